@@ -43,9 +43,212 @@ struct VkMockCommandEXT
     VkMockCommandDataEXT data;
 };
 
+struct VkMockAllocationStatisticsEXT
+{
+    uint64_t allocationCount;
+    uint64_t allocationSize;
+    uint64_t peakAllocationCount;
+    uint64_t peakAllocationSize;
+    uint64_t totalAllocationCount;
+};
+
+enum VkMockImageSwizzleEXT
+{
+    VK_MOCK_IMAGE_SWIZZLE_NONE_EXT = 0,
+    VK_MOCK_IMAGE_SWIZZLE_MORTON_EXT = 1
+};
+
+enum VkMockRasterizerEXT
+{
+    VK_MOCK_RASTERIZER_NONE_EXT = 0,
+    VK_MOCK_RASTERIZER_SOFTWARE_EXT = 1
+};
+
+enum VkMockVertexCacheEXT
+{
+    VK_MOCK_VERTEX_CACHE_NONE_EXT = 0,
+    VK_MOCK_VERTEX_CACHE_FIFO_EXT = 1,
+    VK_MOCK_VERTEX_CACHE_LRU_EXT = 2
+};
+
+struct VkMockDrawStatisticsEXT
+{
+    uint64_t drawCount;
+    uint64_t vertexCount;
+    uint64_t vertexShaderInvocations;
+    uint64_t primitiveCount;
+    uint64_t fragmentShaderInvocations;
+    uint64_t samplesPassed;
+    uint64_t indirectCommandCount;
+    uint64_t indirectDrawCount;
+    uint64_t dispatchCount;
+    uint64_t workgroupCount;
+    uint64_t computeShaderInvocations;
+};
+
+#define VK_MOCK_MAX_VERTEX_ATTRIBUTES_EXT 16
+#define VK_MOCK_MAX_VARYINGS_EXT 16
+#define VK_MOCK_MAX_COLOR_ATTACHMENTS_EXT 8
+#define VK_MOCK_MAX_PERFORMANCE_COUNTERS_EXT 32
+#define VK_MOCK_MAX_PHYSICAL_DEVICES_EXT 32
+
+enum VkMockTimestampClockEXT
+{
+    VK_MOCK_TIMESTAMP_CLOCK_MONOTONIC_EXT = 0,
+    VK_MOCK_TIMESTAMP_CLOCK_TSC_EXT = 1
+};
+
+struct VkMockTimestampClockInfoEXT
+{
+    VkMockTimestampClockEXT clock;
+    float timestampPeriod;
+    uint64_t maxDeviation;
+};
+
+enum VkMockPerformanceCounterEXT
+{
+    VK_MOCK_PERFORMANCE_COUNTER_COMMANDS_EXECUTED_EXT = 0,
+    VK_MOCK_PERFORMANCE_COUNTER_BYTES_COPIED_EXT = 1,
+    VK_MOCK_PERFORMANCE_COUNTER_BUSY_TIME_EXT = 2,
+    VK_MOCK_PERFORMANCE_COUNTER_DRAWS_EXT = 3,
+    VK_MOCK_PERFORMANCE_COUNTER_DISPATCHES_EXT = 4,
+    VK_MOCK_PERFORMANCE_COUNTER_VERTICES_EXT = 5,
+    VK_MOCK_PERFORMANCE_COUNTER_PEER_BYTES_COPIED_EXT = 6
+};
+
+struct VkMockPerformanceCountersInfoEXT
+{
+    uint32_t counterCount;
+    const VkMockPerformanceCounterEXT* pCounters;
+    uint32_t countersPerPass;
+};
+
+struct VkMockPhysicalDeviceInfoEXT
+{
+    const char* pDeviceName;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    VkPhysicalDeviceType deviceType;
+    VkDeviceSize memoryHeapSize;
+    uint32_t threadCount;
+    uint32_t groupIndex;
+};
+
+struct VkMockPhysicalDevicesInfoEXT
+{
+    uint32_t physicalDeviceCount;
+    const VkMockPhysicalDeviceInfoEXT* pPhysicalDevices;
+    uint64_t peerMemoryBandwidth;
+};
+
+struct VkMockPhysicalDeviceProfileInfoEXT
+{
+    const char* pFileName;
+    const char* pProfileName;
+    const char* pCacheFileName;
+};
+
+struct VkMockDescriptorEXT
+{
+    void* pData;
+    VkDeviceSize range;
+};
+
+struct VkMockDescriptorBindingEXT
+{
+    VkDescriptorType descriptorType;
+    uint32_t descriptorCount;
+    const VkMockDescriptorEXT* pDescriptors;
+};
+
+struct VkMockDescriptorSetEXT
+{
+    uint32_t bindingCount;
+    const VkMockDescriptorBindingEXT* pBindings;
+};
+
+struct VkMockWorkgroupEXT
+{
+    uint32_t workgroupId[ 3 ];
+    uint32_t workgroupCount[ 3 ];
+    const void* pPushConstants;
+    uint32_t descriptorSetCount;
+    const VkMockDescriptorSetEXT* pDescriptorSets;
+    void* pUserData;
+};
+
+typedef void( VKAPI_PTR* PFN_vkMockComputeKernelEXT )( const VkMockWorkgroupEXT* pWorkgroup );
+
+struct VkMockComputeKernelCreateInfoEXT
+{
+    PFN_vkMockComputeKernelEXT pfnKernel;
+    void* pUserData;
+};
+
+struct VkMockVertexInputEXT
+{
+    uint32_t vertexIndex;
+    uint32_t instanceIndex;
+    const void* pAttributes[ VK_MOCK_MAX_VERTEX_ATTRIBUTES_EXT ];
+    const void* pPushConstants;
+    uint32_t descriptorSetCount;
+    const VkMockDescriptorSetEXT* pDescriptorSets;
+    void* pUserData;
+};
+
+struct VkMockVertexOutputEXT
+{
+    float position[ 4 ];
+    float varyings[ VK_MOCK_MAX_VARYINGS_EXT ];
+};
+
+struct VkMockFragmentInputEXT
+{
+    float fragCoord[ 4 ];
+    VkBool32 frontFacing;
+    const float* pVaryings;
+    const void* pPushConstants;
+    uint32_t descriptorSetCount;
+    const VkMockDescriptorSetEXT* pDescriptorSets;
+    void* pUserData;
+};
+
+struct VkMockFragmentOutputEXT
+{
+    VkClearColorValue colors[ VK_MOCK_MAX_COLOR_ATTACHMENTS_EXT ];
+    float depth;
+    VkBool32 discard;
+};
+
+typedef void( VKAPI_PTR* PFN_vkMockVertexKernelEXT )( const VkMockVertexInputEXT* pInput, VkMockVertexOutputEXT* pOutput );
+typedef void( VKAPI_PTR* PFN_vkMockFragmentKernelEXT )( const VkMockFragmentInputEXT* pInput, VkMockFragmentOutputEXT* pOutput );
+
+struct VkMockGraphicsKernelCreateInfoEXT
+{
+    PFN_vkMockVertexKernelEXT pfnVertexKernel;
+    PFN_vkMockFragmentKernelEXT pfnFragmentKernel;
+    uint32_t varyingCount;
+    void* pUserData;
+};
+
 typedef void( VKAPI_PTR* PFN_vkSetDeviceMockProcAddrEXT )( VkDevice device, const char* pName, PFN_vkVoidFunction pFunction );
 typedef void( VKAPI_PTR* PFN_vkAppendMockCommandEXT )( VkCommandBuffer commandBuffer, const VkMockCommandEXT* pCommand );
 typedef void( VKAPI_PTR* PFN_vkExecuteMockCommandBufferEXT )( VkQueue queue, VkCommandBuffer commandBuffer );
+typedef VkResult( VKAPI_PTR* PFN_vkResolveMockDeviceAddressEXT )( VkDevice device, VkDeviceAddress address, VkBuffer* pBuffer, VkDeviceSize* pOffset );
+typedef void( VKAPI_PTR* PFN_vkGetMockAllocationStatisticsEXT )( VkDevice device, VkSystemAllocationScope scope, VkMockAllocationStatisticsEXT* pStatistics );
+typedef void( VKAPI_PTR* PFN_vkGetMockObjectStatisticsEXT )( VkDevice device, VkObjectType objectType, VkMockAllocationStatisticsEXT* pStatistics );
+typedef void( VKAPI_PTR* PFN_vkResetMockAllocationStatisticsEXT )( VkDevice device );
+typedef void( VKAPI_PTR* PFN_vkSetMockImageSwizzleEXT )( VkDevice device, VkMockImageSwizzleEXT swizzle );
+typedef VkResult( VKAPI_PTR* PFN_vkCreateMockShaderModuleEXT )( VkDevice device, const VkMockComputeKernelCreateInfoEXT* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkShaderModule* pShaderModule );
+typedef void( VKAPI_PTR* PFN_vkSetMockRasterizerEXT )( VkDevice device, VkMockRasterizerEXT rasterizer );
+typedef VkResult( VKAPI_PTR* PFN_vkCreateMockGraphicsShaderModuleEXT )( VkDevice device, const VkMockGraphicsKernelCreateInfoEXT* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkShaderModule* pShaderModule );
+typedef void( VKAPI_PTR* PFN_vkSetMockVertexCacheEXT )( VkDevice device, VkMockVertexCacheEXT cache, uint32_t entryCount );
+typedef void( VKAPI_PTR* PFN_vkGetMockDrawStatisticsEXT )( VkDevice device, VkMockDrawStatisticsEXT* pStatistics );
+typedef void( VKAPI_PTR* PFN_vkResetMockDrawStatisticsEXT )( VkDevice device );
+typedef VkResult( VKAPI_PTR* PFN_vkSetMockTimestampClockEXT )( VkPhysicalDevice physicalDevice, const VkMockTimestampClockInfoEXT* pInfo );
+typedef VkResult( VKAPI_PTR* PFN_vkSetMockPerformanceCountersEXT )( VkPhysicalDevice physicalDevice, const VkMockPerformanceCountersInfoEXT* pInfo );
+typedef VkResult( VKAPI_PTR* PFN_vkSetMockPhysicalDevicesEXT )( VkInstance instance, const VkMockPhysicalDevicesInfoEXT* pInfo );
+typedef VkResult( VKAPI_PTR* PFN_vkLoadMockPhysicalDeviceProfileEXT )( VkPhysicalDevice physicalDevice, const VkMockPhysicalDeviceProfileInfoEXT* pInfo );
 
 #ifndef VK_NO_PROTOTYPES
 /**
@@ -87,6 +290,302 @@ VKAPI_ATTR void VKAPI_CALL vkExecuteMockCommandBufferEXT(
     VkQueue queue,
     VkCommandBuffer commandBuffer );
 
+/**
+ * @brief
+ *   Find the buffer containing the device address.
+ *   Device addresses returned by the mock are host pointers to the memory
+ *   bound to the buffer, so they can also be dereferenced directly.
+ * @param device
+ *   The device that owns the buffer.
+ * @param address
+ *   The device address to resolve.
+ * @param pBuffer
+ *   Receives the buffer containing the address.
+ * @param pOffset
+ *   Receives the offset of the address from the start of the buffer.
+ * @return
+ *   VK_ERROR_INVALID_DEVICE_ADDRESS_EXT if no buffer created with
+ *   VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT contains the address.
+ */
+VKAPI_ATTR VkResult VKAPI_CALL vkResolveMockDeviceAddressEXT(
+    VkDevice device,
+    VkDeviceAddress address,
+    VkBuffer* pBuffer,
+    VkDeviceSize* pOffset );
+
+/**
+ * @brief
+ *   Get statistics of the host memory allocated by the ICD in the scope.
+ *   The statistics are collected for all objects in the process.
+ * @param device
+ *   Any device created by the ICD.
+ * @param scope
+ *   The allocation scope to get the statistics for.
+ * @param pStatistics
+ *   Receives the statistics.
+ */
+VKAPI_ATTR void VKAPI_CALL vkGetMockAllocationStatisticsEXT(
+    VkDevice device,
+    VkSystemAllocationScope scope,
+    VkMockAllocationStatisticsEXT* pStatistics );
+
+/**
+ * @brief
+ *   Get statistics of the objects of the given type created by the ICD.
+ *   allocationCount is the number of live objects. Internal allocations
+ *   are reported for VK_OBJECT_TYPE_UNKNOWN.
+ * @param device
+ *   Any device created by the ICD.
+ * @param objectType
+ *   The object type to get the statistics for.
+ * @param pStatistics
+ *   Receives the statistics.
+ */
+VKAPI_ATTR void VKAPI_CALL vkGetMockObjectStatisticsEXT(
+    VkDevice device,
+    VkObjectType objectType,
+    VkMockAllocationStatisticsEXT* pStatistics );
+
+/**
+ * @brief
+ *   Reset the high-water marks to the current values and the total
+ *   allocation counts to zero.
+ * @param device
+ *   Any device created by the ICD.
+ */
+VKAPI_ATTR void VKAPI_CALL vkResetMockAllocationStatisticsEXT(
+    VkDevice device );
+
+/**
+ * @brief
+ *   Set the layout of the images created later on the device.
+ *   VK_MOCK_IMAGE_SWIZZLE_MORTON_EXT stores optimally tiled 2D and 3D images created with
+ *   VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT in tiles of 8x8 texels in Morton order, if the
+ *   texel size is a power of two. The texels are reordered by the host image copies,
+ *   transfer commands recorded in command buffers access the memory as it is.
+ * @param device
+ *   The device to set the layout for.
+ * @param swizzle
+ *   The layout of the images.
+ */
+VKAPI_ATTR void VKAPI_CALL vkSetMockImageSwizzleEXT(
+    VkDevice device,
+    VkMockImageSwizzleEXT swizzle );
+
+/**
+ * @brief
+ *   Create a shader module executing a host function instead of SPIR-V code.
+ *   Compute pipelines created from the module call the kernel once for each
+ *   workgroup dispatched with vkCmdDispatch, vkCmdDispatchBase or vkCmdDispatchIndirect.
+ *   The kernel processes all invocations of the workgroup. Workgroups are executed
+ *   in parallel, in any order, so the kernel must be thread-safe.
+ *   pDescriptorSets are indexed by the set number and pBindings by the binding number.
+ *   Descriptors of uniform and storage buffers point to the bound range of the buffer
+ *   memory, including the dynamic offsets.
+ *   The module is destroyed with vkDestroyShaderModule.
+ * @param device
+ *   The device to create the shader module on.
+ * @param pCreateInfo
+ *   The kernel function and the user data passed to it.
+ * @param pAllocator
+ *   The allocator to use for the shader module.
+ * @param pShaderModule
+ *   Receives the shader module.
+ */
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateMockShaderModuleEXT(
+    VkDevice device,
+    const VkMockComputeKernelCreateInfoEXT* pCreateInfo,
+    const VkAllocationCallbacks* pAllocator,
+    VkShaderModule* pShaderModule );
+
+/**
+ * @brief
+ *   Select how the draws recorded later on the device are executed.
+ *   By default draws only wait for a time proportional to the number of vertices.
+ *   VK_MOCK_RASTERIZER_SOFTWARE_EXT rasterizes triangle lists, strips and fans drawn inside
+ *   vkCmdBeginRendering into the color and depth attachments, and clears the attachments
+ *   with VK_ATTACHMENT_LOAD_OP_CLEAR. Triangles are binned into 64x64 pixel tiles, which are
+ *   rasterized in parallel by the device's threads.
+ *   Pipelines without a vertex kernel read the position from the attribute at location 0,
+ *   and 4 varyings from the attribute at location 1 (white if not present). Pipelines without
+ *   a fragment kernel write the first 4 varyings to all color attachments.
+ *   Stencil tests, multisampling, depth bias and logic operations are not supported.
+ * @param device
+ *   The device to set the rasterizer for.
+ * @param rasterizer
+ *   The rasterizer to use.
+ */
+VKAPI_ATTR void VKAPI_CALL vkSetMockRasterizerEXT(
+    VkDevice device,
+    VkMockRasterizerEXT rasterizer );
+
+/**
+ * @brief
+ *   Create a shader module executing host functions instead of SPIR-V code in graphics pipelines.
+ *   The vertex kernel of the module bound to the vertex stage is called once for each vertex,
+ *   and writes the clip-space position and varyingCount varyings. pAttributes point to the
+ *   attributes in the vertex buffers, indexed by the location.
+ *   The fragment kernel of the module bound to the fragment stage is called once for each
+ *   covered pixel with the perspective-correct varyings, and writes the colors of the attachments.
+ *   The depth is initialized with the interpolated depth, and the depth test is executed
+ *   after the kernel. Kernels are called in parallel, so they must be thread-safe.
+ *   The module is destroyed with vkDestroyShaderModule.
+ * @param device
+ *   The device to create the shader module on.
+ * @param pCreateInfo
+ *   The kernel functions and the user data passed to them.
+ * @param pAllocator
+ *   The allocator to use for the shader module.
+ * @param pShaderModule
+ *   Receives the shader module.
+ */
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateMockGraphicsShaderModuleEXT(
+    VkDevice device,
+    const VkMockGraphicsKernelCreateInfoEXT* pCreateInfo,
+    const VkAllocationCallbacks* pAllocator,
+    VkShaderModule* pShaderModule );
+
+/**
+ * @brief
+ *   Set the post-transform vertex cache simulated by the indexed draws recorded later on the device.
+ *   Indices found in the cache reuse the transformed vertex, so only the cache misses are counted
+ *   as vertex shader invocations, and the draws wait for a time proportional to the invocations.
+ *   The cache is empty at the beginning of each instance. Draws use a FIFO cache with 32 entries
+ *   by default.
+ * @param device
+ *   The device to set the cache for.
+ * @param cache
+ *   The replacement policy of the cache, or VK_MOCK_VERTEX_CACHE_NONE_EXT to transform each index.
+ * @param entryCount
+ *   The number of vertices in the cache.
+ */
+VKAPI_ATTR void VKAPI_CALL vkSetMockVertexCacheEXT(
+    VkDevice device,
+    VkMockVertexCacheEXT cache,
+    uint32_t entryCount );
+
+/**
+ * @brief
+ *   Get statistics of the draws executed on the device's queues since the device was created
+ *   or the statistics were reset. vertexCount is the number of vertices and indices of all
+ *   instances, vertexShaderInvocations excludes the indices found in the vertex cache.
+ *   Draws rasterized by the software rasterizer count the fragments and the samples that
+ *   passed the depth test, other draws pass one fragment per primitive.
+ *   indirectDrawCount is the number of draws resolved from the indirect buffers and count
+ *   buffers by indirectCommandCount indirect draw commands. Dispatches are counted too.
+ *   The same counters are the source of the occlusion and pipeline statistics queries.
+ * @param device
+ *   The device to get the statistics for.
+ * @param pStatistics
+ *   Receives the statistics.
+ */
+VKAPI_ATTR void VKAPI_CALL vkGetMockDrawStatisticsEXT(
+    VkDevice device,
+    VkMockDrawStatisticsEXT* pStatistics );
+
+/**
+ * @brief
+ *   Reset the draw statistics of the device.
+ * @param device
+ *   The device to reset the statistics for.
+ */
+VKAPI_ATTR void VKAPI_CALL vkResetMockDrawStatisticsEXT(
+    VkDevice device );
+
+/**
+ * @brief
+ *   Select the clock of the timestamps written by the devices created from the physical device.
+ *   VK_MOCK_TIMESTAMP_CLOCK_MONOTONIC_EXT, the default, reads CLOCK_MONOTONIC (the performance
+ *   counter on Windows), so the device timestamps can be compared with the host timestamps directly.
+ *   VK_MOCK_TIMESTAMP_CLOCK_TSC_EXT reads the time stamp counter of the CPU, which is much cheaper,
+ *   and requires a counter that ticks at a constant rate.
+ *   The ticks of the clock are converted to the timestampPeriod reported in the device limits,
+ *   or written unchanged if timestampPeriod is 0, in which case the period of the clock is reported.
+ *   vkGetCalibratedTimestampsKHR reports at least maxDeviation as the maximum deviation.
+ *   The clock must not be changed while the devices execute commands.
+ * @param physicalDevice
+ *   The physical device to set the clock for.
+ * @param pInfo
+ *   The clock, the period of the timestamps in nanoseconds and the minimum reported deviation.
+ * @return
+ *   VK_ERROR_FEATURE_NOT_PRESENT if the clock is not supported by the host.
+ */
+VKAPI_ATTR VkResult VKAPI_CALL vkSetMockTimestampClockEXT(
+    VkPhysicalDevice physicalDevice,
+    const VkMockTimestampClockInfoEXT* pInfo );
+
+/**
+ * @brief
+ *   Select the counters reported by vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR.
+ *   The counters are derived from the execution of the commands by the mock, and by default all
+ *   counters are reported in the order of VkMockPerformanceCounterEXT and can be sampled in one pass.
+ *   If countersPerPass is not 0, the counters are split into passes of at most countersPerPass
+ *   consecutive counters, and the query pools recording counters from several passes must be
+ *   submitted once per pass with VkPerformanceQuerySubmitInfoKHR.
+ *   The counters must not be changed while query pools created from the physical device exist.
+ * @param physicalDevice
+ *   The physical device to set the counters for.
+ * @param pInfo
+ *   The counters and the number of counters that can be sampled in one pass.
+ * @return
+ *   VK_ERROR_TOO_MANY_OBJECTS if more than VK_MOCK_MAX_PERFORMANCE_COUNTERS_EXT counters are selected.
+ *   VK_ERROR_FEATURE_NOT_PRESENT if any of the counters is not supported.
+ */
+VKAPI_ATTR VkResult VKAPI_CALL vkSetMockPerformanceCountersEXT(
+    VkPhysicalDevice physicalDevice,
+    const VkMockPerformanceCountersInfoEXT* pInfo );
+
+/**
+ * @brief
+ *   Replace the physical devices enumerated by the instance.
+ *   Each physical device reports the name, IDs, type and memory heap size given in its info
+ *   (a heap size of 0 selects the default size),
+ *   and the devices created from it execute the commands on threadCount threads (0 selects
+ *   the number of hardware threads). Transfers use at most 8 of these threads, as they are bound
+ *   by memory bandwidth. Physical devices with the same groupIndex are enumerated as one device
+ *   group by vkEnumeratePhysicalDeviceGroups. Devices created from a group execute the commands
+ *   on the sum of the thread counts of the physical devices in the group, or on all hardware
+ *   threads if any of them selects the number of hardware threads.
+ *   Copies from or to memory bound to the memory instance of another device in the group
+ *   are charged at peerMemoryBandwidth bytes per second (0 disables the charge).
+ *   The physical devices previously enumerated by the instance are destroyed, so no devices
+ *   created from them may exist.
+ * @param instance
+ *   The instance to set the physical devices for.
+ * @param pInfo
+ *   The physical devices and the bandwidth of the links between the devices of a group.
+ * @return
+ *   VK_ERROR_TOO_MANY_OBJECTS if more than VK_MOCK_MAX_PHYSICAL_DEVICES_EXT physical devices are requested.
+ *   VK_ERROR_INITIALIZATION_FAILED if no physical devices are requested.
+ */
+VKAPI_ATTR VkResult VKAPI_CALL vkSetMockPhysicalDevicesEXT(
+    VkInstance instance,
+    const VkMockPhysicalDevicesInfoEXT* pInfo );
+
+/**
+ * @brief
+ *   Load a Vulkan-Profiles JSON file describing the physical device.
+ *   Properties, limits and features defined by the capabilities of the profile override
+ *   the values reported by the physical device. If the profile lists any extensions, the device
+ *   extensions not listed by the profile are hidden. If pProfileName is null, the first profile
+ *   of the file is used.
+ *   The parsed profile is compiled into a binary cache written to pCacheFileName. Later loads
+ *   map the cache directly as long as the size and the hash of the contents of the JSON file match.
+ *   The cache is optional, and failures to write it are ignored.
+ *   The default physical device of an instance loads the profile given by the
+ *   VK_MOCK_ICD_PROFILE_FILE, VK_MOCK_ICD_PROFILE_NAME and VK_MOCK_ICD_PROFILE_CACHE_FILE
+ *   environment variables, if set.
+ * @param physicalDevice
+ *   The physical device to load the profile for.
+ * @param pInfo
+ *   The file and the name of the profile, and the name of the cache file.
+ * @return
+ *   VK_ERROR_INITIALIZATION_FAILED if the file cannot be read, is malformed, or does not define the profile.
+ */
+VKAPI_ATTR VkResult VKAPI_CALL vkLoadMockPhysicalDeviceProfileEXT(
+    VkPhysicalDevice physicalDevice,
+    const VkMockPhysicalDeviceProfileInfoEXT* pInfo );
+
 #endif // VK_NO_PROTOTYPES
 
 #endif // VK_EXT_mock
@@ -223,6 +223,384 @@ class ICDGenerator:
         if ext is not None:
             out.write( f'#endif // {ext}\n' )
 
+class VulkanStructMember:
+    def __init__( self, member: etree.Element ):
+        self.name = member.find( 'name' ).text
+        self.type = member.find( 'type' ).text
+        # Comments are excluded from the declaration
+        self.string = ( member.text or '' ) + ''.join(
+            ( child.text or '' ) + ( child.tail or '' ) if child.tag != 'comment' else ( child.tail or '' )
+            for child in member )
+        self.values = member.get( 'values' )
+        self.api = member.get( 'api' )
+        # Pointers and bitfields cannot be reflected with offsetof
+        self.pointer = '*' in self.string
+        self.bitfield = ':' in self.string.split( self.name, 1 )[ 1 ]
+
+class ReflectionGenerator:
+    # Structures filled from the device profiles, with all structures of their pNext chains
+    root_structs = [ 'VkPhysicalDeviceProperties2', 'VkPhysicalDeviceFeatures2', 'VkFormatProperties2' ]
+
+    base_types = {
+        'VkBool32': 'eBool32',
+        'uint8_t': 'eUint8',
+        'char': 'eChar',
+        'int32_t': 'eInt32',
+        'uint32_t': 'eUint32',
+        'uint64_t': 'eUint64',
+        'VkDeviceSize': 'eUint64',
+        'VkDeviceAddress': 'eUint64',
+        'size_t': 'eSize',
+        'float': 'eFloat' }
+
+    def __init__( self, vk_xml: etree.ElementTree ):
+        spec = VulkanSpec( vk_xml )
+        self.types = {}
+        self.aliases = {}
+        for t in spec.types.findall( 'type' ):
+            name = t.get( 'name' ) or t.findtext( 'name' )
+            if name is None or not self.is_vulkan_api( t ):
+                continue
+            if t.get( 'alias' ) is not None:
+                self.aliases[ name ] = t.get( 'alias' )
+            else:
+                self.types[ name ] = t
+
+        self.guards = {}
+        self.enum_values = {}
+        for e in spec.xml.findall( 'enums' ):
+            self.enum_values[ e.get( 'name' ) ] = [ ( value.get( 'name' ), None )
+                for value in e.findall( 'enum' )
+                if self.is_vulkan_api( value ) ]
+        for feature in spec.xml.findall( 'feature' ):
+            if self.is_vulkan_api( feature ):
+                self.add_requirements( feature, None )
+        for extension in sorted( spec.extensions.findall( 'extension' ), key=lambda ext: int( ext.get( 'number', '0' ) ) ):
+            if 'vulkan' in extension.get( 'supported', 'vulkan' ).split( ',' ):
+                self.add_requirements( extension, extension.get( 'name' ) )
+
+        # Collect the structures of the pNext chains and all structures nested in them
+        self.structs = {}
+        self.struct_types = {}
+        for root in self.root_structs:
+            root_members = self.get_struct_members( root )
+            root_stype = next( member.values for member in root_members if member.name == 'sType' )
+            for member in root_members:
+                if member.name not in ( 'sType', 'pNext' ):
+                    self.struct_types[ member.type ] = root_stype
+            for name, t in self.types.items():
+                if root in ( t.get( 'structextends' ) or '' ).split( ',' ) and name in self.guards:
+                    self.struct_types[ name ] = next( member.values for member in self.get_struct_members( name ) if member.name == 'sType' )
+        for name in list( self.struct_types.keys() ):
+            self.add_struct( name )
+        self.struct_types = { name: stype for name, stype in self.struct_types.items() if self.structs.get( name ) }
+
+    def is_vulkan_api( self, element: etree.Element ):
+        return 'vulkan' in element.get( 'api', 'vulkan' ).split( ',' )
+
+    def add_requirements( self, feature: etree.Element, guard: str ):
+        for require in feature.findall( 'require' ):
+            if not self.is_vulkan_api( require ):
+                continue
+            for t in require.findall( 'type' ):
+                self.guards.setdefault( t.get( 'name' ), guard )
+            for value in require.findall( 'enum[@extends]' ):
+                if not self.is_vulkan_api( value ):
+                    continue
+                values = self.enum_values.setdefault( value.get( 'extends' ), [] )
+                if value.get( 'name' ) not in [ name for name, _ in values ]:
+                    values.append( ( value.get( 'name' ), guard ) )
+
+    def resolve_alias( self, name: str ):
+        while name in self.aliases:
+            name = self.aliases[ name ]
+        return name
+
+    def get_struct_members( self, name: str ):
+        return [ VulkanStructMember( member )
+                 for member in self.types[ name ].findall( 'member' )
+                 if self.is_vulkan_api( member ) ]
+
+    def get_member_type( self, member: VulkanStructMember ):
+        # Returns the reflection type, the enum and the nested structure of the member
+        if member.pointer or member.bitfield or member.name in ( 'sType', 'pNext' ):
+            return None
+        if member.type in self.base_types:
+            return ( self.base_types[ member.type ], None, None )
+        name = self.resolve_alias( member.type )
+        t = self.types.get( name )
+        if t is None or name not in self.guards:
+            return None
+        category = t.get( 'category' )
+        if category == 'enum':
+            return ( 'eEnum', name, None )
+        if category == 'bitmask':
+            bits = self.resolve_alias( t.get( 'requires' ) or t.get( 'bitvalues' ) or '' )
+            flags = 'eFlags64' if t.find( 'type' ).text == 'VkFlags64' else 'eFlags'
+            return ( flags, bits if bits in self.guards else None, None )
+        if category == 'struct' and self.add_struct( name ):
+            return ( 'eStruct', None, name )
+        return None
+
+    def add_struct( self, name: str ):
+        # Returns the reflected members of the structure, or None if it has no members to reflect
+        if name not in self.structs:
+            self.structs[ name ] = None
+            members = []
+            for member in self.get_struct_members( name ):
+                member_type = self.get_member_type( member )
+                if member_type is not None:
+                    members.append( ( member, ) + member_type )
+            self.structs[ name ] = members or None
+        return self.structs[ name ]
+
+    def get_struct_guards( self, name: str ):
+        guards = { self.guards[ name ] }
+        for member, member_type, enum, struct in self.structs[ name ]:
+            if enum is not None:
+                guards.add( self.guards[ enum ] )
+            if struct is not None:
+                guards |= self.get_struct_guards( struct )
+        return guards
+
+    def get_enum_table_values( self, enum: str ):
+        # Values added by other extensions are only defined with these extensions
+        guard = self.guards[ enum ]
+        return [ ( value, value_guard if value_guard != guard else None )
+                 for value, value_guard in self.enum_values.get( enum, [] ) ]
+
+    def write_icd_reflection( self, out: io.TextIOBase ):
+        out.write( '#pragma once\n' )
+        out.write( '#include <vulkan/vulkan.h>\n' )
+        out.write( '#include <iterator>\n' )
+        out.write( '#include <stddef.h>\n\n' )
+        out.write( 'namespace vkmock\n{\n' )
+
+        # Enum values
+        enums = sorted( { enum for members in self.structs.values() if members for _, _, enum, _ in members if enum is not None } )
+        self.enum_tables = set()
+        for enum in enums:
+            values = self.get_enum_table_values( enum )
+            if not any( value_guard is None for _, value_guard in values ):
+                continue
+            self.enum_tables.add( enum )
+            self.begin_guard_block( out, { self.guards[ enum ] } )
+            out.write( f'  static constexpr ReflectionEnumValue g_{enum}Values[] = {{\n' )
+            for value, value_guard in values:
+                self.begin_guard_block( out, { value_guard } )
+                out.write( f'    {{ "{value}", static_cast<uint64_t>( {value} ) }},\n' )
+                self.end_guard_block( out, { value_guard } )
+            out.write( '  };\n' )
+            out.write( f'  static constexpr ReflectionEnumInfo g_{enum}Info = {{ g_{enum}Values, uint32_t( std::size( g_{enum}Values ) ) }};\n' )
+            self.end_guard_block( out, { self.guards[ enum ] } )
+            out.write( '\n' )
+
+        # Structures, nested structures first
+        written = set()
+        for name in self.struct_types.keys():
+            self.write_struct( out, name, written )
+
+        # Structures sorted by name, including the aliases
+        names = [ ( name, name ) for name in self.struct_types.keys() ]
+        names += [ ( alias, name ) for alias, name in self.aliases.items() if name in self.struct_types and alias in self.guards ]
+        out.write( '  static constexpr ReflectionStructName g_ReflectionStructNames[] = {\n' )
+        for alias, name in sorted( names ):
+            guards = self.get_struct_guards( name ) | { self.guards[ alias ] }
+            self.begin_guard_block( out, guards )
+            out.write( f'    {{ "{alias}", &g_{name}Info }},\n' )
+            self.end_guard_block( out, guards )
+        out.write( '  };\n' )
+        out.write( '}\n' )
+
+    def write_struct( self, out: io.TextIOBase, name: str, written: set ):
+        if name in written:
+            return
+        written.add( name )
+        members = self.structs[ name ]
+        for member, member_type, enum, struct in members:
+            if struct is not None:
+                self.write_struct( out, struct, written )
+
+        guards = self.get_struct_guards( name )
+        self.begin_guard_block( out, guards )
+        out.write( f'  static constexpr ReflectionMemberInfo g_{name}Members[] = {{\n' )
+        for member, member_type, enum, struct in members:
+            enum_info = f'&g_{enum}Info' if enum in self.enum_tables else 'nullptr'
+            struct_info = f'&g_{struct}Info' if struct is not None else 'nullptr'
+            out.write( f'    {{ "{member.name}", ReflectionType::{member_type}, offsetof( {name}, {member.name} ), sizeof( {name}::{member.name} ), {enum_info}, {struct_info} }},\n' )
+        out.write( '  };\n' )
+        stype = self.struct_types.get( name, 'VK_STRUCTURE_TYPE_MAX_ENUM' )
+        out.write( f'  static constexpr ReflectionStructInfo g_{name}Info = {{ "{name}", {stype}, sizeof( {name} ), g_{name}Members, uint32_t( std::size( g_{name}Members ) ) }};\n' )
+        self.end_guard_block( out, guards )
+        out.write( '\n' )
+
+    def begin_guard_block( self, out: io.TextIOBase, guards: set ):
+        guards = sorted( guard for guard in guards if guard is not None )
+        if guards:
+            out.write( '#if ' + ' && '.join( f'defined( {guard} )' for guard in guards ) + '\n' )
+
+    def end_guard_block( self, out: io.TextIOBase, guards: set ):
+        if any( guard is not None for guard in guards ):
+            out.write( '#endif\n' )
+
+class FormatGenerator:
+    # Features of the formats, images of all tilings have the same memory layout and support the same features
+    transfer_features = [ 'VK_FORMAT_FEATURE_TRANSFER_SRC_BIT', 'VK_FORMAT_FEATURE_TRANSFER_DST_BIT' ]
+    sampled_features = transfer_features + [ 'VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT' ]
+    blit_features = [ 'VK_FORMAT_FEATURE_BLIT_SRC_BIT', 'VK_FORMAT_FEATURE_BLIT_DST_BIT' ]
+    integer_features = sampled_features + blit_features + [
+        'VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT',
+        'VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT' ]
+    feature_sets = {
+        'Transfer': ( transfer_features, [] ),
+        'Compressed': ( sampled_features + [ 'VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT' ], [] ),
+        'Ycbcr': ( sampled_features + [ 'VK_FORMAT_FEATURE_MIDPOINT_CHROMA_SAMPLES_BIT' ], [] ),
+        'MultiPlane': ( sampled_features + [ 'VK_FORMAT_FEATURE_MIDPOINT_CHROMA_SAMPLES_BIT', 'VK_FORMAT_FEATURE_DISJOINT_BIT' ], [] ),
+        'DepthStencil': ( sampled_features + blit_features + [ 'VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT' ], [] ),
+        'Integer': ( integer_features, [
+            'VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT',
+            'VK_FORMAT_FEATURE_UNIFORM_TEXEL_BUFFER_BIT',
+            'VK_FORMAT_FEATURE_STORAGE_TEXEL_BUFFER_BIT' ] ),
+        'Float': ( integer_features + [
+            'VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT',
+            'VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BLEND_BIT' ], [
+            'VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT',
+            'VK_FORMAT_FEATURE_UNIFORM_TEXEL_BUFFER_BIT',
+            'VK_FORMAT_FEATURE_STORAGE_TEXEL_BUFFER_BIT' ] ) }
+
+    # Numeric formats encoded and decoded by the texel kernels
+    texel_numeric_formats = ( 'UNORM', 'SNORM', 'USCALED', 'SSCALED', 'UINT', 'SINT', 'UFLOAT', 'SFLOAT', 'SRGB' )
+
+    undefined_format = ( 0, ( 1, 1, 1 ), 'VK_IMAGE_ASPECT_COLOR_BIT', [ ( 'VK_IMAGE_ASPECT_COLOR_BIT', 0, 1, 1 ) ], 0, None )
+
+    def __init__( self, vk_xml: etree.ElementTree ):
+        spec = VulkanSpec( vk_xml )
+        self.values = {}
+        self.aliases = {}
+        for enum in spec.xml.findall( 'enums[@name="VkFormat"]/enum' ):
+            self.add_value( enum, None )
+        for feature in spec.xml.findall( 'feature' ):
+            for enum in feature.findall( 'require/enum[@extends="VkFormat"]' ):
+                self.add_value( enum, None )
+        for extension in spec.extensions.findall( 'extension' ):
+            for enum in extension.findall( 'require/enum[@extends="VkFormat"]' ):
+                self.add_value( enum, extension.get( 'number' ) )
+
+        self.formats = { fmt.get( 'name' ): fmt for fmt in spec.xml.findall( 'formats/format' ) if fmt.get( 'name' ) in self.values }
+        self.classes = sorted( { fmt.get( 'class' ) for fmt in self.formats.values() } )
+
+    def add_value( self, enum: etree.Element, extnumber: str ):
+        name = enum.get( 'name' )
+        if enum.get( 'alias' ) is not None:
+            self.aliases[ name ] = enum.get( 'alias' )
+        elif enum.get( 'value' ) is not None:
+            self.values[ name ] = int( enum.get( 'value' ), 0 )
+        elif enum.get( 'offset' ) is not None:
+            # Values of the extension enums are derived from the extension numbers
+            number = int( enum.get( 'extnumber' ) or extnumber )
+            self.values[ name ] = 1000000000 + ( number - 1 ) * 1000 + int( enum.get( 'offset' ) )
+
+    def get_block_extent( self, fmt: etree.Element ):
+        return tuple( int( x ) for x in fmt.get( 'blockExtent', '1,1,1' ).split( ',' ) )
+
+    def get_format_info( self, fmt: etree.Element ):
+        # Returns the block size, block extent, aspect mask, planes, class index and features of the format
+        block_size = int( fmt.get( 'blockSize' ) )
+        block_extent = self.get_block_extent( fmt )
+        class_index = self.classes.index( fmt.get( 'class' ) ) + 1
+        components = { component.get( 'name' ): component for component in fmt.findall( 'component' ) }
+        numeric_formats = { component.get( 'numericFormat' ) for component in components.values() }
+        planes = fmt.findall( 'plane' )
+
+        if planes:
+            # Multi-planar formats report the size of the first plane
+            plane_infos = [ ( f'VK_IMAGE_ASPECT_PLANE_{plane.get( "index" )}_BIT',
+                              int( self.formats[ plane.get( 'compatible' ) ].get( 'blockSize' ) ),
+                              int( plane.get( 'widthDivisor' ) ),
+                              int( plane.get( 'heightDivisor' ) ) ) for plane in planes ]
+            aspects = ' | '.join( [ 'VK_IMAGE_ASPECT_COLOR_BIT' ] + [ aspect for aspect, _, _, _ in plane_infos ] )
+            return ( plane_infos[ 0 ][ 1 ], block_extent, aspects, plane_infos, class_index, 'MultiPlane' )
+
+        if 'D' in components or 'S' in components:
+            # Depth and stencil aspects are kept in separate planes, depth texels are padded to 2 or 4 bytes
+            plane_infos = []
+            if 'D' in components:
+                depth_size = 2 if int( components[ 'D' ].get( 'bits' ) ) <= 16 else 4
+                plane_infos.append( ( 'VK_IMAGE_ASPECT_DEPTH_BIT', depth_size, 1, 1 ) )
+            if 'S' in components:
+                plane_infos.append( ( 'VK_IMAGE_ASPECT_STENCIL_BIT', 1, 1, 1 ) )
+            aspects = ' | '.join( aspect for aspect, _, _, _ in plane_infos )
+            return ( block_size, block_extent, aspects, plane_infos, class_index, 'DepthStencil' )
+
+        if fmt.get( 'compressed' ) is not None:
+            features = 'Compressed'
+        elif fmt.get( 'chroma' ) is not None:
+            features = 'Ycbcr'
+        elif not numeric_formats.issubset( self.texel_numeric_formats ):
+            features = 'Transfer'
+        elif numeric_formats & { 'UINT', 'SINT' } or any( int( c.get( 'bits' ) ) == 64 for c in components.values() ):
+            features = 'Integer'
+        else:
+            features = 'Float'
+        plane_infos = [ ( 'VK_IMAGE_ASPECT_COLOR_BIT', block_size, 1, 1 ) ]
+        return ( block_size, block_extent, 'VK_IMAGE_ASPECT_COLOR_BIT', plane_infos, class_index, features )
+
+    def write_icd_formats( self, out: io.TextIOBase ):
+        out.write( '#pragma once\n' )
+        out.write( '#include <vulkan/vulkan.h>\n\n' )
+        out.write( 'namespace vkmock\n{\n' )
+
+        # Features of the groups of formats
+        for name, ( image_features, buffer_features ) in self.feature_sets.items():
+            out.write( f'  static constexpr VkFormatFeatureFlags g_{name}ImageFeatures = {" | ".join( image_features ) or "0"};\n' )
+            out.write( f'  static constexpr VkFormatFeatureFlags g_{name}BufferFeatures = {" | ".join( buffer_features ) or "0"};\n' )
+        out.write( '\n' )
+
+        # Formats grouped by the blocks of 1000 enum values, each extension has its own block
+        blocks = {}
+        for name in self.formats.keys():
+            value = self.values[ name ]
+            blocks.setdefault( value // 1000, {} )[ value % 1000 ] = name
+
+        # Blocks are dense, missing formats and VK_FORMAT_UNDEFINED share the entry of the unknown formats
+        out.write( '  static constexpr FormatInfo g_FormatInfos[] = {\n' )
+        block_indices = {}
+        index = 0
+        for block, names in sorted( blocks.items() ):
+            block_indices[ block ] = ( index, max( names.keys() ) + 1 )
+            for offset in range( max( names.keys() ) + 1 ):
+                if offset in names:
+                    self.write_format_info( out, self.get_format_info( self.formats[ names[ offset ] ] ) )
+                else:
+                    self.write_format_info( out, self.undefined_format )
+                index += 1
+        out.write( '  };\n\n' )
+
+        # Formats sorted by name, including the aliases
+        names = [ ( name, self.values[ name ] ) for name in self.formats.keys() ]
+        names += [ ( alias, self.values[ name ] ) for alias, name in self.aliases.items() if name in self.formats ]
+        out.write( '  static constexpr FormatName g_FormatNames[] = {\n' )
+        for name, value in sorted( names ):
+            out.write( f'    {{ "{name}", static_cast<VkFormat>( {value} ) }},\n' )
+        out.write( '  };\n\n' )
+
+        out.write( '  inline uint32_t GetFormatInfoIndex( VkFormat format )\n  {\n' )
+        out.write( '    const uint32_t value = static_cast<uint32_t>( format );\n' )
+        out.write( '    const uint32_t offset = value % 1000;\n' )
+        out.write( '    switch( value / 1000 )\n    {\n' )
+        for block, ( base, end ) in sorted( block_indices.items() ):
+            out.write( f'    case {block}: return ( offset < {end} ) ? {base} + offset : 0;\n' )
+        out.write( '    }\n' )
+        out.write( '    return 0;\n  }\n' )
+        out.write( '}\n' )
+
+    def write_format_info( self, out: io.TextIOBase, info: tuple ):
+        block_size, block_extent, aspects, planes, class_index, features = info
+        plane_infos = ', '.join( f'{{ {aspect}, {size}, {width_divisor}, {height_divisor} }}' for aspect, size, width_divisor, height_divisor in planes )
+        image_features = f'g_{features}ImageFeatures' if features else '0'
+        buffer_features = f'g_{features}BufferFeatures' if features else '0'
+        out.write( f'    {{ {block_size}, {{ {block_extent[ 0 ]}, {block_extent[ 1 ]}, {block_extent[ 2 ]} }}, {aspects}, {len( planes )}, {{ {plane_infos} }}, {class_index}, {image_features}, {buffer_features} }},\n' )
+
 def parse_args():
     parser = argparse.ArgumentParser( description='Generate test ICD' )
     parser.add_argument( '--vk_xml', type=str, help='Vulkan XML API description' )
@@ -237,3 +615,9 @@ if __name__ == '__main__':
         icd.write_icd_base( out )
     with open( os.path.join( args.output, 'vk_mock_icd_dispatch.h' ), 'w' ) as out:
         icd.write_icd_dispatch( out )
+    reflection = ReflectionGenerator( vk_xml )
+    with open( os.path.join( args.output, 'vk_mock_icd_reflection.h' ), 'w' ) as out:
+        reflection.write_icd_reflection( out )
+    formats = FormatGenerator( vk_xml )
+    with open( os.path.join( args.output, 'vk_mock_icd_formats.h' ), 'w' ) as out:
+        formats.write_icd_formats( out )
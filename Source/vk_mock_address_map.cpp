@@ -0,0 +1,108 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_address_map.h"
+#include "vk_mock_buffer.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace vkmock
+{
+    DeviceAddressMap::DeviceAddressMap( const VkAllocationCallbacks& allocator )
+        : m_Allocator( allocator )
+        , m_Mutex()
+        , m_Pages( vk_stl_allocator<PageMap::value_type>( allocator ) )
+    {
+    }
+
+    void DeviceAddressMap::Insert( VkBuffer buffer )
+    {
+        const VkDeviceAddress address = buffer->GetDeviceAddress();
+        if( !address || !buffer->m_Size )
+        {
+            return;
+        }
+
+        const uint64_t firstPage = address >> g_PageShift;
+        const uint64_t lastPage = ( address + buffer->m_Size - 1 ) >> g_PageShift;
+
+        std::unique_lock lock( m_Mutex );
+
+        for( uint64_t page = firstPage; page <= lastPage; ++page )
+        {
+            auto it = m_Pages.try_emplace( page, vk_stl_allocator<VkBuffer>( m_Allocator ) ).first;
+            it->second.push_back( buffer );
+        }
+    }
+
+    void DeviceAddressMap::Remove( VkBuffer buffer )
+    {
+        const VkDeviceAddress address = buffer->GetDeviceAddress();
+        if( !address || !buffer->m_Size )
+        {
+            return;
+        }
+
+        const uint64_t firstPage = address >> g_PageShift;
+        const uint64_t lastPage = ( address + buffer->m_Size - 1 ) >> g_PageShift;
+
+        std::unique_lock lock( m_Mutex );
+
+        for( uint64_t page = firstPage; page <= lastPage; ++page )
+        {
+            auto it = m_Pages.find( page );
+            if( it == m_Pages.end() )
+            {
+                continue;
+            }
+
+            BufferVector& buffers = it->second;
+            buffers.erase( std::remove( buffers.begin(), buffers.end(), buffer ), buffers.end() );
+
+            if( buffers.empty() )
+            {
+                m_Pages.erase( it );
+            }
+        }
+    }
+
+    VkBuffer DeviceAddressMap::Find( VkDeviceAddress address ) const
+    {
+        std::shared_lock lock( m_Mutex );
+
+        auto it = m_Pages.find( address >> g_PageShift );
+        if( it == m_Pages.end() )
+        {
+            return VK_NULL_HANDLE;
+        }
+
+        for( VkBuffer buffer : it->second )
+        {
+            const VkDeviceAddress bufferAddress = buffer->GetDeviceAddress();
+            if( address >= bufferAddress && address - bufferAddress < buffer->m_Size )
+            {
+                return buffer;
+            }
+        }
+
+        return VK_NULL_HANDLE;
+    }
+}
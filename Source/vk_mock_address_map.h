@@ -0,0 +1,60 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "vk_mock_icd_helpers.h"
+#include <vulkan/vulkan.h>
+#include <functional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace vkmock
+{
+    /**
+     * @brief
+     *   Maps device addresses back to the buffers they belong to.
+     *   The address space is split into fixed-size pages, and each page keeps
+     *   the list of buffers overlapping it, so the lookup cost does not depend
+     *   on the number of buffers registered in the map.
+     */
+    struct DeviceAddressMap
+    {
+        static constexpr uint32_t g_PageShift = 16;
+
+        typedef std::vector<VkBuffer, vk_stl_allocator<VkBuffer>>
+            BufferVector;
+
+        typedef std::unordered_map<uint64_t, BufferVector, std::hash<uint64_t>, std::equal_to<uint64_t>,
+            vk_stl_allocator<std::pair<const uint64_t, BufferVector>>>
+            PageMap;
+
+        VkAllocationCallbacks m_Allocator;
+        mutable std::shared_mutex m_Mutex;
+        PageMap m_Pages;
+
+        explicit DeviceAddressMap( const VkAllocationCallbacks& allocator );
+
+        void Insert( VkBuffer buffer );
+        void Remove( VkBuffer buffer );
+
+        VkBuffer Find( VkDeviceAddress address ) const;
+    };
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_allocation_statistics.h"
+
+namespace vkmock
+{
+    AllocationCounters g_ScopeAllocationCounters[ g_AllocationScopeCount ];
+    AllocationCounters g_ObjectTypeAllocationCounters[ g_ObjectTypeCount ];
+
+    static void UpdatePeak( std::atomic<uint64_t>& peak, uint64_t value ) noexcept
+    {
+        uint64_t current = peak.load( std::memory_order_relaxed );
+        while( current < value &&
+            !peak.compare_exchange_weak( current, value, std::memory_order_relaxed ) )
+        {
+        }
+    }
+
+    void AllocationCounters::Allocate( uint64_t size ) noexcept
+    {
+        const uint64_t count = m_AllocationCount.fetch_add( 1, std::memory_order_relaxed ) + 1;
+        const uint64_t totalSize = m_AllocationSize.fetch_add( size, std::memory_order_relaxed ) + size;
+        m_TotalAllocationCount.fetch_add( 1, std::memory_order_relaxed );
+
+        UpdatePeak( m_PeakAllocationCount, count );
+        UpdatePeak( m_PeakAllocationSize, totalSize );
+    }
+
+    void AllocationCounters::Free( uint64_t size ) noexcept
+    {
+        m_AllocationCount.fetch_sub( 1, std::memory_order_relaxed );
+        m_AllocationSize.fetch_sub( size, std::memory_order_relaxed );
+    }
+
+    void AllocationCounters::Reset() noexcept
+    {
+        m_PeakAllocationCount.store( m_AllocationCount.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+        m_PeakAllocationSize.store( m_AllocationSize.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+        m_TotalAllocationCount.store( 0, std::memory_order_relaxed );
+    }
+
+    void AllocationCounters::GetStatistics( VkMockAllocationStatisticsEXT* pStatistics ) const noexcept
+    {
+        pStatistics->allocationCount = m_AllocationCount.load( std::memory_order_relaxed );
+        pStatistics->allocationSize = m_AllocationSize.load( std::memory_order_relaxed );
+        pStatistics->peakAllocationCount = m_PeakAllocationCount.load( std::memory_order_relaxed );
+        pStatistics->peakAllocationSize = m_PeakAllocationSize.load( std::memory_order_relaxed );
+        pStatistics->totalAllocationCount = m_TotalAllocationCount.load( std::memory_order_relaxed );
+    }
+}
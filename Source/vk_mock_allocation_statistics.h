@@ -0,0 +1,88 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "vk_mock.h"
+#include <vulkan/vulkan.h>
+#include <atomic>
+
+namespace vkmock
+{
+    /**
+     * @brief
+     *   Lock-free counters of host allocations made by the ICD.
+     */
+    struct AllocationCounters
+    {
+        std::atomic<uint64_t> m_AllocationCount;
+        std::atomic<uint64_t> m_AllocationSize;
+        std::atomic<uint64_t> m_PeakAllocationCount;
+        std::atomic<uint64_t> m_PeakAllocationSize;
+        std::atomic<uint64_t> m_TotalAllocationCount;
+
+        void Allocate( uint64_t size ) noexcept;
+        void Free( uint64_t size ) noexcept;
+        void Reset() noexcept;
+
+        void GetStatistics( VkMockAllocationStatisticsEXT* pStatistics ) const noexcept;
+    };
+
+    // Core object types are stored at their VkObjectType index, followed by
+    // the extension object types. Index 0 (VK_OBJECT_TYPE_UNKNOWN) collects
+    // the internal allocations.
+    static constexpr uint32_t g_SurfaceObjectTypeIndex = VK_OBJECT_TYPE_COMMAND_POOL + 1;
+    static constexpr uint32_t g_SwapchainObjectTypeIndex = VK_OBJECT_TYPE_COMMAND_POOL + 2;
+    static constexpr uint32_t g_ObjectTypeCount = VK_OBJECT_TYPE_COMMAND_POOL + 3;
+
+    static constexpr uint32_t g_AllocationScopeCount = VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1;
+
+    extern AllocationCounters g_ScopeAllocationCounters[ g_AllocationScopeCount ];
+    extern AllocationCounters g_ObjectTypeAllocationCounters[ g_ObjectTypeCount ];
+
+    constexpr uint32_t vk_object_type_index( VkObjectType objectType )
+    {
+        if( objectType <= VK_OBJECT_TYPE_COMMAND_POOL )
+        {
+            return static_cast<uint32_t>( objectType );
+        }
+
+        switch( objectType )
+        {
+        case VK_OBJECT_TYPE_SURFACE_KHR:
+            return g_SurfaceObjectTypeIndex;
+        case VK_OBJECT_TYPE_SWAPCHAIN_KHR:
+            return g_SwapchainObjectTypeIndex;
+        default:
+            return 0;
+        }
+    }
+
+    inline void vk_record_allocation( VkSystemAllocationScope scope, VkObjectType objectType, uint64_t size ) noexcept
+    {
+        g_ScopeAllocationCounters[ scope ].Allocate( size );
+        g_ObjectTypeAllocationCounters[ vk_object_type_index( objectType ) ].Allocate( size );
+    }
+
+    inline void vk_record_free( VkSystemAllocationScope scope, VkObjectType objectType, uint64_t size ) noexcept
+    {
+        g_ScopeAllocationCounters[ scope ].Free( size );
+        g_ObjectTypeAllocationCounters[ vk_object_type_index( objectType ) ].Free( size );
+    }
+}
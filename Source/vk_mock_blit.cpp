@@ -0,0 +1,979 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_blit.h"
+#include "vk_mock_image.h"
+#include "vk_mock_simd.h"
+#include "vk_mock_texel.h"
+#include "vk_mock_thread_pool.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+namespace vkmock
+{
+    // Destination rows are distributed between the threads in chunks of about this size.
+    static constexpr size_t g_BlitChunkSize = 64 * 1024;
+
+    // Filtered texels are kept as 4 floats in RGBA order.
+    static constexpr uint32_t g_ComponentsPerTexel = 4;
+
+    typedef std::vector<float, vk_stl_allocator<float>> FloatVector;
+
+    // Encodings with dedicated row conversion routines.
+    enum class BlitCodec
+    {
+        eGeneric,
+        eUnorm8,
+        eSrgb8,
+        eSfloat16,
+        eSfloat32
+    };
+
+    // Source texels sampled for a destination texel along one axis.
+    struct BlitSample
+    {
+        int32_t index0;
+        int32_t index1;
+        float weight;
+    };
+
+    // Source row contributing to a destination row.
+    struct BlitRow
+    {
+        int32_t z;
+        int32_t y;
+        float weight;
+    };
+
+    // Location of a subresource of one aspect plane in memory.
+    struct BlitSurface
+    {
+        uint8_t* pData;
+        VkDeviceSize rowPitch;
+        VkDeviceSize slicePitch;
+        VkExtent3D extent;
+        uint32_t texelSize;
+
+        uint8_t* GetRow( uint32_t slice, uint32_t y ) const
+        {
+            return pData + slice * slicePitch + y * rowPitch;
+        }
+    };
+
+    static constexpr uint32_t g_SrgbEncodeTableSize = 4096;
+
+    // Lookup tables of the 8-bit encodings.
+    struct Unorm8Tables
+    {
+        float unormToFloat[ 256 ];
+        float srgbToFloat[ 256 ];
+        float srgbThresholds[ 255 ];
+        uint8_t srgbEncode[ g_SrgbEncodeTableSize ];
+
+        Unorm8Tables()
+        {
+            for( uint32_t i = 0; i < 256; ++i )
+            {
+                unormToFloat[ i ] = float( i ) / 255.0f;
+                srgbToFloat[ i ] = vk_srgb_to_linear( float( i ) / 255.0f );
+            }
+
+            // Linear values half-way between the encoded values, so that the encoding
+            // rounds to the nearest value in the sRGB space like vk_linear_to_srgb does.
+            for( uint32_t i = 0; i < 255; ++i )
+            {
+                srgbThresholds[ i ] = vk_srgb_to_linear( ( float( i ) + 0.5f ) / 255.0f );
+            }
+
+            // Codes of evenly spaced linear values, refined with the thresholds.
+            uint32_t code = 0;
+            for( uint32_t i = 0; i < g_SrgbEncodeTableSize; ++i )
+            {
+                const float value = float( i ) / float( g_SrgbEncodeTableSize - 1 );
+                while( code < 255 && value >= srgbThresholds[ code ] )
+                {
+                    code++;
+                }
+                srgbEncode[ i ] = uint8_t( code );
+            }
+        }
+    };
+
+    static const Unorm8Tables& GetUnorm8Tables()
+    {
+        static const Unorm8Tables tables;
+        return tables;
+    }
+
+    static BlitCodec GetBlitCodec( const TexelFormat& format )
+    {
+        if( format.packedBits || format.paddingBits || !format.componentCount )
+        {
+            return BlitCodec::eGeneric;
+        }
+
+        for( uint32_t i = 1; i < format.componentCount; ++i )
+        {
+            if( format.components[ i ].bits != format.components[ 0 ].bits )
+            {
+                return BlitCodec::eGeneric;
+            }
+        }
+
+        const uint32_t bits = format.components[ 0 ].bits;
+        switch( format.numericFormat )
+        {
+        case TexelNumericFormat::eUnorm:
+            return ( bits == 8 ) ? BlitCodec::eUnorm8 : BlitCodec::eGeneric;
+        case TexelNumericFormat::eSrgb:
+            return ( bits == 8 ) ? BlitCodec::eSrgb8 : BlitCodec::eGeneric;
+        case TexelNumericFormat::eSfloat:
+            return ( bits == 16 ) ? BlitCodec::eSfloat16 : ( bits == 32 ) ? BlitCodec::eSfloat32 : BlitCodec::eGeneric;
+        default:
+            return BlitCodec::eGeneric;
+        }
+    }
+
+    static bool IsIntegerFormat( const TexelFormat& format )
+    {
+        return format.numericFormat == TexelNumericFormat::eUint ||
+            format.numericFormat == TexelNumericFormat::eSint;
+    }
+
+    static BlitSurface GetBlitSurface( VkImage image, VkImageAspectFlagBits aspect, const VkImageSubresourceLayers& subresource )
+    {
+        const VkImageSubresource imageSubresource = { aspect, subresource.mipLevel, subresource.baseArrayLayer };
+        const uint32_t planeIndex = image->GetPlaneIndex( aspect );
+
+        VkSubresourceLayout layout;
+
+        BlitSurface surface;
+        surface.pData = image->GetSubresourceData( imageSubresource, &layout );
+        surface.rowPitch = layout.rowPitch;
+        surface.slicePitch = ( image->m_ImageType == VK_IMAGE_TYPE_3D ) ? layout.depthPitch : layout.arrayPitch;
+        surface.extent = image->GetMipLevelExtent( planeIndex, subresource.mipLevel );
+        surface.texelSize = image->m_FormatInfo.planes[ planeIndex ].blockSize;
+        return surface;
+    }
+
+    static void ComputeSamples( BlitSample* pSamples, int32_t dst0, int32_t dst1, int32_t src0, int32_t src1, uint32_t srcSize, VkFilter filter )
+    {
+        const int32_t dstBegin = std::min( dst0, dst1 );
+        const int32_t count = std::abs( dst1 - dst0 );
+        const int32_t maxIndex = int32_t( srcSize ) - 1;
+
+        // Negative scale mirrors the region.
+        const double scale = double( src1 - src0 ) / double( dst1 - dst0 );
+
+        for( int32_t i = 0; i < count; ++i )
+        {
+            // Centers of the destination texels are projected to the source image.
+            const double u = src0 + ( dstBegin + i + 0.5 - dst0 ) * scale;
+
+            BlitSample& sample = pSamples[ i ];
+            if( filter == VK_FILTER_LINEAR )
+            {
+                const double p = u - 0.5;
+                const double index = floor( p );
+                sample.index0 = std::min( std::max( int32_t( index ), 0 ), maxIndex );
+                sample.index1 = std::min( std::max( int32_t( index ) + 1, 0 ), maxIndex );
+                sample.weight = float( p - index );
+            }
+            else
+            {
+                sample.index0 = std::min( std::max( int32_t( floor( u ) ), 0 ), maxIndex );
+                sample.index1 = sample.index0;
+                sample.weight = 0.0f;
+            }
+        }
+    }
+
+    // Components stored in the RGBA order are converted as one array.
+    static bool HasRgbaLayout( const TexelFormat& format )
+    {
+        return format.componentCount == g_ComponentsPerTexel &&
+            format.components[ 0 ].channel == eTexelChannelR &&
+            format.components[ 1 ].channel == eTexelChannelG &&
+            format.components[ 2 ].channel == eTexelChannelB &&
+            format.components[ 3 ].channel == eTexelChannelA;
+    }
+
+#ifdef VK_MOCK_SSE2
+    static const bool g_HasF16c = vk_cpu_has_f16c();
+
+    VK_MOCK_TARGET_F16C
+    static void HalfToFloatF16c( const uint8_t* pSrc, float* pDst, size_t count )
+    {
+        size_t i = 0;
+        for( ; i + 8 <= count; i += 8 )
+        {
+            _mm256_storeu_ps( pDst + i, _mm256_cvtph_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSrc + i * 2 ) ) ) );
+        }
+
+        for( ; i < count; ++i )
+        {
+            uint16_t half;
+            memcpy( &half, pSrc + i * 2, sizeof( half ) );
+            pDst[ i ] = vk_half_to_float( half );
+        }
+    }
+
+    VK_MOCK_TARGET_F16C
+    static void FloatToHalfF16c( const float* pSrc, uint8_t* pDst, size_t count )
+    {
+        size_t i = 0;
+        for( ; i + 8 <= count; i += 8 )
+        {
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( pDst + i * 2 ), _mm256_cvtps_ph( _mm256_loadu_ps( pSrc + i ), _MM_FROUND_TO_NEAREST_INT ) );
+        }
+
+        for( ; i < count; ++i )
+        {
+            const uint16_t half = vk_float_to_half( pSrc[ i ] );
+            memcpy( pDst + i * 2, &half, sizeof( half ) );
+        }
+    }
+#endif
+
+    static void DecodeRow( const TexelFormat& format, BlitCodec codec, const uint8_t* pSrc, uint32_t count, float* pDst )
+    {
+        const Unorm8Tables& tables = GetUnorm8Tables();
+
+        if( codec == BlitCodec::eGeneric )
+        {
+            for( uint32_t x = 0; x < count; ++x, pSrc += format.size, pDst += g_ComponentsPerTexel )
+            {
+                VkClearColorValue value;
+                UnpackTexel( format, pSrc, &value );
+                memcpy( pDst, value.float32, sizeof( value.float32 ) );
+            }
+            return;
+        }
+
+#ifdef VK_MOCK_SSE2
+        if( codec == BlitCodec::eSfloat16 && g_HasF16c && HasRgbaLayout( format ) )
+        {
+            return HalfToFloatF16c( pSrc, pDst, size_t( count ) * g_ComponentsPerTexel );
+        }
+#endif
+
+        // Missing components are 0, missing alpha is 1.
+        for( uint32_t x = 0; x < count; ++x )
+        {
+            pDst[ x * g_ComponentsPerTexel + 0 ] = 0.0f;
+            pDst[ x * g_ComponentsPerTexel + 1 ] = 0.0f;
+            pDst[ x * g_ComponentsPerTexel + 2 ] = 0.0f;
+            pDst[ x * g_ComponentsPerTexel + 3 ] = 1.0f;
+        }
+
+        for( uint32_t i = 0; i < format.componentCount; ++i )
+        {
+            const TexelChannel channel = format.components[ i ].channel;
+            float* pDstComponent = pDst + channel;
+
+            switch( codec )
+            {
+            case BlitCodec::eUnorm8:
+            case BlitCodec::eSrgb8:
+            {
+                const float* pTable = ( codec == BlitCodec::eSrgb8 && channel != eTexelChannelA ) ? tables.srgbToFloat : tables.unormToFloat;
+                for( uint32_t x = 0; x < count; ++x )
+                {
+                    pDstComponent[ x * g_ComponentsPerTexel ] = pTable[ pSrc[ x * format.size + i ] ];
+                }
+                break;
+            }
+
+            case BlitCodec::eSfloat16:
+                for( uint32_t x = 0; x < count; ++x )
+                {
+                    uint16_t half;
+                    memcpy( &half, pSrc + x * format.size + i * sizeof( half ), sizeof( half ) );
+                    pDstComponent[ x * g_ComponentsPerTexel ] = vk_half_to_float( half );
+                }
+                break;
+
+            default:
+                for( uint32_t x = 0; x < count; ++x )
+                {
+                    memcpy( &pDstComponent[ x * g_ComponentsPerTexel ], pSrc + x * format.size + i * sizeof( float ), sizeof( float ) );
+                }
+                break;
+            }
+        }
+    }
+
+    static uint8_t EncodeSrgb8( const Unorm8Tables& tables, float value )
+    {
+        // Start the search at the code of the closest lower table entry.
+        const float clamped = std::min( std::max( value, 0.0f ), 1.0f );
+        uint32_t code = tables.srgbEncode[ uint32_t( clamped * float( g_SrgbEncodeTableSize - 1 ) ) ];
+        while( code < 255 && clamped >= tables.srgbThresholds[ code ] )
+        {
+            code++;
+        }
+        return uint8_t( code );
+    }
+
+    static void EncodeRow( const TexelFormat& format, BlitCodec codec, const float* pSrc, uint32_t count, uint8_t* pDst )
+    {
+        const Unorm8Tables& tables = GetUnorm8Tables();
+
+        if( codec == BlitCodec::eGeneric )
+        {
+            for( uint32_t x = 0; x < count; ++x, pSrc += g_ComponentsPerTexel, pDst += format.size )
+            {
+                VkClearColorValue value;
+                memcpy( value.float32, pSrc, sizeof( value.float32 ) );
+                PackTexel( format, value, pDst );
+            }
+            return;
+        }
+
+#ifdef VK_MOCK_SSE2
+        if( codec == BlitCodec::eSfloat16 && g_HasF16c && HasRgbaLayout( format ) )
+        {
+            return FloatToHalfF16c( pSrc, pDst, size_t( count ) * g_ComponentsPerTexel );
+        }
+#endif
+
+        for( uint32_t i = 0; i < format.componentCount; ++i )
+        {
+            const TexelChannel channel = format.components[ i ].channel;
+            const float* pSrcComponent = pSrc + channel;
+
+            switch( codec )
+            {
+            case BlitCodec::eSrgb8:
+                if( channel != eTexelChannelA )
+                {
+                    for( uint32_t x = 0; x < count; ++x )
+                    {
+                        pDst[ x * format.size + i ] = EncodeSrgb8( tables, pSrcComponent[ x * g_ComponentsPerTexel ] );
+                    }
+                    break;
+                }
+                [[fallthrough]];
+
+            case BlitCodec::eUnorm8:
+                for( uint32_t x = 0; x < count; ++x )
+                {
+                    const float value = std::min( std::max( pSrcComponent[ x * g_ComponentsPerTexel ], 0.0f ), 1.0f );
+                    pDst[ x * format.size + i ] = uint8_t( value * 255.0f + 0.5f );
+                }
+                break;
+
+            case BlitCodec::eSfloat16:
+                for( uint32_t x = 0; x < count; ++x )
+                {
+                    const uint16_t half = vk_float_to_half( pSrcComponent[ x * g_ComponentsPerTexel ] );
+                    memcpy( pDst + x * format.size + i * sizeof( half ), &half, sizeof( half ) );
+                }
+                break;
+
+            default:
+                for( uint32_t x = 0; x < count; ++x )
+                {
+                    memcpy( pDst + x * format.size + i * sizeof( float ), &pSrcComponent[ x * g_ComponentsPerTexel ], sizeof( float ) );
+                }
+                break;
+            }
+        }
+    }
+
+    // pDst[ x ] = lerp( pSrc[ index0 ], pSrc[ index1 ], weight ) for each destination texel,
+    // pSrc starts at the texel srcBegin.
+    static void FilterRow( float* pDst, const float* pSrc, int32_t srcBegin, const BlitSample* pSamples, uint32_t count )
+    {
+        for( uint32_t x = 0; x < count; ++x, pDst += g_ComponentsPerTexel )
+        {
+            const float* pA = pSrc + ( pSamples[ x ].index0 - srcBegin ) * g_ComponentsPerTexel;
+            const float* pB = pSrc + ( pSamples[ x ].index1 - srcBegin ) * g_ComponentsPerTexel;
+#if defined( VK_MOCK_SSE2 )
+            const __m128 a = _mm_loadu_ps( pA );
+            const __m128 b = _mm_loadu_ps( pB );
+            _mm_storeu_ps( pDst, _mm_add_ps( a, _mm_mul_ps( _mm_sub_ps( b, a ), _mm_set1_ps( pSamples[ x ].weight ) ) ) );
+#elif defined( VK_MOCK_NEON )
+            const float32x4_t a = vld1q_f32( pA );
+            const float32x4_t b = vld1q_f32( pB );
+            vst1q_f32( pDst, vmlaq_n_f32( a, vsubq_f32( b, a ), pSamples[ x ].weight ) );
+#else
+            for( uint32_t i = 0; i < g_ComponentsPerTexel; ++i )
+            {
+                pDst[ i ] = pA[ i ] + ( pB[ i ] - pA[ i ] ) * pSamples[ x ].weight;
+            }
+#endif
+        }
+    }
+
+    // pDst[ i ] += pSrc[ i ] * weight, count is a multiple of 4.
+    static void AccumulateRow( float* pDst, const float* pSrc, float weight, size_t count )
+    {
+#if defined( VK_MOCK_SSE2 )
+        const __m128 w = _mm_set1_ps( weight );
+        for( size_t i = 0; i < count; i += 4 )
+        {
+            _mm_storeu_ps( pDst + i, _mm_add_ps( _mm_loadu_ps( pDst + i ), _mm_mul_ps( _mm_loadu_ps( pSrc + i ), w ) ) );
+        }
+#elif defined( VK_MOCK_NEON )
+        for( size_t i = 0; i < count; i += 4 )
+        {
+            vst1q_f32( pDst + i, vmlaq_n_f32( vld1q_f32( pDst + i ), vld1q_f32( pSrc + i ), weight ) );
+        }
+#else
+        for( size_t i = 0; i < count; ++i )
+        {
+            pDst[ i ] += pSrc[ i ] * weight;
+        }
+#endif
+    }
+
+    // Averages 2x2 blocks of 8-bit unorm texels, rounding to the nearest value.
+    static void Downsample2xUnorm8( uint8_t* pDst, const uint8_t* pRow0, const uint8_t* pRow1, uint32_t count, uint32_t texelSize )
+    {
+        uint32_t x = 0;
+
+        if( texelSize == 4 )
+        {
+#if defined( VK_MOCK_SSE2 )
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i two = _mm_set1_epi16( 2 );
+
+            for( ; x + 4 <= count; x += 4 )
+            {
+                __m128i sums[ 4 ];
+                for( uint32_t i = 0; i < 2; ++i )
+                {
+                    const __m128i a = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pRow0 + x * 8 + i * 16 ) );
+                    const __m128i b = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pRow1 + x * 8 + i * 16 ) );
+
+                    // Vertical sums of 2 pairs of texels, widened to 16 bits.
+                    const __m128i lo = _mm_add_epi16( _mm_unpacklo_epi8( a, zero ), _mm_unpacklo_epi8( b, zero ) );
+                    const __m128i hi = _mm_add_epi16( _mm_unpackhi_epi8( a, zero ), _mm_unpackhi_epi8( b, zero ) );
+
+                    // Horizontal sums of the texels in each pair.
+                    sums[ i * 2 + 0 ] = _mm_add_epi16( lo, _mm_srli_si128( lo, 8 ) );
+                    sums[ i * 2 + 1 ] = _mm_add_epi16( hi, _mm_srli_si128( hi, 8 ) );
+                }
+
+                const __m128i texels01 = _mm_srli_epi16( _mm_add_epi16( _mm_unpacklo_epi64( sums[ 0 ], sums[ 1 ] ), two ), 2 );
+                const __m128i texels23 = _mm_srli_epi16( _mm_add_epi16( _mm_unpacklo_epi64( sums[ 2 ], sums[ 3 ] ), two ), 2 );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( pDst + x * 4 ), _mm_packus_epi16( texels01, texels23 ) );
+            }
+#elif defined( VK_MOCK_NEON )
+            for( ; x + 2 <= count; x += 2 )
+            {
+                const uint8x16_t a = vld1q_u8( pRow0 + x * 8 );
+                const uint8x16_t b = vld1q_u8( pRow1 + x * 8 );
+
+                const uint16x8_t lo = vaddl_u8( vget_low_u8( a ), vget_low_u8( b ) );
+                const uint16x8_t hi = vaddl_u8( vget_high_u8( a ), vget_high_u8( b ) );
+
+                const uint16x8_t sums = vcombine_u16(
+                    vadd_u16( vget_low_u16( lo ), vget_high_u16( lo ) ),
+                    vadd_u16( vget_low_u16( hi ), vget_high_u16( hi ) ) );
+
+                vst1_u8( pDst + x * 4, vrshrn_n_u16( sums, 2 ) );
+            }
+#endif
+        }
+
+        for( size_t i = size_t( x ) * texelSize; i < size_t( count ) * texelSize; ++i )
+        {
+            const size_t component = i % texelSize;
+            const size_t src = ( i - component ) * 2 + component;
+            pDst[ i ] = uint8_t( ( pRow0[ src ] + pRow0[ src + texelSize ] + pRow1[ src ] + pRow1[ src + texelSize ] + 2 ) >> 2 );
+        }
+    }
+
+    // Averages 2x2 blocks of 32-bit float texels.
+    static void Downsample2xFloat32( float* pDst, const float* pRow0, const float* pRow1, uint32_t count, uint32_t componentCount )
+    {
+        uint32_t x = 0;
+
+        if( componentCount == 4 )
+        {
+            for( ; x < count; ++x )
+            {
+                const float* pA = pRow0 + x * 8;
+                const float* pB = pRow1 + x * 8;
+#if defined( VK_MOCK_SSE2 )
+                const __m128 sum = _mm_add_ps(
+                    _mm_add_ps( _mm_loadu_ps( pA ), _mm_loadu_ps( pA + 4 ) ),
+                    _mm_add_ps( _mm_loadu_ps( pB ), _mm_loadu_ps( pB + 4 ) ) );
+                _mm_storeu_ps( pDst + x * 4, _mm_mul_ps( sum, _mm_set1_ps( 0.25f ) ) );
+#elif defined( VK_MOCK_NEON )
+                const float32x4_t sum = vaddq_f32(
+                    vaddq_f32( vld1q_f32( pA ), vld1q_f32( pA + 4 ) ),
+                    vaddq_f32( vld1q_f32( pB ), vld1q_f32( pB + 4 ) ) );
+                vst1q_f32( pDst + x * 4, vmulq_n_f32( sum, 0.25f ) );
+#else
+                for( uint32_t i = 0; i < 4; ++i )
+                {
+                    pDst[ x * 4 + i ] = ( pA[ i ] + pA[ i + 4 ] + pB[ i ] + pB[ i + 4 ] ) * 0.25f;
+                }
+#endif
+            }
+        }
+
+        for( size_t i = size_t( x ) * componentCount; i < size_t( count ) * componentCount; ++i )
+        {
+            const size_t component = i % componentCount;
+            const size_t src = ( i - component ) * 2 + component;
+            pDst[ i ] = ( pRow0[ src ] + pRow0[ src + componentCount ] + pRow1[ src ] + pRow1[ src + componentCount ] ) * 0.25f;
+        }
+    }
+
+    // Averages the samples of 8-bit unorm texels, rounding to the nearest value.
+    static void ResolveUnorm8( uint8_t* pDst, const uint8_t* pSrc, uint32_t count, uint32_t texelSize, uint32_t samples, uint32_t sampleShift )
+    {
+        uint32_t x = 0;
+
+        if( texelSize == 4 && samples >= 4 )
+        {
+#if defined( VK_MOCK_SSE2 )
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i round = _mm_set1_epi16( int16_t( samples / 2 ) );
+            const __m128i shift = _mm_cvtsi32_si128( int( sampleShift ) );
+
+            for( ; x < count; ++x )
+            {
+                const uint8_t* pSamples = pSrc + size_t( x ) * samples * 4;
+
+                // Sums of 4 samples per iteration, widened to 16 bits.
+                __m128i sum = zero;
+                for( uint32_t i = 0; i < samples; i += 4 )
+                {
+                    const __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSamples + i * 4 ) );
+                    sum = _mm_add_epi16( sum, _mm_add_epi16( _mm_unpacklo_epi8( v, zero ), _mm_unpackhi_epi8( v, zero ) ) );
+                }
+
+                sum = _mm_add_epi16( sum, _mm_srli_si128( sum, 8 ) );
+                sum = _mm_srl_epi16( _mm_add_epi16( sum, round ), shift );
+
+                const int32_t texel = _mm_cvtsi128_si32( _mm_packus_epi16( sum, sum ) );
+                memcpy( pDst + x * 4, &texel, sizeof( texel ) );
+            }
+#elif defined( VK_MOCK_NEON )
+            const int16x4_t shift = vdup_n_s16( -int16_t( sampleShift ) );
+
+            for( ; x < count; ++x )
+            {
+                const uint8_t* pSamples = pSrc + size_t( x ) * samples * 4;
+
+                // Sums of 2 samples per iteration, widened to 16 bits.
+                uint16x8_t sum = vdupq_n_u16( 0 );
+                for( uint32_t i = 0; i < samples; i += 2 )
+                {
+                    sum = vaddw_u8( sum, vld1_u8( pSamples + i * 4 ) );
+                }
+
+                uint16x4_t total = vadd_u16( vget_low_u16( sum ), vget_high_u16( sum ) );
+                total = vshl_u16( vadd_u16( total, vdup_n_u16( uint16_t( samples / 2 ) ) ), shift );
+
+                const uint32_t texel = vget_lane_u32( vreinterpret_u32_u8( vmovn_u16( vcombine_u16( total, total ) ) ), 0 );
+                memcpy( pDst + x * 4, &texel, sizeof( texel ) );
+            }
+#endif
+        }
+
+        for( ; x < count; ++x )
+        {
+            const uint8_t* pSamples = pSrc + size_t( x ) * samples * texelSize;
+            for( uint32_t c = 0; c < texelSize; ++c )
+            {
+                uint32_t sum = samples / 2;
+                for( uint32_t i = 0; i < samples; ++i )
+                {
+                    sum += pSamples[ i * texelSize + c ];
+                }
+                pDst[ x * texelSize + c ] = uint8_t( sum >> sampleShift );
+            }
+        }
+    }
+
+    // Averages the samples of float texels.
+    static void ResolveFloat32( float* pDst, const float* pSrc, uint32_t count, uint32_t componentCount, uint32_t samples )
+    {
+        const float scale = 1.0f / float( samples );
+        uint32_t x = 0;
+
+        if( componentCount == 4 )
+        {
+            for( ; x < count; ++x )
+            {
+                const float* pSamples = pSrc + size_t( x ) * samples * 4;
+#if defined( VK_MOCK_SSE2 )
+                __m128 sum = _mm_loadu_ps( pSamples );
+                for( uint32_t i = 1; i < samples; ++i )
+                {
+                    sum = _mm_add_ps( sum, _mm_loadu_ps( pSamples + i * 4 ) );
+                }
+                _mm_storeu_ps( pDst + x * 4, _mm_mul_ps( sum, _mm_set1_ps( scale ) ) );
+#elif defined( VK_MOCK_NEON )
+                float32x4_t sum = vld1q_f32( pSamples );
+                for( uint32_t i = 1; i < samples; ++i )
+                {
+                    sum = vaddq_f32( sum, vld1q_f32( pSamples + i * 4 ) );
+                }
+                vst1q_f32( pDst + x * 4, vmulq_n_f32( sum, scale ) );
+#else
+                for( uint32_t c = 0; c < 4; ++c )
+                {
+                    float sum = 0.0f;
+                    for( uint32_t i = 0; i < samples; ++i )
+                    {
+                        sum += pSamples[ i * 4 + c ];
+                    }
+                    pDst[ x * 4 + c ] = sum * scale;
+                }
+#endif
+            }
+        }
+
+        for( ; x < count; ++x )
+        {
+            const float* pSamples = pSrc + size_t( x ) * samples * componentCount;
+            for( uint32_t c = 0; c < componentCount; ++c )
+            {
+                float sum = 0.0f;
+                for( uint32_t i = 0; i < samples; ++i )
+                {
+                    sum += pSamples[ i * componentCount + c ];
+                }
+                pDst[ x * componentCount + c ] = sum * scale;
+            }
+        }
+    }
+
+    static void BlitPlane( ThreadPool& threadPool, VkImage srcImage, VkImage dstImage, const VkImageBlit& region, VkImageAspectFlagBits aspect, VkFilter filter )
+    {
+        const TexelFormat srcFormat = GetTexelFormat( srcImage->m_Format, aspect );
+        const TexelFormat dstFormat = GetTexelFormat( dstImage->m_Format, aspect );
+
+        if( srcFormat.numericFormat == TexelNumericFormat::eUnknown ||
+            dstFormat.numericFormat == TexelNumericFormat::eUnknown )
+        {
+            return;
+        }
+
+        // Integer and depth/stencil formats cannot be filtered.
+        if( IsIntegerFormat( srcFormat ) || aspect != VK_IMAGE_ASPECT_COLOR_BIT )
+        {
+            filter = VK_FILTER_NEAREST;
+        }
+
+        const BlitSurface src = GetBlitSurface( srcImage, aspect, region.srcSubresource );
+        const BlitSurface dst = GetBlitSurface( dstImage, aspect, region.dstSubresource );
+
+        const VkOffset3D* pSrcOffsets = region.srcOffsets;
+        const VkOffset3D* pDstOffsets = region.dstOffsets;
+
+        const uint32_t width = std::abs( pDstOffsets[ 1 ].x - pDstOffsets[ 0 ].x );
+        const uint32_t height = std::abs( pDstOffsets[ 1 ].y - pDstOffsets[ 0 ].y );
+        const bool is3D = ( srcImage->m_ImageType == VK_IMAGE_TYPE_3D );
+
+        // Layers are blitted independently, depth slices of 3D images are filtered like rows.
+        uint32_t sliceCount = std::abs( pDstOffsets[ 1 ].z - pDstOffsets[ 0 ].z );
+        if( !is3D )
+        {
+            sliceCount = ( region.srcSubresource.layerCount == VK_REMAINING_ARRAY_LAYERS )
+                ? srcImage->m_ArrayLayers - region.srcSubresource.baseArrayLayer
+                : region.srcSubresource.layerCount;
+        }
+
+        if( !width || !height || !sliceCount )
+        {
+            return;
+        }
+
+        const VkAllocationCallbacks& allocator = threadPool.m_Allocator;
+
+        std::vector<BlitSample, vk_stl_allocator<BlitSample>> xSamples( width, allocator );
+        std::vector<BlitSample, vk_stl_allocator<BlitSample>> ySamples( height, allocator );
+        std::vector<BlitSample, vk_stl_allocator<BlitSample>> zSamples( sliceCount, allocator );
+
+        ComputeSamples( xSamples.data(), pDstOffsets[ 0 ].x, pDstOffsets[ 1 ].x, pSrcOffsets[ 0 ].x, pSrcOffsets[ 1 ].x, src.extent.width, filter );
+        ComputeSamples( ySamples.data(), pDstOffsets[ 0 ].y, pDstOffsets[ 1 ].y, pSrcOffsets[ 0 ].y, pSrcOffsets[ 1 ].y, src.extent.height, filter );
+
+        if( is3D )
+        {
+            ComputeSamples( zSamples.data(), pDstOffsets[ 0 ].z, pDstOffsets[ 1 ].z, pSrcOffsets[ 0 ].z, pSrcOffsets[ 1 ].z, src.extent.depth, filter );
+        }
+        else
+        {
+            for( uint32_t i = 0; i < sliceCount; ++i )
+            {
+                zSamples[ i ] = { int32_t( i ), int32_t( i ), 0.0f };
+            }
+        }
+
+        const uint32_t dstX = std::min( pDstOffsets[ 0 ].x, pDstOffsets[ 1 ].x );
+        const uint32_t dstY = std::min( pDstOffsets[ 0 ].y, pDstOffsets[ 1 ].y );
+        const uint32_t dstZ = is3D ? std::min( pDstOffsets[ 0 ].z, pDstOffsets[ 1 ].z ) : 0;
+
+        const bool sameFormat = ( srcImage->m_Format == dstImage->m_Format );
+        const BlitCodec srcCodec = GetBlitCodec( srcFormat );
+        const BlitCodec dstCodec = GetBlitCodec( dstFormat );
+
+        // Rows with 1:1 scale are copied directly.
+        const bool copyRows = sameFormat && ( filter == VK_FILTER_NEAREST ) &&
+            ( pSrcOffsets[ 1 ].x - pSrcOffsets[ 0 ].x ) == ( pDstOffsets[ 1 ].x - pDstOffsets[ 0 ].x );
+
+        // Exact 2:1 reductions (generation of mip levels) average 2x2 blocks of the source texels.
+        const bool downsample2x = sameFormat && ( filter == VK_FILTER_LINEAR ) &&
+            ( srcCodec != BlitCodec::eGeneric ) &&
+            ( pDstOffsets[ 1 ].x > pDstOffsets[ 0 ].x ) && ( pDstOffsets[ 1 ].y > pDstOffsets[ 0 ].y ) &&
+            ( pSrcOffsets[ 1 ].x - pSrcOffsets[ 0 ].x ) == int32_t( width * 2 ) &&
+            ( pSrcOffsets[ 1 ].y - pSrcOffsets[ 0 ].y ) == int32_t( height * 2 ) &&
+            ( !is3D || ( pSrcOffsets[ 1 ].z - pSrcOffsets[ 0 ].z ) == ( pDstOffsets[ 1 ].z - pDstOffsets[ 0 ].z ) );
+
+        // Range of the source texels read by the linear filter.
+        int32_t srcXMin = INT32_MAX, srcXMax = 0;
+        for( const BlitSample& sample : xSamples )
+        {
+            srcXMin = std::min( { srcXMin, sample.index0, sample.index1 } );
+            srcXMax = std::max( { srcXMax, sample.index0, sample.index1 } );
+        }
+
+        const uint32_t srcSpan = uint32_t( srcXMax - srcXMin + 1 );
+
+        const size_t rowSize = size_t( width ) * dst.texelSize;
+        const size_t rowsPerChunk = std::max<size_t>( g_BlitChunkSize / rowSize, 1 );
+        const size_t totalRowCount = size_t( sliceCount ) * height;
+        const size_t chunkCount = ( totalRowCount + rowsPerChunk - 1 ) / rowsPerChunk;
+
+        threadPool.ParallelFor( chunkCount, [&]( size_t chunkIndex ) {
+            const size_t firstRow = chunkIndex * rowsPerChunk;
+            const size_t lastRow = std::min( firstRow + rowsPerChunk, totalRowCount );
+
+            FloatVector decoded( allocator );
+            FloatVector filtered( allocator );
+            FloatVector accumulated( allocator );
+
+            if( filter == VK_FILTER_LINEAR )
+            {
+                decoded.resize( size_t( srcSpan ) * g_ComponentsPerTexel );
+                filtered.resize( size_t( std::max( srcSpan, width ) ) * g_ComponentsPerTexel );
+                accumulated.resize( size_t( width ) * g_ComponentsPerTexel );
+            }
+
+            for( size_t row = firstRow; row < lastRow; ++row )
+            {
+                const uint32_t slice = uint32_t( row / height );
+                const uint32_t y = uint32_t( row % height );
+
+                const BlitSample& zSample = zSamples[ slice ];
+                const BlitSample& ySample = ySamples[ y ];
+
+                uint8_t* pDstRow = dst.GetRow( dstZ + slice, dstY + y ) + size_t( dstX ) * dst.texelSize;
+
+                if( downsample2x )
+                {
+                    const int32_t srcX = std::min( pSrcOffsets[ 0 ].x, pSrcOffsets[ 1 ].x );
+                    const int32_t srcY = std::min( pSrcOffsets[ 0 ].y, pSrcOffsets[ 1 ].y ) + int32_t( y * 2 );
+                    const uint32_t srcZ = is3D ? uint32_t( zSample.index0 ) : slice;
+
+                    const uint8_t* pRow0 = src.GetRow( srcZ, srcY ) + size_t( srcX ) * src.texelSize;
+                    const uint8_t* pRow1 = src.GetRow( srcZ, srcY + 1 ) + size_t( srcX ) * src.texelSize;
+
+                    if( srcCodec == BlitCodec::eUnorm8 )
+                    {
+                        Downsample2xUnorm8( pDstRow, pRow0, pRow1, width, src.texelSize );
+                    }
+                    else if( srcCodec == BlitCodec::eSfloat32 )
+                    {
+                        Downsample2xFloat32( reinterpret_cast<float*>( pDstRow ),
+                            reinterpret_cast<const float*>( pRow0 ),
+                            reinterpret_cast<const float*>( pRow1 ),
+                            width, srcFormat.componentCount );
+                    }
+                    else
+                    {
+                        // sRGB and half float texels are averaged as floats.
+                        DecodeRow( srcFormat, srcCodec, pRow0, width * 2, decoded.data() );
+                        DecodeRow( srcFormat, srcCodec, pRow1, width * 2, filtered.data() );
+                        Downsample2xFloat32( accumulated.data(), decoded.data(), filtered.data(), width, g_ComponentsPerTexel );
+                        EncodeRow( dstFormat, dstCodec, accumulated.data(), width, pDstRow );
+                    }
+                }
+                else if( filter == VK_FILTER_NEAREST )
+                {
+                    const uint8_t* pSrcRow = src.GetRow( zSample.index0, ySample.index0 );
+
+                    if( copyRows )
+                    {
+                        memcpy( pDstRow, pSrcRow + size_t( xSamples[ 0 ].index0 ) * src.texelSize, rowSize );
+                    }
+                    else if( sameFormat )
+                    {
+                        for( uint32_t x = 0; x < width; ++x )
+                        {
+                            memcpy( pDstRow + x * dst.texelSize, pSrcRow + size_t( xSamples[ x ].index0 ) * src.texelSize, src.texelSize );
+                        }
+                    }
+                    else
+                    {
+                        // Integer values must not be converted to floats.
+                        for( uint32_t x = 0; x < width; ++x )
+                        {
+                            VkClearColorValue value;
+                            UnpackTexel( srcFormat, pSrcRow + size_t( xSamples[ x ].index0 ) * src.texelSize, &value );
+                            PackTexel( dstFormat, value, pDstRow + x * dst.texelSize );
+                        }
+                    }
+                }
+                else
+                {
+                    // Bilinear (trilinear for 3D images) filtering of up to 4 source rows.
+                    const BlitRow rows[ 4 ] = {
+                        { zSample.index0, ySample.index0, ( 1.0f - zSample.weight ) * ( 1.0f - ySample.weight ) },
+                        { zSample.index0, ySample.index1, ( 1.0f - zSample.weight ) * ySample.weight },
+                        { zSample.index1, ySample.index0, zSample.weight * ( 1.0f - ySample.weight ) },
+                        { zSample.index1, ySample.index1, zSample.weight * ySample.weight }
+                    };
+
+                    std::fill( accumulated.begin(), accumulated.end(), 0.0f );
+
+                    for( const BlitRow& srcRow : rows )
+                    {
+                        if( srcRow.weight == 0.0f )
+                        {
+                            continue;
+                        }
+
+                        DecodeRow( srcFormat, srcCodec,
+                            src.GetRow( srcRow.z, srcRow.y ) + size_t( srcXMin ) * src.texelSize,
+                            srcSpan, decoded.data() );
+
+                        FilterRow( filtered.data(), decoded.data(), srcXMin, xSamples.data(), width );
+                        AccumulateRow( accumulated.data(), filtered.data(), srcRow.weight, accumulated.size() );
+                    }
+
+                    EncodeRow( dstFormat, dstCodec, accumulated.data(), width, pDstRow );
+                }
+            }
+        } );
+    }
+
+    void BlitImageRegion( ThreadPool& threadPool, VkImage srcImage, VkImage dstImage, const VkImageBlit& region, VkFilter filter )
+    {
+        // Depth and stencil aspects are stored in separate planes.
+        for( uint32_t planeIndex = 0; planeIndex < srcImage->m_FormatInfo.planeCount; ++planeIndex )
+        {
+            const VkImageAspectFlagBits aspect = srcImage->m_FormatInfo.planes[ planeIndex ].aspect;
+            if( region.srcSubresource.aspectMask & aspect )
+            {
+                BlitPlane( threadPool, srcImage, dstImage, region, aspect, filter );
+            }
+        }
+    }
+
+    void ResolveImageRegion( ThreadPool& threadPool, VkImage srcImage, VkImage dstImage, const VkImageResolve& region )
+    {
+        const TexelFormat srcFormat = GetTexelFormat( srcImage->m_Format, VK_IMAGE_ASPECT_COLOR_BIT );
+        const TexelFormat dstFormat = GetTexelFormat( dstImage->m_Format, VK_IMAGE_ASPECT_COLOR_BIT );
+
+        if( srcFormat.numericFormat == TexelNumericFormat::eUnknown ||
+            dstFormat.numericFormat == TexelNumericFormat::eUnknown )
+        {
+            return;
+        }
+
+        const BlitSurface src = GetBlitSurface( srcImage, VK_IMAGE_ASPECT_COLOR_BIT, region.srcSubresource );
+        const BlitSurface dst = GetBlitSurface( dstImage, VK_IMAGE_ASPECT_COLOR_BIT, region.dstSubresource );
+
+        const uint32_t samples = srcImage->m_Samples;
+        uint32_t sampleShift = 0;
+        while( ( 1u << sampleShift ) < samples )
+        {
+            sampleShift++;
+        }
+
+        const uint32_t width = region.extent.width;
+        const uint32_t height = region.extent.height;
+        const uint32_t layerCount = ( region.srcSubresource.layerCount == VK_REMAINING_ARRAY_LAYERS )
+            ? srcImage->m_ArrayLayers - region.srcSubresource.baseArrayLayer
+            : region.srcSubresource.layerCount;
+
+        if( !width || !height || !layerCount )
+        {
+            return;
+        }
+
+        const BlitCodec srcCodec = GetBlitCodec( srcFormat );
+        const BlitCodec dstCodec = GetBlitCodec( dstFormat );
+        const size_t srcTexelSize = size_t( src.texelSize ) * samples;
+        const VkAllocationCallbacks& allocator = threadPool.m_Allocator;
+
+        const size_t rowSize = size_t( width ) * srcTexelSize;
+        const size_t rowsPerChunk = std::max<size_t>( g_BlitChunkSize / rowSize, 1 );
+        const size_t totalRowCount = size_t( layerCount ) * height;
+        const size_t chunkCount = ( totalRowCount + rowsPerChunk - 1 ) / rowsPerChunk;
+
+        threadPool.ParallelFor( chunkCount, [&]( size_t chunkIndex ) {
+            const size_t firstRow = chunkIndex * rowsPerChunk;
+            const size_t lastRow = std::min( firstRow + rowsPerChunk, totalRowCount );
+
+            FloatVector decoded( allocator );
+            FloatVector resolved( allocator );
+
+            for( size_t row = firstRow; row < lastRow; ++row )
+            {
+                const uint32_t layer = uint32_t( row / height );
+                const uint32_t y = uint32_t( row % height );
+
+                const uint8_t* pSrcRow = src.GetRow( layer, region.srcOffset.y + y ) + region.srcOffset.x * srcTexelSize;
+                uint8_t* pDstRow = dst.GetRow( layer, region.dstOffset.y + y ) + region.dstOffset.x * dst.texelSize;
+
+                if( IsIntegerFormat( srcFormat ) )
+                {
+                    // Integer values cannot be averaged, the first sample is used.
+                    for( uint32_t x = 0; x < width; ++x )
+                    {
+                        memcpy( pDstRow + x * dst.texelSize, pSrcRow + x * srcTexelSize, dst.texelSize );
+                    }
+                }
+                else if( srcCodec == BlitCodec::eUnorm8 )
+                {
+                    ResolveUnorm8( pDstRow, pSrcRow, width, src.texelSize, samples, sampleShift );
+                }
+                else if( srcCodec == BlitCodec::eSfloat32 )
+                {
+                    ResolveFloat32( reinterpret_cast<float*>( pDstRow ), reinterpret_cast<const float*>( pSrcRow ),
+                        width, srcFormat.componentCount, samples );
+                }
+                else
+                {
+                    // sRGB, half float and the other formats are averaged as floats.
+                    decoded.resize( size_t( width ) * samples * g_ComponentsPerTexel );
+                    resolved.resize( size_t( width ) * g_ComponentsPerTexel );
+
+                    DecodeRow( srcFormat, srcCodec, pSrcRow, width * samples, decoded.data() );
+                    ResolveFloat32( resolved.data(), decoded.data(), width, g_ComponentsPerTexel, samples );
+                    EncodeRow( dstFormat, dstCodec, resolved.data(), width, pDstRow );
+                }
+            }
+        } );
+    }
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <vulkan/vulkan.h>
+
+namespace vkmock
+{
+    struct ThreadPool;
+
+    /**
+     * @brief
+     *   Scale a region of the source image into the destination image, as specified for vkCmdBlitImage.
+     *   Texels are converted to floats for filtering, except for the nearest filtering between
+     *   images of the same format, which copies the texels. Exact 2:1 reductions of 8-bit unorm
+     *   and 32-bit float formats (mip chain generation) are averaged directly in the source format.
+     *   Destination rows are filtered in parallel by the thread pool.
+     */
+    void BlitImageRegion( ThreadPool& threadPool, VkImage srcImage, VkImage dstImage, const VkImageBlit& region, VkFilter filter );
+
+    /**
+     * @brief
+     *   Resolve a region of the multisampled color image into the single-sampled image.
+     *   Samples of each texel are averaged, integer formats take the first sample.
+     */
+    void ResolveImageRegion( ThreadPool& threadPool, VkImage srcImage, VkImage dstImage, const VkImageResolve& region );
+}
@@ -27,12 +27,23 @@ namespace vkmock
     {
         uint8_t* m_pData;
         VkDeviceSize m_Size;
+        VkBufferUsageFlags m_Usage;
+        uint32_t m_PeerMemoryMask;
 
         explicit Buffer( const VkBufferCreateInfo& createInfo )
             : m_pData( nullptr )
             , m_Size( createInfo.size )
+            , m_Usage( createInfo.usage )
+            , m_PeerMemoryMask( 0 )
         {
         }
+
+        // Device addresses are the host addresses of the bound memory, so
+        // the mock commands can dereference them directly.
+        VkDeviceAddress GetDeviceAddress() const
+        {
+            return static_cast<VkDeviceAddress>( reinterpret_cast<uintptr_t>( m_pData ) );
+        }
     };
 }
 
@@ -0,0 +1,313 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_clock.h"
+#include "vk_mock_simd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <thread>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined( CLOCK_MONOTONIC )
+#define VK_MOCK_POSIX_CLOCKS 1
+#endif
+
+#if defined( VK_MOCK_X86 ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+namespace vkmock
+{
+    // 1.0 in the 32.32 fixed-point format of the clock multiplier.
+    static constexpr uint64_t g_FixedPointOne = 1ULL << 32;
+
+    // Time of the TSC period measurement, long enough for a precision of a few ppm.
+    static constexpr std::chrono::milliseconds g_TscCalibrationTime( 10 );
+
+    static const VkTimeDomainKHR g_TimeDomains[] = {
+        VK_TIME_DOMAIN_DEVICE_KHR,
+#ifdef VK_MOCK_POSIX_CLOCKS
+        VK_TIME_DOMAIN_CLOCK_MONOTONIC_KHR,
+#ifdef CLOCK_MONOTONIC_RAW
+        VK_TIME_DOMAIN_CLOCK_MONOTONIC_RAW_KHR,
+#endif
+#endif
+#ifdef _WIN32
+        VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_KHR,
+#endif
+    };
+
+#ifdef VK_MOCK_POSIX_CLOCKS
+    static uint64_t ReadClockNanoseconds( clockid_t clock )
+    {
+        timespec time;
+        clock_gettime( clock, &time );
+        return uint64_t( time.tv_sec ) * 1000000000ULL + uint64_t( time.tv_nsec );
+    }
+#endif
+
+    // Ticks of the host monotonic clock, the default source of the device timestamps.
+    static uint64_t ReadMonotonicClock()
+    {
+#if defined( _WIN32 )
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter( &counter );
+        return uint64_t( counter.QuadPart );
+#elif defined( VK_MOCK_POSIX_CLOCKS )
+        return ReadClockNanoseconds( CLOCK_MONOTONIC );
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch() ).count();
+#endif
+    }
+
+    // Nanoseconds per tick of the host monotonic clock.
+    static double GetMonotonicClockPeriod()
+    {
+#ifdef _WIN32
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency( &frequency );
+        return 1e9 / double( frequency.QuadPart );
+#else
+        return 1.0;
+#endif
+    }
+
+    static uint64_t ReadTimeStampCounter()
+    {
+#if defined( VK_MOCK_X86 )
+        return __rdtsc();
+#elif defined( __aarch64__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+        uint64_t counter;
+        asm volatile( "mrs %0, cntvct_el0" : "=r"( counter ) );
+        return counter;
+#else
+        return 0;
+#endif
+    }
+
+    // The counter must tick at a constant rate regardless of the power state of the cores.
+    static bool HasInvariantTimeStampCounter()
+    {
+#if defined( VK_MOCK_X86 ) && defined( _MSC_VER )
+        int info[ 4 ];
+        __cpuid( info, 0x80000000 );
+        if( uint32_t( info[ 0 ] ) < 0x80000007 )
+        {
+            return false;
+        }
+
+        __cpuid( info, 0x80000007 );
+        return ( info[ 3 ] & ( 1 << 8 ) ) != 0;
+#elif defined( VK_MOCK_X86 ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+        unsigned int eax, ebx, ecx, edx;
+        if( !__get_cpuid( 0x80000007, &eax, &ebx, &ecx, &edx ) )
+        {
+            return false;
+        }
+
+        return ( edx & ( 1 << 8 ) ) != 0;
+#elif defined( __aarch64__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+        // The generic timer of ARMv8 always runs at a constant rate.
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Nanoseconds per tick of the time stamp counter.
+    static double MeasureTimeStampCounterPeriod()
+    {
+#if defined( __aarch64__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+        uint64_t frequency;
+        asm volatile( "mrs %0, cntfrq_el0" : "=r"( frequency ) );
+        return 1e9 / double( frequency );
+#else
+        // The frequency of the TSC is not reported by the CPU, so it is measured against the monotonic clock.
+        const uint64_t clockBegin = ReadMonotonicClock();
+        const uint64_t counterBegin = ReadTimeStampCounter();
+
+        std::this_thread::sleep_for( g_TscCalibrationTime );
+
+        const uint64_t clockEnd = ReadMonotonicClock();
+        const uint64_t counterEnd = ReadTimeStampCounter();
+
+        return double( clockEnd - clockBegin ) * GetMonotonicClockPeriod() / double( std::max<uint64_t>( counterEnd - counterBegin, 1 ) );
+#endif
+    }
+
+    static bool IsTimeStampCounterSupported()
+    {
+        static const bool supported = HasInvariantTimeStampCounter();
+        return supported;
+    }
+
+    static double GetTimeStampCounterPeriod()
+    {
+        static const double period = MeasureTimeStampCounterPeriod();
+        return period;
+    }
+
+    // Computes ( ticks * multiplier ) >> 32 without overflowing the intermediate product.
+    static uint64_t ScaleTicks( uint64_t ticks, uint64_t multiplier )
+    {
+        const uint64_t ticksHigh = ticks >> 32;
+        const uint64_t ticksLow = ticks & 0xFFFFFFFF;
+        const uint64_t multiplierHigh = multiplier >> 32;
+        const uint64_t multiplierLow = multiplier & 0xFFFFFFFF;
+        return ticksHigh * multiplier + ticksLow * multiplierHigh + ( ( ticksLow * multiplierLow ) >> 32 );
+    }
+
+    DeviceClock::DeviceClock()
+        : m_Clock( VK_MOCK_TIMESTAMP_CLOCK_MONOTONIC_EXT )
+        , m_TimestampPeriod( static_cast<float>( GetMonotonicClockPeriod() ) )
+        , m_MaxDeviation( 0 )
+        , m_Multiplier( g_FixedPointOne )
+    {
+    }
+
+    VkResult DeviceClock::SetClock( const VkMockTimestampClockInfoEXT& info )
+    {
+        double clockPeriod = 0;
+        switch( info.clock )
+        {
+        case VK_MOCK_TIMESTAMP_CLOCK_MONOTONIC_EXT:
+            clockPeriod = GetMonotonicClockPeriod();
+            break;
+        case VK_MOCK_TIMESTAMP_CLOCK_TSC_EXT:
+            if( !IsTimeStampCounterSupported() )
+            {
+                return VK_ERROR_FEATURE_NOT_PRESENT;
+            }
+            clockPeriod = GetTimeStampCounterPeriod();
+            break;
+        default:
+            return VK_ERROR_FEATURE_NOT_PRESENT;
+        }
+
+        m_Clock = info.clock;
+        m_MaxDeviation = info.maxDeviation;
+
+        // Without an explicit period the ticks of the clock are written directly.
+        if( info.timestampPeriod > 0 )
+        {
+            m_TimestampPeriod = info.timestampPeriod;
+            m_Multiplier = static_cast<uint64_t>( clockPeriod / info.timestampPeriod * double( g_FixedPointOne ) + 0.5 );
+        }
+        else
+        {
+            m_TimestampPeriod = static_cast<float>( clockPeriod );
+            m_Multiplier = g_FixedPointOne;
+        }
+
+        return VK_SUCCESS;
+    }
+
+    uint64_t DeviceClock::Now() const
+    {
+        const uint64_t ticks = ( m_Clock == VK_MOCK_TIMESTAMP_CLOCK_TSC_EXT )
+            ? ReadTimeStampCounter()
+            : ReadMonotonicClock();
+
+        if( m_Multiplier == g_FixedPointOne )
+        {
+            return ticks;
+        }
+
+        return ScaleTicks( ticks, m_Multiplier );
+    }
+
+    VkResult DeviceClock::GetCalibratedTimestamps( uint32_t timestampCount, const VkCalibratedTimestampInfoKHR* pTimestampInfos, uint64_t* pTimestamps, uint64_t* pMaxDeviation ) const
+    {
+        // All clocks are sampled between two reads of the monotonic clock. The time between
+        // the reads plus the longest tick of the sampled clocks bounds the deviation.
+        const double monotonicClockPeriod = GetMonotonicClockPeriod();
+        double maxPeriod = monotonicClockPeriod;
+
+        const uint64_t begin = ReadMonotonicClock();
+
+        for( uint32_t i = 0; i < timestampCount; ++i )
+        {
+            switch( pTimestampInfos[ i ].timeDomain )
+            {
+            case VK_TIME_DOMAIN_DEVICE_KHR:
+                pTimestamps[ i ] = Now();
+                maxPeriod = std::max<double>( maxPeriod, m_TimestampPeriod );
+                break;
+#ifdef VK_MOCK_POSIX_CLOCKS
+            case VK_TIME_DOMAIN_CLOCK_MONOTONIC_KHR:
+                pTimestamps[ i ] = ReadClockNanoseconds( CLOCK_MONOTONIC );
+                break;
+#ifdef CLOCK_MONOTONIC_RAW
+            case VK_TIME_DOMAIN_CLOCK_MONOTONIC_RAW_KHR:
+                pTimestamps[ i ] = ReadClockNanoseconds( CLOCK_MONOTONIC_RAW );
+                break;
+#endif
+#endif
+#ifdef _WIN32
+            case VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_KHR:
+                pTimestamps[ i ] = ReadMonotonicClock();
+                break;
+#endif
+            default:
+                pTimestamps[ i ] = 0;
+                break;
+            }
+        }
+
+        const uint64_t end = ReadMonotonicClock();
+
+        const uint64_t deviation = static_cast<uint64_t>( std::ceil( double( end - begin ) * monotonicClockPeriod + maxPeriod ) );
+        *pMaxDeviation = std::max( deviation, m_MaxDeviation );
+        return VK_SUCCESS;
+    }
+
+    VkResult DeviceClock::GetTimeDomains( uint32_t* pTimeDomainCount, VkTimeDomainKHR* pTimeDomains )
+    {
+        const uint32_t timeDomainCount = std::size( g_TimeDomains );
+
+        if( !pTimeDomains )
+        {
+            *pTimeDomainCount = timeDomainCount;
+            return VK_SUCCESS;
+        }
+
+        const uint32_t count = std::min( *pTimeDomainCount, timeDomainCount );
+        for( uint32_t i = 0; i < count; ++i )
+        {
+            pTimeDomains[ i ] = g_TimeDomains[ i ];
+        }
+
+        *pTimeDomainCount = count;
+
+        if( count < timeDomainCount )
+        {
+            return VK_INCOMPLETE;
+        }
+
+        return VK_SUCCESS;
+    }
+}
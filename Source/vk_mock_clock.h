@@ -0,0 +1,56 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "vk_mock.h"
+#include <vulkan/vulkan.h>
+
+namespace vkmock
+{
+    /**
+     * @brief
+     *   Source of the device timestamps written by vkCmdWriteTimestamp and returned for
+     *   VK_TIME_DOMAIN_DEVICE_KHR by vkGetCalibratedTimestampsKHR.
+     *   Ticks of the source clock are scaled to the timestamp period with a 32.32 fixed-point
+     *   multiplier, so reading the device clock costs one clock read and at most a few multiplications.
+     */
+    struct DeviceClock
+    {
+        VkMockTimestampClockEXT m_Clock;
+        float m_TimestampPeriod;
+        uint64_t m_MaxDeviation;
+        uint64_t m_Multiplier;
+
+        DeviceClock();
+
+        /**
+         * @brief
+         *   Select the source clock. Returns VK_ERROR_FEATURE_NOT_PRESENT if the CPU has no
+         *   invariant time stamp counter, in which case the current clock is kept.
+         */
+        VkResult SetClock( const VkMockTimestampClockInfoEXT& info );
+
+        uint64_t Now() const;
+
+        VkResult GetCalibratedTimestamps( uint32_t timestampCount, const VkCalibratedTimestampInfoKHR* pTimestampInfos, uint64_t* pTimestamps, uint64_t* pMaxDeviation ) const;
+
+        static VkResult GetTimeDomains( uint32_t* pTimeDomainCount, VkTimeDomainKHR* pTimeDomains );
+    };
+}
@@ -21,9 +21,19 @@
 #include "vk_mock_command_buffer.h"
 #include "vk_mock_command_pool.h"
 #include "vk_mock_device.h"
+#include "vk_mock_physical_device.h"
 #include "vk_mock_queue.h"
 #include "vk_mock_query_pool.h"
 #include "vk_mock_buffer.h"
+#include "vk_mock_image.h"
+#include "vk_mock_image_view.h"
+#include "vk_mock_pipeline.h"
+#include "vk_mock_blit.h"
+#include "vk_mock_compute.h"
+#include "vk_mock_descriptor.h"
+#include "vk_mock_draw.h"
+#include "vk_mock_memory_ops.h"
+#include "vk_mock_texel.h"
 
 #include <chrono>
 #include <thread>
@@ -31,209 +41,2235 @@
 
 namespace vkmock
 {
+    // Large copies are split into chunks executed in parallel by the device's thread pool.
+    static constexpr size_t g_CopyChunkSize = g_NonTemporalThreshold;
+
+    // Transfers are bound by memory bandwidth, which is saturated by a few cores,
+    // so they are split into at most that many chunks regardless of the size of the pool.
+    static constexpr size_t g_MaxTransferChunkCount = 8;
+
+    static size_t GetTransferChunkSize( size_t size, size_t minChunkSize )
+    {
+        return std::max( minChunkSize, vk_div_round_up( size, g_MaxTransferChunkCount ) );
+    }
+
+    static void CopyMemory( VkQueue queue, uint8_t* pDst, const uint8_t* pSrc, size_t size )
+    {
+        queue->m_Device->m_ExecutionCounters.RecordCopy( size );
+
+        // Chunks of overlapping ranges would overwrite the source of other chunks.
+        if( size <= g_CopyChunkSize || vk_memory_overlaps( pDst, pSrc, size ) )
+        {
+            return vk_copy_memory( pDst, pSrc, size );
+        }
+
+        const size_t chunkSize = GetTransferChunkSize( size, g_CopyChunkSize );
+        const size_t chunkCount = vk_div_round_up( size, chunkSize );
+
+        queue->m_Device->m_ThreadPool.ParallelFor( chunkCount, [&]( size_t chunkIndex ) {
+            const size_t offset = chunkIndex * chunkSize;
+            vk_copy_memory( pDst + offset, pSrc + offset, std::min( chunkSize, size - offset ) );
+        } );
+    }
+
+    // Copies of resources bound to the memory instances of peer devices are limited by
+    // the bandwidth of the link between the devices.
+    static void ChargePeerTransfer( VkQueue queue, uint32_t peerMemoryMask, size_t size )
+    {
+        if( !( peerMemoryMask & queue->m_DeviceMask ) )
+        {
+            return;
+        }
+
+        queue->m_Device->m_ExecutionCounters.RecordPeerCopy( size );
+
+        const uint64_t bandwidth = queue->m_Device->m_PhysicalDevice->m_PeerMemoryBandwidth;
+        if( bandwidth )
+        {
+            std::this_thread::sleep_for( std::chrono::nanoseconds(
+                static_cast<int64_t>( double( size ) * 1e9 / double( bandwidth ) ) ) );
+        }
+    }
+
+    // Location of a box of texel blocks in memory.
+    struct BlockRegion
+    {
+        uint8_t* pData;
+        VkDeviceSize rowPitch;
+        VkDeviceSize slicePitch;
+    };
+
+    static void CopyBlocks( VkQueue queue, const BlockRegion& dst, const BlockRegion& src, size_t rowSize, uint32_t rowCount, uint32_t sliceCount )
+    {
+        // Rows and slices stored contiguously in both regions are merged into longer copies.
+        if( dst.rowPitch == rowSize && src.rowPitch == rowSize )
+        {
+            const VkDeviceSize sliceSize = rowSize * rowCount;
+            const bool contiguousSlices = ( dst.slicePitch == sliceSize && src.slicePitch == sliceSize );
+
+            rowSize *= rowCount;
+            rowCount = 1;
+
+            if( contiguousSlices )
+            {
+                rowSize *= sliceCount;
+                sliceCount = 1;
+            }
+        }
+
+        const size_t totalRowCount = size_t( rowCount ) * sliceCount;
+        if( totalRowCount == 1 )
+        {
+            return CopyMemory( queue, dst.pData, src.pData, rowSize );
+        }
+
+        queue->m_Device->m_ExecutionCounters.RecordCopy( totalRowCount * rowSize );
+
+        // Rows are distributed between the threads in chunks of similar size as buffer copies.
+        const size_t rowsPerChunk = GetTransferChunkSize( totalRowCount, std::max<size_t>( g_CopyChunkSize / std::max<size_t>( rowSize, 1 ), 1 ) );
+        const size_t chunkCount = ( totalRowCount + rowsPerChunk - 1 ) / rowsPerChunk;
+
+        queue->m_Device->m_ThreadPool.ParallelFor( chunkCount, [&]( size_t chunkIndex ) {
+            const size_t firstRow = chunkIndex * rowsPerChunk;
+            const size_t lastRow = std::min( firstRow + rowsPerChunk, totalRowCount );
+
+            for( size_t row = firstRow; row < lastRow; ++row )
+            {
+                const size_t slice = row / rowCount;
+                const size_t y = row % rowCount;
+                vk_copy_memory(
+                    dst.pData + slice * dst.slicePitch + y * dst.rowPitch,
+                    src.pData + slice * src.slicePitch + y * src.rowPitch,
+                    rowSize );
+            }
+        } );
+    }
+
+    static uint32_t GetLayerCount( VkImage image, const VkImageSubresourceLayers& subresource )
+    {
+        if( subresource.layerCount == VK_REMAINING_ARRAY_LAYERS )
+        {
+            return image->m_ArrayLayers - subresource.baseArrayLayer;
+        }
+
+        return subresource.layerCount;
+    }
+
+    static uint32_t GetSliceCount( VkImage image, const VkImageSubresourceLayers& subresource, const VkExtent3D& extent )
+    {
+        // Depth slices of 3D images are copied like the layers of array images.
+        if( image->m_ImageType == VK_IMAGE_TYPE_3D )
+        {
+            return vk_div_round_up( extent.depth, image->m_FormatInfo.blockExtent.depth );
+        }
+
+        return GetLayerCount( image, subresource );
+    }
+
+    static BlockRegion GetImageBlockRegion( VkImage image, const VkImageSubresourceLayers& subresource, const VkOffset3D& offset, uint32_t* pBlockSize )
+    {
+        const VkImageSubresource imageSubresource = { subresource.aspectMask, subresource.mipLevel, subresource.baseArrayLayer };
+
+        VkSubresourceLayout layout;
+        uint8_t* pData = image->GetSubresourceData( imageSubresource, &layout );
+
+        const FormatInfo& formatInfo = image->m_FormatInfo;
+        const uint32_t planeIndex = image->GetPlaneIndex( subresource.aspectMask );
+        const uint32_t blockSize = formatInfo.planes[ planeIndex ].blockSize * image->m_Samples;
+
+        BlockRegion region;
+        region.pData = pData +
+            ( static_cast<uint32_t>( offset.z ) / formatInfo.blockExtent.depth ) * layout.depthPitch +
+            ( static_cast<uint32_t>( offset.y ) / formatInfo.blockExtent.height ) * layout.rowPitch +
+            ( static_cast<uint32_t>( offset.x ) / formatInfo.blockExtent.width ) * blockSize;
+        region.rowPitch = layout.rowPitch;
+        region.slicePitch = ( image->m_ImageType == VK_IMAGE_TYPE_3D ) ? layout.depthPitch : layout.arrayPitch;
+
+        *pBlockSize = blockSize;
+        return region;
+    }
+
+    static BlockRegion GetBufferBlockRegion( VkBuffer buffer, VkImage image, const VkBufferImageCopy& copy, uint32_t blockSize )
+    {
+        const VkExtent3D& blockExtent = image->m_FormatInfo.blockExtent;
+        const uint32_t rowLength = copy.bufferRowLength ? copy.bufferRowLength : copy.imageExtent.width;
+        const uint32_t imageHeight = copy.bufferImageHeight ? copy.bufferImageHeight : copy.imageExtent.height;
+
+        BlockRegion region;
+        region.pData = buffer->m_pData + copy.bufferOffset;
+        region.rowPitch = VkDeviceSize( vk_div_round_up( rowLength, blockExtent.width ) ) * blockSize;
+        region.slicePitch = VkDeviceSize( vk_div_round_up( imageHeight, blockExtent.height ) ) * region.rowPitch;
+        return region;
+    }
+
+    struct CopyBufferImageCommandData
+    {
+        VkBuffer buffer;
+        VkImage image;
+        uint32_t regionCount;
+    };
+
+    static_assert( sizeof( CopyBufferImageCommandData ) <= sizeof( VkMockCommandEXT::data ),
+        "Command data size exceeds VkMockCommandEXT::data size" );
+
+    template<bool toImage>
+    static void ExecuteCopyBufferImage( VkQueue queue, VkMockCommandEXT* pCommand )
+    {
+        const CopyBufferImageCommandData& cmdData = *reinterpret_cast<const CopyBufferImageCommandData*>( pCommand->data.u64 );
+        const VkExtent3D& blockExtent = cmdData.image->m_FormatInfo.blockExtent;
+
+        for( uint32_t i = 0; i < cmdData.regionCount; ++i )
+        {
+            VkBufferImageCopy copy;
+            CommandBuffer::ReadPayload( pCommand, i * sizeof( copy ), &copy, sizeof( copy ) );
+
+            uint32_t blockSize;
+            const BlockRegion imageRegion = GetImageBlockRegion( cmdData.image, copy.imageSubresource, copy.imageOffset, &blockSize );
+            const BlockRegion bufferRegion = GetBufferBlockRegion( cmdData.buffer, cmdData.image, copy, blockSize );
+
+            const size_t rowSize = size_t( vk_div_round_up( copy.imageExtent.width, blockExtent.width ) ) * blockSize;
+            const uint32_t rowCount = vk_div_round_up( copy.imageExtent.height, blockExtent.height );
+            const uint32_t sliceCount = GetSliceCount( cmdData.image, copy.imageSubresource, copy.imageExtent );
+
+            ChargePeerTransfer( queue,
+                cmdData.buffer->m_PeerMemoryMask | cmdData.image->m_PeerMemoryMask,
+                rowSize * rowCount * sliceCount );
+
+            if( toImage )
+            {
+                CopyBlocks( queue, imageRegion, bufferRegion, rowSize, rowCount, sliceCount );
+            }
+            else
+            {
+                CopyBlocks( queue, bufferRegion, imageRegion, rowSize, rowCount, sliceCount );
+            }
+        }
+    }
+
+    struct CopyImageCommandData
+    {
+        VkImage srcImage;
+        VkImage dstImage;
+        uint32_t regionCount;
+    };
+
+    static_assert( sizeof( CopyImageCommandData ) <= sizeof( VkMockCommandEXT::data ),
+        "Command data size exceeds VkMockCommandEXT::data size" );
+
+    static void ExecuteCopyImage( VkQueue queue, VkMockCommandEXT* pCommand )
+    {
+        const CopyImageCommandData& cmdData = *reinterpret_cast<const CopyImageCommandData*>( pCommand->data.u64 );
+
+        // Copies between compatible formats are bitwise, including copies between
+        // compressed and uncompressed formats with the same block size. The extent
+        // is given in texels of the source image.
+        const VkExtent3D& blockExtent = cmdData.srcImage->m_FormatInfo.blockExtent;
+
+        for( uint32_t i = 0; i < cmdData.regionCount; ++i )
+        {
+            VkImageCopy copy;
+            CommandBuffer::ReadPayload( pCommand, i * sizeof( copy ), &copy, sizeof( copy ) );
+
+            uint32_t srcBlockSize, dstBlockSize;
+            const BlockRegion srcRegion = GetImageBlockRegion( cmdData.srcImage, copy.srcSubresource, copy.srcOffset, &srcBlockSize );
+            const BlockRegion dstRegion = GetImageBlockRegion( cmdData.dstImage, copy.dstSubresource, copy.dstOffset, &dstBlockSize );
+
+            const size_t rowSize = size_t( vk_div_round_up( copy.extent.width, blockExtent.width ) ) * srcBlockSize;
+            const uint32_t rowCount = vk_div_round_up( copy.extent.height, blockExtent.height );
+
+            // 2D array layers may be copied to 3D slices and vice versa.
+            const uint32_t sliceCount = std::max(
+                GetSliceCount( cmdData.srcImage, copy.srcSubresource, copy.extent ),
+                GetSliceCount( cmdData.dstImage, copy.dstSubresource, copy.extent ) );
+
+            ChargePeerTransfer( queue,
+                cmdData.srcImage->m_PeerMemoryMask | cmdData.dstImage->m_PeerMemoryMask,
+                rowSize * rowCount * sliceCount );
+
+            CopyBlocks( queue, dstRegion, srcRegion, rowSize, rowCount, sliceCount );
+        }
+    }
+
+    struct BlitImageCommandData
+    {
+        VkImage srcImage;
+        VkImage dstImage;
+        VkFilter filter;
+        uint32_t regionCount;
+    };
+
+    static_assert( sizeof( BlitImageCommandData ) <= sizeof( VkMockCommandEXT::data ),
+        "Command data size exceeds VkMockCommandEXT::data size" );
+
+    static void ExecuteBlitImage( VkQueue queue, VkMockCommandEXT* pCommand )
+    {
+        const BlitImageCommandData& cmdData = *reinterpret_cast<const BlitImageCommandData*>( pCommand->data.u64 );
+
+        for( uint32_t i = 0; i < cmdData.regionCount; ++i )
+        {
+            VkImageBlit blit;
+            CommandBuffer::ReadPayload( pCommand, i * sizeof( blit ), &blit, sizeof( blit ) );
+
+            BlitImageRegion( queue->m_Device->m_ThreadPool, cmdData.srcImage, cmdData.dstImage, blit, cmdData.filter );
+        }
+    }
+
+    struct ResolveImageCommandData
+    {
+        VkImage srcImage;
+        VkImage dstImage;
+        uint32_t regionCount;
+    };
+
+    static_assert( sizeof( ResolveImageCommandData ) <= sizeof( VkMockCommandEXT::data ),
+        "Command data size exceeds VkMockCommandEXT::data size" );
+
+    static void ExecuteResolveImage( VkQueue queue, VkMockCommandEXT* pCommand )
+    {
+        const ResolveImageCommandData& cmdData = *reinterpret_cast<const ResolveImageCommandData*>( pCommand->data.u64 );
+
+        for( uint32_t i = 0; i < cmdData.regionCount; ++i )
+        {
+            VkImageResolve resolve;
+            CommandBuffer::ReadPayload( pCommand, i * sizeof( resolve ), &resolve, sizeof( resolve ) );
+
+            ResolveImageRegion( queue->m_Device->m_ThreadPool, cmdData.srcImage, cmdData.dstImage, resolve );
+        }
+    }
+
+    struct DispatchCommandData
+    {
+        VkPipeline pipeline;
+        VkBuffer indirectBuffer;
+        VkDeviceSize indirectOffset;
+        uint32_t baseGroup[ 3 ];
+        uint32_t groupCount[ 3 ];
+        uint32_t descriptorSetCount;
+        uint32_t pushConstantsSize;
+    };
+
+    static_assert( sizeof( DispatchCommandData ) <= sizeof( VkMockCommandEXT::data ),
+        "Command data size exceeds VkMockCommandEXT::data size" );
+
+    // Payload of the dispatch and draw commands contains the bound descriptor sets, followed by
+    // the dynamic offsets of each set and the push constants. Only the dynamic offsets actually
+    // used by the sets are stored.
+    static size_t WriteResourcesPayload( const ComputeState& state, uint8_t* pPayload )
+    {
+        size_t payloadSize = 0;
+
+        memcpy( pPayload, state.m_DescriptorSets, state.m_DescriptorSetCount * sizeof( VkDescriptorSet ) );
+        payloadSize += state.m_DescriptorSetCount * sizeof( VkDescriptorSet );
+
+        for( uint32_t i = 0; i < state.m_DescriptorSetCount; ++i )
+        {
+            if( const VkDescriptorSet set = state.m_DescriptorSets[ i ] )
+            {
+                const size_t dynamicOffsetsSize = set->m_DynamicDescriptorCount * sizeof( uint32_t );
+                memcpy( pPayload + payloadSize, state.m_DynamicOffsets[ i ], dynamicOffsetsSize );
+                payloadSize += dynamicOffsetsSize;
+            }
+        }
+
+        memcpy( pPayload + payloadSize, state.m_PushConstants, state.m_PushConstantsSize );
+        payloadSize += state.m_PushConstantsSize;
+
+        return payloadSize;
+    }
+
+    static void ReadResourcesPayload( const VkMockCommandEXT* pCommand, size_t offset, ComputeState& state )
+    {
+        CommandBuffer::ReadPayload( pCommand, offset, state.m_DescriptorSets, state.m_DescriptorSetCount * sizeof( VkDescriptorSet ) );
+        offset += state.m_DescriptorSetCount * sizeof( VkDescriptorSet );
+
+        for( uint32_t i = 0; i < state.m_DescriptorSetCount; ++i )
+        {
+            if( const VkDescriptorSet set = state.m_DescriptorSets[ i ] )
+            {
+                const size_t dynamicOffsetsSize = set->m_DynamicDescriptorCount * sizeof( uint32_t );
+                CommandBuffer::ReadPayload( pCommand, offset, state.m_DynamicOffsets[ i ], dynamicOffsetsSize );
+                offset += dynamicOffsetsSize;
+            }
+        }
+
+        memset( state.m_PushConstants, 0, sizeof( state.m_PushConstants ) );
+        CommandBuffer::ReadPayload( pCommand, offset, state.m_PushConstants, state.m_PushConstantsSize );
+    }
+
+    static void ExecuteDispatch( VkQueue queue, VkMockCommandEXT* pCommand )
+    {
+        const DispatchCommandData& cmdData = *reinterpret_cast<const DispatchCommandData*>( pCommand->data.u64 );
+
+        ComputeState state;
+        state.m_Pipeline = cmdData.pipeline;
+        state.m_DescriptorSetCount = cmdData.descriptorSetCount;
+        state.m_PushConstantsSize = cmdData.pushConstantsSize;
+        ReadResourcesPayload( pCommand, 0, state );
+
+        uint32_t groupCount[ 3 ] = { cmdData.groupCount[ 0 ], cmdData.groupCount[ 1 ], cmdData.groupCount[ 2 ] };
+
+        // Indirect arguments are read when the command is executed, so they may be written by the previous commands.
+        if( cmdData.indirectBuffer )
+        {
+            VkDispatchIndirectCommand indirectCommand = {};
+
+            const VkBuffer indirectBuffer = cmdData.indirectBuffer;
+            if( indirectBuffer->m_pData && cmdData.indirectOffset + sizeof( indirectCommand ) <= indirectBuffer->m_Size )
+            {
+                memcpy( &indirectCommand, indirectBuffer->m_pData + cmdData.indirectOffset, sizeof( indirectCommand ) );
+            }
+
+            groupCount[ 0 ] = indirectCommand.x;
+            groupCount[ 1 ] = indirectCommand.y;
+            groupCount[ 2 ] = indirectCommand.z;
+        }
+
+        // Host kernels are called once per workgroup, SPIR-V kernels run all invocations of the workgroup.
+        const uint64_t workgroupCount = uint64_t( groupCount[ 0 ] ) * groupCount[ 1 ] * groupCount[ 2 ];
+        uint64_t workgroupSize = 1;
+
+        if( state.m_Pipeline->m_pfnKernel == SpirvProgram::Execute )
+        {
+            const uint32_t* pLocalSize = state.m_Pipeline->m_Program.m_LocalSize;
+            workgroupSize = std::max<uint64_t>( uint64_t( pLocalSize[ 0 ] ) * pLocalSize[ 1 ] * pLocalSize[ 2 ], 1 );
+        }
+
+        queue->m_Device->m_DrawCounters.RecordDispatch( workgroupCount, workgroupCount * workgroupSize );
+
+        DispatchWorkgroups( queue->m_Device->m_ThreadPool, state, cmdData.baseGroup, groupCount );
+    }
+
+    static void FillBlocks( VkQueue queue, const BlockRegion& dst, const void* pTexel, size_t texelSize, size_t rowSize, uint32_t rowCount, uint32_t sliceCount )
+    {
+        // Rows are filled separately because the padding at the end of each row
+        // shifts the pattern, unless the rows are stored contiguously.
+        if( dst.rowPitch == rowSize )
+        {
+            const bool contiguousSlices = ( dst.slicePitch == rowSize * rowCount );
+
+            rowSize *= rowCount;
+            rowCount = 1;
+
+            if( contiguousSlices )
+            {
+                rowSize *= sliceCount;
+                sliceCount = 1;
+            }
+        }
+
+        const size_t totalRowCount = size_t( rowCount ) * sliceCount;
+        const size_t rowsPerChunk = GetTransferChunkSize( totalRowCount, std::max<size_t>( g_CopyChunkSize / std::max<size_t>( rowSize, 1 ), 1 ) );
+
+        if( totalRowCount == 1 && rowSize > g_CopyChunkSize )
+        {
+            // Split a single long row into chunks of whole texels.
+            const size_t chunkSize = vk_div_round_up( GetTransferChunkSize( rowSize, g_CopyChunkSize ), texelSize ) * texelSize;
+            const size_t chunkCount = ( rowSize + chunkSize - 1 ) / chunkSize;
+
+            queue->m_Device->m_ThreadPool.ParallelFor( chunkCount, [&]( size_t chunkIndex ) {
+                const size_t offset = chunkIndex * chunkSize;
+                vk_fill_memory_pattern( dst.pData + offset, pTexel, texelSize, std::min( chunkSize, rowSize - offset ) );
+            } );
+            return;
+        }
+
+        const size_t chunkCount = ( totalRowCount + rowsPerChunk - 1 ) / rowsPerChunk;
+
+        queue->m_Device->m_ThreadPool.ParallelFor( chunkCount, [&]( size_t chunkIndex ) {
+            const size_t firstRow = chunkIndex * rowsPerChunk;
+            const size_t lastRow = std::min( firstRow + rowsPerChunk, totalRowCount );
+
+            for( size_t row = firstRow; row < lastRow; ++row )
+            {
+                const size_t slice = row / rowCount;
+                const size_t y = row % rowCount;
+                vk_fill_memory_pattern(
+                    dst.pData + slice * dst.slicePitch + y * dst.rowPitch,
+                    pTexel, texelSize, rowSize );
+            }
+        } );
+    }
+
+    // The clear value is encoded once at record time. Depth/stencil images keep
+    // a separate texel for each aspect plane.
+    struct ClearImageCommandData
+    {
+        VkImage image;
+        uint32_t rangeCount;
+        uint8_t texelSizes[ 2 ];
+        uint8_t texels[ 2 ][ 16 ];
+    };
+
+    static_assert( sizeof( ClearImageCommandData ) <= sizeof( VkMockCommandEXT::data ),
+        "Command data size exceeds VkMockCommandEXT::data size" );
+
+    static void ExecuteClearImage( VkQueue queue, VkMockCommandEXT* pCommand )
+    {
+        const ClearImageCommandData& cmdData = *reinterpret_cast<const ClearImageCommandData*>( pCommand->data.u64 );
+        const VkImage image = cmdData.image;
+
+        for( uint32_t i = 0; i < cmdData.rangeCount; ++i )
+        {
+            VkImageSubresourceRange range;
+            CommandBuffer::ReadPayload( pCommand, i * sizeof( range ), &range, sizeof( range ) );
+
+            const uint32_t levelCount = ( range.levelCount == VK_REMAINING_MIP_LEVELS )
+                ? image->m_MipLevels - range.baseMipLevel
+                : range.levelCount;
+
+            const uint32_t layerCount = ( range.layerCount == VK_REMAINING_ARRAY_LAYERS )
+                ? image->m_ArrayLayers - range.baseArrayLayer
+                : range.layerCount;
+
+            for( uint32_t planeIndex = 0; planeIndex < image->m_FormatInfo.planeCount; ++planeIndex )
+            {
+                const VkImageAspectFlagBits aspect = image->m_FormatInfo.planes[ planeIndex ].aspect;
+                const size_t texelSize = cmdData.texelSizes[ planeIndex ];
+
+                if( !( range.aspectMask & aspect ) || !texelSize )
+                {
+                    continue;
+                }
+
+                for( uint32_t mipLevel = range.baseMipLevel; mipLevel < range.baseMipLevel + levelCount; ++mipLevel )
+                {
+                    const VkImageSubresource subresource = { aspect, mipLevel, range.baseArrayLayer };
+
+                    VkSubresourceLayout layout;
+                    uint8_t* pData = image->GetSubresourceData( subresource, &layout );
+
+                    const VkExtent3D extent = image->GetMipLevelExtent( planeIndex, mipLevel );
+                    const bool is3D = ( image->m_ImageType == VK_IMAGE_TYPE_3D );
+
+                    BlockRegion region;
+                    region.pData = pData;
+                    region.rowPitch = layout.rowPitch;
+                    region.slicePitch = is3D ? layout.depthPitch : layout.arrayPitch;
+
+                    // Samples of each texel are stored next to each other, so they are cleared as one row.
+                    const size_t rowSize = size_t( extent.width ) * image->m_Samples * texelSize;
+
+                    FillBlocks( queue, region, cmdData.texels[ planeIndex ], texelSize,
+                        rowSize, extent.height, is3D ? extent.depth : layerCount );
+                }
+            }
+        }
+    }
+
+    // Attachments with VK_ATTACHMENT_LOAD_OP_CLEAR are cleared within the render area
+    // when the rendering begins.
+    struct ClearAttachmentCommandData
+    {
+        VkImage image;
+        VkImageSubresource subresource;
+        VkRect2D rect;
+        uint32_t layerCount;
+        uint8_t texelSize;
+        uint8_t texel[ 16 ];
+    };
+
+    static_assert( sizeof( ClearAttachmentCommandData ) <= sizeof( VkMockCommandEXT::data ),
+        "Command data size exceeds VkMockCommandEXT::data size" );
+
+    static void ExecuteClearAttachment( VkQueue queue, VkMockCommandEXT* pCommand )
+    {
+        const ClearAttachmentCommandData& cmdData = *reinterpret_cast<const ClearAttachmentCommandData*>( pCommand->data.u64 );
+        const VkImage image = cmdData.image;
+        const uint32_t planeIndex = image->GetPlaneIndex( cmdData.subresource.aspectMask );
+
+        if( !image->m_Planes[ planeIndex ].m_pData )
+        {
+            return;
+        }
+
+        const VkExtent3D extent = image->GetMipLevelExtent( planeIndex, cmdData.subresource.mipLevel );
+        const uint32_t x = std::min<uint32_t>( cmdData.rect.offset.x, extent.width );
+        const uint32_t y = std::min<uint32_t>( cmdData.rect.offset.y, extent.height );
+        const uint32_t width = std::min( cmdData.rect.extent.width, extent.width - x );
+        const uint32_t height = std::min( cmdData.rect.extent.height, extent.height - y );
+        const uint32_t layerCount = std::min( cmdData.layerCount, image->m_ArrayLayers - cmdData.subresource.arrayLayer );
+
+        if( !width || !height )
+        {
+            return;
+        }
+
+        VkSubresourceLayout layout;
+        uint8_t* pData = image->GetSubresourceData( cmdData.subresource, &layout );
+
+        // Samples of each texel are stored next to each other, so they are cleared as one row.
+        const size_t texelSize = cmdData.texelSize;
+        const size_t sampleSize = texelSize * image->m_Samples;
+
+        BlockRegion region;
+        region.pData = pData + y * layout.rowPitch + x * sampleSize;
+        region.rowPitch = layout.rowPitch;
+        region.slicePitch = layout.arrayPitch;
+
+        FillBlocks( queue, region, cmdData.texel, texelSize, width * sampleSize, height, layerCount );
+    }
+
+    struct DrawCommandData
+    {
+        VkPipeline pipeline;
+        uint32_t vertexCount;
+        uint32_t instanceCount;
+        uint32_t firstVertex;
+        uint32_t firstInstance;
+        int32_t vertexOffset;
+        uint32_t indexed;
+        uint32_t indirect;
+        uint32_t descriptorSetCount;
+        uint32_t pushConstantsSize;
+        VertexCacheInfo vertexCache;
+    };
+
+    static_assert( sizeof( DrawCommandData ) <= sizeof( VkMockCommandEXT::data ),
+        "Command data size exceeds VkMockCommandEXT::data size" );
+
+    // Indices are read when the draw is executed, and the vertex count of the indexed draws is
+    // clamped to the indices available in the index buffer. Returns the number of vertex shader
+    // invocations of a single instance of the draw.
+    static uint32_t ResolveDraw( VkQueue queue, const IndexBufferBinding& indexBuffer, const VertexCacheInfo& vertexCache,
+        bool indexed, const VkDrawIndexedIndirectCommand& command, DrawParameters* pDraw )
+    {
+        *pDraw = {};
+        pDraw->m_VertexCount = command.indexCount;
+        pDraw->m_InstanceCount = command.instanceCount;
+        pDraw->m_FirstVertex = command.firstIndex;
+        pDraw->m_FirstInstance = command.firstInstance;
+        pDraw->m_VertexOffset = command.vertexOffset;
+
+        if( !indexed )
+        {
+            return pDraw->m_VertexCount;
+        }
+
+        pDraw->m_IndexSize = GetIndexSize( indexBuffer.m_IndexType );
+        pDraw->m_pIndices = GetIndexData( indexBuffer.m_Buffer, indexBuffer.m_Offset, indexBuffer.m_IndexType,
+            command.firstIndex, &pDraw->m_VertexCount );
+
+        return CountVertexShaderInvocations( queue->m_Device->m_Allocator, vertexCache,
+            pDraw->m_pIndices, pDraw->m_IndexSize, pDraw->m_VertexCount );
+    }
+
+    static void ExecuteDraw( VkQueue queue, VkMockCommandEXT* pCommand )
+    {
+        const DrawCommandData& cmdData = *reinterpret_cast<const DrawCommandData*>( pCommand->data.u64 );
+
+        // Payload contains the location of the indirect arguments (for indirect draws only),
+        // followed by the draw state and the bound resources.
+        IndirectDrawInfo indirect = {};
+        size_t payloadOffset = 0;
+
+        if( cmdData.indirect )
+        {
+            CommandBuffer::ReadPayload( pCommand, 0, &indirect, sizeof( indirect ) );
+            payloadOffset += sizeof( indirect );
+        }
+
+        DrawState state;
+        CommandBuffer::ReadPayload( pCommand, payloadOffset, &state, sizeof( state ) );
+
+        ComputeState resources;
+        resources.m_Pipeline = cmdData.pipeline;
+        resources.m_DescriptorSetCount = cmdData.descriptorSetCount;
+        resources.m_PushConstantsSize = cmdData.pushConstantsSize;
+        ReadResourcesPayload( pCommand, payloadOffset + sizeof( state ), resources );
+
+        const VkDrawIndexedIndirectCommand command = {
+            cmdData.vertexCount, cmdData.instanceCount, cmdData.firstVertex, cmdData.vertexOffset, cmdData.firstInstance };
+
+        const uint32_t drawCount = cmdData.indirect ? GetIndirectDrawCount( indirect, cmdData.indexed ) : 1;
+
+        for( uint32_t drawIndex = 0; drawIndex < drawCount; ++drawIndex )
+        {
+            DrawParameters draw;
+            const uint32_t invocationCount = ResolveDraw( queue, state.m_IndexBuffer, cmdData.vertexCache, cmdData.indexed,
+                cmdData.indirect ? ReadIndirectDraw( indirect, cmdData.indexed, drawIndex ) : command, &draw );
+
+            queue->m_Device->m_DrawCounters.RecordDraw(
+                uint64_t( draw.m_VertexCount ) * draw.m_InstanceCount,
+                uint64_t( invocationCount ) * draw.m_InstanceCount );
+
+            const RasterStatistics statistics = DrawPrimitives( queue->m_Device->m_ThreadPool, resources, state, draw );
+
+            queue->m_Device->m_DrawCounters.RecordRasterization(
+                statistics.m_PrimitiveCount,
+                statistics.m_FragmentShaderInvocations,
+                statistics.m_SamplesPassed );
+        }
+
+        if( cmdData.indirect )
+        {
+            queue->m_Device->m_DrawCounters.RecordIndirectCommand( drawCount );
+        }
+    }
+
+    struct DrawCostCommandData
+    {
+        IndexBufferBinding indexBuffer;
+        uint32_t vertexCount;
+        uint32_t instanceCount;
+        uint32_t firstIndex;
+        uint32_t indexed;
+        uint32_t indirect;
+        VertexCacheInfo vertexCache;
+        VkPrimitiveTopology topology;
+    };
+
+    static_assert( sizeof( DrawCostCommandData ) <= sizeof( VkMockCommandEXT::data ),
+        "Command data size exceeds VkMockCommandEXT::data size" );
+
+    // Draws that are not rasterized wait 1ns for each vertex shader invocation, and pass
+    // one fragment per primitive. Payload of the indirect draws contains the location of the arguments.
+    static void ExecuteDrawCost( VkQueue queue, VkMockCommandEXT* pCommand )
+    {
+        const DrawCostCommandData& cmdData = *reinterpret_cast<const DrawCostCommandData*>( pCommand->data.u64 );
+
+        IndirectDrawInfo indirect = {};
+        if( cmdData.indirect )
+        {
+            CommandBuffer::ReadPayload( pCommand, 0, &indirect, sizeof( indirect ) );
+        }
+
+        const VkDrawIndexedIndirectCommand command = {
+            cmdData.vertexCount, cmdData.instanceCount, cmdData.firstIndex, 0, 0 };
+
+        const uint32_t drawCount = cmdData.indirect ? GetIndirectDrawCount( indirect, cmdData.indexed ) : 1;
+        uint64_t totalInvocationCount = 0;
+
+        for( uint32_t drawIndex = 0; drawIndex < drawCount; ++drawIndex )
+        {
+            DrawParameters draw;
+            const uint32_t invocationCount = ResolveDraw( queue, cmdData.indexBuffer, cmdData.vertexCache, cmdData.indexed,
+                cmdData.indirect ? ReadIndirectDraw( indirect, cmdData.indexed, drawIndex ) : command, &draw );
+
+            const uint64_t instanceInvocationCount = uint64_t( invocationCount ) * draw.m_InstanceCount;
+            totalInvocationCount += instanceInvocationCount;
+
+            queue->m_Device->m_DrawCounters.RecordDraw(
+                uint64_t( draw.m_VertexCount ) * draw.m_InstanceCount,
+                instanceInvocationCount );
+
+            const uint64_t primitiveCount = uint64_t( GetPrimitiveCount( cmdData.topology, draw.m_VertexCount ) ) * draw.m_InstanceCount;
+
+            queue->m_Device->m_DrawCounters.RecordRasterization(
+                primitiveCount, primitiveCount, primitiveCount );
+        }
+
+        if( cmdData.indirect )
+        {
+            queue->m_Device->m_DrawCounters.RecordIndirectCommand( drawCount );
+        }
+
+        std::this_thread::sleep_for(
+            std::chrono::nanoseconds( totalInvocationCount ) );
+    }
+
     CommandBuffer::CommandBuffer( VkDevice device, VkCommandPool commandPool )
-        : m_CommandPool( commandPool )
+        : m_Device( device )
+        , m_CommandPool( commandPool )
         , m_Commands( 0, commandPool->m_Allocator )
+        , m_ComputeState()
+        , m_GraphicsState()
+    {
+        m_pMockFunctions = device->m_pMockFunctions;
+        m_CommandPool->m_CommandBuffers.push_back( GetApiHandle() );
+    }
+
+    CommandBuffer::~CommandBuffer()
+    {
+        Reset();
+
+        auto iter = std::remove(
+            m_CommandPool->m_CommandBuffers.begin(),
+            m_CommandPool->m_CommandBuffers.end(),
+            GetApiHandle() );
+
+        if( iter != m_CommandPool->m_CommandBuffers.end() )
+        {
+            m_CommandPool->m_CommandBuffers.erase( iter );
+        }
+    }
+
+    void CommandBuffer::Reset()
+    {
+        for( VkMockCommandEXT& cmd : m_Commands )
+        {
+            if( cmd.pfnFree )
+            {
+                cmd.pfnFree( &cmd );
+            }
+        }
+
+        m_Commands.clear();
+
+        memset( &m_ComputeState, 0, sizeof( m_ComputeState ) );
+        memset( &m_GraphicsState, 0, sizeof( m_GraphicsState ) );
+    }
+
+    void CommandBuffer::AppendPayload( const void* pData, size_t size )
+    {
+        // Payload is stored inline in the command stream, in the entries following
+        // the command that consumes it. The entries have no callbacks, so they are
+        // skipped by the queue.
+        const uint8_t* pBytes = static_cast<const uint8_t*>( pData );
+
+        for( size_t offset = 0; offset < size; offset += sizeof( VkMockCommandEXT::data ) )
+        {
+            VkMockCommandEXT payload = {};
+            memcpy( payload.data.u8, pBytes + offset,
+                std::min( size - offset, sizeof( VkMockCommandEXT::data ) ) );
+
+            m_Commands.push_back( payload );
+        }
+    }
+
+    void CommandBuffer::ReadPayload( const VkMockCommandEXT* pCommand, size_t offset, void* pData, size_t size )
+    {
+        constexpr size_t entrySize = sizeof( VkMockCommandEXT::data );
+        uint8_t* pBytes = static_cast<uint8_t*>( pData );
+
+        while( size > 0 )
+        {
+            const VkMockCommandEXT* pPayload = pCommand + 1 + offset / entrySize;
+            const size_t entryOffset = offset % entrySize;
+            const size_t copySize = std::min( size, entrySize - entryOffset );
+
+            memcpy( pBytes, pPayload->data.u8 + entryOffset, copySize );
+            pBytes += copySize;
+            offset += copySize;
+            size -= copySize;
+        }
+    }
+
+    VkResult CommandBuffer::vkBeginCommandBuffer( const VkCommandBufferBeginInfo* pBeginInfo )
+    {
+        Reset();
+
+        if( m_pMockFunctions->vkBeginCommandBuffer )
+        {
+            return m_pMockFunctions->vkBeginCommandBuffer(
+                GetApiHandle(),
+                pBeginInfo );
+        }
+
+        const VkDeviceGroupCommandBufferBeginInfo* pDeviceGroupBeginInfo = vk_find_struct<VkDeviceGroupCommandBufferBeginInfo>(
+            pBeginInfo->pNext, VK_STRUCTURE_TYPE_DEVICE_GROUP_COMMAND_BUFFER_BEGIN_INFO );
+        if( pDeviceGroupBeginInfo )
+        {
+            RecordSetDeviceMask( pDeviceGroupBeginInfo->deviceMask );
+        }
+
+        return VK_SUCCESS;
+    }
+
+    VkResult CommandBuffer::vkResetCommandBuffer( VkCommandBufferResetFlags flags )
+    {
+        Reset();
+
+        if( m_pMockFunctions->vkResetCommandBuffer )
+        {
+            return m_pMockFunctions->vkResetCommandBuffer(
+                GetApiHandle(),
+                flags );
+        }
+
+        return VK_SUCCESS;
+    }
+
+    void CommandBuffer::vkCmdBeginRendering( const VkRenderingInfo* pRenderingInfo )
+    {
+        if( m_pMockFunctions->vkCmdBeginRendering )
+        {
+            return m_pMockFunctions->vkCmdBeginRendering(
+                GetApiHandle(),
+                pRenderingInfo );
+        }
+
+        RenderingState& rendering = m_GraphicsState.m_Draw.m_Rendering;
+        memset( &rendering, 0, sizeof( rendering ) );
+
+        rendering.m_RenderArea = pRenderingInfo->renderArea;
+        rendering.m_ColorAttachmentCount = std::min( pRenderingInfo->colorAttachmentCount, g_MaxColorAttachments );
+
+        for( uint32_t i = 0; i < rendering.m_ColorAttachmentCount; ++i )
+        {
+            rendering.m_ColorAttachments[ i ] = pRenderingInfo->pColorAttachments[ i ].imageView;
+        }
+
+        if( pRenderingInfo->pDepthAttachment )
+        {
+            rendering.m_DepthAttachment = pRenderingInfo->pDepthAttachment->imageView;
+        }
+
+        m_GraphicsState.m_Rendering = true;
+
+        // Attachments are not accessed unless the software rasterizer is enabled, and the
+        // render passes resumed from the previous ones do not load the attachments.
+        if( m_Device->m_Rasterizer != VK_MOCK_RASTERIZER_SOFTWARE_EXT ||
+            ( pRenderingInfo->flags & VK_RENDERING_RESUMING_BIT ) )
+        {
+            return;
+        }
+
+        const uint32_t layerCount = std::max( pRenderingInfo->layerCount, 1U );
+
+        for( uint32_t i = 0; i < pRenderingInfo->colorAttachmentCount; ++i )
+        {
+            RecordClearAttachment( pRenderingInfo->pColorAttachments[ i ], VK_IMAGE_ASPECT_COLOR_BIT, pRenderingInfo->renderArea, layerCount );
+        }
+
+        if( pRenderingInfo->pDepthAttachment )
+        {
+            RecordClearAttachment( *pRenderingInfo->pDepthAttachment, VK_IMAGE_ASPECT_DEPTH_BIT, pRenderingInfo->renderArea, layerCount );
+        }
+
+        if( pRenderingInfo->pStencilAttachment )
+        {
+            RecordClearAttachment( *pRenderingInfo->pStencilAttachment, VK_IMAGE_ASPECT_STENCIL_BIT, pRenderingInfo->renderArea, layerCount );
+        }
+    }
+
+    void CommandBuffer::vkCmdEndRendering()
+    {
+        if( m_pMockFunctions->vkCmdEndRendering )
+        {
+            return m_pMockFunctions->vkCmdEndRendering(
+                GetApiHandle() );
+        }
+
+        m_GraphicsState.m_Rendering = false;
+    }
+
+#ifdef VK_KHR_dynamic_rendering
+    void CommandBuffer::vkCmdBeginRenderingKHR( const VkRenderingInfoKHR* pRenderingInfo )
+    {
+        if( m_pMockFunctions->vkCmdBeginRenderingKHR )
+        {
+            return m_pMockFunctions->vkCmdBeginRenderingKHR(
+                GetApiHandle(),
+                pRenderingInfo );
+        }
+
+        vkCmdBeginRendering( pRenderingInfo );
+    }
+
+    void CommandBuffer::vkCmdEndRenderingKHR()
+    {
+        if( m_pMockFunctions->vkCmdEndRenderingKHR )
+        {
+            return m_pMockFunctions->vkCmdEndRenderingKHR(
+                GetApiHandle() );
+        }
+
+        vkCmdEndRendering();
+    }
+#endif
+
+    void CommandBuffer::RecordClearAttachment( const VkRenderingAttachmentInfo& attachment, VkImageAspectFlagBits aspect, const VkRect2D& renderArea, uint32_t layerCount )
+    {
+        const VkImageView view = attachment.imageView;
+        if( !view || attachment.loadOp != VK_ATTACHMENT_LOAD_OP_CLEAR || !( view->m_Image->m_FormatInfo.aspectMask & aspect ) )
+        {
+            return;
+        }
+
+        const TexelFormat texelFormat = GetTexelFormat( view->m_Format, aspect );
+        if( texelFormat.numericFormat == TexelNumericFormat::eUnknown )
+        {
+            return;
+        }
+
+        VkClearColorValue value = attachment.clearValue.color;
+        if( aspect == VK_IMAGE_ASPECT_DEPTH_BIT )
+        {
+            value = {};
+            value.float32[ 0 ] = attachment.clearValue.depthStencil.depth;
+        }
+        else if( aspect == VK_IMAGE_ASPECT_STENCIL_BIT )
+        {
+            value = {};
+            value.uint32[ 0 ] = attachment.clearValue.depthStencil.stencil;
+        }
+
+        VkMockCommandEXT command = {};
+        ClearAttachmentCommandData& cmdData = *reinterpret_cast<ClearAttachmentCommandData*>( command.data.u64 );
+        cmdData.image = view->m_Image;
+        cmdData.subresource.aspectMask = aspect;
+        cmdData.subresource.mipLevel = view->m_SubresourceRange.baseMipLevel;
+        cmdData.subresource.arrayLayer = view->m_SubresourceRange.baseArrayLayer;
+        cmdData.rect = renderArea;
+        cmdData.layerCount = layerCount;
+        cmdData.texelSize = texelFormat.size;
+        PackTexel( texelFormat, value, cmdData.texel );
+        command.pfnExecute = &ExecuteClearAttachment;
+
+        m_Commands.push_back( command );
+    }
+
+    void CommandBuffer::vkCmdSetViewport( uint32_t firstViewport, uint32_t viewportCount, const VkViewport* pViewports )
+    {
+        if( m_pMockFunctions->vkCmdSetViewport )
+        {
+            return m_pMockFunctions->vkCmdSetViewport(
+                GetApiHandle(),
+                firstViewport,
+                viewportCount,
+                pViewports );
+        }
+
+        // Only the first viewport is used by the rasterizer.
+        if( firstViewport == 0 && viewportCount > 0 )
+        {
+            m_GraphicsState.m_Draw.m_Viewport = pViewports[ 0 ];
+        }
+    }
+
+    void CommandBuffer::vkCmdSetScissor( uint32_t firstScissor, uint32_t scissorCount, const VkRect2D* pScissors )
+    {
+        if( m_pMockFunctions->vkCmdSetScissor )
+        {
+            return m_pMockFunctions->vkCmdSetScissor(
+                GetApiHandle(),
+                firstScissor,
+                scissorCount,
+                pScissors );
+        }
+
+        if( firstScissor == 0 && scissorCount > 0 )
+        {
+            m_GraphicsState.m_Draw.m_Scissor = pScissors[ 0 ];
+        }
+    }
+
+    void CommandBuffer::vkCmdSetBlendConstants( const float blendConstants[ 4 ] )
+    {
+        if( m_pMockFunctions->vkCmdSetBlendConstants )
+        {
+            return m_pMockFunctions->vkCmdSetBlendConstants(
+                GetApiHandle(),
+                blendConstants );
+        }
+
+        memcpy( m_GraphicsState.m_Draw.m_BlendConstants, blendConstants, sizeof( m_GraphicsState.m_Draw.m_BlendConstants ) );
+    }
+
+    void CommandBuffer::vkCmdBindVertexBuffers( uint32_t firstBinding, uint32_t bindingCount, const VkBuffer* pBuffers, const VkDeviceSize* pOffsets )
+    {
+        if( m_pMockFunctions->vkCmdBindVertexBuffers )
+        {
+            return m_pMockFunctions->vkCmdBindVertexBuffers(
+                GetApiHandle(),
+                firstBinding,
+                bindingCount,
+                pBuffers,
+                pOffsets );
+        }
+
+        bindingCount = std::min( bindingCount, g_MaxVertexBindings - std::min( firstBinding, g_MaxVertexBindings ) );
+
+        for( uint32_t i = 0; i < bindingCount; ++i )
+        {
+            m_GraphicsState.m_Draw.m_VertexBuffers[ firstBinding + i ] = pBuffers[ i ];
+            m_GraphicsState.m_Draw.m_VertexBufferOffsets[ firstBinding + i ] = pOffsets[ i ];
+        }
+    }
+
+    void CommandBuffer::vkCmdBindIndexBuffer( VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType )
+    {
+        if( m_pMockFunctions->vkCmdBindIndexBuffer )
+        {
+            return m_pMockFunctions->vkCmdBindIndexBuffer(
+                GetApiHandle(),
+                buffer,
+                offset,
+                indexType );
+        }
+
+        IndexBufferBinding& indexBuffer = m_GraphicsState.m_Draw.m_IndexBuffer;
+        indexBuffer.m_Buffer = buffer;
+        indexBuffer.m_Offset = offset;
+        indexBuffer.m_IndexType = indexType;
+    }
+
+    void CommandBuffer::vkCmdDraw( uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance )
+    {
+        if( m_pMockFunctions->vkCmdDraw )
+        {
+            return m_pMockFunctions->vkCmdDraw(
+                GetApiHandle(),
+                vertexCount,
+                instanceCount,
+                firstVertex,
+                firstInstance );
+        }
+
+        if( UseRasterizer() )
+        {
+            return RecordDraw( vertexCount, instanceCount, firstVertex, firstInstance, 0, false, nullptr );
+        }
+
+        RecordDrawCost( vertexCount, instanceCount, firstVertex, false, nullptr );
+    }
+
+    void CommandBuffer::vkCmdDrawIndexed( uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance )
+    {
+        if( m_pMockFunctions->vkCmdDrawIndexed )
+        {
+            return m_pMockFunctions->vkCmdDrawIndexed(
+                GetApiHandle(),
+                indexCount,
+                instanceCount,
+                firstIndex,
+                vertexOffset,
+                firstInstance );
+        }
+
+        if( UseRasterizer() )
+        {
+            return RecordDraw( indexCount, instanceCount, firstIndex, firstInstance, vertexOffset, true, nullptr );
+        }
+
+        RecordDrawCost( indexCount, instanceCount, firstIndex, true, nullptr );
+    }
+
+    void CommandBuffer::vkCmdDrawIndirect( VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride )
+    {
+        if( m_pMockFunctions->vkCmdDrawIndirect )
+        {
+            return m_pMockFunctions->vkCmdDrawIndirect(
+                GetApiHandle(),
+                buffer,
+                offset,
+                drawCount,
+                stride );
+        }
+
+        RecordDrawIndirect( { buffer, offset, VK_NULL_HANDLE, 0, drawCount, stride }, false );
+    }
+
+    void CommandBuffer::vkCmdDrawIndexedIndirect( VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride )
+    {
+        if( m_pMockFunctions->vkCmdDrawIndexedIndirect )
+        {
+            return m_pMockFunctions->vkCmdDrawIndexedIndirect(
+                GetApiHandle(),
+                buffer,
+                offset,
+                drawCount,
+                stride );
+        }
+
+        RecordDrawIndirect( { buffer, offset, VK_NULL_HANDLE, 0, drawCount, stride }, true );
+    }
+
+    void CommandBuffer::vkCmdDrawIndirectCount( VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride )
+    {
+        if( m_pMockFunctions->vkCmdDrawIndirectCount )
+        {
+            return m_pMockFunctions->vkCmdDrawIndirectCount(
+                GetApiHandle(),
+                buffer,
+                offset,
+                countBuffer,
+                countBufferOffset,
+                maxDrawCount,
+                stride );
+        }
+
+        RecordDrawIndirect( { buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride }, false );
+    }
+
+    void CommandBuffer::vkCmdDrawIndexedIndirectCount( VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride )
+    {
+        if( m_pMockFunctions->vkCmdDrawIndexedIndirectCount )
+        {
+            return m_pMockFunctions->vkCmdDrawIndexedIndirectCount(
+                GetApiHandle(),
+                buffer,
+                offset,
+                countBuffer,
+                countBufferOffset,
+                maxDrawCount,
+                stride );
+        }
+
+        RecordDrawIndirect( { buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride }, true );
+    }
+
+#ifdef VK_KHR_draw_indirect_count
+    void CommandBuffer::vkCmdDrawIndirectCountKHR( VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride )
+    {
+        if( m_pMockFunctions->vkCmdDrawIndirectCountKHR )
+        {
+            return m_pMockFunctions->vkCmdDrawIndirectCountKHR(
+                GetApiHandle(),
+                buffer,
+                offset,
+                countBuffer,
+                countBufferOffset,
+                maxDrawCount,
+                stride );
+        }
+
+        vkCmdDrawIndirectCount( buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride );
+    }
+
+    void CommandBuffer::vkCmdDrawIndexedIndirectCountKHR( VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride )
+    {
+        if( m_pMockFunctions->vkCmdDrawIndexedIndirectCountKHR )
+        {
+            return m_pMockFunctions->vkCmdDrawIndexedIndirectCountKHR(
+                GetApiHandle(),
+                buffer,
+                offset,
+                countBuffer,
+                countBufferOffset,
+                maxDrawCount,
+                stride );
+        }
+
+        vkCmdDrawIndexedIndirectCount( buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride );
+    }
+#endif
+
+    void CommandBuffer::RecordDrawIndirect( const IndirectDrawInfo& indirect, bool indexed )
+    {
+        if( UseRasterizer() )
+        {
+            return RecordDraw( 0, 0, 0, 0, 0, indexed, &indirect );
+        }
+
+        RecordDrawCost( 0, 0, 0, indexed, &indirect );
+    }
+
+    bool CommandBuffer::UseRasterizer() const
+    {
+        return m_Device->m_Rasterizer == VK_MOCK_RASTERIZER_SOFTWARE_EXT &&
+            m_GraphicsState.m_Rendering &&
+            m_GraphicsState.m_Resources.m_Pipeline;
+    }
+
+    void CommandBuffer::RecordDrawCost( uint32_t vertexCount, uint32_t instanceCount, uint32_t firstIndex, bool indexed, const IndirectDrawInfo* pIndirect )
+    {
+        // Indices and indirect arguments are read when the command is executed, so the cache
+        // simulation sees the contents of the buffers written by the preceding commands.
+        VkMockCommandEXT command = {};
+        DrawCostCommandData& cmdData = *reinterpret_cast<DrawCostCommandData*>( command.data.u64 );
+        cmdData.vertexCount = vertexCount;
+        cmdData.instanceCount = instanceCount;
+        cmdData.firstIndex = firstIndex;
+        cmdData.indexed = indexed;
+        cmdData.indirect = ( pIndirect != nullptr );
+        cmdData.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        const VkPipeline pipeline = m_GraphicsState.m_Resources.m_Pipeline;
+        if( pipeline && pipeline->m_BindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS )
+        {
+            cmdData.topology = pipeline->m_Graphics.m_Topology;
+        }
+
+        if( indexed )
+        {
+            cmdData.indexBuffer = m_GraphicsState.m_Draw.m_IndexBuffer;
+            cmdData.vertexCache = m_Device->m_VertexCache;
+        }
+
+        command.pfnExecute = ExecuteDrawCost;
+
+        m_Commands.push_back( command );
+
+        if( pIndirect )
+        {
+            AppendPayload( pIndirect, sizeof( IndirectDrawInfo ) );
+        }
+    }
+
+    void CommandBuffer::RecordDraw( uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance, int32_t vertexOffset, bool indexed, const IndirectDrawInfo* pIndirect )
+    {
+        const ComputeState& resources = m_GraphicsState.m_Resources;
+        const GraphicsPipelineState& pipeline = resources.m_Pipeline->m_Graphics;
+
+        VkMockCommandEXT command = {};
+        DrawCommandData& cmdData = *reinterpret_cast<DrawCommandData*>( command.data.u64 );
+        cmdData.pipeline = resources.m_Pipeline;
+        cmdData.vertexCount = vertexCount;
+        cmdData.instanceCount = instanceCount;
+        cmdData.firstVertex = firstVertex;
+        cmdData.firstInstance = firstInstance;
+        cmdData.vertexOffset = vertexOffset;
+        cmdData.indexed = indexed;
+        cmdData.indirect = ( pIndirect != nullptr );
+        cmdData.descriptorSetCount = resources.m_DescriptorSetCount;
+        cmdData.pushConstantsSize = resources.m_PushConstantsSize;
+        cmdData.vertexCache = m_Device->m_VertexCache;
+        command.pfnExecute = ExecuteDraw;
+
+        // Static state of the pipeline replaces the dynamic state set in the command buffer.
+        DrawState state = m_GraphicsState.m_Draw;
+
+        if( !( pipeline.m_DynamicStateMask & eGraphicsDynamicStateViewport ) )
+        {
+            state.m_Viewport = pipeline.m_Viewport;
+        }
+
+        if( !( pipeline.m_DynamicStateMask & eGraphicsDynamicStateScissor ) )
+        {
+            state.m_Scissor = pipeline.m_Scissor;
+        }
+
+        if( !( pipeline.m_DynamicStateMask & eGraphicsDynamicStateBlendConstants ) )
+        {
+            memcpy( state.m_BlendConstants, pipeline.m_BlendConstants, sizeof( state.m_BlendConstants ) );
+        }
+
+        uint8_t payload[ sizeof( IndirectDrawInfo ) + sizeof( DrawState ) + sizeof( ComputeState ) ];
+        size_t payloadSize = 0;
+
+        if( pIndirect )
+        {
+            memcpy( payload, pIndirect, sizeof( IndirectDrawInfo ) );
+            payloadSize += sizeof( IndirectDrawInfo );
+        }
+
+        memcpy( payload + payloadSize, &state, sizeof( state ) );
+        payloadSize += sizeof( state );
+        payloadSize += WriteResourcesPayload( resources, payload + payloadSize );
+
+        m_Commands.push_back( command );
+        AppendPayload( payload, payloadSize );
+    }
+
+    void CommandBuffer::vkCmdBindPipeline( VkPipelineBindPoint pipelineBindPoint, VkPipeline pipeline )
+    {
+        if( m_pMockFunctions->vkCmdBindPipeline )
+        {
+            return m_pMockFunctions->vkCmdBindPipeline(
+                GetApiHandle(),
+                pipelineBindPoint,
+                pipeline );
+        }
+
+        if( pipelineBindPoint == VK_PIPELINE_BIND_POINT_COMPUTE )
+        {
+            m_ComputeState.m_Pipeline = pipeline;
+        }
+
+        if( pipelineBindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS )
+        {
+            m_GraphicsState.m_Resources.m_Pipeline = pipeline;
+        }
+    }
+
+    void CommandBuffer::vkCmdBindDescriptorSets( VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout layout, uint32_t firstSet, uint32_t descriptorSetCount, const VkDescriptorSet* pDescriptorSets, uint32_t dynamicOffsetCount, const uint32_t* pDynamicOffsets )
+    {
+        if( m_pMockFunctions->vkCmdBindDescriptorSets )
+        {
+            return m_pMockFunctions->vkCmdBindDescriptorSets(
+                GetApiHandle(),
+                pipelineBindPoint,
+                layout,
+                firstSet,
+                descriptorSetCount,
+                pDescriptorSets,
+                dynamicOffsetCount,
+                pDynamicOffsets );
+        }
+
+        if( pipelineBindPoint != VK_PIPELINE_BIND_POINT_COMPUTE &&
+            pipelineBindPoint != VK_PIPELINE_BIND_POINT_GRAPHICS )
+        {
+            return;
+        }
+
+        ComputeState& state = ( pipelineBindPoint == VK_PIPELINE_BIND_POINT_COMPUTE )
+            ? m_ComputeState
+            : m_GraphicsState.m_Resources;
+
+        descriptorSetCount = std::min( descriptorSetCount, g_MaxBoundDescriptorSets - std::min( firstSet, g_MaxBoundDescriptorSets ) );
+
+        // Dynamic offsets are given for all dynamic descriptors of the bound sets, in the order of the sets.
+        for( uint32_t i = 0; i < descriptorSetCount; ++i )
+        {
+            const VkDescriptorSet set = pDescriptorSets[ i ];
+            state.m_DescriptorSets[ firstSet + i ] = set;
+
+            if( set && dynamicOffsetCount )
+            {
+                const uint32_t count = std::min( set->m_DynamicDescriptorCount, dynamicOffsetCount );
+                memcpy( state.m_DynamicOffsets[ firstSet + i ], pDynamicOffsets, count * sizeof( uint32_t ) );
+                pDynamicOffsets += count;
+                dynamicOffsetCount -= count;
+            }
+        }
+
+        state.m_DescriptorSetCount = std::max( state.m_DescriptorSetCount, firstSet + descriptorSetCount );
+    }
+
+    void CommandBuffer::vkCmdPushConstants( VkPipelineLayout layout, VkShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* pValues )
+    {
+        if( m_pMockFunctions->vkCmdPushConstants )
+        {
+            return m_pMockFunctions->vkCmdPushConstants(
+                GetApiHandle(),
+                layout,
+                stageFlags,
+                offset,
+                size,
+                pValues );
+        }
+
+        if( offset >= g_MaxPushConstantsSize )
+        {
+            return;
+        }
+
+        size = std::min( size, g_MaxPushConstantsSize - offset );
+
+        // Push constants are shared by all bind points.
+        for( ComputeState* pState : { &m_ComputeState, &m_GraphicsState.m_Resources } )
+        {
+            memcpy( pState->m_PushConstants + offset, pValues, size );
+            pState->m_PushConstantsSize = std::max( pState->m_PushConstantsSize, offset + size );
+        }
+    }
+
+    void CommandBuffer::vkCmdDispatch( uint32_t x, uint32_t y, uint32_t z )
+    {
+        if( m_pMockFunctions->vkCmdDispatch )
+        {
+            return m_pMockFunctions->vkCmdDispatch(
+                GetApiHandle(),
+                x, y, z );
+        }
+
+        RecordDispatch( 0, 0, 0, x, y, z, VK_NULL_HANDLE, 0 );
+    }
+
+    void CommandBuffer::vkCmdDispatchBase( uint32_t baseGroupX, uint32_t baseGroupY, uint32_t baseGroupZ, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ )
+    {
+        if( m_pMockFunctions->vkCmdDispatchBase )
+        {
+            return m_pMockFunctions->vkCmdDispatchBase(
+                GetApiHandle(),
+                baseGroupX, baseGroupY, baseGroupZ,
+                groupCountX, groupCountY, groupCountZ );
+        }
+
+        RecordDispatch( baseGroupX, baseGroupY, baseGroupZ, groupCountX, groupCountY, groupCountZ, VK_NULL_HANDLE, 0 );
+    }
+
+#ifdef VK_KHR_device_group
+    void CommandBuffer::vkCmdDispatchBaseKHR( uint32_t baseGroupX, uint32_t baseGroupY, uint32_t baseGroupZ, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ )
+    {
+        if( m_pMockFunctions->vkCmdDispatchBaseKHR )
+        {
+            return m_pMockFunctions->vkCmdDispatchBaseKHR(
+                GetApiHandle(),
+                baseGroupX, baseGroupY, baseGroupZ,
+                groupCountX, groupCountY, groupCountZ );
+        }
+
+        vkCmdDispatchBase( baseGroupX, baseGroupY, baseGroupZ, groupCountX, groupCountY, groupCountZ );
+    }
+#endif
+
+    void CommandBuffer::vkCmdDispatchIndirect( VkBuffer buffer, VkDeviceSize offset )
+    {
+        if( m_pMockFunctions->vkCmdDispatchIndirect )
+        {
+            return m_pMockFunctions->vkCmdDispatchIndirect(
+                GetApiHandle(),
+                buffer,
+                offset );
+        }
+
+        RecordDispatch( 0, 0, 0, 0, 0, 0, buffer, offset );
+    }
+
+    void CommandBuffer::vkCmdSetDeviceMask( uint32_t deviceMask )
+    {
+        if( m_pMockFunctions->vkCmdSetDeviceMask )
+        {
+            return m_pMockFunctions->vkCmdSetDeviceMask(
+                GetApiHandle(),
+                deviceMask );
+        }
+
+        RecordSetDeviceMask( deviceMask );
+    }
+
+#ifdef VK_KHR_device_group
+    void CommandBuffer::vkCmdSetDeviceMaskKHR( uint32_t deviceMask )
+    {
+        if( m_pMockFunctions->vkCmdSetDeviceMaskKHR )
+        {
+            return m_pMockFunctions->vkCmdSetDeviceMaskKHR(
+                GetApiHandle(),
+                deviceMask );
+        }
+
+        vkCmdSetDeviceMask( deviceMask );
+    }
+#endif
+
+    void CommandBuffer::RecordSetDeviceMask( uint32_t deviceMask )
+    {
+        struct CommandData
+        {
+            uint32_t deviceMask;
+        };
+
+        static_assert( sizeof( CommandData ) <= sizeof( VkMockCommandEXT::data ),
+            "Command data size exceeds VkMockCommandEXT::data size" );
+
+        VkMockCommandEXT command = {};
+        CommandData& cmdData = *reinterpret_cast<CommandData*>( command.data.u64 );
+        cmdData.deviceMask = deviceMask;
+
+        // Commands recorded after the mask is set only execute on the devices that the
+        // command buffer has been submitted to.
+        command.pfnExecute = []( VkQueue queue, VkMockCommandEXT* pCommand ) {
+            CommandData& cmdData = *reinterpret_cast<CommandData*>( pCommand->data.u64 );
+            queue->m_DeviceMask = cmdData.deviceMask & queue->m_SubmitDeviceMask;
+        };
+
+        m_Commands.push_back( command );
+    }
+
+    void CommandBuffer::RecordDispatch( uint32_t baseGroupX, uint32_t baseGroupY, uint32_t baseGroupZ, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ, VkBuffer indirectBuffer, VkDeviceSize indirectOffset )
+    {
+        const ComputeState& state = m_ComputeState;
+        if( !state.m_Pipeline )
+        {
+            return;
+        }
+
+        VkMockCommandEXT command = {};
+        DispatchCommandData& cmdData = *reinterpret_cast<DispatchCommandData*>( command.data.u64 );
+        cmdData.pipeline = state.m_Pipeline;
+        cmdData.indirectBuffer = indirectBuffer;
+        cmdData.indirectOffset = indirectOffset;
+        cmdData.baseGroup[ 0 ] = baseGroupX;
+        cmdData.baseGroup[ 1 ] = baseGroupY;
+        cmdData.baseGroup[ 2 ] = baseGroupZ;
+        cmdData.groupCount[ 0 ] = groupCountX;
+        cmdData.groupCount[ 1 ] = groupCountY;
+        cmdData.groupCount[ 2 ] = groupCountZ;
+        cmdData.descriptorSetCount = state.m_DescriptorSetCount;
+        cmdData.pushConstantsSize = state.m_PushConstantsSize;
+        command.pfnExecute = ExecuteDispatch;
+
+        // The bound state is captured at record time.
+        uint8_t payload[ sizeof( ComputeState ) ];
+        const size_t payloadSize = WriteResourcesPayload( state, payload );
+
+        m_Commands.push_back( command );
+        AppendPayload( payload, payloadSize );
+    }
+
+    void CommandBuffer::vkCmdExecuteCommands( uint32_t commandBufferCount, const VkCommandBuffer* pCommandBuffers )
+    {
+        if( m_pMockFunctions->vkCmdExecuteCommands )
+        {
+            return m_pMockFunctions->vkCmdExecuteCommands(
+                GetApiHandle(),
+                commandBufferCount,
+                pCommandBuffers );
+        }
+
+        for( uint32_t i = 0; i < commandBufferCount; ++i )
+        {
+            VkMockCommandEXT command = {};
+            command.data.ptr = pCommandBuffers[ i ];
+            command.pfnExecute = []( VkQueue queue, VkMockCommandEXT* pCommand ) {
+                queue->ExecuteCommandBuffer( static_cast<VkCommandBuffer>( pCommand->data.ptr ) );
+            };
+
+            m_Commands.push_back( command );
+        }
+    }
+
+    void CommandBuffer::vkCmdBeginQuery( VkQueryPool queryPool, uint32_t query, VkQueryControlFlags flags )
+    {
+        struct CommandData
+        {
+            VkQueryPool queryPool;
+            uint32_t query;
+        };
+
+        static_assert( sizeof( CommandData ) <= sizeof( VkMockCommandEXT::data ),
+            "Command data size exceeds VkMockCommandEXT::data size" );
+
+        if( m_pMockFunctions->vkCmdBeginQuery )
+        {
+            return m_pMockFunctions->vkCmdBeginQuery(
+                GetApiHandle(),
+                queryPool,
+                query,
+                flags );
+        }
+
+        VkMockCommandEXT command = {};
+        CommandData& cmdData = *reinterpret_cast<CommandData*>( command.data.u64 );
+        cmdData.queryPool = queryPool;
+        cmdData.query = query;
+
+        // Occlusion queries are always precise, so VK_QUERY_CONTROL_PRECISE_BIT is ignored.
+        command.pfnExecute = []( VkQueue queue, VkMockCommandEXT* pCommand ) {
+            CommandData& cmdData = *reinterpret_cast<CommandData*>( pCommand->data.u64 );
+            cmdData.queryPool->Begin( queue, cmdData.query );
+        };
+
+        m_Commands.push_back( command );
+    }
+
+    void CommandBuffer::vkCmdEndQuery( VkQueryPool queryPool, uint32_t query )
+    {
+        struct CommandData
+        {
+            VkQueryPool queryPool;
+            uint32_t query;
+        };
+
+        static_assert( sizeof( CommandData ) <= sizeof( VkMockCommandEXT::data ),
+            "Command data size exceeds VkMockCommandEXT::data size" );
+
+        if( m_pMockFunctions->vkCmdEndQuery )
+        {
+            return m_pMockFunctions->vkCmdEndQuery(
+                GetApiHandle(),
+                queryPool,
+                query );
+        }
+
+        VkMockCommandEXT command = {};
+        CommandData& cmdData = *reinterpret_cast<CommandData*>( command.data.u64 );
+        cmdData.queryPool = queryPool;
+        cmdData.query = query;
+
+        command.pfnExecute = []( VkQueue queue, VkMockCommandEXT* pCommand ) {
+            CommandData& cmdData = *reinterpret_cast<CommandData*>( pCommand->data.u64 );
+            cmdData.queryPool->End( queue, cmdData.query );
+        };
+
+        m_Commands.push_back( command );
+    }
+
+    void CommandBuffer::vkCmdResetQueryPool( VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount )
+    {
+        struct CommandData
+        {
+            VkQueryPool queryPool;
+            uint32_t firstQuery;
+            uint32_t queryCount;
+        };
+
+        static_assert( sizeof( CommandData ) <= sizeof( VkMockCommandEXT::data ),
+            "Command data size exceeds VkMockCommandEXT::data size" );
+
+        if( m_pMockFunctions->vkCmdResetQueryPool )
+        {
+            return m_pMockFunctions->vkCmdResetQueryPool(
+                GetApiHandle(),
+                queryPool,
+                firstQuery,
+                queryCount );
+        }
+
+        VkMockCommandEXT command = {};
+        CommandData& cmdData = *reinterpret_cast<CommandData*>( command.data.u64 );
+        cmdData.queryPool = queryPool;
+        cmdData.firstQuery = firstQuery;
+        cmdData.queryCount = queryCount;
+
+        command.pfnExecute = []( VkQueue, VkMockCommandEXT* pCommand ) {
+            CommandData& cmdData = *reinterpret_cast<CommandData*>( pCommand->data.u64 );
+            cmdData.queryPool->Reset( cmdData.firstQuery, cmdData.queryCount );
+        };
+
+        m_Commands.push_back( command );
+    }
+
+    void CommandBuffer::vkCmdWriteTimestamp( VkPipelineStageFlagBits pipelineStage, VkQueryPool queryPool, uint32_t query )
+    {
+        struct CommandData
+        {
+            VkQueryPool queryPool;
+            uint32_t query;
+        };
+
+        static_assert( sizeof( CommandData ) <= sizeof( VkMockCommandEXT::data ),
+            "Command data size exceeds VkMockCommandEXT::data size" );
+
+        if( m_pMockFunctions->vkCmdWriteTimestamp )
+        {
+            return m_pMockFunctions->vkCmdWriteTimestamp(
+                GetApiHandle(),
+                pipelineStage,
+                queryPool,
+                query );
+        }
+
+        VkMockCommandEXT command = {};
+        CommandData& cmdData = *reinterpret_cast<CommandData*>( command.data.u64 );
+        cmdData.queryPool = queryPool;
+        cmdData.query = query;
+
+        command.pfnExecute = []( VkQueue queue, VkMockCommandEXT* pCommand ) {
+            CommandData& cmdData = *reinterpret_cast<CommandData*>( pCommand->data.u64 );
+            cmdData.queryPool->WriteTimestamp( cmdData.query, queue->m_Device->m_PhysicalDevice->m_Clock.Now() );
+        };
+
+        m_Commands.push_back( command );
+    }
+
+    void CommandBuffer::vkCmdCopyBuffer( VkBuffer srcBuffer, VkBuffer dstBuffer, uint32_t regionCount, const VkBufferCopy* pRegions )
+    {
+        struct CommandData
+        {
+            VkBuffer srcBuffer;
+            VkBuffer dstBuffer;
+            VkBufferCopy region;
+        };
+
+        static_assert( sizeof( CommandData ) <= sizeof( VkMockCommandEXT::data ),
+            "Command data size exceeds VkMockCommandEXT::data size" );
+
+        if( m_pMockFunctions->vkCmdCopyBuffer )
+        {
+            return m_pMockFunctions->vkCmdCopyBuffer(
+                GetApiHandle(),
+                srcBuffer,
+                dstBuffer,
+                regionCount,
+                pRegions );
+        }
+
+        for( uint32_t i = 0; i < regionCount; ++i )
+        {
+            VkMockCommandEXT command = {};
+            CommandData& cmdData = *reinterpret_cast<CommandData*>( command.data.u64 );
+            cmdData.srcBuffer = srcBuffer;
+            cmdData.dstBuffer = dstBuffer;
+            cmdData.region = pRegions[ i ];
+
+            command.pfnExecute = []( VkQueue queue, VkMockCommandEXT* pCommand ) {
+                CommandData& cmdData = *reinterpret_cast<CommandData*>( pCommand->data.u64 );
+                ChargePeerTransfer( queue,
+                    cmdData.srcBuffer->m_PeerMemoryMask | cmdData.dstBuffer->m_PeerMemoryMask,
+                    static_cast<size_t>( cmdData.region.size ) );
+                CopyMemory( queue,
+                    cmdData.dstBuffer->m_pData + cmdData.region.dstOffset,
+                    cmdData.srcBuffer->m_pData + cmdData.region.srcOffset,
+                    static_cast<size_t>( cmdData.region.size ) );
+            };
+
+            m_Commands.push_back( command );
+        }
+    }
+
+    void CommandBuffer::vkCmdCopyBufferToImage( VkBuffer srcBuffer, VkImage dstImage, VkImageLayout dstImageLayout, uint32_t regionCount, const VkBufferImageCopy* pRegions )
+    {
+        if( m_pMockFunctions->vkCmdCopyBufferToImage )
+        {
+            return m_pMockFunctions->vkCmdCopyBufferToImage(
+                GetApiHandle(),
+                srcBuffer,
+                dstImage,
+                dstImageLayout,
+                regionCount,
+                pRegions );
+        }
+
+        RecordCopyBufferImage( &ExecuteCopyBufferImage<true>, srcBuffer, dstImage, regionCount, pRegions );
+    }
+
+    void CommandBuffer::vkCmdCopyImageToBuffer( VkImage srcImage, VkImageLayout srcImageLayout, VkBuffer dstBuffer, uint32_t regionCount, const VkBufferImageCopy* pRegions )
+    {
+        if( m_pMockFunctions->vkCmdCopyImageToBuffer )
+        {
+            return m_pMockFunctions->vkCmdCopyImageToBuffer(
+                GetApiHandle(),
+                srcImage,
+                srcImageLayout,
+                dstBuffer,
+                regionCount,
+                pRegions );
+        }
+
+        RecordCopyBufferImage( &ExecuteCopyBufferImage<false>, dstBuffer, srcImage, regionCount, pRegions );
+    }
+
+    void CommandBuffer::vkCmdCopyImage( VkImage srcImage, VkImageLayout srcImageLayout, VkImage dstImage, VkImageLayout dstImageLayout, uint32_t regionCount, const VkImageCopy* pRegions )
     {
-        m_pMockFunctions = device->m_pMockFunctions;
-        m_CommandPool->m_CommandBuffers.push_back( GetApiHandle() );
+        if( m_pMockFunctions->vkCmdCopyImage )
+        {
+            return m_pMockFunctions->vkCmdCopyImage(
+                GetApiHandle(),
+                srcImage,
+                srcImageLayout,
+                dstImage,
+                dstImageLayout,
+                regionCount,
+                pRegions );
+        }
+
+        RecordCopyImage( srcImage, dstImage, regionCount, pRegions );
     }
 
-    CommandBuffer::~CommandBuffer()
+    void CommandBuffer::vkCmdCopyBufferToImage2( const VkCopyBufferToImageInfo2* pCopyBufferToImageInfo )
     {
-        Reset();
+        if( m_pMockFunctions->vkCmdCopyBufferToImage2 )
+        {
+            return m_pMockFunctions->vkCmdCopyBufferToImage2(
+                GetApiHandle(),
+                pCopyBufferToImageInfo );
+        }
 
-        auto iter = std::remove(
-            m_CommandPool->m_CommandBuffers.begin(),
-            m_CommandPool->m_CommandBuffers.end(),
-            GetApiHandle() );
+        std::vector<VkBufferImageCopy, vk_stl_allocator<VkBufferImageCopy>> regions( m_CommandPool->m_Allocator );
+        regions.reserve( pCopyBufferToImageInfo->regionCount );
 
-        if( iter != m_CommandPool->m_CommandBuffers.end() )
+        for( uint32_t i = 0; i < pCopyBufferToImageInfo->regionCount; ++i )
         {
-            m_CommandPool->m_CommandBuffers.erase( iter );
+            const VkBufferImageCopy2& region = pCopyBufferToImageInfo->pRegions[ i ];
+            regions.push_back( { region.bufferOffset, region.bufferRowLength, region.bufferImageHeight,
+                region.imageSubresource, region.imageOffset, region.imageExtent } );
         }
+
+        RecordCopyBufferImage( &ExecuteCopyBufferImage<true>,
+            pCopyBufferToImageInfo->srcBuffer,
+            pCopyBufferToImageInfo->dstImage,
+            pCopyBufferToImageInfo->regionCount,
+            regions.data() );
     }
 
-    void CommandBuffer::Reset()
+    void CommandBuffer::vkCmdCopyImageToBuffer2( const VkCopyImageToBufferInfo2* pCopyImageToBufferInfo )
     {
-        for( VkMockCommandEXT& cmd : m_Commands )
+        if( m_pMockFunctions->vkCmdCopyImageToBuffer2 )
         {
-            if( cmd.pfnFree )
-            {
-                cmd.pfnFree( &cmd );
-            }
+            return m_pMockFunctions->vkCmdCopyImageToBuffer2(
+                GetApiHandle(),
+                pCopyImageToBufferInfo );
         }
 
-        m_Commands.clear();
+        std::vector<VkBufferImageCopy, vk_stl_allocator<VkBufferImageCopy>> regions( m_CommandPool->m_Allocator );
+        regions.reserve( pCopyImageToBufferInfo->regionCount );
+
+        for( uint32_t i = 0; i < pCopyImageToBufferInfo->regionCount; ++i )
+        {
+            const VkBufferImageCopy2& region = pCopyImageToBufferInfo->pRegions[ i ];
+            regions.push_back( { region.bufferOffset, region.bufferRowLength, region.bufferImageHeight,
+                region.imageSubresource, region.imageOffset, region.imageExtent } );
+        }
+
+        RecordCopyBufferImage( &ExecuteCopyBufferImage<false>,
+            pCopyImageToBufferInfo->dstBuffer,
+            pCopyImageToBufferInfo->srcImage,
+            pCopyImageToBufferInfo->regionCount,
+            regions.data() );
     }
 
-    VkResult CommandBuffer::vkBeginCommandBuffer( const VkCommandBufferBeginInfo* pBeginInfo )
+    void CommandBuffer::vkCmdCopyImage2( const VkCopyImageInfo2* pCopyImageInfo )
     {
-        Reset();
+        if( m_pMockFunctions->vkCmdCopyImage2 )
+        {
+            return m_pMockFunctions->vkCmdCopyImage2(
+                GetApiHandle(),
+                pCopyImageInfo );
+        }
 
-        if( m_pMockFunctions->vkBeginCommandBuffer )
+        std::vector<VkImageCopy, vk_stl_allocator<VkImageCopy>> regions( m_CommandPool->m_Allocator );
+        regions.reserve( pCopyImageInfo->regionCount );
+
+        for( uint32_t i = 0; i < pCopyImageInfo->regionCount; ++i )
         {
-            return m_pMockFunctions->vkBeginCommandBuffer(
+            const VkImageCopy2& region = pCopyImageInfo->pRegions[ i ];
+            regions.push_back( { region.srcSubresource, region.srcOffset,
+                region.dstSubresource, region.dstOffset, region.extent } );
+        }
+
+        RecordCopyImage(
+            pCopyImageInfo->srcImage,
+            pCopyImageInfo->dstImage,
+            pCopyImageInfo->regionCount,
+            regions.data() );
+    }
+
+#ifdef VK_KHR_copy_commands2
+    void CommandBuffer::vkCmdCopyBufferToImage2KHR( const VkCopyBufferToImageInfo2KHR* pCopyBufferToImageInfo )
+    {
+        if( m_pMockFunctions->vkCmdCopyBufferToImage2KHR )
+        {
+            return m_pMockFunctions->vkCmdCopyBufferToImage2KHR(
                 GetApiHandle(),
-                pBeginInfo );
+                pCopyBufferToImageInfo );
         }
 
-        return VK_SUCCESS;
+        vkCmdCopyBufferToImage2( pCopyBufferToImageInfo );
     }
 
-    VkResult CommandBuffer::vkResetCommandBuffer( VkCommandBufferResetFlags flags )
+    void CommandBuffer::vkCmdCopyImageToBuffer2KHR( const VkCopyImageToBufferInfo2KHR* pCopyImageToBufferInfo )
     {
-        Reset();
+        if( m_pMockFunctions->vkCmdCopyImageToBuffer2KHR )
+        {
+            return m_pMockFunctions->vkCmdCopyImageToBuffer2KHR(
+                GetApiHandle(),
+                pCopyImageToBufferInfo );
+        }
 
-        if( m_pMockFunctions->vkResetCommandBuffer )
+        vkCmdCopyImageToBuffer2( pCopyImageToBufferInfo );
+    }
+
+    void CommandBuffer::vkCmdCopyImage2KHR( const VkCopyImageInfo2KHR* pCopyImageInfo )
+    {
+        if( m_pMockFunctions->vkCmdCopyImage2KHR )
         {
-            return m_pMockFunctions->vkResetCommandBuffer(
+            return m_pMockFunctions->vkCmdCopyImage2KHR(
                 GetApiHandle(),
-                flags );
+                pCopyImageInfo );
         }
 
-        return VK_SUCCESS;
+        vkCmdCopyImage2( pCopyImageInfo );
     }
+#endif
 
-    void CommandBuffer::vkCmdDraw( uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance )
+    void CommandBuffer::RecordCopyBufferImage( PFN_vkExecuteMockCommandCallbackEXT pfnExecute, VkBuffer buffer, VkImage image, uint32_t regionCount, const VkBufferImageCopy* pRegions )
     {
-        if( m_pMockFunctions->vkCmdDraw )
+        VkMockCommandEXT command = {};
+        CopyBufferImageCommandData& cmdData = *reinterpret_cast<CopyBufferImageCommandData*>( command.data.u64 );
+        cmdData.buffer = buffer;
+        cmdData.image = image;
+        cmdData.regionCount = regionCount;
+        command.pfnExecute = pfnExecute;
+
+        m_Commands.push_back( command );
+        AppendPayload( pRegions, regionCount * sizeof( VkBufferImageCopy ) );
+    }
+
+    void CommandBuffer::RecordCopyImage( VkImage srcImage, VkImage dstImage, uint32_t regionCount, const VkImageCopy* pRegions )
+    {
+        VkMockCommandEXT command = {};
+        CopyImageCommandData& cmdData = *reinterpret_cast<CopyImageCommandData*>( command.data.u64 );
+        cmdData.srcImage = srcImage;
+        cmdData.dstImage = dstImage;
+        cmdData.regionCount = regionCount;
+        command.pfnExecute = &ExecuteCopyImage;
+
+        m_Commands.push_back( command );
+        AppendPayload( pRegions, regionCount * sizeof( VkImageCopy ) );
+    }
+
+    void CommandBuffer::vkCmdBlitImage( VkImage srcImage, VkImageLayout srcImageLayout, VkImage dstImage, VkImageLayout dstImageLayout, uint32_t regionCount, const VkImageBlit* pRegions, VkFilter filter )
+    {
+        if( m_pMockFunctions->vkCmdBlitImage )
         {
-            return m_pMockFunctions->vkCmdDraw(
+            return m_pMockFunctions->vkCmdBlitImage(
                 GetApiHandle(),
-                vertexCount,
-                instanceCount,
-                firstVertex,
-                firstInstance );
+                srcImage,
+                srcImageLayout,
+                dstImage,
+                dstImageLayout,
+                regionCount,
+                pRegions,
+                filter );
+        }
+
+        RecordBlitImage( srcImage, dstImage, regionCount, pRegions, filter );
+    }
+
+    void CommandBuffer::vkCmdBlitImage2( const VkBlitImageInfo2* pBlitImageInfo )
+    {
+        if( m_pMockFunctions->vkCmdBlitImage2 )
+        {
+            return m_pMockFunctions->vkCmdBlitImage2(
+                GetApiHandle(),
+                pBlitImageInfo );
+        }
+
+        std::vector<VkImageBlit, vk_stl_allocator<VkImageBlit>> regions( m_CommandPool->m_Allocator );
+        regions.reserve( pBlitImageInfo->regionCount );
+
+        for( uint32_t i = 0; i < pBlitImageInfo->regionCount; ++i )
+        {
+            const VkImageBlit2& region = pBlitImageInfo->pRegions[ i ];
+            regions.push_back( { region.srcSubresource, { region.srcOffsets[ 0 ], region.srcOffsets[ 1 ] },
+                region.dstSubresource, { region.dstOffsets[ 0 ], region.dstOffsets[ 1 ] } } );
+        }
+
+        RecordBlitImage(
+            pBlitImageInfo->srcImage,
+            pBlitImageInfo->dstImage,
+            pBlitImageInfo->regionCount,
+            regions.data(),
+            pBlitImageInfo->filter );
+    }
+
+#ifdef VK_KHR_copy_commands2
+    void CommandBuffer::vkCmdBlitImage2KHR( const VkBlitImageInfo2KHR* pBlitImageInfo )
+    {
+        if( m_pMockFunctions->vkCmdBlitImage2KHR )
+        {
+            return m_pMockFunctions->vkCmdBlitImage2KHR(
+                GetApiHandle(),
+                pBlitImageInfo );
         }
 
+        vkCmdBlitImage2( pBlitImageInfo );
+    }
+#endif
+
+    void CommandBuffer::RecordBlitImage( VkImage srcImage, VkImage dstImage, uint32_t regionCount, const VkImageBlit* pRegions, VkFilter filter )
+    {
         VkMockCommandEXT command = {};
-        command.data.u32[ 0 ] = vertexCount * instanceCount;
-        command.pfnExecute = []( VkQueue, VkMockCommandEXT* cmd ) {
-            std::this_thread::sleep_for(
-                std::chrono::nanoseconds( cmd->data.u32[ 0 ] ) );
-        };
+        BlitImageCommandData& cmdData = *reinterpret_cast<BlitImageCommandData*>( command.data.u64 );
+        cmdData.srcImage = srcImage;
+        cmdData.dstImage = dstImage;
+        cmdData.filter = filter;
+        cmdData.regionCount = regionCount;
+        command.pfnExecute = &ExecuteBlitImage;
 
         m_Commands.push_back( command );
+        AppendPayload( pRegions, regionCount * sizeof( VkImageBlit ) );
     }
 
-    void CommandBuffer::vkCmdDispatch( uint32_t x, uint32_t y, uint32_t z )
+    void CommandBuffer::vkCmdResolveImage( VkImage srcImage, VkImageLayout srcImageLayout, VkImage dstImage, VkImageLayout dstImageLayout, uint32_t regionCount, const VkImageResolve* pRegions )
     {
-        if( m_pMockFunctions->vkCmdDispatch )
+        if( m_pMockFunctions->vkCmdResolveImage )
         {
-            return m_pMockFunctions->vkCmdDispatch(
+            return m_pMockFunctions->vkCmdResolveImage(
                 GetApiHandle(),
-                x, y, z );
+                srcImage,
+                srcImageLayout,
+                dstImage,
+                dstImageLayout,
+                regionCount,
+                pRegions );
+        }
+
+        RecordResolveImage( srcImage, dstImage, regionCount, pRegions );
+    }
+
+    void CommandBuffer::vkCmdResolveImage2( const VkResolveImageInfo2* pResolveImageInfo )
+    {
+        if( m_pMockFunctions->vkCmdResolveImage2 )
+        {
+            return m_pMockFunctions->vkCmdResolveImage2(
+                GetApiHandle(),
+                pResolveImageInfo );
+        }
+
+        std::vector<VkImageResolve, vk_stl_allocator<VkImageResolve>> regions( m_CommandPool->m_Allocator );
+        regions.reserve( pResolveImageInfo->regionCount );
+
+        for( uint32_t i = 0; i < pResolveImageInfo->regionCount; ++i )
+        {
+            const VkImageResolve2& region = pResolveImageInfo->pRegions[ i ];
+            regions.push_back( { region.srcSubresource, region.srcOffset,
+                region.dstSubresource, region.dstOffset, region.extent } );
+        }
+
+        RecordResolveImage(
+            pResolveImageInfo->srcImage,
+            pResolveImageInfo->dstImage,
+            pResolveImageInfo->regionCount,
+            regions.data() );
+    }
+
+#ifdef VK_KHR_copy_commands2
+    void CommandBuffer::vkCmdResolveImage2KHR( const VkResolveImageInfo2KHR* pResolveImageInfo )
+    {
+        if( m_pMockFunctions->vkCmdResolveImage2KHR )
+        {
+            return m_pMockFunctions->vkCmdResolveImage2KHR(
+                GetApiHandle(),
+                pResolveImageInfo );
         }
 
+        vkCmdResolveImage2( pResolveImageInfo );
+    }
+#endif
+
+    void CommandBuffer::RecordResolveImage( VkImage srcImage, VkImage dstImage, uint32_t regionCount, const VkImageResolve* pRegions )
+    {
         VkMockCommandEXT command = {};
-        command.data.u32[ 0 ] = x * y * z;
-        command.pfnExecute = []( VkQueue, VkMockCommandEXT* cmd ) {
-            std::this_thread::sleep_for(
-                std::chrono::nanoseconds( cmd->data.u32[ 0 ] ) );
-        };
+        ResolveImageCommandData& cmdData = *reinterpret_cast<ResolveImageCommandData*>( command.data.u64 );
+        cmdData.srcImage = srcImage;
+        cmdData.dstImage = dstImage;
+        cmdData.regionCount = regionCount;
+        command.pfnExecute = &ExecuteResolveImage;
 
         m_Commands.push_back( command );
+        AppendPayload( pRegions, regionCount * sizeof( VkImageResolve ) );
     }
 
-    void CommandBuffer::vkCmdExecuteCommands( uint32_t commandBufferCount, const VkCommandBuffer* pCommandBuffers )
+    void CommandBuffer::vkCmdClearColorImage( VkImage image, VkImageLayout imageLayout, const VkClearColorValue* pColor, uint32_t rangeCount, const VkImageSubresourceRange* pRanges )
     {
-        if( m_pMockFunctions->vkCmdExecuteCommands )
+        if( m_pMockFunctions->vkCmdClearColorImage )
         {
-            return m_pMockFunctions->vkCmdExecuteCommands(
+            return m_pMockFunctions->vkCmdClearColorImage(
                 GetApiHandle(),
-                commandBufferCount,
-                pCommandBuffers );
+                image,
+                imageLayout,
+                pColor,
+                rangeCount,
+                pRanges );
         }
 
-        for( uint32_t i = 0; i < commandBufferCount; ++i )
+        VkMockCommandEXT command = {};
+        ClearImageCommandData& cmdData = *reinterpret_cast<ClearImageCommandData*>( command.data.u64 );
+        cmdData.image = image;
+        cmdData.rangeCount = rangeCount;
+
+        // Texels of 64-bit 4-component formats span both texel slots.
+        const TexelFormat texelFormat = GetTexelFormat( image->m_Format, VK_IMAGE_ASPECT_COLOR_BIT );
+        if( texelFormat.numericFormat != TexelNumericFormat::eUnknown )
         {
-            VkMockCommandEXT command = {};
-            command.data.ptr = pCommandBuffers[ i ];
-            command.pfnExecute = []( VkQueue queue, VkMockCommandEXT* pCommand ) {
-                queue->ExecuteCommandBuffer( static_cast<VkCommandBuffer>( pCommand->data.ptr ) );
-            };
+            cmdData.texelSizes[ 0 ] = texelFormat.size;
+            PackTexel( texelFormat, *pColor, cmdData.texels );
+        }
 
-            m_Commands.push_back( command );
+        command.pfnExecute = &ExecuteClearImage;
+
+        m_Commands.push_back( command );
+        AppendPayload( pRanges, rangeCount * sizeof( VkImageSubresourceRange ) );
+    }
+
+    void CommandBuffer::vkCmdClearDepthStencilImage( VkImage image, VkImageLayout imageLayout, const VkClearDepthStencilValue* pDepthStencil, uint32_t rangeCount, const VkImageSubresourceRange* pRanges )
+    {
+        if( m_pMockFunctions->vkCmdClearDepthStencilImage )
+        {
+            return m_pMockFunctions->vkCmdClearDepthStencilImage(
+                GetApiHandle(),
+                image,
+                imageLayout,
+                pDepthStencil,
+                rangeCount,
+                pRanges );
+        }
+
+        VkMockCommandEXT command = {};
+        ClearImageCommandData& cmdData = *reinterpret_cast<ClearImageCommandData*>( command.data.u64 );
+        cmdData.image = image;
+        cmdData.rangeCount = rangeCount;
+
+        for( uint32_t planeIndex = 0; planeIndex < image->m_FormatInfo.planeCount; ++planeIndex )
+        {
+            const VkImageAspectFlagBits aspect = image->m_FormatInfo.planes[ planeIndex ].aspect;
+            const TexelFormat texelFormat = GetTexelFormat( image->m_Format, aspect );
+
+            if( texelFormat.numericFormat == TexelNumericFormat::eUnknown )
+            {
+                continue;
+            }
+
+            VkClearColorValue value = {};
+            if( aspect == VK_IMAGE_ASPECT_DEPTH_BIT )
+            {
+                value.float32[ 0 ] = pDepthStencil->depth;
+            }
+            else
+            {
+                value.uint32[ 0 ] = pDepthStencil->stencil;
+            }
+
+            cmdData.texelSizes[ planeIndex ] = texelFormat.size;
+            PackTexel( texelFormat, value, cmdData.texels[ planeIndex ] );
         }
+
+        command.pfnExecute = &ExecuteClearImage;
+
+        m_Commands.push_back( command );
+        AppendPayload( pRanges, rangeCount * sizeof( VkImageSubresourceRange ) );
     }
 
-    void CommandBuffer::vkCmdWriteTimestamp( VkPipelineStageFlagBits pipelineStage, VkQueryPool queryPool, uint32_t query )
+    void CommandBuffer::vkCmdFillBuffer( VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize size, uint32_t data )
     {
         struct CommandData
         {
-            VkQueryPool queryPool;
-            uint32_t query;
+            VkBuffer dstBuffer;
+            VkDeviceSize dstOffset;
+            VkDeviceSize size;
+            uint32_t data;
         };
 
         static_assert( sizeof( CommandData ) <= sizeof( VkMockCommandEXT::data ),
             "Command data size exceeds VkMockCommandEXT::data size" );
 
-        if( m_pMockFunctions->vkCmdWriteTimestamp )
+        if( m_pMockFunctions->vkCmdFillBuffer )
         {
-            return m_pMockFunctions->vkCmdWriteTimestamp(
+            return m_pMockFunctions->vkCmdFillBuffer(
                 GetApiHandle(),
-                pipelineStage,
-                queryPool,
-                query );
+                dstBuffer,
+                dstOffset,
+                size,
+                data );
+        }
+
+        if( size == VK_WHOLE_SIZE )
+        {
+            // The remaining size is rounded down to a multiple of 4.
+            size = ( dstBuffer->m_Size - dstOffset ) & ~VkDeviceSize( 3 );
         }
 
         VkMockCommandEXT command = {};
         CommandData& cmdData = *reinterpret_cast<CommandData*>( command.data.u64 );
-        cmdData.queryPool = queryPool;
-        cmdData.query = query;
+        cmdData.dstBuffer = dstBuffer;
+        cmdData.dstOffset = dstOffset;
+        cmdData.size = size;
+        cmdData.data = data;
 
-        command.pfnExecute = []( VkQueue queue, VkMockCommandEXT* pCommand ) {
+        command.pfnExecute = []( VkQueue, VkMockCommandEXT* pCommand ) {
             CommandData& cmdData = *reinterpret_cast<CommandData*>( pCommand->data.u64 );
-
-            auto nanosecondsSinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                std::chrono::steady_clock::now().time_since_epoch() );
-
-            cmdData.queryPool->m_Timestamps.at( cmdData.query ) = nanosecondsSinceEpoch.count();
+            vk_fill_memory( cmdData.dstBuffer->m_pData + cmdData.dstOffset,
+                cmdData.data,
+                static_cast<size_t>( cmdData.size ) );
         };
 
         m_Commands.push_back( command );
     }
 
-    void CommandBuffer::vkCmdCopyBuffer( VkBuffer srcBuffer, VkBuffer dstBuffer, uint32_t regionCount, const VkBufferCopy* pRegions )
+    void CommandBuffer::vkCmdUpdateBuffer( VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize dataSize, const void* pData )
     {
         struct CommandData
         {
-            VkBuffer srcBuffer;
             VkBuffer dstBuffer;
-            VkBufferCopy region;
+            VkDeviceSize dstOffset;
+            VkDeviceSize dataSize;
         };
 
         static_assert( sizeof( CommandData ) <= sizeof( VkMockCommandEXT::data ),
             "Command data size exceeds VkMockCommandEXT::data size" );
 
-        if( m_pMockFunctions->vkCmdCopyBuffer )
+        if( m_pMockFunctions->vkCmdUpdateBuffer )
         {
-            return m_pMockFunctions->vkCmdCopyBuffer(
+            return m_pMockFunctions->vkCmdUpdateBuffer(
                 GetApiHandle(),
-                srcBuffer,
                 dstBuffer,
-                regionCount,
-                pRegions );
+                dstOffset,
+                dataSize,
+                pData );
         }
 
-        for( uint32_t i = 0; i < regionCount; ++i )
-        {
-            VkMockCommandEXT command = {};
-            CommandData& cmdData = *reinterpret_cast<CommandData*>( command.data.u64 );
-            cmdData.srcBuffer = srcBuffer;
-            cmdData.dstBuffer = dstBuffer;
-            cmdData.region = pRegions[ i ];
+        VkMockCommandEXT command = {};
+        CommandData& cmdData = *reinterpret_cast<CommandData*>( command.data.u64 );
+        cmdData.dstBuffer = dstBuffer;
+        cmdData.dstOffset = dstOffset;
+        cmdData.dataSize = dataSize;
 
-            command.pfnExecute = []( VkQueue queue, VkMockCommandEXT* pCommand ) {
-                CommandData& cmdData = *reinterpret_cast<CommandData*>( pCommand->data.u64 );
-                memcpy( cmdData.dstBuffer->m_pData + cmdData.region.dstOffset,
-                    cmdData.srcBuffer->m_pData + cmdData.region.srcOffset,
-                    cmdData.region.size );
-            };
+        command.pfnExecute = []( VkQueue, VkMockCommandEXT* pCommand ) {
+            CommandData& cmdData = *reinterpret_cast<CommandData*>( pCommand->data.u64 );
+            ReadPayload( pCommand, 0,
+                cmdData.dstBuffer->m_pData + cmdData.dstOffset,
+                static_cast<size_t>( cmdData.dataSize ) );
+        };
 
-            m_Commands.push_back( command );
-        }
+        // The data is captured at record time (up to 65536 bytes), so the
+        // application may free it right after the call.
+        m_Commands.push_back( command );
+        AppendPayload( pData, static_cast<size_t>( dataSize ) );
     }
 
     void CommandBuffer::vkCmdCopyQueryPoolResults( VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount, VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize stride, VkQueryResultFlags flags )
@@ -277,21 +2313,68 @@ namespace vkmock
 
         command.pfnExecute = []( VkQueue, VkMockCommandEXT* pCommand ) {
             CommandData& cmdData = *reinterpret_cast<CommandData*>( pCommand->data.u64 );
-            for( uint32_t i = 0; i < cmdData.queryCount; ++i )
+
+            // The queries are written by the same queue, so waiting for them here would never end.
+            // Results of the queries that have not been ended yet are handled like on the host.
+            cmdData.queryPool->GetResults(
+                cmdData.firstQuery,
+                cmdData.queryCount,
+                cmdData.dstBuffer->m_pData + cmdData.dstOffset,
+                cmdData.stride,
+                cmdData.flags & ~VK_QUERY_RESULT_WAIT_BIT );
+        };
+
+        m_Commands.push_back( command );
+    }
+
+#ifdef VK_NV_copy_memory_indirect
+    void CommandBuffer::vkCmdCopyMemoryIndirectNV( VkDeviceAddress copyBufferAddress, uint32_t copyCount, uint32_t stride )
+    {
+        struct CommandData
+        {
+            VkDeviceAddress copyBufferAddress;
+            uint32_t copyCount;
+            uint32_t stride;
+        };
+
+        static_assert( sizeof( CommandData ) <= sizeof( VkMockCommandEXT::data ),
+            "Command data size exceeds VkMockCommandEXT::data size" );
+
+        if( m_pMockFunctions->vkCmdCopyMemoryIndirectNV )
+        {
+            return m_pMockFunctions->vkCmdCopyMemoryIndirectNV(
+                GetApiHandle(),
+                copyBufferAddress,
+                copyCount,
+                stride );
+        }
+
+        VkMockCommandEXT command = {};
+        CommandData& cmdData = *reinterpret_cast<CommandData*>( command.data.u64 );
+        cmdData.copyBufferAddress = copyBufferAddress;
+        cmdData.copyCount = copyCount;
+        cmdData.stride = stride;
+
+        command.pfnExecute = []( VkQueue, VkMockCommandEXT* pCommand ) {
+            CommandData& cmdData = *reinterpret_cast<CommandData*>( pCommand->data.u64 );
+
+            // Device addresses are host pointers, so both the copy parameters and
+            // the copied memory are accessed directly.
+            const uint8_t* pCopyCommands = reinterpret_cast<const uint8_t*>(
+                static_cast<uintptr_t>( cmdData.copyBufferAddress ) );
+
+            for( uint32_t i = 0; i < cmdData.copyCount; ++i )
             {
-                if( cmdData.flags & VK_QUERY_RESULT_64_BIT )
-                {
-                    *reinterpret_cast<uint64_t*>( cmdData.dstBuffer->m_pData + cmdData.dstOffset + i * cmdData.stride ) =
-                        cmdData.queryPool->m_Timestamps.at( cmdData.firstQuery + i );
-                }
-                else
-                {
-                    *reinterpret_cast<uint32_t*>( cmdData.dstBuffer->m_pData + cmdData.dstOffset + i * cmdData.stride ) =
-                        static_cast<uint32_t>( cmdData.queryPool->m_Timestamps.at( cmdData.firstQuery + i ) & 0xFFFFFFFF );
-                }
+                VkCopyMemoryIndirectCommandNV copy;
+                memcpy( &copy, pCopyCommands + i * cmdData.stride, sizeof( copy ) );
+
+                memmove( reinterpret_cast<void*>( static_cast<uintptr_t>( copy.dstAddress ) ),
+                    reinterpret_cast<const void*>( static_cast<uintptr_t>( copy.srcAddress ) ),
+                    static_cast<size_t>( copy.size ) );
             }
         };
 
         m_Commands.push_back( command );
     }
+#endif
 }
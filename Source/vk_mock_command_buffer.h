@@ -22,29 +22,111 @@
 #include "vk_mock.h"
 #include "vk_mock_icd_base.h"
 #include "vk_mock_icd_helpers.h"
+#include "vk_mock_compute.h"
+#include "vk_mock_raster.h"
 #include <vector>
 
 namespace vkmock
 {
     struct CommandBuffer : CommandBufferBase
     {
+        VkDevice m_Device;
         VkCommandPool m_CommandPool;
         std::vector<VkMockCommandEXT, vk_stl_allocator<VkMockCommandEXT>> m_Commands;
+        ComputeState m_ComputeState;
+        GraphicsState m_GraphicsState;
 
         CommandBuffer( VkDevice device, VkCommandPool commandPool );
         ~CommandBuffer();
 
         void Reset();
 
+        void AppendPayload( const void* pData, size_t size );
+        static void ReadPayload( const VkMockCommandEXT* pCommand, size_t offset, void* pData, size_t size );
+
         VkResult vkBeginCommandBuffer( const VkCommandBufferBeginInfo* pBeginInfo );
         VkResult vkResetCommandBuffer( VkCommandBufferResetFlags flags );
 
+        void vkCmdBeginRendering( const VkRenderingInfo* pRenderingInfo );
+        void vkCmdEndRendering();
+        void vkCmdSetViewport( uint32_t firstViewport, uint32_t viewportCount, const VkViewport* pViewports );
+        void vkCmdSetScissor( uint32_t firstScissor, uint32_t scissorCount, const VkRect2D* pScissors );
+        void vkCmdSetBlendConstants( const float blendConstants[ 4 ] );
+        void vkCmdBindVertexBuffers( uint32_t firstBinding, uint32_t bindingCount, const VkBuffer* pBuffers, const VkDeviceSize* pOffsets );
+        void vkCmdBindIndexBuffer( VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType );
         void vkCmdDraw( uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance );
+        void vkCmdDrawIndexed( uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance );
+        void vkCmdDrawIndirect( VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride );
+        void vkCmdDrawIndexedIndirect( VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride );
+        void vkCmdDrawIndirectCount( VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride );
+        void vkCmdDrawIndexedIndirectCount( VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride );
+        void vkCmdBindPipeline( VkPipelineBindPoint pipelineBindPoint, VkPipeline pipeline );
+        void vkCmdBindDescriptorSets( VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout layout, uint32_t firstSet, uint32_t descriptorSetCount, const VkDescriptorSet* pDescriptorSets, uint32_t dynamicOffsetCount, const uint32_t* pDynamicOffsets );
+        void vkCmdPushConstants( VkPipelineLayout layout, VkShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* pValues );
         void vkCmdDispatch( uint32_t x, uint32_t y, uint32_t z );
+        void vkCmdDispatchBase( uint32_t baseGroupX, uint32_t baseGroupY, uint32_t baseGroupZ, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ );
+        void vkCmdDispatchIndirect( VkBuffer buffer, VkDeviceSize offset );
+        void vkCmdSetDeviceMask( uint32_t deviceMask );
         void vkCmdExecuteCommands( uint32_t commandBufferCount, const VkCommandBuffer* pCommandBuffers );
+        void vkCmdBeginQuery( VkQueryPool queryPool, uint32_t query, VkQueryControlFlags flags );
+        void vkCmdEndQuery( VkQueryPool queryPool, uint32_t query );
+        void vkCmdResetQueryPool( VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount );
         void vkCmdWriteTimestamp( VkPipelineStageFlagBits pipelineStage, VkQueryPool queryPool, uint32_t query );
         void vkCmdCopyBuffer( VkBuffer srcBuffer, VkBuffer dstBuffer, uint32_t regionCount, const VkBufferCopy* pRegions );
+        void vkCmdCopyBufferToImage( VkBuffer srcBuffer, VkImage dstImage, VkImageLayout dstImageLayout, uint32_t regionCount, const VkBufferImageCopy* pRegions );
+        void vkCmdCopyImageToBuffer( VkImage srcImage, VkImageLayout srcImageLayout, VkBuffer dstBuffer, uint32_t regionCount, const VkBufferImageCopy* pRegions );
+        void vkCmdCopyImage( VkImage srcImage, VkImageLayout srcImageLayout, VkImage dstImage, VkImageLayout dstImageLayout, uint32_t regionCount, const VkImageCopy* pRegions );
+        void vkCmdCopyBufferToImage2( const VkCopyBufferToImageInfo2* pCopyBufferToImageInfo );
+        void vkCmdCopyImageToBuffer2( const VkCopyImageToBufferInfo2* pCopyImageToBufferInfo );
+        void vkCmdCopyImage2( const VkCopyImageInfo2* pCopyImageInfo );
+        void vkCmdBlitImage( VkImage srcImage, VkImageLayout srcImageLayout, VkImage dstImage, VkImageLayout dstImageLayout, uint32_t regionCount, const VkImageBlit* pRegions, VkFilter filter );
+        void vkCmdBlitImage2( const VkBlitImageInfo2* pBlitImageInfo );
+        void vkCmdResolveImage( VkImage srcImage, VkImageLayout srcImageLayout, VkImage dstImage, VkImageLayout dstImageLayout, uint32_t regionCount, const VkImageResolve* pRegions );
+        void vkCmdResolveImage2( const VkResolveImageInfo2* pResolveImageInfo );
+        void vkCmdClearColorImage( VkImage image, VkImageLayout imageLayout, const VkClearColorValue* pColor, uint32_t rangeCount, const VkImageSubresourceRange* pRanges );
+        void vkCmdClearDepthStencilImage( VkImage image, VkImageLayout imageLayout, const VkClearDepthStencilValue* pDepthStencil, uint32_t rangeCount, const VkImageSubresourceRange* pRanges );
+        void vkCmdFillBuffer( VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize size, uint32_t data );
+        void vkCmdUpdateBuffer( VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize dataSize, const void* pData );
         void vkCmdCopyQueryPoolResults( VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount, VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize stride, VkQueryResultFlags flags );
+
+#ifdef VK_KHR_copy_commands2
+        void vkCmdCopyBufferToImage2KHR( const VkCopyBufferToImageInfo2KHR* pCopyBufferToImageInfo );
+        void vkCmdCopyImageToBuffer2KHR( const VkCopyImageToBufferInfo2KHR* pCopyImageToBufferInfo );
+        void vkCmdCopyImage2KHR( const VkCopyImageInfo2KHR* pCopyImageInfo );
+        void vkCmdBlitImage2KHR( const VkBlitImageInfo2KHR* pBlitImageInfo );
+        void vkCmdResolveImage2KHR( const VkResolveImageInfo2KHR* pResolveImageInfo );
+#endif
+
+#ifdef VK_KHR_dynamic_rendering
+        void vkCmdBeginRenderingKHR( const VkRenderingInfoKHR* pRenderingInfo );
+        void vkCmdEndRenderingKHR();
+#endif
+
+#ifdef VK_KHR_draw_indirect_count
+        void vkCmdDrawIndirectCountKHR( VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride );
+        void vkCmdDrawIndexedIndirectCountKHR( VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer, VkDeviceSize countBufferOffset, uint32_t maxDrawCount, uint32_t stride );
+#endif
+
+#ifdef VK_KHR_device_group
+        void vkCmdDispatchBaseKHR( uint32_t baseGroupX, uint32_t baseGroupY, uint32_t baseGroupZ, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ );
+        void vkCmdSetDeviceMaskKHR( uint32_t deviceMask );
+#endif
+
+#ifdef VK_NV_copy_memory_indirect
+        void vkCmdCopyMemoryIndirectNV( VkDeviceAddress copyBufferAddress, uint32_t copyCount, uint32_t stride );
+#endif
+
+        void RecordSetDeviceMask( uint32_t deviceMask );
+        void RecordCopyBufferImage( PFN_vkExecuteMockCommandCallbackEXT pfnExecute, VkBuffer buffer, VkImage image, uint32_t regionCount, const VkBufferImageCopy* pRegions );
+        void RecordCopyImage( VkImage srcImage, VkImage dstImage, uint32_t regionCount, const VkImageCopy* pRegions );
+        void RecordBlitImage( VkImage srcImage, VkImage dstImage, uint32_t regionCount, const VkImageBlit* pRegions, VkFilter filter );
+        void RecordResolveImage( VkImage srcImage, VkImage dstImage, uint32_t regionCount, const VkImageResolve* pRegions );
+        void RecordClearAttachment( const VkRenderingAttachmentInfo& attachment, VkImageAspectFlagBits aspect, const VkRect2D& renderArea, uint32_t layerCount );
+        bool UseRasterizer() const;
+        void RecordDraw( uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance, int32_t vertexOffset, bool indexed, const IndirectDrawInfo* pIndirect );
+        void RecordDrawCost( uint32_t vertexCount, uint32_t instanceCount, uint32_t firstIndex, bool indexed, const IndirectDrawInfo* pIndirect );
+        void RecordDrawIndirect( const IndirectDrawInfo& indirect, bool indexed );
+        void RecordDispatch( uint32_t baseGroupX, uint32_t baseGroupY, uint32_t baseGroupZ, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ, VkBuffer indirectBuffer, VkDeviceSize indirectOffset );
     };
 }
 
@@ -0,0 +1,117 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_compute.h"
+#include "vk_mock_descriptor.h"
+#include "vk_mock_pipeline.h"
+#include "vk_mock_thread_pool.h"
+
+namespace vkmock
+{
+    BoundDescriptorSets::BoundDescriptorSets( const VkAllocationCallbacks& allocator, const ComputeState& state )
+        : m_Bindings( allocator )
+        , m_Descriptors( allocator )
+        , m_Sets()
+    {
+        size_t bindingCount = 0;
+        size_t descriptorCount = 0;
+
+        for( uint32_t i = 0; i < state.m_DescriptorSetCount; ++i )
+        {
+            if( const VkDescriptorSet set = state.m_DescriptorSets[ i ] )
+            {
+                bindingCount += set->m_Bindings.size();
+                descriptorCount += set->m_Descriptors.size();
+            }
+        }
+
+        // Pointers to the elements are stored in the sets, so the vectors must not grow.
+        m_Bindings.reserve( bindingCount );
+        m_Descriptors.reserve( descriptorCount );
+
+        for( uint32_t i = 0; i < state.m_DescriptorSetCount; ++i )
+        {
+            const VkDescriptorSet set = state.m_DescriptorSets[ i ];
+            if( !set )
+            {
+                continue;
+            }
+
+            m_Sets[ i ].bindingCount = static_cast<uint32_t>( set->m_Bindings.size() );
+            m_Sets[ i ].pBindings = m_Bindings.data() + m_Bindings.size();
+
+            // Dynamic offsets are consumed in the order of the binding numbers.
+            uint32_t dynamicOffsetIndex = 0;
+
+            for( const VkMockDescriptorBindingEXT& setBinding : set->m_Bindings )
+            {
+                VkMockDescriptorBindingEXT& binding = m_Bindings.emplace_back( setBinding );
+                binding.pDescriptors = m_Descriptors.data() + m_Descriptors.size();
+
+                const bool dynamic = IsDynamicDescriptorType( binding.descriptorType );
+
+                for( uint32_t j = 0; j < binding.descriptorCount; ++j )
+                {
+                    VkMockDescriptorEXT& descriptor = m_Descriptors.emplace_back( setBinding.pDescriptors[ j ] );
+
+                    if( dynamic && dynamicOffsetIndex < set->m_DynamicDescriptorCount )
+                    {
+                        if( descriptor.pData )
+                        {
+                            descriptor.pData = static_cast<uint8_t*>( descriptor.pData ) + state.m_DynamicOffsets[ i ][ dynamicOffsetIndex ];
+                        }
+                        dynamicOffsetIndex++;
+                    }
+                }
+            }
+        }
+    }
+
+    void DispatchWorkgroups( ThreadPool& threadPool, const ComputeState& state, const uint32_t baseGroup[ 3 ], const uint32_t groupCount[ 3 ] )
+    {
+        const Pipeline& pipeline = *state.m_Pipeline;
+        const size_t workgroupCount = size_t( groupCount[ 0 ] ) * groupCount[ 1 ] * groupCount[ 2 ];
+
+        if( !pipeline.m_pfnKernel || workgroupCount == 0 )
+        {
+            return;
+        }
+
+        const BoundDescriptorSets descriptorSets( threadPool.m_Allocator, state );
+
+        const size_t groupCountXY = size_t( groupCount[ 0 ] ) * groupCount[ 1 ];
+
+        threadPool.ParallelFor( workgroupCount, [&]( size_t index ) {
+            VkMockWorkgroupEXT workgroup;
+            workgroup.workgroupId[ 0 ] = baseGroup[ 0 ] + static_cast<uint32_t>( index % groupCount[ 0 ] );
+            workgroup.workgroupId[ 1 ] = baseGroup[ 1 ] + static_cast<uint32_t>( ( index / groupCount[ 0 ] ) % groupCount[ 1 ] );
+            workgroup.workgroupId[ 2 ] = baseGroup[ 2 ] + static_cast<uint32_t>( index / groupCountXY );
+            workgroup.workgroupCount[ 0 ] = groupCount[ 0 ];
+            workgroup.workgroupCount[ 1 ] = groupCount[ 1 ];
+            workgroup.workgroupCount[ 2 ] = groupCount[ 2 ];
+            workgroup.pPushConstants = state.m_PushConstants;
+            workgroup.descriptorSetCount = state.m_DescriptorSetCount;
+            workgroup.pDescriptorSets = descriptorSets.m_Sets;
+            workgroup.pUserData = pipeline.m_pKernelUserData;
+
+            pipeline.m_pfnKernel( &workgroup );
+        } );
+    }
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "vk_mock.h"
+#include "vk_mock_icd_helpers.h"
+#include <vulkan/vulkan.h>
+#include <vector>
+
+namespace vkmock
+{
+    struct ThreadPool;
+
+    static constexpr uint32_t g_MaxBoundDescriptorSets = 8;
+    static constexpr uint32_t g_MaxDynamicDescriptorsPerSet = 16;
+    static constexpr uint32_t g_MaxPushConstantsSize = 256;
+
+    /**
+     * @brief
+     *   Resources bound to the compute bind point of a command buffer.
+     *   The graphics bind point keeps the same state for the draws.
+     */
+    struct ComputeState
+    {
+        VkPipeline m_Pipeline;
+        uint32_t m_DescriptorSetCount;
+        VkDescriptorSet m_DescriptorSets[ g_MaxBoundDescriptorSets ];
+        uint32_t m_DynamicOffsets[ g_MaxBoundDescriptorSets ][ g_MaxDynamicDescriptorsPerSet ];
+        uint32_t m_PushConstantsSize;
+        uint8_t m_PushConstants[ g_MaxPushConstantsSize ];
+    };
+
+    /**
+     * @brief
+     *   Descriptors of the bound sets in the layout passed to the host kernels, with the dynamic
+     *   offsets applied. Dynamic offsets are specific to the command, so the descriptors are copied.
+     */
+    struct BoundDescriptorSets
+    {
+        std::vector<VkMockDescriptorBindingEXT, vk_stl_allocator<VkMockDescriptorBindingEXT>> m_Bindings;
+        std::vector<VkMockDescriptorEXT, vk_stl_allocator<VkMockDescriptorEXT>> m_Descriptors;
+        VkMockDescriptorSetEXT m_Sets[ g_MaxBoundDescriptorSets ];
+
+        BoundDescriptorSets( const VkAllocationCallbacks& allocator, const ComputeState& state );
+    };
+
+    /**
+     * @brief
+     *   Execute the kernel of the bound compute pipeline for each workgroup in the grid.
+     *   Descriptors are captured once per dispatch with the dynamic offsets applied,
+     *   and the workgroups are distributed between the threads of the pool.
+     */
+    void DispatchWorkgroups( ThreadPool& threadPool, const ComputeState& state, const uint32_t baseGroup[ 3 ], const uint32_t groupCount[ 3 ] );
+}
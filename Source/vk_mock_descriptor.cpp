@@ -0,0 +1,160 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_descriptor.h"
+#include "vk_mock_buffer.h"
+#include "vk_mock_compute.h"
+
+#include <algorithm>
+
+namespace vkmock
+{
+    static bool IsBufferDescriptorType( VkDescriptorType type )
+    {
+        return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+            type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+            IsDynamicDescriptorType( type );
+    }
+
+    DescriptorSetLayout::DescriptorSetLayout( const VkDescriptorSetLayoutCreateInfo& createInfo )
+        : m_Bindings( g_CurrentAllocator )
+        , m_DescriptorCount( 0 )
+        , m_DynamicDescriptorCount( 0 )
+    {
+        uint32_t bindingCount = 0;
+        for( uint32_t i = 0; i < createInfo.bindingCount; ++i )
+        {
+            bindingCount = std::max( bindingCount, createInfo.pBindings[ i ].binding + 1 );
+        }
+
+        m_Bindings.resize( bindingCount, DescriptorBindingLayout{ VK_DESCRIPTOR_TYPE_SAMPLER, 0, 0 } );
+
+        for( uint32_t i = 0; i < createInfo.bindingCount; ++i )
+        {
+            const VkDescriptorSetLayoutBinding& binding = createInfo.pBindings[ i ];
+            m_Bindings[ binding.binding ].m_Type = binding.descriptorType;
+            m_Bindings[ binding.binding ].m_Count = binding.descriptorCount;
+        }
+
+        for( DescriptorBindingLayout& binding : m_Bindings )
+        {
+            binding.m_Offset = m_DescriptorCount;
+            m_DescriptorCount += binding.m_Count;
+
+            if( IsDynamicDescriptorType( binding.m_Type ) )
+            {
+                m_DynamicDescriptorCount += binding.m_Count;
+            }
+        }
+    }
+
+    DescriptorSet::DescriptorSet( VkDescriptorPool descriptorPool, VkDescriptorSetLayout layout )
+        : m_DescriptorPool( descriptorPool )
+        , m_Bindings( layout->m_Bindings.size(), g_CurrentAllocator )
+        , m_Descriptors( layout->m_DescriptorCount, VkMockDescriptorEXT{}, g_CurrentAllocator )
+        , m_DynamicDescriptorCount( std::min( layout->m_DynamicDescriptorCount, g_MaxDynamicDescriptorsPerSet ) )
+    {
+        for( size_t i = 0; i < m_Bindings.size(); ++i )
+        {
+            const DescriptorBindingLayout& bindingLayout = layout->m_Bindings[ i ];
+            m_Bindings[ i ].descriptorType = bindingLayout.m_Type;
+            m_Bindings[ i ].descriptorCount = bindingLayout.m_Count;
+            m_Bindings[ i ].pDescriptors = m_Descriptors.data() + bindingLayout.m_Offset;
+        }
+
+        m_DescriptorPool->m_DescriptorSets.push_back( static_cast<VkDescriptorSet>( this ) );
+    }
+
+    DescriptorSet::~DescriptorSet()
+    {
+        auto iter = std::find(
+            m_DescriptorPool->m_DescriptorSets.begin(),
+            m_DescriptorPool->m_DescriptorSets.end(),
+            static_cast<VkDescriptorSet>( this ) );
+
+        if( iter != m_DescriptorPool->m_DescriptorSets.end() )
+        {
+            m_DescriptorPool->m_DescriptorSets.erase( iter );
+        }
+    }
+
+    uint32_t DescriptorSet::GetDescriptorIndex( uint32_t binding, uint32_t arrayElement ) const
+    {
+        return static_cast<uint32_t>( m_Bindings[ binding ].pDescriptors - m_Descriptors.data() ) + arrayElement;
+    }
+
+    void DescriptorSet::Write( const VkWriteDescriptorSet& write )
+    {
+        // Image and texel buffer descriptors are not backed by any memory, views are not implemented.
+        if( !IsBufferDescriptorType( write.descriptorType ) )
+        {
+            return;
+        }
+
+        const uint32_t firstIndex = GetDescriptorIndex( write.dstBinding, write.dstArrayElement );
+        const uint32_t count = std::min<uint32_t>( write.descriptorCount, uint32_t( m_Descriptors.size() ) - firstIndex );
+
+        for( uint32_t i = 0; i < count; ++i )
+        {
+            const VkDescriptorBufferInfo& bufferInfo = write.pBufferInfo[ i ];
+            VkMockDescriptorEXT& descriptor = m_Descriptors[ firstIndex + i ];
+
+            if( !bufferInfo.buffer )
+            {
+                descriptor = {};
+                continue;
+            }
+
+            descriptor.pData = bufferInfo.buffer->m_pData + bufferInfo.offset;
+            descriptor.range = ( bufferInfo.range == VK_WHOLE_SIZE )
+                ? bufferInfo.buffer->m_Size - bufferInfo.offset
+                : bufferInfo.range;
+        }
+    }
+
+    void DescriptorSet::Copy( const VkCopyDescriptorSet& copy )
+    {
+        const DescriptorSet& srcSet = *copy.srcSet;
+        const uint32_t srcIndex = srcSet.GetDescriptorIndex( copy.srcBinding, copy.srcArrayElement );
+        const uint32_t dstIndex = GetDescriptorIndex( copy.dstBinding, copy.dstArrayElement );
+
+        std::copy_n( srcSet.m_Descriptors.begin() + srcIndex, copy.descriptorCount, m_Descriptors.begin() + dstIndex );
+    }
+
+    DescriptorPool::DescriptorPool( const VkDescriptorPoolCreateInfo& )
+        : m_Allocator( g_CurrentAllocator )
+        , m_DescriptorSets( m_Allocator )
+    {
+    }
+
+    DescriptorPool::~DescriptorPool()
+    {
+        Reset();
+    }
+
+    void DescriptorPool::Reset()
+    {
+        // Descriptor sets remove themselves from the pool when deleted.
+        while( !m_DescriptorSets.empty() )
+        {
+            vk_delete( m_DescriptorSets.back(), m_Allocator );
+        }
+    }
+}
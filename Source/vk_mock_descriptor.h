@@ -0,0 +1,97 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "vk_mock.h"
+#include "vk_mock_icd_base.h"
+#include "vk_mock_icd_helpers.h"
+#include <vector>
+
+namespace vkmock
+{
+    struct DescriptorBindingLayout
+    {
+        VkDescriptorType m_Type;
+        uint32_t m_Count;
+        uint32_t m_Offset;
+    };
+
+    /**
+     * @brief
+     *   Descriptors of all bindings are stored in a single array, in the order of the binding
+     *   numbers, so writes overflowing to the consecutive bindings are linear.
+     */
+    struct DescriptorSetLayout
+    {
+        std::vector<DescriptorBindingLayout, vk_stl_allocator<DescriptorBindingLayout>> m_Bindings;
+        uint32_t m_DescriptorCount;
+        uint32_t m_DynamicDescriptorCount;
+
+        explicit DescriptorSetLayout( const VkDescriptorSetLayoutCreateInfo& createInfo );
+    };
+
+    struct DescriptorSet
+    {
+        VkDescriptorPool m_DescriptorPool;
+        std::vector<VkMockDescriptorBindingEXT, vk_stl_allocator<VkMockDescriptorBindingEXT>> m_Bindings;
+        std::vector<VkMockDescriptorEXT, vk_stl_allocator<VkMockDescriptorEXT>> m_Descriptors;
+        uint32_t m_DynamicDescriptorCount;
+
+        DescriptorSet( VkDescriptorPool descriptorPool, VkDescriptorSetLayout layout );
+        ~DescriptorSet();
+
+        void Write( const VkWriteDescriptorSet& write );
+        void Copy( const VkCopyDescriptorSet& copy );
+
+        uint32_t GetDescriptorIndex( uint32_t binding, uint32_t arrayElement ) const;
+    };
+
+    struct DescriptorPool
+    {
+        VkAllocationCallbacks m_Allocator;
+        std::vector<VkDescriptorSet, vk_stl_allocator<VkDescriptorSet>> m_DescriptorSets;
+
+        explicit DescriptorPool( const VkDescriptorPoolCreateInfo& createInfo );
+        ~DescriptorPool();
+
+        void Reset();
+    };
+
+    inline bool IsDynamicDescriptorType( VkDescriptorType type )
+    {
+        return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+            type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    }
+}
+
+struct VkDescriptorSetLayout_T : vkmock::DescriptorSetLayout
+{
+    using DescriptorSetLayout::DescriptorSetLayout;
+};
+
+struct VkDescriptorSet_T : vkmock::DescriptorSet
+{
+    using DescriptorSet::DescriptorSet;
+};
+
+struct VkDescriptorPool_T : vkmock::DescriptorPool
+{
+    using DescriptorPool::DescriptorPool;
+};
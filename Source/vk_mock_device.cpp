@@ -28,15 +28,109 @@
 #include "vk_mock_command_pool.h"
 #include "vk_mock_swapchain.h"
 #include "vk_mock_image.h"
+#include "vk_mock_image_view.h"
+#include "vk_mock_host_image_copy.h"
+#include "vk_mock_shader_module.h"
+#include "vk_mock_pipeline.h"
+#include "vk_mock_descriptor.h"
 #include "vk_mock_icd_helpers.h"
 
+#ifdef VK_MOCK_ICD_MEMFD
+#include <unistd.h>
+#endif
+
 namespace vkmock
 {
+#ifdef VK_EXT_host_image_copy
+    // Subresources copied with VK_HOST_IMAGE_COPY_MEMCPY_EXT are stored with their padding.
+    static void GetHostMemcpySize( void* pNext, const VkSubresourceLayout& layout )
+    {
+        VkBaseOutStructure* pStruct = (VkBaseOutStructure*)( pNext );
+        while( pStruct )
+        {
+            if( pStruct->sType == VK_STRUCTURE_TYPE_SUBRESOURCE_HOST_MEMCPY_SIZE_EXT )
+            {
+                VkSubresourceHostMemcpySizeEXT* pMemcpySize = (VkSubresourceHostMemcpySizeEXT*)pStruct;
+                pMemcpySize->size = layout.size;
+            }
+
+            pStruct = pStruct->pNext;
+        }
+    }
+#endif
+
+    // Logical devices created from device groups share the worker threads of all physical devices in the group.
+    static uint32_t GetThreadCount( VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo& createInfo )
+    {
+        const VkDeviceGroupDeviceCreateInfo* pDeviceGroupInfo = vk_find_struct<VkDeviceGroupDeviceCreateInfo>(
+            createInfo.pNext, VK_STRUCTURE_TYPE_DEVICE_GROUP_DEVICE_CREATE_INFO );
+        if( !pDeviceGroupInfo || !pDeviceGroupInfo->physicalDeviceCount )
+        {
+            return physicalDevice->m_ThreadCount;
+        }
+
+        uint32_t threadCount = 0;
+        for( uint32_t i = 0; i < pDeviceGroupInfo->physicalDeviceCount; ++i )
+        {
+            // Physical devices with the default thread count use all hardware threads.
+            if( !pDeviceGroupInfo->pPhysicalDevices[ i ]->m_ThreadCount )
+            {
+                return 0;
+            }
+
+            threadCount += pDeviceGroupInfo->pPhysicalDevices[ i ]->m_ThreadCount;
+        }
+
+        return threadCount;
+    }
+
+    // Resources bound with a device index different from the index of the accessing device
+    // are read from the memory instance of a peer device.
+    static uint32_t GetPeerMemoryMask( uint32_t deviceIndexCount, const uint32_t* pDeviceIndices )
+    {
+        uint32_t peerMemoryMask = 0;
+        for( uint32_t i = 0; i < deviceIndexCount; ++i )
+        {
+            if( pDeviceIndices[ i ] != i )
+            {
+                peerMemoryMask |= ( 1U << i );
+            }
+        }
+
+        return peerMemoryMask;
+    }
+
     Device::Device( VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo& createInfo )
         : m_Allocator( g_CurrentAllocator )
         , m_PhysicalDevice( physicalDevice )
+        , m_PhysicalDeviceCount( 1 )
+        , m_PhysicalDevices()
+        , m_DeviceMask( 1 )
         , m_Queue( nullptr )
+        , m_AddressMap( m_Allocator )
+        , m_ThreadPool( m_Allocator, GetThreadCount( physicalDevice, createInfo ) )
+        , m_ImageSwizzle( VK_MOCK_IMAGE_SWIZZLE_NONE_EXT )
+        , m_Rasterizer( VK_MOCK_RASTERIZER_NONE_EXT )
+        , m_VertexCache( { VK_MOCK_VERTEX_CACHE_FIFO_EXT, g_DefaultVertexCacheSize } )
+        , m_DrawCounters()
+        , m_ExecutionCounters()
+        , m_ProfilingLock()
     {
+        m_PhysicalDevices[ 0 ] = physicalDevice;
+
+        const VkDeviceGroupDeviceCreateInfo* pDeviceGroupInfo = vk_find_struct<VkDeviceGroupDeviceCreateInfo>(
+            createInfo.pNext, VK_STRUCTURE_TYPE_DEVICE_GROUP_DEVICE_CREATE_INFO );
+        if( pDeviceGroupInfo && pDeviceGroupInfo->physicalDeviceCount )
+        {
+            m_PhysicalDeviceCount = std::min<uint32_t>( pDeviceGroupInfo->physicalDeviceCount, VK_MAX_DEVICE_GROUP_SIZE );
+            m_DeviceMask = ( m_PhysicalDeviceCount < 32 ) ? ( ( 1U << m_PhysicalDeviceCount ) - 1 ) : ~0U;
+
+            for( uint32_t i = 0; i < m_PhysicalDeviceCount; ++i )
+            {
+                m_PhysicalDevices[ i ] = pDeviceGroupInfo->pPhysicalDevices[ i ];
+            }
+        }
+
         try
         {
             vk_check( vk_new(
@@ -56,15 +150,16 @@ namespace vkmock
         }
         catch( ... )
         {
-            Device::~Device();
+            vk_delete( m_Queue, m_Allocator, VK_SYSTEM_ALLOCATION_SCOPE_DEVICE );
+            vk_delete( m_pMockFunctions, m_Allocator, VK_SYSTEM_ALLOCATION_SCOPE_DEVICE );
             throw;
         }
     }
 
     Device::~Device()
     {
-        vk_delete( m_Queue, g_CurrentAllocator );
-        vk_delete( m_pMockFunctions, g_CurrentAllocator );
+        vk_delete( m_Queue, g_CurrentAllocator, VK_SYSTEM_ALLOCATION_SCOPE_DEVICE );
+        vk_delete( m_pMockFunctions, g_CurrentAllocator, VK_SYSTEM_ALLOCATION_SCOPE_DEVICE );
     }
 
     void Device::vkDestroyDevice( const VkAllocationCallbacks* pAllocator )
@@ -76,8 +171,9 @@ namespace vkmock
                 pAllocator );
         }
 
-        vk_delete( this,
-            vk_allocator( pAllocator, m_Allocator ) );
+        vk_delete( GetApiHandle(),
+            vk_allocator( pAllocator, m_Allocator ),
+            VK_SYSTEM_ALLOCATION_SCOPE_DEVICE );
     }
 
     void Device::vkGetDeviceQueue( uint32_t queueFamilyIndex, uint32_t queueIndex, VkQueue* pQueue )
@@ -122,6 +218,7 @@ namespace vkmock
             pQueryPool,
             vk_allocator( pAllocator, m_Allocator ),
             VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+            GetApiHandle(),
             *pCreateInfo );
     }
 
@@ -139,6 +236,113 @@ namespace vkmock
             vk_allocator( pAllocator, m_Allocator ) );
     }
 
+    VkResult Device::vkGetQueryPoolResults( VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount, size_t dataSize, void* pData, VkDeviceSize stride, VkQueryResultFlags flags )
+    {
+        if( m_pMockFunctions->vkGetQueryPoolResults )
+        {
+            return m_pMockFunctions->vkGetQueryPoolResults(
+                GetApiHandle(),
+                queryPool,
+                firstQuery,
+                queryCount,
+                dataSize,
+                pData,
+                stride,
+                flags );
+        }
+
+        return queryPool->GetResults( firstQuery, queryCount, pData, stride, flags );
+    }
+
+    void Device::vkResetQueryPool( VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount )
+    {
+        if( m_pMockFunctions->vkResetQueryPool )
+        {
+            return m_pMockFunctions->vkResetQueryPool(
+                GetApiHandle(),
+                queryPool,
+                firstQuery,
+                queryCount );
+        }
+
+        queryPool->Reset( firstQuery, queryCount );
+    }
+
+#ifdef VK_EXT_host_query_reset
+    void Device::vkResetQueryPoolEXT( VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount )
+    {
+        if( m_pMockFunctions->vkResetQueryPoolEXT )
+        {
+            return m_pMockFunctions->vkResetQueryPoolEXT(
+                GetApiHandle(),
+                queryPool,
+                firstQuery,
+                queryCount );
+        }
+
+        vkResetQueryPool( queryPool, firstQuery, queryCount );
+    }
+#endif
+
+#ifdef VK_KHR_calibrated_timestamps
+    VkResult Device::vkGetCalibratedTimestampsKHR( uint32_t timestampCount, const VkCalibratedTimestampInfoKHR* pTimestampInfos, uint64_t* pTimestamps, uint64_t* pMaxDeviation )
+    {
+        if( m_pMockFunctions->vkGetCalibratedTimestampsKHR )
+        {
+            return m_pMockFunctions->vkGetCalibratedTimestampsKHR(
+                GetApiHandle(),
+                timestampCount,
+                pTimestampInfos,
+                pTimestamps,
+                pMaxDeviation );
+        }
+
+        return m_PhysicalDevice->m_Clock.GetCalibratedTimestamps( timestampCount, pTimestampInfos, pTimestamps, pMaxDeviation );
+    }
+#endif
+
+#ifdef VK_EXT_calibrated_timestamps
+    VkResult Device::vkGetCalibratedTimestampsEXT( uint32_t timestampCount, const VkCalibratedTimestampInfoEXT* pTimestampInfos, uint64_t* pTimestamps, uint64_t* pMaxDeviation )
+    {
+        if( m_pMockFunctions->vkGetCalibratedTimestampsEXT )
+        {
+            return m_pMockFunctions->vkGetCalibratedTimestampsEXT(
+                GetApiHandle(),
+                timestampCount,
+                pTimestampInfos,
+                pTimestamps,
+                pMaxDeviation );
+        }
+
+        return m_PhysicalDevice->m_Clock.GetCalibratedTimestamps( timestampCount, pTimestampInfos, pTimestamps, pMaxDeviation );
+    }
+#endif
+
+#ifdef VK_KHR_performance_query
+    VkResult Device::vkAcquireProfilingLockKHR( const VkAcquireProfilingLockInfoKHR* pInfo )
+    {
+        if( m_pMockFunctions->vkAcquireProfilingLockKHR )
+        {
+            return m_pMockFunctions->vkAcquireProfilingLockKHR(
+                GetApiHandle(),
+                pInfo );
+        }
+
+        return m_ProfilingLock.Acquire( pInfo->timeout );
+    }
+
+    void Device::vkReleaseProfilingLockKHR()
+    {
+        if( m_pMockFunctions->vkReleaseProfilingLockKHR )
+        {
+            return m_pMockFunctions->vkReleaseProfilingLockKHR(
+                GetApiHandle() );
+        }
+
+        m_ProfilingLock.Release();
+    }
+#endif
+
     VkResult Device::vkCreateCommandPool( const VkCommandPoolCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkCommandPool* pCommandPool )
     {
         if( m_pMockFunctions->vkCreateCommandPool )
@@ -254,20 +458,23 @@ namespace vkmock
             pMemory,
             vk_allocator( pAllocator, m_Allocator ),
             VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
-            pAllocateInfo->allocationSize );
+            *pAllocateInfo );
     }
 
     void Device::vkFreeMemory( VkDeviceMemory memory, const VkAllocationCallbacks* pAllocator )
     {
         if( m_pMockFunctions->vkFreeMemory )
         {
-            m_pMockFunctions->vkFreeMemory(
+            return m_pMockFunctions->vkFreeMemory(
                 GetApiHandle(),
                 memory,
                 pAllocator );
         }
 
-        delete memory;
+        // Releases the backing storage according to the memory type. Imported
+        // host allocations are only unregistered, the application owns them.
+        vk_delete( memory,
+            vk_allocator( pAllocator, m_Allocator ) );
     }
 
     VkResult Device::vkMapMemory( VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize size, VkMemoryMapFlags flags, void** ppData )
@@ -316,6 +523,11 @@ namespace vkmock
                 pAllocator );
         }
 
+        if( buffer && ( buffer->m_Usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT ) )
+        {
+            m_AddressMap.Remove( buffer );
+        }
+
         vk_delete( buffer,
             vk_allocator( pAllocator, m_Allocator ) );
     }
@@ -346,7 +558,7 @@ namespace vkmock
                 memoryOffset );
         }
 
-        buffer->m_pData = memory->m_pAllocation + memoryOffset;
+        BindBufferMemory( buffer, memory, memoryOffset );
 
         return VK_SUCCESS;
     }
@@ -378,13 +590,99 @@ namespace vkmock
 
         for( uint32_t i = 0; i < bindInfoCount; ++i )
         {
-            pBindInfos[ i ].buffer->m_pData =
-                pBindInfos[ i ].memory->m_pAllocation + pBindInfos[ i ].memoryOffset;
+            BindBufferMemory(
+                pBindInfos[ i ].buffer,
+                pBindInfos[ i ].memory,
+                pBindInfos[ i ].memoryOffset );
+
+            const VkBindBufferMemoryDeviceGroupInfo* pDeviceGroupInfo = vk_find_struct<VkBindBufferMemoryDeviceGroupInfo>(
+                pBindInfos[ i ].pNext, VK_STRUCTURE_TYPE_BIND_BUFFER_MEMORY_DEVICE_GROUP_INFO );
+            if( pDeviceGroupInfo )
+            {
+                pBindInfos[ i ].buffer->m_PeerMemoryMask = GetPeerMemoryMask(
+                    pDeviceGroupInfo->deviceIndexCount,
+                    pDeviceGroupInfo->pDeviceIndices );
+            }
         }
 
         return VK_SUCCESS;
     }
 
+    VkDeviceAddress Device::vkGetBufferDeviceAddress( const VkBufferDeviceAddressInfo* pInfo )
+    {
+        if( m_pMockFunctions->vkGetBufferDeviceAddress )
+        {
+            return m_pMockFunctions->vkGetBufferDeviceAddress(
+                GetApiHandle(),
+                pInfo );
+        }
+
+        return pInfo->buffer->GetDeviceAddress();
+    }
+
+    uint64_t Device::vkGetBufferOpaqueCaptureAddress( const VkBufferDeviceAddressInfo* pInfo )
+    {
+        if( m_pMockFunctions->vkGetBufferOpaqueCaptureAddress )
+        {
+            return m_pMockFunctions->vkGetBufferOpaqueCaptureAddress(
+                GetApiHandle(),
+                pInfo );
+        }
+
+        // Capture/replay is not supported, addresses depend on the host allocations.
+        return 0;
+    }
+
+    uint64_t Device::vkGetDeviceMemoryOpaqueCaptureAddress( const VkDeviceMemoryOpaqueCaptureAddressInfo* pInfo )
+    {
+        if( m_pMockFunctions->vkGetDeviceMemoryOpaqueCaptureAddress )
+        {
+            return m_pMockFunctions->vkGetDeviceMemoryOpaqueCaptureAddress(
+                GetApiHandle(),
+                pInfo );
+        }
+
+        return 0;
+    }
+
+#ifdef VK_KHR_buffer_device_address
+    VkDeviceAddress Device::vkGetBufferDeviceAddressKHR( const VkBufferDeviceAddressInfo* pInfo )
+    {
+        if( m_pMockFunctions->vkGetBufferDeviceAddressKHR )
+        {
+            return m_pMockFunctions->vkGetBufferDeviceAddressKHR(
+                GetApiHandle(),
+                pInfo );
+        }
+
+        return vkGetBufferDeviceAddress( pInfo );
+    }
+
+    uint64_t Device::vkGetBufferOpaqueCaptureAddressKHR( const VkBufferDeviceAddressInfo* pInfo )
+    {
+        if( m_pMockFunctions->vkGetBufferOpaqueCaptureAddressKHR )
+        {
+            return m_pMockFunctions->vkGetBufferOpaqueCaptureAddressKHR(
+                GetApiHandle(),
+                pInfo );
+        }
+
+        return vkGetBufferOpaqueCaptureAddress( pInfo );
+    }
+
+    uint64_t Device::vkGetDeviceMemoryOpaqueCaptureAddressKHR( const VkDeviceMemoryOpaqueCaptureAddressInfo* pInfo )
+    {
+        if( m_pMockFunctions->vkGetDeviceMemoryOpaqueCaptureAddressKHR )
+        {
+            return m_pMockFunctions->vkGetDeviceMemoryOpaqueCaptureAddressKHR(
+                GetApiHandle(),
+                pInfo );
+        }
+
+        return vkGetDeviceMemoryOpaqueCaptureAddress( pInfo );
+    }
+#endif
+
     VkResult Device::vkCreateImage( const VkImageCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkImage* pImage )
     {
         if( m_pMockFunctions->vkCreateImage )
@@ -396,11 +694,24 @@ namespace vkmock
                 pImage );
         }
 
-        return vk_new(
+        VkResult result = vk_new(
             pImage,
             vk_allocator( pAllocator, m_Allocator ),
             VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
             *pCreateInfo );
+
+#ifdef VK_EXT_host_image_copy
+        // Only images accessed with the host image copies can be swizzled, the transfer
+        // commands do not reorder the texels.
+        if( result == VK_SUCCESS &&
+            m_ImageSwizzle == VK_MOCK_IMAGE_SWIZZLE_MORTON_EXT &&
+            ( pCreateInfo->usage & VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT ) )
+        {
+            ( *pImage )->m_Swizzled = ( *pImage )->SupportsSwizzle();
+        }
+#endif
+
+        return result;
     }
 
     void Device::vkDestroyImage( VkImage image, const VkAllocationCallbacks* pAllocator )
@@ -427,10 +738,7 @@ namespace vkmock
                 pMemoryRequirements );
         }
 
-        VkExtent3D extent = image->m_Extent;
-        pMemoryRequirements->size = extent.width * extent.height * extent.depth * 4;
-        pMemoryRequirements->alignment = 1;
-        pMemoryRequirements->memoryTypeBits = 1;
+        image->GetMemoryRequirements( 0, pMemoryRequirements );
     }
 
     VkResult Device::vkBindImageMemory( VkImage image, VkDeviceMemory memory, VkDeviceSize memoryOffset )
@@ -444,11 +752,57 @@ namespace vkmock
                 memoryOffset );
         }
 
-        image->m_pData = memory->m_pAllocation + memoryOffset;
+        image->BindMemory( 0, memory->m_pAllocation + memoryOffset );
 
         return VK_SUCCESS;
     }
 
+    void Device::vkGetImageSubresourceLayout( VkImage image, const VkImageSubresource* pSubresource, VkSubresourceLayout* pLayout )
+    {
+        if( m_pMockFunctions->vkGetImageSubresourceLayout )
+        {
+            return m_pMockFunctions->vkGetImageSubresourceLayout(
+                GetApiHandle(),
+                image,
+                pSubresource,
+                pLayout );
+        }
+
+        image->GetSubresourceLayout( *pSubresource, pLayout );
+    }
+
+    VkResult Device::vkCreateImageView( const VkImageViewCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkImageView* pView )
+    {
+        if( m_pMockFunctions->vkCreateImageView )
+        {
+            return m_pMockFunctions->vkCreateImageView(
+                GetApiHandle(),
+                pCreateInfo,
+                pAllocator,
+                pView );
+        }
+
+        return vk_new(
+            pView,
+            vk_allocator( pAllocator, m_Allocator ),
+            VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+            *pCreateInfo );
+    }
+
+    void Device::vkDestroyImageView( VkImageView imageView, const VkAllocationCallbacks* pAllocator )
+    {
+        if( m_pMockFunctions->vkDestroyImageView )
+        {
+            return m_pMockFunctions->vkDestroyImageView(
+                GetApiHandle(),
+                imageView,
+                pAllocator );
+        }
+
+        vk_delete( imageView,
+            vk_allocator( pAllocator, m_Allocator ) );
+    }
+
     void Device::vkGetImageMemoryRequirements2( const VkImageMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements )
     {
         if( m_pMockFunctions->vkGetImageMemoryRequirements2 )
@@ -459,10 +813,16 @@ namespace vkmock
                 pMemoryRequirements );
         }
 
-        VkExtent3D extent = pInfo->image->m_Extent;
-        pMemoryRequirements->memoryRequirements.size = extent.width * extent.height * extent.depth * 4;
-        pMemoryRequirements->memoryRequirements.alignment = 1;
-        pMemoryRequirements->memoryRequirements.memoryTypeBits = 1;
+        VkImageAspectFlags planeAspect = 0;
+
+        const VkImagePlaneMemoryRequirementsInfo* pPlaneInfo = vk_find_struct<VkImagePlaneMemoryRequirementsInfo>(
+            pInfo->pNext, VK_STRUCTURE_TYPE_IMAGE_PLANE_MEMORY_REQUIREMENTS_INFO );
+        if( pPlaneInfo )
+        {
+            planeAspect = pPlaneInfo->planeAspect;
+        }
+
+        pInfo->image->GetMemoryRequirements( planeAspect, &pMemoryRequirements->memoryRequirements );
     }
 
     VkResult Device::vkBindImageMemory2( uint32_t bindInfoCount, const VkBindImageMemoryInfo* pBindInfos )
@@ -477,82 +837,632 @@ namespace vkmock
 
         for( uint32_t i = 0; i < bindInfoCount; ++i )
         {
-            pBindInfos[ i ].image->m_pData =
-                pBindInfos[ i ].memory->m_pAllocation + pBindInfos[ i ].memoryOffset;
+            VkImageAspectFlags planeAspect = 0;
+
+            const VkBindImagePlaneMemoryInfo* pPlaneInfo = vk_find_struct<VkBindImagePlaneMemoryInfo>(
+                pBindInfos[ i ].pNext, VK_STRUCTURE_TYPE_BIND_IMAGE_PLANE_MEMORY_INFO );
+            if( pPlaneInfo )
+            {
+                planeAspect = pPlaneInfo->planeAspect;
+            }
+
+            pBindInfos[ i ].image->BindMemory( planeAspect,
+                pBindInfos[ i ].memory->m_pAllocation + pBindInfos[ i ].memoryOffset );
+
+            const VkBindImageMemoryDeviceGroupInfo* pDeviceGroupInfo = vk_find_struct<VkBindImageMemoryDeviceGroupInfo>(
+                pBindInfos[ i ].pNext, VK_STRUCTURE_TYPE_BIND_IMAGE_MEMORY_DEVICE_GROUP_INFO );
+            if( pDeviceGroupInfo )
+            {
+                pBindInfos[ i ].image->m_PeerMemoryMask = GetPeerMemoryMask(
+                    pDeviceGroupInfo->deviceIndexCount,
+                    pDeviceGroupInfo->pDeviceIndices );
+            }
         }
 
         return VK_SUCCESS;
     }
 
-#ifdef VK_KHR_swapchain
-    VkResult Device::vkCreateSwapchainKHR( const VkSwapchainCreateInfoKHR* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkSwapchainKHR* pSwapchain )
+    void Device::vkGetDeviceGroupPeerMemoryFeatures( uint32_t heapIndex, uint32_t localDeviceIndex, uint32_t remoteDeviceIndex, VkPeerMemoryFeatureFlags* pPeerMemoryFeatures )
     {
-        if( m_pMockFunctions->vkCreateSwapchainKHR )
+        if( m_pMockFunctions->vkGetDeviceGroupPeerMemoryFeatures )
         {
-            return m_pMockFunctions->vkCreateSwapchainKHR(
+            return m_pMockFunctions->vkGetDeviceGroupPeerMemoryFeatures(
+                GetApiHandle(),
+                heapIndex,
+                localDeviceIndex,
+                remoteDeviceIndex,
+                pPeerMemoryFeatures );
+        }
+
+        // All memory instances live in the host memory, so peer memory supports all kinds of accesses.
+        *pPeerMemoryFeatures =
+            VK_PEER_MEMORY_FEATURE_COPY_SRC_BIT |
+            VK_PEER_MEMORY_FEATURE_COPY_DST_BIT |
+            VK_PEER_MEMORY_FEATURE_GENERIC_SRC_BIT |
+            VK_PEER_MEMORY_FEATURE_GENERIC_DST_BIT;
+    }
+
+#ifdef VK_KHR_device_group
+    void Device::vkGetDeviceGroupPeerMemoryFeaturesKHR( uint32_t heapIndex, uint32_t localDeviceIndex, uint32_t remoteDeviceIndex, VkPeerMemoryFeatureFlags* pPeerMemoryFeatures )
+    {
+        if( m_pMockFunctions->vkGetDeviceGroupPeerMemoryFeaturesKHR )
+        {
+            return m_pMockFunctions->vkGetDeviceGroupPeerMemoryFeaturesKHR(
+                GetApiHandle(),
+                heapIndex,
+                localDeviceIndex,
+                remoteDeviceIndex,
+                pPeerMemoryFeatures );
+        }
+
+        vkGetDeviceGroupPeerMemoryFeatures( heapIndex, localDeviceIndex, remoteDeviceIndex, pPeerMemoryFeatures );
+    }
+#endif
+
+    VkResult Device::vkCreateShaderModule( const VkShaderModuleCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkShaderModule* pShaderModule )
+    {
+        if( m_pMockFunctions->vkCreateShaderModule )
+        {
+            return m_pMockFunctions->vkCreateShaderModule(
                 GetApiHandle(),
                 pCreateInfo,
                 pAllocator,
-                pSwapchain );
+                pShaderModule );
         }
 
         return vk_new(
-            pSwapchain,
+            pShaderModule,
             vk_allocator( pAllocator, m_Allocator ),
             VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
             *pCreateInfo );
     }
 
-    void Device::vkDestroySwapchainKHR( VkSwapchainKHR swapchain, const VkAllocationCallbacks* pAllocator )
+    void Device::vkDestroyShaderModule( VkShaderModule shaderModule, const VkAllocationCallbacks* pAllocator )
     {
-        if( m_pMockFunctions->vkDestroySwapchainKHR )
+        if( m_pMockFunctions->vkDestroyShaderModule )
         {
-            return m_pMockFunctions->vkDestroySwapchainKHR(
+            return m_pMockFunctions->vkDestroyShaderModule(
                 GetApiHandle(),
-                swapchain,
+                shaderModule,
                 pAllocator );
         }
 
-        vk_delete( swapchain,
+        vk_delete( shaderModule,
             vk_allocator( pAllocator, m_Allocator ) );
     }
 
-    VkResult Device::vkGetSwapchainImagesKHR( VkSwapchainKHR swapchain, uint32_t* pSwapchainImageCount, VkImage* pSwapchainImages )
+    VkResult Device::vkCreateGraphicsPipelines( VkPipelineCache pipelineCache, uint32_t createInfoCount, const VkGraphicsPipelineCreateInfo* pCreateInfos, const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines )
     {
-        if( m_pMockFunctions->vkGetSwapchainImagesKHR )
+        if( m_pMockFunctions->vkCreateGraphicsPipelines )
         {
-            return m_pMockFunctions->vkGetSwapchainImagesKHR(
+            return m_pMockFunctions->vkCreateGraphicsPipelines(
                 GetApiHandle(),
-                swapchain,
-                pSwapchainImageCount,
-                pSwapchainImages );
+                pipelineCache,
+                createInfoCount,
+                pCreateInfos,
+                pAllocator,
+                pPipelines );
         }
 
-        if( !pSwapchainImages )
+        for( uint32_t i = 0; i < createInfoCount; ++i )
         {
-            *pSwapchainImageCount = 1;
-            return VK_SUCCESS;
-        }
+            VkResult result = vk_new(
+                &pPipelines[ i ],
+                vk_allocator( pAllocator, m_Allocator ),
+                VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+                pCreateInfos[ i ] );
 
-        if( *pSwapchainImageCount < 1 )
-        {
-            return VK_INCOMPLETE;
-        }
+            if( result != VK_SUCCESS )
+            {
+                for( uint32_t j = 0; j < i; ++j )
+                {
+                    vk_delete( pPipelines[ j ],
+                        vk_allocator( pAllocator, m_Allocator ) );
 
-        pSwapchainImages[ 0 ] = swapchain->m_Image;
+                    pPipelines[ j ] = VK_NULL_HANDLE;
+                }
+
+                return result;
+            }
+        }
 
         return VK_SUCCESS;
     }
 
-    VkResult Device::vkAcquireNextImageKHR( VkSwapchainKHR swapchain, uint64_t timeout, VkSemaphore semaphore, VkFence fence, uint32_t* pImageIndex )
+    VkResult Device::vkCreateComputePipelines( VkPipelineCache pipelineCache, uint32_t createInfoCount, const VkComputePipelineCreateInfo* pCreateInfos, const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines )
     {
-        if( m_pMockFunctions->vkAcquireNextImageKHR )
+        if( m_pMockFunctions->vkCreateComputePipelines )
         {
-            return m_pMockFunctions->vkAcquireNextImageKHR(
+            return m_pMockFunctions->vkCreateComputePipelines(
                 GetApiHandle(),
-                swapchain,
-                timeout,
-                semaphore,
+                pipelineCache,
+                createInfoCount,
+                pCreateInfos,
+                pAllocator,
+                pPipelines );
+        }
+
+        for( uint32_t i = 0; i < createInfoCount; ++i )
+        {
+            VkResult result = vk_new(
+                &pPipelines[ i ],
+                vk_allocator( pAllocator, m_Allocator ),
+                VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+                pCreateInfos[ i ] );
+
+            if( result != VK_SUCCESS )
+            {
+                for( uint32_t j = 0; j < i; ++j )
+                {
+                    vk_delete( pPipelines[ j ],
+                        vk_allocator( pAllocator, m_Allocator ) );
+
+                    pPipelines[ j ] = VK_NULL_HANDLE;
+                }
+
+                return result;
+            }
+        }
+
+        return VK_SUCCESS;
+    }
+
+    void Device::vkDestroyPipeline( VkPipeline pipeline, const VkAllocationCallbacks* pAllocator )
+    {
+        if( m_pMockFunctions->vkDestroyPipeline )
+        {
+            return m_pMockFunctions->vkDestroyPipeline(
+                GetApiHandle(),
+                pipeline,
+                pAllocator );
+        }
+
+        vk_delete( pipeline,
+            vk_allocator( pAllocator, m_Allocator ) );
+    }
+
+    VkResult Device::vkCreatePipelineLayout( const VkPipelineLayoutCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkPipelineLayout* pPipelineLayout )
+    {
+        if( m_pMockFunctions->vkCreatePipelineLayout )
+        {
+            return m_pMockFunctions->vkCreatePipelineLayout(
+                GetApiHandle(),
+                pCreateInfo,
+                pAllocator,
+                pPipelineLayout );
+        }
+
+        return vk_new(
+            pPipelineLayout,
+            vk_allocator( pAllocator, m_Allocator ),
+            VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+            *pCreateInfo );
+    }
+
+    void Device::vkDestroyPipelineLayout( VkPipelineLayout pipelineLayout, const VkAllocationCallbacks* pAllocator )
+    {
+        if( m_pMockFunctions->vkDestroyPipelineLayout )
+        {
+            return m_pMockFunctions->vkDestroyPipelineLayout(
+                GetApiHandle(),
+                pipelineLayout,
+                pAllocator );
+        }
+
+        vk_delete( pipelineLayout,
+            vk_allocator( pAllocator, m_Allocator ) );
+    }
+
+    VkResult Device::vkCreateDescriptorSetLayout( const VkDescriptorSetLayoutCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDescriptorSetLayout* pSetLayout )
+    {
+        if( m_pMockFunctions->vkCreateDescriptorSetLayout )
+        {
+            return m_pMockFunctions->vkCreateDescriptorSetLayout(
+                GetApiHandle(),
+                pCreateInfo,
+                pAllocator,
+                pSetLayout );
+        }
+
+        return vk_new(
+            pSetLayout,
+            vk_allocator( pAllocator, m_Allocator ),
+            VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+            *pCreateInfo );
+    }
+
+    void Device::vkDestroyDescriptorSetLayout( VkDescriptorSetLayout descriptorSetLayout, const VkAllocationCallbacks* pAllocator )
+    {
+        if( m_pMockFunctions->vkDestroyDescriptorSetLayout )
+        {
+            return m_pMockFunctions->vkDestroyDescriptorSetLayout(
+                GetApiHandle(),
+                descriptorSetLayout,
+                pAllocator );
+        }
+
+        vk_delete( descriptorSetLayout,
+            vk_allocator( pAllocator, m_Allocator ) );
+    }
+
+    VkResult Device::vkCreateDescriptorPool( const VkDescriptorPoolCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDescriptorPool* pDescriptorPool )
+    {
+        if( m_pMockFunctions->vkCreateDescriptorPool )
+        {
+            return m_pMockFunctions->vkCreateDescriptorPool(
+                GetApiHandle(),
+                pCreateInfo,
+                pAllocator,
+                pDescriptorPool );
+        }
+
+        return vk_new(
+            pDescriptorPool,
+            vk_allocator( pAllocator, m_Allocator ),
+            VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+            *pCreateInfo );
+    }
+
+    void Device::vkDestroyDescriptorPool( VkDescriptorPool descriptorPool, const VkAllocationCallbacks* pAllocator )
+    {
+        if( m_pMockFunctions->vkDestroyDescriptorPool )
+        {
+            return m_pMockFunctions->vkDestroyDescriptorPool(
+                GetApiHandle(),
+                descriptorPool,
+                pAllocator );
+        }
+
+        vk_delete( descriptorPool,
+            vk_allocator( pAllocator, m_Allocator ) );
+    }
+
+    VkResult Device::vkResetDescriptorPool( VkDescriptorPool descriptorPool, VkDescriptorPoolResetFlags flags )
+    {
+        if( m_pMockFunctions->vkResetDescriptorPool )
+        {
+            return m_pMockFunctions->vkResetDescriptorPool(
+                GetApiHandle(),
+                descriptorPool,
+                flags );
+        }
+
+        descriptorPool->Reset();
+        return VK_SUCCESS;
+    }
+
+    VkResult Device::vkAllocateDescriptorSets( const VkDescriptorSetAllocateInfo* pAllocateInfo, VkDescriptorSet* pDescriptorSets )
+    {
+        if( m_pMockFunctions->vkAllocateDescriptorSets )
+        {
+            return m_pMockFunctions->vkAllocateDescriptorSets(
+                GetApiHandle(),
+                pAllocateInfo,
+                pDescriptorSets );
+        }
+
+        for( uint32_t i = 0; i < pAllocateInfo->descriptorSetCount; ++i )
+        {
+            VkResult result = vk_new(
+                &pDescriptorSets[ i ],
+                pAllocateInfo->descriptorPool->m_Allocator,
+                VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+                pAllocateInfo->descriptorPool,
+                pAllocateInfo->pSetLayouts[ i ] );
+
+            if( result != VK_SUCCESS )
+            {
+                for( uint32_t j = 0; j < i; ++j )
+                {
+                    vk_delete( pDescriptorSets[ j ],
+                        pAllocateInfo->descriptorPool->m_Allocator );
+
+                    pDescriptorSets[ j ] = VK_NULL_HANDLE;
+                }
+
+                return result;
+            }
+        }
+
+        return VK_SUCCESS;
+    }
+
+    VkResult Device::vkFreeDescriptorSets( VkDescriptorPool descriptorPool, uint32_t descriptorSetCount, const VkDescriptorSet* pDescriptorSets )
+    {
+        if( m_pMockFunctions->vkFreeDescriptorSets )
+        {
+            return m_pMockFunctions->vkFreeDescriptorSets(
+                GetApiHandle(),
+                descriptorPool,
+                descriptorSetCount,
+                pDescriptorSets );
+        }
+
+        for( uint32_t i = 0; i < descriptorSetCount; ++i )
+        {
+            vk_delete( pDescriptorSets[ i ], descriptorPool->m_Allocator );
+        }
+
+        return VK_SUCCESS;
+    }
+
+    void Device::vkUpdateDescriptorSets( uint32_t descriptorWriteCount, const VkWriteDescriptorSet* pDescriptorWrites, uint32_t descriptorCopyCount, const VkCopyDescriptorSet* pDescriptorCopies )
+    {
+        if( m_pMockFunctions->vkUpdateDescriptorSets )
+        {
+            return m_pMockFunctions->vkUpdateDescriptorSets(
+                GetApiHandle(),
+                descriptorWriteCount,
+                pDescriptorWrites,
+                descriptorCopyCount,
+                pDescriptorCopies );
+        }
+
+        for( uint32_t i = 0; i < descriptorWriteCount; ++i )
+        {
+            pDescriptorWrites[ i ].dstSet->Write( pDescriptorWrites[ i ] );
+        }
+
+        for( uint32_t i = 0; i < descriptorCopyCount; ++i )
+        {
+            pDescriptorCopies[ i ].dstSet->Copy( pDescriptorCopies[ i ] );
+        }
+    }
+
+#ifdef VK_KHR_external_memory_fd
+    VkResult Device::vkGetMemoryFdKHR( const VkMemoryGetFdInfoKHR* pGetFdInfo, int* pFd )
+    {
+        if( m_pMockFunctions->vkGetMemoryFdKHR )
+        {
+            return m_pMockFunctions->vkGetMemoryFdKHR(
+                GetApiHandle(),
+                pGetFdInfo,
+                pFd );
+        }
+
+#ifdef VK_MOCK_ICD_MEMFD
+        if( pGetFdInfo->handleType == VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT &&
+            pGetFdInfo->memory->m_Type == DeviceMemoryType::eFd )
+        {
+            // Each export creates a new reference to the file, owned by the application.
+            *pFd = dup( pGetFdInfo->memory->m_Fd );
+            if( *pFd < 0 )
+            {
+                return VK_ERROR_TOO_MANY_OBJECTS;
+            }
+
+            return VK_SUCCESS;
+        }
+#endif
+
+        return VK_ERROR_INVALID_EXTERNAL_HANDLE;
+    }
+
+    VkResult Device::vkGetMemoryFdPropertiesKHR( VkExternalMemoryHandleTypeFlagBits handleType, int fd, VkMemoryFdPropertiesKHR* pMemoryFdProperties )
+    {
+        if( m_pMockFunctions->vkGetMemoryFdPropertiesKHR )
+        {
+            return m_pMockFunctions->vkGetMemoryFdPropertiesKHR(
+                GetApiHandle(),
+                handleType,
+                fd,
+                pMemoryFdProperties );
+        }
+
+        // Opaque file descriptors cannot be queried, and no other handle types are supported.
+        return VK_ERROR_INVALID_EXTERNAL_HANDLE;
+    }
+#endif
+
+#ifdef VK_EXT_external_memory_host
+    VkResult Device::vkGetMemoryHostPointerPropertiesEXT( VkExternalMemoryHandleTypeFlagBits handleType, const void* pHostPointer, VkMemoryHostPointerPropertiesEXT* pMemoryHostPointerProperties )
+    {
+        if( m_pMockFunctions->vkGetMemoryHostPointerPropertiesEXT )
+        {
+            return m_pMockFunctions->vkGetMemoryHostPointerPropertiesEXT(
+                GetApiHandle(),
+                handleType,
+                pHostPointer,
+                pMemoryHostPointerProperties );
+        }
+
+        if( ( handleType != VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT &&
+                handleType != VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_MAPPED_FOREIGN_MEMORY_BIT_EXT ) ||
+            ( reinterpret_cast<uintptr_t>( pHostPointer ) % g_MinImportedHostPointerAlignment ) != 0 )
+        {
+            return VK_ERROR_INVALID_EXTERNAL_HANDLE;
+        }
+
+        pMemoryHostPointerProperties->memoryTypeBits = 1;
+
+        return VK_SUCCESS;
+    }
+#endif
+
+#ifdef VK_KHR_maintenance5
+    void Device::vkGetImageSubresourceLayout2KHR( VkImage image, const VkImageSubresource2KHR* pSubresource, VkSubresourceLayout2KHR* pLayout )
+    {
+        if( m_pMockFunctions->vkGetImageSubresourceLayout2KHR )
+        {
+            return m_pMockFunctions->vkGetImageSubresourceLayout2KHR(
+                GetApiHandle(),
+                image,
+                pSubresource,
+                pLayout );
+        }
+
+        image->GetSubresourceLayout( pSubresource->imageSubresource, &pLayout->subresourceLayout );
+
+#ifdef VK_EXT_host_image_copy
+        GetHostMemcpySize( pLayout->pNext, pLayout->subresourceLayout );
+#endif
+    }
+#endif
+
+#ifdef VK_EXT_host_image_copy
+    VkResult Device::vkCopyMemoryToImageEXT( const VkCopyMemoryToImageInfoEXT* pCopyMemoryToImageInfo )
+    {
+        if( m_pMockFunctions->vkCopyMemoryToImageEXT )
+        {
+            return m_pMockFunctions->vkCopyMemoryToImageEXT(
+                GetApiHandle(),
+                pCopyMemoryToImageInfo );
+        }
+
+        for( uint32_t i = 0; i < pCopyMemoryToImageInfo->regionCount; ++i )
+        {
+            CopyMemoryToImageRegion(
+                m_ThreadPool,
+                pCopyMemoryToImageInfo->dstImage,
+                pCopyMemoryToImageInfo->pRegions[ i ],
+                pCopyMemoryToImageInfo->flags );
+        }
+
+        return VK_SUCCESS;
+    }
+
+    VkResult Device::vkCopyImageToMemoryEXT( const VkCopyImageToMemoryInfoEXT* pCopyImageToMemoryInfo )
+    {
+        if( m_pMockFunctions->vkCopyImageToMemoryEXT )
+        {
+            return m_pMockFunctions->vkCopyImageToMemoryEXT(
+                GetApiHandle(),
+                pCopyImageToMemoryInfo );
+        }
+
+        for( uint32_t i = 0; i < pCopyImageToMemoryInfo->regionCount; ++i )
+        {
+            CopyImageToMemoryRegion(
+                m_ThreadPool,
+                pCopyImageToMemoryInfo->srcImage,
+                pCopyImageToMemoryInfo->pRegions[ i ],
+                pCopyImageToMemoryInfo->flags );
+        }
+
+        return VK_SUCCESS;
+    }
+
+    VkResult Device::vkCopyImageToImageEXT( const VkCopyImageToImageInfoEXT* pCopyImageToImageInfo )
+    {
+        if( m_pMockFunctions->vkCopyImageToImageEXT )
+        {
+            return m_pMockFunctions->vkCopyImageToImageEXT(
+                GetApiHandle(),
+                pCopyImageToImageInfo );
+        }
+
+        for( uint32_t i = 0; i < pCopyImageToImageInfo->regionCount; ++i )
+        {
+            CopyImageToImageRegion(
+                m_ThreadPool,
+                pCopyImageToImageInfo->srcImage,
+                pCopyImageToImageInfo->dstImage,
+                pCopyImageToImageInfo->pRegions[ i ],
+                pCopyImageToImageInfo->flags );
+        }
+
+        return VK_SUCCESS;
+    }
+
+    VkResult Device::vkTransitionImageLayoutEXT( uint32_t transitionCount, const VkHostImageLayoutTransitionInfoEXT* pTransitions )
+    {
+        if( m_pMockFunctions->vkTransitionImageLayoutEXT )
+        {
+            return m_pMockFunctions->vkTransitionImageLayoutEXT(
+                GetApiHandle(),
+                transitionCount,
+                pTransitions );
+        }
+
+        // Images have the same memory layout in all image layouts.
+        return VK_SUCCESS;
+    }
+
+    void Device::vkGetImageSubresourceLayout2EXT( VkImage image, const VkImageSubresource2EXT* pSubresource, VkSubresourceLayout2EXT* pLayout )
+    {
+        if( m_pMockFunctions->vkGetImageSubresourceLayout2EXT )
+        {
+            return m_pMockFunctions->vkGetImageSubresourceLayout2EXT(
+                GetApiHandle(),
+                image,
+                pSubresource,
+                pLayout );
+        }
+
+        image->GetSubresourceLayout( pSubresource->imageSubresource, &pLayout->subresourceLayout );
+        GetHostMemcpySize( pLayout->pNext, pLayout->subresourceLayout );
+    }
+#endif
+
+#ifdef VK_KHR_swapchain
+    VkResult Device::vkCreateSwapchainKHR( const VkSwapchainCreateInfoKHR* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkSwapchainKHR* pSwapchain )
+    {
+        if( m_pMockFunctions->vkCreateSwapchainKHR )
+        {
+            return m_pMockFunctions->vkCreateSwapchainKHR(
+                GetApiHandle(),
+                pCreateInfo,
+                pAllocator,
+                pSwapchain );
+        }
+
+        return vk_new(
+            pSwapchain,
+            vk_allocator( pAllocator, m_Allocator ),
+            VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+            *pCreateInfo );
+    }
+
+    void Device::vkDestroySwapchainKHR( VkSwapchainKHR swapchain, const VkAllocationCallbacks* pAllocator )
+    {
+        if( m_pMockFunctions->vkDestroySwapchainKHR )
+        {
+            return m_pMockFunctions->vkDestroySwapchainKHR(
+                GetApiHandle(),
+                swapchain,
+                pAllocator );
+        }
+
+        vk_delete( swapchain,
+            vk_allocator( pAllocator, m_Allocator ) );
+    }
+
+    VkResult Device::vkGetSwapchainImagesKHR( VkSwapchainKHR swapchain, uint32_t* pSwapchainImageCount, VkImage* pSwapchainImages )
+    {
+        if( m_pMockFunctions->vkGetSwapchainImagesKHR )
+        {
+            return m_pMockFunctions->vkGetSwapchainImagesKHR(
+                GetApiHandle(),
+                swapchain,
+                pSwapchainImageCount,
+                pSwapchainImages );
+        }
+
+        if( !pSwapchainImages )
+        {
+            *pSwapchainImageCount = 1;
+            return VK_SUCCESS;
+        }
+
+        if( *pSwapchainImageCount < 1 )
+        {
+            return VK_INCOMPLETE;
+        }
+
+        pSwapchainImages[ 0 ] = swapchain->m_Image;
+
+        return VK_SUCCESS;
+    }
+
+    VkResult Device::vkAcquireNextImageKHR( VkSwapchainKHR swapchain, uint64_t timeout, VkSemaphore semaphore, VkFence fence, uint32_t* pImageIndex )
+    {
+        if( m_pMockFunctions->vkAcquireNextImageKHR )
+        {
+            return m_pMockFunctions->vkAcquireNextImageKHR(
+                GetApiHandle(),
+                swapchain,
+                timeout,
+                semaphore,
                 fence,
                 pImageIndex );
         }
@@ -577,4 +1487,14 @@ namespace vkmock
         return VK_SUCCESS;
     }
 #endif
+
+    void Device::BindBufferMemory( VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize memoryOffset )
+    {
+        buffer->m_pData = memory->m_pAllocation + memoryOffset;
+
+        if( buffer->m_Usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT )
+        {
+            m_AddressMap.Insert( buffer );
+        }
+    }
 }
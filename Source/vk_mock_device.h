@@ -19,7 +19,12 @@
 // SOFTWARE.
 
 #pragma once
+#include "vk_mock.h"
 #include "vk_mock_icd_base.h"
+#include "vk_mock_address_map.h"
+#include "vk_mock_draw.h"
+#include "vk_mock_performance_query.h"
+#include "vk_mock_thread_pool.h"
 
 namespace vkmock
 {
@@ -27,7 +32,18 @@ namespace vkmock
     {
         VkAllocationCallbacks m_Allocator;
         VkPhysicalDevice m_PhysicalDevice;
+        uint32_t m_PhysicalDeviceCount;
+        VkPhysicalDevice m_PhysicalDevices[ VK_MAX_DEVICE_GROUP_SIZE ];
+        uint32_t m_DeviceMask;
         VkQueue m_Queue;
+        DeviceAddressMap m_AddressMap;
+        ThreadPool m_ThreadPool;
+        VkMockImageSwizzleEXT m_ImageSwizzle;
+        VkMockRasterizerEXT m_Rasterizer;
+        VertexCacheInfo m_VertexCache;
+        DrawCounters m_DrawCounters;
+        ExecutionCounters m_ExecutionCounters;
+        ProfilingLock m_ProfilingLock;
 
         Device( VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo& createInfo );
         ~Device();
@@ -39,6 +55,8 @@ namespace vkmock
 
         VkResult vkCreateQueryPool( const VkQueryPoolCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkQueryPool* pQueryPool );
         void vkDestroyQueryPool( VkQueryPool queryPool, const VkAllocationCallbacks* pAllocator );
+        VkResult vkGetQueryPoolResults( VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount, size_t dataSize, void* pData, VkDeviceSize stride, VkQueryResultFlags flags );
+        void vkResetQueryPool( VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount );
 
         VkResult vkCreateCommandPool( const VkCommandPoolCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkCommandPool* pCommandPool );
         void vkDestroyCommandPool( VkCommandPool commandPool, const VkAllocationCallbacks* pAllocator );
@@ -60,6 +78,10 @@ namespace vkmock
         void vkDestroyImage( VkImage image, const VkAllocationCallbacks* pAllocator );
         void vkGetImageMemoryRequirements( VkImage image, VkMemoryRequirements* pMemoryRequirements );
         VkResult vkBindImageMemory( VkImage image, VkDeviceMemory memory, VkDeviceSize memoryOffset );
+        void vkGetImageSubresourceLayout( VkImage image, const VkImageSubresource* pSubresource, VkSubresourceLayout* pLayout );
+
+        VkResult vkCreateImageView( const VkImageViewCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkImageView* pView );
+        void vkDestroyImageView( VkImageView imageView, const VkAllocationCallbacks* pAllocator );
 
         void vkGetBufferMemoryRequirements2( const VkBufferMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements );
         void vkGetImageMemoryRequirements2( const VkImageMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements );
@@ -67,6 +89,81 @@ namespace vkmock
         VkResult vkBindBufferMemory2( uint32_t bindInfoCount, const VkBindBufferMemoryInfo* pBindInfos );
         VkResult vkBindImageMemory2( uint32_t bindInfoCount, const VkBindImageMemoryInfo* pBindInfos );
 
+        void vkGetDeviceGroupPeerMemoryFeatures( uint32_t heapIndex, uint32_t localDeviceIndex, uint32_t remoteDeviceIndex, VkPeerMemoryFeatureFlags* pPeerMemoryFeatures );
+
+        VkResult vkCreateShaderModule( const VkShaderModuleCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkShaderModule* pShaderModule );
+        void vkDestroyShaderModule( VkShaderModule shaderModule, const VkAllocationCallbacks* pAllocator );
+
+        VkResult vkCreateGraphicsPipelines( VkPipelineCache pipelineCache, uint32_t createInfoCount, const VkGraphicsPipelineCreateInfo* pCreateInfos, const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines );
+        VkResult vkCreateComputePipelines( VkPipelineCache pipelineCache, uint32_t createInfoCount, const VkComputePipelineCreateInfo* pCreateInfos, const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines );
+        void vkDestroyPipeline( VkPipeline pipeline, const VkAllocationCallbacks* pAllocator );
+
+        VkResult vkCreatePipelineLayout( const VkPipelineLayoutCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkPipelineLayout* pPipelineLayout );
+        void vkDestroyPipelineLayout( VkPipelineLayout pipelineLayout, const VkAllocationCallbacks* pAllocator );
+
+        VkResult vkCreateDescriptorSetLayout( const VkDescriptorSetLayoutCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDescriptorSetLayout* pSetLayout );
+        void vkDestroyDescriptorSetLayout( VkDescriptorSetLayout descriptorSetLayout, const VkAllocationCallbacks* pAllocator );
+
+        VkResult vkCreateDescriptorPool( const VkDescriptorPoolCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDescriptorPool* pDescriptorPool );
+        void vkDestroyDescriptorPool( VkDescriptorPool descriptorPool, const VkAllocationCallbacks* pAllocator );
+        VkResult vkResetDescriptorPool( VkDescriptorPool descriptorPool, VkDescriptorPoolResetFlags flags );
+
+        VkResult vkAllocateDescriptorSets( const VkDescriptorSetAllocateInfo* pAllocateInfo, VkDescriptorSet* pDescriptorSets );
+        VkResult vkFreeDescriptorSets( VkDescriptorPool descriptorPool, uint32_t descriptorSetCount, const VkDescriptorSet* pDescriptorSets );
+        void vkUpdateDescriptorSets( uint32_t descriptorWriteCount, const VkWriteDescriptorSet* pDescriptorWrites, uint32_t descriptorCopyCount, const VkCopyDescriptorSet* pDescriptorCopies );
+
+        VkDeviceAddress vkGetBufferDeviceAddress( const VkBufferDeviceAddressInfo* pInfo );
+        uint64_t vkGetBufferOpaqueCaptureAddress( const VkBufferDeviceAddressInfo* pInfo );
+        uint64_t vkGetDeviceMemoryOpaqueCaptureAddress( const VkDeviceMemoryOpaqueCaptureAddressInfo* pInfo );
+
+#ifdef VK_KHR_buffer_device_address
+        VkDeviceAddress vkGetBufferDeviceAddressKHR( const VkBufferDeviceAddressInfo* pInfo );
+        uint64_t vkGetBufferOpaqueCaptureAddressKHR( const VkBufferDeviceAddressInfo* pInfo );
+        uint64_t vkGetDeviceMemoryOpaqueCaptureAddressKHR( const VkDeviceMemoryOpaqueCaptureAddressInfo* pInfo );
+#endif
+
+#ifdef VK_EXT_host_query_reset
+        void vkResetQueryPoolEXT( VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount );
+#endif
+
+#ifdef VK_KHR_calibrated_timestamps
+        VkResult vkGetCalibratedTimestampsKHR( uint32_t timestampCount, const VkCalibratedTimestampInfoKHR* pTimestampInfos, uint64_t* pTimestamps, uint64_t* pMaxDeviation );
+#endif
+
+#ifdef VK_EXT_calibrated_timestamps
+        VkResult vkGetCalibratedTimestampsEXT( uint32_t timestampCount, const VkCalibratedTimestampInfoEXT* pTimestampInfos, uint64_t* pTimestamps, uint64_t* pMaxDeviation );
+#endif
+
+#ifdef VK_KHR_performance_query
+        VkResult vkAcquireProfilingLockKHR( const VkAcquireProfilingLockInfoKHR* pInfo );
+        void vkReleaseProfilingLockKHR();
+#endif
+
+#ifdef VK_KHR_device_group
+        void vkGetDeviceGroupPeerMemoryFeaturesKHR( uint32_t heapIndex, uint32_t localDeviceIndex, uint32_t remoteDeviceIndex, VkPeerMemoryFeatureFlags* pPeerMemoryFeatures );
+#endif
+
+#ifdef VK_KHR_external_memory_fd
+        VkResult vkGetMemoryFdKHR( const VkMemoryGetFdInfoKHR* pGetFdInfo, int* pFd );
+        VkResult vkGetMemoryFdPropertiesKHR( VkExternalMemoryHandleTypeFlagBits handleType, int fd, VkMemoryFdPropertiesKHR* pMemoryFdProperties );
+#endif
+
+#ifdef VK_EXT_external_memory_host
+        VkResult vkGetMemoryHostPointerPropertiesEXT( VkExternalMemoryHandleTypeFlagBits handleType, const void* pHostPointer, VkMemoryHostPointerPropertiesEXT* pMemoryHostPointerProperties );
+#endif
+
+#ifdef VK_KHR_maintenance5
+        void vkGetImageSubresourceLayout2KHR( VkImage image, const VkImageSubresource2KHR* pSubresource, VkSubresourceLayout2KHR* pLayout );
+#endif
+
+#ifdef VK_EXT_host_image_copy
+        VkResult vkCopyMemoryToImageEXT( const VkCopyMemoryToImageInfoEXT* pCopyMemoryToImageInfo );
+        VkResult vkCopyImageToMemoryEXT( const VkCopyImageToMemoryInfoEXT* pCopyImageToMemoryInfo );
+        VkResult vkCopyImageToImageEXT( const VkCopyImageToImageInfoEXT* pCopyImageToImageInfo );
+        VkResult vkTransitionImageLayoutEXT( uint32_t transitionCount, const VkHostImageLayoutTransitionInfoEXT* pTransitions );
+        void vkGetImageSubresourceLayout2EXT( VkImage image, const VkImageSubresource2EXT* pSubresource, VkSubresourceLayout2EXT* pLayout );
+#endif
+
 #ifdef VK_KHR_swapchain
         VkResult vkCreateSwapchainKHR( const VkSwapchainCreateInfoKHR* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkSwapchainKHR* pSwapchain );
         void vkDestroySwapchainKHR( VkSwapchainKHR swapchain, const VkAllocationCallbacks* pAllocator );
@@ -74,6 +171,8 @@ namespace vkmock
         VkResult vkAcquireNextImageKHR( VkSwapchainKHR swapchain, uint64_t timeout, VkSemaphore semaphore, VkFence fence, uint32_t* pImageIndex );
         VkResult vkAcquireNextImage2KHR( const VkAcquireNextImageInfoKHR* pAcquireInfo, uint32_t* pImageIndex );
 #endif
+
+        void BindBufferMemory( VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize memoryOffset );
     };
 }
 
@@ -0,0 +1,181 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_device_memory.h"
+#include "vk_mock_icd_helpers.h"
+
+#include <stdlib.h>
+
+#ifdef VK_MOCK_ICD_MEMFD
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vkmock
+{
+    DeviceMemory::DeviceMemory( const VkMemoryAllocateInfo& allocateInfo )
+        : m_pAllocation( nullptr )
+        , m_Size( allocateInfo.allocationSize )
+        , m_Type( DeviceMemoryType::ePrivate )
+        , m_Fd( -1 )
+    {
+#ifdef VK_EXT_external_memory_host
+        const VkImportMemoryHostPointerInfoEXT* pImportHostPointerInfo = vk_find_struct<VkImportMemoryHostPointerInfoEXT>(
+            allocateInfo.pNext, VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT );
+
+        if( pImportHostPointerInfo && pImportHostPointerInfo->handleType )
+        {
+            if( pImportHostPointerInfo->handleType != VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT &&
+                pImportHostPointerInfo->handleType != VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_MAPPED_FOREIGN_MEMORY_BIT_EXT )
+            {
+                throw VK_ERROR_INVALID_EXTERNAL_HANDLE;
+            }
+
+            ImportHostPointer( allocateInfo, pImportHostPointerInfo->pHostPointer );
+            return;
+        }
+#endif
+
+#ifdef VK_MOCK_ICD_MEMFD
+        const VkImportMemoryFdInfoKHR* pImportFdInfo = vk_find_struct<VkImportMemoryFdInfoKHR>(
+            allocateInfo.pNext, VK_STRUCTURE_TYPE_IMPORT_MEMORY_FD_INFO_KHR );
+
+        if( pImportFdInfo && pImportFdInfo->handleType )
+        {
+            if( pImportFdInfo->handleType != VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT )
+            {
+                throw VK_ERROR_INVALID_EXTERNAL_HANDLE;
+            }
+
+            ImportFd( allocateInfo, pImportFdInfo->fd );
+            return;
+        }
+
+        const VkExportMemoryAllocateInfo* pExportInfo = vk_find_struct<VkExportMemoryAllocateInfo>(
+            allocateInfo.pNext, VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO );
+
+        if( pExportInfo && ( pExportInfo->handleTypes & VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT ) )
+        {
+            CreateFd( allocateInfo );
+            return;
+        }
+#endif
+
+        m_pAllocation = static_cast<uint8_t*>( malloc( m_Size ) );
+        if( !m_pAllocation )
+        {
+            throw VK_ERROR_OUT_OF_DEVICE_MEMORY;
+        }
+    }
+
+    DeviceMemory::~DeviceMemory()
+    {
+        switch( m_Type )
+        {
+        case DeviceMemoryType::ePrivate:
+            free( m_pAllocation );
+            break;
+
+        case DeviceMemoryType::eHostPointer:
+            // Imported host memory is owned by the application and must stay
+            // untouched when the allocation is freed.
+            break;
+
+        case DeviceMemoryType::eFd:
+#ifdef VK_MOCK_ICD_MEMFD
+            munmap( m_pAllocation, m_Size );
+            close( m_Fd );
+#endif
+            break;
+        }
+    }
+
+#ifdef VK_EXT_external_memory_host
+    void DeviceMemory::ImportHostPointer( const VkMemoryAllocateInfo& allocateInfo, void* pHostPointer )
+    {
+        const uintptr_t address = reinterpret_cast<uintptr_t>( pHostPointer );
+
+        if( !pHostPointer ||
+            ( address % g_MinImportedHostPointerAlignment ) != 0 ||
+            ( allocateInfo.allocationSize % g_MinImportedHostPointerAlignment ) != 0 )
+        {
+            throw VK_ERROR_INVALID_EXTERNAL_HANDLE;
+        }
+
+        // The memory is used in-place, without copying.
+        m_pAllocation = static_cast<uint8_t*>( pHostPointer );
+        m_Type = DeviceMemoryType::eHostPointer;
+    }
+#endif
+
+#ifdef VK_MOCK_ICD_MEMFD
+    void DeviceMemory::CreateFd( const VkMemoryAllocateInfo& allocateInfo )
+    {
+        // Exportable memory is backed by an anonymous file, so that the same
+        // pages can be mapped by other devices and processes.
+        int fd = memfd_create( "vk_mock_icd", MFD_CLOEXEC );
+        if( fd < 0 )
+        {
+            throw VK_ERROR_OUT_OF_DEVICE_MEMORY;
+        }
+
+        if( ftruncate( fd, static_cast<off_t>( allocateInfo.allocationSize ) ) != 0 )
+        {
+            close( fd );
+            throw VK_ERROR_OUT_OF_DEVICE_MEMORY;
+        }
+
+        try
+        {
+            ImportFd( allocateInfo, fd );
+        }
+        catch( ... )
+        {
+            close( fd );
+            throw VK_ERROR_OUT_OF_DEVICE_MEMORY;
+        }
+    }
+
+    void DeviceMemory::ImportFd( const VkMemoryAllocateInfo& allocateInfo, int fd )
+    {
+        // Accesses past the end of the mapped file raise SIGBUS, so the file must cover the allocation.
+        struct stat fileInfo;
+        if( fstat( fd, &fileInfo ) != 0 ||
+            fileInfo.st_size < 0 ||
+            uint64_t( fileInfo.st_size ) < allocateInfo.allocationSize )
+        {
+            throw VK_ERROR_INVALID_EXTERNAL_HANDLE;
+        }
+
+        void* pAllocation = mmap( nullptr, allocateInfo.allocationSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+        if( pAllocation == MAP_FAILED )
+        {
+            throw VK_ERROR_INVALID_EXTERNAL_HANDLE;
+        }
+
+        // The implementation takes the ownership of the file descriptor
+        // after the successful import.
+        m_pAllocation = static_cast<uint8_t*>( pAllocation );
+        m_Type = DeviceMemoryType::eFd;
+        m_Fd = fd;
+    }
+#endif
+}
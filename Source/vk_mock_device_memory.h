@@ -23,23 +23,34 @@
 
 namespace vkmock
 {
+    enum class DeviceMemoryType
+    {
+        ePrivate,
+        eFd,
+        eHostPointer
+    };
+
+    // Imported host pointers and sizes must be aligned to the page size.
+    static constexpr VkDeviceSize g_MinImportedHostPointerAlignment = 4096;
+
     struct DeviceMemory
     {
         uint8_t* m_pAllocation;
+        VkDeviceSize m_Size;
+        DeviceMemoryType m_Type;
+        int m_Fd;
+
+        explicit DeviceMemory( const VkMemoryAllocateInfo& allocateInfo );
+        ~DeviceMemory();
+
+#ifdef VK_EXT_external_memory_host
+        void ImportHostPointer( const VkMemoryAllocateInfo& allocateInfo, void* pHostPointer );
+#endif
 
-        explicit DeviceMemory( VkDeviceSize size )
-            : m_pAllocation( (uint8_t*)malloc( size ) )
-        {
-            if( !m_pAllocation )
-            {
-                throw VK_ERROR_OUT_OF_DEVICE_MEMORY;
-            }
-        }
-
-        ~DeviceMemory()
-        {
-            free( m_pAllocation );
-        }
+#ifdef VK_MOCK_ICD_MEMFD
+        void CreateFd( const VkMemoryAllocateInfo& allocateInfo );
+        void ImportFd( const VkMemoryAllocateInfo& allocateInfo, int fd );
+#endif
     };
 }
 
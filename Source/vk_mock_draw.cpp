@@ -0,0 +1,271 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_draw.h"
+#include "vk_mock_buffer.h"
+#include "vk_mock_icd_helpers.h"
+
+#include <algorithm>
+#include <vector>
+#include <string.h>
+
+namespace vkmock
+{
+    // FIFO caches track the insertion time of each vertex in a table indexed by the vertex,
+    // unless the range of the indices is much larger than the draw.
+    static constexpr uint32_t g_MinInsertionTableSize = 64 * 1024;
+
+    void DrawCounters::RecordDraw( uint64_t vertexCount, uint64_t vertexShaderInvocations ) noexcept
+    {
+        m_DrawCount.fetch_add( 1, std::memory_order_relaxed );
+        m_VertexCount.fetch_add( vertexCount, std::memory_order_relaxed );
+        m_VertexShaderInvocations.fetch_add( vertexShaderInvocations, std::memory_order_relaxed );
+    }
+
+    void DrawCounters::RecordRasterization( uint64_t primitiveCount, uint64_t fragmentShaderInvocations, uint64_t samplesPassed ) noexcept
+    {
+        m_PrimitiveCount.fetch_add( primitiveCount, std::memory_order_relaxed );
+        m_FragmentShaderInvocations.fetch_add( fragmentShaderInvocations, std::memory_order_relaxed );
+        m_SamplesPassed.fetch_add( samplesPassed, std::memory_order_relaxed );
+    }
+
+    void DrawCounters::RecordIndirectCommand( uint64_t drawCount ) noexcept
+    {
+        m_IndirectCommandCount.fetch_add( 1, std::memory_order_relaxed );
+        m_IndirectDrawCount.fetch_add( drawCount, std::memory_order_relaxed );
+    }
+
+    void DrawCounters::RecordDispatch( uint64_t workgroupCount, uint64_t computeShaderInvocations ) noexcept
+    {
+        m_DispatchCount.fetch_add( 1, std::memory_order_relaxed );
+        m_WorkgroupCount.fetch_add( workgroupCount, std::memory_order_relaxed );
+        m_ComputeShaderInvocations.fetch_add( computeShaderInvocations, std::memory_order_relaxed );
+    }
+
+    void DrawCounters::Reset() noexcept
+    {
+        m_DrawCount.store( 0, std::memory_order_relaxed );
+        m_VertexCount.store( 0, std::memory_order_relaxed );
+        m_VertexShaderInvocations.store( 0, std::memory_order_relaxed );
+        m_PrimitiveCount.store( 0, std::memory_order_relaxed );
+        m_FragmentShaderInvocations.store( 0, std::memory_order_relaxed );
+        m_SamplesPassed.store( 0, std::memory_order_relaxed );
+        m_IndirectCommandCount.store( 0, std::memory_order_relaxed );
+        m_IndirectDrawCount.store( 0, std::memory_order_relaxed );
+        m_DispatchCount.store( 0, std::memory_order_relaxed );
+        m_WorkgroupCount.store( 0, std::memory_order_relaxed );
+        m_ComputeShaderInvocations.store( 0, std::memory_order_relaxed );
+    }
+
+    void DrawCounters::GetStatistics( VkMockDrawStatisticsEXT* pStatistics ) const noexcept
+    {
+        pStatistics->drawCount = m_DrawCount.load( std::memory_order_relaxed );
+        pStatistics->vertexCount = m_VertexCount.load( std::memory_order_relaxed );
+        pStatistics->vertexShaderInvocations = m_VertexShaderInvocations.load( std::memory_order_relaxed );
+        pStatistics->primitiveCount = m_PrimitiveCount.load( std::memory_order_relaxed );
+        pStatistics->fragmentShaderInvocations = m_FragmentShaderInvocations.load( std::memory_order_relaxed );
+        pStatistics->samplesPassed = m_SamplesPassed.load( std::memory_order_relaxed );
+        pStatistics->indirectCommandCount = m_IndirectCommandCount.load( std::memory_order_relaxed );
+        pStatistics->indirectDrawCount = m_IndirectDrawCount.load( std::memory_order_relaxed );
+        pStatistics->dispatchCount = m_DispatchCount.load( std::memory_order_relaxed );
+        pStatistics->workgroupCount = m_WorkgroupCount.load( std::memory_order_relaxed );
+        pStatistics->computeShaderInvocations = m_ComputeShaderInvocations.load( std::memory_order_relaxed );
+    }
+
+    uint32_t GetIndirectDrawCount( const IndirectDrawInfo& indirect, bool indexed )
+    {
+        uint32_t drawCount = indirect.m_MaxDrawCount;
+
+        if( indirect.m_CountBuffer )
+        {
+            const VkBuffer countBuffer = indirect.m_CountBuffer;
+            if( !countBuffer->m_pData || indirect.m_CountBufferOffset + sizeof( uint32_t ) > countBuffer->m_Size )
+            {
+                return 0;
+            }
+
+            uint32_t count;
+            memcpy( &count, countBuffer->m_pData + indirect.m_CountBufferOffset, sizeof( count ) );
+            drawCount = std::min( drawCount, count );
+        }
+
+        const VkBuffer buffer = indirect.m_Buffer;
+        const VkDeviceSize commandSize = indexed ? sizeof( VkDrawIndexedIndirectCommand ) : sizeof( VkDrawIndirectCommand );
+        if( !drawCount || !buffer || !buffer->m_pData || indirect.m_Offset + commandSize > buffer->m_Size )
+        {
+            return 0;
+        }
+
+        // Stride may be zero if only a single draw is executed.
+        if( indirect.m_Stride )
+        {
+            const VkDeviceSize availableDrawCount = ( buffer->m_Size - indirect.m_Offset - commandSize ) / indirect.m_Stride + 1;
+            drawCount = static_cast<uint32_t>( std::min<VkDeviceSize>( drawCount, availableDrawCount ) );
+        }
+        else
+        {
+            drawCount = 1;
+        }
+
+        return drawCount;
+    }
+
+    VkDrawIndexedIndirectCommand ReadIndirectDraw( const IndirectDrawInfo& indirect, bool indexed, uint32_t drawIndex )
+    {
+        const uint8_t* pData = indirect.m_Buffer->m_pData + indirect.m_Offset + VkDeviceSize( drawIndex ) * indirect.m_Stride;
+
+        VkDrawIndexedIndirectCommand draw = {};
+        if( indexed )
+        {
+            memcpy( &draw, pData, sizeof( draw ) );
+        }
+        else
+        {
+            VkDrawIndirectCommand command;
+            memcpy( &command, pData, sizeof( command ) );
+
+            draw.indexCount = command.vertexCount;
+            draw.instanceCount = command.instanceCount;
+            draw.firstIndex = command.firstVertex;
+            draw.firstInstance = command.firstInstance;
+        }
+
+        return draw;
+    }
+
+    const uint8_t* GetIndexData( VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType, uint32_t firstIndex, uint32_t* pIndexCount )
+    {
+        const uint32_t indexSize = GetIndexSize( indexType );
+        if( !buffer || !buffer->m_pData || !indexSize || offset >= buffer->m_Size )
+        {
+            *pIndexCount = 0;
+            return nullptr;
+        }
+
+        const VkDeviceSize availableIndexCount = ( buffer->m_Size - offset ) / indexSize;
+        if( firstIndex >= availableIndexCount )
+        {
+            *pIndexCount = 0;
+            return nullptr;
+        }
+
+        *pIndexCount = static_cast<uint32_t>( std::min<VkDeviceSize>( *pIndexCount, availableIndexCount - firstIndex ) );
+        return buffer->m_pData + offset + VkDeviceSize( firstIndex ) * indexSize;
+    }
+
+    // Entries of the cache are scanned linearly, the caches are small.
+    static uint32_t CountCacheMisses( const VkAllocationCallbacks& allocator, const VertexCacheInfo& cache, const uint8_t* pIndices, uint32_t indexSize, uint32_t indexCount )
+    {
+        struct CacheEntry
+        {
+            uint32_t m_Index;
+            uint32_t m_Time;
+        };
+
+        std::vector<CacheEntry, vk_stl_allocator<CacheEntry>> entries( allocator );
+        entries.reserve( cache.m_EntryCount );
+
+        const bool lru = ( cache.m_Type == VK_MOCK_VERTEX_CACHE_LRU_EXT );
+        uint32_t invocations = 0;
+
+        for( uint32_t i = 0; i < indexCount; ++i )
+        {
+            const uint32_t index = ReadIndex( pIndices, indexSize, i );
+
+            auto entry = std::find_if( entries.begin(), entries.end(),
+                [index]( const CacheEntry& entry ) { return entry.m_Index == index; } );
+
+            if( entry != entries.end() )
+            {
+                // LRU caches refresh the entries on hits, FIFO caches keep the insertion time.
+                if( lru )
+                {
+                    entry->m_Time = i;
+                }
+                continue;
+            }
+
+            invocations++;
+
+            if( entries.size() < cache.m_EntryCount )
+            {
+                entries.push_back( { index, i } );
+                continue;
+            }
+
+            auto oldest = std::min_element( entries.begin(), entries.end(),
+                []( const CacheEntry& a, const CacheEntry& b ) { return a.m_Time < b.m_Time; } );
+
+            *oldest = { index, i };
+        }
+
+        return invocations;
+    }
+
+    // Vertex is in the FIFO cache if it was inserted within the last m_EntryCount misses.
+    static uint32_t CountFifoCacheMisses( const VkAllocationCallbacks& allocator, const VertexCacheInfo& cache, const uint8_t* pIndices, uint32_t indexSize, uint32_t indexCount, uint32_t minIndex, uint32_t indexRange )
+    {
+        std::vector<uint32_t, vk_stl_allocator<uint32_t>> insertionTimes( indexRange, 0, allocator );
+        uint32_t invocations = 0;
+
+        for( uint32_t i = 0; i < indexCount; ++i )
+        {
+            uint32_t& insertionTime = insertionTimes[ ReadIndex( pIndices, indexSize, i ) - minIndex ];
+
+            if( insertionTime && invocations - insertionTime < cache.m_EntryCount )
+            {
+                continue;
+            }
+
+            insertionTime = ++invocations;
+        }
+
+        return invocations;
+    }
+
+    uint32_t CountVertexShaderInvocations( const VkAllocationCallbacks& allocator, const VertexCacheInfo& cache, const uint8_t* pIndices, uint32_t indexSize, uint32_t indexCount )
+    {
+        if( cache.m_Type == VK_MOCK_VERTEX_CACHE_NONE_EXT || !cache.m_EntryCount || !indexCount )
+        {
+            return indexCount;
+        }
+
+        if( cache.m_Type == VK_MOCK_VERTEX_CACHE_FIFO_EXT )
+        {
+            uint32_t minIndex = UINT32_MAX;
+            uint32_t maxIndex = 0;
+
+            for( uint32_t i = 0; i < indexCount; ++i )
+            {
+                const uint32_t index = ReadIndex( pIndices, indexSize, i );
+                minIndex = std::min( minIndex, index );
+                maxIndex = std::max( maxIndex, index );
+            }
+
+            const uint64_t indexRange = uint64_t( maxIndex ) - minIndex + 1;
+            if( indexRange <= std::max<uint64_t>( indexCount, g_MinInsertionTableSize ) )
+            {
+                return CountFifoCacheMisses( allocator, cache, pIndices, indexSize, indexCount, minIndex, static_cast<uint32_t>( indexRange ) );
+            }
+        }
+
+        return CountCacheMisses( allocator, cache, pIndices, indexSize, indexCount );
+    }
+}
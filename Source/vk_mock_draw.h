@@ -0,0 +1,144 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "vk_mock.h"
+#include <vulkan/vulkan.h>
+#include <atomic>
+
+namespace vkmock
+{
+    static constexpr uint32_t g_DefaultVertexCacheSize = 32;
+    static constexpr uint32_t g_MaxVertexCacheSize = 1024;
+
+    /**
+     * @brief
+     *   Lock-free counters of the work done by the draws executed on a device.
+     */
+    struct DrawCounters
+    {
+        std::atomic<uint64_t> m_DrawCount;
+        std::atomic<uint64_t> m_VertexCount;
+        std::atomic<uint64_t> m_VertexShaderInvocations;
+        std::atomic<uint64_t> m_PrimitiveCount;
+        std::atomic<uint64_t> m_FragmentShaderInvocations;
+        std::atomic<uint64_t> m_SamplesPassed;
+        std::atomic<uint64_t> m_IndirectCommandCount;
+        std::atomic<uint64_t> m_IndirectDrawCount;
+        std::atomic<uint64_t> m_DispatchCount;
+        std::atomic<uint64_t> m_WorkgroupCount;
+        std::atomic<uint64_t> m_ComputeShaderInvocations;
+
+        void RecordDraw( uint64_t vertexCount, uint64_t vertexShaderInvocations ) noexcept;
+        void RecordRasterization( uint64_t primitiveCount, uint64_t fragmentShaderInvocations, uint64_t samplesPassed ) noexcept;
+        void RecordIndirectCommand( uint64_t drawCount ) noexcept;
+        void RecordDispatch( uint64_t workgroupCount, uint64_t computeShaderInvocations ) noexcept;
+        void Reset() noexcept;
+
+        void GetStatistics( VkMockDrawStatisticsEXT* pStatistics ) const noexcept;
+    };
+
+    /**
+     * @brief
+     *   Post-transform vertex cache simulated by the indexed draws.
+     */
+    struct VertexCacheInfo
+    {
+        VkMockVertexCacheEXT m_Type;
+        uint32_t m_EntryCount;
+    };
+
+    /**
+     * @brief
+     *   Index buffer bound to a command buffer.
+     */
+    struct IndexBufferBinding
+    {
+        VkBuffer m_Buffer;
+        VkDeviceSize m_Offset;
+        VkIndexType m_IndexType;
+    };
+
+    /**
+     * @brief
+     *   Location of the arguments of an indirect draw command.
+     *   Draw count is read from the count buffer, if present, and clamped to maxDrawCount.
+     */
+    struct IndirectDrawInfo
+    {
+        VkBuffer m_Buffer;
+        VkDeviceSize m_Offset;
+        VkBuffer m_CountBuffer;
+        VkDeviceSize m_CountBufferOffset;
+        uint32_t m_MaxDrawCount;
+        uint32_t m_Stride;
+    };
+
+    inline uint32_t GetIndexSize( VkIndexType indexType )
+    {
+        switch( indexType )
+        {
+#ifdef VK_EXT_index_type_uint8
+        case VK_INDEX_TYPE_UINT8_EXT: return 1;
+#endif
+        case VK_INDEX_TYPE_UINT16: return 2;
+        case VK_INDEX_TYPE_UINT32: return 4;
+        default: return 0;
+        }
+    }
+
+    inline uint32_t ReadIndex( const uint8_t* pIndices, uint32_t indexSize, size_t index )
+    {
+        switch( indexSize )
+        {
+        case 1: return pIndices[ index ];
+        case 2: return reinterpret_cast<const uint16_t*>( pIndices )[ index ];
+        default: return reinterpret_cast<const uint32_t*>( pIndices )[ index ];
+        }
+    }
+
+    /**
+     * @brief
+     *   Get the indices of an indexed draw in the bound index buffer.
+     *   The index count is clamped to the indices available in the buffer.
+     */
+    const uint8_t* GetIndexData( VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType, uint32_t firstIndex, uint32_t* pIndexCount );
+
+    /**
+     * @brief
+     *   Get the number of draws of an indirect draw command.
+     *   Draws with arguments outside of the indirect buffer are not executed.
+     */
+    uint32_t GetIndirectDrawCount( const IndirectDrawInfo& indirect, bool indexed );
+
+    /**
+     * @brief
+     *   Read the arguments of a draw from the indirect buffer.
+     *   Arguments of the non-indexed draws are returned with zero vertexOffset.
+     */
+    VkDrawIndexedIndirectCommand ReadIndirectDraw( const IndirectDrawInfo& indirect, bool indexed, uint32_t drawIndex );
+
+    /**
+     * @brief
+     *   Count the vertex shader invocations of a single instance of an indexed draw,
+     *   which are the indices not found in the post-transform vertex cache.
+     */
+    uint32_t CountVertexShaderInvocations( const VkAllocationCallbacks& allocator, const VertexCacheInfo& cache, const uint8_t* pIndices, uint32_t indexSize, uint32_t indexCount );
+}
@@ -0,0 +1,63 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_format.h"
+#include "vk_mock_icd_formats.h"
+
+#include <algorithm>
+#include <iterator>
+#include <string.h>
+
+namespace vkmock
+{
+    const FormatInfo& GetFormatInfo( VkFormat format )
+    {
+        return g_FormatInfos[ GetFormatInfoIndex( format ) ];
+    }
+
+    bool FindFormat( const char* pName, VkFormat* pFormat )
+    {
+        // The generated names are sorted, including the aliases of the formats.
+        const FormatName* pEnd = g_FormatNames + std::size( g_FormatNames );
+        const FormatName* pFormatName = std::lower_bound( g_FormatNames, pEnd, pName,
+            []( const FormatName& formatName, const char* pName ) { return strcmp( formatName.pName, pName ) < 0; } );
+
+        if( pFormatName != pEnd && !strcmp( pFormatName->pName, pName ) )
+        {
+            *pFormat = pFormatName->format;
+            return true;
+        }
+
+        return false;
+    }
+
+    uint32_t GetFormatPlaneIndex( const FormatInfo& formatInfo, VkImageAspectFlags aspectMask )
+    {
+        for( uint32_t i = 0; i < formatInfo.planeCount; ++i )
+        {
+            if( formatInfo.planes[ i ].aspect & aspectMask )
+            {
+                return i;
+            }
+        }
+
+        return 0;
+    }
+}
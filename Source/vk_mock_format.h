@@ -0,0 +1,73 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <vulkan/vulkan.h>
+
+namespace vkmock
+{
+    /**
+     * @brief
+     *   Describes a single memory plane of a format.
+     *   Depth/stencil formats are stored in separate planes for each aspect.
+     */
+    struct FormatPlaneInfo
+    {
+        VkImageAspectFlagBits aspect;
+        uint32_t blockSize;
+        uint32_t widthDivisor;
+        uint32_t heightDivisor;
+    };
+
+    /**
+     * @brief
+     *   Describes the memory layout of a format and the features supported by the mock.
+     *   Formats with the same class index are size-compatible.
+     *   Images of all tilings have the same layout, so they support the same features.
+     */
+    struct FormatInfo
+    {
+        uint32_t blockSize;
+        VkExtent3D blockExtent;
+        VkImageAspectFlags aspectMask;
+        uint32_t planeCount;
+        FormatPlaneInfo planes[ 3 ];
+        uint32_t classIndex;
+        VkFormatFeatureFlags imageFeatures;
+        VkFormatFeatureFlags bufferFeatures;
+    };
+
+    struct FormatName
+    {
+        const char* pName;
+        VkFormat format;
+    };
+
+    /**
+     * @brief
+     *   Returns the entry of the format in the tables generated from vk.xml.
+     *   Unknown formats return the entry of VK_FORMAT_UNDEFINED.
+     */
+    const FormatInfo& GetFormatInfo( VkFormat format );
+
+    bool FindFormat( const char* pName, VkFormat* pFormat );
+
+    uint32_t GetFormatPlaneIndex( const FormatInfo& formatInfo, VkImageAspectFlags aspectMask );
+}
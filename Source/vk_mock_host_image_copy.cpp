@@ -0,0 +1,467 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_host_image_copy.h"
+#include "vk_mock_icd_helpers.h"
+#include "vk_mock_image.h"
+#include "vk_mock_memory_ops.h"
+#include "vk_mock_simd.h"
+#include "vk_mock_thread_pool.h"
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+#ifdef VK_EXT_host_image_copy
+
+namespace vkmock
+{
+    // Rows are distributed between the threads in chunks of about this size.
+    static constexpr size_t g_HostCopyChunkSize = 64 * 1024;
+
+    // Swizzled images are split into tiles of 8x8 texels, stored row by row. Texels of
+    // each tile are stored in Morton order, so that the neighbouring texels in both
+    // directions are close in memory.
+    static constexpr uint32_t g_TileShift = 3;
+    static constexpr uint32_t g_TileSize = 1 << g_TileShift;
+    static constexpr uint32_t g_TileTexelCount = g_TileSize * g_TileSize;
+
+    // Morton index of a texel is made of the interleaved bits of its coordinates in the tile,
+    // x in even bits and y in odd bits.
+    static constexpr uint8_t g_MortonX[ g_TileSize ] = { 0, 1, 4, 5, 16, 17, 20, 21 };
+    static constexpr uint8_t g_MortonY[ g_TileSize ] = { 0, 2, 8, 10, 32, 34, 40, 42 };
+
+    typedef std::vector<uint8_t, vk_stl_allocator<uint8_t>> ByteVector;
+
+    // Slices of texel blocks in the host memory or in the image.
+    // Linear surfaces point to the first block of the region, swizzled surfaces point to the
+    // first slice and keep the block coordinates of the region, which select the tiles.
+    struct HostCopySurface
+    {
+        uint8_t* pData;
+        size_t rowPitch;
+        size_t slicePitch;
+        uint32_t x;
+        uint32_t y;
+        bool swizzled;
+    };
+
+    typedef void ( *PFN_ConvertTile )( uint8_t* pTile, uint8_t* pLinear, size_t linearRowPitch );
+
+    // Copies a full tile between the tile and 8 rows of the linear memory.
+    // Each 2x2 quad of texels is stored contiguously in the tile, so the tile is copied in pairs
+    // of texels from 2 neighbouring rows.
+    template<bool toTiled, uint32_t texelSize>
+    static void ConvertTile( uint8_t* pTile, uint8_t* pLinear, size_t linearRowPitch )
+    {
+        constexpr size_t pairSize = 2 * texelSize;
+
+        for( uint32_t y = 0; y < g_TileSize; y += 2 )
+        {
+            uint8_t* pRow0 = pLinear + y * linearRowPitch;
+            uint8_t* pRow1 = pRow0 + linearRowPitch;
+
+#if defined( VK_MOCK_SSE2 ) || defined( VK_MOCK_NEON )
+            if constexpr( texelSize == 4 )
+            {
+                // 4 texels of each row make 2 quads, which are stored next to each other,
+                // and the quads are interleaved from the rows with 64-bit unpacks.
+                for( uint32_t x = 0; x < g_TileSize; x += 4 )
+                {
+                    uint8_t* pQuads = pTile + ( g_MortonX[ x ] | g_MortonY[ y ] ) * texelSize;
+                    uint8_t* pSrc0 = toTiled ? pRow0 + x * texelSize : pQuads;
+                    uint8_t* pSrc1 = toTiled ? pRow1 + x * texelSize : pQuads + 16;
+                    uint8_t* pDst0 = toTiled ? pQuads : pRow0 + x * texelSize;
+                    uint8_t* pDst1 = toTiled ? pQuads + 16 : pRow1 + x * texelSize;
+#if defined( VK_MOCK_SSE2 )
+                    const __m128i a = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSrc0 ) );
+                    const __m128i b = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSrc1 ) );
+                    _mm_storeu_si128( reinterpret_cast<__m128i*>( pDst0 ), _mm_unpacklo_epi64( a, b ) );
+                    _mm_storeu_si128( reinterpret_cast<__m128i*>( pDst1 ), _mm_unpackhi_epi64( a, b ) );
+#else
+                    const uint64x2_t a = vreinterpretq_u64_u8( vld1q_u8( pSrc0 ) );
+                    const uint64x2_t b = vreinterpretq_u64_u8( vld1q_u8( pSrc1 ) );
+                    vst1q_u8( pDst0, vreinterpretq_u8_u64( vcombine_u64( vget_low_u64( a ), vget_low_u64( b ) ) ) );
+                    vst1q_u8( pDst1, vreinterpretq_u8_u64( vcombine_u64( vget_high_u64( a ), vget_high_u64( b ) ) ) );
+#endif
+                }
+                continue;
+            }
+#endif
+
+            for( uint32_t x = 0; x < g_TileSize; x += 2 )
+            {
+                uint8_t* pQuad = pTile + ( g_MortonX[ x ] | g_MortonY[ y ] ) * texelSize;
+                uint8_t* pPair0 = pRow0 + x * texelSize;
+                uint8_t* pPair1 = pRow1 + x * texelSize;
+
+                if( toTiled )
+                {
+                    memcpy( pQuad, pPair0, pairSize );
+                    memcpy( pQuad + pairSize, pPair1, pairSize );
+                }
+                else
+                {
+                    memcpy( pPair0, pQuad, pairSize );
+                    memcpy( pPair1, pQuad + pairSize, pairSize );
+                }
+            }
+        }
+    }
+
+    template<bool toTiled>
+    static PFN_ConvertTile GetConvertTileFunction( uint32_t texelSize )
+    {
+        switch( texelSize )
+        {
+        case 1:
+            return ConvertTile<toTiled, 1>;
+        case 2:
+            return ConvertTile<toTiled, 2>;
+        case 4:
+            return ConvertTile<toTiled, 4>;
+        case 8:
+            return ConvertTile<toTiled, 8>;
+        case 16:
+            return ConvertTile<toTiled, 16>;
+        case 32:
+            return ConvertTile<toTiled, 32>;
+        default:
+            return nullptr;
+        }
+    }
+
+    // Copies a part of the tile texel by texel, (tileX, tileY) is the first texel in the tile.
+    template<bool toTiled>
+    static void ConvertPartialTile( uint8_t* pTile, uint32_t tileX, uint32_t tileY, uint8_t* pLinear, size_t linearRowPitch, uint32_t width, uint32_t height, uint32_t texelSize )
+    {
+        for( uint32_t y = 0; y < height; ++y )
+        {
+            uint8_t* pRow = pLinear + y * linearRowPitch;
+
+            for( uint32_t x = 0; x < width; ++x )
+            {
+                uint8_t* pTexel = pTile + ( g_MortonX[ tileX + x ] | g_MortonY[ tileY + y ] ) * texelSize;
+
+                if( toTiled )
+                {
+                    memcpy( pTexel, pRow + x * texelSize, texelSize );
+                }
+                else
+                {
+                    memcpy( pRow + x * texelSize, pTexel, texelSize );
+                }
+            }
+        }
+    }
+
+    // Reorders a rectangle of texels between a slice of the swizzled image and the linear memory.
+    // Rows of tiles are converted in parallel.
+    template<bool toTiled>
+    static void ConvertSlice( ThreadPool& threadPool, uint8_t* pTiled, size_t tiledRowPitch, uint32_t x, uint32_t y, uint8_t* pLinear, size_t linearRowPitch, uint32_t width, uint32_t height, uint32_t texelSize )
+    {
+        const PFN_ConvertTile pfnConvertTile = GetConvertTileFunction<toTiled>( texelSize );
+
+        // Tiles of a row cover 8 rows of the linear layout, so the row pitch in the swizzled
+        // layout is the same as in the linear one.
+        const size_t tileSize = size_t( g_TileTexelCount ) * texelSize;
+        const size_t tileRowPitch = tiledRowPitch * g_TileSize;
+
+        const uint32_t firstTileRow = y >> g_TileShift;
+        const uint32_t lastTileRow = ( y + height - 1 ) >> g_TileShift;
+        const uint32_t firstTileColumn = x >> g_TileShift;
+        const uint32_t lastTileColumn = ( x + width - 1 ) >> g_TileShift;
+
+        const size_t tileRowCount = lastTileRow - firstTileRow + 1;
+        const size_t tileRowSize = size_t( width ) * g_TileSize * texelSize;
+        const size_t tileRowsPerChunk = std::max<size_t>( g_HostCopyChunkSize / tileRowSize, 1 );
+        const size_t chunkCount = ( tileRowCount + tileRowsPerChunk - 1 ) / tileRowsPerChunk;
+
+        threadPool.ParallelFor( chunkCount, [&]( size_t chunkIndex ) {
+            const uint32_t firstRow = firstTileRow + uint32_t( chunkIndex * tileRowsPerChunk );
+            const uint32_t lastRow = std::min( firstRow + uint32_t( tileRowsPerChunk ) - 1, lastTileRow );
+
+            for( uint32_t tileRow = firstRow; tileRow <= lastRow; ++tileRow )
+            {
+                const uint32_t y0 = std::max( tileRow << g_TileShift, y );
+                const uint32_t y1 = std::min( ( tileRow + 1 ) << g_TileShift, y + height );
+
+                for( uint32_t tileColumn = firstTileColumn; tileColumn <= lastTileColumn; ++tileColumn )
+                {
+                    const uint32_t x0 = std::max( tileColumn << g_TileShift, x );
+                    const uint32_t x1 = std::min( ( tileColumn + 1 ) << g_TileShift, x + width );
+
+                    uint8_t* pTile = pTiled + tileRow * tileRowPitch + tileColumn * tileSize;
+                    uint8_t* pLinearTexel = pLinear + ( y0 - y ) * linearRowPitch + ( x0 - x ) * texelSize;
+
+                    if( pfnConvertTile && ( x1 - x0 ) == g_TileSize && ( y1 - y0 ) == g_TileSize )
+                    {
+                        pfnConvertTile( pTile, pLinearTexel, linearRowPitch );
+                    }
+                    else
+                    {
+                        ConvertPartialTile<toTiled>( pTile, x0 - ( tileColumn << g_TileShift ), y0 - ( tileRow << g_TileShift ),
+                            pLinearTexel, linearRowPitch, x1 - x0, y1 - y0, texelSize );
+                    }
+                }
+            }
+        } );
+    }
+
+    static void CopyLinearSlices( ThreadPool& threadPool, const HostCopySurface& dst, const HostCopySurface& src, size_t rowSize, uint32_t rowCount, uint32_t sliceCount )
+    {
+        const size_t totalRowCount = size_t( rowCount ) * sliceCount;
+        const size_t rowsPerChunk = std::max<size_t>( g_HostCopyChunkSize / std::max<size_t>( rowSize, 1 ), 1 );
+        const size_t chunkCount = ( totalRowCount + rowsPerChunk - 1 ) / rowsPerChunk;
+
+        threadPool.ParallelFor( chunkCount, [&]( size_t chunkIndex ) {
+            const size_t firstRow = chunkIndex * rowsPerChunk;
+            const size_t lastRow = std::min( firstRow + rowsPerChunk, totalRowCount );
+
+            for( size_t row = firstRow; row < lastRow; ++row )
+            {
+                const size_t slice = row / rowCount;
+                const size_t y = row % rowCount;
+                memcpy(
+                    dst.pData + slice * dst.slicePitch + y * dst.rowPitch,
+                    src.pData + slice * src.slicePitch + y * src.rowPitch,
+                    rowSize );
+            }
+        } );
+    }
+
+    // Copies a box of texel blocks between the surfaces, the extent is in blocks.
+    static void CopySurface( ThreadPool& threadPool, const HostCopySurface& dst, const HostCopySurface& src, const VkExtent3D& extent, uint32_t sliceCount, uint32_t blockSize )
+    {
+        if( !dst.swizzled && !src.swizzled )
+        {
+            return CopyLinearSlices( threadPool, dst, src, size_t( extent.width ) * blockSize, extent.height, sliceCount );
+        }
+
+        // Texels are reordered between two swizzled images through a linear slice.
+        ByteVector scratch( threadPool.m_Allocator );
+        if( dst.swizzled && src.swizzled )
+        {
+            scratch.resize( size_t( extent.width ) * extent.height * blockSize );
+        }
+
+        const size_t scratchRowPitch = size_t( extent.width ) * blockSize;
+
+        for( uint32_t slice = 0; slice < sliceCount; ++slice )
+        {
+            uint8_t* pDst = dst.pData + slice * dst.slicePitch;
+            uint8_t* pSrc = src.pData + slice * src.slicePitch;
+
+            if( !src.swizzled )
+            {
+                ConvertSlice<true>( threadPool, pDst, dst.rowPitch, dst.x, dst.y, pSrc, src.rowPitch, extent.width, extent.height, blockSize );
+            }
+            else if( !dst.swizzled )
+            {
+                ConvertSlice<false>( threadPool, pSrc, src.rowPitch, src.x, src.y, pDst, dst.rowPitch, extent.width, extent.height, blockSize );
+            }
+            else
+            {
+                ConvertSlice<false>( threadPool, pSrc, src.rowPitch, src.x, src.y, scratch.data(), scratchRowPitch, extent.width, extent.height, blockSize );
+                ConvertSlice<true>( threadPool, pDst, dst.rowPitch, dst.x, dst.y, scratch.data(), scratchRowPitch, extent.width, extent.height, blockSize );
+            }
+        }
+    }
+
+    static uint32_t GetLayerCount( VkImage image, const VkImageSubresourceLayers& subresource )
+    {
+        if( subresource.layerCount == VK_REMAINING_ARRAY_LAYERS )
+        {
+            return image->m_ArrayLayers - subresource.baseArrayLayer;
+        }
+
+        return subresource.layerCount;
+    }
+
+    static uint32_t GetSliceCount( VkImage image, const VkImageSubresourceLayers& subresource, const VkExtent3D& extent )
+    {
+        // Depth slices of 3D images are copied like the layers of array images.
+        if( image->m_ImageType == VK_IMAGE_TYPE_3D )
+        {
+            return vk_div_round_up( extent.depth, image->m_FormatInfo.blockExtent.depth );
+        }
+
+        return GetLayerCount( image, subresource );
+    }
+
+    static VkExtent3D GetBlockExtent( VkImage image, const VkExtent3D& extent )
+    {
+        const VkExtent3D& blockExtent = image->m_FormatInfo.blockExtent;
+
+        VkExtent3D blocks;
+        blocks.width = vk_div_round_up( extent.width, blockExtent.width );
+        blocks.height = vk_div_round_up( extent.height, blockExtent.height );
+        blocks.depth = vk_div_round_up( extent.depth, blockExtent.depth );
+        return blocks;
+    }
+
+    static HostCopySurface GetImageSurface( VkImage image, const VkImageSubresourceLayers& subresource, const VkOffset3D& offset, uint32_t* pBlockSize )
+    {
+        const VkImageSubresource imageSubresource = { subresource.aspectMask, subresource.mipLevel, subresource.baseArrayLayer };
+
+        VkSubresourceLayout layout;
+        uint8_t* pData = image->GetSubresourceData( imageSubresource, &layout );
+
+        const FormatInfo& formatInfo = image->m_FormatInfo;
+        const uint32_t planeIndex = image->GetPlaneIndex( subresource.aspectMask );
+        const uint32_t blockSize = formatInfo.planes[ planeIndex ].blockSize * image->m_Samples;
+
+        const uint32_t x = static_cast<uint32_t>( offset.x ) / formatInfo.blockExtent.width;
+        const uint32_t y = static_cast<uint32_t>( offset.y ) / formatInfo.blockExtent.height;
+        const uint32_t z = static_cast<uint32_t>( offset.z ) / formatInfo.blockExtent.depth;
+
+        HostCopySurface surface = {};
+        surface.pData = pData + z * layout.depthPitch;
+        surface.rowPitch = static_cast<size_t>( layout.rowPitch );
+        surface.slicePitch = static_cast<size_t>( ( image->m_ImageType == VK_IMAGE_TYPE_3D ) ? layout.depthPitch : layout.arrayPitch );
+        surface.swizzled = image->m_Swizzled;
+
+        if( surface.swizzled )
+        {
+            surface.x = x;
+            surface.y = y;
+        }
+        else
+        {
+            surface.pData += y * layout.rowPitch + x * blockSize;
+        }
+
+        *pBlockSize = blockSize;
+        return surface;
+    }
+
+    static HostCopySurface GetMemorySurface( VkImage image, const void* pHostPointer, uint32_t memoryRowLength, uint32_t memoryImageHeight, const VkExtent3D& extent, uint32_t blockSize )
+    {
+        const VkExtent3D& blockExtent = image->m_FormatInfo.blockExtent;
+        const uint32_t rowLength = memoryRowLength ? memoryRowLength : extent.width;
+        const uint32_t imageHeight = memoryImageHeight ? memoryImageHeight : extent.height;
+
+        // The host memory is only written by the image to memory copies.
+        HostCopySurface surface = {};
+        surface.pData = const_cast<uint8_t*>( static_cast<const uint8_t*>( pHostPointer ) );
+        surface.rowPitch = size_t( vk_div_round_up( rowLength, blockExtent.width ) ) * blockSize;
+        surface.slicePitch = size_t( vk_div_round_up( imageHeight, blockExtent.height ) ) * surface.rowPitch;
+        return surface;
+    }
+
+    // VK_HOST_IMAGE_COPY_MEMCPY_EXT copies whole subresources in their internal layout,
+    // each layer takes the size reported in VkSubresourceHostMemcpySizeEXT.
+    template<bool toImage>
+    static void CopySubresourceMemory( VkImage image, const VkImageSubresourceLayers& subresource, uint8_t* pMemory )
+    {
+        const uint32_t layerCount = GetLayerCount( image, subresource );
+
+        for( uint32_t layer = 0; layer < layerCount; ++layer )
+        {
+            const VkImageSubresource imageSubresource = { subresource.aspectMask, subresource.mipLevel, subresource.baseArrayLayer + layer };
+
+            VkSubresourceLayout layout;
+            uint8_t* pData = image->GetSubresourceData( imageSubresource, &layout );
+
+            const size_t size = static_cast<size_t>( layout.size );
+            uint8_t* pLayerMemory = pMemory + layer * size;
+
+            if( toImage )
+            {
+                vk_copy_memory( pData, pLayerMemory, size );
+            }
+            else
+            {
+                vk_copy_memory( pLayerMemory, pData, size );
+            }
+        }
+    }
+
+    void CopyMemoryToImageRegion( ThreadPool& threadPool, VkImage image, const VkMemoryToImageCopyEXT& region, VkHostImageCopyFlagsEXT flags )
+    {
+        uint8_t* pMemory = const_cast<uint8_t*>( static_cast<const uint8_t*>( region.pHostPointer ) );
+
+        if( flags & VK_HOST_IMAGE_COPY_MEMCPY_EXT )
+        {
+            return CopySubresourceMemory<true>( image, region.imageSubresource, pMemory );
+        }
+
+        uint32_t blockSize;
+        const HostCopySurface dst = GetImageSurface( image, region.imageSubresource, region.imageOffset, &blockSize );
+        const HostCopySurface src = GetMemorySurface( image, pMemory, region.memoryRowLength, region.memoryImageHeight, region.imageExtent, blockSize );
+
+        CopySurface( threadPool, dst, src,
+            GetBlockExtent( image, region.imageExtent ),
+            GetSliceCount( image, region.imageSubresource, region.imageExtent ),
+            blockSize );
+    }
+
+    void CopyImageToMemoryRegion( ThreadPool& threadPool, VkImage image, const VkImageToMemoryCopyEXT& region, VkHostImageCopyFlagsEXT flags )
+    {
+        if( flags & VK_HOST_IMAGE_COPY_MEMCPY_EXT )
+        {
+            return CopySubresourceMemory<false>( image, region.imageSubresource, static_cast<uint8_t*>( region.pHostPointer ) );
+        }
+
+        uint32_t blockSize;
+        const HostCopySurface src = GetImageSurface( image, region.imageSubresource, region.imageOffset, &blockSize );
+        const HostCopySurface dst = GetMemorySurface( image, region.pHostPointer, region.memoryRowLength, region.memoryImageHeight, region.imageExtent, blockSize );
+
+        CopySurface( threadPool, dst, src,
+            GetBlockExtent( image, region.imageExtent ),
+            GetSliceCount( image, region.imageSubresource, region.imageExtent ),
+            blockSize );
+    }
+
+    void CopyImageToImageRegion( ThreadPool& threadPool, VkImage srcImage, VkImage dstImage, const VkImageCopy2& region, VkHostImageCopyFlagsEXT flags )
+    {
+        if( flags & VK_HOST_IMAGE_COPY_MEMCPY_EXT )
+        {
+            // Both images have the same layout, so the subresources are copied as they are.
+            const uint32_t layerCount = GetLayerCount( srcImage, region.srcSubresource );
+
+            for( uint32_t layer = 0; layer < layerCount; ++layer )
+            {
+                const VkImageSubresource srcSubresource = { region.srcSubresource.aspectMask, region.srcSubresource.mipLevel, region.srcSubresource.baseArrayLayer + layer };
+                const VkImageSubresource dstSubresource = { region.dstSubresource.aspectMask, region.dstSubresource.mipLevel, region.dstSubresource.baseArrayLayer + layer };
+
+                VkSubresourceLayout srcLayout;
+                VkSubresourceLayout dstLayout;
+                const uint8_t* pSrcData = srcImage->GetSubresourceData( srcSubresource, &srcLayout );
+                uint8_t* pDstData = dstImage->GetSubresourceData( dstSubresource, &dstLayout );
+
+                vk_copy_memory( pDstData, pSrcData, static_cast<size_t>( std::min( srcLayout.size, dstLayout.size ) ) );
+            }
+            return;
+        }
+
+        uint32_t srcBlockSize;
+        uint32_t dstBlockSize;
+        const HostCopySurface src = GetImageSurface( srcImage, region.srcSubresource, region.srcOffset, &srcBlockSize );
+        const HostCopySurface dst = GetImageSurface( dstImage, region.dstSubresource, region.dstOffset, &dstBlockSize );
+
+        CopySurface( threadPool, dst, src,
+            GetBlockExtent( srcImage, region.extent ),
+            GetSliceCount( srcImage, region.srcSubresource, region.extent ),
+            srcBlockSize );
+    }
+}
+
+#endif // VK_EXT_host_image_copy
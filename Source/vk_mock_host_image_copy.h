@@ -0,0 +1,48 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <vulkan/vulkan.h>
+
+namespace vkmock
+{
+    struct ThreadPool;
+
+#ifdef VK_EXT_host_image_copy
+    /**
+     * @brief
+     *   Copy a region of the host memory into the image, as specified for vkCopyMemoryToImageEXT.
+     *   Texels of swizzled images are reordered from the linear layout of the host memory.
+     */
+    void CopyMemoryToImageRegion( ThreadPool& threadPool, VkImage image, const VkMemoryToImageCopyEXT& region, VkHostImageCopyFlagsEXT flags );
+
+    /**
+     * @brief
+     *   Copy a region of the image into the host memory, as specified for vkCopyImageToMemoryEXT.
+     */
+    void CopyImageToMemoryRegion( ThreadPool& threadPool, VkImage image, const VkImageToMemoryCopyEXT& region, VkHostImageCopyFlagsEXT flags );
+
+    /**
+     * @brief
+     *   Copy a region between two images on the host, as specified for vkCopyImageToImageEXT.
+     */
+    void CopyImageToImageRegion( ThreadPool& threadPool, VkImage srcImage, VkImage dstImage, const VkImageCopy2& region, VkHostImageCopyFlagsEXT flags );
+#endif
+}
@@ -25,6 +25,9 @@
 #include "vk_mock_physical_device.h"
 #include "vk_mock_command_buffer.h"
 #include "vk_mock_queue.h"
+#include "vk_mock_buffer.h"
+#include "vk_mock_shader_module.h"
+#include "vk_mock_allocation_statistics.h"
 #undef VK_NO_PROTOTYPES
 #include "vk_mock.h"
 
@@ -41,6 +44,21 @@ PFN_vkVoidFunction vk_icdGetInstanceProcAddr(
     if( !strcmp( "vkSetDeviceMockProcAddrEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkSetDeviceMockProcAddrEXT );
     if( !strcmp( "vkAppendMockCommandEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkAppendMockCommandEXT );
     if( !strcmp( "vkExecuteMockCommandBufferEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkExecuteMockCommandBufferEXT );
+    if( !strcmp( "vkResolveMockDeviceAddressEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkResolveMockDeviceAddressEXT );
+    if( !strcmp( "vkGetMockAllocationStatisticsEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkGetMockAllocationStatisticsEXT );
+    if( !strcmp( "vkGetMockObjectStatisticsEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkGetMockObjectStatisticsEXT );
+    if( !strcmp( "vkResetMockAllocationStatisticsEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkResetMockAllocationStatisticsEXT );
+    if( !strcmp( "vkSetMockImageSwizzleEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkSetMockImageSwizzleEXT );
+    if( !strcmp( "vkCreateMockShaderModuleEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkCreateMockShaderModuleEXT );
+    if( !strcmp( "vkSetMockRasterizerEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkSetMockRasterizerEXT );
+    if( !strcmp( "vkCreateMockGraphicsShaderModuleEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkCreateMockGraphicsShaderModuleEXT );
+    if( !strcmp( "vkSetMockVertexCacheEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkSetMockVertexCacheEXT );
+    if( !strcmp( "vkGetMockDrawStatisticsEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkGetMockDrawStatisticsEXT );
+    if( !strcmp( "vkResetMockDrawStatisticsEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkResetMockDrawStatisticsEXT );
+    if( !strcmp( "vkSetMockTimestampClockEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkSetMockTimestampClockEXT );
+    if( !strcmp( "vkSetMockPerformanceCountersEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkSetMockPerformanceCountersEXT );
+    if( !strcmp( "vkSetMockPhysicalDevicesEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkSetMockPhysicalDevicesEXT );
+    if( !strcmp( "vkLoadMockPhysicalDeviceProfileEXT", pName ) ) return reinterpret_cast<PFN_vkVoidFunction>( vkLoadMockPhysicalDeviceProfileEXT );
 #endif // VK_EXT_mock
 
     return vkGetInstanceProcAddr( nullptr, pName );
@@ -105,6 +123,9 @@ VkResult vkEnumerateInstanceExtensionProperties(
 #endif
 #ifdef VK_KHR_get_physical_device_properties2
         { VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_SPEC_VERSION },
+#endif
+#ifdef VK_KHR_device_group_creation
+        { VK_KHR_DEVICE_GROUP_CREATION_EXTENSION_NAME, VK_KHR_DEVICE_GROUP_CREATION_SPEC_VERSION },
 #endif
     };
 
@@ -167,3 +188,140 @@ void vkExecuteMockCommandBufferEXT(
 {
     queue->ExecuteCommandBuffer( commandBuffer );
 }
+
+VkResult vkResolveMockDeviceAddressEXT(
+    VkDevice device,
+    VkDeviceAddress address,
+    VkBuffer* pBuffer,
+    VkDeviceSize* pOffset )
+{
+    VkBuffer buffer = device->m_AddressMap.Find( address );
+    if( !buffer )
+    {
+        return VK_ERROR_INVALID_DEVICE_ADDRESS_EXT;
+    }
+
+    *pBuffer = buffer;
+    *pOffset = address - buffer->GetDeviceAddress();
+    return VK_SUCCESS;
+}
+
+void vkGetMockAllocationStatisticsEXT(
+    VkDevice,
+    VkSystemAllocationScope scope,
+    VkMockAllocationStatisticsEXT* pStatistics )
+{
+    vkmock::g_ScopeAllocationCounters[ scope ].GetStatistics( pStatistics );
+}
+
+void vkGetMockObjectStatisticsEXT(
+    VkDevice,
+    VkObjectType objectType,
+    VkMockAllocationStatisticsEXT* pStatistics )
+{
+    vkmock::g_ObjectTypeAllocationCounters[ vkmock::vk_object_type_index( objectType ) ].GetStatistics( pStatistics );
+}
+
+void vkResetMockAllocationStatisticsEXT(
+    VkDevice )
+{
+    for( vkmock::AllocationCounters& counters : vkmock::g_ScopeAllocationCounters )
+    {
+        counters.Reset();
+    }
+
+    for( vkmock::AllocationCounters& counters : vkmock::g_ObjectTypeAllocationCounters )
+    {
+        counters.Reset();
+    }
+}
+
+void vkSetMockImageSwizzleEXT(
+    VkDevice device,
+    VkMockImageSwizzleEXT swizzle )
+{
+    device->m_ImageSwizzle = swizzle;
+}
+
+VkResult vkCreateMockShaderModuleEXT(
+    VkDevice device,
+    const VkMockComputeKernelCreateInfoEXT* pCreateInfo,
+    const VkAllocationCallbacks* pAllocator,
+    VkShaderModule* pShaderModule )
+{
+    return vkmock::vk_new(
+        pShaderModule,
+        vkmock::vk_allocator( pAllocator, device->m_Allocator ),
+        VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+        *pCreateInfo );
+}
+
+void vkSetMockRasterizerEXT(
+    VkDevice device,
+    VkMockRasterizerEXT rasterizer )
+{
+    device->m_Rasterizer = rasterizer;
+}
+
+VkResult vkCreateMockGraphicsShaderModuleEXT(
+    VkDevice device,
+    const VkMockGraphicsKernelCreateInfoEXT* pCreateInfo,
+    const VkAllocationCallbacks* pAllocator,
+    VkShaderModule* pShaderModule )
+{
+    return vkmock::vk_new(
+        pShaderModule,
+        vkmock::vk_allocator( pAllocator, device->m_Allocator ),
+        VK_SYSTEM_ALLOCATION_SCOPE_OBJECT,
+        *pCreateInfo );
+}
+
+void vkSetMockVertexCacheEXT(
+    VkDevice device,
+    VkMockVertexCacheEXT cache,
+    uint32_t entryCount )
+{
+    device->m_VertexCache.m_Type = cache;
+    device->m_VertexCache.m_EntryCount = std::min( entryCount, vkmock::g_MaxVertexCacheSize );
+}
+
+void vkGetMockDrawStatisticsEXT(
+    VkDevice device,
+    VkMockDrawStatisticsEXT* pStatistics )
+{
+    device->m_DrawCounters.GetStatistics( pStatistics );
+}
+
+void vkResetMockDrawStatisticsEXT(
+    VkDevice device )
+{
+    device->m_DrawCounters.Reset();
+}
+
+VkResult vkSetMockTimestampClockEXT(
+    VkPhysicalDevice physicalDevice,
+    const VkMockTimestampClockInfoEXT* pInfo )
+{
+    return physicalDevice->m_Clock.SetClock( *pInfo );
+}
+
+VkResult vkSetMockPerformanceCountersEXT(
+    VkPhysicalDevice physicalDevice,
+    const VkMockPerformanceCountersInfoEXT* pInfo )
+{
+    return physicalDevice->m_PerformanceCounters.SetCounters( *pInfo );
+}
+
+VkResult vkSetMockPhysicalDevicesEXT(
+    VkInstance instance,
+    const VkMockPhysicalDevicesInfoEXT* pInfo )
+{
+    return instance->SetPhysicalDevices( *pInfo );
+}
+
+VkResult vkLoadMockPhysicalDeviceProfileEXT(
+    VkPhysicalDevice physicalDevice,
+    const VkMockPhysicalDeviceProfileInfoEXT* pInfo )
+{
+    return physicalDevice->m_Profile.Load( *pInfo );
+}
@@ -21,7 +21,10 @@
 #pragma once
 #include <vulkan/vulkan.h>
 #include <vulkan/vk_icd.h>
+#include "vk_mock_allocation_statistics.h"
+#include "vk_mock_slab_cache.h"
 #include <memory>
+#include <utility>
 
 namespace vkmock
 {
@@ -35,22 +38,123 @@ namespace vkmock
         return pAllocator ? *pAllocator : fallbackAllocator;
     }
 
+    inline bool vk_same_allocator( const VkAllocationCallbacks& a, const VkAllocationCallbacks& b ) noexcept
+    {
+        return a.pUserData == b.pUserData &&
+            a.pfnAllocation == b.pfnAllocation &&
+            a.pfnReallocation == b.pfnReallocation &&
+            a.pfnFree == b.pfnFree;
+    }
+
+    inline bool vk_is_default_allocator( const VkAllocationCallbacks& allocator ) noexcept
+    {
+        return allocator.pfnAllocation == g_DefaultAllocator.pfnAllocation &&
+            allocator.pfnFree == g_DefaultAllocator.pfnFree;
+    }
+
+    /**
+     * @brief
+     *   Makes the allocator current for the constructors and destructors of
+     *   the nested objects. The thread_local is only written when it changes.
+     */
+    struct vk_current_allocator_scope
+    {
+        VkAllocationCallbacks m_PreviousAllocator;
+        bool m_Changed;
+
+        explicit vk_current_allocator_scope( const VkAllocationCallbacks& allocator ) noexcept
+            : m_Changed( !vk_same_allocator( g_CurrentAllocator, allocator ) )
+        {
+            if( m_Changed )
+            {
+                m_PreviousAllocator = std::exchange( g_CurrentAllocator, allocator );
+            }
+        }
+
+        ~vk_current_allocator_scope()
+        {
+            if( m_Changed )
+            {
+                g_CurrentAllocator = m_PreviousAllocator;
+            }
+        }
+
+        vk_current_allocator_scope( const vk_current_allocator_scope& ) = delete;
+        vk_current_allocator_scope& operator=( const vk_current_allocator_scope& ) = delete;
+    };
+
+    template<typename T>
+    inline void* vk_allocate_object( const VkAllocationCallbacks& allocator, VkSystemAllocationScope scope )
+    {
+        if constexpr( SlabCache<T>::g_Supported )
+        {
+            // Objects created without application callbacks are recycled
+            // through the per-thread slab caches instead of malloc.
+            if( vk_is_default_allocator( allocator ) )
+            {
+                return vk_slab_cache<T>().Allocate();
+            }
+        }
+
+        return allocator.pfnAllocation(
+            allocator.pUserData,
+            sizeof( T ),
+            alignof( T ),
+            scope );
+    }
+
+    template<typename T>
+    inline void vk_free_object( const VkAllocationCallbacks& allocator, void* pMemory )
+    {
+        if constexpr( SlabCache<T>::g_Supported )
+        {
+            if( vk_is_default_allocator( allocator ) )
+            {
+                return vk_slab_cache<T>().Free( pMemory );
+            }
+        }
+
+        allocator.pfnFree( allocator.pUserData, pMemory );
+    }
+
+    template<typename T>
+    struct vk_object_type { static constexpr VkObjectType value = VK_OBJECT_TYPE_UNKNOWN; };
+
+    template<> struct vk_object_type<VkInstance_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_INSTANCE; };
+    template<> struct vk_object_type<VkPhysicalDevice_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_PHYSICAL_DEVICE; };
+    template<> struct vk_object_type<VkDevice_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_DEVICE; };
+    template<> struct vk_object_type<VkQueue_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_QUEUE; };
+    template<> struct vk_object_type<VkCommandBuffer_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_COMMAND_BUFFER; };
+    template<> struct vk_object_type<VkCommandPool_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_COMMAND_POOL; };
+    template<> struct vk_object_type<VkDeviceMemory_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_DEVICE_MEMORY; };
+    template<> struct vk_object_type<VkBuffer_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_BUFFER; };
+    template<> struct vk_object_type<VkImage_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_IMAGE; };
+    template<> struct vk_object_type<VkImageView_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_IMAGE_VIEW; };
+    template<> struct vk_object_type<VkQueryPool_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_QUERY_POOL; };
+    template<> struct vk_object_type<VkShaderModule_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_SHADER_MODULE; };
+    template<> struct vk_object_type<VkPipelineLayout_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_PIPELINE_LAYOUT; };
+    template<> struct vk_object_type<VkPipeline_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_PIPELINE; };
+    template<> struct vk_object_type<VkDescriptorSetLayout_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT; };
+    template<> struct vk_object_type<VkDescriptorPool_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_DESCRIPTOR_POOL; };
+    template<> struct vk_object_type<VkDescriptorSet_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_DESCRIPTOR_SET; };
+#ifdef VK_KHR_surface
+    template<> struct vk_object_type<VkSurfaceKHR_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_SURFACE_KHR; };
+#endif
+#ifdef VK_KHR_swapchain
+    template<> struct vk_object_type<VkSwapchainKHR_T> { static constexpr VkObjectType value = VK_OBJECT_TYPE_SWAPCHAIN_KHR; };
+#endif
+
     template<typename T, typename... Args>
     inline VkResult vk_new( T** ptr, const VkAllocationCallbacks& allocator, VkSystemAllocationScope scope, Args&&... args ) noexcept
     {
         VkResult result = VK_SUCCESS;
-        VkAllocationCallbacks previousAllocator =
-            std::exchange( g_CurrentAllocator, allocator );
+        vk_current_allocator_scope allocatorScope( allocator );
 
         ( *ptr ) = nullptr;
         try
         {
             // Allocate memory for the new object.
-            ( *ptr ) = static_cast<T*>( allocator.pfnAllocation(
-                allocator.pUserData,
-                sizeof( T ),
-                alignof( T ),
-                scope ) );
+            ( *ptr ) = static_cast<T*>( vk_allocate_object<T>( allocator, scope ) );
 
             if( !( *ptr ) )
             {
@@ -78,22 +182,26 @@ namespace vkmock
         if( result != VK_SUCCESS && ( *ptr ) )
         {
             // Free memory.
-            allocator.pfnFree( allocator.pUserData, *ptr );
+            vk_free_object<T>( allocator, *ptr );
             ( *ptr ) = nullptr;
         }
 
-        g_CurrentAllocator = previousAllocator;
+        if( result == VK_SUCCESS )
+        {
+            vk_record_allocation( scope, vk_object_type<T>::value, sizeof( T ) );
+        }
 
         return result;
     }
 
     template<typename T>
-    inline void vk_delete( T* ptr, const VkAllocationCallbacks& allocator ) noexcept
+    inline void vk_delete( T* ptr, const VkAllocationCallbacks& allocator, VkSystemAllocationScope scope = VK_SYSTEM_ALLOCATION_SCOPE_OBJECT ) noexcept
     {
         if( ptr )
         {
-            VkAllocationCallbacks previousAllocator =
-                std::exchange( g_CurrentAllocator, allocator );
+            vk_record_free( scope, vk_object_type<T>::value, sizeof( T ) );
+
+            vk_current_allocator_scope allocatorScope( allocator );
 
             try
             {
@@ -101,14 +209,36 @@ namespace vkmock
                 ptr->~T();
 
                 // Free memory.
-                allocator.pfnFree( allocator.pUserData, ptr );
+                vk_free_object<T>( allocator, ptr );
             }
             catch( ... )
             {
             }
+        }
+    }
 
-            g_CurrentAllocator = previousAllocator;
+    template<typename T>
+    constexpr T vk_align( T value, T alignment )
+    {
+        return ( value + alignment - 1 ) & ~( alignment - 1 );
+    }
+
+    template<typename T>
+    constexpr T vk_div_round_up( T value, T divisor )
+    {
+        return ( value + divisor - 1 ) / divisor;
+    }
+
+    template<typename T>
+    inline const T* vk_find_struct( const void* pNext, VkStructureType sType )
+    {
+        const VkBaseInStructure* pStruct = static_cast<const VkBaseInStructure*>( pNext );
+        while( pStruct && pStruct->sType != sType )
+        {
+            pStruct = pStruct->pNext;
         }
+
+        return reinterpret_cast<const T*>( pStruct );
     }
 
     inline void vk_check( VkResult result )
@@ -138,16 +268,36 @@ namespace vkmock
 
         T* allocate( size_t n )
         {
-            return static_cast<T*>( m_Allocator.pfnAllocation(
+            T* p = static_cast<T*>( m_Allocator.pfnAllocation(
                 m_Allocator.pUserData,
                 n * sizeof( T ),
                 alignof( T ),
                 VK_SYSTEM_ALLOCATION_SCOPE_OBJECT ) );
+
+            if( p )
+            {
+                vk_record_allocation( VK_SYSTEM_ALLOCATION_SCOPE_OBJECT, VK_OBJECT_TYPE_UNKNOWN, n * sizeof( T ) );
+            }
+
+            return p;
         }
 
-        void deallocate( T* p, size_t )
+        void deallocate( T* p, size_t n )
         {
+            vk_record_free( VK_SYSTEM_ALLOCATION_SCOPE_OBJECT, VK_OBJECT_TYPE_UNKNOWN, n * sizeof( T ) );
             m_Allocator.pfnFree( m_Allocator.pUserData, p );
         }
+
+        template<typename U>
+        bool operator==( const vk_stl_allocator<U>& other ) const
+        {
+            return vk_same_allocator( m_Allocator, other.m_Allocator );
+        }
+
+        template<typename U>
+        bool operator!=( const vk_stl_allocator<U>& other ) const
+        {
+            return !( *this == other );
+        }
     };
 }
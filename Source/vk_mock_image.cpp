@@ -0,0 +1,213 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_image.h"
+#include "vk_mock_icd_helpers.h"
+
+#include <algorithm>
+
+namespace vkmock
+{
+    // Rows of all images are aligned to 256 bytes, which matches the pitch
+    // alignment required by most of the desktop hardware.
+    static constexpr VkDeviceSize g_RowPitchAlignment = 256;
+
+    // Optimally tiled images are padded to full tiles of 8 rows of texel blocks.
+    static constexpr uint32_t g_OptimalTileHeight = 8;
+
+    // Each mip level and plane starts at a 256-byte boundary.
+    static constexpr VkDeviceSize g_SubresourceAlignment = 256;
+
+    static constexpr VkDeviceSize g_SmallImageAlignment = 4 * 1024;
+    static constexpr VkDeviceSize g_LargeImageAlignment = 64 * 1024;
+
+    static VkSubresourceLayout GetMipLevelLayout( const Image& image, uint32_t planeIndex, uint32_t mipLevel )
+    {
+        const FormatPlaneInfo& plane = image.m_FormatInfo.planes[ planeIndex ];
+        const VkExtent3D& blockExtent = image.m_FormatInfo.blockExtent;
+        const VkExtent3D extent = image.GetMipLevelExtent( planeIndex, mipLevel );
+
+        const VkDeviceSize blocksX = ( extent.width + blockExtent.width - 1 ) / blockExtent.width;
+        VkDeviceSize blocksY = ( extent.height + blockExtent.height - 1 ) / blockExtent.height;
+        const VkDeviceSize blocksZ = ( extent.depth + blockExtent.depth - 1 ) / blockExtent.depth;
+
+        if( image.m_Tiling == VK_IMAGE_TILING_OPTIMAL && image.m_ImageType != VK_IMAGE_TYPE_1D )
+        {
+            blocksY = vk_align<VkDeviceSize>( blocksY, g_OptimalTileHeight );
+        }
+
+        // Samples of each texel are stored next to each other.
+        const VkDeviceSize texelSize = plane.blockSize * image.m_Samples;
+
+        VkSubresourceLayout layout = {};
+        layout.rowPitch = vk_align( blocksX * texelSize, g_RowPitchAlignment );
+        layout.depthPitch = layout.rowPitch * blocksY;
+        layout.size = vk_align( layout.depthPitch * blocksZ, g_SubresourceAlignment );
+        return layout;
+    }
+
+    Image::Image( const VkImageCreateInfo& createInfo )
+        : m_pData( nullptr )
+        , m_ImageType( createInfo.imageType )
+        , m_Format( createInfo.format )
+        , m_Extent( createInfo.extent )
+        , m_MipLevels( std::max( createInfo.mipLevels, 1U ) )
+        , m_ArrayLayers( std::max( createInfo.arrayLayers, 1U ) )
+        , m_Samples( createInfo.samples ? createInfo.samples : VK_SAMPLE_COUNT_1_BIT )
+        , m_Tiling( createInfo.tiling )
+        , m_Flags( createInfo.flags )
+        , m_Usage( createInfo.usage )
+        , m_Swizzled( false )
+        , m_PeerMemoryMask( 0 )
+        , m_FormatInfo( GetFormatInfo( createInfo.format ) )
+        , m_Planes()
+        , m_Size( 0 )
+        , m_Alignment( 0 )
+    {
+        const bool disjoint = ( m_Flags & VK_IMAGE_CREATE_DISJOINT_BIT ) != 0;
+
+        for( uint32_t planeIndex = 0; planeIndex < m_FormatInfo.planeCount; ++planeIndex )
+        {
+            ImagePlane& plane = m_Planes[ planeIndex ];
+
+            for( uint32_t mipLevel = 0; mipLevel < m_MipLevels; ++mipLevel )
+            {
+                plane.m_ArrayPitch += GetMipLevelLayout( *this, planeIndex, mipLevel ).size;
+            }
+
+            plane.m_Size = plane.m_ArrayPitch * m_ArrayLayers;
+            plane.m_Offset = disjoint ? 0 : m_Size;
+
+            m_Size += vk_align( plane.m_Size, g_SubresourceAlignment );
+        }
+
+        if( m_Tiling == VK_IMAGE_TILING_LINEAR )
+        {
+            m_Alignment = g_SmallImageAlignment;
+        }
+        else if( m_Samples > VK_SAMPLE_COUNT_1_BIT || m_Size >= g_LargeImageAlignment )
+        {
+            m_Alignment = g_LargeImageAlignment;
+        }
+        else
+        {
+            m_Alignment = g_SmallImageAlignment;
+        }
+    }
+
+    bool Image::SupportsSwizzle() const
+    {
+        if( m_Tiling != VK_IMAGE_TILING_OPTIMAL ||
+            m_ImageType == VK_IMAGE_TYPE_1D ||
+            m_Samples != VK_SAMPLE_COUNT_1_BIT ||
+            m_FormatInfo.blockExtent.width != 1 ||
+            m_FormatInfo.blockExtent.height != 1 )
+        {
+            return false;
+        }
+
+        // Swizzled tiles of 8x8 texels match the padding of the rows of optimally tiled images,
+        // and the aligned row pitch must hold whole tiles, so that both layouts have the same size.
+        for( uint32_t planeIndex = 0; planeIndex < m_FormatInfo.planeCount; ++planeIndex )
+        {
+            const VkDeviceSize tileRowSize = VkDeviceSize( g_OptimalTileHeight ) * m_FormatInfo.planes[ planeIndex ].blockSize;
+            if( g_RowPitchAlignment % tileRowSize )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    uint32_t Image::GetPlaneIndex( VkImageAspectFlags aspectMask ) const
+    {
+        return GetFormatPlaneIndex( m_FormatInfo, aspectMask );
+    }
+
+    VkExtent3D Image::GetMipLevelExtent( uint32_t planeIndex, uint32_t mipLevel ) const
+    {
+        const FormatPlaneInfo& plane = m_FormatInfo.planes[ planeIndex ];
+
+        VkExtent3D extent;
+        extent.width = ( m_Extent.width + plane.widthDivisor - 1 ) / plane.widthDivisor;
+        extent.height = ( m_Extent.height + plane.heightDivisor - 1 ) / plane.heightDivisor;
+        extent.depth = m_Extent.depth;
+
+        extent.width = std::max( extent.width >> mipLevel, 1U );
+        extent.height = std::max( extent.height >> mipLevel, 1U );
+        extent.depth = std::max( extent.depth >> mipLevel, 1U );
+        return extent;
+    }
+
+    void Image::GetSubresourceLayout( const VkImageSubresource& subresource, VkSubresourceLayout* pLayout ) const
+    {
+        const uint32_t planeIndex = GetPlaneIndex( subresource.aspectMask );
+        const ImagePlane& plane = m_Planes[ planeIndex ];
+
+        VkDeviceSize offset = plane.m_Offset + subresource.arrayLayer * plane.m_ArrayPitch;
+        for( uint32_t mipLevel = 0; mipLevel < subresource.mipLevel; ++mipLevel )
+        {
+            offset += GetMipLevelLayout( *this, planeIndex, mipLevel ).size;
+        }
+
+        *pLayout = GetMipLevelLayout( *this, planeIndex, subresource.mipLevel );
+        pLayout->offset = offset;
+        pLayout->arrayPitch = plane.m_ArrayPitch;
+    }
+
+    uint8_t* Image::GetSubresourceData( const VkImageSubresource& subresource, VkSubresourceLayout* pLayout ) const
+    {
+        GetSubresourceLayout( subresource, pLayout );
+
+        // Planes of disjoint images may be bound to different memory objects,
+        // so the offset is relative to the plane, not the image.
+        const ImagePlane& plane = m_Planes[ GetPlaneIndex( subresource.aspectMask ) ];
+        return plane.m_pData + ( pLayout->offset - plane.m_Offset );
+    }
+
+    void Image::GetMemoryRequirements( VkImageAspectFlags planeAspect, VkMemoryRequirements* pMemoryRequirements ) const
+    {
+        pMemoryRequirements->size = m_Size;
+        pMemoryRequirements->alignment = m_Alignment;
+        pMemoryRequirements->memoryTypeBits = 1;
+
+        if( ( m_Flags & VK_IMAGE_CREATE_DISJOINT_BIT ) && planeAspect )
+        {
+            pMemoryRequirements->size = m_Planes[ GetPlaneIndex( planeAspect ) ].m_Size;
+        }
+    }
+
+    void Image::BindMemory( VkImageAspectFlags planeAspect, uint8_t* pData )
+    {
+        if( ( m_Flags & VK_IMAGE_CREATE_DISJOINT_BIT ) && planeAspect )
+        {
+            m_Planes[ GetPlaneIndex( planeAspect ) ].m_pData = pData;
+            return;
+        }
+
+        m_pData = pData;
+
+        for( uint32_t planeIndex = 0; planeIndex < m_FormatInfo.planeCount; ++planeIndex )
+        {
+            m_Planes[ planeIndex ].m_pData = pData + m_Planes[ planeIndex ].m_Offset;
+        }
+    }
+}
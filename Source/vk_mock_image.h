@@ -20,19 +20,47 @@
 
 #pragma once
 #include "vk_mock_icd_base.h"
+#include "vk_mock_format.h"
 
 namespace vkmock
 {
+    struct ImagePlane
+    {
+        uint8_t* m_pData;
+        VkDeviceSize m_Offset;
+        VkDeviceSize m_Size;
+        VkDeviceSize m_ArrayPitch;
+    };
+
     struct Image
     {
         uint8_t* m_pData;
+        VkImageType m_ImageType;
+        VkFormat m_Format;
         VkExtent3D m_Extent;
+        uint32_t m_MipLevels;
+        uint32_t m_ArrayLayers;
+        VkSampleCountFlagBits m_Samples;
+        VkImageTiling m_Tiling;
+        VkImageCreateFlags m_Flags;
+        VkImageUsageFlags m_Usage;
+        bool m_Swizzled;
+        uint32_t m_PeerMemoryMask;
+
+        const FormatInfo& m_FormatInfo;
+        ImagePlane m_Planes[ 3 ];
+        VkDeviceSize m_Size;
+        VkDeviceSize m_Alignment;
+
+        explicit Image( const VkImageCreateInfo& createInfo );
 
-        explicit Image( const VkImageCreateInfo& createInfo )
-            : m_pData( nullptr )
-            , m_Extent( createInfo.extent )
-        {
-        }
+        bool SupportsSwizzle() const;
+        uint32_t GetPlaneIndex( VkImageAspectFlags aspectMask ) const;
+        VkExtent3D GetMipLevelExtent( uint32_t planeIndex, uint32_t mipLevel ) const;
+        void GetSubresourceLayout( const VkImageSubresource& subresource, VkSubresourceLayout* pLayout ) const;
+        uint8_t* GetSubresourceData( const VkImageSubresource& subresource, VkSubresourceLayout* pLayout ) const;
+        void GetMemoryRequirements( VkImageAspectFlags planeAspect, VkMemoryRequirements* pMemoryRequirements ) const;
+        void BindMemory( VkImageAspectFlags planeAspect, uint8_t* pData );
     };
 }
 
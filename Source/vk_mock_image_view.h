@@ -0,0 +1,47 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "vk_mock_icd_base.h"
+#include "vk_mock_image.h"
+
+namespace vkmock
+{
+    struct ImageView
+    {
+        VkImage m_Image;
+        VkImageViewType m_ViewType;
+        VkFormat m_Format;
+        VkImageSubresourceRange m_SubresourceRange;
+
+        explicit ImageView( const VkImageViewCreateInfo& createInfo )
+            : m_Image( createInfo.image )
+            , m_ViewType( createInfo.viewType )
+            , m_Format( createInfo.format ? createInfo.format : createInfo.image->m_Format )
+            , m_SubresourceRange( createInfo.subresourceRange )
+        {
+        }
+    };
+}
+
+struct VkImageView_T : vkmock::ImageView
+{
+    using ImageView::ImageView;
+};
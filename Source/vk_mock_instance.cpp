@@ -23,56 +23,146 @@
 #include "vk_mock_surface.h"
 #include "vk_mock_icd_helpers.h"
 
+#include <stdlib.h>
+
 namespace vkmock
 {
+    static const VkMockPhysicalDeviceInfoEXT g_DefaultPhysicalDeviceInfo = {
+        nullptr,
+        0,
+        0,
+        VK_PHYSICAL_DEVICE_TYPE_OTHER,
+        0,
+        0,
+        0,
+    };
+
     Instance::Instance( const VkInstanceCreateInfo& createInfo )
         : m_Allocator( g_CurrentAllocator )
-        , m_PhysicalDevice( nullptr )
+        , m_PhysicalDevices( m_Allocator )
     {
-        try
-        {
-            vk_check( vk_new(
-                &m_PhysicalDevice,
-                m_Allocator,
-                VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE,
-                GetApiHandle() ) );
-        }
-        catch( ... )
+        VkMockPhysicalDevicesInfoEXT physicalDevicesInfo = {};
+        physicalDevicesInfo.physicalDeviceCount = 1;
+        physicalDevicesInfo.pPhysicalDevices = &g_DefaultPhysicalDeviceInfo;
+
+        vk_check( SetPhysicalDevices( physicalDevicesInfo ) );
+
+        // Profiles of the default physical device can be selected without modifying the application.
+        VkMockPhysicalDeviceProfileInfoEXT profileInfo = {};
+        profileInfo.pFileName = getenv( "VK_MOCK_ICD_PROFILE_FILE" );
+        profileInfo.pProfileName = getenv( "VK_MOCK_ICD_PROFILE_NAME" );
+        profileInfo.pCacheFileName = getenv( "VK_MOCK_ICD_PROFILE_CACHE_FILE" );
+
+        if( profileInfo.pFileName )
         {
-            Instance::~Instance();
-            throw;
+            vk_check( m_PhysicalDevices.front()->m_Profile.Load( profileInfo ) );
         }
     }
 
     Instance::~Instance()
     {
-        vk_delete( m_PhysicalDevice, g_CurrentAllocator );
+        DestroyPhysicalDevices( m_PhysicalDevices );
     }
 
     void Instance::vkDestroyInstance( const VkAllocationCallbacks* pAllocator )
     {
-        vk_delete( this,
-            vk_allocator( pAllocator, m_Allocator ) );
+        vk_delete( GetApiHandle(),
+            vk_allocator( pAllocator, m_Allocator ),
+            VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE );
     }
 
     VkResult Instance::vkEnumeratePhysicalDevices( uint32_t* pPhysicalDeviceCount, VkPhysicalDevice* pPhysicalDevices )
     {
+        const uint32_t physicalDeviceCount = static_cast<uint32_t>( m_PhysicalDevices.size() );
+
         if( pPhysicalDevices == nullptr )
         {
-            *pPhysicalDeviceCount = 1;
+            *pPhysicalDeviceCount = physicalDeviceCount;
             return VK_SUCCESS;
         }
 
-        if( *pPhysicalDeviceCount < 1 )
+        const uint32_t count = std::min( *pPhysicalDeviceCount, physicalDeviceCount );
+        for( uint32_t i = 0; i < count; ++i )
+        {
+            pPhysicalDevices[ i ] = m_PhysicalDevices[ i ];
+        }
+
+        *pPhysicalDeviceCount = count;
+
+        if( count < physicalDeviceCount )
         {
             return VK_INCOMPLETE;
         }
 
-        *pPhysicalDevices = m_PhysicalDevice;
+        return VK_SUCCESS;
+    }
+
+    VkResult Instance::vkEnumeratePhysicalDeviceGroups( uint32_t* pPhysicalDeviceGroupCount, VkPhysicalDeviceGroupProperties* pPhysicalDeviceGroupProperties )
+    {
+        const uint32_t physicalDeviceCount = static_cast<uint32_t>( m_PhysicalDevices.size() );
+
+        // Groups are enumerated in the order of their first physical devices.
+        uint32_t groupCount = 0;
+        uint32_t writtenGroupCount = 0;
+
+        for( uint32_t i = 0; i < physicalDeviceCount; ++i )
+        {
+            const uint32_t groupIndex = m_PhysicalDevices[ i ]->m_GroupIndex;
+
+            bool firstInGroup = true;
+            for( uint32_t j = 0; j < i && firstInGroup; ++j )
+            {
+                firstInGroup = ( m_PhysicalDevices[ j ]->m_GroupIndex != groupIndex );
+            }
+
+            if( !firstInGroup )
+            {
+                continue;
+            }
+
+            if( pPhysicalDeviceGroupProperties && groupCount < *pPhysicalDeviceGroupCount )
+            {
+                VkPhysicalDeviceGroupProperties& group = pPhysicalDeviceGroupProperties[ groupCount ];
+                group.physicalDeviceCount = 0;
+                group.subsetAllocation = VK_TRUE;
+
+                for( uint32_t j = i; j < physicalDeviceCount; ++j )
+                {
+                    if( m_PhysicalDevices[ j ]->m_GroupIndex == groupIndex )
+                    {
+                        group.physicalDevices[ group.physicalDeviceCount++ ] = m_PhysicalDevices[ j ];
+                    }
+                }
+
+                writtenGroupCount++;
+            }
+
+            groupCount++;
+        }
+
+        if( !pPhysicalDeviceGroupProperties )
+        {
+            *pPhysicalDeviceGroupCount = groupCount;
+            return VK_SUCCESS;
+        }
+
+        *pPhysicalDeviceGroupCount = writtenGroupCount;
+
+        if( writtenGroupCount < groupCount )
+        {
+            return VK_INCOMPLETE;
+        }
 
         return VK_SUCCESS;
     }
 
+#ifdef VK_KHR_device_group_creation
+    VkResult Instance::vkEnumeratePhysicalDeviceGroupsKHR( uint32_t* pPhysicalDeviceGroupCount, VkPhysicalDeviceGroupProperties* pPhysicalDeviceGroupProperties )
+    {
+        return vkEnumeratePhysicalDeviceGroups( pPhysicalDeviceGroupCount, pPhysicalDeviceGroupProperties );
+    }
+#endif
+
 #ifdef VK_KHR_win32_surface
     VkResult Instance::vkCreateWin32SurfaceKHR( const VkWin32SurfaceCreateInfoKHR* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkSurfaceKHR* pSurface )
     {
@@ -130,4 +220,62 @@ namespace vkmock
             vk_allocator( pAllocator, m_Allocator ) );
     }
 #endif
+
+    VkResult Instance::SetPhysicalDevices( const VkMockPhysicalDevicesInfoEXT& info )
+    {
+        if( info.physicalDeviceCount == 0 )
+        {
+            return VK_ERROR_INITIALIZATION_FAILED;
+        }
+
+        if( info.physicalDeviceCount > VK_MOCK_MAX_PHYSICAL_DEVICES_EXT )
+        {
+            return VK_ERROR_TOO_MANY_OBJECTS;
+        }
+
+        PhysicalDeviceVector physicalDevices( info.physicalDeviceCount, nullptr, m_Allocator );
+
+        for( uint32_t i = 0; i < info.physicalDeviceCount; ++i )
+        {
+            VkResult result = vk_new(
+                &physicalDevices[ i ],
+                m_Allocator,
+                VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE,
+                GetApiHandle(),
+                i,
+                info.pPhysicalDevices[ i ],
+                info.peerMemoryBandwidth );
+
+            if( result != VK_SUCCESS )
+            {
+                DestroyPhysicalDevices( physicalDevices );
+                return result;
+            }
+        }
+
+        m_PhysicalDevices.swap( physicalDevices );
+        DestroyPhysicalDevices( physicalDevices );
+        return VK_SUCCESS;
+    }
+
+    uint32_t Instance::GetPhysicalDeviceGroupSize( uint32_t groupIndex ) const
+    {
+        uint32_t count = 0;
+        for( VkPhysicalDevice physicalDevice : m_PhysicalDevices )
+        {
+            count += ( physicalDevice->m_GroupIndex == groupIndex );
+        }
+
+        return count;
+    }
+
+    void Instance::DestroyPhysicalDevices( PhysicalDeviceVector& physicalDevices )
+    {
+        for( VkPhysicalDevice physicalDevice : physicalDevices )
+        {
+            vk_delete( physicalDevice, m_Allocator, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE );
+        }
+
+        physicalDevices.clear();
+    }
 }
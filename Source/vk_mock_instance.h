@@ -19,14 +19,20 @@
 // SOFTWARE.
 
 #pragma once
+#include "vk_mock.h"
 #include "vk_mock_icd_base.h"
+#include "vk_mock_icd_helpers.h"
+#include <vector>
 
 namespace vkmock
 {
     struct Instance : InstanceBase
     {
+        typedef std::vector<VkPhysicalDevice, vk_stl_allocator<VkPhysicalDevice>>
+            PhysicalDeviceVector;
+
         VkAllocationCallbacks m_Allocator;
-        VkPhysicalDevice m_PhysicalDevice;
+        PhysicalDeviceVector m_PhysicalDevices;
 
         Instance( const VkInstanceCreateInfo& createInfo );
         ~Instance();
@@ -34,6 +40,11 @@ namespace vkmock
         void vkDestroyInstance( const VkAllocationCallbacks* pAllocator );
 
         VkResult vkEnumeratePhysicalDevices( uint32_t* pPhysicalDeviceCount, VkPhysicalDevice* pPhysicalDevices );
+        VkResult vkEnumeratePhysicalDeviceGroups( uint32_t* pPhysicalDeviceGroupCount, VkPhysicalDeviceGroupProperties* pPhysicalDeviceGroupProperties );
+
+#ifdef VK_KHR_device_group_creation
+        VkResult vkEnumeratePhysicalDeviceGroupsKHR( uint32_t* pPhysicalDeviceGroupCount, VkPhysicalDeviceGroupProperties* pPhysicalDeviceGroupProperties );
+#endif
 
 #ifdef VK_KHR_win32_surface
         VkResult vkCreateWin32SurfaceKHR( const VkWin32SurfaceCreateInfoKHR* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkSurfaceKHR* pSurface );
@@ -58,6 +69,18 @@ namespace vkmock
 #ifdef VK_KHR_surface
         void vkDestroySurfaceKHR( VkSurfaceKHR surface, const VkAllocationCallbacks* pAllocator );
 #endif
+
+        /**
+         * @brief
+         *   Replace the physical devices of the instance. The new physical devices are created
+         *   before the old ones are destroyed, so the instance is left unchanged on failure.
+         */
+        VkResult SetPhysicalDevices( const VkMockPhysicalDevicesInfoEXT& info );
+
+        uint32_t GetPhysicalDeviceGroupSize( uint32_t groupIndex ) const;
+
+    private:
+        void DestroyPhysicalDevices( PhysicalDeviceVector& physicalDevices );
     };
 }
 
@@ -0,0 +1,358 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_json.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace vkmock
+{
+    // Nesting depth of the documents, deep enough for any device profile.
+    static constexpr uint32_t g_MaxJsonDepth = 64;
+
+    struct JsonParser
+    {
+        const char* m_pCurrent;
+        const char* m_pEnd;
+
+        void SkipWhitespace()
+        {
+            while( m_pCurrent < m_pEnd &&
+                ( *m_pCurrent == ' ' || *m_pCurrent == '\t' || *m_pCurrent == '\n' || *m_pCurrent == '\r' ) )
+            {
+                m_pCurrent++;
+            }
+        }
+
+        bool Consume( char c )
+        {
+            SkipWhitespace();
+
+            if( m_pCurrent < m_pEnd && *m_pCurrent == c )
+            {
+                m_pCurrent++;
+                return true;
+            }
+
+            return false;
+        }
+
+        bool ConsumeLiteral( const char* pLiteral )
+        {
+            const size_t length = strlen( pLiteral );
+
+            if( size_t( m_pEnd - m_pCurrent ) >= length && !memcmp( m_pCurrent, pLiteral, length ) )
+            {
+                m_pCurrent += length;
+                return true;
+            }
+
+            return false;
+        }
+
+        static void AppendUtf8( JsonValue::String& string, uint32_t codePoint )
+        {
+            if( codePoint < 0x80 )
+            {
+                string.push_back( char( codePoint ) );
+            }
+            else if( codePoint < 0x800 )
+            {
+                string.push_back( char( 0xC0 | ( codePoint >> 6 ) ) );
+                string.push_back( char( 0x80 | ( codePoint & 0x3F ) ) );
+            }
+            else if( codePoint < 0x10000 )
+            {
+                string.push_back( char( 0xE0 | ( codePoint >> 12 ) ) );
+                string.push_back( char( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) ) );
+                string.push_back( char( 0x80 | ( codePoint & 0x3F ) ) );
+            }
+            else
+            {
+                string.push_back( char( 0xF0 | ( codePoint >> 18 ) ) );
+                string.push_back( char( 0x80 | ( ( codePoint >> 12 ) & 0x3F ) ) );
+                string.push_back( char( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) ) );
+                string.push_back( char( 0x80 | ( codePoint & 0x3F ) ) );
+            }
+        }
+
+        bool ParseHex4( uint32_t* pValue )
+        {
+            if( m_pEnd - m_pCurrent < 4 )
+            {
+                return false;
+            }
+
+            uint32_t value = 0;
+            for( uint32_t i = 0; i < 4; ++i )
+            {
+                const char c = *m_pCurrent++;
+                value <<= 4;
+
+                if( c >= '0' && c <= '9' ) value |= uint32_t( c - '0' );
+                else if( c >= 'a' && c <= 'f' ) value |= uint32_t( c - 'a' + 10 );
+                else if( c >= 'A' && c <= 'F' ) value |= uint32_t( c - 'A' + 10 );
+                else return false;
+            }
+
+            *pValue = value;
+            return true;
+        }
+
+        bool ParseString( JsonValue::String& string )
+        {
+            if( !Consume( '"' ) )
+            {
+                return false;
+            }
+
+            while( m_pCurrent < m_pEnd )
+            {
+                const char c = *m_pCurrent++;
+
+                if( c == '"' )
+                {
+                    return true;
+                }
+
+                if( c != '\\' )
+                {
+                    string.push_back( c );
+                    continue;
+                }
+
+                if( m_pCurrent == m_pEnd )
+                {
+                    return false;
+                }
+
+                switch( *m_pCurrent++ )
+                {
+                case '"': string.push_back( '"' ); break;
+                case '\\': string.push_back( '\\' ); break;
+                case '/': string.push_back( '/' ); break;
+                case 'b': string.push_back( '\b' ); break;
+                case 'f': string.push_back( '\f' ); break;
+                case 'n': string.push_back( '\n' ); break;
+                case 'r': string.push_back( '\r' ); break;
+                case 't': string.push_back( '\t' ); break;
+                case 'u':
+                {
+                    uint32_t codePoint;
+                    if( !ParseHex4( &codePoint ) )
+                    {
+                        return false;
+                    }
+
+                    // Characters outside of the BMP are encoded as surrogate pairs.
+                    if( codePoint >= 0xD800 && codePoint < 0xDC00 )
+                    {
+                        uint32_t lowSurrogate;
+                        if( !ConsumeLiteral( "\\u" ) || !ParseHex4( &lowSurrogate ) ||
+                            lowSurrogate < 0xDC00 || lowSurrogate >= 0xE000 )
+                        {
+                            return false;
+                        }
+
+                        codePoint = 0x10000 + ( ( codePoint - 0xD800 ) << 10 ) + ( lowSurrogate - 0xDC00 );
+                    }
+
+                    AppendUtf8( string, codePoint );
+                    break;
+                }
+                default:
+                    return false;
+                }
+            }
+
+            return false;
+        }
+
+        bool ParseNumber( JsonValue::String& literal )
+        {
+            const char* pBegin = m_pCurrent;
+
+            if( m_pCurrent < m_pEnd && *m_pCurrent == '-' ) m_pCurrent++;
+            while( m_pCurrent < m_pEnd && strchr( "0123456789.eE+-", *m_pCurrent ) ) m_pCurrent++;
+
+            literal.assign( pBegin, m_pCurrent );
+            return m_pCurrent > pBegin;
+        }
+
+        bool ParseValue( JsonValue& value, uint32_t depth )
+        {
+            SkipWhitespace();
+
+            if( m_pCurrent == m_pEnd || depth > g_MaxJsonDepth )
+            {
+                return false;
+            }
+
+            switch( *m_pCurrent )
+            {
+            case '{':
+            {
+                m_pCurrent++;
+                value.m_Type = JsonType::eObject;
+
+                if( Consume( '}' ) )
+                {
+                    return true;
+                }
+
+                do
+                {
+                    value.m_Object.emplace_back();
+
+                    auto& member = value.m_Object.back();
+                    if( !ParseString( member.first ) || !Consume( ':' ) || !ParseValue( member.second, depth + 1 ) )
+                    {
+                        return false;
+                    }
+                } while( Consume( ',' ) );
+
+                return Consume( '}' );
+            }
+
+            case '[':
+            {
+                m_pCurrent++;
+                value.m_Type = JsonType::eArray;
+
+                if( Consume( ']' ) )
+                {
+                    return true;
+                }
+
+                do
+                {
+                    value.m_Array.emplace_back();
+
+                    if( !ParseValue( value.m_Array.back(), depth + 1 ) )
+                    {
+                        return false;
+                    }
+                } while( Consume( ',' ) );
+
+                return Consume( ']' );
+            }
+
+            case '"':
+                value.m_Type = JsonType::eString;
+                return ParseString( value.m_String );
+
+            case 't':
+                value.m_Type = JsonType::eBool;
+                value.m_Bool = true;
+                return ConsumeLiteral( "true" );
+
+            case 'f':
+                value.m_Type = JsonType::eBool;
+                value.m_Bool = false;
+                return ConsumeLiteral( "false" );
+
+            case 'n':
+                value.m_Type = JsonType::eNull;
+                return ConsumeLiteral( "null" );
+
+            default:
+                value.m_Type = JsonType::eNumber;
+                return ParseNumber( value.m_String );
+            }
+        }
+    };
+
+    JsonValue::JsonValue()
+        : m_Type( JsonType::eNull )
+        , m_Bool( false )
+        , m_String()
+        , m_Array()
+        , m_Object()
+    {
+    }
+
+    const JsonValue* JsonValue::Find( const char* pKey ) const
+    {
+        for( const auto& member : m_Object )
+        {
+            if( member.first == pKey )
+            {
+                return &member.second;
+            }
+        }
+
+        return nullptr;
+    }
+
+    uint64_t JsonValue::GetUint64() const
+    {
+        if( m_Type == JsonType::eBool )
+        {
+            return m_Bool;
+        }
+
+        // Literals with a fraction or an exponent are converted through a double.
+        if( m_String.find_first_of( ".eE" ) != String::npos )
+        {
+            return uint64_t( GetDouble() );
+        }
+
+        return strtoull( m_String.c_str(), nullptr, 10 );
+    }
+
+    int64_t JsonValue::GetInt64() const
+    {
+        if( m_Type == JsonType::eBool )
+        {
+            return m_Bool;
+        }
+
+        if( m_String.find_first_of( ".eE" ) != String::npos )
+        {
+            return int64_t( GetDouble() );
+        }
+
+        return strtoll( m_String.c_str(), nullptr, 10 );
+    }
+
+    double JsonValue::GetDouble() const
+    {
+        if( m_Type == JsonType::eBool )
+        {
+            return m_Bool;
+        }
+
+        return strtod( m_String.c_str(), nullptr );
+    }
+
+    bool ParseJson( const char* pBegin, const char* pEnd, JsonValue& value )
+    {
+        JsonParser parser = { pBegin, pEnd };
+
+        if( !parser.ParseValue( value, 0 ) )
+        {
+            return false;
+        }
+
+        parser.SkipWhitespace();
+        return parser.m_pCurrent == pEnd;
+    }
+}
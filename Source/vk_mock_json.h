@@ -0,0 +1,76 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "vk_mock_icd_helpers.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vkmock
+{
+    enum class JsonType
+    {
+        eNull,
+        eBool,
+        eNumber,
+        eString,
+        eArray,
+        eObject
+    };
+
+    /**
+     * @brief
+     *   Value of a parsed JSON document.
+     *   Numbers keep their literals, so 64-bit integers are converted without the loss
+     *   of precision of a double.
+     */
+    struct JsonValue
+    {
+        typedef std::basic_string<char, std::char_traits<char>, vk_stl_allocator<char>>
+            String;
+
+        typedef std::vector<JsonValue, vk_stl_allocator<JsonValue>>
+            Array;
+
+        typedef std::vector<std::pair<String, JsonValue>, vk_stl_allocator<std::pair<String, JsonValue>>>
+            Object;
+
+        JsonType m_Type;
+        bool m_Bool;
+        String m_String;
+        Array m_Array;
+        Object m_Object;
+
+        JsonValue();
+
+        const JsonValue* Find( const char* pKey ) const;
+
+        uint64_t GetUint64() const;
+        int64_t GetInt64() const;
+        double GetDouble() const;
+    };
+
+    /**
+     * @brief
+     *   Parse the JSON document. Returns false if the document is malformed.
+     */
+    bool ParseJson( const char* pBegin, const char* pEnd, JsonValue& value );
+}
@@ -0,0 +1,456 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_memory_ops.h"
+#include "vk_mock_simd.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace vkmock
+{
+    static void FillScalar( uint32_t* pDst, uint32_t value, size_t count )
+    {
+        for( size_t i = 0; i < count; ++i )
+        {
+            pDst[ i ] = value;
+        }
+    }
+
+    // Fills the unaligned head with scalar stores, so that the vector loop
+    // can use aligned (and non-temporal) stores.
+    static size_t FillHead( uint32_t*& pDst, uint32_t value, size_t count, size_t alignment )
+    {
+        const size_t misalignment = reinterpret_cast<uintptr_t>( pDst ) & ( alignment - 1 );
+        size_t headCount = misalignment ? ( alignment - misalignment ) / sizeof( uint32_t ) : 0;
+        if( headCount > count )
+        {
+            headCount = count;
+        }
+
+        FillScalar( pDst, value, headCount );
+        pDst += headCount;
+        return count - headCount;
+    }
+
+#ifdef VK_MOCK_SSE2
+    static const bool g_HasAvx2 = vk_cpu_has_avx2();
+
+    VK_MOCK_TARGET_AVX2
+    static void FillAvx2( uint32_t* pDst, uint32_t value, size_t count )
+    {
+        count = FillHead( pDst, value, count, 32 );
+
+        const __m256i v = _mm256_set1_epi32( static_cast<int>( value ) );
+        const size_t vectorCount = count / 32;
+
+        if( count * sizeof( uint32_t ) >= g_NonTemporalThreshold )
+        {
+            for( size_t i = 0; i < vectorCount; ++i )
+            {
+                __m256i* p = reinterpret_cast<__m256i*>( pDst + i * 32 );
+                _mm256_stream_si256( p + 0, v );
+                _mm256_stream_si256( p + 1, v );
+                _mm256_stream_si256( p + 2, v );
+                _mm256_stream_si256( p + 3, v );
+            }
+
+            _mm_sfence();
+        }
+        else
+        {
+            for( size_t i = 0; i < vectorCount; ++i )
+            {
+                __m256i* p = reinterpret_cast<__m256i*>( pDst + i * 32 );
+                _mm256_store_si256( p + 0, v );
+                _mm256_store_si256( p + 1, v );
+                _mm256_store_si256( p + 2, v );
+                _mm256_store_si256( p + 3, v );
+            }
+        }
+
+        FillScalar( pDst + vectorCount * 32, value, count - vectorCount * 32 );
+    }
+
+    static void FillSse2( uint32_t* pDst, uint32_t value, size_t count )
+    {
+        count = FillHead( pDst, value, count, 16 );
+
+        const __m128i v = _mm_set1_epi32( static_cast<int>( value ) );
+        const size_t vectorCount = count / 16;
+
+        if( count * sizeof( uint32_t ) >= g_NonTemporalThreshold )
+        {
+            for( size_t i = 0; i < vectorCount; ++i )
+            {
+                __m128i* p = reinterpret_cast<__m128i*>( pDst + i * 16 );
+                _mm_stream_si128( p + 0, v );
+                _mm_stream_si128( p + 1, v );
+                _mm_stream_si128( p + 2, v );
+                _mm_stream_si128( p + 3, v );
+            }
+
+            _mm_sfence();
+        }
+        else
+        {
+            for( size_t i = 0; i < vectorCount; ++i )
+            {
+                __m128i* p = reinterpret_cast<__m128i*>( pDst + i * 16 );
+                _mm_store_si128( p + 0, v );
+                _mm_store_si128( p + 1, v );
+                _mm_store_si128( p + 2, v );
+                _mm_store_si128( p + 3, v );
+            }
+        }
+
+        FillScalar( pDst + vectorCount * 16, value, count - vectorCount * 16 );
+    }
+
+    // Copies the unaligned head with memcpy, so that the destination of
+    // the vector loop is aligned for the non-temporal stores.
+    static size_t CopyHead( uint8_t*& pDst, const uint8_t*& pSrc, size_t size, size_t alignment )
+    {
+        const size_t misalignment = reinterpret_cast<uintptr_t>( pDst ) & ( alignment - 1 );
+        size_t headSize = misalignment ? alignment - misalignment : 0;
+        if( headSize > size )
+        {
+            headSize = size;
+        }
+
+        memcpy( pDst, pSrc, headSize );
+        pDst += headSize;
+        pSrc += headSize;
+        return size - headSize;
+    }
+
+    VK_MOCK_TARGET_AVX2
+    static void StreamCopyAvx2( uint8_t* pDst, const uint8_t* pSrc, size_t size )
+    {
+        size = CopyHead( pDst, pSrc, size, 32 );
+
+        const size_t vectorCount = size / 128;
+        for( size_t i = 0; i < vectorCount; ++i )
+        {
+            const __m256i* s = reinterpret_cast<const __m256i*>( pSrc + i * 128 );
+            __m256i* d = reinterpret_cast<__m256i*>( pDst + i * 128 );
+            const __m256i v0 = _mm256_loadu_si256( s + 0 );
+            const __m256i v1 = _mm256_loadu_si256( s + 1 );
+            const __m256i v2 = _mm256_loadu_si256( s + 2 );
+            const __m256i v3 = _mm256_loadu_si256( s + 3 );
+            _mm256_stream_si256( d + 0, v0 );
+            _mm256_stream_si256( d + 1, v1 );
+            _mm256_stream_si256( d + 2, v2 );
+            _mm256_stream_si256( d + 3, v3 );
+        }
+
+        _mm_sfence();
+
+        memcpy( pDst + vectorCount * 128, pSrc + vectorCount * 128, size - vectorCount * 128 );
+    }
+
+    static void StreamCopySse2( uint8_t* pDst, const uint8_t* pSrc, size_t size )
+    {
+        size = CopyHead( pDst, pSrc, size, 16 );
+
+        const size_t vectorCount = size / 64;
+        for( size_t i = 0; i < vectorCount; ++i )
+        {
+            const __m128i* s = reinterpret_cast<const __m128i*>( pSrc + i * 64 );
+            __m128i* d = reinterpret_cast<__m128i*>( pDst + i * 64 );
+            const __m128i v0 = _mm_loadu_si128( s + 0 );
+            const __m128i v1 = _mm_loadu_si128( s + 1 );
+            const __m128i v2 = _mm_loadu_si128( s + 2 );
+            const __m128i v3 = _mm_loadu_si128( s + 3 );
+            _mm_stream_si128( d + 0, v0 );
+            _mm_stream_si128( d + 1, v1 );
+            _mm_stream_si128( d + 2, v2 );
+            _mm_stream_si128( d + 3, v3 );
+        }
+
+        _mm_sfence();
+
+        memcpy( pDst + vectorCount * 64, pSrc + vectorCount * 64, size - vectorCount * 64 );
+    }
+
+    // Pattern blocks are either 32 or 96 bytes, and the destination is aligned to 32 bytes.
+    VK_MOCK_TARGET_AVX2
+    static void FillPatternAvx2( uint8_t* pDst, const uint8_t* pBlock, size_t blockSize, size_t blockCount, bool nonTemporal )
+    {
+        const size_t vectorsPerBlock = blockSize / 32;
+        const size_t vectorCount = blockCount * vectorsPerBlock;
+
+        __m256i v[ 3 ];
+        for( size_t i = 0; i < vectorsPerBlock; ++i )
+        {
+            v[ i ] = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( pBlock + i * 32 ) );
+        }
+
+        __m256i* p = reinterpret_cast<__m256i*>( pDst );
+        if( nonTemporal )
+        {
+            for( size_t i = 0; i < vectorCount; ++i )
+            {
+                _mm256_stream_si256( p + i, v[ i % vectorsPerBlock ] );
+            }
+
+            _mm_sfence();
+        }
+        else
+        {
+            for( size_t i = 0; i < vectorCount; ++i )
+            {
+                _mm256_store_si256( p + i, v[ i % vectorsPerBlock ] );
+            }
+        }
+    }
+
+    static void FillPatternSse2( uint8_t* pDst, const uint8_t* pBlock, size_t blockSize, size_t blockCount, bool nonTemporal )
+    {
+        const size_t vectorsPerBlock = blockSize / 16;
+        const size_t vectorCount = blockCount * vectorsPerBlock;
+
+        __m128i v[ 6 ];
+        for( size_t i = 0; i < vectorsPerBlock; ++i )
+        {
+            v[ i ] = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pBlock + i * 16 ) );
+        }
+
+        __m128i* p = reinterpret_cast<__m128i*>( pDst );
+        if( nonTemporal )
+        {
+            for( size_t i = 0; i < vectorCount; ++i )
+            {
+                _mm_stream_si128( p + i, v[ i % vectorsPerBlock ] );
+            }
+
+            _mm_sfence();
+        }
+        else
+        {
+            for( size_t i = 0; i < vectorCount; ++i )
+            {
+                _mm_store_si128( p + i, v[ i % vectorsPerBlock ] );
+            }
+        }
+    }
+#endif
+
+#ifdef VK_MOCK_NEON
+    static void FillNeon( uint32_t* pDst, uint32_t value, size_t count )
+    {
+        count = FillHead( pDst, value, count, 16 );
+
+        const uint32x4_t v = vdupq_n_u32( value );
+        const size_t vectorCount = count / 16;
+
+        for( size_t i = 0; i < vectorCount; ++i )
+        {
+            uint32_t* p = pDst + i * 16;
+            vst1q_u32( p + 0, v );
+            vst1q_u32( p + 4, v );
+            vst1q_u32( p + 8, v );
+            vst1q_u32( p + 12, v );
+        }
+
+        FillScalar( pDst + vectorCount * 16, value, count - vectorCount * 16 );
+    }
+
+    static void FillPatternNeon( uint8_t* pDst, const uint8_t* pBlock, size_t blockSize, size_t blockCount, bool )
+    {
+        const size_t vectorsPerBlock = blockSize / 16;
+        const size_t vectorCount = blockCount * vectorsPerBlock;
+
+        uint8x16_t v[ 6 ];
+        for( size_t i = 0; i < vectorsPerBlock; ++i )
+        {
+            v[ i ] = vld1q_u8( pBlock + i * 16 );
+        }
+
+        for( size_t i = 0; i < vectorCount; ++i )
+        {
+            vst1q_u8( pDst + i * 16, v[ i % vectorsPerBlock ] );
+        }
+    }
+#endif
+
+    static void TruncateScalar( uint32_t* pDst, const uint64_t* pSrc, size_t count )
+    {
+        for( size_t i = 0; i < count; ++i )
+        {
+            pDst[ i ] = static_cast<uint32_t>( pSrc[ i ] );
+        }
+    }
+
+#ifdef VK_MOCK_SSE2
+    static void TruncateSse2( uint32_t* pDst, const uint64_t* pSrc, size_t count )
+    {
+        const size_t vectorCount = count / 4;
+
+        for( size_t i = 0; i < vectorCount; ++i )
+        {
+            // Low halves of 4 values are selected from 2 vectors with a single shuffle.
+            const __m128 v0 = _mm_castsi128_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSrc + i * 4 ) ) );
+            const __m128 v1 = _mm_castsi128_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSrc + i * 4 + 2 ) ) );
+            _mm_storeu_ps( reinterpret_cast<float*>( pDst + i * 4 ), _mm_shuffle_ps( v0, v1, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+        }
+
+        TruncateScalar( pDst + vectorCount * 4, pSrc + vectorCount * 4, count - vectorCount * 4 );
+    }
+#endif
+
+#ifdef VK_MOCK_NEON
+    static void TruncateNeon( uint32_t* pDst, const uint64_t* pSrc, size_t count )
+    {
+        const size_t vectorCount = count / 4;
+
+        for( size_t i = 0; i < vectorCount; ++i )
+        {
+            const uint32x2_t v0 = vmovn_u64( vld1q_u64( pSrc + i * 4 ) );
+            const uint32x2_t v1 = vmovn_u64( vld1q_u64( pSrc + i * 4 + 2 ) );
+            vst1q_u32( pDst + i * 4, vcombine_u32( v0, v1 ) );
+        }
+
+        TruncateScalar( pDst + vectorCount * 4, pSrc + vectorCount * 4, count - vectorCount * 4 );
+    }
+#endif
+
+    void vk_fill_memory( void* pDst, uint32_t value, size_t size )
+    {
+        uint32_t* pDst32 = static_cast<uint32_t*>( pDst );
+        const size_t count = size / sizeof( uint32_t );
+
+#if defined( VK_MOCK_SSE2 )
+        if( g_HasAvx2 )
+        {
+            return FillAvx2( pDst32, value, count );
+        }
+
+        return FillSse2( pDst32, value, count );
+#elif defined( VK_MOCK_NEON )
+        return FillNeon( pDst32, value, count );
+#else
+        return FillScalar( pDst32, value, count );
+#endif
+    }
+
+    void vk_copy_memory( void* pDst, const void* pSrc, size_t size )
+    {
+        if( vk_memory_overlaps( pDst, pSrc, size ) )
+        {
+            memmove( pDst, pSrc, size );
+            return;
+        }
+
+#if defined( VK_MOCK_SSE2 )
+        if( size >= g_NonTemporalThreshold )
+        {
+            uint8_t* pDst8 = static_cast<uint8_t*>( pDst );
+            const uint8_t* pSrc8 = static_cast<const uint8_t*>( pSrc );
+
+            if( g_HasAvx2 )
+            {
+                return StreamCopyAvx2( pDst8, pSrc8, size );
+            }
+
+            return StreamCopySse2( pDst8, pSrc8, size );
+        }
+#endif
+
+        memcpy( pDst, pSrc, size );
+    }
+
+    void vk_fill_memory_pattern( void* pDst, const void* pPattern, size_t patternSize, size_t size )
+    {
+        uint8_t* pDst8 = static_cast<uint8_t*>( pDst );
+        const uint8_t* pPattern8 = static_cast<const uint8_t*>( pPattern );
+
+        if( patternSize == 1 )
+        {
+            memset( pDst, pPattern8[ 0 ], size );
+            return;
+        }
+
+        // The pattern is expanded to a block that is a multiple of both the pattern
+        // and the vector size. 96 bytes cover all texel sizes of the uncompressed formats.
+        constexpr size_t maxBlockSize = 96;
+        if( patternSize > maxBlockSize || ( maxBlockSize % patternSize ) != 0 )
+        {
+            for( size_t offset = 0; offset + patternSize <= size; offset += patternSize )
+            {
+                memcpy( pDst8 + offset, pPattern8, patternSize );
+            }
+            return;
+        }
+
+        // Write the unaligned head, and start the block at the pattern phase following it.
+        const size_t misalignment = reinterpret_cast<uintptr_t>( pDst8 ) & 31;
+        const size_t headSize = std::min( misalignment ? 32 - misalignment : 0, size );
+        for( size_t i = 0; i < headSize; ++i )
+        {
+            pDst8[ i ] = pPattern8[ i % patternSize ];
+        }
+
+        pDst8 += headSize;
+        size -= headSize;
+
+        const size_t blockSize = ( 32 % patternSize ) ? maxBlockSize : 32;
+        uint8_t block[ maxBlockSize ];
+        for( size_t i = 0; i < blockSize; ++i )
+        {
+            block[ i ] = pPattern8[ ( headSize + i ) % patternSize ];
+        }
+
+        const size_t blockCount = size / blockSize;
+
+#if defined( VK_MOCK_SSE2 )
+        const bool nonTemporal = size >= g_NonTemporalThreshold;
+        if( g_HasAvx2 )
+        {
+            FillPatternAvx2( pDst8, block, blockSize, blockCount, nonTemporal );
+        }
+        else
+        {
+            FillPatternSse2( pDst8, block, blockSize, blockCount, nonTemporal );
+        }
+#elif defined( VK_MOCK_NEON )
+        FillPatternNeon( pDst8, block, blockSize, blockCount, false );
+#else
+        for( size_t i = 0; i < blockCount; ++i )
+        {
+            memcpy( pDst8 + i * blockSize, block, blockSize );
+        }
+#endif
+
+        // The tail starts at the beginning of a block.
+        memcpy( pDst8 + blockCount * blockSize, block, size - blockCount * blockSize );
+    }
+
+    void vk_truncate_u64( uint32_t* pDst, const uint64_t* pSrc, size_t count )
+    {
+#if defined( VK_MOCK_SSE2 )
+        return TruncateSse2( pDst, pSrc, count );
+#elif defined( VK_MOCK_NEON )
+        return TruncateNeon( pDst, pSrc, count );
+#else
+        return TruncateScalar( pDst, pSrc, count );
+#endif
+    }
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace vkmock
+{
+    // Writes larger than this bypass the caches with non-temporal stores,
+    // the data would be evicted before it is read anyway.
+    static constexpr size_t g_NonTemporalThreshold = 4 * 1024 * 1024;
+
+    /**
+     * @brief
+     *   Fill the memory with a repeated 32-bit pattern.
+     * @param pDst
+     *   Destination memory, aligned to 4 bytes.
+     * @param value
+     *   The pattern to write.
+     * @param size
+     *   Number of bytes to write, multiple of 4.
+     */
+    void vk_fill_memory( void* pDst, uint32_t value, size_t size );
+
+    /**
+     * @brief
+     *   Fill the memory with a repeated pattern of any size, e.g. an encoded texel.
+     * @param pDst
+     *   Destination memory.
+     * @param pPattern
+     *   The pattern to write.
+     * @param patternSize
+     *   Size of the pattern in bytes.
+     * @param size
+     *   Number of bytes to write, multiple of the pattern size.
+     */
+    void vk_fill_memory_pattern( void* pDst, const void* pPattern, size_t patternSize, size_t size );
+
+    /**
+     * @brief
+     *   Check whether two ranges of the same size overlap.
+     */
+    inline bool vk_memory_overlaps( const void* pDst, const void* pSrc, size_t size )
+    {
+        const uintptr_t dst = reinterpret_cast<uintptr_t>( pDst );
+        const uintptr_t src = reinterpret_cast<uintptr_t>( pSrc );
+        return ( dst < src + size ) && ( src < dst + size );
+    }
+
+    /**
+     * @brief
+     *   Copy the memory, bypassing the caches for large copies.
+     *   Overlapping ranges are copied as if through an intermediate buffer.
+     * @param pDst
+     *   Destination memory.
+     * @param pSrc
+     *   Source memory.
+     * @param size
+     *   Number of bytes to copy.
+     */
+    void vk_copy_memory( void* pDst, const void* pSrc, size_t size );
+
+    /**
+     * @brief
+     *   Copy an array of 64-bit values to an array of 32-bit values, keeping the low 32 bits.
+     * @param pDst
+     *   Destination array, aligned to 4 bytes.
+     * @param pSrc
+     *   Source array, aligned to 8 bytes.
+     * @param count
+     *   Number of values to copy.
+     */
+    void vk_truncate_u64( uint32_t* pDst, const uint64_t* pSrc, size_t count );
+}
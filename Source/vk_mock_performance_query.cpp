@@ -0,0 +1,224 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_performance_query.h"
+#include "vk_mock_device.h"
+#include "vk_mock_physical_device.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
+namespace vkmock
+{
+    struct PerformanceCounterInfo
+    {
+        VkPerformanceCounterUnitKHR unit;
+        const char* pName;
+        const char* pCategory;
+        const char* pDescription;
+    };
+
+    // Indexed by VkMockPerformanceCounterEXT.
+    static const PerformanceCounterInfo g_PerformanceCounterInfos[] = {
+        { VK_PERFORMANCE_COUNTER_UNIT_GENERIC_KHR, "Commands executed", "Command processor", "Number of commands executed by the queue." },
+        { VK_PERFORMANCE_COUNTER_UNIT_BYTES_KHR, "Bytes copied", "Transfer", "Number of bytes written by the copy commands." },
+        { VK_PERFORMANCE_COUNTER_UNIT_NANOSECONDS_KHR, "Busy time", "Command processor", "Time spent executing the commands." },
+        { VK_PERFORMANCE_COUNTER_UNIT_GENERIC_KHR, "Draws", "Graphics", "Number of draws executed, including the draws of the indirect commands." },
+        { VK_PERFORMANCE_COUNTER_UNIT_GENERIC_KHR, "Dispatches", "Compute", "Number of dispatches executed." },
+        { VK_PERFORMANCE_COUNTER_UNIT_GENERIC_KHR, "Vertices", "Graphics", "Number of vertices assembled by the draws." },
+        { VK_PERFORMANCE_COUNTER_UNIT_BYTES_KHR, "Peer bytes copied", "Transfer", "Number of bytes copied from or to the memory of other devices in the group." },
+    };
+
+    static constexpr uint32_t g_PerformanceCounterInfoCount = static_cast<uint32_t>( std::size( g_PerformanceCounterInfos ) );
+
+    static void CopyString( char* pDst, const char* pSrc )
+    {
+        strncpy( pDst, pSrc, VK_MAX_DESCRIPTION_SIZE - 1 );
+        pDst[ VK_MAX_DESCRIPTION_SIZE - 1 ] = '\0';
+    }
+
+    void ExecutionCounters::RecordCommand() noexcept
+    {
+        m_CommandCount.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    void ExecutionCounters::RecordCopy( uint64_t size ) noexcept
+    {
+        m_BytesCopied.fetch_add( size, std::memory_order_relaxed );
+    }
+
+    void ExecutionCounters::RecordPeerCopy( uint64_t size ) noexcept
+    {
+        m_PeerBytesCopied.fetch_add( size, std::memory_order_relaxed );
+    }
+
+    PerformanceCounterSet::PerformanceCounterSet()
+        : m_Counters()
+        , m_CounterCount( g_PerformanceCounterInfoCount )
+        , m_CountersPerPass( 0 )
+    {
+        for( uint32_t i = 0; i < m_CounterCount; ++i )
+        {
+            m_Counters[ i ] = static_cast<VkMockPerformanceCounterEXT>( i );
+        }
+    }
+
+    VkResult PerformanceCounterSet::SetCounters( const VkMockPerformanceCountersInfoEXT& info )
+    {
+        if( info.counterCount > g_MaxPerformanceCounters )
+        {
+            return VK_ERROR_TOO_MANY_OBJECTS;
+        }
+
+        for( uint32_t i = 0; i < info.counterCount; ++i )
+        {
+            if( static_cast<uint32_t>( info.pCounters[ i ] ) >= g_PerformanceCounterInfoCount )
+            {
+                return VK_ERROR_FEATURE_NOT_PRESENT;
+            }
+        }
+
+        std::copy_n( info.pCounters, info.counterCount, m_Counters );
+        m_CounterCount = info.counterCount;
+        m_CountersPerPass = info.countersPerPass;
+        return VK_SUCCESS;
+    }
+
+    VkResult PerformanceCounterSet::EnumerateCounters( uint32_t* pCounterCount, VkPerformanceCounterKHR* pCounters, VkPerformanceCounterDescriptionKHR* pCounterDescriptions ) const
+    {
+        if( !pCounters && !pCounterDescriptions )
+        {
+            *pCounterCount = m_CounterCount;
+            return VK_SUCCESS;
+        }
+
+        const uint32_t count = std::min( *pCounterCount, m_CounterCount );
+        for( uint32_t i = 0; i < count; ++i )
+        {
+            const PerformanceCounterInfo& info = g_PerformanceCounterInfos[ m_Counters[ i ] ];
+
+            if( pCounters )
+            {
+                // UUIDs identify the counters regardless of their indices.
+                pCounters[ i ].unit = info.unit;
+                pCounters[ i ].scope = VK_PERFORMANCE_COUNTER_SCOPE_COMMAND_KHR;
+                pCounters[ i ].storage = VK_PERFORMANCE_COUNTER_STORAGE_UINT64_KHR;
+                memset( pCounters[ i ].uuid, 0, VK_UUID_SIZE );
+                memcpy( pCounters[ i ].uuid, "vk_mock_icd", 11 );
+                pCounters[ i ].uuid[ VK_UUID_SIZE - 1 ] = static_cast<uint8_t>( m_Counters[ i ] );
+            }
+
+            if( pCounterDescriptions )
+            {
+                pCounterDescriptions[ i ].flags = 0;
+                CopyString( pCounterDescriptions[ i ].name, info.pName );
+                CopyString( pCounterDescriptions[ i ].category, info.pCategory );
+                CopyString( pCounterDescriptions[ i ].description, info.pDescription );
+            }
+        }
+
+        *pCounterCount = count;
+
+        if( count < m_CounterCount )
+        {
+            return VK_INCOMPLETE;
+        }
+
+        return VK_SUCCESS;
+    }
+
+    uint32_t PerformanceCounterSet::GetCounterPass( uint32_t counterIndex ) const
+    {
+        return m_CountersPerPass ? counterIndex / m_CountersPerPass : 0;
+    }
+
+    uint32_t PerformanceCounterSet::GetPassCount( const VkQueryPoolPerformanceCreateInfoKHR& createInfo ) const
+    {
+        uint32_t passCount = 1;
+        for( uint32_t i = 0; i < createInfo.counterIndexCount; ++i )
+        {
+            passCount = std::max( passCount, GetCounterPass( createInfo.pCounterIndices[ i ] ) + 1 );
+        }
+
+        return passCount;
+    }
+
+    ProfilingLock::ProfilingLock()
+        : m_Acquired( false )
+    {
+    }
+
+    VkResult ProfilingLock::Acquire( uint64_t timeout )
+    {
+        std::unique_lock lock( m_Mutex );
+
+        // Timeouts too long to be represented by the clock wait indefinitely.
+        const auto released = [&] { return !m_Acquired; };
+        if( timeout >= uint64_t( std::chrono::nanoseconds::max().count() ) )
+        {
+            m_Released.wait( lock, released );
+        }
+        else if( !m_Released.wait_for( lock, std::chrono::nanoseconds( timeout ), released ) )
+        {
+            return VK_TIMEOUT;
+        }
+
+        m_Acquired = true;
+        return VK_SUCCESS;
+    }
+
+    void ProfilingLock::Release()
+    {
+        {
+            std::scoped_lock lock( m_Mutex );
+            m_Acquired = false;
+        }
+
+        m_Released.notify_one();
+    }
+
+    uint64_t ReadPerformanceCounter( VkDevice device, VkMockPerformanceCounterEXT counter )
+    {
+        switch( counter )
+        {
+        case VK_MOCK_PERFORMANCE_COUNTER_COMMANDS_EXECUTED_EXT:
+            return device->m_ExecutionCounters.m_CommandCount.load( std::memory_order_relaxed );
+        case VK_MOCK_PERFORMANCE_COUNTER_BYTES_COPIED_EXT:
+            return device->m_ExecutionCounters.m_BytesCopied.load( std::memory_order_relaxed );
+        case VK_MOCK_PERFORMANCE_COUNTER_BUSY_TIME_EXT:
+        {
+            // Commands are executed synchronously, so the device is busy for the whole duration of the query.
+            const DeviceClock& clock = device->m_PhysicalDevice->m_Clock;
+            return static_cast<uint64_t>( static_cast<double>( clock.Now() ) * clock.m_TimestampPeriod );
+        }
+        case VK_MOCK_PERFORMANCE_COUNTER_DRAWS_EXT:
+            return device->m_DrawCounters.m_DrawCount.load( std::memory_order_relaxed );
+        case VK_MOCK_PERFORMANCE_COUNTER_DISPATCHES_EXT:
+            return device->m_DrawCounters.m_DispatchCount.load( std::memory_order_relaxed );
+        case VK_MOCK_PERFORMANCE_COUNTER_VERTICES_EXT:
+            return device->m_DrawCounters.m_VertexCount.load( std::memory_order_relaxed );
+        case VK_MOCK_PERFORMANCE_COUNTER_PEER_BYTES_COPIED_EXT:
+            return device->m_ExecutionCounters.m_PeerBytesCopied.load( std::memory_order_relaxed );
+        default:
+            return 0;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "vk_mock.h"
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace vkmock
+{
+    static constexpr uint32_t g_MaxPerformanceCounters = VK_MOCK_MAX_PERFORMANCE_COUNTERS_EXT;
+
+    /**
+     * @brief
+     *   Counters of the work executed by the queues of a device, which is not covered by the draw counters.
+     */
+    struct ExecutionCounters
+    {
+        std::atomic<uint64_t> m_CommandCount;
+        std::atomic<uint64_t> m_BytesCopied;
+        std::atomic<uint64_t> m_PeerBytesCopied;
+
+        void RecordCommand() noexcept;
+        void RecordCopy( uint64_t size ) noexcept;
+        void RecordPeerCopy( uint64_t size ) noexcept;
+    };
+
+    /**
+     * @brief
+     *   Performance counters exposed through VK_KHR_performance_query.
+     *   Counters are assigned to the passes in order, countersPerPass counters at a time.
+     */
+    struct PerformanceCounterSet
+    {
+        VkMockPerformanceCounterEXT m_Counters[ g_MaxPerformanceCounters ];
+        uint32_t m_CounterCount;
+        uint32_t m_CountersPerPass;
+
+        PerformanceCounterSet();
+
+        VkResult SetCounters( const VkMockPerformanceCountersInfoEXT& info );
+
+        VkResult EnumerateCounters( uint32_t* pCounterCount, VkPerformanceCounterKHR* pCounters, VkPerformanceCounterDescriptionKHR* pCounterDescriptions ) const;
+
+        uint32_t GetCounterPass( uint32_t counterIndex ) const;
+        uint32_t GetPassCount( const VkQueryPoolPerformanceCreateInfoKHR& createInfo ) const;
+    };
+
+    /**
+     * @brief
+     *   Lock of the device required by VK_KHR_performance_query while the performance queries
+     *   are recorded and executed. Concurrent acquisitions wait until the lock is released.
+     */
+    struct ProfilingLock
+    {
+        std::mutex m_Mutex;
+        std::condition_variable m_Released;
+        bool m_Acquired;
+
+        ProfilingLock();
+
+        VkResult Acquire( uint64_t timeout );
+        void Release();
+    };
+
+    /**
+     * @brief
+     *   Read the current value of the counter.
+     *   Values are cumulative, so the result of a query is the difference of the values
+     *   read at the end and at the beginning of the query.
+     */
+    uint64_t ReadPerformanceCounter( VkDevice device, VkMockPerformanceCounterEXT counter );
+}
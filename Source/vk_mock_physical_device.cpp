@@ -21,14 +21,68 @@
 #include "vk_mock_physical_device.h"
 #include "vk_mock_instance.h"
 #include "vk_mock_device.h"
+#include "vk_mock_device_memory.h"
+#include "vk_mock_compute.h"
+#include "vk_mock_format.h"
+#include "vk_mock_raster.h"
+#include "vk_mock_spirv.h"
 #include "vk_mock_icd_helpers.h"
 
 namespace vkmock
 {
-    PhysicalDevice::PhysicalDevice( VkInstance instance )
+    static constexpr VkDeviceSize g_DefaultMemoryHeapSize = 128 * 1024 * 1024;
+
+#ifdef VK_EXT_host_image_copy
+    // Images have the same memory layout in all image layouts, so the host image copies
+    // support the same layouts for reads and writes.
+    static void GetHostImageCopyLayouts( uint32_t* pLayoutCount, VkImageLayout* pLayouts )
+    {
+        const VkImageLayout layouts[] = {
+            VK_IMAGE_LAYOUT_GENERAL,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        };
+
+        const uint32_t layoutCount = std::size( layouts );
+
+        if( !pLayouts )
+        {
+            *pLayoutCount = layoutCount;
+            return;
+        }
+
+        const uint32_t count = std::min( *pLayoutCount, layoutCount );
+        for( uint32_t i = 0; i < count; ++i )
+        {
+            pLayouts[ i ] = layouts[ i ];
+        }
+
+        *pLayoutCount = count;
+    }
+#endif
+
+    PhysicalDevice::PhysicalDevice( VkInstance instance, uint32_t index, const VkMockPhysicalDeviceInfoEXT& info, uint64_t peerMemoryBandwidth )
         : m_Instance( instance )
+        , m_Clock()
+        , m_PerformanceCounters()
+        , m_Profile()
+        , m_Index( index )
+        , m_DeviceName()
+        , m_VendorID( info.vendorID )
+        , m_DeviceID( info.deviceID )
+        , m_DeviceType( info.deviceType )
+        , m_MemoryHeapSize( info.memoryHeapSize ? info.memoryHeapSize : g_DefaultMemoryHeapSize )
+        , m_ThreadCount( info.threadCount )
+        , m_GroupIndex( info.groupIndex )
+        , m_PeerMemoryBandwidth( peerMemoryBandwidth )
     {
         m_pMockFunctions = instance->m_pMockFunctions;
+
+        if( info.pDeviceName )
+        {
+            strncpy( m_DeviceName, info.pDeviceName, VK_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1 );
+        }
     }
 
     PhysicalDevice::~PhysicalDevice()
@@ -43,10 +97,62 @@ namespace vkmock
 #endif
 #ifdef VK_EXT_nested_command_buffer
             { VK_EXT_NESTED_COMMAND_BUFFER_EXTENSION_NAME, VK_EXT_NESTED_COMMAND_BUFFER_SPEC_VERSION },
+#endif
+#ifdef VK_KHR_buffer_device_address
+            { VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME, VK_KHR_BUFFER_DEVICE_ADDRESS_SPEC_VERSION },
+#endif
+#ifdef VK_NV_copy_memory_indirect
+            { VK_NV_COPY_MEMORY_INDIRECT_EXTENSION_NAME, VK_NV_COPY_MEMORY_INDIRECT_SPEC_VERSION },
+#endif
+#ifdef VK_KHR_external_memory
+            { VK_KHR_EXTERNAL_MEMORY_EXTENSION_NAME, VK_KHR_EXTERNAL_MEMORY_SPEC_VERSION },
+#endif
+#if defined( VK_KHR_external_memory_fd ) && defined( VK_MOCK_ICD_MEMFD )
+            { VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME, VK_KHR_EXTERNAL_MEMORY_FD_SPEC_VERSION },
+#endif
+#ifdef VK_EXT_external_memory_host
+            { VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME, VK_EXT_EXTERNAL_MEMORY_HOST_SPEC_VERSION },
+#endif
+#ifdef VK_KHR_copy_commands2
+            { VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME, VK_KHR_COPY_COMMANDS_2_SPEC_VERSION },
+#endif
+#ifdef VK_EXT_host_image_copy
+            { VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME, VK_EXT_HOST_IMAGE_COPY_SPEC_VERSION },
+#endif
+#ifdef VK_KHR_dynamic_rendering
+            { VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME, VK_KHR_DYNAMIC_RENDERING_SPEC_VERSION },
+#endif
+#ifdef VK_KHR_draw_indirect_count
+            { VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME, VK_KHR_DRAW_INDIRECT_COUNT_SPEC_VERSION },
+#endif
+#ifdef VK_EXT_host_query_reset
+            { VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME, VK_EXT_HOST_QUERY_RESET_SPEC_VERSION },
+#endif
+#ifdef VK_KHR_calibrated_timestamps
+            { VK_KHR_CALIBRATED_TIMESTAMPS_EXTENSION_NAME, VK_KHR_CALIBRATED_TIMESTAMPS_SPEC_VERSION },
+#endif
+#ifdef VK_EXT_calibrated_timestamps
+            { VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME, VK_EXT_CALIBRATED_TIMESTAMPS_SPEC_VERSION },
+#endif
+#ifdef VK_KHR_performance_query
+            { VK_KHR_PERFORMANCE_QUERY_EXTENSION_NAME, VK_KHR_PERFORMANCE_QUERY_SPEC_VERSION },
+#endif
+#ifdef VK_KHR_device_group
+            { VK_KHR_DEVICE_GROUP_EXTENSION_NAME, VK_KHR_DEVICE_GROUP_SPEC_VERSION },
 #endif
         };
 
-        const uint32_t propertyCount = std::size( properties );
+        // Extensions not defined by the profile of the device are hidden.
+        const VkExtensionProperties* pSupportedProperties[ std::size( properties ) ];
+        uint32_t propertyCount = 0;
+
+        for( const VkExtensionProperties& extension : properties )
+        {
+            if( m_Profile.SupportsExtension( extension.extensionName ) )
+            {
+                pSupportedProperties[ propertyCount++ ] = &extension;
+            }
+        }
 
         if( !pProperties )
         {
@@ -57,7 +163,7 @@ namespace vkmock
         const uint32_t count = std::min( *pPropertyCount, propertyCount );
         for( uint32_t i = 0; i < count; ++i )
         {
-            pProperties[ i ] = properties[ i ];
+            pProperties[ i ] = *pSupportedProperties[ i ];
         }
 
         *pPropertyCount = count;
@@ -75,9 +181,10 @@ namespace vkmock
         memset( pProperties, 0, sizeof( VkPhysicalDeviceProperties ) );
         pProperties->apiVersion = VK_API_VERSION_1_3;
         pProperties->driverVersion = 0;
-        pProperties->vendorID = 0;
-        pProperties->deviceID = 0;
-        pProperties->deviceType = VK_PHYSICAL_DEVICE_TYPE_OTHER;
+        pProperties->vendorID = m_VendorID;
+        pProperties->deviceID = m_DeviceID;
+        pProperties->deviceType = m_DeviceType;
+        memcpy( pProperties->deviceName, m_DeviceName, VK_MAX_PHYSICAL_DEVICE_NAME_SIZE );
 
         pProperties->limits.maxImageDimension1D = 4096;
         pProperties->limits.maxImageDimension2D = 4096;
@@ -87,9 +194,60 @@ namespace vkmock
         pProperties->limits.maxTexelBufferElements = 65536;
         pProperties->limits.maxUniformBufferRange = 65536;
         pProperties->limits.maxStorageBufferRange = 65536;
-        pProperties->limits.maxPushConstantsSize = 256;
+        pProperties->limits.maxPushConstantsSize = g_MaxPushConstantsSize;
         pProperties->limits.maxMemoryAllocationCount = 4096;
         pProperties->limits.maxSamplerAllocationCount = 64;
+        pProperties->limits.maxBoundDescriptorSets = g_MaxBoundDescriptorSets;
+        pProperties->limits.maxDescriptorSetUniformBuffersDynamic = g_MaxDynamicDescriptorsPerSet / 2;
+        pProperties->limits.maxDescriptorSetStorageBuffersDynamic = g_MaxDynamicDescriptorsPerSet / 2;
+        pProperties->limits.minUniformBufferOffsetAlignment = 16;
+        pProperties->limits.minStorageBufferOffsetAlignment = 16;
+
+        // Compute limits match the values supported by most of the desktop hardware.
+        pProperties->limits.maxComputeSharedMemorySize = 32768;
+        pProperties->limits.maxComputeWorkGroupCount[ 0 ] = 65535;
+        pProperties->limits.maxComputeWorkGroupCount[ 1 ] = 65535;
+        pProperties->limits.maxComputeWorkGroupCount[ 2 ] = 65535;
+        pProperties->limits.maxComputeWorkGroupInvocations = 1024;
+        pProperties->limits.maxComputeWorkGroupSize[ 0 ] = 1024;
+        pProperties->limits.maxComputeWorkGroupSize[ 1 ] = 1024;
+        pProperties->limits.maxComputeWorkGroupSize[ 2 ] = 64;
+
+        // Graphics limits are bound by the fixed-size state of the software rasterizer.
+        pProperties->limits.maxVertexInputAttributes = g_MaxVertexAttributes;
+        pProperties->limits.maxVertexInputBindings = g_MaxVertexBindings;
+        pProperties->limits.maxVertexOutputComponents = g_MaxVaryings;
+        pProperties->limits.maxFragmentInputComponents = g_MaxVaryings;
+        pProperties->limits.maxFragmentOutputAttachments = g_MaxColorAttachments;
+        pProperties->limits.maxColorAttachments = g_MaxColorAttachments;
+        pProperties->limits.subPixelPrecisionBits = 4;
+        pProperties->limits.maxDrawIndirectCount = UINT32_MAX;
+        pProperties->limits.maxViewports = 1;
+        pProperties->limits.maxViewportDimensions[ 0 ] = 4096;
+        pProperties->limits.maxViewportDimensions[ 1 ] = 4096;
+        pProperties->limits.maxFramebufferWidth = 4096;
+        pProperties->limits.maxFramebufferHeight = 4096;
+        pProperties->limits.maxFramebufferLayers = 1;
+
+        // Timestamps of all queues are read from the same clock.
+        pProperties->limits.timestampComputeAndGraphics = VK_TRUE;
+        pProperties->limits.timestampPeriod = m_Clock.m_TimestampPeriod;
+
+        // Multisampled images store the samples of each texel next to each other.
+        const VkSampleCountFlags sampleCounts =
+            VK_SAMPLE_COUNT_1_BIT | VK_SAMPLE_COUNT_2_BIT | VK_SAMPLE_COUNT_4_BIT | VK_SAMPLE_COUNT_8_BIT;
+
+        pProperties->limits.framebufferColorSampleCounts = sampleCounts;
+        pProperties->limits.framebufferDepthSampleCounts = sampleCounts;
+        pProperties->limits.framebufferStencilSampleCounts = sampleCounts;
+        pProperties->limits.framebufferNoAttachmentsSampleCounts = sampleCounts;
+        pProperties->limits.sampledImageColorSampleCounts = sampleCounts;
+        pProperties->limits.sampledImageIntegerSampleCounts = sampleCounts;
+        pProperties->limits.sampledImageDepthSampleCounts = sampleCounts;
+        pProperties->limits.sampledImageStencilSampleCounts = sampleCounts;
+        pProperties->limits.storageImageSampleCounts = VK_SAMPLE_COUNT_1_BIT;
+
+        m_Profile.Apply( VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, pProperties );
     }
 
     void PhysicalDevice::vkGetPhysicalDeviceProperties2( VkPhysicalDeviceProperties2* pProperties )
@@ -99,6 +257,36 @@ namespace vkmock
         VkBaseOutStructure* pStruct = (VkBaseOutStructure*)( pProperties->pNext );
         while( pStruct )
         {
+            if( pStruct->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES )
+            {
+                // Processes sharing external memory compare the UUIDs to check
+                // whether the memory can be imported.
+                VkPhysicalDeviceIDProperties* pIDProperties = (VkPhysicalDeviceIDProperties*)pStruct;
+                memset( pIDProperties->deviceUUID, 0, VK_UUID_SIZE );
+                memset( pIDProperties->driverUUID, 0, VK_UUID_SIZE );
+                memcpy( pIDProperties->deviceUUID, "vk_mock_icd", 11 );
+                memcpy( pIDProperties->driverUUID, "vk_mock_icd", 11 );
+                pIDProperties->deviceUUID[ VK_UUID_SIZE - 1 ] = static_cast<uint8_t>( m_Index );
+                pIDProperties->deviceLUIDValid = VK_FALSE;
+            }
+
+            if( pStruct->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES )
+            {
+                // Subgroups are emulated by the SPIR-V interpreter, which only runs compute shaders.
+                VkPhysicalDeviceSubgroupProperties* pSubgroupProperties = (VkPhysicalDeviceSubgroupProperties*)pStruct;
+                pSubgroupProperties->subgroupSize = g_SpirvSubgroupSize;
+                pSubgroupProperties->supportedStages = VK_SHADER_STAGE_COMPUTE_BIT;
+                pSubgroupProperties->supportedOperations =
+                    VK_SUBGROUP_FEATURE_BASIC_BIT |
+                    VK_SUBGROUP_FEATURE_VOTE_BIT |
+                    VK_SUBGROUP_FEATURE_ARITHMETIC_BIT |
+                    VK_SUBGROUP_FEATURE_BALLOT_BIT |
+                    VK_SUBGROUP_FEATURE_SHUFFLE_BIT |
+                    VK_SUBGROUP_FEATURE_SHUFFLE_RELATIVE_BIT |
+                    VK_SUBGROUP_FEATURE_CLUSTERED_BIT;
+                pSubgroupProperties->quadOperationsInAllStages = VK_FALSE;
+            }
+
 #ifdef VK_EXT_nested_command_buffer
             if( pStruct->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_NESTED_COMMAND_BUFFER_PROPERTIES_EXT )
             {
@@ -107,6 +295,46 @@ namespace vkmock
             }
 #endif
 
+#ifdef VK_EXT_external_memory_host
+            if( pStruct->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT )
+            {
+                VkPhysicalDeviceExternalMemoryHostPropertiesEXT* pExternalMemoryHostProperties = (VkPhysicalDeviceExternalMemoryHostPropertiesEXT*)pStruct;
+                pExternalMemoryHostProperties->minImportedHostPointerAlignment = g_MinImportedHostPointerAlignment;
+            }
+#endif
+
+#ifdef VK_NV_copy_memory_indirect
+            if( pStruct->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COPY_MEMORY_INDIRECT_PROPERTIES_NV )
+            {
+                VkPhysicalDeviceCopyMemoryIndirectPropertiesNV* pCopyMemoryIndirectProperties = (VkPhysicalDeviceCopyMemoryIndirectPropertiesNV*)pStruct;
+                pCopyMemoryIndirectProperties->supportedQueues = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT;
+            }
+#endif
+
+#ifdef VK_EXT_host_image_copy
+            if( pStruct->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_PROPERTIES_EXT )
+            {
+                VkPhysicalDeviceHostImageCopyPropertiesEXT* pHostImageCopyProperties = (VkPhysicalDeviceHostImageCopyPropertiesEXT*)pStruct;
+                GetHostImageCopyLayouts( &pHostImageCopyProperties->copySrcLayoutCount, pHostImageCopyProperties->pCopySrcLayouts );
+                GetHostImageCopyLayouts( &pHostImageCopyProperties->copyDstLayoutCount, pHostImageCopyProperties->pCopyDstLayouts );
+                memset( pHostImageCopyProperties->optimalTilingLayoutUUID, 0, VK_UUID_SIZE );
+                memcpy( pHostImageCopyProperties->optimalTilingLayoutUUID, "vk_mock_icd", 11 );
+                pHostImageCopyProperties->identicalMemoryTypeRequirements = VK_TRUE;
+            }
+#endif
+
+#ifdef VK_KHR_performance_query
+            if( pStruct->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PERFORMANCE_QUERY_PROPERTIES_KHR )
+            {
+                // Results are computed on the host, so they can be copied with vkCmdCopyQueryPoolResults.
+                VkPhysicalDevicePerformanceQueryPropertiesKHR* pPerformanceQueryProperties = (VkPhysicalDevicePerformanceQueryPropertiesKHR*)pStruct;
+                pPerformanceQueryProperties->allowCommandBufferQueryCopies = VK_TRUE;
+            }
+#endif
+
+            // Values defined by the profile replace the values reported by the mock.
+            m_Profile.Apply( pStruct->sType, pStruct );
+
             pStruct = pStruct->pNext;
         }
     }
@@ -114,6 +342,14 @@ namespace vkmock
     void PhysicalDevice::vkGetPhysicalDeviceFeatures( VkPhysicalDeviceFeatures* pFeatures )
     {
         memset( pFeatures, 0, sizeof( VkPhysicalDeviceFeatures ) );
+
+        pFeatures->multiDrawIndirect = VK_TRUE;
+        pFeatures->drawIndirectFirstInstance = VK_TRUE;
+        pFeatures->occlusionQueryPrecise = VK_TRUE;
+        pFeatures->pipelineStatisticsQuery = VK_TRUE;
+
+        // Core structures are identified by the sTypes of the structures wrapping them.
+        m_Profile.Apply( VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, pFeatures );
     }
 
     void PhysicalDevice::vkGetPhysicalDeviceFeatures2( VkPhysicalDeviceFeatures2* pFeatures )
@@ -133,10 +369,209 @@ namespace vkmock
             }
 #endif
 
+            if( pStruct->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES )
+            {
+                VkPhysicalDeviceVulkan12Features* pVulkan12Features = (VkPhysicalDeviceVulkan12Features*)pStruct;
+                pVulkan12Features->drawIndirectCount = VK_TRUE;
+                pVulkan12Features->bufferDeviceAddress = VK_TRUE;
+                pVulkan12Features->hostQueryReset = VK_TRUE;
+            }
+
+            if( pStruct->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES )
+            {
+                VkPhysicalDeviceBufferDeviceAddressFeatures* pBufferDeviceAddressFeatures = (VkPhysicalDeviceBufferDeviceAddressFeatures*)pStruct;
+                pBufferDeviceAddressFeatures->bufferDeviceAddress = VK_TRUE;
+            }
+
+#ifdef VK_NV_copy_memory_indirect
+            if( pStruct->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COPY_MEMORY_INDIRECT_FEATURES_NV )
+            {
+                VkPhysicalDeviceCopyMemoryIndirectFeaturesNV* pCopyMemoryIndirectFeatures = (VkPhysicalDeviceCopyMemoryIndirectFeaturesNV*)pStruct;
+                pCopyMemoryIndirectFeatures->indirectCopy = VK_TRUE;
+            }
+#endif
+
+#ifdef VK_EXT_host_image_copy
+            if( pStruct->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT )
+            {
+                VkPhysicalDeviceHostImageCopyFeaturesEXT* pHostImageCopyFeatures = (VkPhysicalDeviceHostImageCopyFeaturesEXT*)pStruct;
+                pHostImageCopyFeatures->hostImageCopy = VK_TRUE;
+            }
+#endif
+
+#ifdef VK_KHR_performance_query
+            if( pStruct->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PERFORMANCE_QUERY_FEATURES_KHR )
+            {
+                VkPhysicalDevicePerformanceQueryFeaturesKHR* pPerformanceQueryFeatures = (VkPhysicalDevicePerformanceQueryFeaturesKHR*)pStruct;
+                pPerformanceQueryFeatures->performanceCounterQueryPools = VK_TRUE;
+                pPerformanceQueryFeatures->performanceCounterMultipleQueryPools = VK_TRUE;
+            }
+#endif
+
+            m_Profile.Apply( pStruct->sType, pStruct );
+
+            pStruct = pStruct->pNext;
+        }
+    }
+
+    void PhysicalDevice::vkGetPhysicalDeviceFormatProperties( VkFormat format, VkFormatProperties* pFormatProperties )
+    {
+        // Images are laid out the same way in both tilings, so the copy and clear kernels
+        // support the same features for the linear and optimal images.
+        const FormatInfo& formatInfo = GetFormatInfo( format );
+        pFormatProperties->linearTilingFeatures = formatInfo.imageFeatures;
+        pFormatProperties->optimalTilingFeatures = formatInfo.imageFeatures;
+        pFormatProperties->bufferFeatures = formatInfo.bufferFeatures;
+
+        m_Profile.Apply( format, VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_2, pFormatProperties );
+    }
+
+    void PhysicalDevice::vkGetPhysicalDeviceFormatProperties2( VkFormat format, VkFormatProperties2* pFormatProperties )
+    {
+        vkGetPhysicalDeviceFormatProperties( format, &pFormatProperties->formatProperties );
+
+        VkBaseOutStructure* pStruct = (VkBaseOutStructure*)( pFormatProperties->pNext );
+        while( pStruct )
+        {
+            if( pStruct->sType == VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_3 )
+            {
+                // The first 31 bits of the extended flags match the legacy ones.
+                const VkFormatProperties& formatProperties = pFormatProperties->formatProperties;
+                VkFormatProperties3* pFormatProperties3 = (VkFormatProperties3*)pStruct;
+                pFormatProperties3->linearTilingFeatures = formatProperties.linearTilingFeatures;
+                pFormatProperties3->optimalTilingFeatures = formatProperties.optimalTilingFeatures;
+                pFormatProperties3->bufferFeatures = formatProperties.bufferFeatures;
+            }
+
+            m_Profile.Apply( format, pStruct->sType, pStruct );
+
             pStruct = pStruct->pNext;
         }
     }
 
+    VkResult PhysicalDevice::vkGetPhysicalDeviceImageFormatProperties( VkFormat format, VkImageType type, VkImageTiling tiling, VkImageUsageFlags usage, VkImageCreateFlags flags, VkImageFormatProperties* pImageFormatProperties )
+    {
+        memset( pImageFormatProperties, 0, sizeof( VkImageFormatProperties ) );
+
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties( format, &formatProperties );
+
+        const VkFormatFeatureFlags features = ( tiling == VK_IMAGE_TILING_LINEAR )
+            ? formatProperties.linearTilingFeatures
+            : formatProperties.optimalTilingFeatures;
+
+        VkFormatFeatureFlags requiredFeatures = 0;
+        if( usage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT ) requiredFeatures |= VK_FORMAT_FEATURE_TRANSFER_SRC_BIT;
+        if( usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT ) requiredFeatures |= VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+        if( usage & VK_IMAGE_USAGE_SAMPLED_BIT ) requiredFeatures |= VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+        if( usage & VK_IMAGE_USAGE_STORAGE_BIT ) requiredFeatures |= VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT;
+        if( usage & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT ) requiredFeatures |= VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT;
+        if( usage & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT ) requiredFeatures |= VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
+        if( !features || ( features & requiredFeatures ) != requiredFeatures )
+        {
+            return VK_ERROR_FORMAT_NOT_SUPPORTED;
+        }
+
+        // Input attachments may be either color or depth/stencil attachments.
+        if( ( usage & VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT ) &&
+            !( features & ( VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT | VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT ) ) )
+        {
+            return VK_ERROR_FORMAT_NOT_SUPPORTED;
+        }
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties( &properties );
+
+        const VkPhysicalDeviceLimits& limits = properties.limits;
+        VkExtent3D& maxExtent = pImageFormatProperties->maxExtent;
+
+        switch( type )
+        {
+        case VK_IMAGE_TYPE_1D:
+            maxExtent = { limits.maxImageDimension1D, 1, 1 };
+            break;
+        case VK_IMAGE_TYPE_2D:
+            maxExtent.width = ( flags & VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT ) ? limits.maxImageDimensionCube : limits.maxImageDimension2D;
+            maxExtent.height = maxExtent.width;
+            maxExtent.depth = 1;
+            break;
+        case VK_IMAGE_TYPE_3D:
+            maxExtent = { limits.maxImageDimension3D, limits.maxImageDimension3D, limits.maxImageDimension3D };
+            break;
+        default:
+            return VK_ERROR_FORMAT_NOT_SUPPORTED;
+        }
+
+        uint32_t maxDimension = std::max( { maxExtent.width, maxExtent.height, maxExtent.depth } );
+        pImageFormatProperties->maxMipLevels = 1;
+        while( maxDimension >>= 1 )
+        {
+            pImageFormatProperties->maxMipLevels++;
+        }
+
+        pImageFormatProperties->maxArrayLayers = ( type == VK_IMAGE_TYPE_3D ) ? 1 : limits.maxImageArrayLayers;
+        pImageFormatProperties->sampleCounts = VK_SAMPLE_COUNT_1_BIT;
+        pImageFormatProperties->maxResourceSize = m_MemoryHeapSize;
+
+        // Multi-planar images are limited to a single mip level, layer and sample.
+        if( GetFormatInfo( format ).aspectMask & VK_IMAGE_ASPECT_PLANE_0_BIT )
+        {
+            pImageFormatProperties->maxMipLevels = 1;
+            pImageFormatProperties->maxArrayLayers = 1;
+            return VK_SUCCESS;
+        }
+
+        if( tiling == VK_IMAGE_TILING_OPTIMAL &&
+            type == VK_IMAGE_TYPE_2D &&
+            !( flags & VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT ) &&
+            ( features & ( VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT | VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT ) ) )
+        {
+            pImageFormatProperties->sampleCounts = ( features & VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT )
+                ? limits.framebufferColorSampleCounts
+                : limits.framebufferDepthSampleCounts;
+        }
+
+        // Storage images are accessed by the shaders texel by texel.
+        if( usage & VK_IMAGE_USAGE_STORAGE_BIT )
+        {
+            pImageFormatProperties->sampleCounts &= limits.storageImageSampleCounts;
+        }
+
+        return VK_SUCCESS;
+    }
+
+    VkResult PhysicalDevice::vkGetPhysicalDeviceImageFormatProperties2( const VkPhysicalDeviceImageFormatInfo2* pImageFormatInfo, VkImageFormatProperties2* pImageFormatProperties )
+    {
+        VkResult result = vkGetPhysicalDeviceImageFormatProperties(
+            pImageFormatInfo->format,
+            pImageFormatInfo->type,
+            pImageFormatInfo->tiling,
+            pImageFormatInfo->usage,
+            pImageFormatInfo->flags,
+            &pImageFormatProperties->imageFormatProperties );
+
+        if( result != VK_SUCCESS )
+        {
+            return result;
+        }
+
+        VkBaseOutStructure* pStruct = (VkBaseOutStructure*)( pImageFormatProperties->pNext );
+        while( pStruct )
+        {
+            if( pStruct->sType == VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_IMAGE_FORMAT_PROPERTIES )
+            {
+                // Each plane is bound to a separate descriptor.
+                VkSamplerYcbcrConversionImageFormatProperties* pYcbcrProperties = (VkSamplerYcbcrConversionImageFormatProperties*)pStruct;
+                pYcbcrProperties->combinedImageSamplerDescriptorCount = GetFormatInfo( pImageFormatInfo->format ).planeCount;
+            }
+
+            pStruct = pStruct->pNext;
+        }
+
+        return VK_SUCCESS;
+    }
+
     void PhysicalDevice::vkGetPhysicalDeviceMemoryProperties( VkPhysicalDeviceMemoryProperties* pMemoryProperties )
     {
         memset( pMemoryProperties, 0, sizeof( VkPhysicalDeviceMemoryProperties ) );
@@ -144,8 +579,14 @@ namespace vkmock
         pMemoryProperties->memoryTypes[ 0 ].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
         pMemoryProperties->memoryTypes[ 0 ].heapIndex = 0;
         pMemoryProperties->memoryHeapCount = 1;
-        pMemoryProperties->memoryHeaps[ 0 ].size = 128 * 1024 * 1024;
+        pMemoryProperties->memoryHeaps[ 0 ].size = m_MemoryHeapSize;
         pMemoryProperties->memoryHeaps[ 0 ].flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+
+        // Allocations made on a device group are replicated on all of its physical devices.
+        if( m_Instance->GetPhysicalDeviceGroupSize( m_GroupIndex ) > 1 )
+        {
+            pMemoryProperties->memoryHeaps[ 0 ].flags |= VK_MEMORY_HEAP_MULTI_INSTANCE_BIT;
+        }
     }
 
     void PhysicalDevice::vkGetPhysicalDeviceQueueFamilyProperties( uint32_t* pQueueFamilyPropertyCount, VkQueueFamilyProperties* pQueueFamilyProperties )
@@ -165,6 +606,56 @@ namespace vkmock
         }
     }
 
+    void PhysicalDevice::vkGetPhysicalDeviceExternalBufferProperties( const VkPhysicalDeviceExternalBufferInfo* pExternalBufferInfo, VkExternalBufferProperties* pExternalBufferProperties )
+    {
+        VkExternalMemoryProperties& properties = pExternalBufferProperties->externalMemoryProperties;
+        memset( &properties, 0, sizeof( VkExternalMemoryProperties ) );
+
+#ifdef VK_MOCK_ICD_MEMFD
+        if( pExternalBufferInfo->handleType == VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT )
+        {
+            properties.externalMemoryFeatures = VK_EXTERNAL_MEMORY_FEATURE_EXPORTABLE_BIT | VK_EXTERNAL_MEMORY_FEATURE_IMPORTABLE_BIT;
+            properties.exportFromImportedHandleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
+            properties.compatibleHandleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
+        }
+#endif
+
+#ifdef VK_EXT_external_memory_host
+        if( pExternalBufferInfo->handleType == VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT ||
+            pExternalBufferInfo->handleType == VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_MAPPED_FOREIGN_MEMORY_BIT_EXT )
+        {
+            properties.externalMemoryFeatures = VK_EXTERNAL_MEMORY_FEATURE_IMPORTABLE_BIT;
+            properties.compatibleHandleTypes = pExternalBufferInfo->handleType;
+        }
+#endif
+    }
+
+#ifdef VK_KHR_calibrated_timestamps
+    VkResult PhysicalDevice::vkGetPhysicalDeviceCalibrateableTimeDomainsKHR( uint32_t* pTimeDomainCount, VkTimeDomainKHR* pTimeDomains )
+    {
+        return DeviceClock::GetTimeDomains( pTimeDomainCount, pTimeDomains );
+    }
+#endif
+
+#ifdef VK_EXT_calibrated_timestamps
+    VkResult PhysicalDevice::vkGetPhysicalDeviceCalibrateableTimeDomainsEXT( uint32_t* pTimeDomainCount, VkTimeDomainEXT* pTimeDomains )
+    {
+        return DeviceClock::GetTimeDomains( pTimeDomainCount, pTimeDomains );
+    }
+#endif
+
+#ifdef VK_KHR_performance_query
+    VkResult PhysicalDevice::vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR( uint32_t queueFamilyIndex, uint32_t* pCounterCount, VkPerformanceCounterKHR* pCounters, VkPerformanceCounterDescriptionKHR* pCounterDescriptions )
+    {
+        return m_PerformanceCounters.EnumerateCounters( pCounterCount, pCounters, pCounterDescriptions );
+    }
+
+    void PhysicalDevice::vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR( const VkQueryPoolPerformanceCreateInfoKHR* pPerformanceQueryCreateInfo, uint32_t* pNumPasses )
+    {
+        *pNumPasses = m_PerformanceCounters.GetPassCount( *pPerformanceQueryCreateInfo );
+    }
+#endif
+
 #ifdef VK_KHR_win32_surface
     VkBool32 PhysicalDevice::vkGetPhysicalDeviceWin32PresentationSupportKHR( uint32_t queueFamilyIndex )
     {
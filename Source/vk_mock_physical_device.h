@@ -20,14 +20,31 @@
 
 #pragma once
 #include "vk_mock_icd_base.h"
+#include "vk_mock_clock.h"
+#include "vk_mock_performance_query.h"
+#include "vk_mock_profile.h"
+#include "vk_mock.h"
 
 namespace vkmock
 {
     struct PhysicalDevice : PhysicalDeviceBase
     {
         VkInstance m_Instance;
+        DeviceClock m_Clock;
+        PerformanceCounterSet m_PerformanceCounters;
+        DeviceProfile m_Profile;
 
-        PhysicalDevice( VkInstance instance );
+        uint32_t m_Index;
+        char m_DeviceName[ VK_MAX_PHYSICAL_DEVICE_NAME_SIZE ];
+        uint32_t m_VendorID;
+        uint32_t m_DeviceID;
+        VkPhysicalDeviceType m_DeviceType;
+        VkDeviceSize m_MemoryHeapSize;
+        uint32_t m_ThreadCount;
+        uint32_t m_GroupIndex;
+        uint64_t m_PeerMemoryBandwidth;
+
+        PhysicalDevice( VkInstance instance, uint32_t index, const VkMockPhysicalDeviceInfoEXT& info, uint64_t peerMemoryBandwidth );
         ~PhysicalDevice();
 
         VkResult vkEnumerateDeviceExtensionProperties( const char* pLayerName, uint32_t* pPropertyCount, VkExtensionProperties* pProperties );
@@ -36,8 +53,26 @@ namespace vkmock
         void vkGetPhysicalDeviceProperties2( VkPhysicalDeviceProperties2* pProperties );
         void vkGetPhysicalDeviceFeatures( VkPhysicalDeviceFeatures* pFeatures );
         void vkGetPhysicalDeviceFeatures2( VkPhysicalDeviceFeatures2* pFeatures );
+        void vkGetPhysicalDeviceFormatProperties( VkFormat format, VkFormatProperties* pFormatProperties );
+        void vkGetPhysicalDeviceFormatProperties2( VkFormat format, VkFormatProperties2* pFormatProperties );
+        VkResult vkGetPhysicalDeviceImageFormatProperties( VkFormat format, VkImageType type, VkImageTiling tiling, VkImageUsageFlags usage, VkImageCreateFlags flags, VkImageFormatProperties* pImageFormatProperties );
+        VkResult vkGetPhysicalDeviceImageFormatProperties2( const VkPhysicalDeviceImageFormatInfo2* pImageFormatInfo, VkImageFormatProperties2* pImageFormatProperties );
         void vkGetPhysicalDeviceMemoryProperties( VkPhysicalDeviceMemoryProperties* pMemoryProperties );
         void vkGetPhysicalDeviceQueueFamilyProperties( uint32_t* pQueueFamilyPropertyCount, VkQueueFamilyProperties* pQueueFamilyProperties );
+        void vkGetPhysicalDeviceExternalBufferProperties( const VkPhysicalDeviceExternalBufferInfo* pExternalBufferInfo, VkExternalBufferProperties* pExternalBufferProperties );
+
+#ifdef VK_KHR_calibrated_timestamps
+        VkResult vkGetPhysicalDeviceCalibrateableTimeDomainsKHR( uint32_t* pTimeDomainCount, VkTimeDomainKHR* pTimeDomains );
+#endif
+
+#ifdef VK_EXT_calibrated_timestamps
+        VkResult vkGetPhysicalDeviceCalibrateableTimeDomainsEXT( uint32_t* pTimeDomainCount, VkTimeDomainEXT* pTimeDomains );
+#endif
+
+#ifdef VK_KHR_performance_query
+        VkResult vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR( uint32_t queueFamilyIndex, uint32_t* pCounterCount, VkPerformanceCounterKHR* pCounters, VkPerformanceCounterDescriptionKHR* pCounterDescriptions );
+        void vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR( const VkQueryPoolPerformanceCreateInfoKHR* pPerformanceQueryCreateInfo, uint32_t* pNumPasses );
+#endif
 
 #ifdef VK_KHR_win32_surface
         VkBool32 vkGetPhysicalDeviceWin32PresentationSupportKHR( uint32_t queueFamilyIndex );
@@ -0,0 +1,190 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_pipeline.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace vkmock
+{
+    // Host kernels take precedence over the SPIR-V code. Modules that cannot be interpreted
+    // create pipelines that do not execute any code.
+    Pipeline::Pipeline( const VkComputePipelineCreateInfo& createInfo )
+        : m_BindPoint( VK_PIPELINE_BIND_POINT_COMPUTE )
+        , m_pfnKernel( nullptr )
+        , m_pKernelUserData( nullptr )
+        , m_Program( g_CurrentAllocator )
+        , m_Graphics()
+    {
+        const VkPipelineShaderStageCreateInfo& stage = createInfo.stage;
+        const uint32_t* pCode = nullptr;
+        size_t codeSize = 0;
+
+        if( stage.module )
+        {
+            m_pfnKernel = stage.module->m_pfnKernel;
+            m_pKernelUserData = stage.module->m_pKernelUserData;
+
+            pCode = stage.module->m_Code.data();
+            codeSize = stage.module->m_Code.size() * sizeof( uint32_t );
+        }
+        else if( const VkShaderModuleCreateInfo* pModuleCreateInfo = vk_find_struct<VkShaderModuleCreateInfo>(
+                     stage.pNext, VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO ) )
+        {
+            pCode = pModuleCreateInfo->pCode;
+            codeSize = pModuleCreateInfo->codeSize;
+        }
+
+        if( !m_pfnKernel && pCode &&
+            m_Program.Decode( pCode, codeSize / sizeof( uint32_t ), stage.pName, stage.pSpecializationInfo ) )
+        {
+            m_pfnKernel = SpirvProgram::Execute;
+            m_pKernelUserData = &m_Program;
+        }
+    }
+
+    // Only the host kernels are executed in the graphics pipelines, stages with SPIR-V code
+    // are replaced with the fixed-function fallbacks of the software rasterizer.
+    Pipeline::Pipeline( const VkGraphicsPipelineCreateInfo& createInfo )
+        : m_BindPoint( VK_PIPELINE_BIND_POINT_GRAPHICS )
+        , m_pfnKernel( nullptr )
+        , m_pKernelUserData( nullptr )
+        , m_Program( g_CurrentAllocator )
+        , m_Graphics()
+    {
+        GraphicsPipelineState& state = m_Graphics;
+        state.m_Topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        state.m_CullMode = VK_CULL_MODE_NONE;
+        state.m_FrontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        state.m_DepthCompareOp = VK_COMPARE_OP_ALWAYS;
+        state.m_VaryingCount = 4;
+
+        for( uint32_t i = 0; i < createInfo.stageCount; ++i )
+        {
+            const VkPipelineShaderStageCreateInfo& stage = createInfo.pStages[ i ];
+            if( !stage.module )
+            {
+                continue;
+            }
+
+            if( stage.stage == VK_SHADER_STAGE_VERTEX_BIT && stage.module->m_pfnVertexKernel )
+            {
+                state.m_pfnVertexKernel = stage.module->m_pfnVertexKernel;
+                state.m_pVertexKernelUserData = stage.module->m_pKernelUserData;
+                state.m_VaryingCount = stage.module->m_VaryingCount;
+            }
+
+            if( stage.stage == VK_SHADER_STAGE_FRAGMENT_BIT && stage.module->m_pfnFragmentKernel )
+            {
+                state.m_pfnFragmentKernel = stage.module->m_pfnFragmentKernel;
+                state.m_pFragmentKernelUserData = stage.module->m_pKernelUserData;
+            }
+        }
+
+        if( const VkPipelineVertexInputStateCreateInfo* pVertexInputState = createInfo.pVertexInputState )
+        {
+            for( uint32_t i = 0; i < pVertexInputState->vertexBindingDescriptionCount; ++i )
+            {
+                const VkVertexInputBindingDescription& binding = pVertexInputState->pVertexBindingDescriptions[ i ];
+                if( binding.binding < g_MaxVertexBindings )
+                {
+                    state.m_BindingStrides[ binding.binding ] = binding.stride;
+                    state.m_BindingInputRates[ binding.binding ] = binding.inputRate;
+                }
+            }
+
+            for( uint32_t i = 0; i < pVertexInputState->vertexAttributeDescriptionCount; ++i )
+            {
+                const VkVertexInputAttributeDescription& attribute = pVertexInputState->pVertexAttributeDescriptions[ i ];
+                if( attribute.location < g_MaxVertexAttributes && attribute.binding < g_MaxVertexBindings )
+                {
+                    VertexAttribute& vertexAttribute = state.m_Attributes[ attribute.location ];
+                    vertexAttribute.m_Binding = attribute.binding;
+                    vertexAttribute.m_Offset = attribute.offset;
+                    vertexAttribute.m_Format = GetTexelFormat( attribute.format, VK_IMAGE_ASPECT_COLOR_BIT );
+                    state.m_AttributeMask |= 1U << attribute.location;
+                }
+            }
+        }
+
+        if( const VkPipelineInputAssemblyStateCreateInfo* pInputAssemblyState = createInfo.pInputAssemblyState )
+        {
+            state.m_Topology = pInputAssemblyState->topology;
+        }
+
+        if( const VkPipelineRasterizationStateCreateInfo* pRasterizationState = createInfo.pRasterizationState )
+        {
+            state.m_RasterizerDiscardEnable = pRasterizationState->rasterizerDiscardEnable;
+            state.m_DepthClampEnable = pRasterizationState->depthClampEnable;
+            state.m_CullMode = pRasterizationState->cullMode;
+            state.m_FrontFace = pRasterizationState->frontFace;
+        }
+
+        if( const VkPipelineDepthStencilStateCreateInfo* pDepthStencilState = createInfo.pDepthStencilState )
+        {
+            state.m_DepthTestEnable = pDepthStencilState->depthTestEnable;
+            state.m_DepthWriteEnable = pDepthStencilState->depthTestEnable && pDepthStencilState->depthWriteEnable;
+            state.m_DepthCompareOp = pDepthStencilState->depthCompareOp;
+        }
+
+        if( const VkPipelineColorBlendStateCreateInfo* pColorBlendState = createInfo.pColorBlendState )
+        {
+            state.m_ColorBlendAttachmentCount = std::min( pColorBlendState->attachmentCount, g_MaxColorAttachments );
+            memcpy( state.m_ColorBlendAttachments, pColorBlendState->pAttachments,
+                state.m_ColorBlendAttachmentCount * sizeof( VkPipelineColorBlendAttachmentState ) );
+            memcpy( state.m_BlendConstants, pColorBlendState->blendConstants, sizeof( state.m_BlendConstants ) );
+        }
+
+        if( const VkPipelineViewportStateCreateInfo* pViewportState = createInfo.pViewportState )
+        {
+            if( pViewportState->pViewports && pViewportState->viewportCount )
+            {
+                state.m_Viewport = pViewportState->pViewports[ 0 ];
+            }
+
+            if( pViewportState->pScissors && pViewportState->scissorCount )
+            {
+                state.m_Scissor = pViewportState->pScissors[ 0 ];
+            }
+        }
+
+        if( const VkPipelineDynamicStateCreateInfo* pDynamicState = createInfo.pDynamicState )
+        {
+            for( uint32_t i = 0; i < pDynamicState->dynamicStateCount; ++i )
+            {
+                switch( pDynamicState->pDynamicStates[ i ] )
+                {
+                case VK_DYNAMIC_STATE_VIEWPORT:
+                    state.m_DynamicStateMask |= eGraphicsDynamicStateViewport;
+                    break;
+                case VK_DYNAMIC_STATE_SCISSOR:
+                    state.m_DynamicStateMask |= eGraphicsDynamicStateScissor;
+                    break;
+                case VK_DYNAMIC_STATE_BLEND_CONSTANTS:
+                    state.m_DynamicStateMask |= eGraphicsDynamicStateBlendConstants;
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+    }
+}
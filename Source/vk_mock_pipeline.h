@@ -0,0 +1,61 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "vk_mock.h"
+#include "vk_mock_icd_base.h"
+#include "vk_mock_raster.h"
+#include "vk_mock_shader_module.h"
+#include "vk_mock_spirv.h"
+
+namespace vkmock
+{
+    struct PipelineLayout
+    {
+        uint32_t m_SetLayoutCount;
+
+        explicit PipelineLayout( const VkPipelineLayoutCreateInfo& createInfo )
+            : m_SetLayoutCount( createInfo.setLayoutCount )
+        {
+        }
+    };
+
+    struct Pipeline
+    {
+        VkPipelineBindPoint m_BindPoint;
+        PFN_vkMockComputeKernelEXT m_pfnKernel;
+        void* m_pKernelUserData;
+        SpirvProgram m_Program;
+        GraphicsPipelineState m_Graphics;
+
+        explicit Pipeline( const VkComputePipelineCreateInfo& createInfo );
+        explicit Pipeline( const VkGraphicsPipelineCreateInfo& createInfo );
+    };
+}
+
+struct VkPipelineLayout_T : vkmock::PipelineLayout
+{
+    using PipelineLayout::PipelineLayout;
+};
+
+struct VkPipeline_T : vkmock::Pipeline
+{
+    using Pipeline::Pipeline;
+};
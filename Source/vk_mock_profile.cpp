@@ -0,0 +1,850 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_profile.h"
+#include "vk_mock_format.h"
+#include "vk_mock_json.h"
+#include "vk_mock_reflection.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace vkmock
+{
+    // "VKMP" in the little-endian byte order.
+    static constexpr uint32_t g_ProfileMagic = 0x504D4B56;
+
+    // Incremented whenever the layout of the compiled profiles or the reflection tables change.
+    static constexpr uint32_t g_ProfileCacheVersion = 4;
+
+    // Size of the largest member patched by the profiles (the device name).
+    static constexpr uint32_t g_MaxMemberSize = 256;
+
+    typedef std::vector<char, vk_stl_allocator<char>>
+        CharVector;
+
+    static uint64_t HashBytes( const void* pData, size_t size )
+    {
+        // FNV-1a
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for( size_t i = 0; i < size; ++i )
+        {
+            hash ^= static_cast<const uint8_t*>( pData )[ i ];
+            hash *= 0x100000001B3ULL;
+        }
+        return hash;
+    }
+
+    static uint64_t HashProfileName( const char* pName )
+    {
+        return HashBytes( pName, pName ? strlen( pName ) : 0 );
+    }
+
+    static bool ReadSourceFile( const char* pFileName, CharVector& source )
+    {
+#ifdef _WIN32
+        struct _stat64 fileInfo;
+        if( _stat64( pFileName, &fileInfo ) )
+        {
+            return false;
+        }
+#else
+        struct stat fileInfo;
+        if( stat( pFileName, &fileInfo ) )
+        {
+            return false;
+        }
+#endif
+
+        FILE* pFile = fopen( pFileName, "rb" );
+        if( !pFile )
+        {
+            return false;
+        }
+
+        source.resize( static_cast<size_t>( fileInfo.st_size ) );
+        const size_t readSize = fread( source.data(), 1, source.size(), pFile );
+        fclose( pFile );
+
+        return readSize == source.size();
+    }
+
+    static size_t GetProfileSize( const ProfileHeader& header )
+    {
+        return sizeof( ProfileHeader ) +
+            size_t( header.patchCount ) * sizeof( ProfilePatch ) +
+            size_t( header.extensionCount ) * sizeof( VkExtensionProperties ) +
+            size_t( header.dataSize );
+    }
+
+    static bool IsPatchOrdered( const ProfilePatch& first, const ProfilePatch& second )
+    {
+        if( first.format != second.format )
+        {
+            return uint32_t( first.format ) < uint32_t( second.format );
+        }
+
+        if( first.sType != second.sType )
+        {
+            return uint32_t( first.sType ) < uint32_t( second.sType );
+        }
+
+        return first.offset < second.offset;
+    }
+
+    /**
+     * @brief
+     *   Checks whether the compiled profile matches the expected header, and whether
+     *   all patches stay within the bounds of the data and of the patched structures.
+     */
+    static bool ValidateProfile( const void* pProfile, size_t size, const ProfileHeader& expectedHeader )
+    {
+        if( size < sizeof( ProfileHeader ) )
+        {
+            return false;
+        }
+
+        const ProfileHeader& header = *static_cast<const ProfileHeader*>( pProfile );
+
+        if( header.magic != expectedHeader.magic ||
+            header.version != expectedHeader.version ||
+            header.headerVersion != expectedHeader.headerVersion ||
+            header.pointerSize != expectedHeader.pointerSize ||
+            header.sourceSize != expectedHeader.sourceSize ||
+            header.sourceHash != expectedHeader.sourceHash ||
+            header.profileNameHash != expectedHeader.profileNameHash )
+        {
+            return false;
+        }
+
+        if( GetProfileSize( header ) != size )
+        {
+            return false;
+        }
+
+        const ProfilePatch* pPatches = reinterpret_cast<const ProfilePatch*>( &header + 1 );
+        for( uint32_t i = 0; i < header.patchCount; ++i )
+        {
+            const ProfilePatch& patch = pPatches[ i ];
+            const ReflectionStructInfo* pStructInfo = FindReflectionStructInfo( patch.sType );
+
+            // sType and pNext of the structures are never patched.
+            if( !pStructInfo ||
+                patch.offset < pStructInfo->pMembers[ 0 ].offset ||
+                uint64_t( patch.offset ) + patch.size > pStructInfo->size ||
+                uint64_t( patch.dataOffset ) + patch.size > header.dataSize )
+            {
+                return false;
+            }
+
+            if( i > 0 && !IsPatchOrdered( pPatches[ i - 1 ], patch ) )
+            {
+                return false;
+            }
+        }
+
+        const VkExtensionProperties* pExtensions = reinterpret_cast<const VkExtensionProperties*>( pPatches + header.patchCount );
+        for( uint32_t i = 0; i < header.extensionCount; ++i )
+        {
+            if( !memchr( pExtensions[ i ].extensionName, 0, VK_MAX_EXTENSION_NAME_SIZE ) )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    template<typename T>
+    static void StoreValue( uint8_t* pData, T value )
+    {
+        memcpy( pData, &value, sizeof( T ) );
+    }
+
+    /**
+     * @brief
+     *   Converts a JSON value to a single element of the member.
+     *   Enums and flags are given by the names of their values, or by the numbers.
+     */
+    static bool StoreMemberValue( const ReflectionMemberInfo& member, const JsonValue& value, uint8_t* pData )
+    {
+        if( member.type == ReflectionType::eEnum && value.m_Type == JsonType::eString )
+        {
+            uint64_t enumValue = 0;
+            if( !member.pEnumInfo || !FindReflectionEnumValue( *member.pEnumInfo, value.m_String.c_str(), &enumValue ) )
+            {
+                return false;
+            }
+
+            StoreValue<uint32_t>( pData, uint32_t( enumValue ) );
+            return true;
+        }
+
+        const bool flags = ( member.type == ReflectionType::eFlags || member.type == ReflectionType::eFlags64 );
+
+        if( flags && ( value.m_Type == JsonType::eArray || value.m_Type == JsonType::eString ) )
+        {
+            const JsonValue* pBits = ( value.m_Type == JsonType::eArray ) ? value.m_Array.data() : &value;
+            const size_t bitCount = ( value.m_Type == JsonType::eArray ) ? value.m_Array.size() : 1;
+
+            uint64_t flagsValue = 0;
+            for( size_t i = 0; i < bitCount; ++i )
+            {
+                uint64_t bit = 0;
+                if( pBits[ i ].m_Type != JsonType::eString ||
+                    !member.pEnumInfo ||
+                    !FindReflectionEnumValue( *member.pEnumInfo, pBits[ i ].m_String.c_str(), &bit ) )
+                {
+                    return false;
+                }
+
+                flagsValue |= bit;
+            }
+
+            if( member.type == ReflectionType::eFlags64 )
+            {
+                StoreValue<uint64_t>( pData, flagsValue );
+            }
+            else
+            {
+                StoreValue<uint32_t>( pData, uint32_t( flagsValue ) );
+            }
+            return true;
+        }
+
+        if( value.m_Type != JsonType::eNumber && value.m_Type != JsonType::eBool )
+        {
+            return false;
+        }
+
+        switch( member.type )
+        {
+        case ReflectionType::eBool32:
+            StoreValue<VkBool32>( pData, value.GetUint64() ? VK_TRUE : VK_FALSE );
+            return true;
+        case ReflectionType::eUint8:
+            StoreValue<uint8_t>( pData, uint8_t( value.GetUint64() ) );
+            return true;
+        case ReflectionType::eInt32:
+            StoreValue<int32_t>( pData, int32_t( value.GetInt64() ) );
+            return true;
+        case ReflectionType::eUint32:
+        case ReflectionType::eEnum:
+        case ReflectionType::eFlags:
+            StoreValue<uint32_t>( pData, uint32_t( value.GetUint64() ) );
+            return true;
+        case ReflectionType::eUint64:
+        case ReflectionType::eFlags64:
+            StoreValue<uint64_t>( pData, value.GetUint64() );
+            return true;
+        case ReflectionType::eSize:
+            StoreValue<size_t>( pData, size_t( value.GetUint64() ) );
+            return true;
+        case ReflectionType::eFloat:
+            StoreValue<float>( pData, float( value.GetDouble() ) );
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * @brief
+     *   Compiles the capabilities of a profile into patches of the structures.
+     *   Members are patched individually, so the values not defined by the profile
+     *   keep the values reported by the mock.
+     */
+    struct ProfileCompiler
+    {
+        struct Patch
+        {
+            ProfilePatch m_Patch;
+            uint32_t m_Order;
+        };
+
+        typedef std::vector<Patch, vk_stl_allocator<Patch>>
+            PatchVector;
+
+        typedef std::vector<uint8_t, vk_stl_allocator<uint8_t>>
+            DataVector;
+
+        typedef std::vector<VkExtensionProperties, vk_stl_allocator<VkExtensionProperties>>
+            ExtensionVector;
+
+        PatchVector m_Patches;
+        DataVector m_Data;
+        ExtensionVector m_Extensions;
+
+        void AddPatch( VkFormat format, VkStructureType sType, uint32_t offset, const uint8_t* pData, uint32_t size )
+        {
+            Patch patch;
+            patch.m_Patch.format = format;
+            patch.m_Patch.sType = sType;
+            patch.m_Patch.offset = offset;
+            patch.m_Patch.size = size;
+            patch.m_Patch.dataOffset = static_cast<uint32_t>( m_Data.size() );
+            patch.m_Order = static_cast<uint32_t>( m_Patches.size() );
+
+            m_Patches.push_back( patch );
+            m_Data.insert( m_Data.end(), pData, pData + size );
+        }
+
+        void CompileMember( const ReflectionMemberInfo& member, VkFormat format, VkStructureType sType, uint32_t structOffset, const JsonValue& value )
+        {
+            const uint32_t offset = structOffset + member.offset;
+
+            if( member.type == ReflectionType::eStruct )
+            {
+                if( value.m_Type == JsonType::eObject )
+                {
+                    CompileStruct( *member.pStructInfo, format, sType, offset, value );
+                }
+                return;
+            }
+
+            uint8_t data[ g_MaxMemberSize ] = {};
+            if( member.size > sizeof( data ) )
+            {
+                return;
+            }
+
+            if( member.type == ReflectionType::eChar )
+            {
+                // Strings always replace the whole array, including the terminator.
+                if( value.m_Type == JsonType::eString )
+                {
+                    memcpy( data, value.m_String.c_str(), std::min<size_t>( value.m_String.size(), member.size - 1 ) );
+                    AddPatch( format, sType, offset, data, member.size );
+                }
+                return;
+            }
+
+            const uint32_t elementSize = GetReflectionTypeSize( member.type );
+            const uint32_t elementCount = member.size / elementSize;
+
+            if( elementCount == 1 )
+            {
+                if( StoreMemberValue( member, value, data ) )
+                {
+                    AddPatch( format, sType, offset, data, member.size );
+                }
+                return;
+            }
+
+            // Arrays may be defined partially, only the leading elements are patched.
+            if( value.m_Type != JsonType::eArray )
+            {
+                return;
+            }
+
+            uint32_t count = 0;
+            while( count < elementCount && count < value.m_Array.size() &&
+                StoreMemberValue( member, value.m_Array[ count ], data + count * elementSize ) )
+            {
+                count++;
+            }
+
+            if( count )
+            {
+                AddPatch( format, sType, offset, data, count * elementSize );
+            }
+        }
+
+        void CompileStruct( const ReflectionStructInfo& structInfo, VkFormat format, VkStructureType sType, uint32_t structOffset, const JsonValue& value )
+        {
+            for( const auto& member : value.m_Object )
+            {
+                const ReflectionMemberInfo* pMemberInfo = FindReflectionMemberInfo( structInfo, member.first.c_str() );
+                if( pMemberInfo )
+                {
+                    CompileMember( *pMemberInfo, format, sType, structOffset, member.second );
+                }
+            }
+        }
+
+        void CompileStructs( const JsonValue* pStructs, VkFormat format = VK_FORMAT_UNDEFINED )
+        {
+            if( !pStructs || pStructs->m_Type != JsonType::eObject )
+            {
+                return;
+            }
+
+            // Structures missing from the reflection tables are ignored.
+            for( const auto& structValue : pStructs->m_Object )
+            {
+                const ReflectionStructInfo* pStructInfo = FindReflectionStructInfo( structValue.first.c_str() );
+                if( pStructInfo && structValue.second.m_Type == JsonType::eObject )
+                {
+                    CompileStruct( *pStructInfo, format, pStructInfo->sType, 0, structValue.second );
+                }
+            }
+        }
+
+        void CompileFormats( const JsonValue* pFormats )
+        {
+            if( !pFormats || pFormats->m_Type != JsonType::eObject )
+            {
+                return;
+            }
+
+            // Formats unknown to the mock are ignored.
+            for( const auto& formatValue : pFormats->m_Object )
+            {
+                VkFormat format = VK_FORMAT_UNDEFINED;
+                if( FindFormat( formatValue.first.c_str(), &format ) && format != VK_FORMAT_UNDEFINED )
+                {
+                    CompileStructs( &formatValue.second, format );
+                }
+            }
+        }
+
+        void CompileExtensions( const JsonValue* pExtensions )
+        {
+            if( !pExtensions || pExtensions->m_Type != JsonType::eObject )
+            {
+                return;
+            }
+
+            for( const auto& extension : pExtensions->m_Object )
+            {
+                if( extension.first.size() >= VK_MAX_EXTENSION_NAME_SIZE )
+                {
+                    continue;
+                }
+
+                VkExtensionProperties properties = {};
+                memcpy( properties.extensionName, extension.first.c_str(), extension.first.size() );
+                properties.specVersion = uint32_t( extension.second.GetUint64() );
+
+                auto it = std::find_if( m_Extensions.begin(), m_Extensions.end(),
+                    [&]( const VkExtensionProperties& other ) { return !strcmp( other.extensionName, properties.extensionName ); } );
+
+                if( it != m_Extensions.end() )
+                {
+                    *it = properties;
+                }
+                else
+                {
+                    m_Extensions.push_back( properties );
+                }
+            }
+        }
+
+        void CompileCapability( const JsonValue& capability )
+        {
+            CompileExtensions( capability.Find( "extensions" ) );
+            CompileStructs( capability.Find( "features" ) );
+            CompileStructs( capability.Find( "properties" ) );
+            CompileFormats( capability.Find( "formats" ) );
+        }
+
+        void CompileApiVersion( const JsonValue* pApiVersion )
+        {
+            uint32_t major = 0, minor = 0, patch = 0;
+            if( !pApiVersion ||
+                pApiVersion->m_Type != JsonType::eString ||
+                sscanf( pApiVersion->m_String.c_str(), "%u.%u.%u", &major, &minor, &patch ) != 3 )
+            {
+                return;
+            }
+
+            const ReflectionStructInfo* pStructInfo = FindReflectionStructInfo( "VkPhysicalDeviceProperties" );
+            const ReflectionMemberInfo* pMemberInfo = FindReflectionMemberInfo( *pStructInfo, "apiVersion" );
+
+            uint8_t data[ sizeof( uint32_t ) ];
+            StoreValue<uint32_t>( data, VK_MAKE_API_VERSION( 0, major, minor, patch ) );
+            AddPatch( VK_FORMAT_UNDEFINED, pStructInfo->sType, pMemberInfo->offset, data, sizeof( data ) );
+        }
+
+        bool CompileProfile( const JsonValue& root, const char* pProfileName )
+        {
+            const JsonValue* pProfiles = root.Find( "profiles" );
+            if( !pProfiles || pProfiles->m_Type != JsonType::eObject || pProfiles->m_Object.empty() )
+            {
+                return false;
+            }
+
+            const JsonValue* pProfile = pProfileName ? pProfiles->Find( pProfileName ) : &pProfiles->m_Object.front().second;
+            if( !pProfile || pProfile->m_Type != JsonType::eObject )
+            {
+                return false;
+            }
+
+            CompileApiVersion( pProfile->Find( "api-version" ) );
+
+            const JsonValue* pCapabilityNames = pProfile->Find( "capabilities" );
+            if( !pCapabilityNames )
+            {
+                return true;
+            }
+
+            const JsonValue* pCapabilities = root.Find( "capabilities" );
+            if( pCapabilityNames->m_Type != JsonType::eArray || !pCapabilities )
+            {
+                return false;
+            }
+
+            for( const JsonValue& capabilityName : pCapabilityNames->m_Array )
+            {
+                // Alternative capabilities are given as arrays, the first one is used.
+                const JsonValue* pName = &capabilityName;
+                if( pName->m_Type == JsonType::eArray && !pName->m_Array.empty() )
+                {
+                    pName = &pName->m_Array.front();
+                }
+
+                const JsonValue* pCapability = ( pName->m_Type == JsonType::eString ) ? pCapabilities->Find( pName->m_String.c_str() ) : nullptr;
+                if( !pCapability || pCapability->m_Type != JsonType::eObject )
+                {
+                    return false;
+                }
+
+                CompileCapability( *pCapability );
+            }
+
+            return true;
+        }
+
+        void Serialize( ProfileHeader header, DeviceProfile::Blob& blob )
+        {
+            // Later patches of the same member replace the earlier ones.
+            std::sort( m_Patches.begin(), m_Patches.end(),
+                []( const Patch& first, const Patch& second ) {
+                    if( IsPatchOrdered( first.m_Patch, second.m_Patch ) ) return true;
+                    if( IsPatchOrdered( second.m_Patch, first.m_Patch ) ) return false;
+                    return first.m_Order < second.m_Order;
+                } );
+
+            PatchVector patches;
+            for( const Patch& patch : m_Patches )
+            {
+                if( !patches.empty() && !IsPatchOrdered( patches.back().m_Patch, patch.m_Patch ) )
+                {
+                    patches.back() = patch;
+                }
+                else
+                {
+                    patches.push_back( patch );
+                }
+            }
+
+            header.patchCount = static_cast<uint32_t>( patches.size() );
+            header.extensionCount = static_cast<uint32_t>( m_Extensions.size() );
+            header.dataSize = 0;
+
+            for( const Patch& patch : patches )
+            {
+                header.dataSize += patch.m_Patch.size;
+            }
+
+            const size_t size = GetProfileSize( header );
+            blob.assign( ( size + sizeof( uint64_t ) - 1 ) / sizeof( uint64_t ), 0 );
+
+            uint8_t* pBlob = reinterpret_cast<uint8_t*>( blob.data() );
+            memcpy( pBlob, &header, sizeof( header ) );
+
+            ProfilePatch* pPatches = reinterpret_cast<ProfilePatch*>( pBlob + sizeof( header ) );
+            VkExtensionProperties* pExtensions = reinterpret_cast<VkExtensionProperties*>( pPatches + header.patchCount );
+            uint8_t* pData = reinterpret_cast<uint8_t*>( pExtensions + header.extensionCount );
+
+            uint32_t dataOffset = 0;
+            for( uint32_t i = 0; i < header.patchCount; ++i )
+            {
+                const ProfilePatch& patch = patches[ i ].m_Patch;
+                memcpy( pData + dataOffset, m_Data.data() + patch.dataOffset, patch.size );
+
+                pPatches[ i ] = patch;
+                pPatches[ i ].dataOffset = dataOffset;
+                dataOffset += patch.size;
+            }
+
+            std::copy( m_Extensions.begin(), m_Extensions.end(), pExtensions );
+        }
+    };
+
+    static bool CompileProfile( const VkMockPhysicalDeviceProfileInfoEXT& info, const ProfileHeader& header, const CharVector& source, DeviceProfile::Blob& blob )
+    {
+        JsonValue root;
+        if( !ParseJson( source.data(), source.data() + source.size(), root ) )
+        {
+            return false;
+        }
+
+        ProfileCompiler compiler;
+        if( !compiler.CompileProfile( root, info.pProfileName ) )
+        {
+            return false;
+        }
+
+        compiler.Serialize( header, blob );
+        return true;
+    }
+
+    static void WriteCacheFile( const char* pCacheFileName, const void* pProfile, size_t size )
+    {
+        // The cache is written to a temporary file first, so that other processes
+        // never map a partially written profile.
+#ifdef _WIN32
+        const int processId = _getpid();
+#else
+        const int processId = getpid();
+#endif
+
+        CharVector tempFileName( strlen( pCacheFileName ) + 32 );
+        snprintf( tempFileName.data(), tempFileName.size(), "%s.%d.tmp", pCacheFileName, processId );
+
+        FILE* pFile = fopen( tempFileName.data(), "wb" );
+        if( !pFile )
+        {
+            return;
+        }
+
+        const bool written = ( fwrite( pProfile, 1, size, pFile ) == size );
+
+        if( fclose( pFile ) || !written )
+        {
+            remove( tempFileName.data() );
+            return;
+        }
+
+#ifdef _WIN32
+        if( !MoveFileExA( tempFileName.data(), pCacheFileName, MOVEFILE_REPLACE_EXISTING ) )
+#else
+        if( rename( tempFileName.data(), pCacheFileName ) )
+#endif
+        {
+            remove( tempFileName.data() );
+        }
+    }
+
+    static void* MapCacheFile( const char* pCacheFileName, size_t* pSize )
+    {
+        void* pMapping = nullptr;
+
+#ifdef _WIN32
+        HANDLE hFile = CreateFileA( pCacheFileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+        if( hFile == INVALID_HANDLE_VALUE )
+        {
+            return nullptr;
+        }
+
+        LARGE_INTEGER fileSize;
+        if( GetFileSizeEx( hFile, &fileSize ) && fileSize.QuadPart > 0 )
+        {
+            HANDLE hMapping = CreateFileMappingA( hFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+            if( hMapping )
+            {
+                pMapping = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+                CloseHandle( hMapping );
+            }
+
+            *pSize = static_cast<size_t>( fileSize.QuadPart );
+        }
+
+        CloseHandle( hFile );
+#else
+        const int fd = open( pCacheFileName, O_RDONLY );
+        if( fd < 0 )
+        {
+            return nullptr;
+        }
+
+        struct stat fileInfo;
+        if( !fstat( fd, &fileInfo ) && fileInfo.st_size > 0 )
+        {
+            pMapping = mmap( nullptr, size_t( fileInfo.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+            if( pMapping == MAP_FAILED )
+            {
+                pMapping = nullptr;
+            }
+
+            *pSize = size_t( fileInfo.st_size );
+        }
+
+        close( fd );
+#endif
+
+        return pMapping;
+    }
+
+    static void UnmapCacheFile( void* pMapping, size_t size )
+    {
+#ifdef _WIN32
+        UnmapViewOfFile( pMapping );
+#else
+        munmap( pMapping, size );
+#endif
+    }
+
+    DeviceProfile::DeviceProfile()
+        : m_Blob()
+        , m_pMapping( nullptr )
+        , m_MappingSize( 0 )
+        , m_pHeader( nullptr )
+        , m_pPatches( nullptr )
+        , m_pExtensions( nullptr )
+        , m_pData( nullptr )
+    {
+    }
+
+    DeviceProfile::~DeviceProfile()
+    {
+        Reset();
+    }
+
+    VkResult DeviceProfile::Load( const VkMockPhysicalDeviceProfileInfoEXT& info )
+    {
+        ProfileHeader header = {};
+        header.magic = g_ProfileMagic;
+        header.version = g_ProfileCacheVersion;
+        header.headerVersion = VK_HEADER_VERSION;
+        header.pointerSize = sizeof( void* );
+        header.profileNameHash = HashProfileName( info.pProfileName );
+
+        // The source is hashed rather than identified by its modification time, which may not change
+        // when the file is rewritten with the same size in quick succession.
+        CharVector source;
+        if( !info.pFileName || !ReadSourceFile( info.pFileName, source ) )
+        {
+            return VK_ERROR_INITIALIZATION_FAILED;
+        }
+
+        header.sourceSize = source.size();
+        header.sourceHash = HashBytes( source.data(), source.size() );
+
+        const void* pProfile = nullptr;
+
+        if( info.pCacheFileName )
+        {
+            size_t mappingSize = 0;
+            void* pMapping = MapCacheFile( info.pCacheFileName, &mappingSize );
+
+            if( pMapping && !ValidateProfile( pMapping, mappingSize, header ) )
+            {
+                UnmapCacheFile( pMapping, mappingSize );
+                pMapping = nullptr;
+            }
+
+            if( pMapping )
+            {
+                Reset();
+                m_pMapping = pMapping;
+                m_MappingSize = mappingSize;
+                pProfile = pMapping;
+            }
+        }
+
+        if( !pProfile )
+        {
+            Blob blob;
+            if( !CompileProfile( info, header, source, blob ) )
+            {
+                return VK_ERROR_INITIALIZATION_FAILED;
+            }
+
+            Reset();
+            m_Blob.swap( blob );
+            pProfile = m_Blob.data();
+
+            if( info.pCacheFileName )
+            {
+                WriteCacheFile( info.pCacheFileName, pProfile, GetProfileSize( *static_cast<const ProfileHeader*>( pProfile ) ) );
+            }
+        }
+
+        m_pHeader = static_cast<const ProfileHeader*>( pProfile );
+        m_pPatches = reinterpret_cast<const ProfilePatch*>( m_pHeader + 1 );
+        m_pExtensions = reinterpret_cast<const VkExtensionProperties*>( m_pPatches + m_pHeader->patchCount );
+        m_pData = reinterpret_cast<const uint8_t*>( m_pExtensions + m_pHeader->extensionCount );
+        return VK_SUCCESS;
+    }
+
+    void DeviceProfile::Reset()
+    {
+        if( m_pMapping )
+        {
+            UnmapCacheFile( m_pMapping, m_MappingSize );
+        }
+
+        m_Blob.clear();
+        m_Blob.shrink_to_fit();
+        m_pMapping = nullptr;
+        m_MappingSize = 0;
+        m_pHeader = nullptr;
+        m_pPatches = nullptr;
+        m_pExtensions = nullptr;
+        m_pData = nullptr;
+    }
+
+    void DeviceProfile::Apply( VkStructureType sType, void* pStruct ) const
+    {
+        Apply( VK_FORMAT_UNDEFINED, sType, pStruct );
+    }
+
+    void DeviceProfile::Apply( VkFormat format, VkStructureType sType, void* pStruct ) const
+    {
+        if( !m_pHeader )
+        {
+            return;
+        }
+
+        ProfilePatch key = {};
+        key.format = format;
+        key.sType = sType;
+
+        const ProfilePatch* pEnd = m_pPatches + m_pHeader->patchCount;
+        const ProfilePatch* pPatch = std::lower_bound( m_pPatches, pEnd, key, &IsPatchOrdered );
+
+        for( ; pPatch != pEnd && pPatch->format == format && pPatch->sType == sType; ++pPatch )
+        {
+            memcpy( static_cast<uint8_t*>( pStruct ) + pPatch->offset, m_pData + pPatch->dataOffset, pPatch->size );
+        }
+    }
+
+    bool DeviceProfile::SupportsExtension( const char* pName ) const
+    {
+        // Profiles without extensions do not restrict the extensions of the device.
+        if( !m_pHeader || !m_pHeader->extensionCount )
+        {
+            return true;
+        }
+
+        for( uint32_t i = 0; i < m_pHeader->extensionCount; ++i )
+        {
+            if( !strcmp( m_pExtensions[ i ].extensionName, pName ) )
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "vk_mock_icd_helpers.h"
+#include "vk_mock.h"
+#include <vector>
+
+namespace vkmock
+{
+    /**
+     * @brief
+     *   Header of a compiled device profile.
+     *   The source file size and hash identify the contents of the JSON file the profile
+     *   was compiled from, so that stale cache files are recompiled.
+     */
+    struct ProfileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t headerVersion;
+        uint32_t pointerSize;
+        uint32_t patchCount;
+        uint32_t extensionCount;
+        uint32_t dataSize;
+        uint32_t reserved;
+        uint64_t sourceSize;
+        uint64_t sourceHash;
+        uint64_t profileNameHash;
+    };
+
+    /**
+     * @brief
+     *   Replaces size bytes at the offset of the structure identified by sType
+     *   with the bytes at dataOffset in the data of the profile.
+     *   Patches of the format properties are keyed by the format as well,
+     *   patches of the device structures use VK_FORMAT_UNDEFINED.
+     */
+    struct ProfilePatch
+    {
+        VkFormat format;
+        VkStructureType sType;
+        uint32_t offset;
+        uint32_t size;
+        uint32_t dataOffset;
+    };
+
+    /**
+     * @brief
+     *   Device profile compiled from a Vulkan-Profiles JSON file.
+     *   The compiled profile is a single blob with the header, the patches sorted by format and sType,
+     *   the extensions and the data of the patches, so it can be written to a cache file
+     *   and mapped directly by the later loads.
+     */
+    struct DeviceProfile
+    {
+        typedef std::vector<uint64_t, vk_stl_allocator<uint64_t>>
+            Blob;
+
+        Blob m_Blob;
+        void* m_pMapping;
+        size_t m_MappingSize;
+
+        const ProfileHeader* m_pHeader;
+        const ProfilePatch* m_pPatches;
+        const VkExtensionProperties* m_pExtensions;
+        const uint8_t* m_pData;
+
+        DeviceProfile();
+        ~DeviceProfile();
+
+        DeviceProfile( const DeviceProfile& ) = delete;
+        DeviceProfile& operator=( const DeviceProfile& ) = delete;
+
+        VkResult Load( const VkMockPhysicalDeviceProfileInfoEXT& info );
+        void Reset();
+
+        bool IsLoaded() const { return m_pHeader != nullptr; }
+
+        void Apply( VkStructureType sType, void* pStruct ) const;
+        void Apply( VkFormat format, VkStructureType sType, void* pStruct ) const;
+        bool SupportsExtension( const char* pName ) const;
+    };
+}
@@ -0,0 +1,336 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_query_pool.h"
+#include "vk_mock_device.h"
+#include "vk_mock_physical_device.h"
+#include "vk_mock_queue.h"
+#include "vk_mock_memory_ops.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace vkmock
+{
+    static constexpr VkQueryPipelineStatisticFlags g_SupportedPipelineStatistics = 0x7FF;
+
+    static const VkQueryPoolPerformanceCreateInfoKHR* GetPerformanceCreateInfo( const VkQueryPoolCreateInfo& createInfo )
+    {
+        return vk_find_struct<VkQueryPoolPerformanceCreateInfoKHR>(
+            createInfo.pNext, VK_STRUCTURE_TYPE_QUERY_POOL_PERFORMANCE_CREATE_INFO_KHR );
+    }
+
+    static uint32_t GetQueryValueCount( const VkQueryPoolCreateInfo& createInfo )
+    {
+        if( createInfo.queryType == VK_QUERY_TYPE_PERFORMANCE_QUERY_KHR )
+        {
+            const VkQueryPoolPerformanceCreateInfoKHR* pPerformanceCreateInfo = GetPerformanceCreateInfo( createInfo );
+            return pPerformanceCreateInfo ? pPerformanceCreateInfo->counterIndexCount : 0;
+        }
+
+        if( createInfo.queryType != VK_QUERY_TYPE_PIPELINE_STATISTICS )
+        {
+            return 1;
+        }
+
+        // Each enabled statistic writes one value.
+        uint32_t count = 0;
+        for( VkQueryPipelineStatisticFlags flags = createInfo.pipelineStatistics & g_SupportedPipelineStatistics; flags; flags &= flags - 1 )
+        {
+            count++;
+        }
+
+        return count;
+    }
+
+    // Geometry and tessellation stages are not supported, so their statistics are always zero.
+    static uint64_t GetPipelineStatistic( const DrawCounters& counters, VkQueryPipelineStatisticFlagBits statistic )
+    {
+        switch( statistic )
+        {
+        case VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT:
+            return counters.m_VertexCount.load( std::memory_order_relaxed );
+        case VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT:
+        case VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT:
+        case VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT:
+            return counters.m_PrimitiveCount.load( std::memory_order_relaxed );
+        case VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT:
+            return counters.m_VertexShaderInvocations.load( std::memory_order_relaxed );
+        case VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT:
+            return counters.m_FragmentShaderInvocations.load( std::memory_order_relaxed );
+        case VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT:
+            return counters.m_ComputeShaderInvocations.load( std::memory_order_relaxed );
+        default:
+            return 0;
+        }
+    }
+
+    static void WriteValue( uint8_t* pDst, uint64_t value, bool write64 )
+    {
+        if( write64 )
+        {
+            memcpy( pDst, &value, sizeof( value ) );
+        }
+        else
+        {
+            const uint32_t value32 = static_cast<uint32_t>( value );
+            memcpy( pDst, &value32, sizeof( value32 ) );
+        }
+    }
+
+    QueryPool::QueryPool( VkDevice device, const VkQueryPoolCreateInfo& createInfo )
+        : m_QueryType( createInfo.queryType )
+        , m_QueryCount( createInfo.queryCount )
+        , m_PipelineStatistics( createInfo.pipelineStatistics & g_SupportedPipelineStatistics )
+        , m_ValueCount( GetQueryValueCount( createInfo ) )
+        , m_RequiredPasses( 0 )
+        , m_WaiterCount( 0 )
+        , m_Values( size_t( createInfo.queryCount ) * m_ValueCount, 0, g_CurrentAllocator )
+        , m_BeginValues( g_CurrentAllocator )
+        , m_Availability( createInfo.queryCount, 0, g_CurrentAllocator )
+        , m_Counters( g_CurrentAllocator )
+        , m_CounterPasses( g_CurrentAllocator )
+        , m_EndedPasses( g_CurrentAllocator )
+    {
+        // Timestamps are written at once, other queries keep the counters sampled at the beginning.
+        if( m_QueryType != VK_QUERY_TYPE_TIMESTAMP )
+        {
+            m_BeginValues.resize( m_Values.size() );
+        }
+
+        // Counter indices are resolved at creation, so the queries do not depend on later changes of the counter set.
+        if( m_QueryType == VK_QUERY_TYPE_PERFORMANCE_QUERY_KHR && m_ValueCount )
+        {
+            const VkQueryPoolPerformanceCreateInfoKHR& performanceCreateInfo = *GetPerformanceCreateInfo( createInfo );
+            const PerformanceCounterSet& counterSet = device->m_PhysicalDevice->m_PerformanceCounters;
+
+            m_Counters.resize( m_ValueCount );
+            m_CounterPasses.resize( m_ValueCount );
+            m_EndedPasses.resize( m_QueryCount, 0 );
+
+            for( uint32_t i = 0; i < m_ValueCount; ++i )
+            {
+                const uint32_t counterIndex = performanceCreateInfo.pCounterIndices[ i ];
+                m_Counters[ i ] = counterSet.m_Counters[ counterIndex ];
+                m_CounterPasses[ i ] = static_cast<uint8_t>( counterSet.GetCounterPass( counterIndex ) );
+                m_RequiredPasses |= 1U << m_CounterPasses[ i ];
+            }
+        }
+    }
+
+    void QueryPool::Reset( uint32_t firstQuery, uint32_t queryCount )
+    {
+        std::scoped_lock lock( m_Mutex );
+
+        if( firstQuery >= m_QueryCount )
+        {
+            return;
+        }
+
+        queryCount = std::min( queryCount, m_QueryCount - firstQuery );
+
+        memset( m_Availability.data() + firstQuery, 0, queryCount );
+
+        if( !m_EndedPasses.empty() )
+        {
+            std::fill_n( m_EndedPasses.data() + firstQuery, queryCount, 0 );
+        }
+
+        memset( m_Values.data() + size_t( firstQuery ) * m_ValueCount, 0, size_t( queryCount ) * m_ValueCount * sizeof( uint64_t ) );
+    }
+
+    void QueryPool::Begin( VkQueue queue, uint32_t query )
+    {
+        std::scoped_lock lock( m_Mutex );
+
+        if( query < m_QueryCount && !m_BeginValues.empty() )
+        {
+            ReadCounters( queue, m_BeginValues.data() + size_t( query ) * m_ValueCount );
+        }
+    }
+
+    void QueryPool::End( VkQueue queue, uint32_t query )
+    {
+        std::scoped_lock lock( m_Mutex );
+
+        if( query >= m_QueryCount || m_BeginValues.empty() )
+        {
+            return;
+        }
+
+        uint64_t* pValues = m_Values.data() + size_t( query ) * m_ValueCount;
+        const uint64_t* pBeginValues = m_BeginValues.data() + size_t( query ) * m_ValueCount;
+
+        ReadCounters( queue, pValues );
+
+        for( uint32_t i = 0; i < m_ValueCount; ++i )
+        {
+            if( IsSampled( queue, i ) )
+            {
+                pValues[ i ] -= pBeginValues[ i ];
+            }
+        }
+
+        if( m_EndedPasses.empty() )
+        {
+            return SetAvailable( query );
+        }
+
+        m_EndedPasses[ query ] |= 1U << queue->m_CounterPassIndex;
+
+        if( m_EndedPasses[ query ] == m_RequiredPasses )
+        {
+            SetAvailable( query );
+        }
+    }
+
+    void QueryPool::WriteTimestamp( uint32_t query, uint64_t timestamp )
+    {
+        std::scoped_lock lock( m_Mutex );
+
+        if( query < m_QueryCount )
+        {
+            m_Values[ size_t( query ) * m_ValueCount ] = timestamp;
+            SetAvailable( query );
+        }
+    }
+
+    VkResult QueryPool::GetResults( uint32_t firstQuery, uint32_t queryCount, void* pData, VkDeviceSize stride, VkQueryResultFlags flags )
+    {
+        std::unique_lock lock( m_Mutex );
+
+        if( firstQuery >= m_QueryCount )
+        {
+            return VK_SUCCESS;
+        }
+
+        queryCount = std::min( queryCount, m_QueryCount - firstQuery );
+
+        const uint8_t* pAvailability = m_Availability.data() + firstQuery;
+
+        // Queries usually become available in order, so the scan continues from the query
+        // that has been waited for, and the thread wakes up at most once per query.
+        if( flags & VK_QUERY_RESULT_WAIT_BIT )
+        {
+            m_WaiterCount++;
+
+            for( uint32_t i = 0; i < queryCount; ++i )
+            {
+                m_QueryAvailable.wait( lock, [&] { return pAvailability[ i ] != 0; } );
+            }
+
+            m_WaiterCount--;
+        }
+
+        // Results of the performance queries are always written as VkPerformanceCounterResultKHR.
+        const bool allAvailable = ( memchr( pAvailability, 0, queryCount ) == nullptr );
+        const bool write64 = ( flags & VK_QUERY_RESULT_64_BIT ) || m_QueryType == VK_QUERY_TYPE_PERFORMANCE_QUERY_KHR;
+        const bool writeAvailability = ( flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT ) != 0;
+        const VkDeviceSize valueSize = write64 ? sizeof( uint64_t ) : sizeof( uint32_t );
+
+        const uint64_t* pValues = m_Values.data() + size_t( firstQuery ) * m_ValueCount;
+
+        // Tightly packed results of the available queries are copied in bulk.
+        if( allAvailable && !writeAvailability && stride == valueSize * m_ValueCount )
+        {
+            const size_t valueCount = size_t( queryCount ) * m_ValueCount;
+
+            if( write64 )
+            {
+                memcpy( pData, pValues, valueCount * sizeof( uint64_t ) );
+            }
+            else
+            {
+                vk_truncate_u64( static_cast<uint32_t*>( pData ), pValues, valueCount );
+            }
+
+            return VK_SUCCESS;
+        }
+
+        uint8_t* pDst = static_cast<uint8_t*>( pData );
+
+        for( uint32_t i = 0; i < queryCount; ++i, pDst += stride )
+        {
+            const bool available = ( pAvailability[ i ] != 0 );
+
+            // Partial results of the unavailable queries are the values written at reset.
+            if( available || ( flags & VK_QUERY_RESULT_PARTIAL_BIT ) )
+            {
+                for( uint32_t v = 0; v < m_ValueCount; ++v )
+                {
+                    WriteValue( pDst + v * valueSize, pValues[ size_t( i ) * m_ValueCount + v ], write64 );
+                }
+            }
+
+            if( writeAvailability )
+            {
+                WriteValue( pDst + m_ValueCount * valueSize, available, write64 );
+            }
+        }
+
+        return allAvailable ? VK_SUCCESS : VK_NOT_READY;
+    }
+
+    bool QueryPool::IsSampled( VkQueue queue, uint32_t valueIndex ) const
+    {
+        return m_CounterPasses.empty() || m_CounterPasses[ valueIndex ] == queue->m_CounterPassIndex;
+    }
+
+    void QueryPool::ReadCounters( VkQueue queue, uint64_t* pValues ) const
+    {
+        const DrawCounters& counters = queue->m_Device->m_DrawCounters;
+
+        if( m_QueryType == VK_QUERY_TYPE_PERFORMANCE_QUERY_KHR )
+        {
+            for( uint32_t i = 0; i < m_ValueCount; ++i )
+            {
+                if( IsSampled( queue, i ) )
+                {
+                    pValues[ i ] = ReadPerformanceCounter( queue->m_Device, m_Counters[ i ] );
+                }
+            }
+            return;
+        }
+
+        if( m_QueryType == VK_QUERY_TYPE_OCCLUSION )
+        {
+            pValues[ 0 ] = counters.m_SamplesPassed.load( std::memory_order_relaxed );
+            return;
+        }
+
+        // Statistics are written in the order of the bits.
+        for( VkQueryPipelineStatisticFlags flags = m_PipelineStatistics; flags; flags &= flags - 1 )
+        {
+            const VkQueryPipelineStatisticFlagBits statistic = static_cast<VkQueryPipelineStatisticFlagBits>( flags & ~( flags - 1 ) );
+            *pValues++ = GetPipelineStatistic( counters, statistic );
+        }
+    }
+
+    void QueryPool::SetAvailable( uint32_t query )
+    {
+        m_Availability[ query ] = 1;
+
+        // Notification is skipped when no thread waits for the results, which is the common case.
+        if( m_WaiterCount )
+        {
+            m_QueryAvailable.notify_all();
+        }
+    }
+}
@@ -19,26 +19,61 @@
 // SOFTWARE.
 
 #pragma once
+#include "vk_mock.h"
 #include "vk_mock_icd_base.h"
 #include "vk_mock_icd_helpers.h"
+#include <condition_variable>
+#include <mutex>
 #include <vector>
 
 namespace vkmock
 {
+    /**
+     * @brief
+     *   Results and availability of the queries in a pool.
+     *   Occlusion, pipeline statistics and performance queries are computed from the device's
+     *   counters sampled at the beginning and at the end of the query.
+     *   Performance queries sample only the counters of the pass the queue executes, and become
+     *   available once all passes have ended.
+     */
     struct QueryPool
     {
-        std::vector<uint64_t, vk_stl_allocator<uint64_t>> m_Timestamps;
-
-        explicit QueryPool( const VkQueryPoolCreateInfo& createInfo )
-            : m_Timestamps( 0, g_CurrentAllocator )
-        {
-            switch( createInfo.queryType )
-            {
-            case VK_QUERY_TYPE_TIMESTAMP:
-                m_Timestamps.resize( createInfo.queryCount );
-                break;
-            }
-        }
+        VkQueryType m_QueryType;
+        uint32_t m_QueryCount;
+        VkQueryPipelineStatisticFlags m_PipelineStatistics;
+        uint32_t m_ValueCount;
+        uint32_t m_RequiredPasses;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_QueryAvailable;
+        uint32_t m_WaiterCount;
+
+        std::vector<uint64_t, vk_stl_allocator<uint64_t>> m_Values;
+        std::vector<uint64_t, vk_stl_allocator<uint64_t>> m_BeginValues;
+        std::vector<uint8_t, vk_stl_allocator<uint8_t>> m_Availability;
+
+        std::vector<VkMockPerformanceCounterEXT, vk_stl_allocator<VkMockPerformanceCounterEXT>> m_Counters;
+        std::vector<uint8_t, vk_stl_allocator<uint8_t>> m_CounterPasses;
+        std::vector<uint32_t, vk_stl_allocator<uint32_t>> m_EndedPasses;
+
+        QueryPool( VkDevice device, const VkQueryPoolCreateInfo& createInfo );
+
+        void Reset( uint32_t firstQuery, uint32_t queryCount );
+        void Begin( VkQueue queue, uint32_t query );
+        void End( VkQueue queue, uint32_t query );
+        void WriteTimestamp( uint32_t query, uint64_t timestamp );
+
+        /**
+         * @brief
+         *   Write the results of the queries in the layout of vkGetQueryPoolResults.
+         *   Waits for the queries to become available if VK_QUERY_RESULT_WAIT_BIT is set.
+         */
+        VkResult GetResults( uint32_t firstQuery, uint32_t queryCount, void* pData, VkDeviceSize stride, VkQueryResultFlags flags );
+
+    private:
+        bool IsSampled( VkQueue queue, uint32_t valueIndex ) const;
+        void ReadCounters( VkQueue queue, uint64_t* pValues ) const;
+        void SetAvailable( uint32_t query );
     };
 }
 
@@ -23,12 +23,40 @@
 #include "vk_mock_command_buffer.h"
 #include "vk_mock_query_pool.h"
 #include "vk_mock_buffer.h"
+#include "vk_mock_icd_helpers.h"
 #include <chrono>
 #include <thread>
 
 namespace vkmock
 {
+    // Performance queries sample the counters of the pass selected for the submission.
+    static uint32_t GetCounterPassIndex( const void* pNext )
+    {
+        const VkPerformanceQuerySubmitInfoKHR* pPerformanceSubmitInfo = vk_find_struct<VkPerformanceQuerySubmitInfoKHR>(
+            pNext, VK_STRUCTURE_TYPE_PERFORMANCE_QUERY_SUBMIT_INFO_KHR );
+
+        return pPerformanceSubmitInfo ? pPerformanceSubmitInfo->counterPassIndex : 0;
+    }
+
+    // Command buffers submitted without a device mask execute on all physical devices of the group.
+    static uint32_t GetCommandBufferDeviceMask( VkDevice device, const void* pNext, uint32_t commandBufferIndex )
+    {
+        const VkDeviceGroupSubmitInfo* pDeviceGroupSubmitInfo = vk_find_struct<VkDeviceGroupSubmitInfo>(
+            pNext, VK_STRUCTURE_TYPE_DEVICE_GROUP_SUBMIT_INFO );
+
+        if( pDeviceGroupSubmitInfo && commandBufferIndex < pDeviceGroupSubmitInfo->commandBufferCount )
+        {
+            return pDeviceGroupSubmitInfo->pCommandBufferDeviceMasks[ commandBufferIndex ];
+        }
+
+        return device->m_DeviceMask;
+    }
+
     Queue::Queue( VkDevice device, const VkDeviceQueueCreateInfo& createInfo )
+        : m_Device( device )
+        , m_CounterPassIndex( 0 )
+        , m_SubmitDeviceMask( device->m_DeviceMask )
+        , m_DeviceMask( device->m_DeviceMask )
     {
         m_pMockFunctions = device->m_pMockFunctions;
     }
@@ -46,8 +74,11 @@ namespace vkmock
 
         for( uint32_t i = 0; i < submitCount; ++i )
         {
+            m_CounterPassIndex = GetCounterPassIndex( pSubmits[ i ].pNext );
+
             for( uint32_t j = 0; j < pSubmits[ i ].commandBufferCount; ++j )
             {
+                SetSubmitDeviceMask( GetCommandBufferDeviceMask( m_Device, pSubmits[ i ].pNext, j ) );
                 ExecuteCommandBuffer( pSubmits[ i ].pCommandBuffers[ j ] );
             }
         }
@@ -64,9 +95,14 @@ namespace vkmock
 
         for( uint32_t i = 0; i < submitCount; ++i )
         {
+            m_CounterPassIndex = GetCounterPassIndex( pSubmits[ i ].pNext );
+
             for( uint32_t j = 0; j < pSubmits[ i ].commandBufferInfoCount; ++j )
             {
-                ExecuteCommandBuffer( pSubmits[ i ].pCommandBufferInfos[ j ].commandBuffer );
+                const VkCommandBufferSubmitInfo& commandBufferInfo = pSubmits[ i ].pCommandBufferInfos[ j ];
+
+                SetSubmitDeviceMask( commandBufferInfo.deviceMask ? commandBufferInfo.deviceMask : m_Device->m_DeviceMask );
+                ExecuteCommandBuffer( commandBufferInfo.commandBuffer );
             }
         }
 
@@ -79,8 +115,15 @@ namespace vkmock
         {
             if( cmd.pfnExecute )
             {
+                m_Device->m_ExecutionCounters.RecordCommand();
                 cmd.pfnExecute( GetApiHandle(), &cmd );
             }
         }
     }
+
+    void Queue::SetSubmitDeviceMask( uint32_t deviceMask )
+    {
+        m_SubmitDeviceMask = deviceMask;
+        m_DeviceMask = deviceMask;
+    }
 }
@@ -25,6 +25,13 @@ namespace vkmock
 {
     struct Queue : QueueBase
     {
+        VkDevice m_Device;
+        uint32_t m_CounterPassIndex;
+
+        // Physical devices of the device group executing the current command buffer.
+        uint32_t m_SubmitDeviceMask;
+        uint32_t m_DeviceMask;
+
         Queue( VkDevice device, const VkDeviceQueueCreateInfo& createInfo );
         ~Queue();
 
@@ -32,6 +39,7 @@ namespace vkmock
         VkResult vkQueueSubmit2( uint32_t submitCount, const VkSubmitInfo2* pSubmits, VkFence fence );
 
         void ExecuteCommandBuffer( VkCommandBuffer commandBuffer );
+        void SetSubmitDeviceMask( uint32_t deviceMask );
     };
 }
 
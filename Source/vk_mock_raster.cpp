@@ -0,0 +1,1122 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_raster.h"
+#include "vk_mock_buffer.h"
+#include "vk_mock_draw.h"
+#include "vk_mock_image.h"
+#include "vk_mock_image_view.h"
+#include "vk_mock_pipeline.h"
+#include "vk_mock_simd.h"
+#include "vk_mock_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <math.h>
+#include <string.h>
+
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+
+namespace vkmock
+{
+    // Triangles are binned into square tiles of pixels, which are rasterized independently.
+    static constexpr int32_t g_TileSizeLog2 = 6;
+    static constexpr int32_t g_TileSize = 1 << g_TileSizeLog2;
+
+    // Vertices are snapped to 1/16 of a pixel, the minimum precision required by the spec.
+    static constexpr int32_t g_SubpixelBits = 4;
+    static constexpr int32_t g_SubpixelScale = 1 << g_SubpixelBits;
+    static constexpr int32_t g_HalfPixel = g_SubpixelScale / 2;
+
+    // Triangles are clipped to a guard band, so that the edge deltas fit in 19 bits and
+    // the edge functions of all pixels of a tile, relative to the tile, fit in 32 bits.
+    static constexpr float g_GuardBand = 8000.0f;
+    static constexpr int64_t g_EdgeClamp = int64_t( 1 ) << 30;
+
+    // Vertices and primitives are processed in batches to amortize the scheduling.
+    static constexpr uint32_t g_VertexBatchSize = 256;
+    static constexpr uint32_t g_PrimitiveBatchSize = 256;
+
+    // A triangle clipped by all planes has at most 3 + g_ClipPlaneCount vertices.
+    static constexpr uint32_t g_ClipPlaneCount = 7;
+    static constexpr uint32_t g_MaxClipVertices = 3 + g_ClipPlaneCount;
+
+    typedef VkMockVertexOutputEXT ClipVertex;
+
+    static inline uint32_t FindLowestBit( uint32_t mask )
+    {
+#if defined( _MSC_VER )
+        unsigned long index;
+        _BitScanForward( &index, mask );
+        return index;
+#else
+        return __builtin_ctz( mask );
+#endif
+    }
+
+    // Distance of a clip-space position from the plane is dot( m_Coefficients, ( x, y, z, w, 1 ) ).
+    struct ClipPlane
+    {
+        float m_Coefficients[ 5 ];
+
+        float Distance( const float position[ 4 ] ) const
+        {
+            return m_Coefficients[ 0 ] * position[ 0 ] +
+                m_Coefficients[ 1 ] * position[ 1 ] +
+                m_Coefficients[ 2 ] * position[ 2 ] +
+                m_Coefficients[ 3 ] * position[ 3 ] +
+                m_Coefficients[ 4 ];
+        }
+    };
+
+    // Edge functions E = A * x + B * y + C are evaluated in subpixels at the pixel centers.
+    // C includes the bias of the fill rule, so the pixels with E >= 0 for all edges are covered.
+    // Barycentric coordinates of the vertices 1 and 2 are evaluated in pixels, relative to the
+    // minimum of the bounding box.
+    struct RasterTriangle
+    {
+        int32_t m_MinX;
+        int32_t m_MinY;
+        int32_t m_MaxX;
+        int32_t m_MaxY;
+        int32_t m_EdgeA[ 3 ];
+        int32_t m_EdgeB[ 3 ];
+        int64_t m_EdgeC[ 3 ];
+        float m_BarycentricA[ 2 ];
+        float m_BarycentricB[ 2 ];
+        float m_BarycentricC[ 2 ];
+        float m_Depth[ 3 ];
+        float m_InvW[ 3 ];
+        bool m_FrontFacing;
+
+        // Varyings divided by w, interpolated linearly in the screen space.
+        float m_Varyings[ 3 ][ g_MaxVaryings ];
+    };
+
+    typedef std::vector<RasterTriangle, vk_stl_allocator<RasterTriangle>> RasterTriangleVector;
+
+    struct RenderTarget
+    {
+        uint8_t* m_pData;
+        VkDeviceSize m_RowPitch;
+        uint32_t m_TexelSize;
+        uint32_t m_SampleCount;
+        TexelFormat m_Format;
+    };
+
+    struct RasterContext
+    {
+        const GraphicsPipelineState* m_pPipeline;
+        const DrawState* m_pState;
+        const ComputeState* m_pResources;
+        const BoundDescriptorSets* m_pDescriptorSets;
+        const DrawParameters* m_pDraw;
+        uint32_t m_VaryingCount;
+
+        // Intersection of the render area, scissor and attachments, max exclusive.
+        int32_t m_ClipMinX;
+        int32_t m_ClipMinY;
+        int32_t m_ClipMaxX;
+        int32_t m_ClipMaxY;
+
+        uint32_t m_ColorTargetCount;
+        RenderTarget m_ColorTargets[ g_MaxColorAttachments ];
+        bool m_HasDepthTarget;
+        RenderTarget m_DepthTarget;
+
+        // Viewport transform.
+        float m_OffsetX;
+        float m_OffsetY;
+        float m_ScaleX;
+        float m_ScaleY;
+        float m_MinDepth;
+        float m_DepthRange;
+        float m_DepthClampMin;
+        float m_DepthClampMax;
+
+        uint32_t m_ClipPlaneCount;
+        ClipPlane m_ClipPlanes[ g_ClipPlaneCount ];
+    };
+
+    static inline int32_t ClampEdge( int64_t value )
+    {
+        return static_cast<int32_t>( std::min( std::max( value, -g_EdgeClamp ), g_EdgeClamp ) );
+    }
+
+    static bool InitRenderTarget( VkImageView view, VkImageAspectFlagBits aspect, RenderTarget* pTarget, VkExtent3D* pExtent )
+    {
+        const VkImage image = view->m_Image;
+        const uint32_t planeIndex = image->GetPlaneIndex( aspect );
+        if( !( image->m_FormatInfo.aspectMask & aspect ) || !image->m_Planes[ planeIndex ].m_pData )
+        {
+            return false;
+        }
+
+        pTarget->m_Format = GetTexelFormat( view->m_Format, aspect );
+        if( pTarget->m_Format.numericFormat == TexelNumericFormat::eUnknown )
+        {
+            return false;
+        }
+
+        const VkImageSubresource subresource = {
+            static_cast<VkImageAspectFlags>( aspect ),
+            view->m_SubresourceRange.baseMipLevel,
+            view->m_SubresourceRange.baseArrayLayer };
+
+        VkSubresourceLayout layout;
+        pTarget->m_pData = image->GetSubresourceData( subresource, &layout );
+        pTarget->m_RowPitch = layout.rowPitch;
+        pTarget->m_TexelSize = image->m_FormatInfo.planes[ planeIndex ].blockSize;
+        pTarget->m_SampleCount = image->m_Samples;
+
+        *pExtent = image->GetMipLevelExtent( planeIndex, subresource.mipLevel );
+        return true;
+    }
+
+    static inline uint8_t* GetTexelAddress( const RenderTarget& target, int32_t x, int32_t y )
+    {
+        return target.m_pData + y * target.m_RowPitch + size_t( x ) * target.m_TexelSize * target.m_SampleCount;
+    }
+
+    // Samples of multisampled attachments are stored next to each other, all are covered.
+    static inline void WriteTexel( const RenderTarget& target, uint8_t* pTexel, const void* pValue )
+    {
+        for( uint32_t sample = 0; sample < target.m_SampleCount; ++sample )
+        {
+            memcpy( pTexel + sample * target.m_TexelSize, pValue, target.m_TexelSize );
+        }
+    }
+
+    static inline bool CompareDepth( VkCompareOp op, float depth, float reference )
+    {
+        switch( op )
+        {
+        case VK_COMPARE_OP_NEVER: return false;
+        case VK_COMPARE_OP_LESS: return depth < reference;
+        case VK_COMPARE_OP_EQUAL: return depth == reference;
+        case VK_COMPARE_OP_LESS_OR_EQUAL: return depth <= reference;
+        case VK_COMPARE_OP_GREATER: return depth > reference;
+        case VK_COMPARE_OP_NOT_EQUAL: return depth != reference;
+        case VK_COMPARE_OP_GREATER_OR_EQUAL: return depth >= reference;
+        default: return true;
+        }
+    }
+
+    static inline float GetBlendFactor( VkBlendFactor factor, const float src[ 4 ], const float dst[ 4 ], const float constants[ 4 ], uint32_t component )
+    {
+        switch( factor )
+        {
+        case VK_BLEND_FACTOR_ZERO: return 0.0f;
+        case VK_BLEND_FACTOR_ONE: return 1.0f;
+        case VK_BLEND_FACTOR_SRC_COLOR: return src[ component ];
+        case VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR: return 1.0f - src[ component ];
+        case VK_BLEND_FACTOR_DST_COLOR: return dst[ component ];
+        case VK_BLEND_FACTOR_ONE_MINUS_DST_COLOR: return 1.0f - dst[ component ];
+        case VK_BLEND_FACTOR_SRC_ALPHA: return src[ 3 ];
+        case VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA: return 1.0f - src[ 3 ];
+        case VK_BLEND_FACTOR_DST_ALPHA: return dst[ 3 ];
+        case VK_BLEND_FACTOR_ONE_MINUS_DST_ALPHA: return 1.0f - dst[ 3 ];
+        case VK_BLEND_FACTOR_CONSTANT_COLOR: return constants[ component ];
+        case VK_BLEND_FACTOR_ONE_MINUS_CONSTANT_COLOR: return 1.0f - constants[ component ];
+        case VK_BLEND_FACTOR_CONSTANT_ALPHA: return constants[ 3 ];
+        case VK_BLEND_FACTOR_ONE_MINUS_CONSTANT_ALPHA: return 1.0f - constants[ 3 ];
+        case VK_BLEND_FACTOR_SRC_ALPHA_SATURATE: return ( component == 3 ) ? 1.0f : std::min( src[ 3 ], 1.0f - dst[ 3 ] );
+        default: return 0.0f;
+        }
+    }
+
+    static inline float BlendComponent( VkBlendOp op, float src, float srcFactor, float dst, float dstFactor )
+    {
+        switch( op )
+        {
+        case VK_BLEND_OP_SUBTRACT: return src * srcFactor - dst * dstFactor;
+        case VK_BLEND_OP_REVERSE_SUBTRACT: return dst * dstFactor - src * srcFactor;
+        case VK_BLEND_OP_MIN: return std::min( src, dst );
+        case VK_BLEND_OP_MAX: return std::max( src, dst );
+        default: return src * srcFactor + dst * dstFactor;
+        }
+    }
+
+    static void ShadeVertex( const RasterContext& context, size_t index, ClipVertex* pVertex )
+    {
+        const GraphicsPipelineState& pipeline = *context.m_pPipeline;
+        const DrawState& state = *context.m_pState;
+
+        const DrawParameters& draw = *context.m_pDraw;
+        const uint32_t vertex = static_cast<uint32_t>( index % draw.m_VertexCount );
+
+        VkMockVertexInputEXT input = {};
+        input.vertexIndex = draw.m_pIndices
+            ? ReadIndex( draw.m_pIndices, draw.m_IndexSize, vertex ) + draw.m_VertexOffset
+            : draw.m_FirstVertex + vertex;
+        input.instanceIndex = draw.m_FirstInstance + static_cast<uint32_t>( index / draw.m_VertexCount );
+        input.pPushConstants = context.m_pResources->m_PushConstants;
+        input.descriptorSetCount = context.m_pResources->m_DescriptorSetCount;
+        input.pDescriptorSets = context.m_pDescriptorSets->m_Sets;
+        input.pUserData = pipeline.m_pVertexKernelUserData;
+
+        for( uint32_t mask = pipeline.m_AttributeMask; mask; mask &= mask - 1 )
+        {
+            const uint32_t location = FindLowestBit( mask );
+            const VertexAttribute& attribute = pipeline.m_Attributes[ location ];
+            const VkBuffer buffer = state.m_VertexBuffers[ attribute.m_Binding ];
+
+            if( buffer && buffer->m_pData )
+            {
+                const uint32_t elementIndex = ( pipeline.m_BindingInputRates[ attribute.m_Binding ] == VK_VERTEX_INPUT_RATE_INSTANCE )
+                    ? input.instanceIndex
+                    : input.vertexIndex;
+
+                input.pAttributes[ location ] = buffer->m_pData + state.m_VertexBufferOffsets[ attribute.m_Binding ] +
+                    VkDeviceSize( elementIndex ) * pipeline.m_BindingStrides[ attribute.m_Binding ] + attribute.m_Offset;
+            }
+        }
+
+        memset( pVertex, 0, sizeof( ClipVertex ) );
+
+        if( pipeline.m_pfnVertexKernel )
+        {
+            return pipeline.m_pfnVertexKernel( &input, pVertex );
+        }
+
+        // Position-only pipelines read the position and the color from the attributes.
+        VkClearColorValue value = {};
+        value.float32[ 3 ] = 1.0f;
+
+        if( input.pAttributes[ 0 ] )
+        {
+            UnpackTexel( pipeline.m_Attributes[ 0 ].m_Format, input.pAttributes[ 0 ], &value );
+        }
+
+        memcpy( pVertex->position, value.float32, sizeof( pVertex->position ) );
+
+        value.float32[ 0 ] = value.float32[ 1 ] = value.float32[ 2 ] = value.float32[ 3 ] = 1.0f;
+
+        if( input.pAttributes[ 1 ] )
+        {
+            UnpackTexel( pipeline.m_Attributes[ 1 ].m_Format, input.pAttributes[ 1 ], &value );
+        }
+
+        memcpy( pVertex->varyings, value.float32, sizeof( value.float32 ) );
+    }
+
+    static uint32_t ClipPolygon( const RasterContext& context, uint32_t planeMask, ClipVertex* pVertices, uint32_t vertexCount )
+    {
+        ClipVertex clipped[ g_MaxClipVertices ];
+        const uint32_t componentCount = 4 + context.m_VaryingCount;
+
+        for( ; planeMask && vertexCount; planeMask &= planeMask - 1 )
+        {
+            const ClipPlane& plane = context.m_ClipPlanes[ FindLowestBit( planeMask ) ];
+            uint32_t clippedCount = 0;
+
+            for( uint32_t i = 0; i < vertexCount; ++i )
+            {
+                const ClipVertex& v0 = pVertices[ i ];
+                const ClipVertex& v1 = pVertices[ ( i + 1 ) % vertexCount ];
+                const float d0 = plane.Distance( v0.position );
+                const float d1 = plane.Distance( v1.position );
+
+                if( d0 >= 0.0f )
+                {
+                    clipped[ clippedCount++ ] = v0;
+                }
+
+                if( ( d0 >= 0.0f ) != ( d1 >= 0.0f ) )
+                {
+                    // Position and varyings are stored contiguously, so they are interpolated together.
+                    const float t = d0 / ( d0 - d1 );
+                    const float* p0 = v0.position;
+                    const float* p1 = v1.position;
+                    float* pOut = clipped[ clippedCount++ ].position;
+
+                    for( uint32_t c = 0; c < componentCount; ++c )
+                    {
+                        pOut[ c ] = p0[ c ] + t * ( p1[ c ] - p0[ c ] );
+                    }
+                }
+            }
+
+            vertexCount = clippedCount;
+            memcpy( pVertices, clipped, vertexCount * sizeof( ClipVertex ) );
+        }
+
+        return vertexCount;
+    }
+
+    static void SetupTriangle( const RasterContext& context, const ClipVertex* const pVertices[ 3 ], RasterTriangleVector& triangles )
+    {
+        const GraphicsPipelineState& pipeline = *context.m_pPipeline;
+
+        float screen[ 3 ][ 2 ];
+        int32_t fixed[ 3 ][ 2 ];
+        float depth[ 3 ];
+        float invW[ 3 ];
+
+        for( uint32_t i = 0; i < 3; ++i )
+        {
+            const float* position = pVertices[ i ]->position;
+            invW[ i ] = 1.0f / position[ 3 ];
+            screen[ i ][ 0 ] = context.m_OffsetX + context.m_ScaleX * position[ 0 ] * invW[ i ];
+            screen[ i ][ 1 ] = context.m_OffsetY + context.m_ScaleY * position[ 1 ] * invW[ i ];
+            depth[ i ] = context.m_MinDepth + context.m_DepthRange * position[ 2 ] * invW[ i ];
+            fixed[ i ][ 0 ] = static_cast<int32_t>( lrintf( screen[ i ][ 0 ] * g_SubpixelScale ) );
+            fixed[ i ][ 1 ] = static_cast<int32_t>( lrintf( screen[ i ][ 1 ] * g_SubpixelScale ) );
+        }
+
+        int64_t area = int64_t( fixed[ 1 ][ 0 ] - fixed[ 0 ][ 0 ] ) * ( fixed[ 2 ][ 1 ] - fixed[ 0 ][ 1 ] ) -
+            int64_t( fixed[ 2 ][ 0 ] - fixed[ 0 ][ 0 ] ) * ( fixed[ 1 ][ 1 ] - fixed[ 0 ][ 1 ] );
+
+        if( area == 0 )
+        {
+            return;
+        }
+
+        // Framebuffer y axis points down, so the negative area is counter-clockwise.
+        const bool counterClockwise = ( area < 0 );
+        const bool frontFacing = ( pipeline.m_FrontFace == VK_FRONT_FACE_COUNTER_CLOCKWISE ) == counterClockwise;
+
+        if( ( pipeline.m_CullMode & ( frontFacing ? VK_CULL_MODE_FRONT_BIT : VK_CULL_MODE_BACK_BIT ) ) )
+        {
+            return;
+        }
+
+        // Vertices are reordered to the positive area, so that the interior of all triangles is on the same side of the edges.
+        uint32_t order[ 3 ] = { 0, 1, 2 };
+        if( counterClockwise )
+        {
+            std::swap( order[ 1 ], order[ 2 ] );
+            area = -area;
+        }
+
+        int32_t minX = INT32_MAX, minY = INT32_MAX, maxX = INT32_MIN, maxY = INT32_MIN;
+        for( uint32_t i = 0; i < 3; ++i )
+        {
+            minX = std::min( minX, fixed[ i ][ 0 ] );
+            minY = std::min( minY, fixed[ i ][ 1 ] );
+            maxX = std::max( maxX, fixed[ i ][ 0 ] );
+            maxY = std::max( maxY, fixed[ i ][ 1 ] );
+        }
+
+        // Pixels with the centers inside the bounding box, clipped to the render area.
+        RasterTriangle triangle;
+        triangle.m_MinX = std::max( ( minX - g_HalfPixel + g_SubpixelScale - 1 ) >> g_SubpixelBits, context.m_ClipMinX );
+        triangle.m_MinY = std::max( ( minY - g_HalfPixel + g_SubpixelScale - 1 ) >> g_SubpixelBits, context.m_ClipMinY );
+        triangle.m_MaxX = std::min( ( ( maxX - g_HalfPixel ) >> g_SubpixelBits ) + 1, context.m_ClipMaxX );
+        triangle.m_MaxY = std::min( ( ( maxY - g_HalfPixel ) >> g_SubpixelBits ) + 1, context.m_ClipMaxY );
+
+        if( triangle.m_MinX >= triangle.m_MaxX || triangle.m_MinY >= triangle.m_MaxY )
+        {
+            return;
+        }
+
+        const double originX = double( triangle.m_MinX ) * g_SubpixelScale + g_HalfPixel;
+        const double originY = double( triangle.m_MinY ) * g_SubpixelScale + g_HalfPixel;
+
+        // Edge k is opposite to the vertex k, so it evaluates to area at the vertex.
+        for( uint32_t k = 0; k < 3; ++k )
+        {
+            const int32_t* v0 = fixed[ order[ ( k + 1 ) % 3 ] ];
+            const int32_t* v1 = fixed[ order[ ( k + 2 ) % 3 ] ];
+            const int32_t dx = v1[ 0 ] - v0[ 0 ];
+            const int32_t dy = v1[ 1 ] - v0[ 1 ];
+
+            triangle.m_EdgeA[ k ] = -dy;
+            triangle.m_EdgeB[ k ] = dx;
+            triangle.m_EdgeC[ k ] = int64_t( dy ) * v0[ 0 ] - int64_t( dx ) * v0[ 1 ];
+
+            if( k > 0 )
+            {
+                const double invArea = 1.0 / double( area );
+                triangle.m_BarycentricA[ k - 1 ] = float( -dy * g_SubpixelScale * invArea );
+                triangle.m_BarycentricB[ k - 1 ] = float( dx * g_SubpixelScale * invArea );
+                triangle.m_BarycentricC[ k - 1 ] = float( ( -dy * originX + dx * originY + double( triangle.m_EdgeC[ k ] ) ) * invArea );
+            }
+
+            // Top-left fill rule: pixels on the right and bottom edges are not covered.
+            const bool topLeft = ( dy < 0 ) || ( dy == 0 && dx > 0 );
+            if( !topLeft )
+            {
+                triangle.m_EdgeC[ k ] -= 1;
+            }
+        }
+
+        for( uint32_t i = 0; i < 3; ++i )
+        {
+            const uint32_t vertex = order[ i ];
+            triangle.m_Depth[ i ] = depth[ vertex ];
+            triangle.m_InvW[ i ] = invW[ vertex ];
+
+            for( uint32_t c = 0; c < context.m_VaryingCount; ++c )
+            {
+                triangle.m_Varyings[ i ][ c ] = pVertices[ vertex ]->varyings[ c ] * invW[ vertex ];
+            }
+        }
+
+        triangle.m_FrontFacing = frontFacing;
+        triangles.push_back( triangle );
+    }
+
+    static void SetupPrimitive( const RasterContext& context, const ClipVertex* pV0, const ClipVertex* pV1, const ClipVertex* pV2, RasterTriangleVector& triangles )
+    {
+        uint32_t outside[ 3 ] = {};
+        const ClipVertex* const pVertices[ 3 ] = { pV0, pV1, pV2 };
+
+        for( uint32_t i = 0; i < 3; ++i )
+        {
+            for( uint32_t p = 0; p < context.m_ClipPlaneCount; ++p )
+            {
+                if( context.m_ClipPlanes[ p ].Distance( pVertices[ i ]->position ) < 0.0f )
+                {
+                    outside[ i ] |= 1U << p;
+                }
+            }
+        }
+
+        if( outside[ 0 ] & outside[ 1 ] & outside[ 2 ] )
+        {
+            return;
+        }
+
+        const uint32_t planeMask = outside[ 0 ] | outside[ 1 ] | outside[ 2 ];
+        if( !planeMask )
+        {
+            return SetupTriangle( context, pVertices, triangles );
+        }
+
+        // Clipped polygon is convex, so it is split into a fan of triangles.
+        ClipVertex polygon[ g_MaxClipVertices ];
+        polygon[ 0 ] = *pV0;
+        polygon[ 1 ] = *pV1;
+        polygon[ 2 ] = *pV2;
+
+        const uint32_t vertexCount = ClipPolygon( context, planeMask, polygon, 3 );
+
+        for( uint32_t i = 2; i < vertexCount; ++i )
+        {
+            const ClipVertex* const pFan[ 3 ] = { &polygon[ 0 ], &polygon[ i - 1 ], &polygon[ i ] };
+            SetupTriangle( context, pFan, triangles );
+        }
+    }
+
+    static void GetPrimitiveVertices( VkPrimitiveTopology topology, uint32_t primitive, uint32_t indices[ 3 ] )
+    {
+        switch( topology )
+        {
+        case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP:
+            // Odd triangles of the strip are reversed to keep the winding of the first one.
+            indices[ 0 ] = primitive;
+            indices[ 1 ] = primitive + 1 + ( primitive & 1 );
+            indices[ 2 ] = primitive + 2 - ( primitive & 1 );
+            break;
+        case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN:
+            indices[ 0 ] = primitive + 1;
+            indices[ 1 ] = primitive + 2;
+            indices[ 2 ] = 0;
+            break;
+        default:
+            indices[ 0 ] = primitive * 3;
+            indices[ 1 ] = primitive * 3 + 1;
+            indices[ 2 ] = primitive * 3 + 2;
+            break;
+        }
+    }
+
+    // Returns true if the fragment passed the depth test and was not discarded.
+    static bool ShadeFragment( const RasterContext& context, const RasterTriangle& triangle, int32_t x, int32_t y )
+    {
+        const GraphicsPipelineState& pipeline = *context.m_pPipeline;
+
+        const float dx = float( x - triangle.m_MinX );
+        const float dy = float( y - triangle.m_MinY );
+        const float b1 = triangle.m_BarycentricA[ 0 ] * dx + triangle.m_BarycentricB[ 0 ] * dy + triangle.m_BarycentricC[ 0 ];
+        const float b2 = triangle.m_BarycentricA[ 1 ] * dx + triangle.m_BarycentricB[ 1 ] * dy + triangle.m_BarycentricC[ 1 ];
+
+        // Attributes are interpolated relative to the first vertex, so constant attributes are exact.
+        auto interpolate = [b1, b2]( float a0, float a1, float a2 ) {
+            return a0 + b1 * ( a1 - a0 ) + b2 * ( a2 - a0 );
+        };
+
+        float depth = interpolate( triangle.m_Depth[ 0 ], triangle.m_Depth[ 1 ], triangle.m_Depth[ 2 ] );
+        const float invW = interpolate( triangle.m_InvW[ 0 ], triangle.m_InvW[ 1 ], triangle.m_InvW[ 2 ] );
+
+        float varyings[ g_MaxVaryings ];
+        const float w = 1.0f / invW;
+        for( uint32_t c = 0; c < context.m_VaryingCount; ++c )
+        {
+            varyings[ c ] = interpolate( triangle.m_Varyings[ 0 ][ c ], triangle.m_Varyings[ 1 ][ c ], triangle.m_Varyings[ 2 ][ c ] ) * w;
+        }
+
+        VkMockFragmentOutputEXT output;
+        if( pipeline.m_pfnFragmentKernel )
+        {
+            VkMockFragmentInputEXT input;
+            input.fragCoord[ 0 ] = float( x ) + 0.5f;
+            input.fragCoord[ 1 ] = float( y ) + 0.5f;
+            input.fragCoord[ 2 ] = depth;
+            input.fragCoord[ 3 ] = invW;
+            input.frontFacing = triangle.m_FrontFacing;
+            input.pVaryings = varyings;
+            input.pPushConstants = context.m_pResources->m_PushConstants;
+            input.descriptorSetCount = context.m_pResources->m_DescriptorSetCount;
+            input.pDescriptorSets = context.m_pDescriptorSets->m_Sets;
+            input.pUserData = pipeline.m_pFragmentKernelUserData;
+
+            memset( &output, 0, sizeof( output ) );
+            output.depth = depth;
+
+            pipeline.m_pfnFragmentKernel( &input, &output );
+
+            if( output.discard )
+            {
+                return false;
+            }
+
+            depth = output.depth;
+        }
+        else
+        {
+            for( uint32_t i = 0; i < context.m_ColorTargetCount; ++i )
+            {
+                memcpy( output.colors[ i ].float32, varyings, sizeof( output.colors[ i ].float32 ) );
+            }
+        }
+
+        depth = std::min( std::max( depth, context.m_DepthClampMin ), context.m_DepthClampMax );
+
+        if( context.m_HasDepthTarget && pipeline.m_DepthTestEnable )
+        {
+            const RenderTarget& target = context.m_DepthTarget;
+            uint8_t* pTexel = GetTexelAddress( target, x, y );
+
+            VkClearColorValue value;
+            UnpackTexel( target.m_Format, pTexel, &value );
+
+            if( !CompareDepth( pipeline.m_DepthCompareOp, depth, value.float32[ 0 ] ) )
+            {
+                return false;
+            }
+
+            if( pipeline.m_DepthWriteEnable )
+            {
+                uint8_t texel[ 16 ];
+                value.float32[ 0 ] = depth;
+                PackTexel( target.m_Format, value, texel );
+                WriteTexel( target, pTexel, texel );
+            }
+        }
+
+        for( uint32_t i = 0; i < context.m_ColorTargetCount; ++i )
+        {
+            const RenderTarget& target = context.m_ColorTargets[ i ];
+            if( !target.m_pData )
+            {
+                continue;
+            }
+
+            // Attachments without the blend state are written without blending.
+            VkPipelineColorBlendAttachmentState blend = {};
+            blend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+            if( i < pipeline.m_ColorBlendAttachmentCount )
+            {
+                blend = pipeline.m_ColorBlendAttachments[ i ];
+            }
+
+            if( !blend.colorWriteMask )
+            {
+                continue;
+            }
+
+            uint8_t* pTexel = GetTexelAddress( target, x, y );
+            VkClearColorValue color = output.colors[ i ];
+
+            const bool integer =
+                target.m_Format.numericFormat == TexelNumericFormat::eUint ||
+                target.m_Format.numericFormat == TexelNumericFormat::eSint;
+
+            const bool blendEnable = blend.blendEnable && !integer;
+            const bool partialWrite = ( blend.colorWriteMask & 0xF ) != 0xF;
+
+            if( blendEnable || partialWrite )
+            {
+                VkClearColorValue dst;
+                UnpackTexel( target.m_Format, pTexel, &dst );
+
+                if( blendEnable )
+                {
+                    // Fixed-point formats clamp the source before blending.
+                    float src[ 4 ];
+                    const bool normalized =
+                        target.m_Format.numericFormat == TexelNumericFormat::eUnorm ||
+                        target.m_Format.numericFormat == TexelNumericFormat::eSrgb;
+
+                    for( uint32_t c = 0; c < 4; ++c )
+                    {
+                        src[ c ] = normalized ? std::min( std::max( color.float32[ c ], 0.0f ), 1.0f ) : color.float32[ c ];
+                    }
+
+                    const float* constants = context.m_pState->m_BlendConstants;
+                    for( uint32_t c = 0; c < 4; ++c )
+                    {
+                        const bool alpha = ( c == 3 );
+                        const float srcFactor = GetBlendFactor( alpha ? blend.srcAlphaBlendFactor : blend.srcColorBlendFactor, src, dst.float32, constants, c );
+                        const float dstFactor = GetBlendFactor( alpha ? blend.dstAlphaBlendFactor : blend.dstColorBlendFactor, src, dst.float32, constants, c );
+                        color.float32[ c ] = BlendComponent( alpha ? blend.alphaBlendOp : blend.colorBlendOp, src[ c ], srcFactor, dst.float32[ c ], dstFactor );
+                    }
+                }
+
+                for( uint32_t c = 0; c < 4; ++c )
+                {
+                    if( !( blend.colorWriteMask & ( 1U << c ) ) )
+                    {
+                        color.uint32[ c ] = dst.uint32[ c ];
+                    }
+                }
+            }
+
+            uint8_t texel[ 16 ];
+            PackTexel( target.m_Format, color, texel );
+            WriteTexel( target, pTexel, texel );
+        }
+
+        return true;
+    }
+
+    // Edge functions of 4 horizontally adjacent pixels, evaluated with the vector instructions.
+    struct EdgeQuad
+    {
+#if defined( VK_MOCK_SSE2 )
+        __m128i m_Values[ 3 ];
+        __m128i m_Steps[ 3 ];
+
+        EdgeQuad( const int32_t values[ 3 ], const int32_t steps[ 3 ] )
+        {
+            for( uint32_t k = 0; k < 3; ++k )
+            {
+                m_Values[ k ] = _mm_add_epi32( _mm_set1_epi32( values[ k ] ), _mm_set_epi32( 3 * steps[ k ], 2 * steps[ k ], steps[ k ], 0 ) );
+                m_Steps[ k ] = _mm_set1_epi32( 4 * steps[ k ] );
+            }
+        }
+
+        uint32_t CoverageMask() const
+        {
+            // Pixel is covered if the sign bits of all edge functions are clear.
+            const __m128i outside = _mm_or_si128( _mm_or_si128( m_Values[ 0 ], m_Values[ 1 ] ), m_Values[ 2 ] );
+            return ~static_cast<uint32_t>( _mm_movemask_ps( _mm_castsi128_ps( outside ) ) ) & 0xF;
+        }
+
+        void Next()
+        {
+            for( uint32_t k = 0; k < 3; ++k )
+            {
+                m_Values[ k ] = _mm_add_epi32( m_Values[ k ], m_Steps[ k ] );
+            }
+        }
+#elif defined( VK_MOCK_NEON )
+        int32x4_t m_Values[ 3 ];
+        int32x4_t m_Steps[ 3 ];
+
+        EdgeQuad( const int32_t values[ 3 ], const int32_t steps[ 3 ] )
+        {
+            for( uint32_t k = 0; k < 3; ++k )
+            {
+                const int32_t offsets[ 4 ] = { 0, steps[ k ], 2 * steps[ k ], 3 * steps[ k ] };
+                m_Values[ k ] = vaddq_s32( vdupq_n_s32( values[ k ] ), vld1q_s32( offsets ) );
+                m_Steps[ k ] = vdupq_n_s32( 4 * steps[ k ] );
+            }
+        }
+
+        uint32_t CoverageMask() const
+        {
+            const int32x4_t outside = vorrq_s32( vorrq_s32( m_Values[ 0 ], m_Values[ 1 ] ), m_Values[ 2 ] );
+            const uint32x4_t signs = vshrq_n_u32( vreinterpretq_u32_s32( outside ), 31 );
+            return ~( vgetq_lane_u32( signs, 0 ) |
+                ( vgetq_lane_u32( signs, 1 ) << 1 ) |
+                ( vgetq_lane_u32( signs, 2 ) << 2 ) |
+                ( vgetq_lane_u32( signs, 3 ) << 3 ) ) & 0xF;
+        }
+
+        void Next()
+        {
+            for( uint32_t k = 0; k < 3; ++k )
+            {
+                m_Values[ k ] = vaddq_s32( m_Values[ k ], m_Steps[ k ] );
+            }
+        }
+#else
+        int32_t m_Values[ 3 ];
+        int32_t m_Steps[ 3 ];
+
+        EdgeQuad( const int32_t values[ 3 ], const int32_t steps[ 3 ] )
+        {
+            memcpy( m_Values, values, sizeof( m_Values ) );
+            memcpy( m_Steps, steps, sizeof( m_Steps ) );
+        }
+
+        uint32_t CoverageMask() const
+        {
+            uint32_t mask = 0;
+            for( int32_t i = 0; i < 4; ++i )
+            {
+                const int32_t outside =
+                    ( m_Values[ 0 ] + i * m_Steps[ 0 ] ) |
+                    ( m_Values[ 1 ] + i * m_Steps[ 1 ] ) |
+                    ( m_Values[ 2 ] + i * m_Steps[ 2 ] );
+                mask |= uint32_t( outside >= 0 ) << i;
+            }
+            return mask;
+        }
+
+        void Next()
+        {
+            for( uint32_t k = 0; k < 3; ++k )
+            {
+                m_Values[ k ] += 4 * m_Steps[ k ];
+            }
+        }
+#endif
+    };
+
+    static void RasterizeTriangle( const RasterContext& context, const RasterTriangle& triangle, int32_t tileMinX, int32_t tileMinY, int32_t tileMaxX, int32_t tileMaxY, RasterStatistics& statistics )
+    {
+        const int32_t minX = std::max( triangle.m_MinX, tileMinX );
+        const int32_t minY = std::max( triangle.m_MinY, tileMinY );
+        const int32_t maxX = std::min( triangle.m_MaxX, tileMaxX );
+        const int32_t maxY = std::min( triangle.m_MaxY, tileMaxY );
+
+        if( minX >= maxX || minY >= maxY )
+        {
+            return;
+        }
+
+        // Edge functions are evaluated relative to the corner of the tile, where the values clamped
+        // to the range larger than the variation within the tile keep their signs.
+        const int64_t cornerX = int64_t( minX ) * g_SubpixelScale + g_HalfPixel;
+        const int64_t cornerY = int64_t( minY ) * g_SubpixelScale + g_HalfPixel;
+
+        int32_t rowValues[ 3 ];
+        int32_t stepsX[ 3 ];
+        int32_t stepsY[ 3 ];
+
+        for( uint32_t k = 0; k < 3; ++k )
+        {
+            rowValues[ k ] = ClampEdge( triangle.m_EdgeA[ k ] * cornerX + triangle.m_EdgeB[ k ] * cornerY + triangle.m_EdgeC[ k ] );
+            stepsX[ k ] = triangle.m_EdgeA[ k ] * g_SubpixelScale;
+            stepsY[ k ] = triangle.m_EdgeB[ k ] * g_SubpixelScale;
+        }
+
+        for( int32_t y = minY; y < maxY; ++y )
+        {
+            EdgeQuad quad( rowValues, stepsX );
+
+            for( int32_t x = minX; x < maxX; x += 4 )
+            {
+                uint32_t mask = quad.CoverageMask();
+
+                // Pixels past the end of the row are masked out.
+                if( maxX - x < 4 )
+                {
+                    mask &= ( 1U << ( maxX - x ) ) - 1;
+                }
+
+                for( ; mask; mask &= mask - 1 )
+                {
+                    statistics.m_FragmentShaderInvocations++;
+                    statistics.m_SamplesPassed += ShadeFragment( context, triangle, x + int32_t( FindLowestBit( mask ) ), y );
+                }
+
+                quad.Next();
+            }
+
+            for( uint32_t k = 0; k < 3; ++k )
+            {
+                rowValues[ k ] += stepsY[ k ];
+            }
+        }
+    }
+
+    // Rejects the tiles entirely outside of any edge of the triangle, by testing the corner
+    // of the tile with the largest value of the edge function.
+    static bool TriangleOverlapsTile( const RasterTriangle& triangle, int32_t tileMinX, int32_t tileMinY, int32_t tileMaxX, int32_t tileMaxY )
+    {
+        for( uint32_t k = 0; k < 3; ++k )
+        {
+            const int64_t x = ( triangle.m_EdgeA[ k ] > 0 ) ? tileMaxX - 1 : tileMinX;
+            const int64_t y = ( triangle.m_EdgeB[ k ] > 0 ) ? tileMaxY - 1 : tileMinY;
+            const int64_t value = triangle.m_EdgeA[ k ] * ( x * g_SubpixelScale + g_HalfPixel ) +
+                triangle.m_EdgeB[ k ] * ( y * g_SubpixelScale + g_HalfPixel ) +
+                triangle.m_EdgeC[ k ];
+
+            if( value < 0 )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    uint32_t GetPrimitiveCount( VkPrimitiveTopology topology, uint32_t vertexCount )
+    {
+        switch( topology )
+        {
+        case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+            return vertexCount;
+        case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+            return vertexCount / 2;
+        case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+            return ( vertexCount > 1 ) ? vertexCount - 1 : 0;
+        case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST:
+            return vertexCount / 3;
+        case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP:
+        case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN:
+            return ( vertexCount > 2 ) ? vertexCount - 2 : 0;
+        default:
+            return 0;
+        }
+    }
+
+    RasterStatistics DrawPrimitives( ThreadPool& threadPool, const ComputeState& resources, const DrawState& state, const DrawParameters& draw )
+    {
+        const GraphicsPipelineState& pipeline = resources.m_Pipeline->m_Graphics;
+        const uint32_t vertexCount = draw.m_VertexCount;
+        const uint32_t instanceCount = draw.m_InstanceCount;
+
+        RasterStatistics statistics = {};
+        statistics.m_PrimitiveCount = uint64_t( GetPrimitiveCount( pipeline.m_Topology, vertexCount ) ) * instanceCount;
+
+        // Points, lines and patches are not rasterized.
+        uint32_t primitiveCount = 0;
+        switch( pipeline.m_Topology )
+        {
+        case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST:
+        case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP:
+        case VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN:
+            primitiveCount = GetPrimitiveCount( pipeline.m_Topology, vertexCount );
+            break;
+        default:
+            break;
+        }
+
+        if( pipeline.m_RasterizerDiscardEnable || !primitiveCount || !instanceCount )
+        {
+            return statistics;
+        }
+
+        RasterContext context = {};
+        context.m_pPipeline = &pipeline;
+        context.m_pState = &state;
+        context.m_pResources = &resources;
+        context.m_pDraw = &draw;
+        context.m_VaryingCount = pipeline.m_VaryingCount;
+
+        const VkRect2D& renderArea = state.m_Rendering.m_RenderArea;
+        const VkRect2D& scissor = state.m_Scissor;
+        int64_t clipMaxX = std::min( int64_t( renderArea.offset.x ) + renderArea.extent.width, int64_t( scissor.offset.x ) + scissor.extent.width );
+        int64_t clipMaxY = std::min( int64_t( renderArea.offset.y ) + renderArea.extent.height, int64_t( scissor.offset.y ) + scissor.extent.height );
+
+        for( uint32_t i = 0; i < state.m_Rendering.m_ColorAttachmentCount; ++i )
+        {
+            VkExtent3D extent;
+            const VkImageView view = state.m_Rendering.m_ColorAttachments[ i ];
+            if( view && InitRenderTarget( view, VK_IMAGE_ASPECT_COLOR_BIT, &context.m_ColorTargets[ i ], &extent ) )
+            {
+                clipMaxX = std::min<int64_t>( clipMaxX, extent.width );
+                clipMaxY = std::min<int64_t>( clipMaxY, extent.height );
+            }
+        }
+
+        context.m_ColorTargetCount = state.m_Rendering.m_ColorAttachmentCount;
+
+        if( const VkImageView view = state.m_Rendering.m_DepthAttachment )
+        {
+            VkExtent3D extent;
+            context.m_HasDepthTarget = InitRenderTarget( view, VK_IMAGE_ASPECT_DEPTH_BIT, &context.m_DepthTarget, &extent );
+            if( context.m_HasDepthTarget )
+            {
+                clipMaxX = std::min<int64_t>( clipMaxX, extent.width );
+                clipMaxY = std::min<int64_t>( clipMaxY, extent.height );
+            }
+        }
+
+        context.m_ClipMinX = std::max( std::max( renderArea.offset.x, scissor.offset.x ), 0 );
+        context.m_ClipMinY = std::max( std::max( renderArea.offset.y, scissor.offset.y ), 0 );
+        context.m_ClipMaxX = static_cast<int32_t>( std::min<int64_t>( clipMaxX, int64_t( g_GuardBand ) ) );
+        context.m_ClipMaxY = static_cast<int32_t>( std::min<int64_t>( clipMaxY, int64_t( g_GuardBand ) ) );
+
+        if( context.m_ClipMinX >= context.m_ClipMaxX || context.m_ClipMinY >= context.m_ClipMaxY )
+        {
+            return statistics;
+        }
+
+        const VkViewport& viewport = state.m_Viewport;
+        context.m_ScaleX = viewport.width * 0.5f;
+        context.m_ScaleY = viewport.height * 0.5f;
+        context.m_OffsetX = viewport.x + context.m_ScaleX;
+        context.m_OffsetY = viewport.y + context.m_ScaleY;
+        context.m_MinDepth = viewport.minDepth;
+        context.m_DepthRange = viewport.maxDepth - viewport.minDepth;
+        context.m_DepthClampMin = std::min( viewport.minDepth, viewport.maxDepth );
+        context.m_DepthClampMax = std::max( viewport.minDepth, viewport.maxDepth );
+
+        // Vertices behind the eye are clipped before the perspective division, and the vertices
+        // outside of the guard band are clipped to keep the fixed-point coordinates in range.
+        const ClipPlane clipPlanes[] = {
+            { { 0.0f, 0.0f, 0.0f, 1.0f, -1e-6f } },
+            { { -context.m_ScaleX, 0.0f, 0.0f, g_GuardBand - context.m_OffsetX, 0.0f } },
+            { { context.m_ScaleX, 0.0f, 0.0f, g_GuardBand + context.m_OffsetX, 0.0f } },
+            { { 0.0f, -context.m_ScaleY, 0.0f, g_GuardBand - context.m_OffsetY, 0.0f } },
+            { { 0.0f, context.m_ScaleY, 0.0f, g_GuardBand + context.m_OffsetY, 0.0f } },
+            { { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f } },
+            { { 0.0f, 0.0f, -1.0f, 1.0f, 0.0f } } };
+
+        static_assert( std::size( clipPlanes ) == g_ClipPlaneCount, "Unexpected number of clip planes" );
+
+        // Depth clamping disables the clipping to the near and far planes.
+        context.m_ClipPlaneCount = pipeline.m_DepthClampEnable ? g_ClipPlaneCount - 2 : g_ClipPlaneCount;
+        memcpy( context.m_ClipPlanes, clipPlanes, sizeof( clipPlanes ) );
+
+        const BoundDescriptorSets descriptorSets( threadPool.m_Allocator, resources );
+        context.m_pDescriptorSets = &descriptorSets;
+
+        // Vertex processing.
+        const size_t totalVertexCount = size_t( vertexCount ) * instanceCount;
+        std::vector<ClipVertex, vk_stl_allocator<ClipVertex>> vertices( totalVertexCount, threadPool.m_Allocator );
+
+        threadPool.ParallelFor( vk_div_round_up<size_t>( totalVertexCount, g_VertexBatchSize ), [&]( size_t batch ) {
+            const size_t end = std::min( ( batch + 1 ) * g_VertexBatchSize, totalVertexCount );
+            for( size_t i = batch * g_VertexBatchSize; i < end; ++i )
+            {
+                ShadeVertex( context, i, &vertices[ i ] );
+            }
+        } );
+
+        // Primitive assembly, clipping and triangle setup. Each batch of primitives produces
+        // its own list of triangles, the lists are concatenated in the API order.
+        const size_t totalPrimitiveCount = size_t( primitiveCount ) * instanceCount;
+        const size_t primitiveBatchCount = vk_div_round_up<size_t>( totalPrimitiveCount, g_PrimitiveBatchSize );
+
+        std::vector<RasterTriangleVector, vk_stl_allocator<RasterTriangleVector>> triangleBatches(
+            primitiveBatchCount, RasterTriangleVector( threadPool.m_Allocator ), threadPool.m_Allocator );
+
+        threadPool.ParallelFor( primitiveBatchCount, [&]( size_t batch ) {
+            const size_t end = std::min( ( batch + 1 ) * g_PrimitiveBatchSize, totalPrimitiveCount );
+            for( size_t i = batch * g_PrimitiveBatchSize; i < end; ++i )
+            {
+                const ClipVertex* pInstanceVertices = vertices.data() + ( i / primitiveCount ) * vertexCount;
+
+                uint32_t indices[ 3 ];
+                GetPrimitiveVertices( pipeline.m_Topology, static_cast<uint32_t>( i % primitiveCount ), indices );
+
+                SetupPrimitive( context,
+                    &pInstanceVertices[ indices[ 0 ] ],
+                    &pInstanceVertices[ indices[ 1 ] ],
+                    &pInstanceVertices[ indices[ 2 ] ],
+                    triangleBatches[ batch ] );
+            }
+        } );
+
+        // Binning. Tiles are aligned to the multiples of the tile size, triangles are counted
+        // in the first pass and stored in the API order in the second pass.
+        const int32_t firstTileX = context.m_ClipMinX >> g_TileSizeLog2;
+        const int32_t firstTileY = context.m_ClipMinY >> g_TileSizeLog2;
+        const int32_t tileCountX = ( ( context.m_ClipMaxX - 1 ) >> g_TileSizeLog2 ) - firstTileX + 1;
+        const int32_t tileCountY = ( ( context.m_ClipMaxY - 1 ) >> g_TileSizeLog2 ) - firstTileY + 1;
+        const size_t tileCount = size_t( tileCountX ) * tileCountY;
+
+        std::vector<uint32_t, vk_stl_allocator<uint32_t>> binOffsets( tileCount + 1, 0, threadPool.m_Allocator );
+        std::vector<const RasterTriangle*, vk_stl_allocator<const RasterTriangle*>> binEntries( threadPool.m_Allocator );
+
+        auto forEachOverlappedTile = [&]( const RasterTriangle& triangle, auto&& function ) {
+            const int32_t tileMinX = ( triangle.m_MinX >> g_TileSizeLog2 ) - firstTileX;
+            const int32_t tileMinY = ( triangle.m_MinY >> g_TileSizeLog2 ) - firstTileY;
+            const int32_t tileMaxX = ( ( triangle.m_MaxX - 1 ) >> g_TileSizeLog2 ) - firstTileX;
+            const int32_t tileMaxY = ( ( triangle.m_MaxY - 1 ) >> g_TileSizeLog2 ) - firstTileY;
+
+            for( int32_t ty = tileMinY; ty <= tileMaxY; ++ty )
+            {
+                for( int32_t tx = tileMinX; tx <= tileMaxX; ++tx )
+                {
+                    const int32_t x = ( firstTileX + tx ) << g_TileSizeLog2;
+                    const int32_t y = ( firstTileY + ty ) << g_TileSizeLog2;
+
+                    if( TriangleOverlapsTile( triangle, x, y, x + g_TileSize, y + g_TileSize ) )
+                    {
+                        function( size_t( ty ) * tileCountX + tx );
+                    }
+                }
+            }
+        };
+
+        for( const RasterTriangleVector& triangles : triangleBatches )
+        {
+            for( const RasterTriangle& triangle : triangles )
+            {
+                forEachOverlappedTile( triangle, [&]( size_t tile ) { binOffsets[ tile + 1 ]++; } );
+            }
+        }
+
+        for( size_t tile = 0; tile < tileCount; ++tile )
+        {
+            binOffsets[ tile + 1 ] += binOffsets[ tile ];
+        }
+
+        binEntries.resize( binOffsets[ tileCount ] );
+
+        std::vector<uint32_t, vk_stl_allocator<uint32_t>> binSizes( tileCount, 0, threadPool.m_Allocator );
+
+        for( const RasterTriangleVector& triangles : triangleBatches )
+        {
+            for( const RasterTriangle& triangle : triangles )
+            {
+                forEachOverlappedTile( triangle, [&]( size_t tile ) {
+                    binEntries[ binOffsets[ tile ] + binSizes[ tile ]++ ] = &triangle;
+                } );
+            }
+        }
+
+        std::atomic<uint64_t> fragmentShaderInvocations( 0 );
+        std::atomic<uint64_t> samplesPassed( 0 );
+
+        // Tiles cover disjoint pixels, so they are rasterized in parallel without synchronization.
+        threadPool.ParallelFor( tileCount, [&]( size_t tile ) {
+            const int32_t tileMinX = std::max( ( firstTileX + int32_t( tile % tileCountX ) ) << g_TileSizeLog2, context.m_ClipMinX );
+            const int32_t tileMinY = std::max( ( firstTileY + int32_t( tile / tileCountX ) ) << g_TileSizeLog2, context.m_ClipMinY );
+            const int32_t tileMaxX = std::min( ( ( tileMinX >> g_TileSizeLog2 ) + 1 ) << g_TileSizeLog2, context.m_ClipMaxX );
+            const int32_t tileMaxY = std::min( ( ( tileMinY >> g_TileSizeLog2 ) + 1 ) << g_TileSizeLog2, context.m_ClipMaxY );
+
+            RasterStatistics tileStatistics = {};
+
+            for( uint32_t i = binOffsets[ tile ]; i < binOffsets[ tile + 1 ]; ++i )
+            {
+                RasterizeTriangle( context, *binEntries[ i ], tileMinX, tileMinY, tileMaxX, tileMaxY, tileStatistics );
+            }
+
+            fragmentShaderInvocations.fetch_add( tileStatistics.m_FragmentShaderInvocations, std::memory_order_relaxed );
+            samplesPassed.fetch_add( tileStatistics.m_SamplesPassed, std::memory_order_relaxed );
+        } );
+
+        statistics.m_FragmentShaderInvocations = fragmentShaderInvocations.load( std::memory_order_relaxed );
+        statistics.m_SamplesPassed = samplesPassed.load( std::memory_order_relaxed );
+        return statistics;
+    }
+}
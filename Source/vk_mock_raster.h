@@ -0,0 +1,167 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "vk_mock.h"
+#include "vk_mock_compute.h"
+#include "vk_mock_draw.h"
+#include "vk_mock_texel.h"
+#include <vulkan/vulkan.h>
+
+namespace vkmock
+{
+    struct ThreadPool;
+
+    static constexpr uint32_t g_MaxVertexBindings = 16;
+    static constexpr uint32_t g_MaxVertexAttributes = VK_MOCK_MAX_VERTEX_ATTRIBUTES_EXT;
+    static constexpr uint32_t g_MaxVaryings = VK_MOCK_MAX_VARYINGS_EXT;
+    static constexpr uint32_t g_MaxColorAttachments = VK_MOCK_MAX_COLOR_ATTACHMENTS_EXT;
+
+    enum GraphicsDynamicStateBits : uint32_t
+    {
+        eGraphicsDynamicStateViewport = 1,
+        eGraphicsDynamicStateScissor = 2,
+        eGraphicsDynamicStateBlendConstants = 4
+    };
+
+    struct VertexAttribute
+    {
+        uint32_t m_Binding;
+        uint32_t m_Offset;
+        TexelFormat m_Format;
+    };
+
+    /**
+     * @brief
+     *   Subset of the graphics pipeline state supported by the software rasterizer.
+     *   Attributes are indexed by the location, bindings by the binding number.
+     */
+    struct GraphicsPipelineState
+    {
+        uint32_t m_AttributeMask;
+        VertexAttribute m_Attributes[ g_MaxVertexAttributes ];
+        uint32_t m_BindingStrides[ g_MaxVertexBindings ];
+        VkVertexInputRate m_BindingInputRates[ g_MaxVertexBindings ];
+
+        VkPrimitiveTopology m_Topology;
+        bool m_RasterizerDiscardEnable;
+        bool m_DepthClampEnable;
+        VkCullModeFlags m_CullMode;
+        VkFrontFace m_FrontFace;
+
+        bool m_DepthTestEnable;
+        bool m_DepthWriteEnable;
+        VkCompareOp m_DepthCompareOp;
+
+        uint32_t m_ColorBlendAttachmentCount;
+        VkPipelineColorBlendAttachmentState m_ColorBlendAttachments[ g_MaxColorAttachments ];
+
+        uint32_t m_DynamicStateMask;
+        VkViewport m_Viewport;
+        VkRect2D m_Scissor;
+        float m_BlendConstants[ 4 ];
+
+        PFN_vkMockVertexKernelEXT m_pfnVertexKernel;
+        void* m_pVertexKernelUserData;
+        PFN_vkMockFragmentKernelEXT m_pfnFragmentKernel;
+        void* m_pFragmentKernelUserData;
+        uint32_t m_VaryingCount;
+    };
+
+    /**
+     * @brief
+     *   Attachments of the dynamic render pass started with vkCmdBeginRendering.
+     */
+    struct RenderingState
+    {
+        VkRect2D m_RenderArea;
+        uint32_t m_ColorAttachmentCount;
+        VkImageView m_ColorAttachments[ g_MaxColorAttachments ];
+        VkImageView m_DepthAttachment;
+    };
+
+    /**
+     * @brief
+     *   State captured by the draw commands, in addition to the bound pipeline and resources.
+     *   Static state of the pipeline replaces the dynamic state at record time.
+     */
+    struct DrawState
+    {
+        RenderingState m_Rendering;
+        VkViewport m_Viewport;
+        VkRect2D m_Scissor;
+        float m_BlendConstants[ 4 ];
+        VkBuffer m_VertexBuffers[ g_MaxVertexBindings ];
+        VkDeviceSize m_VertexBufferOffsets[ g_MaxVertexBindings ];
+        IndexBufferBinding m_IndexBuffer;
+    };
+
+    /**
+     * @brief
+     *   Graphics state of a command buffer.
+     */
+    struct GraphicsState
+    {
+        ComputeState m_Resources;
+        DrawState m_Draw;
+        bool m_Rendering;
+    };
+
+    /**
+     * @brief
+     *   Parameters of a draw. Indexed draws read vertexCount indices from pIndices,
+     *   and add the vertex offset to them.
+     */
+    struct DrawParameters
+    {
+        uint32_t m_VertexCount;
+        uint32_t m_InstanceCount;
+        uint32_t m_FirstVertex;
+        uint32_t m_FirstInstance;
+        int32_t m_VertexOffset;
+        uint32_t m_IndexSize;
+        const uint8_t* m_pIndices;
+    };
+
+    /**
+     * @brief
+     *   Work done by the rasterizer in a draw, reported to the queries.
+     */
+    struct RasterStatistics
+    {
+        uint64_t m_PrimitiveCount;
+        uint64_t m_FragmentShaderInvocations;
+        uint64_t m_SamplesPassed;
+    };
+
+    /**
+     * @brief
+     *   Get the number of primitives assembled from the vertices of a single instance.
+     */
+    uint32_t GetPrimitiveCount( VkPrimitiveTopology topology, uint32_t vertexCount );
+
+    /**
+     * @brief
+     *   Rasterize the triangles of a draw into the attachments.
+     *   Vertices are processed in parallel, then the clipped triangles are binned into
+     *   screen tiles in the API order, and the tiles are rasterized in parallel.
+     */
+    RasterStatistics DrawPrimitives( ThreadPool& threadPool, const ComputeState& resources, const DrawState& state, const DrawParameters& draw );
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_reflection.h"
+#include "vk_mock_icd_reflection.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace vkmock
+{
+    const ReflectionStructInfo* FindReflectionStructInfo( const char* pName )
+    {
+        // The generated names are sorted, including the aliases of the structures.
+        const ReflectionStructName* pEnd = g_ReflectionStructNames + std::size( g_ReflectionStructNames );
+        const ReflectionStructName* pStructName = std::lower_bound( g_ReflectionStructNames, pEnd, pName,
+            []( const ReflectionStructName& structName, const char* pName ) { return strcmp( structName.pName, pName ) < 0; } );
+
+        if( pStructName != pEnd && !strcmp( pStructName->pName, pName ) )
+        {
+            return pStructName->pStructInfo;
+        }
+
+        return nullptr;
+    }
+
+    const ReflectionStructInfo* FindReflectionStructInfo( VkStructureType sType )
+    {
+        for( const ReflectionStructName& structName : g_ReflectionStructNames )
+        {
+            if( structName.pStructInfo->sType == sType )
+            {
+                return structName.pStructInfo;
+            }
+        }
+
+        return nullptr;
+    }
+
+    const ReflectionMemberInfo* FindReflectionMemberInfo( const ReflectionStructInfo& structInfo, const char* pName )
+    {
+        for( uint32_t i = 0; i < structInfo.memberCount; ++i )
+        {
+            if( !strcmp( structInfo.pMembers[ i ].pName, pName ) )
+            {
+                return &structInfo.pMembers[ i ];
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool FindReflectionEnumValue( const ReflectionEnumInfo& enumInfo, const char* pName, uint64_t* pValue )
+    {
+        for( uint32_t i = 0; i < enumInfo.valueCount; ++i )
+        {
+            if( !strcmp( enumInfo.pValues[ i ].pName, pName ) )
+            {
+                *pValue = enumInfo.pValues[ i ].value;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    uint32_t GetReflectionTypeSize( ReflectionType type )
+    {
+        switch( type )
+        {
+        case ReflectionType::eUint8:
+        case ReflectionType::eChar:
+            return 1;
+        case ReflectionType::eUint64:
+        case ReflectionType::eFlags64:
+            return 8;
+        case ReflectionType::eSize:
+            return sizeof( size_t );
+        case ReflectionType::eStruct:
+            return 0;
+        default:
+            return 4;
+        }
+    }
+}
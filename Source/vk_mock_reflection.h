@@ -0,0 +1,101 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <vulkan/vulkan.h>
+
+namespace vkmock
+{
+    enum class ReflectionType : uint8_t
+    {
+        eBool32,
+        eUint8,
+        eChar,
+        eInt32,
+        eUint32,
+        eUint64,
+        eSize,
+        eFloat,
+        eEnum,
+        eFlags,
+        eFlags64,
+        eStruct
+    };
+
+    struct ReflectionEnumValue
+    {
+        const char* pName;
+        uint64_t value;
+    };
+
+    struct ReflectionEnumInfo
+    {
+        const ReflectionEnumValue* pValues;
+        uint32_t valueCount;
+    };
+
+    struct ReflectionStructInfo;
+
+    /**
+     * @brief
+     *   Describes a member of a Vulkan structure.
+     *   Arrays are described by a single member with the size of the whole array.
+     */
+    struct ReflectionMemberInfo
+    {
+        const char* pName;
+        ReflectionType type;
+        uint32_t offset;
+        uint32_t size;
+        const ReflectionEnumInfo* pEnumInfo;
+        const ReflectionStructInfo* pStructInfo;
+    };
+
+    /**
+     * @brief
+     *   Describes the layout of a Vulkan structure.
+     *   VkPhysicalDeviceProperties and VkPhysicalDeviceFeatures are identified by the sTypes
+     *   of the structures wrapping them. Other structures without sType, which are only
+     *   nested in other structures, have VK_STRUCTURE_TYPE_MAX_ENUM.
+     *   The tables are generated from vk.xml by gen_icd.py, and cover the structures of
+     *   the pNext chains of VkPhysicalDeviceProperties2 and VkPhysicalDeviceFeatures2.
+     */
+    struct ReflectionStructInfo
+    {
+        const char* pName;
+        VkStructureType sType;
+        uint32_t size;
+        const ReflectionMemberInfo* pMembers;
+        uint32_t memberCount;
+    };
+
+    struct ReflectionStructName
+    {
+        const char* pName;
+        const ReflectionStructInfo* pStructInfo;
+    };
+
+    const ReflectionStructInfo* FindReflectionStructInfo( const char* pName );
+    const ReflectionStructInfo* FindReflectionStructInfo( VkStructureType sType );
+    const ReflectionMemberInfo* FindReflectionMemberInfo( const ReflectionStructInfo& structInfo, const char* pName );
+    bool FindReflectionEnumValue( const ReflectionEnumInfo& enumInfo, const char* pName, uint64_t* pValue );
+
+    uint32_t GetReflectionTypeSize( ReflectionType type );
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "vk_mock.h"
+#include "vk_mock_icd_base.h"
+#include "vk_mock_icd_helpers.h"
+#include <algorithm>
+#include <vector>
+
+namespace vkmock
+{
+    struct ShaderModule
+    {
+        std::vector<uint32_t, vk_stl_allocator<uint32_t>> m_Code;
+        PFN_vkMockComputeKernelEXT m_pfnKernel;
+        PFN_vkMockVertexKernelEXT m_pfnVertexKernel;
+        PFN_vkMockFragmentKernelEXT m_pfnFragmentKernel;
+        uint32_t m_VaryingCount;
+        void* m_pKernelUserData;
+
+        explicit ShaderModule( const VkShaderModuleCreateInfo& createInfo )
+            : m_Code( createInfo.pCode, createInfo.pCode + createInfo.codeSize / sizeof( uint32_t ), g_CurrentAllocator )
+            , m_pfnKernel( nullptr )
+            , m_pfnVertexKernel( nullptr )
+            , m_pfnFragmentKernel( nullptr )
+            , m_VaryingCount( 0 )
+            , m_pKernelUserData( nullptr )
+        {
+        }
+
+        explicit ShaderModule( const VkMockComputeKernelCreateInfoEXT& createInfo )
+            : m_Code( g_CurrentAllocator )
+            , m_pfnKernel( createInfo.pfnKernel )
+            , m_pfnVertexKernel( nullptr )
+            , m_pfnFragmentKernel( nullptr )
+            , m_VaryingCount( 0 )
+            , m_pKernelUserData( createInfo.pUserData )
+        {
+        }
+
+        explicit ShaderModule( const VkMockGraphicsKernelCreateInfoEXT& createInfo )
+            : m_Code( g_CurrentAllocator )
+            , m_pfnKernel( nullptr )
+            , m_pfnVertexKernel( createInfo.pfnVertexKernel )
+            , m_pfnFragmentKernel( createInfo.pfnFragmentKernel )
+            , m_VaryingCount( std::min<uint32_t>( createInfo.varyingCount, VK_MOCK_MAX_VARYINGS_EXT ) )
+            , m_pKernelUserData( createInfo.pUserData )
+        {
+        }
+    };
+}
+
+struct VkShaderModule_T : vkmock::ShaderModule
+{
+    using ShaderModule::ShaderModule;
+};
@@ -0,0 +1,90 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_simd.h"
+
+#ifdef VK_MOCK_X86
+namespace vkmock
+{
+#ifdef _MSC_VER
+    // Check OSXSAVE and AVX support, and that the OS saves the YMM registers.
+    static bool HasAvxState()
+    {
+        int info[ 4 ];
+        __cpuid( info, 1 );
+        return ( info[ 2 ] & ( ( 1 << 27 ) | ( 1 << 28 ) ) ) == ( ( 1 << 27 ) | ( 1 << 28 ) ) &&
+            ( _xgetbv( 0 ) & 6 ) == 6;
+    }
+#endif
+
+    static bool HasAvx2()
+    {
+#if defined( __AVX2__ )
+        return true;
+#elif defined( __GNUC__ ) || defined( __clang__ )
+        return __builtin_cpu_supports( "avx2" );
+#elif defined( _MSC_VER )
+        int info[ 4 ];
+        __cpuid( info, 0 );
+        if( info[ 0 ] < 7 || !HasAvxState() )
+        {
+            return false;
+        }
+
+        __cpuidex( info, 7, 0 );
+        return ( info[ 1 ] & ( 1 << 5 ) ) != 0;
+#else
+        return false;
+#endif
+    }
+
+    static bool HasF16c()
+    {
+#if defined( __F16C__ )
+        return true;
+#elif defined( __GNUC__ ) || defined( __clang__ )
+        return __builtin_cpu_supports( "f16c" );
+#elif defined( _MSC_VER )
+        if( !HasAvxState() )
+        {
+            return false;
+        }
+
+        int info[ 4 ];
+        __cpuid( info, 1 );
+        return ( info[ 2 ] & ( 1 << 29 ) ) != 0;
+#else
+        return false;
+#endif
+    }
+
+    bool vk_cpu_has_avx2()
+    {
+        static const bool hasAvx2 = HasAvx2();
+        return hasAvx2;
+    }
+
+    bool vk_cpu_has_f16c()
+    {
+        static const bool hasF16c = HasF16c();
+        return hasF16c;
+    }
+}
+#endif
@@ -0,0 +1,61 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// Selects the vector instruction set of the target architecture.
+// SSE2 and NEON are always available on the 64-bit targets, 32-bit x86 targets
+// use the SSE2 kernels only if the compiler targets SSE2, and fall back to the
+// scalar code otherwise. AVX2 kernels are compiled with VK_MOCK_TARGET_AVX2
+// and selected at runtime.
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ ) || defined( _M_IX86 )
+#define VK_MOCK_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define VK_MOCK_SSE2 1
+#endif
+#elif defined( __aarch64__ ) || defined( _M_ARM64 ) || defined( __ARM_NEON )
+#define VK_MOCK_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined( VK_MOCK_SSE2 ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#define VK_MOCK_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#define VK_MOCK_TARGET_F16C __attribute__( ( target( "avx,f16c" ) ) )
+#else
+#define VK_MOCK_TARGET_AVX2
+#define VK_MOCK_TARGET_F16C
+#endif
+
+#ifdef VK_MOCK_X86
+namespace vkmock
+{
+    /**
+     * @brief
+     *   Check whether the CPU and the OS support the instruction set extensions.
+     *   The result is computed once.
+     */
+    bool vk_cpu_has_avx2();
+    bool vk_cpu_has_f16c();
+}
+#endif
@@ -0,0 +1,180 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <algorithm>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <utility>
+
+namespace vkmock
+{
+    /**
+     * @brief
+     *   Free blocks released by threads that have exited, or by threads that
+     *   free more objects than they allocate. Shared by all threads.
+     */
+    struct SlabDepot
+    {
+        std::mutex m_Mutex;
+        void* m_pFreeList = nullptr;
+        size_t m_FreeCount = 0;
+    };
+
+    /**
+     * @brief
+     *   Per-thread cache of fixed-size blocks for objects of type T.
+     *   Blocks are carved from slabs allocated with malloc, which are kept
+     *   for the lifetime of the process and recycled through the free lists.
+     */
+    template<typename T>
+    struct SlabCache
+    {
+        static constexpr size_t g_BlockAlignment = std::max( alignof( T ), alignof( void* ) );
+        static constexpr size_t g_BlockSize = ( std::max( sizeof( T ), sizeof( void* ) ) + g_BlockAlignment - 1 ) & ~( g_BlockAlignment - 1 );
+        static constexpr size_t g_BlocksPerSlab = std::max<size_t>( 64 * 1024 / g_BlockSize, 16 );
+
+        // Slabs are allocated with malloc, so only fundamental alignments are supported.
+        static constexpr bool g_Supported = alignof( T ) <= alignof( max_align_t );
+
+        void* m_pFreeList = nullptr;
+        size_t m_FreeCount = 0;
+
+        SlabCache() = default;
+        SlabCache( const SlabCache& ) = delete;
+        SlabCache& operator=( const SlabCache& ) = delete;
+
+        ~SlabCache()
+        {
+            // Hand the cached blocks over to the other threads.
+            Flush( m_FreeCount );
+        }
+
+        void* Allocate()
+        {
+            if( !m_pFreeList )
+            {
+                Refill();
+            }
+
+            void* pBlock = m_pFreeList;
+            if( pBlock )
+            {
+                m_pFreeList = Next( pBlock );
+                m_FreeCount--;
+            }
+
+            return pBlock;
+        }
+
+        void Free( void* pBlock )
+        {
+            Next( pBlock ) = m_pFreeList;
+            m_pFreeList = pBlock;
+            m_FreeCount++;
+
+            // Threads that release objects created by other threads would
+            // accumulate blocks indefinitely, so return the excess to the depot.
+            if( m_FreeCount >= 2 * g_BlocksPerSlab )
+            {
+                Flush( g_BlocksPerSlab );
+            }
+        }
+
+    private:
+        static void*& Next( void* pBlock )
+        {
+            return *static_cast<void**>( pBlock );
+        }
+
+        static SlabDepot& Depot()
+        {
+            // Intentionally leaked, the depot must outlive thread_local caches.
+            static SlabDepot* pDepot = new SlabDepot();
+            return *pDepot;
+        }
+
+        void Refill()
+        {
+            SlabDepot& depot = Depot();
+            {
+                std::scoped_lock lock( depot.m_Mutex );
+                m_pFreeList = std::exchange( depot.m_pFreeList, nullptr );
+                m_FreeCount = std::exchange( depot.m_FreeCount, 0 );
+            }
+
+            if( m_pFreeList )
+            {
+                return;
+            }
+
+            uint8_t* pSlab = static_cast<uint8_t*>( malloc( g_BlockSize * g_BlocksPerSlab ) );
+            if( !pSlab )
+            {
+                return;
+            }
+
+            for( size_t i = g_BlocksPerSlab; i > 0; --i )
+            {
+                void* pBlock = pSlab + ( i - 1 ) * g_BlockSize;
+                Next( pBlock ) = m_pFreeList;
+                m_pFreeList = pBlock;
+            }
+
+            m_FreeCount = g_BlocksPerSlab;
+        }
+
+        void Flush( size_t count )
+        {
+            if( !count || !m_pFreeList )
+            {
+                return;
+            }
+
+            // Detach the first count blocks from the local list.
+            void* pFirst = m_pFreeList;
+            void* pLast = pFirst;
+            size_t flushed = 1;
+            while( flushed < count && Next( pLast ) )
+            {
+                pLast = Next( pLast );
+                flushed++;
+            }
+
+            m_pFreeList = std::exchange( Next( pLast ), nullptr );
+            m_FreeCount -= flushed;
+
+            SlabDepot& depot = Depot();
+            std::scoped_lock lock( depot.m_Mutex );
+            Next( pLast ) = depot.m_pFreeList;
+            depot.m_pFreeList = pFirst;
+            depot.m_FreeCount += flushed;
+        }
+    };
+
+    template<typename T>
+    inline SlabCache<T>& vk_slab_cache() noexcept
+    {
+        thread_local SlabCache<T> cache;
+        return cache;
+    }
+}
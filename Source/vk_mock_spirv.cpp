@@ -0,0 +1,4003 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_spirv.h"
+
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <string.h>
+
+namespace vkmock
+{
+    // Subset of the SPIR-V enumerants used by the interpreter.
+    namespace spv
+    {
+        static constexpr uint32_t MagicNumber = 0x07230203;
+
+        enum Op : uint32_t
+        {
+            OpNop = 0,
+            OpUndef = 1,
+            OpLine = 8,
+            OpExtInstImport = 11,
+            OpExtInst = 12,
+            OpEntryPoint = 15,
+            OpExecutionMode = 16,
+            OpTypeVoid = 19,
+            OpTypeBool = 20,
+            OpTypeInt = 21,
+            OpTypeFloat = 22,
+            OpTypeVector = 23,
+            OpTypeMatrix = 24,
+            OpTypeArray = 28,
+            OpTypeRuntimeArray = 29,
+            OpTypeStruct = 30,
+            OpTypePointer = 32,
+            OpConstantTrue = 41,
+            OpConstantFalse = 42,
+            OpConstant = 43,
+            OpConstantComposite = 44,
+            OpConstantNull = 46,
+            OpSpecConstantTrue = 48,
+            OpSpecConstantFalse = 49,
+            OpSpecConstant = 50,
+            OpSpecConstantComposite = 51,
+            OpSpecConstantOp = 52,
+            OpFunction = 54,
+            OpFunctionParameter = 55,
+            OpFunctionEnd = 56,
+            OpFunctionCall = 57,
+            OpVariable = 59,
+            OpLoad = 61,
+            OpStore = 62,
+            OpCopyMemory = 63,
+            OpAccessChain = 65,
+            OpInBoundsAccessChain = 66,
+            OpArrayLength = 68,
+            OpDecorate = 71,
+            OpMemberDecorate = 72,
+            OpVectorExtractDynamic = 77,
+            OpVectorInsertDynamic = 78,
+            OpVectorShuffle = 79,
+            OpCompositeConstruct = 80,
+            OpCompositeExtract = 81,
+            OpCompositeInsert = 82,
+            OpCopyObject = 83,
+            OpTranspose = 84,
+            OpConvertFToU = 109,
+            OpConvertFToS = 110,
+            OpConvertSToF = 111,
+            OpConvertUToF = 112,
+            OpUConvert = 113,
+            OpSConvert = 114,
+            OpFConvert = 115,
+            OpBitcast = 124,
+            OpSNegate = 126,
+            OpFNegate = 127,
+            OpIAdd = 128,
+            OpFAdd = 129,
+            OpISub = 130,
+            OpFSub = 131,
+            OpIMul = 132,
+            OpFMul = 133,
+            OpUDiv = 134,
+            OpSDiv = 135,
+            OpFDiv = 136,
+            OpUMod = 137,
+            OpSRem = 138,
+            OpSMod = 139,
+            OpFRem = 140,
+            OpFMod = 141,
+            OpVectorTimesScalar = 142,
+            OpMatrixTimesScalar = 143,
+            OpVectorTimesMatrix = 144,
+            OpMatrixTimesVector = 145,
+            OpMatrixTimesMatrix = 146,
+            OpOuterProduct = 147,
+            OpDot = 148,
+            OpAny = 154,
+            OpAll = 155,
+            OpIsNan = 156,
+            OpIsInf = 157,
+            OpLogicalEqual = 164,
+            OpLogicalNotEqual = 165,
+            OpLogicalOr = 166,
+            OpLogicalAnd = 167,
+            OpLogicalNot = 168,
+            OpSelect = 169,
+            OpIEqual = 170,
+            OpINotEqual = 171,
+            OpUGreaterThan = 172,
+            OpSGreaterThan = 173,
+            OpUGreaterThanEqual = 174,
+            OpSGreaterThanEqual = 175,
+            OpULessThan = 176,
+            OpSLessThan = 177,
+            OpULessThanEqual = 178,
+            OpSLessThanEqual = 179,
+            OpFOrdEqual = 180,
+            OpFUnordEqual = 181,
+            OpFOrdNotEqual = 182,
+            OpFUnordNotEqual = 183,
+            OpFOrdLessThan = 184,
+            OpFUnordLessThan = 185,
+            OpFOrdGreaterThan = 186,
+            OpFUnordGreaterThan = 187,
+            OpFOrdLessThanEqual = 188,
+            OpFUnordLessThanEqual = 189,
+            OpFOrdGreaterThanEqual = 190,
+            OpFUnordGreaterThanEqual = 191,
+            OpShiftRightLogical = 194,
+            OpShiftRightArithmetic = 195,
+            OpShiftLeftLogical = 196,
+            OpBitwiseOr = 197,
+            OpBitwiseXor = 198,
+            OpBitwiseAnd = 199,
+            OpNot = 200,
+            OpBitFieldInsert = 201,
+            OpBitFieldSExtract = 202,
+            OpBitFieldUExtract = 203,
+            OpBitReverse = 204,
+            OpBitCount = 205,
+            OpControlBarrier = 224,
+            OpMemoryBarrier = 225,
+            OpAtomicLoad = 227,
+            OpAtomicStore = 228,
+            OpAtomicExchange = 229,
+            OpAtomicCompareExchange = 230,
+            OpAtomicIIncrement = 232,
+            OpAtomicIDecrement = 233,
+            OpAtomicIAdd = 234,
+            OpAtomicISub = 235,
+            OpAtomicSMin = 236,
+            OpAtomicUMin = 237,
+            OpAtomicSMax = 238,
+            OpAtomicUMax = 239,
+            OpAtomicAnd = 240,
+            OpAtomicOr = 241,
+            OpAtomicXor = 242,
+            OpPhi = 245,
+            OpLoopMerge = 246,
+            OpSelectionMerge = 247,
+            OpLabel = 248,
+            OpBranch = 249,
+            OpBranchConditional = 250,
+            OpSwitch = 251,
+            OpKill = 252,
+            OpReturn = 253,
+            OpReturnValue = 254,
+            OpUnreachable = 255,
+            OpNoLine = 317,
+            OpExecutionModeId = 331,
+            OpGroupNonUniformElect = 333,
+            OpGroupNonUniformAll = 334,
+            OpGroupNonUniformAny = 335,
+            OpGroupNonUniformAllEqual = 336,
+            OpGroupNonUniformBroadcast = 337,
+            OpGroupNonUniformBroadcastFirst = 338,
+            OpGroupNonUniformBallot = 339,
+            OpGroupNonUniformInverseBallot = 340,
+            OpGroupNonUniformBallotBitExtract = 341,
+            OpGroupNonUniformBallotBitCount = 342,
+            OpGroupNonUniformBallotFindLSB = 343,
+            OpGroupNonUniformBallotFindMSB = 344,
+            OpGroupNonUniformShuffle = 345,
+            OpGroupNonUniformShuffleXor = 346,
+            OpGroupNonUniformShuffleUp = 347,
+            OpGroupNonUniformShuffleDown = 348,
+            OpGroupNonUniformIAdd = 349,
+            OpGroupNonUniformFAdd = 350,
+            OpGroupNonUniformIMul = 351,
+            OpGroupNonUniformFMul = 352,
+            OpGroupNonUniformSMin = 353,
+            OpGroupNonUniformUMin = 354,
+            OpGroupNonUniformFMin = 355,
+            OpGroupNonUniformSMax = 356,
+            OpGroupNonUniformUMax = 357,
+            OpGroupNonUniformFMax = 358,
+            OpGroupNonUniformBitwiseAnd = 359,
+            OpGroupNonUniformBitwiseOr = 360,
+            OpGroupNonUniformBitwiseXor = 361,
+            OpGroupNonUniformLogicalAnd = 362,
+            OpGroupNonUniformLogicalOr = 363,
+            OpGroupNonUniformLogicalXor = 364,
+            OpTerminateInvocation = 4416,
+        };
+
+        enum Decoration : uint32_t
+        {
+            DecorationSpecId = 1,
+            DecorationRowMajor = 4,
+            DecorationArrayStride = 6,
+            DecorationMatrixStride = 7,
+            DecorationBuiltIn = 11,
+            DecorationBinding = 33,
+            DecorationDescriptorSet = 34,
+            DecorationOffset = 35,
+        };
+
+        enum StorageClass : uint32_t
+        {
+            StorageClassUniformConstant = 0,
+            StorageClassInput = 1,
+            StorageClassUniform = 2,
+            StorageClassOutput = 3,
+            StorageClassWorkgroup = 4,
+            StorageClassPrivate = 6,
+            StorageClassFunction = 7,
+            StorageClassPushConstant = 9,
+            StorageClassStorageBuffer = 12,
+        };
+
+        enum BuiltIn : uint32_t
+        {
+            BuiltInNumWorkgroups = 24,
+            BuiltInWorkgroupSize = 25,
+            BuiltInWorkgroupId = 26,
+            BuiltInLocalInvocationId = 27,
+            BuiltInGlobalInvocationId = 28,
+            BuiltInLocalInvocationIndex = 29,
+            BuiltInSubgroupSize = 36,
+            BuiltInNumSubgroups = 38,
+            BuiltInSubgroupId = 40,
+            BuiltInSubgroupLocalInvocationId = 41,
+            BuiltInSubgroupEqMask = 4416,
+            BuiltInSubgroupGeMask = 4417,
+            BuiltInSubgroupGtMask = 4418,
+            BuiltInSubgroupLeMask = 4419,
+            BuiltInSubgroupLtMask = 4420,
+        };
+
+        enum ExecutionModel : uint32_t
+        {
+            ExecutionModelGLCompute = 5,
+        };
+
+        enum ExecutionMode : uint32_t
+        {
+            ExecutionModeLocalSize = 17,
+            ExecutionModeLocalSizeId = 38,
+        };
+
+        enum Scope : uint32_t
+        {
+            ScopeSubgroup = 3,
+        };
+
+        enum GroupOperation : uint32_t
+        {
+            GroupOperationReduce = 0,
+            GroupOperationInclusiveScan = 1,
+            GroupOperationExclusiveScan = 2,
+            GroupOperationClusteredReduce = 3,
+        };
+
+        enum GLSLstd450 : uint32_t
+        {
+            GLSLstd450Round = 1,
+            GLSLstd450RoundEven = 2,
+            GLSLstd450Trunc = 3,
+            GLSLstd450FAbs = 4,
+            GLSLstd450SAbs = 5,
+            GLSLstd450FSign = 6,
+            GLSLstd450SSign = 7,
+            GLSLstd450Floor = 8,
+            GLSLstd450Ceil = 9,
+            GLSLstd450Fract = 10,
+            GLSLstd450Radians = 11,
+            GLSLstd450Degrees = 12,
+            GLSLstd450Sin = 13,
+            GLSLstd450Cos = 14,
+            GLSLstd450Tan = 15,
+            GLSLstd450Asin = 16,
+            GLSLstd450Acos = 17,
+            GLSLstd450Atan = 18,
+            GLSLstd450Sinh = 19,
+            GLSLstd450Cosh = 20,
+            GLSLstd450Tanh = 21,
+            GLSLstd450Atan2 = 25,
+            GLSLstd450Pow = 26,
+            GLSLstd450Exp = 27,
+            GLSLstd450Log = 28,
+            GLSLstd450Exp2 = 29,
+            GLSLstd450Log2 = 30,
+            GLSLstd450Sqrt = 31,
+            GLSLstd450InverseSqrt = 32,
+            GLSLstd450FMin = 37,
+            GLSLstd450UMin = 38,
+            GLSLstd450SMin = 39,
+            GLSLstd450FMax = 40,
+            GLSLstd450UMax = 41,
+            GLSLstd450SMax = 42,
+            GLSLstd450FClamp = 43,
+            GLSLstd450UClamp = 44,
+            GLSLstd450SClamp = 45,
+            GLSLstd450FMix = 46,
+            GLSLstd450Step = 48,
+            GLSLstd450SmoothStep = 49,
+            GLSLstd450Fma = 50,
+            GLSLstd450Length = 66,
+            GLSLstd450Distance = 67,
+            GLSLstd450Cross = 68,
+            GLSLstd450Normalize = 69,
+            GLSLstd450FaceForward = 70,
+            GLSLstd450Reflect = 71,
+            GLSLstd450FindILsb = 73,
+            GLSLstd450FindSMsb = 74,
+            GLSLstd450FindUMsb = 75,
+            GLSLstd450NMin = 79,
+            GLSLstd450NMax = 80,
+            GLSLstd450NClamp = 81,
+        };
+    }
+
+    static constexpr uint32_t g_InvalidOffset = UINT32_MAX;
+    static constexpr uint32_t g_MaxCallDepth = 16;
+
+    // Limit of the ids in a module, which bounds the memory used by the decoder.
+    static constexpr uint32_t g_MaxIdBound = 1 << 22;
+
+    enum SpirvInvocationState
+    {
+        eSpirvInvocationRunning,
+        eSpirvInvocationSubgroupWait,
+        eSpirvInvocationBarrierWait,
+        eSpirvInvocationDone
+    };
+
+    struct SpirvCallFrame
+    {
+        uint32_t m_ReturnPc;
+        uint32_t m_Result;
+        uint32_t m_ResultSize;
+    };
+
+    struct SpirvInvocation
+    {
+        uint8_t* m_pMemory;
+        const uint32_t* m_pExtraOperands;
+        uint32_t m_Pc;
+        SpirvInvocationState m_State;
+        uint32_t m_PreviousBlock;
+        uint32_t m_SubgroupInvocationId;
+        uint32_t m_CallDepth;
+        SpirvCallFrame m_CallStack[ g_MaxCallDepth ];
+    };
+
+    template<typename T>
+    static inline T* GetValue( SpirvInvocation& invocation, uint32_t offset )
+    {
+        return reinterpret_cast<T*>( invocation.m_pMemory + offset );
+    }
+
+    static inline uint8_t* GetPointer( SpirvInvocation& invocation, uint32_t offset )
+    {
+        return *GetValue<uint8_t*>( invocation, offset );
+    }
+
+    static inline const uint32_t* GetExtraOperands( const SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        return invocation.m_pExtraOperands + instruction.m_FirstExtraOperand;
+    }
+
+    static inline bool ToBool( uint32_t value )
+    {
+        return value != 0;
+    }
+
+    static inline int32_t ToSigned( uint32_t value )
+    {
+        int32_t result;
+        memcpy( &result, &value, sizeof( result ) );
+        return result;
+    }
+
+    static inline uint32_t FindMsb( uint32_t value )
+    {
+        uint32_t msb = UINT32_MAX;
+        for( uint32_t bit = 0; bit < 32; ++bit )
+        {
+            if( value & ( 1U << bit ) )
+            {
+                msb = bit;
+            }
+        }
+        return msb;
+    }
+
+    static inline uint32_t FindLsb( uint32_t value )
+    {
+        for( uint32_t bit = 0; bit < 32; ++bit )
+        {
+            if( value & ( 1U << bit ) )
+            {
+                return bit;
+            }
+        }
+        return UINT32_MAX;
+    }
+
+    static inline uint32_t CountBits( uint32_t value )
+    {
+        uint32_t count = 0;
+        for( ; value; value &= value - 1 )
+        {
+            count++;
+        }
+        return count;
+    }
+
+    // Operations applied to each component of the operands.
+    // Integer arithmetic wraps around, and the results undefined by the specification
+    // (division by zero, too large shifts, out of range conversions) are clamped.
+    struct SpirvIAdd { static uint32_t Execute( uint32_t a, uint32_t b ) { return a + b; } static uint32_t Identity() { return 0; } };
+    struct SpirvISub { static uint32_t Execute( uint32_t a, uint32_t b ) { return a - b; } };
+    struct SpirvIMul { static uint32_t Execute( uint32_t a, uint32_t b ) { return a * b; } static uint32_t Identity() { return 1; } };
+    struct SpirvUDiv { static uint32_t Execute( uint32_t a, uint32_t b ) { return b ? a / b : UINT32_MAX; } };
+    struct SpirvUMod { static uint32_t Execute( uint32_t a, uint32_t b ) { return b ? a % b : 0; } };
+    struct SpirvSNegate { static uint32_t Execute( uint32_t a ) { return 0U - a; } };
+    struct SpirvUMin { static uint32_t Execute( uint32_t a, uint32_t b ) { return std::min( a, b ); } static uint32_t Identity() { return UINT32_MAX; } };
+    struct SpirvUMax { static uint32_t Execute( uint32_t a, uint32_t b ) { return std::max( a, b ); } static uint32_t Identity() { return 0; } };
+    struct SpirvSMin { static int32_t Execute( int32_t a, int32_t b ) { return std::min( a, b ); } static int32_t Identity() { return INT32_MAX; } };
+    struct SpirvSMax { static int32_t Execute( int32_t a, int32_t b ) { return std::max( a, b ); } static int32_t Identity() { return INT32_MIN; } };
+    struct SpirvUClamp { static uint32_t Execute( uint32_t x, uint32_t lo, uint32_t hi ) { return std::min( std::max( x, lo ), hi ); } };
+    struct SpirvSClamp { static int32_t Execute( int32_t x, int32_t lo, int32_t hi ) { return std::min( std::max( x, lo ), hi ); } };
+    struct SpirvSAbs { static uint32_t Execute( int32_t a ) { return a < 0 ? 0U - uint32_t( a ) : uint32_t( a ); } };
+    struct SpirvSSign { static int32_t Execute( int32_t a ) { return ( a > 0 ) - ( a < 0 ); } };
+
+    struct SpirvSDiv
+    {
+        static int32_t Execute( int32_t a, int32_t b )
+        {
+            if( b == 0 )
+            {
+                return -1;
+            }
+            if( b == -1 )
+            {
+                return ToSigned( 0U - uint32_t( a ) );
+            }
+            return a / b;
+        }
+    };
+
+    struct SpirvSRem
+    {
+        static int32_t Execute( int32_t a, int32_t b )
+        {
+            return ( b == 0 || b == -1 ) ? 0 : a % b;
+        }
+    };
+
+    struct SpirvSMod
+    {
+        static int32_t Execute( int32_t a, int32_t b )
+        {
+            int32_t r = SpirvSRem::Execute( a, b );
+            if( r != 0 && ( ( r < 0 ) != ( b < 0 ) ) )
+            {
+                r += b;
+            }
+            return r;
+        }
+    };
+
+    struct SpirvShiftLeftLogical { static uint32_t Execute( uint32_t a, uint32_t b ) { return a << ( b & 31 ); } };
+    struct SpirvShiftRightLogical { static uint32_t Execute( uint32_t a, uint32_t b ) { return a >> ( b & 31 ); } };
+    struct SpirvShiftRightArithmetic { static int32_t Execute( int32_t a, uint32_t b ) { return a >> ( b & 31 ); } };
+    struct SpirvBitwiseAnd { static uint32_t Execute( uint32_t a, uint32_t b ) { return a & b; } static uint32_t Identity() { return UINT32_MAX; } };
+    struct SpirvBitwiseOr { static uint32_t Execute( uint32_t a, uint32_t b ) { return a | b; } static uint32_t Identity() { return 0; } };
+    struct SpirvBitwiseXor { static uint32_t Execute( uint32_t a, uint32_t b ) { return a ^ b; } static uint32_t Identity() { return 0; } };
+    struct SpirvNot { static uint32_t Execute( uint32_t a ) { return ~a; } };
+    struct SpirvBitCount { static uint32_t Execute( uint32_t a ) { return CountBits( a ); } };
+    struct SpirvFindILsb { static uint32_t Execute( uint32_t a ) { return FindLsb( a ); } };
+    struct SpirvFindUMsb { static uint32_t Execute( uint32_t a ) { return FindMsb( a ); } };
+    struct SpirvFindSMsb { static uint32_t Execute( int32_t a ) { return FindMsb( a < 0 ? ~uint32_t( a ) : uint32_t( a ) ); } };
+
+    struct SpirvBitReverse
+    {
+        static uint32_t Execute( uint32_t a )
+        {
+            uint32_t result = 0;
+            for( uint32_t bit = 0; bit < 32; ++bit )
+            {
+                result |= ( ( a >> bit ) & 1 ) << ( 31 - bit );
+            }
+            return result;
+        }
+    };
+
+    struct SpirvLogicalAnd { static uint32_t Execute( uint32_t a, uint32_t b ) { return ToBool( a ) && ToBool( b ); } static uint32_t Identity() { return 1; } };
+    struct SpirvLogicalOr { static uint32_t Execute( uint32_t a, uint32_t b ) { return ToBool( a ) || ToBool( b ); } static uint32_t Identity() { return 0; } };
+    struct SpirvLogicalNotEqual { static uint32_t Execute( uint32_t a, uint32_t b ) { return ToBool( a ) != ToBool( b ); } static uint32_t Identity() { return 0; } };
+    struct SpirvLogicalEqual { static uint32_t Execute( uint32_t a, uint32_t b ) { return ToBool( a ) == ToBool( b ); } };
+    struct SpirvLogicalNot { static uint32_t Execute( uint32_t a ) { return !ToBool( a ); } };
+
+    struct SpirvEqual { template<typename T> static uint32_t Execute( T a, T b ) { return a == b; } };
+    struct SpirvNotEqual { template<typename T> static uint32_t Execute( T a, T b ) { return a != b; } };
+    struct SpirvLessThan { template<typename T> static uint32_t Execute( T a, T b ) { return a < b; } };
+    struct SpirvLessThanEqual { template<typename T> static uint32_t Execute( T a, T b ) { return a <= b; } };
+    struct SpirvGreaterThan { template<typename T> static uint32_t Execute( T a, T b ) { return a > b; } };
+    struct SpirvGreaterThanEqual { template<typename T> static uint32_t Execute( T a, T b ) { return a >= b; } };
+
+    // Unordered comparisons are true when any of the operands is NaN.
+    template<typename Operation>
+    struct SpirvUnordered
+    {
+        static uint32_t Execute( float a, float b ) { return std::isnan( a ) || std::isnan( b ) || Operation::Execute( a, b ); }
+    };
+
+    // Ordered comparisons are false when any of the operands is NaN.
+    struct SpirvOrderedNotEqual
+    {
+        static uint32_t Execute( float a, float b ) { return !std::isnan( a ) && !std::isnan( b ) && a != b; }
+    };
+
+    struct SpirvFAdd { static float Execute( float a, float b ) { return a + b; } static float Identity() { return 0.0f; } };
+    struct SpirvFSub { static float Execute( float a, float b ) { return a - b; } };
+    struct SpirvFMul { static float Execute( float a, float b ) { return a * b; } static float Identity() { return 1.0f; } };
+    struct SpirvFDiv { static float Execute( float a, float b ) { return a / b; } };
+    struct SpirvFRem { static float Execute( float a, float b ) { return std::fmod( a, b ); } };
+    struct SpirvFMod { static float Execute( float a, float b ) { return a - b * std::floor( a / b ); } };
+    struct SpirvFNegate { static float Execute( float a ) { return -a; } };
+    struct SpirvFMin { static float Execute( float a, float b ) { return std::fmin( a, b ); } static float Identity() { return std::numeric_limits<float>::infinity(); } };
+    struct SpirvFMax { static float Execute( float a, float b ) { return std::fmax( a, b ); } static float Identity() { return -std::numeric_limits<float>::infinity(); } };
+    struct SpirvFClamp { static float Execute( float x, float lo, float hi ) { return std::fmin( std::fmax( x, lo ), hi ); } };
+    struct SpirvFMix { static float Execute( float x, float y, float a ) { return x * ( 1.0f - a ) + y * a; } };
+    struct SpirvFma { static float Execute( float a, float b, float c ) { return std::fma( a, b, c ); } };
+    struct SpirvStep { static float Execute( float edge, float x ) { return x < edge ? 0.0f : 1.0f; } };
+    struct SpirvIsNan { static uint32_t Execute( float a ) { return std::isnan( a ); } };
+    struct SpirvIsInf { static uint32_t Execute( float a ) { return std::isinf( a ); } };
+
+    struct SpirvSmoothStep
+    {
+        static float Execute( float edge0, float edge1, float x )
+        {
+            const float t = std::fmin( std::fmax( ( x - edge0 ) / ( edge1 - edge0 ), 0.0f ), 1.0f );
+            return t * t * ( 3.0f - 2.0f * t );
+        }
+    };
+
+    struct SpirvRound { static float Execute( float a ) { return std::round( a ); } };
+    struct SpirvRoundEven { static float Execute( float a ) { return std::nearbyint( a ); } };
+    struct SpirvTrunc { static float Execute( float a ) { return std::trunc( a ); } };
+    struct SpirvFAbs { static float Execute( float a ) { return std::fabs( a ); } };
+    struct SpirvFSign { static float Execute( float a ) { return float( ( a > 0.0f ) - ( a < 0.0f ) ); } };
+    struct SpirvFloor { static float Execute( float a ) { return std::floor( a ); } };
+    struct SpirvCeil { static float Execute( float a ) { return std::ceil( a ); } };
+    struct SpirvFract { static float Execute( float a ) { return a - std::floor( a ); } };
+    struct SpirvRadians { static float Execute( float a ) { return a * 0.01745329251994329577f; } };
+    struct SpirvDegrees { static float Execute( float a ) { return a * 57.2957795130823208768f; } };
+    struct SpirvSin { static float Execute( float a ) { return std::sin( a ); } };
+    struct SpirvCos { static float Execute( float a ) { return std::cos( a ); } };
+    struct SpirvTan { static float Execute( float a ) { return std::tan( a ); } };
+    struct SpirvAsin { static float Execute( float a ) { return std::asin( a ); } };
+    struct SpirvAcos { static float Execute( float a ) { return std::acos( a ); } };
+    struct SpirvAtan { static float Execute( float a ) { return std::atan( a ); } };
+    struct SpirvSinh { static float Execute( float a ) { return std::sinh( a ); } };
+    struct SpirvCosh { static float Execute( float a ) { return std::cosh( a ); } };
+    struct SpirvTanh { static float Execute( float a ) { return std::tanh( a ); } };
+    struct SpirvAtan2 { static float Execute( float y, float x ) { return std::atan2( y, x ); } };
+    struct SpirvPow { static float Execute( float x, float y ) { return std::pow( x, y ); } };
+    struct SpirvExp { static float Execute( float a ) { return std::exp( a ); } };
+    struct SpirvLog { static float Execute( float a ) { return std::log( a ); } };
+    struct SpirvExp2 { static float Execute( float a ) { return std::exp2( a ); } };
+    struct SpirvLog2 { static float Execute( float a ) { return std::log2( a ); } };
+    struct SpirvSqrt { static float Execute( float a ) { return std::sqrt( a ); } };
+    struct SpirvInverseSqrt { static float Execute( float a ) { return 1.0f / std::sqrt( a ); } };
+
+    struct SpirvConvertFToU
+    {
+        static uint32_t Execute( float a )
+        {
+            if( !( a > 0.0f ) )
+            {
+                return 0;
+            }
+            return a < 4294967296.0f ? uint32_t( a ) : UINT32_MAX;
+        }
+    };
+
+    struct SpirvConvertFToS
+    {
+        static int32_t Execute( float a )
+        {
+            if( std::isnan( a ) )
+            {
+                return 0;
+            }
+            if( a <= -2147483648.0f )
+            {
+                return INT32_MIN;
+            }
+            return a < 2147483648.0f ? int32_t( a ) : INT32_MAX;
+        }
+    };
+
+    struct SpirvConvertSToF { static float Execute( int32_t a ) { return float( a ); } };
+    struct SpirvConvertUToF { static float Execute( uint32_t a ) { return float( a ); } };
+
+    // Atomic read-modify-write operations, which take the previous value and the operand.
+    struct SpirvAtomicExchange { static uint32_t Execute( uint32_t, uint32_t b ) { return b; } };
+    struct SpirvAtomicIIncrement { static uint32_t Execute( uint32_t a, uint32_t ) { return a + 1; } };
+    struct SpirvAtomicIDecrement { static uint32_t Execute( uint32_t a, uint32_t ) { return a - 1; } };
+
+    template<typename Operation, typename T, typename R>
+    static void ExecuteUnary( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        R* pResult = GetValue<R>( invocation, instruction.m_Result );
+        const T* pA = GetValue<T>( invocation, instruction.m_Operands[ 0 ] );
+
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            pResult[ i ] = Operation::Execute( pA[ i ] );
+        }
+    }
+
+    template<typename Operation, typename T, typename R>
+    static void ExecuteBinary( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        R* pResult = GetValue<R>( invocation, instruction.m_Result );
+        const T* pA = GetValue<T>( invocation, instruction.m_Operands[ 0 ] );
+        const T* pB = GetValue<T>( invocation, instruction.m_Operands[ 1 ] );
+
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            pResult[ i ] = Operation::Execute( pA[ i ], pB[ i ] );
+        }
+    }
+
+    // Shifts take the shift amounts as unsigned integers regardless of the type of the base.
+    template<typename Operation, typename T>
+    static void ExecuteShift( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        T* pResult = GetValue<T>( invocation, instruction.m_Result );
+        const T* pBase = GetValue<T>( invocation, instruction.m_Operands[ 0 ] );
+        const uint32_t* pShift = GetValue<uint32_t>( invocation, instruction.m_Operands[ 1 ] );
+
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            pResult[ i ] = Operation::Execute( pBase[ i ], pShift[ i ] );
+        }
+    }
+
+    template<typename Operation, typename T>
+    static void ExecuteTernary( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        T* pResult = GetValue<T>( invocation, instruction.m_Result );
+        const T* pA = GetValue<T>( invocation, instruction.m_Operands[ 0 ] );
+        const T* pB = GetValue<T>( invocation, instruction.m_Operands[ 1 ] );
+        const T* pC = GetValue<T>( invocation, instruction.m_Operands[ 2 ] );
+
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            pResult[ i ] = Operation::Execute( pA[ i ], pB[ i ], pC[ i ] );
+        }
+    }
+
+    static void ExecuteVectorTimesScalar( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        float* pResult = GetValue<float>( invocation, instruction.m_Result );
+        const float* pVector = GetValue<float>( invocation, instruction.m_Operands[ 0 ] );
+        const float scalar = *GetValue<float>( invocation, instruction.m_Operands[ 1 ] );
+
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            pResult[ i ] = pVector[ i ] * scalar;
+        }
+    }
+
+    static float Dot( const float* pA, const float* pB, uint32_t count )
+    {
+        float result = 0.0f;
+        for( uint32_t i = 0; i < count; ++i )
+        {
+            result += pA[ i ] * pB[ i ];
+        }
+        return result;
+    }
+
+    static void ExecuteDot( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        *GetValue<float>( invocation, instruction.m_Result ) = Dot(
+            GetValue<float>( invocation, instruction.m_Operands[ 0 ] ),
+            GetValue<float>( invocation, instruction.m_Operands[ 1 ] ),
+            instruction.m_Count );
+    }
+
+    // Matrices are stored as arrays of columns.
+    static void ExecuteMatrixTimesVector( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        float* pResult = GetValue<float>( invocation, instruction.m_Result );
+        const float* pMatrix = GetValue<float>( invocation, instruction.m_Operands[ 0 ] );
+        const float* pVector = GetValue<float>( invocation, instruction.m_Operands[ 1 ] );
+        const uint32_t rows = instruction.m_Operands[ 2 ];
+        const uint32_t columns = instruction.m_Operands[ 3 ];
+
+        for( uint32_t row = 0; row < rows; ++row )
+        {
+            float sum = 0.0f;
+            for( uint32_t column = 0; column < columns; ++column )
+            {
+                sum += pMatrix[ column * rows + row ] * pVector[ column ];
+            }
+            pResult[ row ] = sum;
+        }
+    }
+
+    static void ExecuteVectorTimesMatrix( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        float* pResult = GetValue<float>( invocation, instruction.m_Result );
+        const float* pVector = GetValue<float>( invocation, instruction.m_Operands[ 0 ] );
+        const float* pMatrix = GetValue<float>( invocation, instruction.m_Operands[ 1 ] );
+        const uint32_t rows = instruction.m_Operands[ 2 ];
+
+        for( uint32_t column = 0; column < instruction.m_Count; ++column )
+        {
+            pResult[ column ] = Dot( pVector, pMatrix + column * rows, rows );
+        }
+    }
+
+    static void ExecuteMatrixTimesMatrix( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        float* pResult = GetValue<float>( invocation, instruction.m_Result );
+        const float* pLeft = GetValue<float>( invocation, instruction.m_Operands[ 0 ] );
+        const float* pRight = GetValue<float>( invocation, instruction.m_Operands[ 1 ] );
+        const uint32_t rows = instruction.m_Operands[ 2 ];
+        const uint32_t inner = instruction.m_Operands[ 3 ];
+
+        for( uint32_t column = 0; column < instruction.m_Count; ++column )
+        {
+            for( uint32_t row = 0; row < rows; ++row )
+            {
+                float sum = 0.0f;
+                for( uint32_t k = 0; k < inner; ++k )
+                {
+                    sum += pLeft[ k * rows + row ] * pRight[ column * inner + k ];
+                }
+                pResult[ column * rows + row ] = sum;
+            }
+        }
+    }
+
+    static void ExecuteOuterProduct( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        float* pResult = GetValue<float>( invocation, instruction.m_Result );
+        const float* pLeft = GetValue<float>( invocation, instruction.m_Operands[ 0 ] );
+        const float* pRight = GetValue<float>( invocation, instruction.m_Operands[ 1 ] );
+        const uint32_t rows = instruction.m_Operands[ 2 ];
+
+        for( uint32_t column = 0; column < instruction.m_Count; ++column )
+        {
+            for( uint32_t row = 0; row < rows; ++row )
+            {
+                pResult[ column * rows + row ] = pLeft[ row ] * pRight[ column ];
+            }
+        }
+    }
+
+    static void ExecuteTranspose( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        uint32_t* pResult = GetValue<uint32_t>( invocation, instruction.m_Result );
+        const uint32_t* pMatrix = GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] );
+        const uint32_t rows = instruction.m_Operands[ 2 ];
+        const uint32_t columns = instruction.m_Count;
+
+        for( uint32_t column = 0; column < columns; ++column )
+        {
+            for( uint32_t row = 0; row < rows; ++row )
+            {
+                pResult[ row * columns + column ] = pMatrix[ column * rows + row ];
+            }
+        }
+    }
+
+    static void ExecuteLength( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const float* pVector = GetValue<float>( invocation, instruction.m_Operands[ 0 ] );
+        *GetValue<float>( invocation, instruction.m_Result ) = std::sqrt( Dot( pVector, pVector, instruction.m_Count ) );
+    }
+
+    static void ExecuteDistance( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const float* pA = GetValue<float>( invocation, instruction.m_Operands[ 0 ] );
+        const float* pB = GetValue<float>( invocation, instruction.m_Operands[ 1 ] );
+
+        float sum = 0.0f;
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            sum += ( pA[ i ] - pB[ i ] ) * ( pA[ i ] - pB[ i ] );
+        }
+        *GetValue<float>( invocation, instruction.m_Result ) = std::sqrt( sum );
+    }
+
+    static void ExecuteNormalize( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        float* pResult = GetValue<float>( invocation, instruction.m_Result );
+        const float* pVector = GetValue<float>( invocation, instruction.m_Operands[ 0 ] );
+        const float length = std::sqrt( Dot( pVector, pVector, instruction.m_Count ) );
+
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            pResult[ i ] = pVector[ i ] / length;
+        }
+    }
+
+    static void ExecuteCross( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        float* pResult = GetValue<float>( invocation, instruction.m_Result );
+        const float* pA = GetValue<float>( invocation, instruction.m_Operands[ 0 ] );
+        const float* pB = GetValue<float>( invocation, instruction.m_Operands[ 1 ] );
+
+        pResult[ 0 ] = pA[ 1 ] * pB[ 2 ] - pB[ 1 ] * pA[ 2 ];
+        pResult[ 1 ] = pA[ 2 ] * pB[ 0 ] - pB[ 2 ] * pA[ 0 ];
+        pResult[ 2 ] = pA[ 0 ] * pB[ 1 ] - pB[ 0 ] * pA[ 1 ];
+    }
+
+    static void ExecuteFaceForward( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        float* pResult = GetValue<float>( invocation, instruction.m_Result );
+        const float* pN = GetValue<float>( invocation, instruction.m_Operands[ 0 ] );
+        const float* pI = GetValue<float>( invocation, instruction.m_Operands[ 1 ] );
+        const float* pNref = GetValue<float>( invocation, instruction.m_Operands[ 2 ] );
+        const float sign = Dot( pNref, pI, instruction.m_Count ) < 0.0f ? 1.0f : -1.0f;
+
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            pResult[ i ] = sign * pN[ i ];
+        }
+    }
+
+    static void ExecuteReflect( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        float* pResult = GetValue<float>( invocation, instruction.m_Result );
+        const float* pI = GetValue<float>( invocation, instruction.m_Operands[ 0 ] );
+        const float* pN = GetValue<float>( invocation, instruction.m_Operands[ 1 ] );
+        const float dot = Dot( pN, pI, instruction.m_Count );
+
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            pResult[ i ] = pI[ i ] - 2.0f * dot * pN[ i ];
+        }
+    }
+
+    static void ExecuteAny( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const uint32_t* pVector = GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] );
+
+        uint32_t result = 0;
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            result |= ToBool( pVector[ i ] );
+        }
+        *GetValue<uint32_t>( invocation, instruction.m_Result ) = result;
+    }
+
+    static void ExecuteAll( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const uint32_t* pVector = GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] );
+
+        uint32_t result = 1;
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            result &= ToBool( pVector[ i ] );
+        }
+        *GetValue<uint32_t>( invocation, instruction.m_Result ) = result;
+    }
+
+    static void ExecuteSelectComponents( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        uint32_t* pResult = GetValue<uint32_t>( invocation, instruction.m_Result );
+        const uint32_t* pCondition = GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] );
+        const uint32_t* pA = GetValue<uint32_t>( invocation, instruction.m_Operands[ 1 ] );
+        const uint32_t* pB = GetValue<uint32_t>( invocation, instruction.m_Operands[ 2 ] );
+
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            pResult[ i ] = ToBool( pCondition[ i ] ) ? pA[ i ] : pB[ i ];
+        }
+    }
+
+    static void ExecuteSelectObject( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const uint32_t condition = *GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] );
+        const uint32_t source = ToBool( condition ) ? instruction.m_Operands[ 1 ] : instruction.m_Operands[ 2 ];
+        memcpy( invocation.m_pMemory + instruction.m_Result, invocation.m_pMemory + source, instruction.m_Count );
+    }
+
+    static void ExecuteBitFieldInsert( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        uint32_t* pResult = GetValue<uint32_t>( invocation, instruction.m_Result );
+        const uint32_t* pBase = GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] );
+        const uint32_t* pInsert = GetValue<uint32_t>( invocation, instruction.m_Operands[ 1 ] );
+        const uint32_t offset = std::min( *GetValue<uint32_t>( invocation, instruction.m_Operands[ 2 ] ), 32U );
+        const uint32_t count = std::min( *GetValue<uint32_t>( invocation, instruction.m_Operands[ 3 ] ), 32U - offset );
+        const uint32_t mask = count ? ( UINT32_MAX >> ( 32 - count ) ) << offset : 0;
+
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            pResult[ i ] = ( pBase[ i ] & ~mask ) | ( ( pInsert[ i ] << ( offset & 31 ) ) & mask );
+        }
+    }
+
+    template<bool Signed>
+    static void ExecuteBitFieldExtract( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        uint32_t* pResult = GetValue<uint32_t>( invocation, instruction.m_Result );
+        const uint32_t* pBase = GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] );
+        const uint32_t offset = std::min( *GetValue<uint32_t>( invocation, instruction.m_Operands[ 1 ] ), 32U );
+        const uint32_t count = std::min( *GetValue<uint32_t>( invocation, instruction.m_Operands[ 2 ] ), 32U - offset );
+
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            if( count == 0 )
+            {
+                pResult[ i ] = 0;
+                continue;
+            }
+
+            const uint32_t bits = ( pBase[ i ] >> ( offset & 31 ) ) & ( UINT32_MAX >> ( 32 - count ) );
+            const bool negative = Signed && ( bits & ( 1U << ( count - 1 ) ) );
+            pResult[ i ] = ( negative && count < 32 ) ? bits | ( UINT32_MAX << count ) : bits;
+        }
+    }
+
+    static void ExecuteCopy( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        memcpy( invocation.m_pMemory + instruction.m_Result, invocation.m_pMemory + instruction.m_Operands[ 0 ], instruction.m_Count );
+    }
+
+    static void ExecuteCompositeInsert( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        uint8_t* pResult = invocation.m_pMemory + instruction.m_Result;
+        memcpy( pResult, invocation.m_pMemory + instruction.m_Operands[ 0 ], instruction.m_Count );
+        memcpy( pResult + instruction.m_Operands[ 2 ], invocation.m_pMemory + instruction.m_Operands[ 1 ], instruction.m_Operands[ 3 ] );
+    }
+
+    // Extra operands are triples of the destination offset, the source offset and the size.
+    static void ExecuteCompositeConstruct( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const uint32_t* pOperands = GetExtraOperands( invocation, instruction );
+        uint8_t* pResult = invocation.m_pMemory + instruction.m_Result;
+
+        for( uint32_t i = 0; i < instruction.m_ExtraOperandCount; i += 3 )
+        {
+            memcpy( pResult + pOperands[ i ], invocation.m_pMemory + pOperands[ i + 1 ], pOperands[ i + 2 ] );
+        }
+    }
+
+    // Extra operands are offsets of the source components.
+    static void ExecuteVectorShuffle( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const uint32_t* pOperands = GetExtraOperands( invocation, instruction );
+        uint32_t* pResult = GetValue<uint32_t>( invocation, instruction.m_Result );
+
+        for( uint32_t i = 0; i < instruction.m_ExtraOperandCount; ++i )
+        {
+            pResult[ i ] = *GetValue<uint32_t>( invocation, pOperands[ i ] );
+        }
+    }
+
+    static void ExecuteVectorExtractDynamic( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const uint32_t* pVector = GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] );
+        const uint32_t index = *GetValue<uint32_t>( invocation, instruction.m_Operands[ 1 ] );
+        *GetValue<uint32_t>( invocation, instruction.m_Result ) = index < instruction.m_Count ? pVector[ index ] : 0;
+    }
+
+    static void ExecuteVectorInsertDynamic( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        uint32_t* pResult = GetValue<uint32_t>( invocation, instruction.m_Result );
+        const uint32_t index = *GetValue<uint32_t>( invocation, instruction.m_Operands[ 2 ] );
+        memcpy( pResult, GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] ), instruction.m_Count * sizeof( uint32_t ) );
+
+        if( index < instruction.m_Count )
+        {
+            pResult[ index ] = *GetValue<uint32_t>( invocation, instruction.m_Operands[ 1 ] );
+        }
+    }
+
+    // Loads from unbound descriptors return zeros and stores to them are discarded.
+    static void ExecuteLoad( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const uint8_t* pSource = GetPointer( invocation, instruction.m_Operands[ 0 ] );
+        uint8_t* pResult = invocation.m_pMemory + instruction.m_Result;
+
+        if( pSource )
+        {
+            memcpy( pResult, pSource, instruction.m_Count );
+        }
+        else
+        {
+            memset( pResult, 0, instruction.m_Count );
+        }
+    }
+
+    static void ExecuteStore( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        if( uint8_t* pTarget = GetPointer( invocation, instruction.m_Operands[ 0 ] ) )
+        {
+            memcpy( pTarget, invocation.m_pMemory + instruction.m_Operands[ 1 ], instruction.m_Count );
+        }
+    }
+
+    static void ExecuteCopyMemory( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        uint8_t* pTarget = GetPointer( invocation, instruction.m_Operands[ 0 ] );
+        const uint8_t* pSource = GetPointer( invocation, instruction.m_Operands[ 1 ] );
+
+        if( pTarget && pSource )
+        {
+            memmove( pTarget, pSource, instruction.m_Count );
+        }
+    }
+
+    static void ExecuteVariable( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        uint8_t* pStorage = invocation.m_pMemory + instruction.m_Operands[ 0 ];
+        *GetValue<uint8_t*>( invocation, instruction.m_Result ) = pStorage;
+
+        if( instruction.m_Operands[ 1 ] != g_InvalidOffset )
+        {
+            memcpy( pStorage, invocation.m_pMemory + instruction.m_Operands[ 1 ], instruction.m_Count );
+        }
+        else
+        {
+            memset( pStorage, 0, instruction.m_Count );
+        }
+    }
+
+    // Constant indices are folded into the offset of the instruction.
+    // Extra operands are pairs of the stride and the offset of the dynamic index.
+    static void ExecuteAccessChain( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        uint8_t* pBase = GetPointer( invocation, instruction.m_Operands[ 0 ] );
+
+        // Variables with arrays of descriptors point to the tables of the descriptor addresses.
+        if( instruction.m_Operands[ 1 ] != g_InvalidOffset && pBase )
+        {
+            const uint32_t index = *GetValue<uint32_t>( invocation, instruction.m_Operands[ 1 ] );
+            const VkDeviceSize descriptorCount = *GetValue<VkDeviceSize>( invocation, instruction.m_Operands[ 2 ] );
+            pBase = index < descriptorCount ? reinterpret_cast<uint8_t**>( pBase )[ index ] : nullptr;
+        }
+
+        if( pBase )
+        {
+            const uint32_t* pOperands = GetExtraOperands( invocation, instruction );
+
+            ptrdiff_t offset = instruction.m_Count;
+            for( uint32_t i = 0; i < instruction.m_ExtraOperandCount; i += 2 )
+            {
+                offset += ptrdiff_t( pOperands[ i ] ) * *GetValue<int32_t>( invocation, pOperands[ i + 1 ] );
+            }
+            pBase += offset;
+        }
+
+        *GetValue<uint8_t*>( invocation, instruction.m_Result ) = pBase;
+    }
+
+    static void ExecuteArrayLength( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const VkDeviceSize range = *GetValue<VkDeviceSize>( invocation, instruction.m_Operands[ 0 ] );
+        const VkDeviceSize offset = instruction.m_Operands[ 1 ];
+        const VkDeviceSize stride = instruction.m_Operands[ 2 ];
+
+        *GetValue<uint32_t>( invocation, instruction.m_Result ) = ( range > offset )
+            ? static_cast<uint32_t>( std::min<VkDeviceSize>( ( range - offset ) / stride, UINT32_MAX ) )
+            : 0;
+    }
+
+    static_assert( sizeof( std::atomic<uint32_t> ) == sizeof( uint32_t ), "Atomic operations require lock-free 32-bit atomics." );
+
+    static inline std::atomic<uint32_t>* GetAtomic( SpirvInvocation& invocation, uint32_t offset )
+    {
+        return reinterpret_cast<std::atomic<uint32_t>*>( GetPointer( invocation, offset ) );
+    }
+
+    template<typename Operation, typename T>
+    static void ExecuteAtomic( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        std::atomic<uint32_t>* pAtomic = GetAtomic( invocation, instruction.m_Operands[ 0 ] );
+        const uint32_t value = ( instruction.m_Operands[ 1 ] != g_InvalidOffset ) ? *GetValue<uint32_t>( invocation, instruction.m_Operands[ 1 ] ) : 0;
+
+        uint32_t previous = 0;
+        if( pAtomic )
+        {
+            previous = pAtomic->load( std::memory_order_relaxed );
+            while( !pAtomic->compare_exchange_weak( previous, uint32_t( Operation::Execute( T( previous ), T( value ) ) ) ) )
+            {
+            }
+        }
+
+        *GetValue<uint32_t>( invocation, instruction.m_Result ) = previous;
+    }
+
+    static void ExecuteAtomicLoad( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        std::atomic<uint32_t>* pAtomic = GetAtomic( invocation, instruction.m_Operands[ 0 ] );
+        *GetValue<uint32_t>( invocation, instruction.m_Result ) = pAtomic ? pAtomic->load() : 0;
+    }
+
+    static void ExecuteAtomicStore( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        if( std::atomic<uint32_t>* pAtomic = GetAtomic( invocation, instruction.m_Operands[ 0 ] ) )
+        {
+            pAtomic->store( *GetValue<uint32_t>( invocation, instruction.m_Operands[ 1 ] ) );
+        }
+    }
+
+    static void ExecuteAtomicCompareExchange( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        std::atomic<uint32_t>* pAtomic = GetAtomic( invocation, instruction.m_Operands[ 0 ] );
+        uint32_t expected = *GetValue<uint32_t>( invocation, instruction.m_Operands[ 2 ] );
+
+        if( pAtomic )
+        {
+            pAtomic->compare_exchange_strong( expected, *GetValue<uint32_t>( invocation, instruction.m_Operands[ 1 ] ) );
+        }
+        else
+        {
+            expected = 0;
+        }
+
+        *GetValue<uint32_t>( invocation, instruction.m_Result ) = expected;
+    }
+
+    static void ExecuteMemoryBarrier( SpirvInvocation&, const SpirvInstruction& )
+    {
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+    }
+
+    static void ExecuteControlBarrier( SpirvInvocation& invocation, const SpirvInstruction& )
+    {
+        invocation.m_State = eSpirvInvocationBarrierWait;
+    }
+
+    // Subgroup operations suspend the invocation until all active invocations of the subgroup reach them.
+    static void ExecuteSubgroupWait( SpirvInvocation& invocation, const SpirvInstruction& )
+    {
+        invocation.m_State = eSpirvInvocationSubgroupWait;
+    }
+
+    static void ExecuteBranch( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        invocation.m_PreviousBlock = instruction.m_Operands[ 1 ];
+        invocation.m_Pc = instruction.m_Operands[ 0 ];
+    }
+
+    static void ExecuteBranchConditional( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const uint32_t condition = *GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] );
+        invocation.m_PreviousBlock = instruction.m_Operands[ 3 ];
+        invocation.m_Pc = ToBool( condition ) ? instruction.m_Operands[ 1 ] : instruction.m_Operands[ 2 ];
+    }
+
+    // Extra operands are pairs of the literal and the target.
+    static void ExecuteSwitch( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const uint32_t* pOperands = GetExtraOperands( invocation, instruction );
+        const uint32_t selector = *GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] );
+
+        invocation.m_PreviousBlock = instruction.m_Operands[ 2 ];
+        invocation.m_Pc = instruction.m_Operands[ 1 ];
+
+        for( uint32_t i = 0; i < instruction.m_ExtraOperandCount; i += 2 )
+        {
+            if( pOperands[ i ] == selector )
+            {
+                invocation.m_Pc = pOperands[ i + 1 ];
+                break;
+            }
+        }
+    }
+
+    // Extra operands are triples of the parameter offset, the argument offset and the size.
+    static void ExecuteFunctionCall( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        if( invocation.m_CallDepth == g_MaxCallDepth )
+        {
+            invocation.m_State = eSpirvInvocationDone;
+            return;
+        }
+
+        const uint32_t* pOperands = GetExtraOperands( invocation, instruction );
+        for( uint32_t i = 0; i < instruction.m_ExtraOperandCount; i += 3 )
+        {
+            memcpy( invocation.m_pMemory + pOperands[ i ], invocation.m_pMemory + pOperands[ i + 1 ], pOperands[ i + 2 ] );
+        }
+
+        SpirvCallFrame& frame = invocation.m_CallStack[ invocation.m_CallDepth++ ];
+        frame.m_ReturnPc = invocation.m_Pc;
+        frame.m_Result = instruction.m_Result;
+        frame.m_ResultSize = instruction.m_Count;
+
+        invocation.m_Pc = instruction.m_Operands[ 0 ];
+    }
+
+    static void ExecuteReturn( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        if( invocation.m_CallDepth == 0 )
+        {
+            invocation.m_State = eSpirvInvocationDone;
+            return;
+        }
+
+        const SpirvCallFrame& frame = invocation.m_CallStack[ --invocation.m_CallDepth ];
+        if( instruction.m_Operands[ 0 ] != g_InvalidOffset )
+        {
+            memcpy( invocation.m_pMemory + frame.m_Result, invocation.m_pMemory + instruction.m_Operands[ 0 ], frame.m_ResultSize );
+        }
+
+        invocation.m_Pc = frame.m_ReturnPc;
+    }
+
+    static void ExecuteTerminate( SpirvInvocation& invocation, const SpirvInstruction& )
+    {
+        invocation.m_State = eSpirvInvocationDone;
+    }
+
+    // All phis at the beginning of a block are grouped in a single instruction and evaluated
+    // simultaneously, because they may refer to each other. Extra operands are the result offset,
+    // the size and the number of the incoming blocks for each phi, followed by the pairs
+    // of the block label and the value offset.
+    static void ExecutePhi( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const uint32_t* pOperands = GetExtraOperands( invocation, instruction );
+        uint8_t* pScratch = invocation.m_pMemory + instruction.m_Operands[ 0 ];
+
+        const uint32_t* pPhi = pOperands;
+        uint32_t scratchOffset = 0;
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            const uint32_t size = pPhi[ 1 ];
+            const uint32_t incomingCount = pPhi[ 2 ];
+
+            for( uint32_t j = 0; j < incomingCount; ++j )
+            {
+                if( pPhi[ 3 + 2 * j ] == invocation.m_PreviousBlock )
+                {
+                    memcpy( pScratch + scratchOffset, invocation.m_pMemory + pPhi[ 4 + 2 * j ], size );
+                    break;
+                }
+            }
+
+            scratchOffset += size;
+            pPhi += 3 + 2 * incomingCount;
+        }
+
+        pPhi = pOperands;
+        scratchOffset = 0;
+        for( uint32_t i = 0; i < instruction.m_Count; ++i )
+        {
+            memcpy( invocation.m_pMemory + pPhi[ 0 ], pScratch + scratchOffset, pPhi[ 1 ] );
+            scratchOffset += pPhi[ 1 ];
+            pPhi += 3 + 2 * pPhi[ 2 ];
+        }
+    }
+
+    static void ExecuteInverseBallot( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const uint32_t* pBallot = GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] );
+        *GetValue<uint32_t>( invocation, instruction.m_Result ) = ( pBallot[ 0 ] >> invocation.m_SubgroupInvocationId ) & 1;
+    }
+
+    static void ExecuteBallotBitExtract( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const uint32_t* pBallot = GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] );
+        const uint32_t index = *GetValue<uint32_t>( invocation, instruction.m_Operands[ 1 ] );
+        *GetValue<uint32_t>( invocation, instruction.m_Result ) = index < 128 ? ( pBallot[ index / 32 ] >> ( index % 32 ) ) & 1 : 0;
+    }
+
+    static void ExecuteBallotBitCount( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        const uint32_t* pBallot = GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] );
+        const uint32_t id = invocation.m_SubgroupInvocationId;
+
+        uint32_t mask = ( 1U << g_SpirvSubgroupSize ) - 1;
+        if( instruction.m_Operands[ 1 ] == spv::GroupOperationInclusiveScan )
+        {
+            mask &= ( 2U << id ) - 1;
+        }
+        if( instruction.m_Operands[ 1 ] == spv::GroupOperationExclusiveScan )
+        {
+            mask &= ( 1U << id ) - 1;
+        }
+
+        *GetValue<uint32_t>( invocation, instruction.m_Result ) = CountBits( pBallot[ 0 ] & mask );
+    }
+
+    static void ExecuteBallotFindLsb( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        *GetValue<uint32_t>( invocation, instruction.m_Result ) = FindLsb( *GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] ) );
+    }
+
+    static void ExecuteBallotFindMsb( SpirvInvocation& invocation, const SpirvInstruction& instruction )
+    {
+        *GetValue<uint32_t>( invocation, instruction.m_Result ) = FindMsb( *GetValue<uint32_t>( invocation, instruction.m_Operands[ 0 ] ) );
+    }
+
+    // Group handlers receive the active invocations of the subgroup ordered by their subgroup invocation ids.
+    static void ExecuteGroupSync( SpirvInvocation* const*, uint32_t, const SpirvInstruction& )
+    {
+    }
+
+    static void ExecuteGroupElect( SpirvInvocation* const* ppInvocations, uint32_t invocationCount, const SpirvInstruction& instruction )
+    {
+        for( uint32_t i = 0; i < invocationCount; ++i )
+        {
+            *GetValue<uint32_t>( *ppInvocations[ i ], instruction.m_Result ) = ( i == 0 );
+        }
+    }
+
+    template<bool All>
+    static void ExecuteGroupVote( SpirvInvocation* const* ppInvocations, uint32_t invocationCount, const SpirvInstruction& instruction )
+    {
+        uint32_t result = All;
+        for( uint32_t i = 0; i < invocationCount; ++i )
+        {
+            const bool predicate = ToBool( *GetValue<uint32_t>( *ppInvocations[ i ], instruction.m_Operands[ 0 ] ) );
+            result = All ? ( result && predicate ) : ( result || predicate );
+        }
+
+        for( uint32_t i = 0; i < invocationCount; ++i )
+        {
+            *GetValue<uint32_t>( *ppInvocations[ i ], instruction.m_Result ) = result;
+        }
+    }
+
+    static void ExecuteGroupAllEqual( SpirvInvocation* const* ppInvocations, uint32_t invocationCount, const SpirvInstruction& instruction )
+    {
+        const uint8_t* pFirst = GetValue<uint8_t>( *ppInvocations[ 0 ], instruction.m_Operands[ 0 ] );
+
+        uint32_t result = 1;
+        for( uint32_t i = 1; i < invocationCount; ++i )
+        {
+            result &= memcmp( pFirst, GetValue<uint8_t>( *ppInvocations[ i ], instruction.m_Operands[ 0 ] ), instruction.m_Count ) == 0;
+        }
+
+        for( uint32_t i = 0; i < invocationCount; ++i )
+        {
+            *GetValue<uint32_t>( *ppInvocations[ i ], instruction.m_Result ) = result;
+        }
+    }
+
+    static void ExecuteGroupBallot( SpirvInvocation* const* ppInvocations, uint32_t invocationCount, const SpirvInstruction& instruction )
+    {
+        uint32_t mask = 0;
+        for( uint32_t i = 0; i < invocationCount; ++i )
+        {
+            if( ToBool( *GetValue<uint32_t>( *ppInvocations[ i ], instruction.m_Operands[ 0 ] ) ) )
+            {
+                mask |= 1U << ppInvocations[ i ]->m_SubgroupInvocationId;
+            }
+        }
+
+        for( uint32_t i = 0; i < invocationCount; ++i )
+        {
+            uint32_t* pResult = GetValue<uint32_t>( *ppInvocations[ i ], instruction.m_Result );
+            pResult[ 0 ] = mask;
+            pResult[ 1 ] = 0;
+            pResult[ 2 ] = 0;
+            pResult[ 3 ] = 0;
+        }
+    }
+
+    // Source of the value read by each invocation in the shuffles and broadcasts.
+    struct SpirvBroadcast { static uint32_t Execute( uint32_t, uint32_t operand ) { return operand; } };
+    struct SpirvShuffleXor { static uint32_t Execute( uint32_t id, uint32_t operand ) { return id ^ operand; } };
+    struct SpirvShuffleUp { static uint32_t Execute( uint32_t id, uint32_t operand ) { return id - operand; } };
+    struct SpirvShuffleDown { static uint32_t Execute( uint32_t id, uint32_t operand ) { return id + operand; } };
+
+    // Invocations reading from inactive invocations keep their own values.
+    template<typename Operation>
+    static void ExecuteGroupShuffle( SpirvInvocation* const* ppInvocations, uint32_t invocationCount, const SpirvInstruction& instruction )
+    {
+        SpirvInvocation* pInvocationsById[ g_SpirvSubgroupSize ] = {};
+        for( uint32_t i = 0; i < invocationCount; ++i )
+        {
+            pInvocationsById[ ppInvocations[ i ]->m_SubgroupInvocationId ] = ppInvocations[ i ];
+        }
+
+        for( uint32_t i = 0; i < invocationCount; ++i )
+        {
+            SpirvInvocation& invocation = *ppInvocations[ i ];
+
+            // The operand of the broadcasts is dynamically uniform and has no source in the shuffles.
+            const uint32_t operand = ( instruction.m_Operands[ 1 ] != g_InvalidOffset )
+                ? *GetValue<uint32_t>( invocation, instruction.m_Operands[ 1 ] )
+                : ppInvocations[ 0 ]->m_SubgroupInvocationId;
+
+            const uint32_t sourceId = Operation::Execute( invocation.m_SubgroupInvocationId, operand );
+
+            SpirvInvocation* pSource = &invocation;
+            if( sourceId < g_SpirvSubgroupSize && pInvocationsById[ sourceId ] )
+            {
+                pSource = pInvocationsById[ sourceId ];
+            }
+
+            memcpy( GetValue<uint8_t>( invocation, instruction.m_Result ), GetValue<uint8_t>( *pSource, instruction.m_Operands[ 0 ] ), instruction.m_Count );
+        }
+    }
+
+    template<typename Operation, typename T>
+    static void ExecuteGroupArithmetic( SpirvInvocation* const* ppInvocations, uint32_t invocationCount, const SpirvInstruction& instruction )
+    {
+        const uint32_t operation = instruction.m_Operands[ 1 ];
+
+        uint32_t clusterSize = g_SpirvSubgroupSize;
+        if( operation == spv::GroupOperationClusteredReduce )
+        {
+            clusterSize = std::max( *GetValue<uint32_t>( *ppInvocations[ 0 ], instruction.m_Operands[ 2 ] ), 1U );
+        }
+
+        for( uint32_t component = 0; component < instruction.m_Count; ++component )
+        {
+            uint32_t first = 0;
+            while( first < invocationCount )
+            {
+                // Find the invocations of the cluster, which is the whole subgroup for the non-clustered operations.
+                const uint32_t cluster = ppInvocations[ first ]->m_SubgroupInvocationId / clusterSize;
+                uint32_t last = first;
+                while( last < invocationCount && ppInvocations[ last ]->m_SubgroupInvocationId / clusterSize == cluster )
+                {
+                    last++;
+                }
+
+                T accumulator = Operation::Identity();
+                for( uint32_t i = first; i < last; ++i )
+                {
+                    const T value = GetValue<T>( *ppInvocations[ i ], instruction.m_Operands[ 0 ] )[ component ];
+                    T* pResult = GetValue<T>( *ppInvocations[ i ], instruction.m_Result ) + component;
+
+                    if( operation == spv::GroupOperationExclusiveScan )
+                    {
+                        *pResult = accumulator;
+                    }
+
+                    accumulator = Operation::Execute( accumulator, value );
+
+                    if( operation == spv::GroupOperationInclusiveScan )
+                    {
+                        *pResult = accumulator;
+                    }
+                }
+
+                if( operation == spv::GroupOperationReduce || operation == spv::GroupOperationClusteredReduce )
+                {
+                    for( uint32_t i = first; i < last; ++i )
+                    {
+                        GetValue<T>( *ppInvocations[ i ], instruction.m_Result )[ component ] = accumulator;
+                    }
+                }
+
+                first = last;
+            }
+        }
+    }
+
+    // Limit of the memory of a single invocation.
+    static constexpr uint32_t g_MaxInvocationMemorySize = 1024 * 1024;
+
+    /**
+     * @brief
+     *   Decoder state of a single id of the module.
+     */
+    struct SpirvId
+    {
+        uint32_t m_Opcode = 0;
+        uint32_t m_Type = 0;
+        uint32_t m_Offset = g_InvalidOffset;
+        bool m_Constant = false;
+        bool m_NonSemantic = false;
+
+        // Types.
+        uint32_t m_Size = 0;
+        uint32_t m_Alignment = 4;
+        uint32_t m_Width = 0;
+        uint32_t m_ElementType = 0;
+        uint32_t m_Length = 0;
+        uint32_t m_Stride = 0;
+        uint32_t m_FirstMember = 0;
+        uint32_t m_StorageClass = 0;
+
+        // Decorations.
+        uint32_t m_ArrayStride = 0;
+        uint32_t m_BuiltIn = UINT32_MAX;
+        uint32_t m_SpecId = UINT32_MAX;
+        uint32_t m_DescriptorSet = 0;
+        uint32_t m_Binding = 0;
+
+        // Functions, labels and variables.
+        uint32_t m_Pc = g_InvalidOffset;
+        uint32_t m_FirstParameter = 0;
+        uint32_t m_ParameterCount = 0;
+        bool m_Supported = false;
+        bool m_Reachable = false;
+        uint32_t m_Variable = UINT32_MAX;
+    };
+
+    struct SpirvMemberDecoration
+    {
+        uint32_t m_Struct;
+        uint32_t m_Member;
+        uint32_t m_Decoration;
+        uint32_t m_Value;
+    };
+
+    struct SpirvFunctionCall
+    {
+        uint32_t m_Instruction;
+        uint32_t m_Caller;
+        uint32_t m_Callee;
+    };
+
+    /**
+     * @brief
+     *   Translates a SPIR-V module to the threaded code of the interpreter.
+     *   Values of all ids get fixed offsets in the memory of an invocation, with the constants,
+     *   the module-scope variables and the builtins placed first, so that the invocations
+     *   are initialized with a single copy of the memory image built by the decoder.
+     *   Functions using unsupported instructions are rejected when they are reachable
+     *   from the entry point.
+     */
+    struct SpirvDecoder
+    {
+        template<typename T>
+        using Vector = std::vector<T, vk_stl_allocator<T>>;
+
+        SpirvProgram& m_Program;
+        const VkSpecializationInfo* m_pSpecializationInfo;
+        const char* m_pEntryPointName;
+
+        Vector<SpirvId> m_Ids;
+        Vector<uint32_t> m_MemberTypes;
+        Vector<uint32_t> m_MemberOffsets;
+        Vector<SpirvMemberDecoration> m_MemberDecorations;
+        Vector<uint32_t> m_Parameters;
+        Vector<SpirvFunctionCall> m_FunctionCalls;
+
+        bool m_GlobalSection;
+        bool m_InvalidId;
+        uint32_t m_EntryPoint;
+        uint32_t m_LocalSizeIds[ 3 ];
+        uint32_t m_WorkgroupSize;
+        uint32_t m_GlslInstructionSet;
+        uint32_t m_CurrentFunction;
+        uint32_t m_CurrentBlock;
+        uint32_t m_PhiInstruction;
+        uint32_t m_PhiScratchSize;
+        uint32_t m_MaxPhiScratchSize;
+        uint32_t m_ZeroOffset;
+
+        SpirvDecoder( SpirvProgram& program, const VkSpecializationInfo* pSpecializationInfo, const char* pEntryPointName )
+            : m_Program( program )
+            , m_pSpecializationInfo( pSpecializationInfo )
+            , m_pEntryPointName( pEntryPointName ? pEntryPointName : "main" )
+            , m_Ids( program.m_Allocator )
+            , m_MemberTypes( program.m_Allocator )
+            , m_MemberOffsets( program.m_Allocator )
+            , m_MemberDecorations( program.m_Allocator )
+            , m_Parameters( program.m_Allocator )
+            , m_FunctionCalls( program.m_Allocator )
+            , m_GlobalSection( true )
+            , m_InvalidId( false )
+            , m_EntryPoint( 0 )
+            , m_LocalSizeIds()
+            , m_WorkgroupSize( 0 )
+            , m_GlslInstructionSet( 0 )
+            , m_CurrentFunction( 0 )
+            , m_CurrentBlock( 0 )
+            , m_PhiInstruction( g_InvalidOffset )
+            , m_PhiScratchSize( 0 )
+            , m_MaxPhiScratchSize( 0 )
+            , m_ZeroOffset( 0 )
+        {
+        }
+
+        SpirvId& Id( uint32_t id )
+        {
+            if( id == 0 || id >= m_Ids.size() )
+            {
+                m_InvalidId = true;
+                return m_Ids[ 0 ];
+            }
+            return m_Ids[ id ];
+        }
+
+        SpirvId& TypeOf( uint32_t id )
+        {
+            return Id( Id( id ).m_Type );
+        }
+
+        uint32_t ValueOffset( uint32_t id )
+        {
+            const SpirvId& value = Id( id );
+            if( value.m_Offset == g_InvalidOffset )
+            {
+                m_InvalidId = true;
+                return 0;
+            }
+            return value.m_Offset;
+        }
+
+        uint32_t ConstantValue( uint32_t id )
+        {
+            const SpirvId& value = Id( id );
+            if( !value.m_Constant || value.m_Offset + sizeof( uint32_t ) > m_Program.m_InitialMemory.size() )
+            {
+                m_InvalidId = true;
+                return 0;
+            }
+
+            uint32_t result;
+            memcpy( &result, m_Program.m_InitialMemory.data() + value.m_Offset, sizeof( result ) );
+            return result;
+        }
+
+        uint32_t Allocate( uint32_t size, uint32_t alignment )
+        {
+            const uint32_t offset = vk_align( m_Program.m_MemorySize, alignment );
+
+            if( size > g_MaxInvocationMemorySize || offset > g_MaxInvocationMemorySize - size )
+            {
+                m_InvalidId = true;
+                return 0;
+            }
+
+            m_Program.m_MemorySize = offset + size;
+
+            // Memory allocated before the first function is initialized from the image built by the decoder.
+            if( m_GlobalSection )
+            {
+                m_Program.m_InitialMemory.resize( m_Program.m_MemorySize );
+            }
+            return offset;
+        }
+
+        uint32_t AllocateValue( uint32_t id, uint32_t type )
+        {
+            SpirvId& value = Id( id );
+            if( value.m_Offset == g_InvalidOffset && !m_InvalidId )
+            {
+                const SpirvId& valueType = Id( type );
+                value.m_Type = type;
+                value.m_Offset = Allocate( valueType.m_Size, std::max( valueType.m_Alignment, 4U ) );
+            }
+            return value.m_Offset;
+        }
+
+        uint32_t Result( const uint32_t* pWords )
+        {
+            return AllocateValue( pWords[ 2 ], pWords[ 1 ] );
+        }
+
+        uint32_t ScalarType( uint32_t type )
+        {
+            while( Id( type ).m_Opcode == spv::OpTypeVector || Id( type ).m_Opcode == spv::OpTypeMatrix )
+            {
+                type = Id( type ).m_ElementType;
+            }
+            return type;
+        }
+
+        bool IsFloat32( uint32_t type )
+        {
+            const SpirvId& scalar = Id( ScalarType( type ) );
+            return scalar.m_Opcode == spv::OpTypeFloat && scalar.m_Width == 32;
+        }
+
+        bool IsInt32( uint32_t type )
+        {
+            const SpirvId& scalar = Id( ScalarType( type ) );
+            return scalar.m_Opcode == spv::OpTypeInt && scalar.m_Width == 32;
+        }
+
+        bool IsBool( uint32_t type )
+        {
+            return Id( ScalarType( type ) ).m_Opcode == spv::OpTypeBool;
+        }
+
+        bool Is32Bit( uint32_t type )
+        {
+            return IsFloat32( type ) || IsInt32( type ) || IsBool( type );
+        }
+
+        uint32_t ComponentCount( uint32_t type )
+        {
+            const SpirvId& typeId = Id( type );
+            switch( typeId.m_Opcode )
+            {
+            case spv::OpTypeVector:
+                return typeId.m_Length;
+            case spv::OpTypeMatrix:
+                return typeId.m_Length * Id( typeId.m_ElementType ).m_Length;
+            default:
+                return 1;
+            }
+        }
+
+        // Returns the type of the constituent and adds its offset, or returns 0 if the index is out of range.
+        uint32_t Constituent( uint32_t type, uint32_t index, uint32_t& offset )
+        {
+            const SpirvId& typeId = Id( type );
+            switch( typeId.m_Opcode )
+            {
+            case spv::OpTypeStruct:
+                if( index >= typeId.m_Length )
+                {
+                    return 0;
+                }
+                offset += m_MemberOffsets[ typeId.m_FirstMember + index ];
+                return m_MemberTypes[ typeId.m_FirstMember + index ];
+
+            case spv::OpTypeArray:
+            case spv::OpTypeVector:
+            case spv::OpTypeMatrix:
+                if( index >= typeId.m_Length )
+                {
+                    return 0;
+                }
+                offset += index * typeId.m_Stride;
+                return typeId.m_ElementType;
+
+            default:
+                return 0;
+            }
+        }
+
+        SpirvInstruction& Emit( SpirvHandler pfnHandler, uint32_t result = 0 )
+        {
+            SpirvInstruction instruction = {};
+            instruction.m_pfnHandler = pfnHandler;
+            instruction.m_Result = result;
+            instruction.m_FirstExtraOperand = static_cast<uint32_t>( m_Program.m_ExtraOperands.size() );
+
+            m_PhiInstruction = g_InvalidOffset;
+            m_Program.m_Instructions.push_back( instruction );
+            return m_Program.m_Instructions.back();
+        }
+
+        void EmitExtraOperand( uint32_t value )
+        {
+            m_Program.m_ExtraOperands.push_back( value );
+            m_Program.m_Instructions.back().m_ExtraOperandCount++;
+        }
+
+        // Emits an operation on each component of the result.
+        bool EmitComponentwise( SpirvHandler pfnHandler, const uint32_t* pWords, uint32_t wordCount, uint32_t firstOperand, uint32_t operandCount )
+        {
+            if( wordCount < firstOperand + operandCount )
+            {
+                return false;
+            }
+
+            SpirvInstruction& instruction = Emit( pfnHandler, Result( pWords ) );
+            for( uint32_t i = 0; i < operandCount; ++i )
+            {
+                instruction.m_Operands[ i ] = ValueOffset( pWords[ firstOperand + i ] );
+            }
+            instruction.m_Count = ComponentCount( pWords[ 1 ] );
+            return true;
+        }
+
+        bool EmitUnary( SpirvHandler pfnHandler, const uint32_t* pWords, uint32_t wordCount )
+        {
+            return EmitComponentwise( pfnHandler, pWords, wordCount, 3, 1 );
+        }
+
+        bool EmitBinary( SpirvHandler pfnHandler, const uint32_t* pWords, uint32_t wordCount )
+        {
+            return EmitComponentwise( pfnHandler, pWords, wordCount, 3, 2 );
+        }
+
+        bool EmitCopy( const uint32_t* pWords, uint32_t source, uint32_t size )
+        {
+            SpirvInstruction& instruction = Emit( ExecuteCopy, Result( pWords ) );
+            instruction.m_Operands[ 0 ] = source;
+            instruction.m_Count = size;
+            return true;
+        }
+
+        bool EmitCompositeConstruct( const uint32_t* pWords, uint32_t wordCount )
+        {
+            const uint32_t type = pWords[ 1 ];
+            const bool vector = Id( type ).m_Opcode == spv::OpTypeVector;
+
+            Emit( ExecuteCompositeConstruct, Result( pWords ) );
+
+            // Vectors may be constructed from the components of smaller vectors.
+            uint32_t vectorOffset = 0;
+            for( uint32_t i = 3; i < wordCount; ++i )
+            {
+                const uint32_t size = TypeOf( pWords[ i ] ).m_Size;
+
+                uint32_t offset = 0;
+                if( vector )
+                {
+                    offset = vectorOffset;
+                    vectorOffset += size;
+                }
+                else if( !Constituent( type, i - 3, offset ) )
+                {
+                    return false;
+                }
+
+                if( offset + size > Id( type ).m_Size )
+                {
+                    return false;
+                }
+
+                EmitExtraOperand( offset );
+                EmitExtraOperand( ValueOffset( pWords[ i ] ) );
+                EmitExtraOperand( size );
+            }
+            return true;
+        }
+
+        // Executes the last emitted instruction on the memory image and removes it from the program.
+        void EvaluateConstant( uint32_t id )
+        {
+            const SpirvInstruction instruction = m_Program.m_Instructions.back();
+
+            if( !m_InvalidId )
+            {
+                SpirvInvocation invocation = {};
+                invocation.m_pMemory = m_Program.m_InitialMemory.data();
+                invocation.m_pExtraOperands = m_Program.m_ExtraOperands.data();
+                instruction.m_pfnHandler( invocation, instruction );
+            }
+
+            m_Program.m_Instructions.pop_back();
+            m_Program.m_ExtraOperands.resize( instruction.m_FirstExtraOperand );
+            Id( id ).m_Constant = true;
+        }
+
+        const VkSpecializationMapEntry* FindSpecialization( uint32_t id )
+        {
+            const uint32_t specId = Id( id ).m_SpecId;
+            if( !m_pSpecializationInfo || specId == UINT32_MAX )
+            {
+                return nullptr;
+            }
+
+            for( uint32_t i = 0; i < m_pSpecializationInfo->mapEntryCount; ++i )
+            {
+                const VkSpecializationMapEntry& entry = m_pSpecializationInfo->pMapEntries[ i ];
+                if( entry.constantID == specId && entry.offset + entry.size <= m_pSpecializationInfo->dataSize )
+                {
+                    return &entry;
+                }
+            }
+            return nullptr;
+        }
+
+        static bool MatchString( const uint32_t* pWords, uint32_t wordCount, const char* pString, bool prefix )
+        {
+            const size_t length = strlen( pString ) + ( prefix ? 0 : 1 );
+            return length <= wordCount * sizeof( uint32_t ) && memcmp( pWords, pString, length ) == 0;
+        }
+
+        bool Decode( const uint32_t* pCode, size_t wordCount );
+        bool DecodeGlobalInstruction( const uint32_t* pWords, uint32_t wordCount );
+        bool DecodeType( const uint32_t* pWords, uint32_t wordCount );
+        bool DecodeStruct( const uint32_t* pWords, uint32_t wordCount );
+        bool DecodeConstant( const uint32_t* pWords, uint32_t wordCount );
+        bool DecodeGlobalVariable( const uint32_t* pWords, uint32_t wordCount );
+        bool DecodeFunctionInstruction( const uint32_t* pWords, uint32_t wordCount );
+        bool DecodeAccessChain( const uint32_t* pWords, uint32_t wordCount );
+        bool DecodeAtomic( const uint32_t* pWords, uint32_t wordCount );
+        bool DecodeGroupOperation( const uint32_t* pWords, uint32_t wordCount );
+        bool DecodeGlslInstruction( const uint32_t* pWords, uint32_t wordCount );
+        bool ResolveLabel( uint32_t& label );
+        bool Link();
+    };
+
+    bool SpirvDecoder::Decode( const uint32_t* pCode, size_t wordCount )
+    {
+        if( wordCount < 5 || pCode[ 0 ] != spv::MagicNumber || pCode[ 3 ] == 0 || pCode[ 3 ] > g_MaxIdBound )
+        {
+            return false;
+        }
+
+        m_Ids.resize( pCode[ 3 ] );
+
+        // Undefined components of the shuffled vectors are read from a zeroed block.
+        m_ZeroOffset = Allocate( 16, 8 );
+
+        for( size_t position = 5; position < wordCount; )
+        {
+            const uint32_t* pWords = pCode + position;
+            const uint32_t instructionWordCount = pWords[ 0 ] >> 16;
+
+            if( instructionWordCount == 0 || instructionWordCount > wordCount - position )
+            {
+                return false;
+            }
+
+            m_InvalidId = false;
+
+            const bool supported = m_CurrentFunction
+                ? DecodeFunctionInstruction( pWords, instructionWordCount )
+                : DecodeGlobalInstruction( pWords, instructionWordCount );
+
+            if( !supported || m_InvalidId )
+            {
+                if( !m_CurrentFunction )
+                {
+                    return false;
+                }
+                m_Ids[ m_CurrentFunction ].m_Supported = false;
+            }
+
+            position += instructionWordCount;
+        }
+
+        return Link();
+    }
+
+    bool SpirvDecoder::DecodeGlobalInstruction( const uint32_t* pWords, uint32_t wordCount )
+    {
+        const uint32_t opcode = pWords[ 0 ] & 0xFFFF;
+
+        switch( opcode )
+        {
+        case spv::OpExtInstImport:
+            if( wordCount < 3 )
+            {
+                return false;
+            }
+            if( MatchString( pWords + 2, wordCount - 2, "GLSL.std.450", false ) )
+            {
+                m_GlslInstructionSet = pWords[ 1 ];
+            }
+            Id( pWords[ 1 ] ).m_NonSemantic = MatchString( pWords + 2, wordCount - 2, "NonSemantic.", true );
+            return true;
+
+        case spv::OpEntryPoint:
+            if( wordCount >= 4 &&
+                pWords[ 1 ] == spv::ExecutionModelGLCompute &&
+                MatchString( pWords + 3, wordCount - 3, m_pEntryPointName, false ) )
+            {
+                m_EntryPoint = pWords[ 2 ];
+            }
+            return true;
+
+        case spv::OpExecutionMode:
+        case spv::OpExecutionModeId:
+            if( wordCount >= 6 && m_EntryPoint && pWords[ 1 ] == m_EntryPoint )
+            {
+                if( opcode == spv::OpExecutionMode && pWords[ 2 ] == spv::ExecutionModeLocalSize )
+                {
+                    memcpy( m_Program.m_LocalSize, pWords + 3, sizeof( m_Program.m_LocalSize ) );
+                }
+                if( opcode == spv::OpExecutionModeId && pWords[ 2 ] == spv::ExecutionModeLocalSizeId )
+                {
+                    memcpy( m_LocalSizeIds, pWords + 3, sizeof( m_LocalSizeIds ) );
+                }
+            }
+            return true;
+
+        case spv::OpDecorate:
+        {
+            if( wordCount < 3 )
+            {
+                return false;
+            }
+
+            SpirvId& target = Id( pWords[ 1 ] );
+            const uint32_t value = ( wordCount >= 4 ) ? pWords[ 3 ] : 0;
+
+            switch( pWords[ 2 ] )
+            {
+            case spv::DecorationSpecId:
+                target.m_SpecId = value;
+                break;
+            case spv::DecorationArrayStride:
+                target.m_ArrayStride = value;
+                break;
+            case spv::DecorationBuiltIn:
+                target.m_BuiltIn = value;
+                break;
+            case spv::DecorationBinding:
+                target.m_Binding = value;
+                break;
+            case spv::DecorationDescriptorSet:
+                target.m_DescriptorSet = value;
+                break;
+            }
+            return true;
+        }
+
+        case spv::OpMemberDecorate:
+            if( wordCount < 4 )
+            {
+                return false;
+            }
+            m_MemberDecorations.push_back( { pWords[ 1 ], pWords[ 2 ], pWords[ 3 ], ( wordCount >= 5 ) ? pWords[ 4 ] : 0 } );
+            return true;
+
+        case spv::OpTypeVoid:
+        case spv::OpTypeBool:
+        case spv::OpTypeInt:
+        case spv::OpTypeFloat:
+        case spv::OpTypeVector:
+        case spv::OpTypeMatrix:
+        case spv::OpTypeArray:
+        case spv::OpTypeRuntimeArray:
+        case spv::OpTypePointer:
+            return DecodeType( pWords, wordCount );
+
+        case spv::OpTypeStruct:
+            return DecodeStruct( pWords, wordCount );
+
+        case spv::OpConstantTrue:
+        case spv::OpConstantFalse:
+        case spv::OpConstant:
+        case spv::OpConstantComposite:
+        case spv::OpConstantNull:
+        case spv::OpSpecConstantTrue:
+        case spv::OpSpecConstantFalse:
+        case spv::OpSpecConstant:
+        case spv::OpSpecConstantComposite:
+        case spv::OpSpecConstantOp:
+        case spv::OpUndef:
+            return DecodeConstant( pWords, wordCount );
+
+        case spv::OpVariable:
+            return DecodeGlobalVariable( pWords, wordCount );
+
+        case spv::OpFunction:
+        {
+            if( wordCount < 5 )
+            {
+                return false;
+            }
+
+            SpirvId& function = Id( pWords[ 2 ] );
+            function.m_Opcode = spv::OpFunction;
+            function.m_Type = pWords[ 1 ];
+            function.m_Pc = static_cast<uint32_t>( m_Program.m_Instructions.size() );
+            function.m_FirstParameter = static_cast<uint32_t>( m_Parameters.size() );
+            function.m_Supported = true;
+
+            m_GlobalSection = false;
+            m_CurrentFunction = m_InvalidId ? 0 : pWords[ 2 ];
+            return true;
+        }
+
+        default:
+            // Debug information, capabilities and opaque types do not affect the execution.
+            return true;
+        }
+    }
+
+    bool SpirvDecoder::DecodeType( const uint32_t* pWords, uint32_t wordCount )
+    {
+        const uint32_t opcode = pWords[ 0 ] & 0xFFFF;
+        if( wordCount < 2 )
+        {
+            return false;
+        }
+
+        SpirvId& type = Id( pWords[ 1 ] );
+        type.m_Opcode = opcode;
+
+        switch( opcode )
+        {
+        case spv::OpTypeVoid:
+            type.m_Size = 0;
+            return true;
+
+        case spv::OpTypeBool:
+            type.m_Size = 4;
+            type.m_Width = 32;
+            return true;
+
+        case spv::OpTypeInt:
+        case spv::OpTypeFloat:
+            if( wordCount < 3 || ( pWords[ 2 ] != 8 && pWords[ 2 ] != 16 && pWords[ 2 ] != 32 && pWords[ 2 ] != 64 ) )
+            {
+                return false;
+            }
+            type.m_Width = pWords[ 2 ];
+            type.m_Size = pWords[ 2 ] / 8;
+            type.m_Alignment = type.m_Size;
+            return true;
+
+        case spv::OpTypeVector:
+        case spv::OpTypeMatrix:
+        {
+            if( wordCount < 4 || pWords[ 3 ] == 0 || pWords[ 3 ] > 16 )
+            {
+                return false;
+            }
+
+            const SpirvId& element = Id( pWords[ 2 ] );
+            type.m_ElementType = pWords[ 2 ];
+            type.m_Length = pWords[ 3 ];
+            type.m_Stride = element.m_Size;
+            type.m_Size = element.m_Size * pWords[ 3 ];
+            type.m_Alignment = element.m_Alignment;
+            return true;
+        }
+
+        case spv::OpTypeArray:
+        case spv::OpTypeRuntimeArray:
+        {
+            if( wordCount < ( opcode == spv::OpTypeArray ? 4U : 3U ) )
+            {
+                return false;
+            }
+
+            const SpirvId& element = Id( pWords[ 2 ] );
+            type.m_ElementType = pWords[ 2 ];
+            type.m_Alignment = element.m_Alignment;
+            type.m_Stride = type.m_ArrayStride ? type.m_ArrayStride : vk_align( element.m_Size, element.m_Alignment );
+
+            if( opcode == spv::OpTypeArray )
+            {
+                type.m_Length = ConstantValue( pWords[ 3 ] );
+
+                const uint64_t size = uint64_t( type.m_Length ) * type.m_Stride;
+                if( size > g_MaxInvocationMemorySize )
+                {
+                    return false;
+                }
+                type.m_Size = static_cast<uint32_t>( size );
+            }
+            return true;
+        }
+
+        case spv::OpTypePointer:
+            if( wordCount < 4 )
+            {
+                return false;
+            }
+            type.m_StorageClass = pWords[ 2 ];
+            type.m_ElementType = pWords[ 3 ];
+            type.m_Size = sizeof( uint8_t* );
+            type.m_Alignment = alignof( uint8_t* );
+            return true;
+        }
+
+        return false;
+    }
+
+    bool SpirvDecoder::DecodeStruct( const uint32_t* pWords, uint32_t wordCount )
+    {
+        if( wordCount < 2 )
+        {
+            return false;
+        }
+
+        SpirvId& type = Id( pWords[ 1 ] );
+        type.m_Opcode = spv::OpTypeStruct;
+        type.m_FirstMember = static_cast<uint32_t>( m_MemberTypes.size() );
+        type.m_Length = wordCount - 2;
+
+        uint32_t offset = 0;
+        for( uint32_t member = 0; member < type.m_Length; ++member )
+        {
+            const uint32_t memberType = pWords[ 2 + member ];
+            const SpirvId& memberTypeId = Id( memberType );
+
+            // Members without the explicit layout are packed with their natural alignment.
+            uint32_t memberOffset = vk_align( offset, memberTypeId.m_Alignment );
+
+            for( const SpirvMemberDecoration& decoration : m_MemberDecorations )
+            {
+                if( decoration.m_Struct != pWords[ 1 ] || decoration.m_Member != member )
+                {
+                    continue;
+                }
+
+                switch( decoration.m_Decoration )
+                {
+                case spv::DecorationOffset:
+                    memberOffset = decoration.m_Value;
+                    break;
+
+                case spv::DecorationMatrixStride:
+                {
+                    // Matrices are kept in the memory as arrays of tightly packed columns.
+                    uint32_t matrixType = memberType;
+                    while( Id( matrixType ).m_Opcode == spv::OpTypeArray || Id( matrixType ).m_Opcode == spv::OpTypeRuntimeArray )
+                    {
+                        matrixType = Id( matrixType ).m_ElementType;
+                    }
+                    if( decoration.m_Value != Id( matrixType ).m_Stride )
+                    {
+                        return false;
+                    }
+                    break;
+                }
+
+                case spv::DecorationRowMajor:
+                    return false;
+                }
+            }
+
+            if( uint64_t( memberOffset ) + memberTypeId.m_Size > g_MaxInvocationMemorySize )
+            {
+                return false;
+            }
+
+            m_MemberTypes.push_back( memberType );
+            m_MemberOffsets.push_back( memberOffset );
+
+            offset = std::max( offset, memberOffset + memberTypeId.m_Size );
+            type.m_Alignment = std::max( type.m_Alignment, memberTypeId.m_Alignment );
+        }
+
+        type.m_Size = vk_align( offset, type.m_Alignment );
+        return true;
+    }
+
+    bool SpirvDecoder::DecodeConstant( const uint32_t* pWords, uint32_t wordCount )
+    {
+        const uint32_t opcode = pWords[ 0 ] & 0xFFFF;
+        if( wordCount < 3 )
+        {
+            return false;
+        }
+
+        const uint32_t id = pWords[ 2 ];
+        const uint32_t offset = Result( pWords );
+        const uint32_t size = Id( pWords[ 1 ] ).m_Size;
+
+        if( m_InvalidId )
+        {
+            return false;
+        }
+
+        uint8_t* pValue = m_Program.m_InitialMemory.data() + offset;
+        const VkSpecializationMapEntry* pSpecialization = FindSpecialization( id );
+
+        switch( opcode )
+        {
+        case spv::OpConstantTrue:
+        case spv::OpConstantFalse:
+        case spv::OpSpecConstantTrue:
+        case spv::OpSpecConstantFalse:
+        {
+            uint32_t value = ( opcode == spv::OpConstantTrue || opcode == spv::OpSpecConstantTrue );
+            if( pSpecialization )
+            {
+                VkBool32 specialization = VK_FALSE;
+                memcpy( &specialization, static_cast<const uint8_t*>( m_pSpecializationInfo->pData ) + pSpecialization->offset,
+                    std::min<size_t>( pSpecialization->size, sizeof( specialization ) ) );
+                value = ( specialization != VK_FALSE );
+            }
+            memcpy( pValue, &value, std::min<uint32_t>( size, sizeof( value ) ) );
+            break;
+        }
+
+        case spv::OpConstant:
+        case spv::OpSpecConstant:
+            memcpy( pValue, pWords + 3, std::min<size_t>( size, ( wordCount - 3 ) * sizeof( uint32_t ) ) );
+            if( pSpecialization )
+            {
+                memcpy( pValue, static_cast<const uint8_t*>( m_pSpecializationInfo->pData ) + pSpecialization->offset,
+                    std::min<size_t>( pSpecialization->size, size ) );
+            }
+            break;
+
+        case spv::OpConstantComposite:
+        case spv::OpSpecConstantComposite:
+            if( !EmitCompositeConstruct( pWords, wordCount ) )
+            {
+                return false;
+            }
+            EvaluateConstant( id );
+            break;
+
+        case spv::OpSpecConstantOp:
+        {
+            // Decode the operation as if it was in a function and evaluate it on the memory image.
+            if( wordCount < 4 || wordCount - 1 > 16 )
+            {
+                return false;
+            }
+
+            uint32_t words[ 16 ];
+            words[ 0 ] = ( ( wordCount - 1 ) << 16 ) | pWords[ 3 ];
+            words[ 1 ] = pWords[ 1 ];
+            words[ 2 ] = pWords[ 2 ];
+            memcpy( words + 3, pWords + 4, ( wordCount - 4 ) * sizeof( uint32_t ) );
+
+            const size_t instructionCount = m_Program.m_Instructions.size();
+            if( !DecodeFunctionInstruction( words, wordCount - 1 ) || m_Program.m_Instructions.size() != instructionCount + 1 )
+            {
+                return false;
+            }
+            EvaluateConstant( id );
+            break;
+        }
+        }
+
+        // Constants other than undefined values may be used as indices.
+        Id( id ).m_Constant = ( opcode != spv::OpUndef );
+
+        if( Id( id ).m_BuiltIn == spv::BuiltInWorkgroupSize )
+        {
+            m_WorkgroupSize = id;
+        }
+        return true;
+    }
+
+    bool SpirvDecoder::DecodeGlobalVariable( const uint32_t* pWords, uint32_t wordCount )
+    {
+        if( wordCount < 4 )
+        {
+            return false;
+        }
+
+        const uint32_t id = pWords[ 2 ];
+        const SpirvId& type = Id( Id( pWords[ 1 ] ).m_ElementType );
+
+        SpirvVariable variable = {};
+        variable.m_StorageClass = pWords[ 3 ];
+        variable.m_DescriptorSet = Id( id ).m_DescriptorSet;
+        variable.m_Binding = Id( id ).m_Binding;
+        variable.m_BuiltIn = Id( id ).m_BuiltIn;
+        variable.m_PointerOffset = AllocateValue( id, pWords[ 1 ] );
+        variable.m_RangeOffset = g_InvalidOffset;
+        variable.m_StorageOffset = g_InvalidOffset;
+        variable.m_Size = type.m_Size;
+
+        switch( variable.m_StorageClass )
+        {
+        case spv::StorageClassInput:
+        case spv::StorageClassOutput:
+        case spv::StorageClassPrivate:
+            variable.m_StorageOffset = Allocate( type.m_Size, std::max( type.m_Alignment, 4U ) );
+            if( wordCount >= 5 && !m_InvalidId )
+            {
+                memcpy( m_Program.m_InitialMemory.data() + variable.m_StorageOffset,
+                    m_Program.m_InitialMemory.data() + ValueOffset( pWords[ 4 ] ),
+                    type.m_Size );
+            }
+            break;
+
+        case spv::StorageClassWorkgroup:
+            variable.m_StorageOffset = vk_align( m_Program.m_SharedMemorySize, std::max( type.m_Alignment, 4U ) );
+            if( type.m_Size > g_MaxInvocationMemorySize - variable.m_StorageOffset )
+            {
+                return false;
+            }
+            m_Program.m_SharedMemorySize = variable.m_StorageOffset + type.m_Size;
+            break;
+
+        case spv::StorageClassUniformConstant:
+        case spv::StorageClassUniform:
+        case spv::StorageClassStorageBuffer:
+            if( type.m_Opcode == spv::OpTypeArray )
+            {
+                variable.m_DescriptorCount = type.m_Length;
+            }
+            if( type.m_Opcode == spv::OpTypeRuntimeArray )
+            {
+                variable.m_DescriptorCount = UINT32_MAX;
+            }
+
+            // Range of the descriptor, or the number of descriptors in the array.
+            variable.m_RangeOffset = Allocate( sizeof( VkDeviceSize ), alignof( VkDeviceSize ) );
+            break;
+        }
+
+        Id( id ).m_Opcode = spv::OpVariable;
+        Id( id ).m_Variable = static_cast<uint32_t>( m_Program.m_Variables.size() );
+        m_Program.m_Variables.push_back( variable );
+        return true;
+    }
+
+    // Instructions shorter than the result type and the result id.
+    static bool IsShortInstruction( uint32_t opcode )
+    {
+        switch( opcode )
+        {
+        case spv::OpNop:
+        case spv::OpNoLine:
+        case spv::OpFunctionEnd:
+        case spv::OpLabel:
+        case spv::OpBranch:
+        case spv::OpReturn:
+        case spv::OpReturnValue:
+        case spv::OpKill:
+        case spv::OpUnreachable:
+        case spv::OpTerminateInvocation:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool SpirvDecoder::DecodeFunctionInstruction( const uint32_t* pWords, uint32_t wordCount )
+    {
+        const uint32_t opcode = pWords[ 0 ] & 0xFFFF;
+
+        if( wordCount < 3 && !IsShortInstruction( opcode ) )
+        {
+            return false;
+        }
+
+        // Type of the first operand of the instructions with a result.
+        // Other instructions may have literals there, so invalid ids are not reported.
+        const uint32_t operandType = ( wordCount > 3 && pWords[ 3 ] < m_Ids.size() ) ? m_Ids[ pWords[ 3 ] ].m_Type : 0;
+
+        switch( opcode )
+        {
+        case spv::OpNop:
+        case spv::OpLine:
+        case spv::OpNoLine:
+        case spv::OpLoopMerge:
+        case spv::OpSelectionMerge:
+            return true;
+
+        case spv::OpFunctionParameter:
+            m_Parameters.push_back( Result( pWords ) );
+            Id( m_CurrentFunction ).m_ParameterCount++;
+            return true;
+
+        case spv::OpFunctionEnd:
+            m_CurrentFunction = 0;
+            return true;
+
+        case spv::OpLabel:
+            if( wordCount < 2 )
+            {
+                return false;
+            }
+            Id( pWords[ 1 ] ).m_Pc = static_cast<uint32_t>( m_Program.m_Instructions.size() );
+            m_CurrentBlock = pWords[ 1 ];
+            m_PhiInstruction = g_InvalidOffset;
+            return true;
+
+        case spv::OpUndef:
+            Result( pWords );
+            return true;
+
+        case spv::OpVariable:
+        {
+            if( wordCount < 4 || pWords[ 3 ] != spv::StorageClassFunction )
+            {
+                return false;
+            }
+
+            const SpirvId& type = Id( Id( pWords[ 1 ] ).m_ElementType );
+            const uint32_t storage = Allocate( type.m_Size, std::max( type.m_Alignment, 4U ) );
+
+            SpirvInstruction& instruction = Emit( ExecuteVariable, Result( pWords ) );
+            instruction.m_Operands[ 0 ] = storage;
+            instruction.m_Operands[ 1 ] = ( wordCount >= 5 ) ? ValueOffset( pWords[ 4 ] ) : g_InvalidOffset;
+            instruction.m_Count = type.m_Size;
+            return true;
+        }
+
+        case spv::OpLoad:
+        {
+            if( wordCount < 4 )
+            {
+                return false;
+            }
+
+            SpirvInstruction& instruction = Emit( ExecuteLoad, Result( pWords ) );
+            instruction.m_Operands[ 0 ] = ValueOffset( pWords[ 3 ] );
+            instruction.m_Count = Id( pWords[ 1 ] ).m_Size;
+            return true;
+        }
+
+        case spv::OpStore:
+        {
+            SpirvInstruction& instruction = Emit( ExecuteStore );
+            instruction.m_Operands[ 0 ] = ValueOffset( pWords[ 1 ] );
+            instruction.m_Operands[ 1 ] = ValueOffset( pWords[ 2 ] );
+            instruction.m_Count = TypeOf( pWords[ 2 ] ).m_Size;
+            return true;
+        }
+
+        case spv::OpCopyMemory:
+        {
+            SpirvInstruction& instruction = Emit( ExecuteCopyMemory );
+            instruction.m_Operands[ 0 ] = ValueOffset( pWords[ 1 ] );
+            instruction.m_Operands[ 1 ] = ValueOffset( pWords[ 2 ] );
+            instruction.m_Count = Id( TypeOf( pWords[ 1 ] ).m_ElementType ).m_Size;
+            return true;
+        }
+
+        case spv::OpAccessChain:
+        case spv::OpInBoundsAccessChain:
+            return DecodeAccessChain( pWords, wordCount );
+
+        case spv::OpArrayLength:
+        {
+            if( wordCount < 5 )
+            {
+                return false;
+            }
+
+            // Only the lengths of the arrays in the variables bound to single descriptors are known.
+            const SpirvId& structure = Id( pWords[ 3 ] );
+            if( structure.m_Variable == UINT32_MAX )
+            {
+                return false;
+            }
+
+            const SpirvVariable& variable = m_Program.m_Variables[ structure.m_Variable ];
+            if( variable.m_RangeOffset == g_InvalidOffset || variable.m_DescriptorCount )
+            {
+                return false;
+            }
+
+            uint32_t memberOffset = 0;
+            const uint32_t arrayType = Constituent( Id( structure.m_Type ).m_ElementType, pWords[ 4 ], memberOffset );
+            if( Id( arrayType ).m_Opcode != spv::OpTypeRuntimeArray || Id( arrayType ).m_Stride == 0 )
+            {
+                return false;
+            }
+
+            SpirvInstruction& instruction = Emit( ExecuteArrayLength, Result( pWords ) );
+            instruction.m_Operands[ 0 ] = variable.m_RangeOffset;
+            instruction.m_Operands[ 1 ] = memberOffset;
+            instruction.m_Operands[ 2 ] = Id( arrayType ).m_Stride;
+            return true;
+        }
+
+        case spv::OpCompositeConstruct:
+            return EmitCompositeConstruct( pWords, wordCount );
+
+        case spv::OpCompositeExtract:
+        {
+            if( wordCount < 4 )
+            {
+                return false;
+            }
+
+            uint32_t type = operandType;
+            uint32_t offset = 0;
+            for( uint32_t i = 4; i < wordCount; ++i )
+            {
+                if( !( type = Constituent( type, pWords[ i ], offset ) ) )
+                {
+                    return false;
+                }
+            }
+            return EmitCopy( pWords, ValueOffset( pWords[ 3 ] ) + offset, Id( pWords[ 1 ] ).m_Size );
+        }
+
+        case spv::OpCompositeInsert:
+        {
+            if( wordCount < 5 )
+            {
+                return false;
+            }
+
+            uint32_t type = pWords[ 1 ];
+            uint32_t offset = 0;
+            for( uint32_t i = 5; i < wordCount; ++i )
+            {
+                if( !( type = Constituent( type, pWords[ i ], offset ) ) )
+                {
+                    return false;
+                }
+            }
+
+            SpirvInstruction& instruction = Emit( ExecuteCompositeInsert, Result( pWords ) );
+            instruction.m_Operands[ 0 ] = ValueOffset( pWords[ 4 ] );
+            instruction.m_Operands[ 1 ] = ValueOffset( pWords[ 3 ] );
+            instruction.m_Operands[ 2 ] = offset;
+            instruction.m_Operands[ 3 ] = Id( type ).m_Size;
+            instruction.m_Count = Id( pWords[ 1 ] ).m_Size;
+            return true;
+        }
+
+        case spv::OpCopyObject:
+            return wordCount >= 4 && EmitCopy( pWords, ValueOffset( pWords[ 3 ] ), Id( pWords[ 1 ] ).m_Size );
+
+        case spv::OpUConvert:
+        case spv::OpSConvert:
+        case spv::OpFConvert:
+        case spv::OpBitcast:
+            // Conversions between the types of the same size do not change the bits.
+            return wordCount >= 4 &&
+                Id( pWords[ 1 ] ).m_Size == Id( operandType ).m_Size &&
+                ( opcode == spv::OpBitcast || Is32Bit( pWords[ 1 ] ) ) &&
+                EmitCopy( pWords, ValueOffset( pWords[ 3 ] ), Id( pWords[ 1 ] ).m_Size );
+
+        case spv::OpVectorShuffle:
+        {
+            if( wordCount < 5 || !Is32Bit( pWords[ 1 ] ) )
+            {
+                return false;
+            }
+
+            const uint32_t firstCount = Id( operandType ).m_Length;
+            const uint32_t secondCount = TypeOf( pWords[ 4 ] ).m_Length;
+            const uint32_t first = ValueOffset( pWords[ 3 ] );
+            const uint32_t second = ValueOffset( pWords[ 4 ] );
+
+            Emit( ExecuteVectorShuffle, Result( pWords ) );
+            for( uint32_t i = 5; i < wordCount; ++i )
+            {
+                const uint32_t component = pWords[ i ];
+                if( component < firstCount )
+                {
+                    EmitExtraOperand( first + component * 4 );
+                }
+                else if( component - firstCount < secondCount )
+                {
+                    EmitExtraOperand( second + ( component - firstCount ) * 4 );
+                }
+                else
+                {
+                    EmitExtraOperand( m_ZeroOffset );
+                }
+            }
+            return true;
+        }
+
+        case spv::OpVectorExtractDynamic:
+            if( wordCount < 5 || !Is32Bit( pWords[ 1 ] ) || !IsInt32( Id( pWords[ 4 ] ).m_Type ) )
+            {
+                return false;
+            }
+            EmitBinary( ExecuteVectorExtractDynamic, pWords, wordCount );
+            m_Program.m_Instructions.back().m_Count = Id( operandType ).m_Length;
+            return true;
+
+        case spv::OpVectorInsertDynamic:
+            return Is32Bit( pWords[ 1 ] ) &&
+                EmitComponentwise( ExecuteVectorInsertDynamic, pWords, wordCount, 3, 3 );
+
+        case spv::OpTranspose:
+        {
+            if( !IsFloat32( pWords[ 1 ] ) || !EmitUnary( ExecuteTranspose, pWords, wordCount ) )
+            {
+                return false;
+            }
+            SpirvInstruction& instruction = m_Program.m_Instructions.back();
+            instruction.m_Operands[ 2 ] = Id( Id( operandType ).m_ElementType ).m_Length;
+            instruction.m_Count = Id( operandType ).m_Length;
+            return true;
+        }
+
+        case spv::OpSNegate:
+            return IsInt32( pWords[ 1 ] ) && EmitUnary( ExecuteUnary<SpirvSNegate, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpFNegate:
+            return IsFloat32( pWords[ 1 ] ) && EmitUnary( ExecuteUnary<SpirvFNegate, float, float>, pWords, wordCount );
+        case spv::OpIAdd:
+            return IsInt32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvIAdd, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpISub:
+            return IsInt32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvISub, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpIMul:
+            return IsInt32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvIMul, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpUDiv:
+            return IsInt32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvUDiv, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpSDiv:
+            return IsInt32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvSDiv, int32_t, int32_t>, pWords, wordCount );
+        case spv::OpUMod:
+            return IsInt32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvUMod, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpSRem:
+            return IsInt32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvSRem, int32_t, int32_t>, pWords, wordCount );
+        case spv::OpSMod:
+            return IsInt32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvSMod, int32_t, int32_t>, pWords, wordCount );
+        case spv::OpFAdd:
+            return IsFloat32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvFAdd, float, float>, pWords, wordCount );
+        case spv::OpFSub:
+            return IsFloat32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvFSub, float, float>, pWords, wordCount );
+        case spv::OpFMul:
+            return IsFloat32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvFMul, float, float>, pWords, wordCount );
+        case spv::OpFDiv:
+            return IsFloat32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvFDiv, float, float>, pWords, wordCount );
+        case spv::OpFRem:
+            return IsFloat32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvFRem, float, float>, pWords, wordCount );
+        case spv::OpFMod:
+            return IsFloat32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvFMod, float, float>, pWords, wordCount );
+
+        case spv::OpVectorTimesScalar:
+        case spv::OpMatrixTimesScalar:
+            return IsFloat32( pWords[ 1 ] ) && EmitBinary( ExecuteVectorTimesScalar, pWords, wordCount );
+
+        case spv::OpDot:
+            if( !IsFloat32( pWords[ 1 ] ) || !EmitBinary( ExecuteDot, pWords, wordCount ) )
+            {
+                return false;
+            }
+            m_Program.m_Instructions.back().m_Count = Id( operandType ).m_Length;
+            return true;
+
+        case spv::OpMatrixTimesVector:
+        case spv::OpVectorTimesMatrix:
+        case spv::OpMatrixTimesMatrix:
+        case spv::OpOuterProduct:
+        {
+            if( !IsFloat32( pWords[ 1 ] ) || wordCount < 5 )
+            {
+                return false;
+            }
+
+            const SpirvId& left = Id( operandType );
+            const SpirvId& right = TypeOf( pWords[ 4 ] );
+            const SpirvId& result = Id( pWords[ 1 ] );
+
+            SpirvHandler pfnHandler = ExecuteOuterProduct;
+            uint32_t rows = left.m_Length;
+            uint32_t inner = 0;
+            uint32_t count = right.m_Length;
+
+            if( opcode == spv::OpMatrixTimesVector )
+            {
+                pfnHandler = ExecuteMatrixTimesVector;
+                rows = Id( left.m_ElementType ).m_Length;
+                inner = left.m_Length;
+            }
+            if( opcode == spv::OpVectorTimesMatrix )
+            {
+                pfnHandler = ExecuteVectorTimesMatrix;
+                count = result.m_Length;
+            }
+            if( opcode == spv::OpMatrixTimesMatrix )
+            {
+                pfnHandler = ExecuteMatrixTimesMatrix;
+                rows = Id( left.m_ElementType ).m_Length;
+                inner = left.m_Length;
+            }
+
+            if( !EmitBinary( pfnHandler, pWords, wordCount ) )
+            {
+                return false;
+            }
+
+            SpirvInstruction& instruction = m_Program.m_Instructions.back();
+            instruction.m_Operands[ 2 ] = rows;
+            instruction.m_Operands[ 3 ] = inner;
+            instruction.m_Count = count;
+            return true;
+        }
+
+        case spv::OpAny:
+        case spv::OpAll:
+            if( !EmitUnary( ( opcode == spv::OpAny ) ? ExecuteAny : ExecuteAll, pWords, wordCount ) )
+            {
+                return false;
+            }
+            m_Program.m_Instructions.back().m_Count = ComponentCount( operandType );
+            return true;
+
+        case spv::OpIsNan:
+            return IsFloat32( operandType ) && EmitUnary( ExecuteUnary<SpirvIsNan, float, uint32_t>, pWords, wordCount );
+        case spv::OpIsInf:
+            return IsFloat32( operandType ) && EmitUnary( ExecuteUnary<SpirvIsInf, float, uint32_t>, pWords, wordCount );
+        case spv::OpLogicalEqual:
+            return EmitBinary( ExecuteBinary<SpirvLogicalEqual, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpLogicalNotEqual:
+            return EmitBinary( ExecuteBinary<SpirvLogicalNotEqual, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpLogicalOr:
+            return EmitBinary( ExecuteBinary<SpirvLogicalOr, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpLogicalAnd:
+            return EmitBinary( ExecuteBinary<SpirvLogicalAnd, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpLogicalNot:
+            return EmitUnary( ExecuteUnary<SpirvLogicalNot, uint32_t, uint32_t>, pWords, wordCount );
+
+        case spv::OpSelect:
+        {
+            if( wordCount < 6 )
+            {
+                return false;
+            }
+
+            // Vector conditions select the components, scalar conditions select the whole objects.
+            if( Id( operandType ).m_Opcode == spv::OpTypeVector )
+            {
+                return Is32Bit( pWords[ 1 ] ) && EmitComponentwise( ExecuteSelectComponents, pWords, wordCount, 3, 3 );
+            }
+
+            EmitComponentwise( ExecuteSelectObject, pWords, wordCount, 3, 3 );
+            m_Program.m_Instructions.back().m_Count = Id( pWords[ 1 ] ).m_Size;
+            return true;
+        }
+
+        case spv::OpIEqual:
+            return IsInt32( operandType ) && EmitBinary( ExecuteBinary<SpirvEqual, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpINotEqual:
+            return IsInt32( operandType ) && EmitBinary( ExecuteBinary<SpirvNotEqual, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpUGreaterThan:
+            return IsInt32( operandType ) && EmitBinary( ExecuteBinary<SpirvGreaterThan, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpSGreaterThan:
+            return IsInt32( operandType ) && EmitBinary( ExecuteBinary<SpirvGreaterThan, int32_t, uint32_t>, pWords, wordCount );
+        case spv::OpUGreaterThanEqual:
+            return IsInt32( operandType ) && EmitBinary( ExecuteBinary<SpirvGreaterThanEqual, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpSGreaterThanEqual:
+            return IsInt32( operandType ) && EmitBinary( ExecuteBinary<SpirvGreaterThanEqual, int32_t, uint32_t>, pWords, wordCount );
+        case spv::OpULessThan:
+            return IsInt32( operandType ) && EmitBinary( ExecuteBinary<SpirvLessThan, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpSLessThan:
+            return IsInt32( operandType ) && EmitBinary( ExecuteBinary<SpirvLessThan, int32_t, uint32_t>, pWords, wordCount );
+        case spv::OpULessThanEqual:
+            return IsInt32( operandType ) && EmitBinary( ExecuteBinary<SpirvLessThanEqual, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpSLessThanEqual:
+            return IsInt32( operandType ) && EmitBinary( ExecuteBinary<SpirvLessThanEqual, int32_t, uint32_t>, pWords, wordCount );
+        case spv::OpFOrdEqual:
+            return IsFloat32( operandType ) && EmitBinary( ExecuteBinary<SpirvEqual, float, uint32_t>, pWords, wordCount );
+        case spv::OpFUnordEqual:
+            return IsFloat32( operandType ) && EmitBinary( ExecuteBinary<SpirvUnordered<SpirvEqual>, float, uint32_t>, pWords, wordCount );
+        case spv::OpFOrdNotEqual:
+            return IsFloat32( operandType ) && EmitBinary( ExecuteBinary<SpirvOrderedNotEqual, float, uint32_t>, pWords, wordCount );
+        case spv::OpFUnordNotEqual:
+            return IsFloat32( operandType ) && EmitBinary( ExecuteBinary<SpirvNotEqual, float, uint32_t>, pWords, wordCount );
+        case spv::OpFOrdLessThan:
+            return IsFloat32( operandType ) && EmitBinary( ExecuteBinary<SpirvLessThan, float, uint32_t>, pWords, wordCount );
+        case spv::OpFUnordLessThan:
+            return IsFloat32( operandType ) && EmitBinary( ExecuteBinary<SpirvUnordered<SpirvLessThan>, float, uint32_t>, pWords, wordCount );
+        case spv::OpFOrdGreaterThan:
+            return IsFloat32( operandType ) && EmitBinary( ExecuteBinary<SpirvGreaterThan, float, uint32_t>, pWords, wordCount );
+        case spv::OpFUnordGreaterThan:
+            return IsFloat32( operandType ) && EmitBinary( ExecuteBinary<SpirvUnordered<SpirvGreaterThan>, float, uint32_t>, pWords, wordCount );
+        case spv::OpFOrdLessThanEqual:
+            return IsFloat32( operandType ) && EmitBinary( ExecuteBinary<SpirvLessThanEqual, float, uint32_t>, pWords, wordCount );
+        case spv::OpFUnordLessThanEqual:
+            return IsFloat32( operandType ) && EmitBinary( ExecuteBinary<SpirvUnordered<SpirvLessThanEqual>, float, uint32_t>, pWords, wordCount );
+        case spv::OpFOrdGreaterThanEqual:
+            return IsFloat32( operandType ) && EmitBinary( ExecuteBinary<SpirvGreaterThanEqual, float, uint32_t>, pWords, wordCount );
+        case spv::OpFUnordGreaterThanEqual:
+            return IsFloat32( operandType ) && EmitBinary( ExecuteBinary<SpirvUnordered<SpirvGreaterThanEqual>, float, uint32_t>, pWords, wordCount );
+
+        case spv::OpShiftRightLogical:
+            return IsInt32( pWords[ 1 ] ) && EmitBinary( ExecuteShift<SpirvShiftRightLogical, uint32_t>, pWords, wordCount );
+        case spv::OpShiftRightArithmetic:
+            return IsInt32( pWords[ 1 ] ) && EmitBinary( ExecuteShift<SpirvShiftRightArithmetic, int32_t>, pWords, wordCount );
+        case spv::OpShiftLeftLogical:
+            return IsInt32( pWords[ 1 ] ) && EmitBinary( ExecuteShift<SpirvShiftLeftLogical, uint32_t>, pWords, wordCount );
+        case spv::OpBitwiseOr:
+            return IsInt32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvBitwiseOr, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpBitwiseXor:
+            return IsInt32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvBitwiseXor, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpBitwiseAnd:
+            return IsInt32( pWords[ 1 ] ) && EmitBinary( ExecuteBinary<SpirvBitwiseAnd, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpNot:
+            return IsInt32( pWords[ 1 ] ) && EmitUnary( ExecuteUnary<SpirvNot, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpBitReverse:
+            return IsInt32( pWords[ 1 ] ) && EmitUnary( ExecuteUnary<SpirvBitReverse, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpBitCount:
+            return IsInt32( pWords[ 1 ] ) && IsInt32( operandType ) && EmitUnary( ExecuteUnary<SpirvBitCount, uint32_t, uint32_t>, pWords, wordCount );
+        case spv::OpBitFieldInsert:
+            return IsInt32( pWords[ 1 ] ) && EmitComponentwise( ExecuteBitFieldInsert, pWords, wordCount, 3, 4 );
+        case spv::OpBitFieldSExtract:
+            return IsInt32( pWords[ 1 ] ) && EmitComponentwise( ExecuteBitFieldExtract<true>, pWords, wordCount, 3, 3 );
+        case spv::OpBitFieldUExtract:
+            return IsInt32( pWords[ 1 ] ) && EmitComponentwise( ExecuteBitFieldExtract<false>, pWords, wordCount, 3, 3 );
+
+        case spv::OpConvertFToU:
+            return IsInt32( pWords[ 1 ] ) && IsFloat32( operandType ) && EmitUnary( ExecuteUnary<SpirvConvertFToU, float, uint32_t>, pWords, wordCount );
+        case spv::OpConvertFToS:
+            return IsInt32( pWords[ 1 ] ) && IsFloat32( operandType ) && EmitUnary( ExecuteUnary<SpirvConvertFToS, float, int32_t>, pWords, wordCount );
+        case spv::OpConvertSToF:
+            return IsFloat32( pWords[ 1 ] ) && IsInt32( operandType ) && EmitUnary( ExecuteUnary<SpirvConvertSToF, int32_t, float>, pWords, wordCount );
+        case spv::OpConvertUToF:
+            return IsFloat32( pWords[ 1 ] ) && IsInt32( operandType ) && EmitUnary( ExecuteUnary<SpirvConvertUToF, uint32_t, float>, pWords, wordCount );
+
+        case spv::OpControlBarrier:
+            // Barriers with the subgroup execution scope only synchronize the subgroup.
+            if( ConstantValue( pWords[ 1 ] ) == spv::ScopeSubgroup )
+            {
+                Emit( ExecuteSubgroupWait ).m_pfnGroupHandler = ExecuteGroupSync;
+                return true;
+            }
+            Emit( ExecuteControlBarrier );
+            return true;
+
+        case spv::OpMemoryBarrier:
+            Emit( ExecuteMemoryBarrier );
+            return true;
+
+        case spv::OpAtomicLoad:
+        case spv::OpAtomicStore:
+        case spv::OpAtomicExchange:
+        case spv::OpAtomicCompareExchange:
+        case spv::OpAtomicIIncrement:
+        case spv::OpAtomicIDecrement:
+        case spv::OpAtomicIAdd:
+        case spv::OpAtomicISub:
+        case spv::OpAtomicSMin:
+        case spv::OpAtomicUMin:
+        case spv::OpAtomicSMax:
+        case spv::OpAtomicUMax:
+        case spv::OpAtomicAnd:
+        case spv::OpAtomicOr:
+        case spv::OpAtomicXor:
+            return DecodeAtomic( pWords, wordCount );
+
+        case spv::OpPhi:
+        {
+            if( m_PhiInstruction == g_InvalidOffset )
+            {
+                Emit( ExecutePhi );
+                m_PhiInstruction = static_cast<uint32_t>( m_Program.m_Instructions.size() - 1 );
+                m_PhiScratchSize = 0;
+            }
+
+            const uint32_t size = Id( pWords[ 1 ] ).m_Size;
+            const uint32_t incomingCount = ( wordCount - 3 ) / 2;
+
+            m_Program.m_Instructions.back().m_Count++;
+            EmitExtraOperand( Result( pWords ) );
+            EmitExtraOperand( size );
+            EmitExtraOperand( incomingCount );
+
+            // Values defined later in the function get their offsets here.
+            for( uint32_t i = 0; i < incomingCount; ++i )
+            {
+                EmitExtraOperand( pWords[ 4 + 2 * i ] );
+                EmitExtraOperand( AllocateValue( pWords[ 3 + 2 * i ], pWords[ 1 ] ) );
+            }
+
+            m_PhiScratchSize += size;
+            m_MaxPhiScratchSize = std::max( m_MaxPhiScratchSize, m_PhiScratchSize );
+            return true;
+        }
+
+        case spv::OpBranch:
+        {
+            if( wordCount < 2 )
+            {
+                return false;
+            }
+
+            SpirvInstruction& instruction = Emit( ExecuteBranch );
+            instruction.m_Operands[ 0 ] = pWords[ 1 ];
+            instruction.m_Operands[ 1 ] = m_CurrentBlock;
+            return true;
+        }
+
+        case spv::OpBranchConditional:
+        {
+            if( wordCount < 4 )
+            {
+                return false;
+            }
+
+            SpirvInstruction& instruction = Emit( ExecuteBranchConditional );
+            instruction.m_Operands[ 0 ] = ValueOffset( pWords[ 1 ] );
+            instruction.m_Operands[ 1 ] = pWords[ 2 ];
+            instruction.m_Operands[ 2 ] = pWords[ 3 ];
+            instruction.m_Operands[ 3 ] = m_CurrentBlock;
+            return true;
+        }
+
+        case spv::OpSwitch:
+        {
+            if( !IsInt32( Id( pWords[ 1 ] ).m_Type ) )
+            {
+                return false;
+            }
+
+            SpirvInstruction& instruction = Emit( ExecuteSwitch );
+            instruction.m_Operands[ 0 ] = ValueOffset( pWords[ 1 ] );
+            instruction.m_Operands[ 1 ] = pWords[ 2 ];
+            instruction.m_Operands[ 2 ] = m_CurrentBlock;
+
+            for( uint32_t i = 3; i + 1 < wordCount; i += 2 )
+            {
+                EmitExtraOperand( pWords[ i ] );
+                EmitExtraOperand( pWords[ i + 1 ] );
+            }
+            return true;
+        }
+
+        case spv::OpReturn:
+            Emit( ExecuteReturn ).m_Operands[ 0 ] = g_InvalidOffset;
+            return true;
+
+        case spv::OpReturnValue:
+            if( wordCount < 2 )
+            {
+                return false;
+            }
+            Emit( ExecuteReturn ).m_Operands[ 0 ] = ValueOffset( pWords[ 1 ] );
+            return true;
+
+        case spv::OpKill:
+        case spv::OpUnreachable:
+        case spv::OpTerminateInvocation:
+            Emit( ExecuteTerminate );
+            return true;
+
+        case spv::OpFunctionCall:
+        {
+            if( wordCount < 4 )
+            {
+                return false;
+            }
+
+            m_FunctionCalls.push_back( { static_cast<uint32_t>( m_Program.m_Instructions.size() ), m_CurrentFunction, pWords[ 3 ] } );
+
+            SpirvInstruction& instruction = Emit( ExecuteFunctionCall, Result( pWords ) );
+            instruction.m_Count = Id( pWords[ 1 ] ).m_Size;
+
+            // Parameter indices are replaced with the offsets of the parameters when the module is linked.
+            for( uint32_t i = 4; i < wordCount; ++i )
+            {
+                EmitExtraOperand( i - 4 );
+                EmitExtraOperand( ValueOffset( pWords[ i ] ) );
+                EmitExtraOperand( TypeOf( pWords[ i ] ).m_Size );
+            }
+            return true;
+        }
+
+        case spv::OpExtInst:
+            if( wordCount < 5 )
+            {
+                return false;
+            }
+            if( Id( pWords[ 3 ] ).m_NonSemantic )
+            {
+                return true;
+            }
+            return pWords[ 3 ] == m_GlslInstructionSet && DecodeGlslInstruction( pWords, wordCount );
+
+        case spv::OpGroupNonUniformElect:
+        case spv::OpGroupNonUniformAll:
+        case spv::OpGroupNonUniformAny:
+        case spv::OpGroupNonUniformAllEqual:
+        case spv::OpGroupNonUniformBroadcast:
+        case spv::OpGroupNonUniformBroadcastFirst:
+        case spv::OpGroupNonUniformBallot:
+        case spv::OpGroupNonUniformInverseBallot:
+        case spv::OpGroupNonUniformBallotBitExtract:
+        case spv::OpGroupNonUniformBallotBitCount:
+        case spv::OpGroupNonUniformBallotFindLSB:
+        case spv::OpGroupNonUniformBallotFindMSB:
+        case spv::OpGroupNonUniformShuffle:
+        case spv::OpGroupNonUniformShuffleXor:
+        case spv::OpGroupNonUniformShuffleUp:
+        case spv::OpGroupNonUniformShuffleDown:
+        case spv::OpGroupNonUniformIAdd:
+        case spv::OpGroupNonUniformFAdd:
+        case spv::OpGroupNonUniformIMul:
+        case spv::OpGroupNonUniformFMul:
+        case spv::OpGroupNonUniformSMin:
+        case spv::OpGroupNonUniformUMin:
+        case spv::OpGroupNonUniformFMin:
+        case spv::OpGroupNonUniformSMax:
+        case spv::OpGroupNonUniformUMax:
+        case spv::OpGroupNonUniformFMax:
+        case spv::OpGroupNonUniformBitwiseAnd:
+        case spv::OpGroupNonUniformBitwiseOr:
+        case spv::OpGroupNonUniformBitwiseXor:
+        case spv::OpGroupNonUniformLogicalAnd:
+        case spv::OpGroupNonUniformLogicalOr:
+        case spv::OpGroupNonUniformLogicalXor:
+            return DecodeGroupOperation( pWords, wordCount );
+
+        default:
+            return false;
+        }
+    }
+
+    bool SpirvDecoder::DecodeAccessChain( const uint32_t* pWords, uint32_t wordCount )
+    {
+        if( wordCount < 4 )
+        {
+            return false;
+        }
+
+        const SpirvId& base = Id( pWords[ 3 ] );
+        uint32_t type = TypeOf( pWords[ 3 ] ).m_ElementType;
+        uint32_t firstIndex = 4;
+
+        SpirvInstruction& instruction = Emit( ExecuteAccessChain, Result( pWords ) );
+        instruction.m_Operands[ 0 ] = ValueOffset( pWords[ 3 ] );
+        instruction.m_Operands[ 1 ] = g_InvalidOffset;
+
+        // The first index of the arrays of descriptors selects the descriptor.
+        if( base.m_Variable != UINT32_MAX && m_Program.m_Variables[ base.m_Variable ].m_DescriptorCount && wordCount > 4 )
+        {
+            instruction.m_Operands[ 1 ] = ValueOffset( pWords[ 4 ] );
+            instruction.m_Operands[ 2 ] = m_Program.m_Variables[ base.m_Variable ].m_RangeOffset;
+            type = Id( type ).m_ElementType;
+            firstIndex = 5;
+        }
+
+        uint32_t offset = 0;
+        for( uint32_t i = firstIndex; i < wordCount; ++i )
+        {
+            const SpirvId& typeId = Id( type );
+            const SpirvId& index = Id( pWords[ i ] );
+
+            if( !IsInt32( index.m_Type ) )
+            {
+                return false;
+            }
+
+            if( typeId.m_Opcode == spv::OpTypeStruct )
+            {
+                // Members of the structures are always selected with constants.
+                if( !index.m_Constant || !( type = Constituent( type, ConstantValue( pWords[ i ] ), offset ) ) )
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            if( typeId.m_Opcode != spv::OpTypeArray &&
+                typeId.m_Opcode != spv::OpTypeRuntimeArray &&
+                typeId.m_Opcode != spv::OpTypeVector &&
+                typeId.m_Opcode != spv::OpTypeMatrix )
+            {
+                return false;
+            }
+
+            if( index.m_Constant )
+            {
+                offset += typeId.m_Stride * ConstantValue( pWords[ i ] );
+            }
+            else
+            {
+                EmitExtraOperand( typeId.m_Stride );
+                EmitExtraOperand( ValueOffset( pWords[ i ] ) );
+            }
+
+            type = typeId.m_ElementType;
+        }
+
+        m_Program.m_Instructions.back().m_Count = offset;
+        return true;
+    }
+
+    bool SpirvDecoder::DecodeAtomic( const uint32_t* pWords, uint32_t wordCount )
+    {
+        const uint32_t opcode = pWords[ 0 ] & 0xFFFF;
+
+        if( opcode == spv::OpAtomicStore )
+        {
+            if( wordCount < 5 || !IsInt32( Id( pWords[ 4 ] ).m_Type ) )
+            {
+                return false;
+            }
+
+            SpirvInstruction& instruction = Emit( ExecuteAtomicStore );
+            instruction.m_Operands[ 0 ] = ValueOffset( pWords[ 1 ] );
+            instruction.m_Operands[ 1 ] = ValueOffset( pWords[ 4 ] );
+            return true;
+        }
+
+        if( wordCount < 6 || !IsInt32( pWords[ 1 ] ) )
+        {
+            return false;
+        }
+
+        SpirvHandler pfnHandler = nullptr;
+        uint32_t valueIndex = 6;
+
+        switch( opcode )
+        {
+        case spv::OpAtomicLoad:
+            pfnHandler = ExecuteAtomicLoad;
+            valueIndex = 0;
+            break;
+        case spv::OpAtomicCompareExchange:
+            pfnHandler = ExecuteAtomicCompareExchange;
+            valueIndex = 7;
+            break;
+        case spv::OpAtomicIIncrement:
+            pfnHandler = ExecuteAtomic<SpirvAtomicIIncrement, uint32_t>;
+            valueIndex = 0;
+            break;
+        case spv::OpAtomicIDecrement:
+            pfnHandler = ExecuteAtomic<SpirvAtomicIDecrement, uint32_t>;
+            valueIndex = 0;
+            break;
+        case spv::OpAtomicExchange:
+            pfnHandler = ExecuteAtomic<SpirvAtomicExchange, uint32_t>;
+            break;
+        case spv::OpAtomicIAdd:
+            pfnHandler = ExecuteAtomic<SpirvIAdd, uint32_t>;
+            break;
+        case spv::OpAtomicISub:
+            pfnHandler = ExecuteAtomic<SpirvISub, uint32_t>;
+            break;
+        case spv::OpAtomicSMin:
+            pfnHandler = ExecuteAtomic<SpirvSMin, int32_t>;
+            break;
+        case spv::OpAtomicUMin:
+            pfnHandler = ExecuteAtomic<SpirvUMin, uint32_t>;
+            break;
+        case spv::OpAtomicSMax:
+            pfnHandler = ExecuteAtomic<SpirvSMax, int32_t>;
+            break;
+        case spv::OpAtomicUMax:
+            pfnHandler = ExecuteAtomic<SpirvUMax, uint32_t>;
+            break;
+        case spv::OpAtomicAnd:
+            pfnHandler = ExecuteAtomic<SpirvBitwiseAnd, uint32_t>;
+            break;
+        case spv::OpAtomicOr:
+            pfnHandler = ExecuteAtomic<SpirvBitwiseOr, uint32_t>;
+            break;
+        case spv::OpAtomicXor:
+            pfnHandler = ExecuteAtomic<SpirvBitwiseXor, uint32_t>;
+            break;
+        default:
+            return false;
+        }
+
+        if( valueIndex >= wordCount || ( opcode == spv::OpAtomicCompareExchange && wordCount < 9 ) )
+        {
+            return false;
+        }
+
+        SpirvInstruction& instruction = Emit( pfnHandler, Result( pWords ) );
+        instruction.m_Operands[ 0 ] = ValueOffset( pWords[ 3 ] );
+        instruction.m_Operands[ 1 ] = valueIndex ? ValueOffset( pWords[ valueIndex ] ) : g_InvalidOffset;
+
+        if( opcode == spv::OpAtomicCompareExchange )
+        {
+            instruction.m_Operands[ 2 ] = ValueOffset( pWords[ 8 ] );
+        }
+        return true;
+    }
+
+    bool SpirvDecoder::DecodeGroupOperation( const uint32_t* pWords, uint32_t wordCount )
+    {
+        const uint32_t opcode = pWords[ 0 ] & 0xFFFF;
+        const uint32_t type = pWords[ 1 ];
+
+        // Only the subgroup scope is supported.
+        if( wordCount < 4 || ConstantValue( pWords[ 3 ] ) != spv::ScopeSubgroup )
+        {
+            return false;
+        }
+
+        // Operations that do not exchange values between the invocations.
+        switch( opcode )
+        {
+        case spv::OpGroupNonUniformInverseBallot:
+            return EmitComponentwise( ExecuteInverseBallot, pWords, wordCount, 4, 1 );
+        case spv::OpGroupNonUniformBallotBitExtract:
+            return EmitComponentwise( ExecuteBallotBitExtract, pWords, wordCount, 4, 2 );
+        case spv::OpGroupNonUniformBallotFindLSB:
+            return EmitComponentwise( ExecuteBallotFindLsb, pWords, wordCount, 4, 1 );
+        case spv::OpGroupNonUniformBallotFindMSB:
+            return EmitComponentwise( ExecuteBallotFindMsb, pWords, wordCount, 4, 1 );
+        case spv::OpGroupNonUniformBallotBitCount:
+            if( !EmitComponentwise( ExecuteBallotBitCount, pWords, wordCount, 5, 1 ) )
+            {
+                return false;
+            }
+            m_Program.m_Instructions.back().m_Operands[ 1 ] = pWords[ 4 ];
+            return true;
+        }
+
+        SpirvGroupHandler pfnGroupHandler = nullptr;
+        uint32_t operandCount = 0;
+        bool arithmetic = false;
+
+        switch( opcode )
+        {
+        case spv::OpGroupNonUniformElect:
+            pfnGroupHandler = ExecuteGroupElect;
+            break;
+        case spv::OpGroupNonUniformAll:
+            pfnGroupHandler = ExecuteGroupVote<true>;
+            operandCount = 1;
+            break;
+        case spv::OpGroupNonUniformAny:
+            pfnGroupHandler = ExecuteGroupVote<false>;
+            operandCount = 1;
+            break;
+        case spv::OpGroupNonUniformAllEqual:
+            pfnGroupHandler = ExecuteGroupAllEqual;
+            operandCount = 1;
+            break;
+        case spv::OpGroupNonUniformBallot:
+            pfnGroupHandler = ExecuteGroupBallot;
+            operandCount = 1;
+            break;
+        case spv::OpGroupNonUniformBroadcast:
+        case spv::OpGroupNonUniformShuffle:
+            pfnGroupHandler = ExecuteGroupShuffle<SpirvBroadcast>;
+            operandCount = 2;
+            break;
+        case spv::OpGroupNonUniformBroadcastFirst:
+            pfnGroupHandler = ExecuteGroupShuffle<SpirvBroadcast>;
+            operandCount = 1;
+            break;
+        case spv::OpGroupNonUniformShuffleXor:
+            pfnGroupHandler = ExecuteGroupShuffle<SpirvShuffleXor>;
+            operandCount = 2;
+            break;
+        case spv::OpGroupNonUniformShuffleUp:
+            pfnGroupHandler = ExecuteGroupShuffle<SpirvShuffleUp>;
+            operandCount = 2;
+            break;
+        case spv::OpGroupNonUniformShuffleDown:
+            pfnGroupHandler = ExecuteGroupShuffle<SpirvShuffleDown>;
+            operandCount = 2;
+            break;
+        default:
+            arithmetic = true;
+            break;
+        }
+
+        if( arithmetic )
+        {
+            const bool integer = IsInt32( type );
+            const bool floating = IsFloat32( type );
+            const bool boolean = IsBool( type );
+
+            switch( opcode )
+            {
+            case spv::OpGroupNonUniformIAdd:
+                pfnGroupHandler = integer ? ExecuteGroupArithmetic<SpirvIAdd, uint32_t> : nullptr;
+                break;
+            case spv::OpGroupNonUniformFAdd:
+                pfnGroupHandler = floating ? ExecuteGroupArithmetic<SpirvFAdd, float> : nullptr;
+                break;
+            case spv::OpGroupNonUniformIMul:
+                pfnGroupHandler = integer ? ExecuteGroupArithmetic<SpirvIMul, uint32_t> : nullptr;
+                break;
+            case spv::OpGroupNonUniformFMul:
+                pfnGroupHandler = floating ? ExecuteGroupArithmetic<SpirvFMul, float> : nullptr;
+                break;
+            case spv::OpGroupNonUniformSMin:
+                pfnGroupHandler = integer ? ExecuteGroupArithmetic<SpirvSMin, int32_t> : nullptr;
+                break;
+            case spv::OpGroupNonUniformUMin:
+                pfnGroupHandler = integer ? ExecuteGroupArithmetic<SpirvUMin, uint32_t> : nullptr;
+                break;
+            case spv::OpGroupNonUniformFMin:
+                pfnGroupHandler = floating ? ExecuteGroupArithmetic<SpirvFMin, float> : nullptr;
+                break;
+            case spv::OpGroupNonUniformSMax:
+                pfnGroupHandler = integer ? ExecuteGroupArithmetic<SpirvSMax, int32_t> : nullptr;
+                break;
+            case spv::OpGroupNonUniformUMax:
+                pfnGroupHandler = integer ? ExecuteGroupArithmetic<SpirvUMax, uint32_t> : nullptr;
+                break;
+            case spv::OpGroupNonUniformFMax:
+                pfnGroupHandler = floating ? ExecuteGroupArithmetic<SpirvFMax, float> : nullptr;
+                break;
+            case spv::OpGroupNonUniformBitwiseAnd:
+                pfnGroupHandler = integer ? ExecuteGroupArithmetic<SpirvBitwiseAnd, uint32_t> : nullptr;
+                break;
+            case spv::OpGroupNonUniformBitwiseOr:
+                pfnGroupHandler = integer ? ExecuteGroupArithmetic<SpirvBitwiseOr, uint32_t> : nullptr;
+                break;
+            case spv::OpGroupNonUniformBitwiseXor:
+                pfnGroupHandler = integer ? ExecuteGroupArithmetic<SpirvBitwiseXor, uint32_t> : nullptr;
+                break;
+            case spv::OpGroupNonUniformLogicalAnd:
+                pfnGroupHandler = boolean ? ExecuteGroupArithmetic<SpirvLogicalAnd, uint32_t> : nullptr;
+                break;
+            case spv::OpGroupNonUniformLogicalOr:
+                pfnGroupHandler = boolean ? ExecuteGroupArithmetic<SpirvLogicalOr, uint32_t> : nullptr;
+                break;
+            case spv::OpGroupNonUniformLogicalXor:
+                pfnGroupHandler = boolean ? ExecuteGroupArithmetic<SpirvLogicalNotEqual, uint32_t> : nullptr;
+                break;
+            }
+
+            if( !pfnGroupHandler || wordCount < 6 )
+            {
+                return false;
+            }
+
+            // The group operation precedes the value, and the cluster size follows it.
+            SpirvInstruction& instruction = Emit( ExecuteSubgroupWait, Result( pWords ) );
+            instruction.m_pfnGroupHandler = pfnGroupHandler;
+            instruction.m_Operands[ 0 ] = ValueOffset( pWords[ 5 ] );
+            instruction.m_Operands[ 1 ] = pWords[ 4 ];
+            instruction.m_Operands[ 2 ] = ( wordCount > 6 ) ? ValueOffset( pWords[ 6 ] ) : g_InvalidOffset;
+            instruction.m_Count = ComponentCount( type );
+
+            return pWords[ 4 ] <= spv::GroupOperationClusteredReduce &&
+                ( pWords[ 4 ] != spv::GroupOperationClusteredReduce || wordCount > 6 );
+        }
+
+        if( wordCount < 4 + operandCount )
+        {
+            return false;
+        }
+
+        SpirvInstruction& instruction = Emit( ExecuteSubgroupWait, Result( pWords ) );
+        instruction.m_pfnGroupHandler = pfnGroupHandler;
+        instruction.m_Operands[ 1 ] = g_InvalidOffset;
+        for( uint32_t i = 0; i < operandCount; ++i )
+        {
+            instruction.m_Operands[ i ] = ValueOffset( pWords[ 4 + i ] );
+        }
+
+        // Values exchanged between the invocations are copied as a whole.
+        instruction.m_Count = operandCount ? TypeOf( pWords[ 4 ] ).m_Size : 0;
+        return true;
+    }
+
+    bool SpirvDecoder::DecodeGlslInstruction( const uint32_t* pWords, uint32_t wordCount )
+    {
+        const uint32_t type = pWords[ 1 ];
+        const bool floating = IsFloat32( type );
+        const bool integer = IsInt32( type );
+
+        switch( pWords[ 4 ] )
+        {
+        case spv::GLSLstd450Round:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvRound, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450RoundEven:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvRoundEven, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Trunc:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvTrunc, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450FAbs:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvFAbs, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450SAbs:
+            return integer && EmitComponentwise( ExecuteUnary<SpirvSAbs, int32_t, uint32_t>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450FSign:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvFSign, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450SSign:
+            return integer && EmitComponentwise( ExecuteUnary<SpirvSSign, int32_t, int32_t>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Floor:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvFloor, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Ceil:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvCeil, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Fract:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvFract, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Radians:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvRadians, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Degrees:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvDegrees, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Sin:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvSin, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Cos:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvCos, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Tan:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvTan, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Asin:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvAsin, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Acos:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvAcos, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Atan:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvAtan, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Sinh:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvSinh, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Cosh:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvCosh, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Tanh:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvTanh, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Atan2:
+            return floating && EmitComponentwise( ExecuteBinary<SpirvAtan2, float, float>, pWords, wordCount, 5, 2 );
+        case spv::GLSLstd450Pow:
+            return floating && EmitComponentwise( ExecuteBinary<SpirvPow, float, float>, pWords, wordCount, 5, 2 );
+        case spv::GLSLstd450Exp:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvExp, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Log:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvLog, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Exp2:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvExp2, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Log2:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvLog2, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Sqrt:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvSqrt, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450InverseSqrt:
+            return floating && EmitComponentwise( ExecuteUnary<SpirvInverseSqrt, float, float>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450FMin:
+        case spv::GLSLstd450NMin:
+            return floating && EmitComponentwise( ExecuteBinary<SpirvFMin, float, float>, pWords, wordCount, 5, 2 );
+        case spv::GLSLstd450UMin:
+            return integer && EmitComponentwise( ExecuteBinary<SpirvUMin, uint32_t, uint32_t>, pWords, wordCount, 5, 2 );
+        case spv::GLSLstd450SMin:
+            return integer && EmitComponentwise( ExecuteBinary<SpirvSMin, int32_t, int32_t>, pWords, wordCount, 5, 2 );
+        case spv::GLSLstd450FMax:
+        case spv::GLSLstd450NMax:
+            return floating && EmitComponentwise( ExecuteBinary<SpirvFMax, float, float>, pWords, wordCount, 5, 2 );
+        case spv::GLSLstd450UMax:
+            return integer && EmitComponentwise( ExecuteBinary<SpirvUMax, uint32_t, uint32_t>, pWords, wordCount, 5, 2 );
+        case spv::GLSLstd450SMax:
+            return integer && EmitComponentwise( ExecuteBinary<SpirvSMax, int32_t, int32_t>, pWords, wordCount, 5, 2 );
+        case spv::GLSLstd450FClamp:
+        case spv::GLSLstd450NClamp:
+            return floating && EmitComponentwise( ExecuteTernary<SpirvFClamp, float>, pWords, wordCount, 5, 3 );
+        case spv::GLSLstd450UClamp:
+            return integer && EmitComponentwise( ExecuteTernary<SpirvUClamp, uint32_t>, pWords, wordCount, 5, 3 );
+        case spv::GLSLstd450SClamp:
+            return integer && EmitComponentwise( ExecuteTernary<SpirvSClamp, int32_t>, pWords, wordCount, 5, 3 );
+        case spv::GLSLstd450FMix:
+            return floating && EmitComponentwise( ExecuteTernary<SpirvFMix, float>, pWords, wordCount, 5, 3 );
+        case spv::GLSLstd450Step:
+            return floating && EmitComponentwise( ExecuteBinary<SpirvStep, float, float>, pWords, wordCount, 5, 2 );
+        case spv::GLSLstd450SmoothStep:
+            return floating && EmitComponentwise( ExecuteTernary<SpirvSmoothStep, float>, pWords, wordCount, 5, 3 );
+        case spv::GLSLstd450Fma:
+            return floating && EmitComponentwise( ExecuteTernary<SpirvFma, float>, pWords, wordCount, 5, 3 );
+        case spv::GLSLstd450FindILsb:
+            return integer && EmitComponentwise( ExecuteUnary<SpirvFindILsb, uint32_t, uint32_t>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450FindSMsb:
+            return integer && EmitComponentwise( ExecuteUnary<SpirvFindSMsb, int32_t, uint32_t>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450FindUMsb:
+            return integer && EmitComponentwise( ExecuteUnary<SpirvFindUMsb, uint32_t, uint32_t>, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Normalize:
+            return floating && EmitComponentwise( ExecuteNormalize, pWords, wordCount, 5, 1 );
+        case spv::GLSLstd450Cross:
+            return floating && ComponentCount( type ) == 3 && EmitComponentwise( ExecuteCross, pWords, wordCount, 5, 2 );
+        case spv::GLSLstd450FaceForward:
+            return floating && EmitComponentwise( ExecuteFaceForward, pWords, wordCount, 5, 3 );
+        case spv::GLSLstd450Reflect:
+            return floating && EmitComponentwise( ExecuteReflect, pWords, wordCount, 5, 2 );
+
+        case spv::GLSLstd450Length:
+        case spv::GLSLstd450Distance:
+        {
+            // The result is a scalar, so the count of the components is taken from the operand.
+            const uint32_t operandCount = ( pWords[ 4 ] == spv::GLSLstd450Length ) ? 1 : 2;
+            if( !floating || !EmitComponentwise( ( operandCount == 1 ) ? ExecuteLength : ExecuteDistance, pWords, wordCount, 5, operandCount ) )
+            {
+                return false;
+            }
+            m_Program.m_Instructions.back().m_Count = ComponentCount( Id( pWords[ 5 ] ).m_Type );
+            return true;
+        }
+
+        default:
+            return false;
+        }
+    }
+
+    bool SpirvDecoder::ResolveLabel( uint32_t& label )
+    {
+        const SpirvId& labelId = Id( label );
+        if( m_InvalidId || labelId.m_Pc == g_InvalidOffset )
+        {
+            return false;
+        }
+        label = labelId.m_Pc;
+        return true;
+    }
+
+    bool SpirvDecoder::Link()
+    {
+        m_InvalidId = false;
+
+        SpirvId& entryPoint = Id( m_EntryPoint );
+        if( m_InvalidId || entryPoint.m_Pc == g_InvalidOffset )
+        {
+            return false;
+        }
+
+        // All functions called from the entry point must be supported.
+        Vector<uint32_t> functions( 1, m_EntryPoint, m_Program.m_Allocator );
+        entryPoint.m_Reachable = true;
+
+        while( !functions.empty() )
+        {
+            const uint32_t function = functions.back();
+            functions.pop_back();
+
+            if( !m_Ids[ function ].m_Supported )
+            {
+                return false;
+            }
+
+            for( const SpirvFunctionCall& call : m_FunctionCalls )
+            {
+                if( call.m_Caller == function )
+                {
+                    SpirvId& callee = Id( call.m_Callee );
+                    if( m_InvalidId || callee.m_Opcode != spv::OpFunction )
+                    {
+                        return false;
+                    }
+                    if( !callee.m_Reachable )
+                    {
+                        callee.m_Reachable = true;
+                        functions.push_back( call.m_Callee );
+                    }
+                }
+            }
+        }
+
+        for( const SpirvFunctionCall& call : m_FunctionCalls )
+        {
+            const SpirvId& caller = m_Ids[ call.m_Caller ];
+            const SpirvId& callee = m_Ids[ call.m_Callee ];
+            if( !caller.m_Reachable )
+            {
+                continue;
+            }
+
+            SpirvInstruction& instruction = m_Program.m_Instructions[ call.m_Instruction ];
+            if( instruction.m_ExtraOperandCount != 3 * callee.m_ParameterCount )
+            {
+                return false;
+            }
+
+            uint32_t* pOperands = m_Program.m_ExtraOperands.data() + instruction.m_FirstExtraOperand;
+            for( uint32_t i = 0; i < instruction.m_ExtraOperandCount; i += 3 )
+            {
+                pOperands[ i ] = m_Parameters[ callee.m_FirstParameter + pOperands[ i ] ];
+            }
+            instruction.m_Operands[ 0 ] = callee.m_Pc;
+        }
+
+        // Phis of a block are copied through the scratch memory.
+        const uint32_t phiScratch = Allocate( m_MaxPhiScratchSize, 4 );
+
+        for( SpirvInstruction& instruction : m_Program.m_Instructions )
+        {
+            bool resolved = true;
+
+            if( instruction.m_pfnHandler == ExecuteBranch )
+            {
+                resolved = ResolveLabel( instruction.m_Operands[ 0 ] );
+            }
+            if( instruction.m_pfnHandler == ExecuteBranchConditional )
+            {
+                resolved = ResolveLabel( instruction.m_Operands[ 1 ] ) && ResolveLabel( instruction.m_Operands[ 2 ] );
+            }
+            if( instruction.m_pfnHandler == ExecuteSwitch )
+            {
+                resolved = ResolveLabel( instruction.m_Operands[ 1 ] );
+
+                uint32_t* pOperands = m_Program.m_ExtraOperands.data() + instruction.m_FirstExtraOperand;
+                for( uint32_t i = 1; i < instruction.m_ExtraOperandCount && resolved; i += 2 )
+                {
+                    resolved = ResolveLabel( pOperands[ i ] );
+                }
+            }
+            if( instruction.m_pfnHandler == ExecutePhi )
+            {
+                instruction.m_Operands[ 0 ] = phiScratch;
+            }
+
+            if( !resolved )
+            {
+                return false;
+            }
+        }
+
+        // The workgroup size builtin overrides the execution modes.
+        if( m_LocalSizeIds[ 0 ] )
+        {
+            for( uint32_t i = 0; i < 3; ++i )
+            {
+                m_Program.m_LocalSize[ i ] = ConstantValue( m_LocalSizeIds[ i ] );
+            }
+        }
+        if( m_WorkgroupSize )
+        {
+            memcpy( m_Program.m_LocalSize, m_Program.m_InitialMemory.data() + m_Ids[ m_WorkgroupSize ].m_Offset, sizeof( m_Program.m_LocalSize ) );
+        }
+
+        const uint64_t invocationCount = uint64_t( m_Program.m_LocalSize[ 0 ] ) * m_Program.m_LocalSize[ 1 ] * m_Program.m_LocalSize[ 2 ];
+        if( invocationCount == 0 || invocationCount > 1024 || m_InvalidId )
+        {
+            return false;
+        }
+
+        m_Program.m_EntryPoint = entryPoint.m_Pc;
+        m_Program.m_MemorySize = vk_align( m_Program.m_MemorySize, 16U );
+        return true;
+    }
+
+    SpirvProgram::SpirvProgram( const VkAllocationCallbacks& allocator )
+        : m_Allocator( allocator )
+        , m_LocalSize()
+        , m_EntryPoint( 0 )
+        , m_MemorySize( 0 )
+        , m_SharedMemorySize( 0 )
+        , m_InitialMemory( allocator )
+        , m_Instructions( allocator )
+        , m_ExtraOperands( allocator )
+        , m_Variables( allocator )
+    {
+        m_LocalSize[ 0 ] = 1;
+        m_LocalSize[ 1 ] = 1;
+        m_LocalSize[ 2 ] = 1;
+    }
+
+    bool SpirvProgram::Decode( const uint32_t* pCode, size_t wordCount, const char* pEntryPointName, const VkSpecializationInfo* pSpecializationInfo )
+    {
+        SpirvDecoder decoder( *this, pSpecializationInfo, pEntryPointName );
+        if( !decoder.Decode( pCode, wordCount ) )
+        {
+            m_MemorySize = 0;
+            m_SharedMemorySize = 0;
+            m_InitialMemory.clear();
+            m_Instructions.clear();
+            m_ExtraOperands.clear();
+            m_Variables.clear();
+            return false;
+        }
+        return true;
+    }
+
+    static const VkMockDescriptorBindingEXT* FindBinding( const VkMockWorkgroupEXT& workgroup, uint32_t set, uint32_t binding )
+    {
+        if( set < workgroup.descriptorSetCount && binding < workgroup.pDescriptorSets[ set ].bindingCount )
+        {
+            const VkMockDescriptorBindingEXT* pBinding = &workgroup.pDescriptorSets[ set ].pBindings[ binding ];
+            if( pBinding->descriptorCount && pBinding->pDescriptors )
+            {
+                return pBinding;
+            }
+        }
+        return nullptr;
+    }
+
+    static void WriteBuiltIn( uint8_t* pStorage, uint32_t size, uint32_t x, uint32_t y = 0, uint32_t z = 0, uint32_t w = 0 )
+    {
+        const uint32_t value[ 4 ] = { x, y, z, w };
+        memcpy( pStorage, value, std::min<size_t>( size, sizeof( value ) ) );
+    }
+
+    void SpirvProgram::ExecuteWorkgroup( const VkMockWorkgroupEXT& workgroup ) const
+    {
+        if( m_Instructions.empty() )
+        {
+            return;
+        }
+
+        const uint32_t invocationCount = m_LocalSize[ 0 ] * m_LocalSize[ 1 ] * m_LocalSize[ 2 ];
+        const uint32_t subgroupCount = vk_div_round_up( invocationCount, g_SpirvSubgroupSize );
+
+        // Arrays of descriptors are accessed through the tables of the descriptor addresses.
+        size_t descriptorTableSize = 0;
+        for( const SpirvVariable& variable : m_Variables )
+        {
+            const VkMockDescriptorBindingEXT* pBinding = FindBinding( workgroup, variable.m_DescriptorSet, variable.m_Binding );
+            if( variable.m_DescriptorCount && pBinding )
+            {
+                descriptorTableSize += std::min( variable.m_DescriptorCount, pBinding->descriptorCount );
+            }
+        }
+
+        // Memory of all invocations, the shared memory and the descriptor tables are allocated at once.
+        const size_t invocationMemorySize = size_t( m_MemorySize ) * invocationCount;
+        const size_t sharedMemorySize = vk_align<size_t>( m_SharedMemorySize, sizeof( uint64_t ) );
+
+        std::vector<uint64_t, vk_stl_allocator<uint64_t>> memory(
+            ( invocationMemorySize + sharedMemorySize ) / sizeof( uint64_t ) + descriptorTableSize,
+            0,
+            vk_stl_allocator<uint64_t>( m_Allocator ) );
+
+        uint8_t* pMemory = reinterpret_cast<uint8_t*>( memory.data() );
+        uint8_t* pSharedMemory = pMemory + invocationMemorySize;
+        uint8_t** ppDescriptorTable = reinterpret_cast<uint8_t**>( pSharedMemory + sharedMemorySize );
+
+        memcpy( pMemory, m_InitialMemory.data(), m_InitialMemory.size() );
+
+        for( const SpirvVariable& variable : m_Variables )
+        {
+            uint8_t* pPointer = nullptr;
+            VkDeviceSize range = 0;
+
+            switch( variable.m_StorageClass )
+            {
+            case spv::StorageClassWorkgroup:
+                pPointer = pSharedMemory + variable.m_StorageOffset;
+                break;
+
+            case spv::StorageClassPushConstant:
+                pPointer = static_cast<uint8_t*>( const_cast<void*>( workgroup.pPushConstants ) );
+                break;
+
+            case spv::StorageClassUniformConstant:
+            case spv::StorageClassUniform:
+            case spv::StorageClassStorageBuffer:
+                if( const VkMockDescriptorBindingEXT* pBinding = FindBinding( workgroup, variable.m_DescriptorSet, variable.m_Binding ) )
+                {
+                    if( variable.m_DescriptorCount )
+                    {
+                        range = std::min( variable.m_DescriptorCount, pBinding->descriptorCount );
+                        for( uint32_t i = 0; i < range; ++i )
+                        {
+                            ppDescriptorTable[ i ] = static_cast<uint8_t*>( pBinding->pDescriptors[ i ].pData );
+                        }
+                        pPointer = reinterpret_cast<uint8_t*>( ppDescriptorTable );
+                        ppDescriptorTable += range;
+                    }
+                    else
+                    {
+                        pPointer = static_cast<uint8_t*>( pBinding->pDescriptors[ 0 ].pData );
+                        range = pBinding->pDescriptors[ 0 ].range;
+                    }
+                }
+                break;
+            }
+
+            memcpy( pMemory + variable.m_PointerOffset, &pPointer, sizeof( pPointer ) );
+
+            if( variable.m_RangeOffset != g_InvalidOffset )
+            {
+                memcpy( pMemory + variable.m_RangeOffset, &range, sizeof( range ) );
+            }
+        }
+
+        std::vector<SpirvInvocation, vk_stl_allocator<SpirvInvocation>> invocations(
+            invocationCount,
+            SpirvInvocation(),
+            vk_stl_allocator<SpirvInvocation>( m_Allocator ) );
+
+        for( uint32_t i = 0; i < invocationCount; ++i )
+        {
+            SpirvInvocation& invocation = invocations[ i ];
+            invocation.m_pMemory = pMemory + size_t( m_MemorySize ) * i;
+            invocation.m_pExtraOperands = m_ExtraOperands.data();
+            invocation.m_Pc = m_EntryPoint;
+            invocation.m_State = eSpirvInvocationRunning;
+            invocation.m_SubgroupInvocationId = i % g_SpirvSubgroupSize;
+
+            if( i > 0 )
+            {
+                memcpy( invocation.m_pMemory, pMemory, m_InitialMemory.size() );
+            }
+
+            const uint32_t localId[ 3 ] = {
+                i % m_LocalSize[ 0 ],
+                ( i / m_LocalSize[ 0 ] ) % m_LocalSize[ 1 ],
+                i / ( m_LocalSize[ 0 ] * m_LocalSize[ 1 ] ) };
+
+            const uint32_t lane = invocation.m_SubgroupInvocationId;
+            const uint32_t subgroupMask = ( 1U << g_SpirvSubgroupSize ) - 1;
+
+            // Variables with the storage in the invocation memory, including the built-in inputs.
+            for( const SpirvVariable& variable : m_Variables )
+            {
+                if( variable.m_StorageClass != spv::StorageClassInput &&
+                    variable.m_StorageClass != spv::StorageClassOutput &&
+                    variable.m_StorageClass != spv::StorageClassPrivate )
+                {
+                    continue;
+                }
+
+                uint8_t* pStorage = invocation.m_pMemory + variable.m_StorageOffset;
+                memcpy( invocation.m_pMemory + variable.m_PointerOffset, &pStorage, sizeof( pStorage ) );
+
+                switch( variable.m_BuiltIn )
+                {
+                case spv::BuiltInNumWorkgroups:
+                    WriteBuiltIn( pStorage, variable.m_Size, workgroup.workgroupCount[ 0 ], workgroup.workgroupCount[ 1 ], workgroup.workgroupCount[ 2 ] );
+                    break;
+                case spv::BuiltInWorkgroupSize:
+                    WriteBuiltIn( pStorage, variable.m_Size, m_LocalSize[ 0 ], m_LocalSize[ 1 ], m_LocalSize[ 2 ] );
+                    break;
+                case spv::BuiltInWorkgroupId:
+                    WriteBuiltIn( pStorage, variable.m_Size, workgroup.workgroupId[ 0 ], workgroup.workgroupId[ 1 ], workgroup.workgroupId[ 2 ] );
+                    break;
+                case spv::BuiltInLocalInvocationId:
+                    WriteBuiltIn( pStorage, variable.m_Size, localId[ 0 ], localId[ 1 ], localId[ 2 ] );
+                    break;
+                case spv::BuiltInGlobalInvocationId:
+                    WriteBuiltIn( pStorage, variable.m_Size,
+                        workgroup.workgroupId[ 0 ] * m_LocalSize[ 0 ] + localId[ 0 ],
+                        workgroup.workgroupId[ 1 ] * m_LocalSize[ 1 ] + localId[ 1 ],
+                        workgroup.workgroupId[ 2 ] * m_LocalSize[ 2 ] + localId[ 2 ] );
+                    break;
+                case spv::BuiltInLocalInvocationIndex:
+                    WriteBuiltIn( pStorage, variable.m_Size, i );
+                    break;
+                case spv::BuiltInSubgroupSize:
+                    WriteBuiltIn( pStorage, variable.m_Size, g_SpirvSubgroupSize );
+                    break;
+                case spv::BuiltInNumSubgroups:
+                    WriteBuiltIn( pStorage, variable.m_Size, subgroupCount );
+                    break;
+                case spv::BuiltInSubgroupId:
+                    WriteBuiltIn( pStorage, variable.m_Size, i / g_SpirvSubgroupSize );
+                    break;
+                case spv::BuiltInSubgroupLocalInvocationId:
+                    WriteBuiltIn( pStorage, variable.m_Size, lane );
+                    break;
+                case spv::BuiltInSubgroupEqMask:
+                    WriteBuiltIn( pStorage, variable.m_Size, 1U << lane );
+                    break;
+                case spv::BuiltInSubgroupGeMask:
+                    WriteBuiltIn( pStorage, variable.m_Size, ( subgroupMask << lane ) & subgroupMask );
+                    break;
+                case spv::BuiltInSubgroupGtMask:
+                    WriteBuiltIn( pStorage, variable.m_Size, ( subgroupMask << ( lane + 1 ) ) & subgroupMask );
+                    break;
+                case spv::BuiltInSubgroupLeMask:
+                    WriteBuiltIn( pStorage, variable.m_Size, ( 2U << lane ) - 1 );
+                    break;
+                case spv::BuiltInSubgroupLtMask:
+                    WriteBuiltIn( pStorage, variable.m_Size, ( 1U << lane ) - 1 );
+                    break;
+                }
+            }
+        }
+
+        const SpirvInstruction* pInstructions = m_Instructions.data();
+        SpirvInvocation* ppSubgroup[ g_SpirvSubgroupSize ];
+
+        for( ;; )
+        {
+            // Run each invocation until it finishes or reaches a barrier or a subgroup operation.
+            for( SpirvInvocation& invocation : invocations )
+            {
+                while( invocation.m_State == eSpirvInvocationRunning )
+                {
+                    const SpirvInstruction& instruction = pInstructions[ invocation.m_Pc++ ];
+                    instruction.m_pfnHandler( invocation, instruction );
+                }
+            }
+
+            // Invocations of a subgroup waiting at the earliest subgroup operation execute it together.
+            bool progress = false;
+            for( uint32_t subgroup = 0; subgroup < subgroupCount; ++subgroup )
+            {
+                const uint32_t firstInvocation = subgroup * g_SpirvSubgroupSize;
+                const uint32_t lastInvocation = std::min( firstInvocation + g_SpirvSubgroupSize, invocationCount );
+
+                uint32_t pc = UINT32_MAX;
+                for( uint32_t i = firstInvocation; i < lastInvocation; ++i )
+                {
+                    if( invocations[ i ].m_State == eSpirvInvocationSubgroupWait )
+                    {
+                        pc = std::min( pc, invocations[ i ].m_Pc );
+                    }
+                }
+
+                if( pc == UINT32_MAX )
+                {
+                    continue;
+                }
+
+                uint32_t activeCount = 0;
+                for( uint32_t i = firstInvocation; i < lastInvocation; ++i )
+                {
+                    if( invocations[ i ].m_State == eSpirvInvocationSubgroupWait && invocations[ i ].m_Pc == pc )
+                    {
+                        invocations[ i ].m_State = eSpirvInvocationRunning;
+                        ppSubgroup[ activeCount++ ] = &invocations[ i ];
+                    }
+                }
+
+                const SpirvInstruction& instruction = pInstructions[ pc - 1 ];
+                instruction.m_pfnGroupHandler( ppSubgroup, activeCount, instruction );
+                progress = true;
+            }
+
+            if( progress )
+            {
+                continue;
+            }
+
+            // All invocations have either finished or reached a barrier.
+            bool barrier = false;
+            for( SpirvInvocation& invocation : invocations )
+            {
+                if( invocation.m_State == eSpirvInvocationBarrierWait )
+                {
+                    invocation.m_State = eSpirvInvocationRunning;
+                    barrier = true;
+                }
+            }
+
+            if( !barrier )
+            {
+                break;
+            }
+        }
+    }
+
+    void VKAPI_PTR SpirvProgram::Execute( const VkMockWorkgroupEXT* pWorkgroup )
+    {
+        static_cast<const SpirvProgram*>( pWorkgroup->pUserData )->ExecuteWorkgroup( *pWorkgroup );
+    }
+}
@@ -0,0 +1,112 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "vk_mock.h"
+#include "vk_mock_icd_helpers.h"
+#include <vector>
+
+namespace vkmock
+{
+    // Number of invocations executed together by the subgroup operations.
+    static constexpr uint32_t g_SpirvSubgroupSize = 8;
+
+    struct SpirvInvocation;
+    struct SpirvInstruction;
+
+    typedef void ( *SpirvHandler )( SpirvInvocation& invocation, const SpirvInstruction& instruction );
+    typedef void ( *SpirvGroupHandler )( SpirvInvocation* const* ppInvocations, uint32_t invocationCount, const SpirvInstruction& instruction );
+
+    /**
+     * @brief
+     *   Single instruction of the threaded code executed by the interpreter.
+     *   Operands are offsets of the values in the memory of an invocation,
+     *   resolved when the module is decoded, so the handlers never look up the ids.
+     */
+    struct SpirvInstruction
+    {
+        SpirvHandler m_pfnHandler;
+        SpirvGroupHandler m_pfnGroupHandler;
+        uint32_t m_Result;
+        uint32_t m_Operands[ 4 ];
+        uint32_t m_Count;
+        uint32_t m_FirstExtraOperand;
+        uint32_t m_ExtraOperandCount;
+    };
+
+    /**
+     * @brief
+     *   Module-scope variable of the entry point.
+     *   The pointer to the variable is written to the memory of each invocation
+     *   before the workgroup starts.
+     */
+    struct SpirvVariable
+    {
+        uint32_t m_StorageClass;
+        uint32_t m_DescriptorSet;
+        uint32_t m_Binding;
+        uint32_t m_DescriptorCount;
+        uint32_t m_BuiltIn;
+        uint32_t m_PointerOffset;
+        uint32_t m_RangeOffset;
+        uint32_t m_StorageOffset;
+        uint32_t m_Size;
+    };
+
+    /**
+     * @brief
+     *   Compute shader decoded once when the pipeline is created.
+     *   Invocations of a workgroup are interpreted on a single thread and switch at barriers
+     *   and subgroup operations, so the workgroups can be distributed between the threads
+     *   like the host compute kernels.
+     */
+    struct SpirvProgram
+    {
+        typedef std::vector<uint8_t, vk_stl_allocator<uint8_t>>
+            ByteVector;
+
+        typedef std::vector<uint32_t, vk_stl_allocator<uint32_t>>
+            UintVector;
+
+        typedef std::vector<SpirvInstruction, vk_stl_allocator<SpirvInstruction>>
+            InstructionVector;
+
+        typedef std::vector<SpirvVariable, vk_stl_allocator<SpirvVariable>>
+            VariableVector;
+
+        VkAllocationCallbacks m_Allocator;
+        uint32_t m_LocalSize[ 3 ];
+        uint32_t m_EntryPoint;
+        uint32_t m_MemorySize;
+        uint32_t m_SharedMemorySize;
+        ByteVector m_InitialMemory;
+        InstructionVector m_Instructions;
+        UintVector m_ExtraOperands;
+        VariableVector m_Variables;
+
+        explicit SpirvProgram( const VkAllocationCallbacks& allocator );
+
+        bool Decode( const uint32_t* pCode, size_t wordCount, const char* pEntryPointName, const VkSpecializationInfo* pSpecializationInfo );
+
+        void ExecuteWorkgroup( const VkMockWorkgroupEXT& workgroup ) const;
+
+        static void VKAPI_PTR Execute( const VkMockWorkgroupEXT* pWorkgroup );
+    };
+}
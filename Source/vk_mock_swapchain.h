@@ -50,7 +50,7 @@ namespace vkmock
 
         ~Swapchain()
         {
-            delete m_Image;
+            vk_delete( m_Image, g_CurrentAllocator );
         }
     };
 }
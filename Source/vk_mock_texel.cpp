@@ -0,0 +1,779 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_texel.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+namespace vkmock
+{
+    static constexpr TexelComponent R( uint8_t bits ) { return { eTexelChannelR, bits }; }
+    static constexpr TexelComponent G( uint8_t bits ) { return { eTexelChannelG, bits }; }
+    static constexpr TexelComponent B( uint8_t bits ) { return { eTexelChannelB, bits }; }
+    static constexpr TexelComponent A( uint8_t bits ) { return { eTexelChannelA, bits }; }
+    static constexpr TexelComponent X( uint8_t bits ) { return { eTexelChannelX, bits }; }
+
+    static constexpr TexelFormat Texel( TexelNumericFormat numericFormat, TexelComponent c0, TexelComponent c1 = {}, TexelComponent c2 = {}, TexelComponent c3 = {} )
+    {
+        const uint8_t componentCount = 1 + ( c1.bits != 0 ) + ( c2.bits != 0 ) + ( c3.bits != 0 );
+        const uint8_t size = ( c0.bits + c1.bits + c2.bits + c3.bits ) / 8;
+        return { numericFormat, size, 0, 0, componentCount, { c0, c1, c2, c3 } };
+    }
+
+    static constexpr TexelFormat Packed( TexelNumericFormat numericFormat, uint8_t packedBits, TexelComponent c0, TexelComponent c1 = {}, TexelComponent c2 = {}, TexelComponent c3 = {} )
+    {
+        TexelFormat format = Texel( numericFormat, c0, c1, c2, c3 );
+        format.size = packedBits / 8;
+        format.packedBits = packedBits;
+        return format;
+    }
+
+    // Formats with the components stored in the most significant bits of 16-bit words.
+    static constexpr TexelFormat Padded( uint8_t paddingBits, uint8_t componentCount )
+    {
+        return { TexelNumericFormat::eUnorm, uint8_t( 2 * componentCount ), 0, paddingBits, componentCount,
+            { R( 16 ), G( 16 ), B( 16 ), A( 16 ) } };
+    }
+
+    static constexpr TexelFormat Unknown()
+    {
+        return { TexelNumericFormat::eUnknown, 0, 0, 0, 0, {} };
+    }
+
+    TexelFormat GetTexelFormat( VkFormat format, VkImageAspectFlags aspectMask )
+    {
+        if( aspectMask & VK_IMAGE_ASPECT_STENCIL_BIT )
+        {
+            switch( format )
+            {
+            case VK_FORMAT_S8_UINT:
+            case VK_FORMAT_D16_UNORM_S8_UINT:
+            case VK_FORMAT_D24_UNORM_S8_UINT:
+            case VK_FORMAT_D32_SFLOAT_S8_UINT:
+                return Texel( TexelNumericFormat::eUint, R( 8 ) );
+            default:
+                return Unknown();
+            }
+        }
+
+        switch( format )
+        {
+        case VK_FORMAT_R4G4_UNORM_PACK8:
+            return Packed( TexelNumericFormat::eUnorm, 8, R( 4 ), G( 4 ) );
+        case VK_FORMAT_R4G4B4A4_UNORM_PACK16:
+            return Packed( TexelNumericFormat::eUnorm, 16, R( 4 ), G( 4 ), B( 4 ), A( 4 ) );
+        case VK_FORMAT_B4G4R4A4_UNORM_PACK16:
+            return Packed( TexelNumericFormat::eUnorm, 16, B( 4 ), G( 4 ), R( 4 ), A( 4 ) );
+        case VK_FORMAT_A4R4G4B4_UNORM_PACK16:
+            return Packed( TexelNumericFormat::eUnorm, 16, A( 4 ), R( 4 ), G( 4 ), B( 4 ) );
+        case VK_FORMAT_A4B4G4R4_UNORM_PACK16:
+            return Packed( TexelNumericFormat::eUnorm, 16, A( 4 ), B( 4 ), G( 4 ), R( 4 ) );
+        case VK_FORMAT_R5G6B5_UNORM_PACK16:
+            return Packed( TexelNumericFormat::eUnorm, 16, R( 5 ), G( 6 ), B( 5 ) );
+        case VK_FORMAT_B5G6R5_UNORM_PACK16:
+            return Packed( TexelNumericFormat::eUnorm, 16, B( 5 ), G( 6 ), R( 5 ) );
+        case VK_FORMAT_R5G5B5A1_UNORM_PACK16:
+            return Packed( TexelNumericFormat::eUnorm, 16, R( 5 ), G( 5 ), B( 5 ), A( 1 ) );
+        case VK_FORMAT_B5G5R5A1_UNORM_PACK16:
+            return Packed( TexelNumericFormat::eUnorm, 16, B( 5 ), G( 5 ), R( 5 ), A( 1 ) );
+        case VK_FORMAT_A1R5G5B5_UNORM_PACK16:
+            return Packed( TexelNumericFormat::eUnorm, 16, A( 1 ), R( 5 ), G( 5 ), B( 5 ) );
+        case VK_FORMAT_R8_UNORM:
+            return Texel( TexelNumericFormat::eUnorm, R( 8 ) );
+        case VK_FORMAT_R8_SNORM:
+            return Texel( TexelNumericFormat::eSnorm, R( 8 ) );
+        case VK_FORMAT_R8_USCALED:
+            return Texel( TexelNumericFormat::eUscaled, R( 8 ) );
+        case VK_FORMAT_R8_SSCALED:
+            return Texel( TexelNumericFormat::eSscaled, R( 8 ) );
+        case VK_FORMAT_R8_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 8 ) );
+        case VK_FORMAT_R8_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 8 ) );
+        case VK_FORMAT_R8_SRGB:
+            return Texel( TexelNumericFormat::eSrgb, R( 8 ) );
+        case VK_FORMAT_R8G8_UNORM:
+            return Texel( TexelNumericFormat::eUnorm, R( 8 ), G( 8 ) );
+        case VK_FORMAT_R8G8_SNORM:
+            return Texel( TexelNumericFormat::eSnorm, R( 8 ), G( 8 ) );
+        case VK_FORMAT_R8G8_USCALED:
+            return Texel( TexelNumericFormat::eUscaled, R( 8 ), G( 8 ) );
+        case VK_FORMAT_R8G8_SSCALED:
+            return Texel( TexelNumericFormat::eSscaled, R( 8 ), G( 8 ) );
+        case VK_FORMAT_R8G8_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 8 ), G( 8 ) );
+        case VK_FORMAT_R8G8_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 8 ), G( 8 ) );
+        case VK_FORMAT_R8G8_SRGB:
+            return Texel( TexelNumericFormat::eSrgb, R( 8 ), G( 8 ) );
+        case VK_FORMAT_R8G8B8_UNORM:
+            return Texel( TexelNumericFormat::eUnorm, R( 8 ), G( 8 ), B( 8 ) );
+        case VK_FORMAT_R8G8B8_SNORM:
+            return Texel( TexelNumericFormat::eSnorm, R( 8 ), G( 8 ), B( 8 ) );
+        case VK_FORMAT_R8G8B8_USCALED:
+            return Texel( TexelNumericFormat::eUscaled, R( 8 ), G( 8 ), B( 8 ) );
+        case VK_FORMAT_R8G8B8_SSCALED:
+            return Texel( TexelNumericFormat::eSscaled, R( 8 ), G( 8 ), B( 8 ) );
+        case VK_FORMAT_R8G8B8_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 8 ), G( 8 ), B( 8 ) );
+        case VK_FORMAT_R8G8B8_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 8 ), G( 8 ), B( 8 ) );
+        case VK_FORMAT_R8G8B8_SRGB:
+            return Texel( TexelNumericFormat::eSrgb, R( 8 ), G( 8 ), B( 8 ) );
+        case VK_FORMAT_B8G8R8_UNORM:
+            return Texel( TexelNumericFormat::eUnorm, B( 8 ), G( 8 ), R( 8 ) );
+        case VK_FORMAT_B8G8R8_SNORM:
+            return Texel( TexelNumericFormat::eSnorm, B( 8 ), G( 8 ), R( 8 ) );
+        case VK_FORMAT_B8G8R8_USCALED:
+            return Texel( TexelNumericFormat::eUscaled, B( 8 ), G( 8 ), R( 8 ) );
+        case VK_FORMAT_B8G8R8_SSCALED:
+            return Texel( TexelNumericFormat::eSscaled, B( 8 ), G( 8 ), R( 8 ) );
+        case VK_FORMAT_B8G8R8_UINT:
+            return Texel( TexelNumericFormat::eUint, B( 8 ), G( 8 ), R( 8 ) );
+        case VK_FORMAT_B8G8R8_SINT:
+            return Texel( TexelNumericFormat::eSint, B( 8 ), G( 8 ), R( 8 ) );
+        case VK_FORMAT_B8G8R8_SRGB:
+            return Texel( TexelNumericFormat::eSrgb, B( 8 ), G( 8 ), R( 8 ) );
+        case VK_FORMAT_R8G8B8A8_UNORM:
+            return Texel( TexelNumericFormat::eUnorm, R( 8 ), G( 8 ), B( 8 ), A( 8 ) );
+        case VK_FORMAT_R8G8B8A8_SNORM:
+            return Texel( TexelNumericFormat::eSnorm, R( 8 ), G( 8 ), B( 8 ), A( 8 ) );
+        case VK_FORMAT_R8G8B8A8_USCALED:
+            return Texel( TexelNumericFormat::eUscaled, R( 8 ), G( 8 ), B( 8 ), A( 8 ) );
+        case VK_FORMAT_R8G8B8A8_SSCALED:
+            return Texel( TexelNumericFormat::eSscaled, R( 8 ), G( 8 ), B( 8 ), A( 8 ) );
+        case VK_FORMAT_R8G8B8A8_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 8 ), G( 8 ), B( 8 ), A( 8 ) );
+        case VK_FORMAT_R8G8B8A8_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 8 ), G( 8 ), B( 8 ), A( 8 ) );
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            return Texel( TexelNumericFormat::eSrgb, R( 8 ), G( 8 ), B( 8 ), A( 8 ) );
+        case VK_FORMAT_B8G8R8A8_UNORM:
+            return Texel( TexelNumericFormat::eUnorm, B( 8 ), G( 8 ), R( 8 ), A( 8 ) );
+        case VK_FORMAT_B8G8R8A8_SNORM:
+            return Texel( TexelNumericFormat::eSnorm, B( 8 ), G( 8 ), R( 8 ), A( 8 ) );
+        case VK_FORMAT_B8G8R8A8_USCALED:
+            return Texel( TexelNumericFormat::eUscaled, B( 8 ), G( 8 ), R( 8 ), A( 8 ) );
+        case VK_FORMAT_B8G8R8A8_SSCALED:
+            return Texel( TexelNumericFormat::eSscaled, B( 8 ), G( 8 ), R( 8 ), A( 8 ) );
+        case VK_FORMAT_B8G8R8A8_UINT:
+            return Texel( TexelNumericFormat::eUint, B( 8 ), G( 8 ), R( 8 ), A( 8 ) );
+        case VK_FORMAT_B8G8R8A8_SINT:
+            return Texel( TexelNumericFormat::eSint, B( 8 ), G( 8 ), R( 8 ), A( 8 ) );
+        case VK_FORMAT_B8G8R8A8_SRGB:
+            return Texel( TexelNumericFormat::eSrgb, B( 8 ), G( 8 ), R( 8 ), A( 8 ) );
+        case VK_FORMAT_A8B8G8R8_UNORM_PACK32:
+            return Packed( TexelNumericFormat::eUnorm, 32, A( 8 ), B( 8 ), G( 8 ), R( 8 ) );
+        case VK_FORMAT_A8B8G8R8_SNORM_PACK32:
+            return Packed( TexelNumericFormat::eSnorm, 32, A( 8 ), B( 8 ), G( 8 ), R( 8 ) );
+        case VK_FORMAT_A8B8G8R8_USCALED_PACK32:
+            return Packed( TexelNumericFormat::eUscaled, 32, A( 8 ), B( 8 ), G( 8 ), R( 8 ) );
+        case VK_FORMAT_A8B8G8R8_SSCALED_PACK32:
+            return Packed( TexelNumericFormat::eSscaled, 32, A( 8 ), B( 8 ), G( 8 ), R( 8 ) );
+        case VK_FORMAT_A8B8G8R8_UINT_PACK32:
+            return Packed( TexelNumericFormat::eUint, 32, A( 8 ), B( 8 ), G( 8 ), R( 8 ) );
+        case VK_FORMAT_A8B8G8R8_SINT_PACK32:
+            return Packed( TexelNumericFormat::eSint, 32, A( 8 ), B( 8 ), G( 8 ), R( 8 ) );
+        case VK_FORMAT_A8B8G8R8_SRGB_PACK32:
+            return Packed( TexelNumericFormat::eSrgb, 32, A( 8 ), B( 8 ), G( 8 ), R( 8 ) );
+        case VK_FORMAT_A2R10G10B10_UNORM_PACK32:
+            return Packed( TexelNumericFormat::eUnorm, 32, A( 2 ), R( 10 ), G( 10 ), B( 10 ) );
+        case VK_FORMAT_A2R10G10B10_SNORM_PACK32:
+            return Packed( TexelNumericFormat::eSnorm, 32, A( 2 ), R( 10 ), G( 10 ), B( 10 ) );
+        case VK_FORMAT_A2R10G10B10_USCALED_PACK32:
+            return Packed( TexelNumericFormat::eUscaled, 32, A( 2 ), R( 10 ), G( 10 ), B( 10 ) );
+        case VK_FORMAT_A2R10G10B10_SSCALED_PACK32:
+            return Packed( TexelNumericFormat::eSscaled, 32, A( 2 ), R( 10 ), G( 10 ), B( 10 ) );
+        case VK_FORMAT_A2R10G10B10_UINT_PACK32:
+            return Packed( TexelNumericFormat::eUint, 32, A( 2 ), R( 10 ), G( 10 ), B( 10 ) );
+        case VK_FORMAT_A2R10G10B10_SINT_PACK32:
+            return Packed( TexelNumericFormat::eSint, 32, A( 2 ), R( 10 ), G( 10 ), B( 10 ) );
+        case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+            return Packed( TexelNumericFormat::eUnorm, 32, A( 2 ), B( 10 ), G( 10 ), R( 10 ) );
+        case VK_FORMAT_A2B10G10R10_SNORM_PACK32:
+            return Packed( TexelNumericFormat::eSnorm, 32, A( 2 ), B( 10 ), G( 10 ), R( 10 ) );
+        case VK_FORMAT_A2B10G10R10_USCALED_PACK32:
+            return Packed( TexelNumericFormat::eUscaled, 32, A( 2 ), B( 10 ), G( 10 ), R( 10 ) );
+        case VK_FORMAT_A2B10G10R10_SSCALED_PACK32:
+            return Packed( TexelNumericFormat::eSscaled, 32, A( 2 ), B( 10 ), G( 10 ), R( 10 ) );
+        case VK_FORMAT_A2B10G10R10_UINT_PACK32:
+            return Packed( TexelNumericFormat::eUint, 32, A( 2 ), B( 10 ), G( 10 ), R( 10 ) );
+        case VK_FORMAT_A2B10G10R10_SINT_PACK32:
+            return Packed( TexelNumericFormat::eSint, 32, A( 2 ), B( 10 ), G( 10 ), R( 10 ) );
+        case VK_FORMAT_R16_UNORM:
+            return Texel( TexelNumericFormat::eUnorm, R( 16 ) );
+        case VK_FORMAT_R16_SNORM:
+            return Texel( TexelNumericFormat::eSnorm, R( 16 ) );
+        case VK_FORMAT_R16_USCALED:
+            return Texel( TexelNumericFormat::eUscaled, R( 16 ) );
+        case VK_FORMAT_R16_SSCALED:
+            return Texel( TexelNumericFormat::eSscaled, R( 16 ) );
+        case VK_FORMAT_R16_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 16 ) );
+        case VK_FORMAT_R16_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 16 ) );
+        case VK_FORMAT_R16_SFLOAT:
+            return Texel( TexelNumericFormat::eSfloat, R( 16 ) );
+        case VK_FORMAT_R16G16_UNORM:
+            return Texel( TexelNumericFormat::eUnorm, R( 16 ), G( 16 ) );
+        case VK_FORMAT_R16G16_SNORM:
+            return Texel( TexelNumericFormat::eSnorm, R( 16 ), G( 16 ) );
+        case VK_FORMAT_R16G16_USCALED:
+            return Texel( TexelNumericFormat::eUscaled, R( 16 ), G( 16 ) );
+        case VK_FORMAT_R16G16_SSCALED:
+            return Texel( TexelNumericFormat::eSscaled, R( 16 ), G( 16 ) );
+        case VK_FORMAT_R16G16_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 16 ), G( 16 ) );
+        case VK_FORMAT_R16G16_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 16 ), G( 16 ) );
+        case VK_FORMAT_R16G16_SFLOAT:
+            return Texel( TexelNumericFormat::eSfloat, R( 16 ), G( 16 ) );
+        case VK_FORMAT_R16G16B16_UNORM:
+            return Texel( TexelNumericFormat::eUnorm, R( 16 ), G( 16 ), B( 16 ) );
+        case VK_FORMAT_R16G16B16_SNORM:
+            return Texel( TexelNumericFormat::eSnorm, R( 16 ), G( 16 ), B( 16 ) );
+        case VK_FORMAT_R16G16B16_USCALED:
+            return Texel( TexelNumericFormat::eUscaled, R( 16 ), G( 16 ), B( 16 ) );
+        case VK_FORMAT_R16G16B16_SSCALED:
+            return Texel( TexelNumericFormat::eSscaled, R( 16 ), G( 16 ), B( 16 ) );
+        case VK_FORMAT_R16G16B16_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 16 ), G( 16 ), B( 16 ) );
+        case VK_FORMAT_R16G16B16_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 16 ), G( 16 ), B( 16 ) );
+        case VK_FORMAT_R16G16B16_SFLOAT:
+            return Texel( TexelNumericFormat::eSfloat, R( 16 ), G( 16 ), B( 16 ) );
+        case VK_FORMAT_R16G16B16A16_UNORM:
+            return Texel( TexelNumericFormat::eUnorm, R( 16 ), G( 16 ), B( 16 ), A( 16 ) );
+        case VK_FORMAT_R16G16B16A16_SNORM:
+            return Texel( TexelNumericFormat::eSnorm, R( 16 ), G( 16 ), B( 16 ), A( 16 ) );
+        case VK_FORMAT_R16G16B16A16_USCALED:
+            return Texel( TexelNumericFormat::eUscaled, R( 16 ), G( 16 ), B( 16 ), A( 16 ) );
+        case VK_FORMAT_R16G16B16A16_SSCALED:
+            return Texel( TexelNumericFormat::eSscaled, R( 16 ), G( 16 ), B( 16 ), A( 16 ) );
+        case VK_FORMAT_R16G16B16A16_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 16 ), G( 16 ), B( 16 ), A( 16 ) );
+        case VK_FORMAT_R16G16B16A16_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 16 ), G( 16 ), B( 16 ), A( 16 ) );
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+            return Texel( TexelNumericFormat::eSfloat, R( 16 ), G( 16 ), B( 16 ), A( 16 ) );
+        case VK_FORMAT_R32_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 32 ) );
+        case VK_FORMAT_R32_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 32 ) );
+        case VK_FORMAT_R32_SFLOAT:
+            return Texel( TexelNumericFormat::eSfloat, R( 32 ) );
+        case VK_FORMAT_R32G32_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 32 ), G( 32 ) );
+        case VK_FORMAT_R32G32_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 32 ), G( 32 ) );
+        case VK_FORMAT_R32G32_SFLOAT:
+            return Texel( TexelNumericFormat::eSfloat, R( 32 ), G( 32 ) );
+        case VK_FORMAT_R32G32B32_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 32 ), G( 32 ), B( 32 ) );
+        case VK_FORMAT_R32G32B32_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 32 ), G( 32 ), B( 32 ) );
+        case VK_FORMAT_R32G32B32_SFLOAT:
+            return Texel( TexelNumericFormat::eSfloat, R( 32 ), G( 32 ), B( 32 ) );
+        case VK_FORMAT_R32G32B32A32_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 32 ), G( 32 ), B( 32 ), A( 32 ) );
+        case VK_FORMAT_R32G32B32A32_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 32 ), G( 32 ), B( 32 ), A( 32 ) );
+        case VK_FORMAT_R32G32B32A32_SFLOAT:
+            return Texel( TexelNumericFormat::eSfloat, R( 32 ), G( 32 ), B( 32 ), A( 32 ) );
+        case VK_FORMAT_R64_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 64 ) );
+        case VK_FORMAT_R64_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 64 ) );
+        case VK_FORMAT_R64_SFLOAT:
+            return Texel( TexelNumericFormat::eSfloat, R( 64 ) );
+        case VK_FORMAT_R64G64_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 64 ), G( 64 ) );
+        case VK_FORMAT_R64G64_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 64 ), G( 64 ) );
+        case VK_FORMAT_R64G64_SFLOAT:
+            return Texel( TexelNumericFormat::eSfloat, R( 64 ), G( 64 ) );
+        case VK_FORMAT_R64G64B64_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 64 ), G( 64 ), B( 64 ) );
+        case VK_FORMAT_R64G64B64_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 64 ), G( 64 ), B( 64 ) );
+        case VK_FORMAT_R64G64B64_SFLOAT:
+            return Texel( TexelNumericFormat::eSfloat, R( 64 ), G( 64 ), B( 64 ) );
+        case VK_FORMAT_R64G64B64A64_UINT:
+            return Texel( TexelNumericFormat::eUint, R( 64 ), G( 64 ), B( 64 ), A( 64 ) );
+        case VK_FORMAT_R64G64B64A64_SINT:
+            return Texel( TexelNumericFormat::eSint, R( 64 ), G( 64 ), B( 64 ), A( 64 ) );
+        case VK_FORMAT_R64G64B64A64_SFLOAT:
+            return Texel( TexelNumericFormat::eSfloat, R( 64 ), G( 64 ), B( 64 ), A( 64 ) );
+
+#ifdef VK_KHR_maintenance5
+        case VK_FORMAT_A8_UNORM_KHR:
+            return Texel( TexelNumericFormat::eUnorm, A( 8 ) );
+        case VK_FORMAT_A1B5G5R5_UNORM_PACK16_KHR:
+            return Packed( TexelNumericFormat::eUnorm, 16, A( 1 ), B( 5 ), G( 5 ), R( 5 ) );
+#endif
+
+        case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+            return Packed( TexelNumericFormat::eB10G11R11Ufloat, 32, B( 10 ), G( 11 ), R( 11 ) );
+        case VK_FORMAT_E5B9G9R9_UFLOAT_PACK32:
+            return Packed( TexelNumericFormat::eE5B9G9R9Ufloat, 32, X( 5 ), B( 9 ), G( 9 ), R( 9 ) );
+
+        case VK_FORMAT_R10X6_UNORM_PACK16:
+            return Padded( 6, 1 );
+        case VK_FORMAT_R10X6G10X6_UNORM_2PACK16:
+            return Padded( 6, 2 );
+        case VK_FORMAT_R10X6G10X6B10X6A10X6_UNORM_4PACK16:
+            return Padded( 6, 4 );
+        case VK_FORMAT_R12X4_UNORM_PACK16:
+            return Padded( 4, 1 );
+        case VK_FORMAT_R12X4G12X4_UNORM_2PACK16:
+            return Padded( 4, 2 );
+        case VK_FORMAT_R12X4G12X4B12X4A12X4_UNORM_4PACK16:
+            return Padded( 4, 4 );
+
+        // Depth is always decoded to the R channel.
+        case VK_FORMAT_D16_UNORM:
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+            return Texel( TexelNumericFormat::eUnorm, R( 16 ) );
+        case VK_FORMAT_X8_D24_UNORM_PACK32:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+            return Packed( TexelNumericFormat::eUnorm, 32, X( 8 ), R( 24 ) );
+        case VK_FORMAT_D32_SFLOAT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return Texel( TexelNumericFormat::eSfloat, R( 32 ) );
+
+        default:
+            return Unknown();
+        }
+    }
+
+    uint16_t vk_float_to_half( float value )
+    {
+        uint32_t bits;
+        memcpy( &bits, &value, sizeof( bits ) );
+
+        const uint32_t sign = ( bits >> 16 ) & 0x8000;
+        const uint32_t exponent = ( bits >> 23 ) & 0xFF;
+        uint32_t mantissa = bits & 0x7FFFFF;
+
+        if( exponent == 0xFF )
+        {
+            // Infinity or NaN.
+            return uint16_t( sign | 0x7C00 | ( mantissa ? 0x200 : 0 ) );
+        }
+
+        const int32_t halfExponent = int32_t( exponent ) - 127 + 15;
+        if( halfExponent >= 0x1F )
+        {
+            return uint16_t( sign | 0x7C00 );
+        }
+
+        if( halfExponent <= 0 )
+        {
+            if( halfExponent < -10 )
+            {
+                return uint16_t( sign );
+            }
+
+            // Denormal, round to nearest even.
+            mantissa |= 0x800000;
+            const uint32_t shift = uint32_t( 14 - halfExponent );
+            uint32_t halfMantissa = mantissa >> shift;
+            const uint32_t remainder = mantissa & ( ( 1u << shift ) - 1 );
+            const uint32_t halfway = 1u << ( shift - 1 );
+            if( remainder > halfway || ( remainder == halfway && ( halfMantissa & 1 ) ) )
+            {
+                halfMantissa++;
+            }
+            return uint16_t( sign | halfMantissa );
+        }
+
+        // Round to nearest even, the carry may propagate to the exponent.
+        uint32_t half = sign | ( uint32_t( halfExponent ) << 10 ) | ( mantissa >> 13 );
+        const uint32_t remainder = mantissa & 0x1FFF;
+        if( remainder > 0x1000 || ( remainder == 0x1000 && ( half & 1 ) ) )
+        {
+            half++;
+        }
+        return uint16_t( half );
+    }
+
+    float vk_half_to_float( uint16_t value )
+    {
+        const uint32_t sign = uint32_t( value & 0x8000 ) << 16;
+        uint32_t exponent = ( value >> 10 ) & 0x1F;
+        uint32_t mantissa = value & 0x3FF;
+
+        uint32_t bits;
+        if( exponent == 0x1F )
+        {
+            bits = sign | 0x7F800000 | ( mantissa << 13 );
+        }
+        else if( exponent != 0 )
+        {
+            bits = sign | ( ( exponent + 127 - 15 ) << 23 ) | ( mantissa << 13 );
+        }
+        else if( mantissa != 0 )
+        {
+            // Normalize the denormal.
+            exponent = 127 - 15 + 1;
+            while( !( mantissa & 0x400 ) )
+            {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | ( exponent << 23 ) | ( ( mantissa & 0x3FF ) << 13 );
+        }
+        else
+        {
+            bits = sign;
+        }
+
+        float result;
+        memcpy( &result, &bits, sizeof( result ) );
+        return result;
+    }
+
+    // Unsigned floats of B10G11R11 have 5-bit exponent and no sign.
+    static uint32_t EncodeUnsignedFloat( float value, uint32_t mantissaBits )
+    {
+        if( !( value > 0.0f ) )
+        {
+            return 0;
+        }
+
+        const uint32_t half = vk_float_to_half( value );
+        return half >> ( 10 - mantissaBits );
+    }
+
+    static float DecodeUnsignedFloat( uint32_t value, uint32_t mantissaBits )
+    {
+        return vk_half_to_float( uint16_t( value << ( 10 - mantissaBits ) ) );
+    }
+
+    static uint32_t EncodeSharedExponent( const float* pRGB )
+    {
+        constexpr int32_t mantissaBits = 9;
+        constexpr int32_t bias = 15;
+        constexpr float maxValue = float( ( 1 << mantissaBits ) - 1 ) / ( 1 << mantissaBits ) * float( 1 << ( 31 - bias ) );
+
+        float rgb[ 3 ];
+        for( int i = 0; i < 3; ++i )
+        {
+            rgb[ i ] = std::min( std::max( pRGB[ i ], 0.0f ), maxValue );
+        }
+
+        const float maxComponent = std::max( { rgb[ 0 ], rgb[ 1 ], rgb[ 2 ] } );
+        int32_t exponent = std::max( -bias - 1, int32_t( floorf( log2f( std::max( maxComponent, 1e-30f ) ) ) ) ) + 1 + bias;
+        if( lrintf( maxComponent / ldexpf( 1.0f, exponent - bias - mantissaBits ) ) == ( 1 << mantissaBits ) )
+        {
+            exponent++;
+        }
+
+        const float scale = ldexpf( 1.0f, exponent - bias - mantissaBits );
+
+        uint32_t result = uint32_t( exponent ) << 27;
+        for( int i = 0; i < 3; ++i )
+        {
+            result |= uint32_t( lrintf( rgb[ i ] / scale ) ) << ( i * mantissaBits );
+        }
+        return result;
+    }
+
+    float vk_linear_to_srgb( float value )
+    {
+        if( value <= 0.0031308f )
+        {
+            return value * 12.92f;
+        }
+        return 1.055f * powf( value, 1.0f / 2.4f ) - 0.055f;
+    }
+
+    float vk_srgb_to_linear( float value )
+    {
+        if( value <= 0.04045f )
+        {
+            return value / 12.92f;
+        }
+        return powf( ( value + 0.055f ) / 1.055f, 2.4f );
+    }
+
+    static uint64_t EncodeComponent( TexelNumericFormat numericFormat, const TexelComponent& component, const VkClearColorValue& value )
+    {
+        const uint32_t bits = component.bits;
+        const uint64_t mask = ( bits == 64 ) ? ~0ull : ( ( 1ull << bits ) - 1 );
+
+        if( component.channel == eTexelChannelX )
+        {
+            return 0;
+        }
+
+        const float f = value.float32[ component.channel ];
+
+        switch( numericFormat )
+        {
+        case TexelNumericFormat::eSrgb:
+            if( component.channel != eTexelChannelA )
+            {
+                return uint64_t( llrint( double( vk_linear_to_srgb( std::min( std::max( f, 0.0f ), 1.0f ) ) ) * mask ) );
+            }
+            [[fallthrough]];
+        case TexelNumericFormat::eUnorm:
+            return uint64_t( llrint( double( std::min( std::max( f, 0.0f ), 1.0f ) ) * mask ) );
+
+        case TexelNumericFormat::eSnorm:
+        {
+            const double maxValue = double( ( 1ull << ( bits - 1 ) ) - 1 );
+            return uint64_t( llrint( double( std::min( std::max( f, -1.0f ), 1.0f ) ) * maxValue ) ) & mask;
+        }
+
+        case TexelNumericFormat::eUscaled:
+            return uint64_t( llrint( std::min( std::max( double( f ), 0.0 ), double( mask ) ) ) );
+
+        case TexelNumericFormat::eSscaled:
+        {
+            const double maxValue = double( ( 1ull << ( bits - 1 ) ) - 1 );
+            return uint64_t( llrint( std::min( std::max( double( f ), -maxValue - 1 ), maxValue ) ) ) & mask;
+        }
+
+        case TexelNumericFormat::eUint:
+            return uint64_t( value.uint32[ component.channel ] ) & mask;
+
+        case TexelNumericFormat::eSint:
+            return uint64_t( int64_t( value.int32[ component.channel ] ) ) & mask;
+
+        case TexelNumericFormat::eSfloat:
+            if( bits == 16 )
+            {
+                return vk_float_to_half( f );
+            }
+            if( bits == 64 )
+            {
+                const double d = f;
+                uint64_t result;
+                memcpy( &result, &d, sizeof( result ) );
+                return result;
+            }
+            else
+            {
+                uint32_t result;
+                memcpy( &result, &f, sizeof( result ) );
+                return result;
+            }
+
+        case TexelNumericFormat::eB10G11R11Ufloat:
+            return EncodeUnsignedFloat( f, bits - 5 );
+
+        default:
+            return 0;
+        }
+    }
+
+    static void DecodeComponent( TexelNumericFormat numericFormat, const TexelComponent& component, uint64_t encoded, VkClearColorValue* pValue )
+    {
+        const uint32_t bits = component.bits;
+        const uint64_t mask = ( bits == 64 ) ? ~0ull : ( ( 1ull << bits ) - 1 );
+
+        // Sign-extend the signed components.
+        const int64_t signedValue = ( bits == 64 ) ? int64_t( encoded ) :
+            int64_t( encoded << ( 64 - bits ) ) >> ( 64 - bits );
+
+        float& f = pValue->float32[ component.channel ];
+
+        switch( numericFormat )
+        {
+        case TexelNumericFormat::eSrgb:
+            f = float( double( encoded ) / double( mask ) );
+            if( component.channel != eTexelChannelA )
+            {
+                f = vk_srgb_to_linear( f );
+            }
+            break;
+
+        case TexelNumericFormat::eUnorm:
+            f = float( double( encoded ) / double( mask ) );
+            break;
+
+        case TexelNumericFormat::eSnorm:
+            f = std::max( float( double( signedValue ) / double( ( 1ull << ( bits - 1 ) ) - 1 ) ), -1.0f );
+            break;
+
+        case TexelNumericFormat::eUscaled:
+            f = float( encoded );
+            break;
+
+        case TexelNumericFormat::eSscaled:
+            f = float( signedValue );
+            break;
+
+        case TexelNumericFormat::eUint:
+            pValue->uint32[ component.channel ] = uint32_t( encoded );
+            break;
+
+        case TexelNumericFormat::eSint:
+            pValue->int32[ component.channel ] = int32_t( signedValue );
+            break;
+
+        case TexelNumericFormat::eSfloat:
+            if( bits == 16 )
+            {
+                f = vk_half_to_float( uint16_t( encoded ) );
+            }
+            else if( bits == 64 )
+            {
+                double d;
+                memcpy( &d, &encoded, sizeof( d ) );
+                f = float( d );
+            }
+            else
+            {
+                const uint32_t encoded32 = uint32_t( encoded );
+                memcpy( &f, &encoded32, sizeof( f ) );
+            }
+            break;
+
+        case TexelNumericFormat::eB10G11R11Ufloat:
+            f = DecodeUnsignedFloat( uint32_t( encoded ), bits - 5 );
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    void PackTexel( const TexelFormat& format, const VkClearColorValue& value, void* pTexel )
+    {
+        uint8_t* pBytes = static_cast<uint8_t*>( pTexel );
+
+        if( format.numericFormat == TexelNumericFormat::eE5B9G9R9Ufloat )
+        {
+            const uint32_t encoded = EncodeSharedExponent( value.float32 );
+            memcpy( pBytes, &encoded, sizeof( encoded ) );
+            return;
+        }
+
+        if( format.packedBits )
+        {
+            uint64_t packed = 0;
+            uint32_t shift = format.packedBits;
+            for( uint32_t i = 0; i < format.componentCount; ++i )
+            {
+                shift -= format.components[ i ].bits;
+                packed |= EncodeComponent( format.numericFormat, format.components[ i ], value ) << shift;
+            }
+
+            // Packed formats are stored in the native (little) endianness.
+            memcpy( pBytes, &packed, format.size );
+            return;
+        }
+
+        for( uint32_t i = 0; i < format.componentCount; ++i )
+        {
+            const TexelComponent& component = format.components[ i ];
+
+            uint64_t encoded;
+            if( format.paddingBits )
+            {
+                const TexelComponent unpadded = { component.channel, uint8_t( component.bits - format.paddingBits ) };
+                encoded = EncodeComponent( format.numericFormat, unpadded, value ) << format.paddingBits;
+            }
+            else
+            {
+                encoded = EncodeComponent( format.numericFormat, component, value );
+            }
+
+            memcpy( pBytes, &encoded, component.bits / 8 );
+            pBytes += component.bits / 8;
+        }
+    }
+
+    void UnpackTexel( const TexelFormat& format, const void* pTexel, VkClearColorValue* pValue )
+    {
+        const uint8_t* pBytes = static_cast<const uint8_t*>( pTexel );
+
+        const bool isInteger =
+            format.numericFormat == TexelNumericFormat::eUint ||
+            format.numericFormat == TexelNumericFormat::eSint;
+
+        if( isInteger )
+        {
+            pValue->uint32[ 0 ] = pValue->uint32[ 1 ] = pValue->uint32[ 2 ] = 0;
+            pValue->uint32[ 3 ] = 1;
+        }
+        else
+        {
+            pValue->float32[ 0 ] = pValue->float32[ 1 ] = pValue->float32[ 2 ] = 0.0f;
+            pValue->float32[ 3 ] = 1.0f;
+        }
+
+        if( format.numericFormat == TexelNumericFormat::eE5B9G9R9Ufloat )
+        {
+            uint32_t encoded;
+            memcpy( &encoded, pBytes, sizeof( encoded ) );
+
+            const float scale = ldexpf( 1.0f, int32_t( encoded >> 27 ) - 15 - 9 );
+            for( int i = 0; i < 3; ++i )
+            {
+                pValue->float32[ i ] = float( ( encoded >> ( i * 9 ) ) & 0x1FF ) * scale;
+            }
+            return;
+        }
+
+        if( format.packedBits )
+        {
+            uint64_t packed = 0;
+            memcpy( &packed, pBytes, format.size );
+
+            uint32_t shift = format.packedBits;
+            for( uint32_t i = 0; i < format.componentCount; ++i )
+            {
+                const TexelComponent& component = format.components[ i ];
+                shift -= component.bits;
+
+                if( component.channel != eTexelChannelX )
+                {
+                    const uint64_t encoded = ( packed >> shift ) & ( ( 1ull << component.bits ) - 1 );
+                    DecodeComponent( format.numericFormat, component, encoded, pValue );
+                }
+            }
+            return;
+        }
+
+        for( uint32_t i = 0; i < format.componentCount; ++i )
+        {
+            const TexelComponent& component = format.components[ i ];
+
+            uint64_t encoded = 0;
+            memcpy( &encoded, pBytes, component.bits / 8 );
+            pBytes += component.bits / 8;
+
+            if( format.paddingBits )
+            {
+                const TexelComponent unpadded = { component.channel, uint8_t( component.bits - format.paddingBits ) };
+                DecodeComponent( format.numericFormat, unpadded, encoded >> format.paddingBits, pValue );
+            }
+            else
+            {
+                DecodeComponent( format.numericFormat, component, encoded, pValue );
+            }
+        }
+    }
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <vulkan/vulkan.h>
+
+namespace vkmock
+{
+    enum class TexelNumericFormat : uint8_t
+    {
+        eUnknown,
+        eUnorm,
+        eSnorm,
+        eUscaled,
+        eSscaled,
+        eUint,
+        eSint,
+        eSfloat,
+        eSrgb,
+        eB10G11R11Ufloat,
+        eE5B9G9R9Ufloat
+    };
+
+    enum TexelChannel : uint8_t
+    {
+        eTexelChannelR,
+        eTexelChannelG,
+        eTexelChannelB,
+        eTexelChannelA,
+        eTexelChannelX
+    };
+
+    struct TexelComponent
+    {
+        TexelChannel channel;
+        uint8_t bits;
+    };
+
+    /**
+     * @brief
+     *   Describes the encoding of a single texel of an uncompressed format, or a single
+     *   aspect of a depth/stencil format.
+     *   Components of packed formats are listed from the most significant bits,
+     *   components of the other formats are listed in the memory order.
+     */
+    struct TexelFormat
+    {
+        TexelNumericFormat numericFormat;
+        uint8_t size;
+        uint8_t packedBits;
+        uint8_t paddingBits;
+        uint8_t componentCount;
+        TexelComponent components[ 4 ];
+    };
+
+    TexelFormat GetTexelFormat( VkFormat format, VkImageAspectFlags aspectMask );
+
+    /**
+     * @brief
+     *   Encode the value in the texel format.
+     *   Float formats read float32, integer formats read int32 or uint32 members of the value.
+     */
+    void PackTexel( const TexelFormat& format, const VkClearColorValue& value, void* pTexel );
+
+    /**
+     * @brief
+     *   Decode the texel. Missing color components are set to 0 and alpha to 1.
+     */
+    void UnpackTexel( const TexelFormat& format, const void* pTexel, VkClearColorValue* pValue );
+
+    uint16_t vk_float_to_half( float value );
+    float vk_half_to_float( uint16_t value );
+
+    float vk_linear_to_srgb( float value );
+    float vk_srgb_to_linear( float value );
+}
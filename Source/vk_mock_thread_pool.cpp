@@ -0,0 +1,254 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vk_mock_thread_pool.h"
+
+#include <algorithm>
+
+namespace vkmock
+{
+    ThreadPool::ThreadPool( const VkAllocationCallbacks& allocator, uint32_t threadCount )
+        : m_Allocator( allocator )
+        , m_Threads( m_Allocator )
+        , m_Jobs( m_Allocator )
+        , m_ThreadCount( 0 )
+        , m_Exit( false )
+    {
+        if( threadCount == 0 )
+        {
+            threadCount = std::thread::hardware_concurrency();
+        }
+
+        // The calling thread is one of the workers.
+        if( threadCount > 1 )
+        {
+            m_ThreadCount = threadCount - 1;
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::scoped_lock lock( m_Mutex );
+            m_Exit = true;
+        }
+
+        m_WorkAvailable.notify_all();
+
+        for( std::thread& thread : m_Threads )
+        {
+            thread.join();
+        }
+    }
+
+    void ThreadPool::ParallelFor( size_t count, const std::function<void( size_t )>& function )
+    {
+        if( count == 0 )
+        {
+            return;
+        }
+
+        if( count == 1 || m_ThreadCount == 0 )
+        {
+            for( size_t i = 0; i < count; ++i )
+            {
+                function( i );
+            }
+            return;
+        }
+
+        // Ranges hold 32-bit indices, larger jobs are executed in parts.
+        for( size_t offset = 0; offset < count; offset += UINT32_MAX )
+        {
+            RunRange( function, offset, uint32_t( std::min<size_t>( count - offset, UINT32_MAX ) ) );
+        }
+    }
+
+    void ThreadPool::RunRange( const std::function<void( size_t )>& function, size_t offset, uint32_t count )
+    {
+        Job job;
+        job.m_pFunction = &function;
+        job.m_Offset = offset;
+        job.m_RangeCount = std::min( m_ThreadCount + 1, count );
+        job.m_NextRange = 1;
+        job.m_Users = 1;
+
+        RangeVector ranges( job.m_RangeCount, m_Allocator );
+        job.m_pRanges = ranges.data();
+
+        for( uint32_t i = 0; i < job.m_RangeCount; ++i )
+        {
+            const uint64_t begin = uint64_t( count ) * i / job.m_RangeCount;
+            const uint64_t end = uint64_t( count ) * ( i + 1 ) / job.m_RangeCount;
+            job.m_pRanges[ i ].m_Value.store( ( begin << 32 ) | end, std::memory_order_relaxed );
+        }
+
+        {
+            std::scoped_lock lock( m_Mutex );
+            if( m_Threads.empty() )
+            {
+                StartThreads();
+            }
+
+            m_Jobs.push_back( &job );
+        }
+
+        m_WorkAvailable.notify_all();
+
+        RunJob( job, 0 );
+
+        // All indices have been taken, wait for the workers still running them.
+        std::unique_lock lock( m_Mutex );
+        RemoveJob( &job );
+        job.m_Users--;
+        m_JobFinished.wait( lock, [&] { return job.m_Users == 0; } );
+    }
+
+    void ThreadPool::StartThreads()
+    {
+        m_Threads.reserve( m_ThreadCount );
+
+        for( uint32_t i = 0; i < m_ThreadCount; ++i )
+        {
+            m_Threads.emplace_back( &ThreadPool::WorkerThread, this );
+        }
+    }
+
+    void ThreadPool::WorkerThread()
+    {
+        std::unique_lock lock( m_Mutex );
+
+        while( true )
+        {
+            m_WorkAvailable.wait( lock, [&] { return m_Exit || !m_Jobs.empty(); } );
+
+            if( m_Exit )
+            {
+                return;
+            }
+
+            Job* pJob = m_Jobs.front();
+            pJob->m_Users++;
+
+            const uint32_t rangeIndex = pJob->m_NextRange.fetch_add( 1, std::memory_order_relaxed );
+
+            lock.unlock();
+            RunJob( *pJob, rangeIndex );
+            lock.lock();
+
+            RemoveJob( pJob );
+
+            if( --pJob->m_Users == 0 )
+            {
+                m_JobFinished.notify_all();
+            }
+        }
+    }
+
+    void ThreadPool::RemoveJob( Job* pJob )
+    {
+        auto it = std::find( m_Jobs.begin(), m_Jobs.end(), pJob );
+        if( it != m_Jobs.end() )
+        {
+            m_Jobs.erase( it );
+        }
+    }
+
+    void ThreadPool::RunJob( Job& job, uint32_t rangeIndex )
+    {
+        uint32_t index;
+        while( ( rangeIndex < job.m_RangeCount && PopIndex( job.m_pRanges[ rangeIndex ], &index ) ) ||
+            StealIndex( job, rangeIndex, &index ) )
+        {
+            ( *job.m_pFunction )( job.m_Offset + index );
+        }
+    }
+
+    bool ThreadPool::PopIndex( Range& range, uint32_t* pIndex )
+    {
+        uint64_t value = range.m_Value.load( std::memory_order_relaxed );
+
+        while( true )
+        {
+            const uint32_t begin = uint32_t( value >> 32 );
+            const uint32_t end = uint32_t( value );
+
+            if( begin >= end )
+            {
+                return false;
+            }
+
+            if( range.m_Value.compare_exchange_weak( value, ( uint64_t( begin + 1 ) << 32 ) | end, std::memory_order_relaxed ) )
+            {
+                *pIndex = begin;
+                return true;
+            }
+        }
+    }
+
+    bool ThreadPool::StealIndex( Job& job, uint32_t rangeIndex, uint32_t* pIndex )
+    {
+        // Threads joining after all ranges have been assigned have no range to move the
+        // stolen indices to, so they take one index at a time.
+        const bool hasRange = ( rangeIndex < job.m_RangeCount );
+
+        while( true )
+        {
+            Range* pVictim = nullptr;
+            uint64_t victimValue = 0;
+            uint32_t victimSize = 0;
+
+            for( uint32_t i = 0; i < job.m_RangeCount; ++i )
+            {
+                const uint64_t value = job.m_pRanges[ i ].m_Value.load( std::memory_order_relaxed );
+                const uint32_t begin = uint32_t( value >> 32 );
+                const uint32_t end = uint32_t( value );
+
+                if( i != rangeIndex && end > begin && end - begin > victimSize )
+                {
+                    pVictim = &job.m_pRanges[ i ];
+                    victimValue = value;
+                    victimSize = end - begin;
+                }
+            }
+
+            if( !pVictim )
+            {
+                return false;
+            }
+
+            // The victim keeps the lower half of its range.
+            const uint32_t begin = uint32_t( victimValue >> 32 );
+            const uint32_t end = uint32_t( victimValue );
+            const uint32_t middle = hasRange ? begin + victimSize / 2 : end - 1;
+
+            if( pVictim->m_Value.compare_exchange_strong( victimValue, ( uint64_t( begin ) << 32 ) | middle, std::memory_order_relaxed ) )
+            {
+                if( hasRange )
+                {
+                    job.m_pRanges[ rangeIndex ].m_Value.store( ( uint64_t( middle + 1 ) << 32 ) | end, std::memory_order_relaxed );
+                }
+
+                *pIndex = middle;
+                return true;
+            }
+        }
+    }
+}
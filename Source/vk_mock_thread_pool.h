@@ -0,0 +1,100 @@
+// Copyright (c) 2024 Lukasz Stalmirski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "vk_mock_icd_helpers.h"
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vkmock
+{
+    /**
+     * @brief
+     *   Pool of worker threads executing data-parallel work of the device.
+     *   Threads are started on the first use, so devices that never execute
+     *   parallel work do not pay for them.
+     *   Indices of each job are split into contiguous ranges, one per thread.
+     *   Threads that run out of work steal the upper half of the largest
+     *   remaining range, so uneven work items do not leave cores idle.
+     */
+    struct ThreadPool
+    {
+        // Range of indices owned by a thread, packed as ( begin << 32 ) | end so that
+        // both ends are updated atomically. Ranges are padded to the size of a cache line,
+        // so that the values of two ranges never share one.
+        struct Range
+        {
+            std::atomic<uint64_t> m_Value;
+            uint8_t m_Padding[ 64 - sizeof( std::atomic<uint64_t> ) ];
+        };
+
+        typedef std::vector<Range, vk_stl_allocator<Range>>
+            RangeVector;
+
+        struct Job
+        {
+            const std::function<void( size_t )>* m_pFunction;
+            size_t m_Offset;
+            uint32_t m_RangeCount;
+            std::atomic<uint32_t> m_NextRange;
+            Range* m_pRanges;
+            size_t m_Users;
+        };
+
+        VkAllocationCallbacks m_Allocator;
+        std::mutex m_Mutex;
+        std::condition_variable m_WorkAvailable;
+        std::condition_variable m_JobFinished;
+        std::vector<std::thread, vk_stl_allocator<std::thread>> m_Threads;
+        std::vector<Job*, vk_stl_allocator<Job*>> m_Jobs;
+        uint32_t m_ThreadCount;
+        bool m_Exit;
+
+        /**
+         * @brief
+         *   Create a pool executing the jobs on threadCount threads, including the calling thread.
+         *   If threadCount is 0, the number of hardware threads is used.
+         */
+        ThreadPool( const VkAllocationCallbacks& allocator, uint32_t threadCount );
+        ~ThreadPool();
+
+        /**
+         * @brief
+         *   Calls the function for each index in [0, count) and waits for all calls to complete.
+         *   The calling thread takes part in the execution.
+         */
+        void ParallelFor( size_t count, const std::function<void( size_t )>& function );
+
+    private:
+        void StartThreads();
+        void WorkerThread();
+        void RemoveJob( Job* pJob );
+        void RunRange( const std::function<void( size_t )>& function, size_t offset, uint32_t count );
+
+        static void RunJob( Job& job, uint32_t rangeIndex );
+        static bool PopIndex( Range& range, uint32_t* pIndex );
+        static bool StealIndex( Job& job, uint32_t rangeIndex, uint32_t* pIndex );
+    };
+}
@@ -21,6 +21,15 @@
 #include <gtest/gtest.h>
 #include <vulkan/vulkan.h>
 #include <vk_mock.h>
+#include "vk_mock_memory_ops.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
 
 struct vk_mock_icd_tests : testing::Test
 {
@@ -97,6 +106,90 @@ struct vk_mock_icd_tests : testing::Test
         vkExecuteMockCommandBufferEXT = (PFN_vkExecuteMockCommandBufferEXT)vkGetDeviceProcAddr( device, "vkExecuteMockCommandBufferEXT" );
         ASSERT_NE( nullptr, vkExecuteMockCommandBufferEXT );
     }
+
+    void CreateHostVisibleBuffer( VkDeviceSize size, VkBuffer* pBuffer, VkDeviceMemory* pMemory, void** ppData )
+    {
+        VkBufferCreateInfo bufferCreateInfo = {};
+        bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferCreateInfo.size = size;
+        bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+        VkResult result = vkCreateBuffer( device, &bufferCreateInfo, nullptr, pBuffer );
+        ASSERT_EQ( VK_SUCCESS, result );
+
+        VkMemoryAllocateInfo memoryAllocateInfo = {};
+        memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        memoryAllocateInfo.allocationSize = size;
+
+        result = vkAllocateMemory( device, &memoryAllocateInfo, nullptr, pMemory );
+        ASSERT_EQ( VK_SUCCESS, result );
+
+        result = vkBindBufferMemory( device, *pBuffer, *pMemory, 0 );
+        ASSERT_EQ( VK_SUCCESS, result );
+
+        result = vkMapMemory( device, *pMemory, 0, VK_WHOLE_SIZE, 0, ppData );
+        ASSERT_EQ( VK_SUCCESS, result );
+    }
+
+    void CreateImage( const VkImageCreateInfo& createInfo, VkImage* pImage, VkDeviceMemory* pMemory )
+    {
+        VkResult result = vkCreateImage( device, &createInfo, nullptr, pImage );
+        ASSERT_EQ( VK_SUCCESS, result );
+
+        VkMemoryRequirements memoryRequirements = {};
+        vkGetImageMemoryRequirements( device, *pImage, &memoryRequirements );
+
+        VkMemoryAllocateInfo memoryAllocateInfo = {};
+        memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        memoryAllocateInfo.allocationSize = memoryRequirements.size;
+
+        result = vkAllocateMemory( device, &memoryAllocateInfo, nullptr, pMemory );
+        ASSERT_EQ( VK_SUCCESS, result );
+
+        result = vkBindImageMemory( device, *pImage, *pMemory, 0 );
+        ASSERT_EQ( VK_SUCCESS, result );
+    }
+
+    void BeginCommandBuffer( VkCommandPool* pCommandPool, VkCommandBuffer* pCommandBuffer )
+    {
+        VkCommandPoolCreateInfo commandPoolCreateInfo = {};
+        commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        commandPoolCreateInfo.queueFamilyIndex = 0;
+
+        VkResult result = vkCreateCommandPool( device, &commandPoolCreateInfo, nullptr, pCommandPool );
+        ASSERT_EQ( VK_SUCCESS, result );
+
+        VkCommandBufferAllocateInfo commandBufferAllocateInfo = {};
+        commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        commandBufferAllocateInfo.commandPool = *pCommandPool;
+        commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        commandBufferAllocateInfo.commandBufferCount = 1;
+
+        result = vkAllocateCommandBuffers( device, &commandBufferAllocateInfo, pCommandBuffer );
+        ASSERT_EQ( VK_SUCCESS, result );
+
+        VkCommandBufferBeginInfo commandBufferBeginInfo = {};
+        commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+        result = vkBeginCommandBuffer( *pCommandBuffer, &commandBufferBeginInfo );
+        ASSERT_EQ( VK_SUCCESS, result );
+    }
+
+    void SubmitCommandBuffer( VkCommandBuffer commandBuffer )
+    {
+        VkResult result = vkEndCommandBuffer( commandBuffer );
+        ASSERT_EQ( VK_SUCCESS, result );
+
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+
+        result = vkQueueSubmit( queue, 1, &submitInfo, VK_NULL_HANDLE );
+        ASSERT_EQ( VK_SUCCESS, result );
+
+        vkQueueWaitIdle( queue );
+    }
 };
 
 static bool mockDestroyDeviceCalled = false;
@@ -231,6 +324,2809 @@ TEST_F( vk_mock_icd_tests, vkAppendMockCommandEXT )
     EXPECT_TRUE( mockFreeCalled );
 }
 
+TEST_F( vk_mock_icd_tests, vkGetImageSubresourceLayout )
+{
+    CreateInstance();
+    CreateDevice();
+
+    VkImageCreateInfo imageCreateInfo = {};
+    imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.format = VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+    imageCreateInfo.extent = { 100, 60, 1 };
+    imageCreateInfo.mipLevels = 3;
+    imageCreateInfo.arrayLayers = 2;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_LINEAR;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    VkImage image = VK_NULL_HANDLE;
+    VkResult result = vkCreateImage( device, &imageCreateInfo, nullptr, &image );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkMemoryRequirements memoryRequirements = {};
+    vkGetImageMemoryRequirements( device, image, &memoryRequirements );
+    EXPECT_LT( 1, memoryRequirements.alignment );
+    EXPECT_EQ( 0, memoryRequirements.alignment & ( memoryRequirements.alignment - 1 ) );
+
+    VkImageSubresource subresource = {};
+    subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    subresource.mipLevel = 1;
+    subresource.arrayLayer = 1;
+
+    VkSubresourceLayout layout = {};
+    vkGetImageSubresourceLayout( device, image, &subresource, &layout );
+
+    // 50x30 texels are stored in 13x8 blocks of 8 bytes.
+    EXPECT_LE( 13 * 8, layout.rowPitch );
+    EXPECT_LE( 8 * layout.rowPitch, layout.size );
+    EXPECT_LE( layout.arrayPitch, layout.offset );
+    EXPECT_GE( memoryRequirements.size, layout.offset + layout.size );
+
+    vkDestroyImage( device, image, nullptr );
+}
+
+TEST_F( vk_mock_icd_tests, vkGetBufferDeviceAddress )
+{
+    CreateInstance();
+    CreateDevice();
+
+    PFN_vkResolveMockDeviceAddressEXT vkResolveMockDeviceAddressEXT =
+        (PFN_vkResolveMockDeviceAddressEXT)vkGetDeviceProcAddr( device, "vkResolveMockDeviceAddressEXT" );
+    ASSERT_NE( nullptr, vkResolveMockDeviceAddressEXT );
+
+    VkBufferCreateInfo bufferCreateInfo = {};
+    bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferCreateInfo.size = 256 * 1024;
+    bufferCreateInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkResult result = vkCreateBuffer( device, &bufferCreateInfo, nullptr, &buffer );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkMemoryAllocateInfo memoryAllocateInfo = {};
+    memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    memoryAllocateInfo.allocationSize = bufferCreateInfo.size + 256;
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    result = vkAllocateMemory( device, &memoryAllocateInfo, nullptr, &memory );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    result = vkBindBufferMemory( device, buffer, memory, 256 );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkBufferDeviceAddressInfo addressInfo = {};
+    addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+    addressInfo.buffer = buffer;
+
+    VkDeviceAddress address = vkGetBufferDeviceAddress( device, &addressInfo );
+    ASSERT_NE( 0, address );
+    EXPECT_EQ( address, vkGetBufferDeviceAddress( device, &addressInfo ) );
+
+    VkBuffer resolvedBuffer = VK_NULL_HANDLE;
+    VkDeviceSize resolvedOffset = 0;
+    result = vkResolveMockDeviceAddressEXT( device, address + 100000, &resolvedBuffer, &resolvedOffset );
+    ASSERT_EQ( VK_SUCCESS, result );
+    EXPECT_EQ( buffer, resolvedBuffer );
+    EXPECT_EQ( 100000, resolvedOffset );
+
+    // Device addresses point to the mapped memory.
+    void* pData = nullptr;
+    result = vkMapMemory( device, memory, 0, VK_WHOLE_SIZE, 0, &pData );
+    ASSERT_EQ( VK_SUCCESS, result );
+    EXPECT_EQ( static_cast<uint8_t*>( pData ) + 256, reinterpret_cast<uint8_t*>( static_cast<uintptr_t>( address ) ) );
+
+    result = vkResolveMockDeviceAddressEXT( device, address + bufferCreateInfo.size, &resolvedBuffer, &resolvedOffset );
+    EXPECT_EQ( VK_ERROR_INVALID_DEVICE_ADDRESS_EXT, result );
+
+    vkDestroyBuffer( device, buffer, nullptr );
+
+    result = vkResolveMockDeviceAddressEXT( device, address, &resolvedBuffer, &resolvedOffset );
+    EXPECT_EQ( VK_ERROR_INVALID_DEVICE_ADDRESS_EXT, result );
+
+    vkFreeMemory( device, memory, nullptr );
+}
+
+#ifdef VK_KHR_external_memory_fd
+TEST_F( vk_mock_icd_tests, vkGetMemoryFdKHR )
+{
+    CreateInstance();
+    CreateDevice();
+
+    PFN_vkGetMemoryFdKHR vkGetMemoryFdKHR =
+        (PFN_vkGetMemoryFdKHR)vkGetDeviceProcAddr( device, "vkGetMemoryFdKHR" );
+    ASSERT_NE( nullptr, vkGetMemoryFdKHR );
+
+    VkExportMemoryAllocateInfo exportAllocateInfo = {};
+    exportAllocateInfo.sType = VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO;
+    exportAllocateInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
+
+    VkMemoryAllocateInfo memoryAllocateInfo = {};
+    memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    memoryAllocateInfo.pNext = &exportAllocateInfo;
+    memoryAllocateInfo.allocationSize = 64 * 1024;
+
+    VkDeviceMemory exportedMemory = VK_NULL_HANDLE;
+    VkResult result = vkAllocateMemory( device, &memoryAllocateInfo, nullptr, &exportedMemory );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkMemoryGetFdInfoKHR getFdInfo = {};
+    getFdInfo.sType = VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR;
+    getFdInfo.memory = exportedMemory;
+    getFdInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
+
+    int fd = -1;
+    result = vkGetMemoryFdKHR( device, &getFdInfo, &fd );
+    if( result == VK_ERROR_INVALID_EXTERNAL_HANDLE )
+    {
+        vkFreeMemory( device, exportedMemory, nullptr );
+        GTEST_SKIP() << "Exportable memory is not supported on this platform";
+    }
+
+    ASSERT_EQ( VK_SUCCESS, result );
+    ASSERT_LE( 0, fd );
+
+    VkImportMemoryFdInfoKHR importFdInfo = {};
+    importFdInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_FD_INFO_KHR;
+    importFdInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
+    importFdInfo.fd = fd;
+
+    memoryAllocateInfo.pNext = &importFdInfo;
+
+    // Files smaller than the allocation are rejected, and the application keeps the ownership of the fd.
+    VkDeviceMemory importedMemory = VK_NULL_HANDLE;
+    memoryAllocateInfo.allocationSize = 128 * 1024;
+    result = vkAllocateMemory( device, &memoryAllocateInfo, nullptr, &importedMemory );
+    EXPECT_EQ( VK_ERROR_INVALID_EXTERNAL_HANDLE, result );
+
+    memoryAllocateInfo.allocationSize = 64 * 1024;
+    result = vkAllocateMemory( device, &memoryAllocateInfo, nullptr, &importedMemory );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    uint32_t* pExportedData = nullptr;
+    result = vkMapMemory( device, exportedMemory, 0, VK_WHOLE_SIZE, 0, (void**)&pExportedData );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    uint32_t* pImportedData = nullptr;
+    result = vkMapMemory( device, importedMemory, 0, VK_WHOLE_SIZE, 0, (void**)&pImportedData );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    // Both allocations share the same pages.
+    pExportedData[ 1000 ] = 0xC0FFEE;
+    EXPECT_EQ( 0xC0FFEE, pImportedData[ 1000 ] );
+
+    vkFreeMemory( device, importedMemory, nullptr );
+    vkFreeMemory( device, exportedMemory, nullptr );
+}
+#endif
+
+#ifdef VK_EXT_external_memory_host
+TEST_F( vk_mock_icd_tests, vkImportMemoryHostPointerEXT )
+{
+    CreateInstance();
+    CreateDevice();
+
+    VkPhysicalDeviceExternalMemoryHostPropertiesEXT externalMemoryHostProperties = {};
+    externalMemoryHostProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT;
+
+    VkPhysicalDeviceProperties2 properties = {};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &externalMemoryHostProperties;
+    vkGetPhysicalDeviceProperties2( physicalDevice, &properties );
+
+    const VkDeviceSize alignment = externalMemoryHostProperties.minImportedHostPointerAlignment;
+    ASSERT_LT( 0, alignment );
+    ASSERT_EQ( 0, alignment & ( alignment - 1 ) );
+
+    const VkDeviceSize size = 4 * alignment;
+    std::vector<uint8_t> hostMemory( size + alignment );
+    uint8_t* pHostPointer = hostMemory.data() + alignment - ( reinterpret_cast<uintptr_t>( hostMemory.data() ) % alignment );
+    pHostPointer[ 0 ] = 0x5A;
+
+    VkImportMemoryHostPointerInfoEXT importInfo = {};
+    importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT;
+    importInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+    importInfo.pHostPointer = pHostPointer;
+
+    VkMemoryAllocateInfo memoryAllocateInfo = {};
+    memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    memoryAllocateInfo.pNext = &importInfo;
+    memoryAllocateInfo.allocationSize = size;
+
+    // Host pointers cannot be imported as handles of other types.
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    importInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
+    VkResult result = vkAllocateMemory( device, &memoryAllocateInfo, nullptr, &memory );
+    EXPECT_EQ( VK_ERROR_INVALID_EXTERNAL_HANDLE, result );
+
+    importInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+    result = vkAllocateMemory( device, &memoryAllocateInfo, nullptr, &memory );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    // The imported memory is used in-place.
+    void* pData = nullptr;
+    result = vkMapMemory( device, memory, 0, VK_WHOLE_SIZE, 0, &pData );
+    ASSERT_EQ( VK_SUCCESS, result );
+    EXPECT_EQ( pHostPointer, pData );
+
+    vkFreeMemory( device, memory, nullptr );
+
+    // The application still owns the memory after it has been freed.
+    EXPECT_EQ( 0x5A, pHostPointer[ 0 ] );
+}
+#endif
+
+TEST_F( vk_mock_icd_tests, vkGetMockAllocationStatisticsEXT )
+{
+    CreateInstance();
+    CreateDevice();
+
+    PFN_vkGetMockAllocationStatisticsEXT vkGetMockAllocationStatisticsEXT =
+        (PFN_vkGetMockAllocationStatisticsEXT)vkGetDeviceProcAddr( device, "vkGetMockAllocationStatisticsEXT" );
+    ASSERT_NE( nullptr, vkGetMockAllocationStatisticsEXT );
+
+    PFN_vkGetMockObjectStatisticsEXT vkGetMockObjectStatisticsEXT =
+        (PFN_vkGetMockObjectStatisticsEXT)vkGetDeviceProcAddr( device, "vkGetMockObjectStatisticsEXT" );
+    ASSERT_NE( nullptr, vkGetMockObjectStatisticsEXT );
+
+    PFN_vkResetMockAllocationStatisticsEXT vkResetMockAllocationStatisticsEXT =
+        (PFN_vkResetMockAllocationStatisticsEXT)vkGetDeviceProcAddr( device, "vkResetMockAllocationStatisticsEXT" );
+    ASSERT_NE( nullptr, vkResetMockAllocationStatisticsEXT );
+
+    vkResetMockAllocationStatisticsEXT( device );
+
+    VkMockAllocationStatisticsEXT initialStatistics = {};
+    vkGetMockObjectStatisticsEXT( device, VK_OBJECT_TYPE_BUFFER, &initialStatistics );
+    EXPECT_EQ( 0, initialStatistics.totalAllocationCount );
+
+    VkMockAllocationStatisticsEXT deviceStatistics = {};
+    vkGetMockObjectStatisticsEXT( device, VK_OBJECT_TYPE_DEVICE, &deviceStatistics );
+    EXPECT_LE( 1, deviceStatistics.allocationCount );
+
+    VkBufferCreateInfo bufferCreateInfo = {};
+    bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferCreateInfo.size = 1024;
+    bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+    VkBuffer buffers[ 2 ] = {};
+    for( VkBuffer& buffer : buffers )
+    {
+        VkResult result = vkCreateBuffer( device, &bufferCreateInfo, nullptr, &buffer );
+        ASSERT_EQ( VK_SUCCESS, result );
+    }
+
+    VkMockAllocationStatisticsEXT statistics = {};
+    vkGetMockObjectStatisticsEXT( device, VK_OBJECT_TYPE_BUFFER, &statistics );
+    EXPECT_EQ( initialStatistics.allocationCount + 2, statistics.allocationCount );
+    EXPECT_LT( initialStatistics.allocationSize, statistics.allocationSize );
+    EXPECT_EQ( 2, statistics.totalAllocationCount );
+
+    VkMockAllocationStatisticsEXT objectScopeStatistics = {};
+    vkGetMockAllocationStatisticsEXT( device, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT, &objectScopeStatistics );
+    EXPECT_LE( 2, objectScopeStatistics.totalAllocationCount );
+
+    for( VkBuffer buffer : buffers )
+    {
+        vkDestroyBuffer( device, buffer, nullptr );
+    }
+
+    vkGetMockObjectStatisticsEXT( device, VK_OBJECT_TYPE_BUFFER, &statistics );
+    EXPECT_EQ( initialStatistics.allocationCount, statistics.allocationCount );
+    EXPECT_EQ( initialStatistics.allocationSize, statistics.allocationSize );
+    EXPECT_EQ( initialStatistics.allocationCount + 2, statistics.peakAllocationCount );
+}
+
+TEST_F( vk_mock_icd_tests, vkCreateBufferChurn )
+{
+    CreateInstance();
+    CreateDevice();
+
+    VkBufferCreateInfo bufferCreateInfo = {};
+    bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+    std::vector<VkBuffer> buffers( 1000 );
+    for( uint32_t iteration = 0; iteration < 10; ++iteration )
+    {
+        for( size_t i = 0; i < buffers.size(); ++i )
+        {
+            bufferCreateInfo.size = 16 * ( i + 1 );
+
+            VkResult result = vkCreateBuffer( device, &bufferCreateInfo, nullptr, &buffers[ i ] );
+            ASSERT_EQ( VK_SUCCESS, result );
+        }
+
+        // Recycled objects must not alias live ones.
+        for( size_t i = 0; i < buffers.size(); ++i )
+        {
+            VkMemoryRequirements memoryRequirements = {};
+            vkGetBufferMemoryRequirements( device, buffers[ i ], &memoryRequirements );
+            EXPECT_EQ( 16 * ( i + 1 ), memoryRequirements.size );
+        }
+
+        for( VkBuffer buffer : buffers )
+        {
+            vkDestroyBuffer( device, buffer, nullptr );
+        }
+    }
+}
+
+TEST_F( vk_mock_icd_tests, vkCmdFillBuffer )
+{
+    CreateInstance();
+    CreateDevice();
+
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    void* pData = nullptr;
+    CreateHostVisibleBuffer( 1024 * 1024 + 6, &buffer, &memory, &pData );
+    memset( pData, 0, 1024 * 1024 + 6 );
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    BeginCommandBuffer( &commandPool, &commandBuffer );
+
+    // Unaligned offset and the rounding of VK_WHOLE_SIZE.
+    vkCmdFillBuffer( commandBuffer, buffer, 0, VK_WHOLE_SIZE, 0x11111111 );
+    vkCmdFillBuffer( commandBuffer, buffer, 12, 4 * 1000, 0xdeadbeef );
+
+    std::vector<uint32_t> update( 4000 );
+    for( uint32_t i = 0; i < update.size(); ++i )
+    {
+        update[ i ] = i;
+    }
+
+    vkCmdUpdateBuffer( commandBuffer, buffer, 8192, update.size() * sizeof( uint32_t ), update.data() );
+
+    // The update data is copied at record time.
+    update.assign( update.size(), 0 );
+
+    SubmitCommandBuffer( commandBuffer );
+
+    const uint32_t* pWords = static_cast<const uint32_t*>( pData );
+    const uint8_t* pBytes = static_cast<const uint8_t*>( pData );
+    EXPECT_EQ( 0x11111111, pWords[ 0 ] );
+    EXPECT_EQ( 0x11111111, pWords[ 2 ] );
+    EXPECT_EQ( 0xdeadbeef, pWords[ 3 ] );
+    EXPECT_EQ( 0xdeadbeef, pWords[ 1002 ] );
+    EXPECT_EQ( 0x11111111, pWords[ 1003 ] );
+    EXPECT_EQ( 0, pWords[ 2048 ] );
+    EXPECT_EQ( 3999, pWords[ 2048 + 3999 ] );
+    EXPECT_EQ( 0x11111111, pWords[ 2048 + 4000 ] );
+    EXPECT_EQ( 0x11111111, pWords[ 1024 * 1024 / 4 - 1 ] );
+    EXPECT_EQ( 0, pBytes[ 1024 * 1024 + 4 ] );
+
+    vkDestroyCommandPool( device, commandPool, nullptr );
+    vkDestroyBuffer( device, buffer, nullptr );
+    vkFreeMemory( device, memory, nullptr );
+}
+
+TEST_F( vk_mock_icd_tests, vkCmdCopyBufferLarge )
+{
+    CreateInstance();
+    CreateDevice();
+
+    // Large enough to be split into multiple chunks copied in parallel.
+    const VkDeviceSize size = 40 * 1024 * 1024 + 12;
+
+    VkBuffer srcBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory srcMemory = VK_NULL_HANDLE;
+    void* pSrcData = nullptr;
+    CreateHostVisibleBuffer( size, &srcBuffer, &srcMemory, &pSrcData );
+
+    VkBuffer dstBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory dstMemory = VK_NULL_HANDLE;
+    void* pDstData = nullptr;
+    CreateHostVisibleBuffer( size, &dstBuffer, &dstMemory, &pDstData );
+
+    uint32_t* pSrcWords = static_cast<uint32_t*>( pSrcData );
+    for( uint32_t i = 0; i < size / 4; ++i )
+    {
+        pSrcWords[ i ] = i * 2654435761u;
+    }
+
+    memset( pDstData, 0, size );
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    BeginCommandBuffer( &commandPool, &commandBuffer );
+
+    VkBufferCopy regions[ 2 ] = {};
+    regions[ 0 ].srcOffset = 4;
+    regions[ 0 ].dstOffset = 0;
+    regions[ 0 ].size = size - 4;
+    // Copy between disjoint ranges of the same buffer.
+    regions[ 1 ].srcOffset = 0;
+    regions[ 1 ].dstOffset = 24 * 1024 * 1024;
+    regions[ 1 ].size = 16 * 1024 * 1024;
+
+    vkCmdCopyBuffer( commandBuffer, srcBuffer, dstBuffer, 1, &regions[ 0 ] );
+    vkCmdCopyBuffer( commandBuffer, srcBuffer, srcBuffer, 1, &regions[ 1 ] );
+
+    SubmitCommandBuffer( commandBuffer );
+
+    const uint32_t* pDstWords = static_cast<const uint32_t*>( pDstData );
+    for( uint32_t i = 0; i < size / 4 - 1; ++i )
+    {
+        ASSERT_EQ( ( i + 1 ) * 2654435761u, pDstWords[ i ] );
+    }
+
+    for( uint32_t i = 0; i < 16 * 1024 * 1024 / 4; i += 4099 )
+    {
+        ASSERT_EQ( i * 2654435761u, pSrcWords[ 6 * 1024 * 1024 + i ] );
+    }
+
+    vkDestroyCommandPool( device, commandPool, nullptr );
+    vkDestroyBuffer( device, srcBuffer, nullptr );
+    vkDestroyBuffer( device, dstBuffer, nullptr );
+    vkFreeMemory( device, srcMemory, nullptr );
+    vkFreeMemory( device, dstMemory, nullptr );
+}
+
+TEST( vk_mock_memory_ops_tests, vk_copy_memory_overlapping )
+{
+    const size_t size = 2 * vkmock::g_NonTemporalThreshold + 12;
+    const size_t shift = 4 * 1024 + 4;
+
+    std::vector<uint8_t> buffer( size + shift );
+    for( size_t i = 0; i < buffer.size(); ++i )
+    {
+        buffer[ i ] = static_cast<uint8_t>( i * 31 + i / 251 );
+    }
+
+    const std::vector<uint8_t> original = buffer;
+    std::vector<uint8_t> expected = buffer;
+
+    // Forward copy, the destination starts inside the source.
+    memmove( expected.data() + shift, expected.data(), size );
+    vkmock::vk_copy_memory( buffer.data() + shift, buffer.data(), size );
+    ASSERT_TRUE( buffer == expected );
+
+    buffer = original;
+    expected = original;
+
+    // Backward copy, the source starts inside the destination.
+    memmove( expected.data(), expected.data() + shift, size );
+    vkmock::vk_copy_memory( buffer.data(), buffer.data() + shift, size );
+    ASSERT_TRUE( buffer == expected );
+}
+
+TEST_F( vk_mock_icd_tests, vkCmdCopyBufferToImage )
+{
+    CreateInstance();
+    CreateDevice();
+
+    // 64x32 BC1 texels are stored in 16x8 blocks of 8 bytes, the buffer rows are padded to 80 texels.
+    const uint32_t blocksX = 16, blocksY = 8, rowBlocks = 20, layers = 2;
+
+    VkBuffer srcBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory srcMemory = VK_NULL_HANDLE;
+    void* pSrcData = nullptr;
+    CreateHostVisibleBuffer( rowBlocks * blocksY * layers * 8, &srcBuffer, &srcMemory, &pSrcData );
+
+    uint64_t* pSrcBlocks = static_cast<uint64_t*>( pSrcData );
+    for( uint32_t i = 0; i < rowBlocks * blocksY * layers; ++i )
+    {
+        pSrcBlocks[ i ] = 0x0123456789abcdefull * ( i + 1 );
+    }
+
+    VkBuffer dstBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory dstMemory = VK_NULL_HANDLE;
+    void* pDstData = nullptr;
+    CreateHostVisibleBuffer( blocksX * blocksY * layers * 8, &dstBuffer, &dstMemory, &pDstData );
+    memset( pDstData, 0, blocksX * blocksY * layers * 8 );
+
+    VkImageCreateInfo imageCreateInfo = {};
+    imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.format = VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+    imageCreateInfo.extent = { blocksX * 4, blocksY * 4, 1 };
+    imageCreateInfo.mipLevels = 1;
+    imageCreateInfo.arrayLayers = layers;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    VkImage compressedImage = VK_NULL_HANDLE;
+    VkDeviceMemory compressedMemory = VK_NULL_HANDLE;
+    CreateImage( imageCreateInfo, &compressedImage, &compressedMemory );
+
+    // Uncompressed format with the same block size.
+    imageCreateInfo.format = VK_FORMAT_R32G32_UINT;
+    imageCreateInfo.extent = { blocksX, blocksY, 1 };
+
+    VkImage uncompressedImage = VK_NULL_HANDLE;
+    VkDeviceMemory uncompressedMemory = VK_NULL_HANDLE;
+    CreateImage( imageCreateInfo, &uncompressedImage, &uncompressedMemory );
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    BeginCommandBuffer( &commandPool, &commandBuffer );
+
+    VkBufferImageCopy bufferImageCopy = {};
+    bufferImageCopy.bufferRowLength = rowBlocks * 4;
+    bufferImageCopy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, layers };
+    bufferImageCopy.imageExtent = { blocksX * 4, blocksY * 4, 1 };
+    vkCmdCopyBufferToImage( commandBuffer, srcBuffer, compressedImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopy );
+
+    VkImageCopy imageCopy = {};
+    imageCopy.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, layers };
+    imageCopy.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, layers };
+    imageCopy.extent = { blocksX * 4, blocksY * 4, 1 };
+    vkCmdCopyImage( commandBuffer,
+        compressedImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        uncompressedImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1, &imageCopy );
+
+    bufferImageCopy.bufferRowLength = 0;
+    bufferImageCopy.imageExtent = { blocksX, blocksY, 1 };
+    vkCmdCopyImageToBuffer( commandBuffer, uncompressedImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dstBuffer, 1, &bufferImageCopy );
+
+    SubmitCommandBuffer( commandBuffer );
+
+    const uint64_t* pDstBlocks = static_cast<const uint64_t*>( pDstData );
+    for( uint32_t layer = 0; layer < layers; ++layer )
+    {
+        for( uint32_t y = 0; y < blocksY; ++y )
+        {
+            for( uint32_t x = 0; x < blocksX; ++x )
+            {
+                ASSERT_EQ( pSrcBlocks[ ( layer * blocksY + y ) * rowBlocks + x ],
+                    pDstBlocks[ ( layer * blocksY + y ) * blocksX + x ] );
+            }
+        }
+    }
+
+    vkDestroyCommandPool( device, commandPool, nullptr );
+    vkDestroyImage( device, compressedImage, nullptr );
+    vkDestroyImage( device, uncompressedImage, nullptr );
+    vkDestroyBuffer( device, srcBuffer, nullptr );
+    vkDestroyBuffer( device, dstBuffer, nullptr );
+    vkFreeMemory( device, compressedMemory, nullptr );
+    vkFreeMemory( device, uncompressedMemory, nullptr );
+    vkFreeMemory( device, srcMemory, nullptr );
+    vkFreeMemory( device, dstMemory, nullptr );
+}
+
+TEST_F( vk_mock_icd_tests, vkCmdClearImage )
+{
+    CreateInstance();
+    CreateDevice();
+
+    // 3-byte texels do not divide the vector size, so the pattern is not aligned with the rows.
+    const uint32_t width = 37, height = 5, layers = 2;
+
+    VkBuffer colorBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory colorBufferMemory = VK_NULL_HANDLE;
+    void* pColorData = nullptr;
+    CreateHostVisibleBuffer( width * height * layers * 3, &colorBuffer, &colorBufferMemory, &pColorData );
+    memset( pColorData, 0, width * height * layers * 3 );
+
+    VkBuffer depthBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory depthBufferMemory = VK_NULL_HANDLE;
+    void* pDepthData = nullptr;
+    CreateHostVisibleBuffer( width * height * 4, &depthBuffer, &depthBufferMemory, &pDepthData );
+    memset( pDepthData, 0, width * height * 4 );
+
+    VkBuffer stencilBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory stencilBufferMemory = VK_NULL_HANDLE;
+    void* pStencilData = nullptr;
+    CreateHostVisibleBuffer( width * height, &stencilBuffer, &stencilBufferMemory, &pStencilData );
+    memset( pStencilData, 0, width * height );
+
+    VkImageCreateInfo imageCreateInfo = {};
+    imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.format = VK_FORMAT_R8G8B8_UNORM;
+    imageCreateInfo.extent = { width, height, 1 };
+    imageCreateInfo.mipLevels = 1;
+    imageCreateInfo.arrayLayers = layers;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    VkImage colorImage = VK_NULL_HANDLE;
+    VkDeviceMemory colorImageMemory = VK_NULL_HANDLE;
+    CreateImage( imageCreateInfo, &colorImage, &colorImageMemory );
+
+    imageCreateInfo.format = VK_FORMAT_D24_UNORM_S8_UINT;
+    imageCreateInfo.arrayLayers = 1;
+
+    VkImage depthImage = VK_NULL_HANDLE;
+    VkDeviceMemory depthImageMemory = VK_NULL_HANDLE;
+    CreateImage( imageCreateInfo, &depthImage, &depthImageMemory );
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    BeginCommandBuffer( &commandPool, &commandBuffer );
+
+    VkClearColorValue color = {};
+    color.float32[ 0 ] = 1.0f;
+    color.float32[ 1 ] = 0.2f;
+    color.float32[ 2 ] = 0.0f;
+
+    VkImageSubresourceRange colorRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+    vkCmdClearColorImage( commandBuffer, colorImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &color, 1, &colorRange );
+
+    VkClearDepthStencilValue depthStencil = { 1.0f, 0x5a };
+    VkImageSubresourceRange depthStencilRange = { VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT, 0, 1, 0, 1 };
+    vkCmdClearDepthStencilImage( commandBuffer, depthImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &depthStencil, 1, &depthStencilRange );
+
+    VkBufferImageCopy bufferImageCopy = {};
+    bufferImageCopy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, layers };
+    bufferImageCopy.imageExtent = { width, height, 1 };
+    vkCmdCopyImageToBuffer( commandBuffer, colorImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, colorBuffer, 1, &bufferImageCopy );
+
+    bufferImageCopy.imageSubresource = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 0, 1 };
+    vkCmdCopyImageToBuffer( commandBuffer, depthImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, depthBuffer, 1, &bufferImageCopy );
+
+    bufferImageCopy.imageSubresource = { VK_IMAGE_ASPECT_STENCIL_BIT, 0, 0, 1 };
+    vkCmdCopyImageToBuffer( commandBuffer, depthImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, stencilBuffer, 1, &bufferImageCopy );
+
+    SubmitCommandBuffer( commandBuffer );
+
+    const uint8_t* pColorTexels = static_cast<const uint8_t*>( pColorData );
+    for( uint32_t i = 0; i < width * height * layers; ++i )
+    {
+        ASSERT_EQ( 255, pColorTexels[ i * 3 + 0 ] );
+        ASSERT_EQ( 51, pColorTexels[ i * 3 + 1 ] );
+        ASSERT_EQ( 0, pColorTexels[ i * 3 + 2 ] );
+    }
+
+    const uint32_t* pDepthTexels = static_cast<const uint32_t*>( pDepthData );
+    const uint8_t* pStencilTexels = static_cast<const uint8_t*>( pStencilData );
+    for( uint32_t i = 0; i < width * height; ++i )
+    {
+        ASSERT_EQ( 0x00ffffffu, pDepthTexels[ i ] );
+        ASSERT_EQ( 0x5a, pStencilTexels[ i ] );
+    }
+
+    vkDestroyCommandPool( device, commandPool, nullptr );
+    vkDestroyImage( device, colorImage, nullptr );
+    vkDestroyImage( device, depthImage, nullptr );
+    vkDestroyBuffer( device, colorBuffer, nullptr );
+    vkDestroyBuffer( device, depthBuffer, nullptr );
+    vkDestroyBuffer( device, stencilBuffer, nullptr );
+    vkFreeMemory( device, colorImageMemory, nullptr );
+    vkFreeMemory( device, depthImageMemory, nullptr );
+    vkFreeMemory( device, colorBufferMemory, nullptr );
+    vkFreeMemory( device, depthBufferMemory, nullptr );
+    vkFreeMemory( device, stencilBufferMemory, nullptr );
+}
+
+TEST_F( vk_mock_icd_tests, vkCmdBlitImage )
+{
+    CreateInstance();
+    CreateDevice();
+
+    const uint32_t size = 16;
+
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory bufferMemory = VK_NULL_HANDLE;
+    void* pData = nullptr;
+    CreateHostVisibleBuffer( size * size * 4, &buffer, &bufferMemory, &pData );
+
+    uint8_t* pTexels = static_cast<uint8_t*>( pData );
+    for( uint32_t i = 0; i < size * size * 4; ++i )
+    {
+        pTexels[ i ] = uint8_t( i * 7 + ( i >> 6 ) );
+    }
+
+    std::vector<uint8_t> texels( pTexels, pTexels + size * size * 4 );
+
+    VkImageCreateInfo imageCreateInfo = {};
+    imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    imageCreateInfo.extent = { size, size, 1 };
+    imageCreateInfo.mipLevels = 2;
+    imageCreateInfo.arrayLayers = 1;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    VkImage mipImage = VK_NULL_HANDLE;
+    VkDeviceMemory mipImageMemory = VK_NULL_HANDLE;
+    CreateImage( imageCreateInfo, &mipImage, &mipImageMemory );
+
+    // 2x1 source and 4x2 destination of float texels.
+    imageCreateInfo.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+    imageCreateInfo.extent = { 2, 1, 1 };
+    imageCreateInfo.mipLevels = 1;
+
+    VkImage floatSrcImage = VK_NULL_HANDLE;
+    VkDeviceMemory floatSrcImageMemory = VK_NULL_HANDLE;
+    CreateImage( imageCreateInfo, &floatSrcImage, &floatSrcImageMemory );
+
+    imageCreateInfo.extent = { 4, 2, 1 };
+
+    VkImage floatDstImage = VK_NULL_HANDLE;
+    VkDeviceMemory floatDstImageMemory = VK_NULL_HANDLE;
+    CreateImage( imageCreateInfo, &floatDstImage, &floatDstImageMemory );
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    BeginCommandBuffer( &commandPool, &commandBuffer );
+
+    VkBufferImageCopy bufferImageCopy = {};
+    bufferImageCopy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    bufferImageCopy.imageExtent = { size, size, 1 };
+    vkCmdCopyBufferToImage( commandBuffer, buffer, mipImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopy );
+
+    VkImageBlit blit = {};
+    blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    blit.srcOffsets[ 1 ] = { int32_t( size ), int32_t( size ), 1 };
+    blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1 };
+    blit.dstOffsets[ 1 ] = { int32_t( size / 2 ), int32_t( size / 2 ), 1 };
+    vkCmdBlitImage( commandBuffer,
+        mipImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        mipImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1, &blit, VK_FILTER_LINEAR );
+
+    // Write the float texels with an update of the buffer and a copy.
+    const float floatTexels[ 8 ] = { 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 2.0f, 4.0f, 8.0f };
+    vkCmdUpdateBuffer( commandBuffer, buffer, size * size * 4 - sizeof( floatTexels ), sizeof( floatTexels ), floatTexels );
+
+    bufferImageCopy.bufferOffset = size * size * 4 - sizeof( floatTexels );
+    bufferImageCopy.imageExtent = { 2, 1, 1 };
+    vkCmdCopyBufferToImage( commandBuffer, buffer, floatSrcImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopy );
+
+    // Linear magnification to the first row, mirrored nearest magnification to the second row.
+    blit.srcOffsets[ 1 ] = { 2, 1, 1 };
+    blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    blit.dstOffsets[ 1 ] = { 4, 1, 1 };
+    vkCmdBlitImage( commandBuffer,
+        floatSrcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        floatDstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1, &blit, VK_FILTER_LINEAR );
+
+    blit.dstOffsets[ 0 ] = { 4, 1, 0 };
+    blit.dstOffsets[ 1 ] = { 0, 2, 1 };
+    vkCmdBlitImage( commandBuffer,
+        floatSrcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        floatDstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1, &blit, VK_FILTER_NEAREST );
+
+    bufferImageCopy.bufferOffset = 0;
+    bufferImageCopy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1 };
+    bufferImageCopy.imageExtent = { size / 2, size / 2, 1 };
+    vkCmdCopyImageToBuffer( commandBuffer, mipImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &bufferImageCopy );
+
+    bufferImageCopy.bufferOffset = size * size;
+    bufferImageCopy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    bufferImageCopy.imageExtent = { 4, 2, 1 };
+    vkCmdCopyImageToBuffer( commandBuffer, floatDstImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &bufferImageCopy );
+
+    SubmitCommandBuffer( commandBuffer );
+
+    // Each texel of the second mip level is the rounded average of 2x2 texels.
+    for( uint32_t y = 0; y < size / 2; ++y )
+    {
+        for( uint32_t x = 0; x < size / 2; ++x )
+        {
+            for( uint32_t c = 0; c < 4; ++c )
+            {
+                const uint32_t sum =
+                    texels[ ( ( y * 2 + 0 ) * size + x * 2 + 0 ) * 4 + c ] +
+                    texels[ ( ( y * 2 + 0 ) * size + x * 2 + 1 ) * 4 + c ] +
+                    texels[ ( ( y * 2 + 1 ) * size + x * 2 + 0 ) * 4 + c ] +
+                    texels[ ( ( y * 2 + 1 ) * size + x * 2 + 1 ) * 4 + c ];
+
+                ASSERT_EQ( ( sum + 2 ) / 4, pTexels[ ( y * ( size / 2 ) + x ) * 4 + c ] );
+            }
+        }
+    }
+
+    const float expectedTexels[ 8 ] = { 0.0f, 0.25f, 0.75f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f };
+
+    const float* pFloatTexels = reinterpret_cast<const float*>( pTexels + size * size );
+    for( uint32_t i = 0; i < 8; ++i )
+    {
+        ASSERT_FLOAT_EQ( expectedTexels[ i ], pFloatTexels[ i * 4 + 0 ] );
+        ASSERT_FLOAT_EQ( expectedTexels[ i ] * 8.0f, pFloatTexels[ i * 4 + 3 ] );
+    }
+
+    vkDestroyCommandPool( device, commandPool, nullptr );
+    vkDestroyImage( device, mipImage, nullptr );
+    vkDestroyImage( device, floatSrcImage, nullptr );
+    vkDestroyImage( device, floatDstImage, nullptr );
+    vkDestroyBuffer( device, buffer, nullptr );
+    vkFreeMemory( device, mipImageMemory, nullptr );
+    vkFreeMemory( device, floatSrcImageMemory, nullptr );
+    vkFreeMemory( device, floatDstImageMemory, nullptr );
+    vkFreeMemory( device, bufferMemory, nullptr );
+}
+
+TEST_F( vk_mock_icd_tests, vkCmdResolveImage )
+{
+    CreateInstance();
+    CreateDevice();
+
+    // Rows of 64 texels are not padded, so the memory requirements grow with the sample count.
+    const uint32_t width = 64, height = 4, samples = 4;
+
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory bufferMemory = VK_NULL_HANDLE;
+    void* pData = nullptr;
+    CreateHostVisibleBuffer( width * height * samples * 4, &buffer, &bufferMemory, &pData );
+
+    uint8_t* pBytes = static_cast<uint8_t*>( pData );
+    for( uint32_t i = 0; i < width * height * samples * 4; ++i )
+    {
+        pBytes[ i ] = uint8_t( i * 13 + ( i >> 4 ) );
+    }
+
+    std::vector<uint8_t> sampleData( pBytes, pBytes + width * height * samples * 4 );
+
+    VkImageCreateInfo imageCreateInfo = {};
+    imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    imageCreateInfo.extent = { width, height, 1 };
+    imageCreateInfo.mipLevels = 1;
+    imageCreateInfo.arrayLayers = 1;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
+    VkImage resolveImage = VK_NULL_HANDLE;
+    VkDeviceMemory resolveImageMemory = VK_NULL_HANDLE;
+    CreateImage( imageCreateInfo, &resolveImage, &resolveImageMemory );
+
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_4_BIT;
+
+    VkImage msaaImage = VK_NULL_HANDLE;
+    VkDeviceMemory msaaImageMemory = VK_NULL_HANDLE;
+    CreateImage( imageCreateInfo, &msaaImage, &msaaImageMemory );
+
+    // Memory requirements include all samples.
+    VkMemoryRequirements resolveMemoryRequirements = {};
+    vkGetImageMemoryRequirements( device, resolveImage, &resolveMemoryRequirements );
+
+    VkMemoryRequirements msaaMemoryRequirements = {};
+    vkGetImageMemoryRequirements( device, msaaImage, &msaaMemoryRequirements );
+
+    ASSERT_GE( msaaMemoryRequirements.size, resolveMemoryRequirements.size * samples );
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    BeginCommandBuffer( &commandPool, &commandBuffer );
+
+    // Samples of each texel are stored next to each other, write them directly.
+    VkBufferImageCopy bufferImageCopy = {};
+    bufferImageCopy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    bufferImageCopy.imageExtent = { width, height, 1 };
+    vkCmdCopyBufferToImage( commandBuffer, buffer, msaaImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopy );
+
+    VkImageResolve resolve = {};
+    resolve.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    resolve.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    resolve.extent = { width, height, 1 };
+    vkCmdResolveImage( commandBuffer,
+        msaaImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        resolveImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1, &resolve );
+
+    vkCmdCopyImageToBuffer( commandBuffer, resolveImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &bufferImageCopy );
+
+    SubmitCommandBuffer( commandBuffer );
+
+    for( uint32_t texel = 0; texel < width * height; ++texel )
+    {
+        for( uint32_t c = 0; c < 4; ++c )
+        {
+            uint32_t sum = 0;
+            for( uint32_t sample = 0; sample < samples; ++sample )
+            {
+                sum += sampleData[ ( texel * samples + sample ) * 4 + c ];
+            }
+
+            ASSERT_EQ( ( sum + samples / 2 ) / samples, pBytes[ texel * 4 + c ] );
+        }
+    }
+
+    vkDestroyCommandPool( device, commandPool, nullptr );
+    vkDestroyImage( device, msaaImage, nullptr );
+    vkDestroyImage( device, resolveImage, nullptr );
+    vkDestroyBuffer( device, buffer, nullptr );
+    vkFreeMemory( device, msaaImageMemory, nullptr );
+    vkFreeMemory( device, resolveImageMemory, nullptr );
+    vkFreeMemory( device, bufferMemory, nullptr );
+}
+
+TEST_F( vk_mock_icd_tests, vkCopyMemoryToImageEXT )
+{
+    CreateInstance();
+    CreateDevice();
+
+    PFN_vkCopyMemoryToImageEXT vkCopyMemoryToImageEXT =
+        (PFN_vkCopyMemoryToImageEXT)vkGetDeviceProcAddr( device, "vkCopyMemoryToImageEXT" );
+    ASSERT_NE( nullptr, vkCopyMemoryToImageEXT );
+
+    PFN_vkCopyImageToMemoryEXT vkCopyImageToMemoryEXT =
+        (PFN_vkCopyImageToMemoryEXT)vkGetDeviceProcAddr( device, "vkCopyImageToMemoryEXT" );
+    ASSERT_NE( nullptr, vkCopyImageToMemoryEXT );
+
+    PFN_vkCopyImageToImageEXT vkCopyImageToImageEXT =
+        (PFN_vkCopyImageToImageEXT)vkGetDeviceProcAddr( device, "vkCopyImageToImageEXT" );
+    ASSERT_NE( nullptr, vkCopyImageToImageEXT );
+
+    PFN_vkSetMockImageSwizzleEXT vkSetMockImageSwizzleEXT =
+        (PFN_vkSetMockImageSwizzleEXT)vkGetDeviceProcAddr( device, "vkSetMockImageSwizzleEXT" );
+    ASSERT_NE( nullptr, vkSetMockImageSwizzleEXT );
+
+    const uint32_t width = 37, height = 19, rowLength = 40;
+
+    std::vector<uint32_t> texels( rowLength * height );
+    for( uint32_t i = 0; i < rowLength * height; ++i )
+    {
+        texels[ i ] = i * 2654435761u;
+    }
+
+    VkImageCreateInfo imageCreateInfo = {};
+    imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    imageCreateInfo.extent = { width, height, 1 };
+    imageCreateInfo.mipLevels = 1;
+    imageCreateInfo.arrayLayers = 1;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT;
+
+    VkImage linearImage = VK_NULL_HANDLE;
+    VkDeviceMemory linearImageMemory = VK_NULL_HANDLE;
+    CreateImage( imageCreateInfo, &linearImage, &linearImageMemory );
+
+    vkSetMockImageSwizzleEXT( device, VK_MOCK_IMAGE_SWIZZLE_MORTON_EXT );
+
+    VkImage swizzledImage = VK_NULL_HANDLE;
+    VkDeviceMemory swizzledImageMemory = VK_NULL_HANDLE;
+    CreateImage( imageCreateInfo, &swizzledImage, &swizzledImageMemory );
+
+    // Upload a region that does not start or end at the tile boundaries.
+    VkMemoryToImageCopyEXT memoryToImageCopy = {};
+    memoryToImageCopy.sType = VK_STRUCTURE_TYPE_MEMORY_TO_IMAGE_COPY_EXT;
+    memoryToImageCopy.pHostPointer = texels.data();
+    memoryToImageCopy.memoryRowLength = rowLength;
+    memoryToImageCopy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    memoryToImageCopy.imageOffset = { 3, 5, 0 };
+    memoryToImageCopy.imageExtent = { 30, 12, 1 };
+
+    VkCopyMemoryToImageInfoEXT copyMemoryToImageInfo = {};
+    copyMemoryToImageInfo.sType = VK_STRUCTURE_TYPE_COPY_MEMORY_TO_IMAGE_INFO_EXT;
+    copyMemoryToImageInfo.dstImage = swizzledImage;
+    copyMemoryToImageInfo.dstImageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    copyMemoryToImageInfo.regionCount = 1;
+    copyMemoryToImageInfo.pRegions = &memoryToImageCopy;
+    ASSERT_EQ( VK_SUCCESS, vkCopyMemoryToImageEXT( device, &copyMemoryToImageInfo ) );
+
+    // Reorder the texels into the image with the linear layout.
+    VkImageCopy2 imageCopy = {};
+    imageCopy.sType = VK_STRUCTURE_TYPE_IMAGE_COPY_2;
+    imageCopy.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    imageCopy.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    imageCopy.extent = { width, height, 1 };
+
+    VkCopyImageToImageInfoEXT copyImageToImageInfo = {};
+    copyImageToImageInfo.sType = VK_STRUCTURE_TYPE_COPY_IMAGE_TO_IMAGE_INFO_EXT;
+    copyImageToImageInfo.srcImage = swizzledImage;
+    copyImageToImageInfo.srcImageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    copyImageToImageInfo.dstImage = linearImage;
+    copyImageToImageInfo.dstImageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    copyImageToImageInfo.regionCount = 1;
+    copyImageToImageInfo.pRegions = &imageCopy;
+    ASSERT_EQ( VK_SUCCESS, vkCopyImageToImageEXT( device, &copyImageToImageInfo ) );
+
+    std::vector<uint32_t> linearTexels( width * height );
+
+    VkImageToMemoryCopyEXT imageToMemoryCopy = {};
+    imageToMemoryCopy.sType = VK_STRUCTURE_TYPE_IMAGE_TO_MEMORY_COPY_EXT;
+    imageToMemoryCopy.pHostPointer = linearTexels.data();
+    imageToMemoryCopy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    imageToMemoryCopy.imageExtent = { width, height, 1 };
+
+    VkCopyImageToMemoryInfoEXT copyImageToMemoryInfo = {};
+    copyImageToMemoryInfo.sType = VK_STRUCTURE_TYPE_COPY_IMAGE_TO_MEMORY_INFO_EXT;
+    copyImageToMemoryInfo.srcImage = linearImage;
+    copyImageToMemoryInfo.srcImageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    copyImageToMemoryInfo.regionCount = 1;
+    copyImageToMemoryInfo.pRegions = &imageToMemoryCopy;
+    ASSERT_EQ( VK_SUCCESS, vkCopyImageToMemoryEXT( device, &copyImageToMemoryInfo ) );
+
+    for( uint32_t y = 0; y < 12; ++y )
+    {
+        for( uint32_t x = 0; x < 30; ++x )
+        {
+            ASSERT_EQ( texels[ y * rowLength + x ], linearTexels[ ( y + 5 ) * width + x + 3 ] );
+        }
+    }
+
+    // The internal layout of the swizzled image stores the tiles of 8x8 texels in Morton order.
+    VkSubresourceLayout layout = {};
+    VkImageSubresource subresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0 };
+    vkGetImageSubresourceLayout( device, swizzledImage, &subresource, &layout );
+
+    std::vector<uint32_t> swizzledTexels( layout.size / 4 );
+    imageToMemoryCopy.pHostPointer = swizzledTexels.data();
+    copyImageToMemoryInfo.flags = VK_HOST_IMAGE_COPY_MEMCPY_EXT;
+    copyImageToMemoryInfo.srcImage = swizzledImage;
+    ASSERT_EQ( VK_SUCCESS, vkCopyImageToMemoryEXT( device, &copyImageToMemoryInfo ) );
+
+    const uint32_t tileTexelsPerRow = uint32_t( layout.rowPitch / 4 ) * 8;
+    ASSERT_EQ( texels[ 0 ], swizzledTexels[ 0 * tileTexelsPerRow + 0 * 64 + 39 ] ); // (3, 5) -> (3, 5) in tile (0, 0)
+    ASSERT_EQ( texels[ 5 ], swizzledTexels[ 0 * tileTexelsPerRow + 1 * 64 + 34 ] ); // (8, 5) -> (0, 5) in tile (1, 0)
+    ASSERT_EQ( texels[ 3 * rowLength + 5 ], swizzledTexels[ 1 * tileTexelsPerRow + 1 * 64 + 0 ] ); // (8, 8) -> (0, 0) in tile (1, 1)
+
+    // Round-trip through the swizzled image.
+    std::vector<uint32_t> roundTripTexels( rowLength * height );
+    imageToMemoryCopy.pHostPointer = roundTripTexels.data();
+    imageToMemoryCopy.memoryRowLength = rowLength;
+    imageToMemoryCopy.imageOffset = memoryToImageCopy.imageOffset;
+    imageToMemoryCopy.imageExtent = memoryToImageCopy.imageExtent;
+    copyImageToMemoryInfo.flags = 0;
+    ASSERT_EQ( VK_SUCCESS, vkCopyImageToMemoryEXT( device, &copyImageToMemoryInfo ) );
+
+    for( uint32_t y = 0; y < 12; ++y )
+    {
+        for( uint32_t x = 0; x < 30; ++x )
+        {
+            ASSERT_EQ( texels[ y * rowLength + x ], roundTripTexels[ y * rowLength + x ] );
+        }
+    }
+
+    vkDestroyImage( device, swizzledImage, nullptr );
+    vkDestroyImage( device, linearImage, nullptr );
+    vkFreeMemory( device, swizzledImageMemory, nullptr );
+    vkFreeMemory( device, linearImageMemory, nullptr );
+}
+
+static void VKAPI_PTR mockComputeKernel( const VkMockWorkgroupEXT* pWorkgroup )
+{
+    // Each workgroup of 4 invocations writes its id and the push constant.
+    const VkMockDescriptorEXT& output = pWorkgroup->pDescriptorSets[ 0 ].pBindings[ 0 ].pDescriptors[ 0 ];
+    const uint32_t value = *static_cast<const uint32_t*>( pWorkgroup->pPushConstants );
+
+    uint32_t* pOutput = static_cast<uint32_t*>( output.pData );
+    const uint32_t workgroupIndex = pWorkgroup->workgroupId[ 1 ] * 8 + pWorkgroup->workgroupId[ 0 ];
+
+    for( uint32_t i = 0; i < 4; ++i )
+    {
+        pOutput[ workgroupIndex * 4 + i ] = value + pWorkgroup->workgroupId[ 0 ] * 10 + pWorkgroup->workgroupId[ 1 ] * 100 + i;
+    }
+
+    ( *static_cast<std::atomic<uint32_t>*>( pWorkgroup->pUserData ) )++;
+}
+
+TEST_F( vk_mock_icd_tests, vkCreateMockShaderModuleEXT )
+{
+    CreateInstance();
+    CreateDevice();
+
+    auto vkCreateMockShaderModuleEXT = (PFN_vkCreateMockShaderModuleEXT)vkGetDeviceProcAddr( device, "vkCreateMockShaderModuleEXT" );
+    ASSERT_NE( nullptr, vkCreateMockShaderModuleEXT );
+
+    std::atomic<uint32_t> workgroupCount = 0;
+
+    VkMockComputeKernelCreateInfoEXT kernelCreateInfo = {};
+    kernelCreateInfo.pfnKernel = mockComputeKernel;
+    kernelCreateInfo.pUserData = &workgroupCount;
+
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    VkResult result = vkCreateMockShaderModuleEXT( device, &kernelCreateInfo, nullptr, &shaderModule );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkDescriptorSetLayoutBinding binding = {};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo setLayoutCreateInfo = {};
+    setLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    setLayoutCreateInfo.bindingCount = 1;
+    setLayoutCreateInfo.pBindings = &binding;
+
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    result = vkCreateDescriptorSetLayout( device, &setLayoutCreateInfo, nullptr, &setLayout );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkPushConstantRange pushConstantRange = {};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.size = sizeof( uint32_t );
+
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
+    pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutCreateInfo.setLayoutCount = 1;
+    pipelineLayoutCreateInfo.pSetLayouts = &setLayout;
+    pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+    pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    result = vkCreatePipelineLayout( device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkComputePipelineCreateInfo pipelineCreateInfo = {};
+    pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineCreateInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineCreateInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineCreateInfo.stage.module = shaderModule;
+    pipelineCreateInfo.stage.pName = "main";
+    pipelineCreateInfo.layout = pipelineLayout;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    result = vkCreateComputePipelines( device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipeline );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    // The module is not needed after the pipeline is created.
+    vkDestroyShaderModule( device, shaderModule, nullptr );
+
+    VkDescriptorPoolSize poolSize = {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    poolSize.descriptorCount = 1;
+
+    VkDescriptorPoolCreateInfo poolCreateInfo = {};
+    poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolCreateInfo.maxSets = 1;
+    poolCreateInfo.poolSizeCount = 1;
+    poolCreateInfo.pPoolSizes = &poolSize;
+
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    result = vkCreateDescriptorPool( device, &poolCreateInfo, nullptr, &descriptorPool );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkDescriptorSetAllocateInfo setAllocateInfo = {};
+    setAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    setAllocateInfo.descriptorPool = descriptorPool;
+    setAllocateInfo.descriptorSetCount = 1;
+    setAllocateInfo.pSetLayouts = &setLayout;
+
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    result = vkAllocateDescriptorSets( device, &setAllocateInfo, &descriptorSet );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    void* pData = nullptr;
+    CreateHostVisibleBuffer( 1024, &buffer, &memory, &pData );
+    memset( pData, 0, 1024 );
+
+    VkDescriptorBufferInfo bufferInfo = {};
+    bufferInfo.buffer = buffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = 256;
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = descriptorSet;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    write.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets( device, 1, &write, 0, nullptr );
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    BeginCommandBuffer( &commandPool, &commandBuffer );
+
+    vkCmdBindPipeline( commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline );
+
+    // Workgroups ( 2..4, 1..2 ) in the first half of the buffer.
+    uint32_t dynamicOffset = 0;
+    uint32_t pushConstant = 1000;
+    vkCmdBindDescriptorSets( commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet, 1, &dynamicOffset );
+    vkCmdPushConstants( commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof( pushConstant ), &pushConstant );
+    vkCmdDispatchBase( commandBuffer, 2, 1, 0, 3, 2, 1 );
+
+    // Indirect arguments at the end of the buffer are written by the previous command.
+    const VkDispatchIndirectCommand indirectCommand = { 2, 1, 1 };
+    vkCmdUpdateBuffer( commandBuffer, buffer, 1024 - 16, sizeof( indirectCommand ), &indirectCommand );
+
+    // Workgroups ( 0..1, 0 ) in the second half of the buffer.
+    dynamicOffset = 512;
+    pushConstant = 2000;
+    vkCmdBindDescriptorSets( commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet, 1, &dynamicOffset );
+    vkCmdPushConstants( commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof( pushConstant ), &pushConstant );
+    vkCmdDispatchIndirect( commandBuffer, buffer, 1024 - 16 );
+
+    SubmitCommandBuffer( commandBuffer );
+
+    EXPECT_EQ( 8, workgroupCount.load() );
+
+    const uint32_t* pWords = static_cast<const uint32_t*>( pData );
+    EXPECT_EQ( 0, pWords[ 0 ] );
+    EXPECT_EQ( 0, pWords[ ( 8 + 1 ) * 4 ] );
+    EXPECT_EQ( 1120, pWords[ ( 8 + 2 ) * 4 ] );
+    EXPECT_EQ( 1123, pWords[ ( 8 + 2 ) * 4 + 3 ] );
+    EXPECT_EQ( 1140, pWords[ ( 8 + 4 ) * 4 ] );
+    EXPECT_EQ( 0, pWords[ ( 8 + 5 ) * 4 ] );
+    EXPECT_EQ( 1220, pWords[ ( 16 + 2 ) * 4 ] );
+    EXPECT_EQ( 1243, pWords[ ( 16 + 4 ) * 4 + 3 ] );
+    EXPECT_EQ( 2000, pWords[ 128 ] );
+    EXPECT_EQ( 2013, pWords[ 128 + 7 ] );
+    EXPECT_EQ( 0, pWords[ 128 + 8 ] );
+
+    vkDestroyCommandPool( device, commandPool, nullptr );
+    vkDestroyDescriptorPool( device, descriptorPool, nullptr );
+    vkDestroyPipeline( device, pipeline, nullptr );
+    vkDestroyPipelineLayout( device, pipelineLayout, nullptr );
+    vkDestroyDescriptorSetLayout( device, setLayout, nullptr );
+    vkDestroyBuffer( device, buffer, nullptr );
+    vkFreeMemory( device, memory, nullptr );
+}
+
+// Assembled from the following shader:
+//
+//   layout( local_size_x = 16 ) in;
+//   layout( set = 0, binding = 0 ) buffer Values { uint values[]; };
+//   layout( push_constant ) uniform PushConstants { uint scale; };
+//   shared uint partial[ 16 ];
+//
+//   void main()
+//   {
+//       uint i = gl_LocalInvocationID.x;
+//       uint sum = 0;
+//       for( uint j = 0; j <= i; ++j ) sum += j;
+//       partial[ i ] = sum * scale;
+//       barrier();
+//       uint total = subgroupAdd( partial[ 15 - i ] );
+//       values[ gl_GlobalInvocationID.x ] = total + partial[ ( i + 1 ) % 16 ];
+//   }
+static const uint32_t g_SpirvComputeShader[] = {
+0x07230203, 0x00010300, 0x00000000, 0x00000041, 0x00000000, 0x00020011,
+    0x00000001, 0x00020011, 0x0000003d, 0x00020011, 0x0000003f, 0x0003000e,
+    0x00000000, 0x00000001, 0x0007000f, 0x00000005, 0x0000001e, 0x6e69616d,
+    0x00000000, 0x00000006, 0x00000007, 0x00060010, 0x0000001e, 0x00000011,
+    0x00000010, 0x00000001, 0x00000001, 0x00040047, 0x00000006, 0x0000000b,
+    0x0000001b, 0x00040047, 0x00000007, 0x0000000b, 0x0000001c, 0x00040047,
+    0x00000008, 0x00000006, 0x00000004, 0x00030047, 0x00000009, 0x00000002,
+    0x00050048, 0x00000009, 0x00000000, 0x00000023, 0x00000000, 0x00040047,
+    0x0000000b, 0x00000022, 0x00000000, 0x00040047, 0x0000000b, 0x00000021,
+    0x00000000, 0x00030047, 0x0000000c, 0x00000002, 0x00050048, 0x0000000c,
+    0x00000000, 0x00000023, 0x00000000, 0x00020013, 0x00000001, 0x00030021,
+    0x00000002, 0x00000001, 0x00040015, 0x00000003, 0x00000020, 0x00000000,
+    0x00040017, 0x00000004, 0x00000003, 0x00000003, 0x00040020, 0x00000005,
+    0x00000001, 0x00000004, 0x0004003b, 0x00000005, 0x00000006, 0x00000001,
+    0x0004003b, 0x00000005, 0x00000007, 0x00000001, 0x0003001d, 0x00000008,
+    0x00000003, 0x0003001e, 0x00000009, 0x00000008, 0x00040020, 0x0000000a,
+    0x0000000c, 0x00000009, 0x0004003b, 0x0000000a, 0x0000000b, 0x0000000c,
+    0x0003001e, 0x0000000c, 0x00000003, 0x00040020, 0x0000000d, 0x00000009,
+    0x0000000c, 0x0004003b, 0x0000000d, 0x0000000e, 0x00000009, 0x0004002b,
+    0x00000003, 0x0000000f, 0x00000010, 0x0004001c, 0x00000010, 0x00000003,
+    0x0000000f, 0x00040020, 0x00000011, 0x00000004, 0x00000010, 0x0004003b,
+    0x00000011, 0x00000012, 0x00000004, 0x0004002b, 0x00000003, 0x00000013,
+    0x00000000, 0x0004002b, 0x00000003, 0x00000014, 0x00000001, 0x0004002b,
+    0x00000003, 0x00000015, 0x0000000f, 0x0004002b, 0x00000003, 0x00000016,
+    0x00000002, 0x0004002b, 0x00000003, 0x00000017, 0x00000003, 0x0004002b,
+    0x00000003, 0x00000018, 0x00000108, 0x00020014, 0x00000019, 0x00040020,
+    0x0000001a, 0x00000009, 0x00000003, 0x00040020, 0x0000001b, 0x00000004,
+    0x00000003, 0x00040020, 0x0000001c, 0x0000000c, 0x00000003, 0x00050036,
+    0x00000001, 0x0000001e, 0x00000000, 0x00000002, 0x000200f8, 0x0000001f,
+    0x0004003d, 0x00000004, 0x00000021, 0x00000006, 0x00050051, 0x00000003,
+    0x00000020, 0x00000021, 0x00000000, 0x000200f9, 0x00000028, 0x000200f8,
+    0x00000028, 0x000700f5, 0x00000003, 0x00000029, 0x00000013, 0x0000001f,
+    0x0000002c, 0x0000002a, 0x000700f5, 0x00000003, 0x0000002d, 0x00000013,
+    0x0000001f, 0x0000002e, 0x0000002a, 0x000400f6, 0x0000002b, 0x0000002a,
+    0x00000000, 0x000500b2, 0x00000019, 0x0000002f, 0x00000029, 0x00000020,
+    0x000400fa, 0x0000002f, 0x00000030, 0x0000002b, 0x000200f8, 0x00000030,
+    0x00050080, 0x00000003, 0x0000002e, 0x0000002d, 0x00000029, 0x000200f9,
+    0x0000002a, 0x000200f8, 0x0000002a, 0x00050080, 0x00000003, 0x0000002c,
+    0x00000029, 0x00000014, 0x000200f9, 0x00000028, 0x000200f8, 0x0000002b,
+    0x00050041, 0x0000001a, 0x00000031, 0x0000000e, 0x00000013, 0x0004003d,
+    0x00000003, 0x00000032, 0x00000031, 0x00050084, 0x00000003, 0x00000033,
+    0x0000002d, 0x00000032, 0x00050041, 0x0000001b, 0x00000034, 0x00000012,
+    0x00000020, 0x0003003e, 0x00000034, 0x00000033, 0x000400e0, 0x00000016,
+    0x00000016, 0x00000018, 0x00050082, 0x00000003, 0x00000035, 0x00000015,
+    0x00000020, 0x00050041, 0x0000001b, 0x00000036, 0x00000012, 0x00000035,
+    0x0004003d, 0x00000003, 0x00000037, 0x00000036, 0x0006015d, 0x00000003,
+    0x00000038, 0x00000017, 0x00000000, 0x00000037, 0x00050080, 0x00000003,
+    0x00000039, 0x00000020, 0x00000014, 0x00050089, 0x00000003, 0x0000003a,
+    0x00000039, 0x0000000f, 0x00050041, 0x0000001b, 0x0000003b, 0x00000012,
+    0x0000003a, 0x0004003d, 0x00000003, 0x0000003c, 0x0000003b, 0x00050080,
+    0x00000003, 0x0000003d, 0x00000038, 0x0000003c, 0x0004003d, 0x00000004,
+    0x0000003e, 0x00000007, 0x00050051, 0x00000003, 0x0000003f, 0x0000003e,
+    0x00000000, 0x00060041, 0x0000001c, 0x00000040, 0x0000000b, 0x00000013,
+    0x0000003f, 0x0003003e, 0x00000040, 0x0000003d, 0x000100fd, 0x00010038,
+};
+
+TEST_F( vk_mock_icd_tests, vkCmdDispatchSpirv )
+{
+    CreateInstance();
+    CreateDevice();
+
+    VkShaderModuleCreateInfo shaderModuleCreateInfo = {};
+    shaderModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    shaderModuleCreateInfo.codeSize = sizeof( g_SpirvComputeShader );
+    shaderModuleCreateInfo.pCode = g_SpirvComputeShader;
+
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    VkResult result = vkCreateShaderModule( device, &shaderModuleCreateInfo, nullptr, &shaderModule );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkDescriptorSetLayoutBinding binding = {};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo setLayoutCreateInfo = {};
+    setLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    setLayoutCreateInfo.bindingCount = 1;
+    setLayoutCreateInfo.pBindings = &binding;
+
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    result = vkCreateDescriptorSetLayout( device, &setLayoutCreateInfo, nullptr, &setLayout );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkPushConstantRange pushConstantRange = {};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.size = sizeof( uint32_t );
+
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
+    pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutCreateInfo.setLayoutCount = 1;
+    pipelineLayoutCreateInfo.pSetLayouts = &setLayout;
+    pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+    pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    result = vkCreatePipelineLayout( device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkComputePipelineCreateInfo pipelineCreateInfo = {};
+    pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineCreateInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineCreateInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineCreateInfo.stage.module = shaderModule;
+    pipelineCreateInfo.stage.pName = "main";
+    pipelineCreateInfo.layout = pipelineLayout;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    result = vkCreateComputePipelines( device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipeline );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    vkDestroyShaderModule( device, shaderModule, nullptr );
+
+    VkDescriptorPoolSize poolSize = {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 1;
+
+    VkDescriptorPoolCreateInfo poolCreateInfo = {};
+    poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolCreateInfo.maxSets = 1;
+    poolCreateInfo.poolSizeCount = 1;
+    poolCreateInfo.pPoolSizes = &poolSize;
+
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    result = vkCreateDescriptorPool( device, &poolCreateInfo, nullptr, &descriptorPool );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkDescriptorSetAllocateInfo setAllocateInfo = {};
+    setAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    setAllocateInfo.descriptorPool = descriptorPool;
+    setAllocateInfo.descriptorSetCount = 1;
+    setAllocateInfo.pSetLayouts = &setLayout;
+
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    result = vkAllocateDescriptorSets( device, &setAllocateInfo, &descriptorSet );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    void* pData = nullptr;
+    CreateHostVisibleBuffer( 256, &buffer, &memory, &pData );
+    memset( pData, 0, 256 );
+
+    VkDescriptorBufferInfo bufferInfo = {};
+    bufferInfo.buffer = buffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = 128;
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = descriptorSet;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets( device, 1, &write, 0, nullptr );
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    BeginCommandBuffer( &commandPool, &commandBuffer );
+
+    const uint32_t scale = 3;
+    vkCmdBindPipeline( commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline );
+    vkCmdBindDescriptorSets( commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet, 0, nullptr );
+    vkCmdPushConstants( commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof( scale ), &scale );
+    vkCmdDispatch( commandBuffer, 2, 1, 1 );
+
+    SubmitCommandBuffer( commandBuffer );
+
+    // Subgroups of 8 invocations sum the values written by the other subgroup.
+    uint32_t partial[ 16 ];
+    for( uint32_t i = 0; i < 16; ++i )
+    {
+        partial[ i ] = i * ( i + 1 ) / 2 * scale;
+    }
+
+    const uint32_t* pWords = static_cast<const uint32_t*>( pData );
+    for( uint32_t g = 0; g < 32; ++g )
+    {
+        const uint32_t i = g % 16;
+        const uint32_t first = ( i < 8 ) ? 8 : 0;
+
+        uint32_t total = 0;
+        for( uint32_t k = first; k < first + 8; ++k )
+        {
+            total += partial[ k ];
+        }
+
+        EXPECT_EQ( total + partial[ ( i + 1 ) % 16 ], pWords[ g ] );
+    }
+    EXPECT_EQ( 0, pWords[ 32 ] );
+
+    vkDestroyCommandPool( device, commandPool, nullptr );
+    vkDestroyDescriptorPool( device, descriptorPool, nullptr );
+    vkDestroyPipeline( device, pipeline, nullptr );
+    vkDestroyPipelineLayout( device, pipelineLayout, nullptr );
+    vkDestroyDescriptorSetLayout( device, setLayout, nullptr );
+    vkDestroyBuffer( device, buffer, nullptr );
+    vkFreeMemory( device, memory, nullptr );
+}
+
+static void VKAPI_PTR mockVertexKernel( const VkMockVertexInputEXT* pInput, VkMockVertexOutputEXT* pOutput )
+{
+    // Triangle covering the whole viewport.
+    pOutput->position[ 0 ] = ( pInput->vertexIndex == 1 ) ? 3.0f : -1.0f;
+    pOutput->position[ 1 ] = ( pInput->vertexIndex == 2 ) ? 3.0f : -1.0f;
+    pOutput->position[ 2 ] = 0.0f;
+    pOutput->position[ 3 ] = 1.0f;
+}
+
+static void VKAPI_PTR mockFragmentKernel( const VkMockFragmentInputEXT* pInput, VkMockFragmentOutputEXT* pOutput )
+{
+    // Left columns are discarded, the rest is filled with the color from the push constants.
+    if( pInput->fragCoord[ 0 ] < 10.0f )
+    {
+        pOutput->discard = VK_TRUE;
+        return;
+    }
+
+    memcpy( pOutput->colors[ 0 ].float32, pInput->pPushConstants, sizeof( pOutput->colors[ 0 ].float32 ) );
+}
+
+TEST_F( vk_mock_icd_tests, vkCmdDrawSoftwareRasterizer )
+{
+    CreateInstance();
+    CreateDevice();
+
+    auto vkSetMockRasterizerEXT = (PFN_vkSetMockRasterizerEXT)vkGetDeviceProcAddr( device, "vkSetMockRasterizerEXT" );
+    ASSERT_NE( nullptr, vkSetMockRasterizerEXT );
+
+    auto vkCreateMockGraphicsShaderModuleEXT = (PFN_vkCreateMockGraphicsShaderModuleEXT)vkGetDeviceProcAddr( device, "vkCreateMockGraphicsShaderModuleEXT" );
+    ASSERT_NE( nullptr, vkCreateMockGraphicsShaderModuleEXT );
+
+    vkSetMockRasterizerEXT( device, VK_MOCK_RASTERIZER_SOFTWARE_EXT );
+
+    // Attachments span multiple tiles, with partial tiles on the right and bottom edges.
+    const uint32_t width = 100, height = 80;
+
+    VkImageCreateInfo imageCreateInfo = {};
+    imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    imageCreateInfo.extent = { width, height, 1 };
+    imageCreateInfo.mipLevels = 1;
+    imageCreateInfo.arrayLayers = 1;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
+    VkImage colorImage = VK_NULL_HANDLE;
+    VkDeviceMemory colorImageMemory = VK_NULL_HANDLE;
+    CreateImage( imageCreateInfo, &colorImage, &colorImageMemory );
+
+    imageCreateInfo.format = VK_FORMAT_D32_SFLOAT;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
+    VkImage depthImage = VK_NULL_HANDLE;
+    VkDeviceMemory depthImageMemory = VK_NULL_HANDLE;
+    CreateImage( imageCreateInfo, &depthImage, &depthImageMemory );
+
+    VkImageViewCreateInfo imageViewCreateInfo = {};
+    imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    imageViewCreateInfo.image = colorImage;
+    imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    imageViewCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    imageViewCreateInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+    VkImageView colorView = VK_NULL_HANDLE;
+    VkResult result = vkCreateImageView( device, &imageViewCreateInfo, nullptr, &colorView );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    imageViewCreateInfo.image = depthImage;
+    imageViewCreateInfo.format = VK_FORMAT_D32_SFLOAT;
+    imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+
+    VkImageView depthView = VK_NULL_HANDLE;
+    result = vkCreateImageView( device, &imageViewCreateInfo, nullptr, &depthView );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    // Vertices with the position and color attributes.
+    // Red triangle covers the whole viewport, green triangle is hidden behind it, and
+    // the blue quad in front of it covers the bottom-right quarter.
+    const float vertices[][ 8 ] = {
+        { -1.0f, -1.0f, 0.5f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f },
+        { 3.0f, -1.0f, 0.5f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f },
+        { -1.0f, 3.0f, 0.5f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f },
+        { -1.0f, -1.0f, 0.75f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f },
+        { 1.0f, -1.0f, 0.75f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f },
+        { -1.0f, 1.0f, 0.75f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f },
+        { 0.0f, 0.0f, 0.25f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f },
+        { 1.0f, 0.0f, 0.25f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f },
+        { 0.0f, 1.0f, 0.25f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f },
+        { 1.0f, 0.0f, 0.25f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f },
+        { 1.0f, 1.0f, 0.25f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f },
+        { 0.0f, 1.0f, 0.25f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f } };
+
+    VkBuffer vertexBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory vertexBufferMemory = VK_NULL_HANDLE;
+    void* pVertexData = nullptr;
+    CreateHostVisibleBuffer( sizeof( vertices ), &vertexBuffer, &vertexBufferMemory, &pVertexData );
+    memcpy( pVertexData, vertices, sizeof( vertices ) );
+
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
+    pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    result = vkCreatePipelineLayout( device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkVertexInputBindingDescription binding = { 0, sizeof( vertices[ 0 ] ), VK_VERTEX_INPUT_RATE_VERTEX };
+    VkVertexInputAttributeDescription attributes[ 2 ] = {
+        { 0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, 0 },
+        { 1, 0, VK_FORMAT_R32G32B32A32_SFLOAT, 16 } };
+
+    VkPipelineVertexInputStateCreateInfo vertexInputState = {};
+    vertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputState.vertexBindingDescriptionCount = 1;
+    vertexInputState.pVertexBindingDescriptions = &binding;
+    vertexInputState.vertexAttributeDescriptionCount = 2;
+    vertexInputState.pVertexAttributeDescriptions = attributes;
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = {};
+    inputAssemblyState.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssemblyState.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkViewport viewport = { 0.0f, 0.0f, float( width ), float( height ), 0.0f, 1.0f };
+    VkRect2D scissor = { { 0, 0 }, { width, height } };
+
+    VkPipelineViewportStateCreateInfo viewportState = {};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.pViewports = &viewport;
+    viewportState.scissorCount = 1;
+    viewportState.pScissors = &scissor;
+
+    VkPipelineRasterizationStateCreateInfo rasterizationState = {};
+    rasterizationState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizationState.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizationState.cullMode = VK_CULL_MODE_NONE;
+    rasterizationState.lineWidth = 1.0f;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencilState = {};
+    depthStencilState.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencilState.depthTestEnable = VK_TRUE;
+    depthStencilState.depthWriteEnable = VK_TRUE;
+    depthStencilState.depthCompareOp = VK_COMPARE_OP_LESS;
+
+    VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
+    colorBlendAttachment.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    VkPipelineColorBlendStateCreateInfo colorBlendState = {};
+    colorBlendState.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlendState.attachmentCount = 1;
+    colorBlendState.pAttachments = &colorBlendAttachment;
+
+    VkGraphicsPipelineCreateInfo pipelineCreateInfo = {};
+    pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineCreateInfo.pVertexInputState = &vertexInputState;
+    pipelineCreateInfo.pInputAssemblyState = &inputAssemblyState;
+    pipelineCreateInfo.pViewportState = &viewportState;
+    pipelineCreateInfo.pRasterizationState = &rasterizationState;
+    pipelineCreateInfo.pDepthStencilState = &depthStencilState;
+    pipelineCreateInfo.pColorBlendState = &colorBlendState;
+    pipelineCreateInfo.layout = pipelineLayout;
+
+    // Position-only pipeline, without shader stages.
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    result = vkCreateGraphicsPipelines( device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipeline );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    // Pipeline with host kernels, without vertex input and depth test.
+    VkMockGraphicsKernelCreateInfoEXT kernelCreateInfo = {};
+    kernelCreateInfo.pfnVertexKernel = mockVertexKernel;
+    kernelCreateInfo.pfnFragmentKernel = mockFragmentKernel;
+
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    result = vkCreateMockGraphicsShaderModuleEXT( device, &kernelCreateInfo, nullptr, &shaderModule );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkPipelineShaderStageCreateInfo stages[ 2 ] = {};
+    stages[ 0 ].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[ 0 ].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stages[ 0 ].module = shaderModule;
+    stages[ 0 ].pName = "main";
+    stages[ 1 ] = stages[ 0 ];
+    stages[ 1 ].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    depthStencilState.depthTestEnable = VK_FALSE;
+    pipelineCreateInfo.stageCount = 2;
+    pipelineCreateInfo.pStages = stages;
+    pipelineCreateInfo.pVertexInputState = nullptr;
+
+    VkPipeline kernelPipeline = VK_NULL_HANDLE;
+    result = vkCreateGraphicsPipelines( device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &kernelPipeline );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    vkDestroyShaderModule( device, shaderModule, nullptr );
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    BeginCommandBuffer( &commandPool, &commandBuffer );
+
+    VkRenderingAttachmentInfo colorAttachment = {};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    colorAttachment.imageView = colorView;
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.clearValue.color = { { 0.0f, 0.0f, 0.0f, 1.0f } };
+
+    VkRenderingAttachmentInfo depthAttachment = {};
+    depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    depthAttachment.imageView = depthView;
+    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depthAttachment.clearValue.depthStencil = { 1.0f, 0 };
+
+    VkRenderingInfo renderingInfo = {};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+    renderingInfo.renderArea = { { 0, 0 }, { width, height } };
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+    renderingInfo.pDepthAttachment = &depthAttachment;
+
+    vkCmdBeginRendering( commandBuffer, &renderingInfo );
+
+    const VkDeviceSize vertexBufferOffset = 0;
+    vkCmdBindPipeline( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline );
+    vkCmdBindVertexBuffers( commandBuffer, 0, 1, &vertexBuffer, &vertexBufferOffset );
+    vkCmdDraw( commandBuffer, 12, 1, 0, 0 );
+
+    vkCmdEndRendering( commandBuffer );
+
+    SubmitCommandBuffer( commandBuffer );
+
+    VkImageSubresource subresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0 };
+    VkSubresourceLayout colorLayout = {};
+    vkGetImageSubresourceLayout( device, colorImage, &subresource, &colorLayout );
+
+    subresource.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    VkSubresourceLayout depthLayout = {};
+    vkGetImageSubresourceLayout( device, depthImage, &subresource, &depthLayout );
+
+    void* pColorData = nullptr;
+    result = vkMapMemory( device, colorImageMemory, 0, VK_WHOLE_SIZE, 0, &pColorData );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    void* pDepthData = nullptr;
+    result = vkMapMemory( device, depthImageMemory, 0, VK_WHOLE_SIZE, 0, &pDepthData );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    // Shared edges of the quad triangles are covered exactly once, without gaps.
+    for( uint32_t y = 0; y < height; ++y )
+    {
+        const uint8_t* pColorRow = static_cast<const uint8_t*>( pColorData ) + colorLayout.offset + y * colorLayout.rowPitch;
+        const float* pDepthRow = reinterpret_cast<const float*>( static_cast<const uint8_t*>( pDepthData ) + depthLayout.offset + y * depthLayout.rowPitch );
+
+        for( uint32_t x = 0; x < width; ++x )
+        {
+            const bool blue = ( x >= width / 2 ) && ( y >= height / 2 );
+            const uint8_t expected[ 4 ] = { uint8_t( blue ? 0 : 255 ), 0, uint8_t( blue ? 255 : 0 ), 255 };
+
+            ASSERT_EQ( 0, memcmp( expected, pColorRow + x * 4, 4 ) ) << "x = " << x << ", y = " << y;
+            ASSERT_EQ( blue ? 0.25f : 0.5f, pDepthRow[ x ] ) << "x = " << x << ", y = " << y;
+        }
+    }
+
+    // Second pass loads the attachments and overwrites them with the host kernels.
+    vkResetCommandBuffer( commandBuffer, 0 );
+
+    VkCommandBufferBeginInfo commandBufferBeginInfo = {};
+    commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    vkBeginCommandBuffer( commandBuffer, &commandBufferBeginInfo );
+
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+
+    const float pushColor[ 4 ] = { 0.0f, 1.0f, 1.0f, 1.0f };
+
+    vkCmdBeginRendering( commandBuffer, &renderingInfo );
+    vkCmdBindPipeline( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, kernelPipeline );
+    vkCmdPushConstants( commandBuffer, pipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof( pushColor ), pushColor );
+    vkCmdDraw( commandBuffer, 3, 1, 0, 0 );
+    vkCmdEndRendering( commandBuffer );
+
+    SubmitCommandBuffer( commandBuffer );
+
+    for( uint32_t y = 0; y < height; ++y )
+    {
+        const uint8_t* pColorRow = static_cast<const uint8_t*>( pColorData ) + colorLayout.offset + y * colorLayout.rowPitch;
+
+        for( uint32_t x = 0; x < width; ++x )
+        {
+            const uint8_t expected[ 4 ] = { 0, 255, 255, 255 };
+            if( x >= 10 )
+            {
+                ASSERT_EQ( 0, memcmp( expected, pColorRow + x * 4, 4 ) ) << "x = " << x << ", y = " << y;
+            }
+            else
+            {
+                ASSERT_EQ( 255, pColorRow[ x * 4 ] ) << "x = " << x << ", y = " << y;
+            }
+        }
+    }
+
+    vkDestroyCommandPool( device, commandPool, nullptr );
+    vkDestroyPipeline( device, kernelPipeline, nullptr );
+    vkDestroyPipeline( device, pipeline, nullptr );
+    vkDestroyPipelineLayout( device, pipelineLayout, nullptr );
+    vkDestroyImageView( device, depthView, nullptr );
+    vkDestroyImageView( device, colorView, nullptr );
+    vkDestroyImage( device, depthImage, nullptr );
+    vkDestroyImage( device, colorImage, nullptr );
+    vkDestroyBuffer( device, vertexBuffer, nullptr );
+    vkFreeMemory( device, depthImageMemory, nullptr );
+    vkFreeMemory( device, colorImageMemory, nullptr );
+    vkFreeMemory( device, vertexBufferMemory, nullptr );
+}
+
+TEST_F( vk_mock_icd_tests, vkCmdDrawIndexedVertexCache )
+{
+    CreateInstance();
+    CreateDevice();
+
+    auto vkSetMockVertexCacheEXT = (PFN_vkSetMockVertexCacheEXT)vkGetDeviceProcAddr( device, "vkSetMockVertexCacheEXT" );
+    ASSERT_NE( nullptr, vkSetMockVertexCacheEXT );
+
+    auto vkGetMockDrawStatisticsEXT = (PFN_vkGetMockDrawStatisticsEXT)vkGetDeviceProcAddr( device, "vkGetMockDrawStatisticsEXT" );
+    ASSERT_NE( nullptr, vkGetMockDrawStatisticsEXT );
+
+    auto vkResetMockDrawStatisticsEXT = (PFN_vkResetMockDrawStatisticsEXT)vkGetDeviceProcAddr( device, "vkResetMockDrawStatisticsEXT" );
+    ASSERT_NE( nullptr, vkResetMockDrawStatisticsEXT );
+
+    // Vertex 0 is reused after 1 and 2 entered the cache.
+    // FIFO cache with 2 entries evicts it, LRU cache keeps it because it was used recently.
+    const uint16_t indices[] = { 0, 1, 0, 2, 0 };
+
+    VkBuffer indexBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory indexBufferMemory = VK_NULL_HANDLE;
+    void* pIndexData = nullptr;
+    CreateHostVisibleBuffer( sizeof( indices ), &indexBuffer, &indexBufferMemory, &pIndexData );
+    memcpy( pIndexData, indices, sizeof( indices ) );
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    BeginCommandBuffer( &commandPool, &commandBuffer );
+
+    auto drawIndexed = [&]( VkMockVertexCacheEXT cache, uint32_t entryCount, VkMockDrawStatisticsEXT* pStatistics )
+    {
+        vkSetMockVertexCacheEXT( device, cache, entryCount );
+        vkResetMockDrawStatisticsEXT( device );
+
+        vkResetCommandBuffer( commandBuffer, 0 );
+
+        VkCommandBufferBeginInfo commandBufferBeginInfo = {};
+        commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        vkBeginCommandBuffer( commandBuffer, &commandBufferBeginInfo );
+
+        vkCmdBindIndexBuffer( commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT16 );
+        vkCmdDrawIndexed( commandBuffer, 5, 2, 0, 0, 0 );
+
+        SubmitCommandBuffer( commandBuffer );
+
+        vkGetMockDrawStatisticsEXT( device, pStatistics );
+    };
+
+    VkMockDrawStatisticsEXT statistics = {};
+    drawIndexed( VK_MOCK_VERTEX_CACHE_FIFO_EXT, 2, &statistics );
+    EXPECT_EQ( 1, statistics.drawCount );
+    EXPECT_EQ( 10, statistics.vertexCount );
+    EXPECT_EQ( 8, statistics.vertexShaderInvocations );
+
+    drawIndexed( VK_MOCK_VERTEX_CACHE_LRU_EXT, 2, &statistics );
+    EXPECT_EQ( 1, statistics.drawCount );
+    EXPECT_EQ( 10, statistics.vertexCount );
+    EXPECT_EQ( 6, statistics.vertexShaderInvocations );
+
+    drawIndexed( VK_MOCK_VERTEX_CACHE_NONE_EXT, 0, &statistics );
+    EXPECT_EQ( 1, statistics.drawCount );
+    EXPECT_EQ( 10, statistics.vertexCount );
+    EXPECT_EQ( 10, statistics.vertexShaderInvocations );
+
+    // Larger cache holds all vertices of the draw.
+    drawIndexed( VK_MOCK_VERTEX_CACHE_FIFO_EXT, 32, &statistics );
+    EXPECT_EQ( 6, statistics.vertexShaderInvocations );
+
+    vkDestroyCommandPool( device, commandPool, nullptr );
+    vkDestroyBuffer( device, indexBuffer, nullptr );
+    vkFreeMemory( device, indexBufferMemory, nullptr );
+}
+
+TEST_F( vk_mock_icd_tests, vkCmdDrawIndirectCount )
+{
+    CreateInstance();
+    CreateDevice();
+
+    auto vkSetMockVertexCacheEXT = (PFN_vkSetMockVertexCacheEXT)vkGetDeviceProcAddr( device, "vkSetMockVertexCacheEXT" );
+    ASSERT_NE( nullptr, vkSetMockVertexCacheEXT );
+
+    auto vkGetMockDrawStatisticsEXT = (PFN_vkGetMockDrawStatisticsEXT)vkGetDeviceProcAddr( device, "vkGetMockDrawStatisticsEXT" );
+    ASSERT_NE( nullptr, vkGetMockDrawStatisticsEXT );
+
+    vkSetMockVertexCacheEXT( device, VK_MOCK_VERTEX_CACHE_NONE_EXT, 0 );
+
+    const uint16_t indices[] = { 0, 1, 2, 3, 4 };
+
+    VkBuffer indexBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory indexBufferMemory = VK_NULL_HANDLE;
+    void* pIndexData = nullptr;
+    CreateHostVisibleBuffer( sizeof( indices ), &indexBuffer, &indexBufferMemory, &pIndexData );
+    memcpy( pIndexData, indices, sizeof( indices ) );
+
+    // Third draw is culled by the count written to the count buffer.
+    const VkDrawIndexedIndirectCommand indexedDraws[] = {
+        { 3, 2, 0, 0, 0 },
+        { 5, 1, 0, 0, 0 },
+        { 100, 1, 0, 0, 0 } };
+
+    VkBuffer indexedDrawBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory indexedDrawBufferMemory = VK_NULL_HANDLE;
+    void* pIndexedDrawData = nullptr;
+    CreateHostVisibleBuffer( sizeof( indexedDraws ), &indexedDrawBuffer, &indexedDrawBufferMemory, &pIndexedDrawData );
+    memcpy( pIndexedDrawData, indexedDraws, sizeof( indexedDraws ) );
+
+    // Second draw has no vertices, but it is still executed.
+    const VkDrawIndirectCommand draws[] = {
+        { 4, 1, 0, 0 },
+        { 0, 1, 0, 0 } };
+
+    VkBuffer drawBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory drawBufferMemory = VK_NULL_HANDLE;
+    void* pDrawData = nullptr;
+    CreateHostVisibleBuffer( sizeof( draws ), &drawBuffer, &drawBufferMemory, &pDrawData );
+    memcpy( pDrawData, draws, sizeof( draws ) );
+
+    VkBuffer countBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory countBufferMemory = VK_NULL_HANDLE;
+    void* pCountData = nullptr;
+    CreateHostVisibleBuffer( sizeof( uint32_t ), &countBuffer, &countBufferMemory, &pCountData );
+    memset( pCountData, 0, sizeof( uint32_t ) );
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    BeginCommandBuffer( &commandPool, &commandBuffer );
+
+    // Count is written by the command buffer, so it must be read when the draw is executed.
+    vkCmdFillBuffer( commandBuffer, countBuffer, 0, sizeof( uint32_t ), 2 );
+    vkCmdBindIndexBuffer( commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT16 );
+    vkCmdDrawIndexedIndirectCount( commandBuffer, indexedDrawBuffer, 0, countBuffer, 0, 3, sizeof( VkDrawIndexedIndirectCommand ) );
+    vkCmdDrawIndirect( commandBuffer, drawBuffer, 0, 2, sizeof( VkDrawIndirectCommand ) );
+
+    SubmitCommandBuffer( commandBuffer );
+
+    VkMockDrawStatisticsEXT statistics = {};
+    vkGetMockDrawStatisticsEXT( device, &statistics );
+    EXPECT_EQ( 2, statistics.indirectCommandCount );
+    EXPECT_EQ( 4, statistics.indirectDrawCount );
+    EXPECT_EQ( 4, statistics.drawCount );
+    EXPECT_EQ( 15, statistics.vertexCount );
+    EXPECT_EQ( 15, statistics.vertexShaderInvocations );
+
+    vkDestroyCommandPool( device, commandPool, nullptr );
+    vkDestroyBuffer( device, countBuffer, nullptr );
+    vkDestroyBuffer( device, drawBuffer, nullptr );
+    vkDestroyBuffer( device, indexedDrawBuffer, nullptr );
+    vkDestroyBuffer( device, indexBuffer, nullptr );
+    vkFreeMemory( device, countBufferMemory, nullptr );
+    vkFreeMemory( device, drawBufferMemory, nullptr );
+    vkFreeMemory( device, indexedDrawBufferMemory, nullptr );
+    vkFreeMemory( device, indexBufferMemory, nullptr );
+}
+
+TEST_F( vk_mock_icd_tests, vkGetQueryPoolResults )
+{
+    CreateInstance();
+    CreateDevice();
+
+    auto vkSetMockVertexCacheEXT = (PFN_vkSetMockVertexCacheEXT)vkGetDeviceProcAddr( device, "vkSetMockVertexCacheEXT" );
+    ASSERT_NE( nullptr, vkSetMockVertexCacheEXT );
+
+    vkSetMockVertexCacheEXT( device, VK_MOCK_VERTEX_CACHE_NONE_EXT, 0 );
+
+    VkQueryPoolCreateInfo queryPoolCreateInfo = {};
+    queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolCreateInfo.queryType = VK_QUERY_TYPE_OCCLUSION;
+    queryPoolCreateInfo.queryCount = 2;
+
+    VkQueryPool occlusionQueryPool = VK_NULL_HANDLE;
+    VkResult result = vkCreateQueryPool( device, &queryPoolCreateInfo, nullptr, &occlusionQueryPool );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    queryPoolCreateInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+    queryPoolCreateInfo.queryCount = 1;
+    queryPoolCreateInfo.pipelineStatistics =
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT;
+
+    VkQueryPool statisticsQueryPool = VK_NULL_HANDLE;
+    result = vkCreateQueryPool( device, &queryPoolCreateInfo, nullptr, &statisticsQueryPool );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    const uint32_t timestampCount = 1000;
+    queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolCreateInfo.queryCount = timestampCount;
+    queryPoolCreateInfo.pipelineStatistics = 0;
+
+    VkQueryPool timestampQueryPool = VK_NULL_HANDLE;
+    result = vkCreateQueryPool( device, &queryPoolCreateInfo, nullptr, &timestampQueryPool );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    vkResetQueryPool( device, occlusionQueryPool, 0, 2 );
+    vkResetQueryPool( device, statisticsQueryPool, 0, 1 );
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    BeginCommandBuffer( &commandPool, &commandBuffer );
+
+    vkCmdResetQueryPool( commandBuffer, timestampQueryPool, 0, timestampCount );
+    vkCmdBeginQuery( commandBuffer, statisticsQueryPool, 0, 0 );
+    vkCmdBeginQuery( commandBuffer, occlusionQueryPool, 0, VK_QUERY_CONTROL_PRECISE_BIT );
+    vkCmdDraw( commandBuffer, 6, 2, 0, 0 );
+    vkCmdEndQuery( commandBuffer, occlusionQueryPool, 0 );
+    vkCmdDraw( commandBuffer, 3, 1, 0, 0 );
+    vkCmdEndQuery( commandBuffer, statisticsQueryPool, 0 );
+
+    for( uint32_t i = 0; i < timestampCount; ++i )
+    {
+        vkCmdWriteTimestamp( commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampQueryPool, i );
+    }
+
+    // Results are not available until the command buffer is executed.
+    uint64_t occlusionResults[ 2 ][ 2 ] = {};
+    result = vkGetQueryPoolResults( device, occlusionQueryPool, 0, 2, sizeof( occlusionResults ), occlusionResults, sizeof( occlusionResults[ 0 ] ),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT );
+    EXPECT_EQ( VK_NOT_READY, result );
+    EXPECT_EQ( 0, occlusionResults[ 0 ][ 1 ] );
+    EXPECT_EQ( 0, occlusionResults[ 1 ][ 1 ] );
+
+    SubmitCommandBuffer( commandBuffer );
+
+    // Draws that are not rasterized pass one sample per primitive.
+    result = vkGetQueryPoolResults( device, occlusionQueryPool, 0, 2, sizeof( occlusionResults ), occlusionResults, sizeof( occlusionResults[ 0 ] ),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT );
+    EXPECT_EQ( VK_NOT_READY, result );
+    EXPECT_EQ( 4, occlusionResults[ 0 ][ 0 ] );
+    EXPECT_EQ( 1, occlusionResults[ 0 ][ 1 ] );
+    EXPECT_EQ( 0, occlusionResults[ 1 ][ 1 ] );
+
+    uint64_t statisticsResults[ 3 ] = {};
+    result = vkGetQueryPoolResults( device, statisticsQueryPool, 0, 1, sizeof( statisticsResults ), statisticsResults, sizeof( statisticsResults ),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT );
+    EXPECT_EQ( VK_SUCCESS, result );
+    EXPECT_EQ( 15, statisticsResults[ 0 ] );
+    EXPECT_EQ( 5, statisticsResults[ 1 ] );
+    EXPECT_EQ( 15, statisticsResults[ 2 ] );
+
+    // Large ranges of 32-bit results are copied in bulk.
+    std::vector<uint32_t> timestamps( timestampCount );
+    result = vkGetQueryPoolResults( device, timestampQueryPool, 0, timestampCount, timestampCount * sizeof( uint32_t ), timestamps.data(), sizeof( uint32_t ),
+        VK_QUERY_RESULT_WAIT_BIT );
+    EXPECT_EQ( VK_SUCCESS, result );
+
+    std::vector<uint64_t> timestamps64( timestampCount );
+    result = vkGetQueryPoolResults( device, timestampQueryPool, 0, timestampCount, timestampCount * sizeof( uint64_t ), timestamps64.data(), sizeof( uint64_t ),
+        VK_QUERY_RESULT_64_BIT );
+    EXPECT_EQ( VK_SUCCESS, result );
+
+    for( uint32_t i = 0; i < timestampCount; ++i )
+    {
+        EXPECT_EQ( static_cast<uint32_t>( timestamps64[ i ] ), timestamps[ i ] );
+        if( i > 0 )
+        {
+            EXPECT_LE( timestamps64[ i - 1 ], timestamps64[ i ] );
+        }
+    }
+
+    vkResetQueryPool( device, timestampQueryPool, 0, timestampCount );
+
+    result = vkGetQueryPoolResults( device, timestampQueryPool, 0, timestampCount, timestampCount * sizeof( uint64_t ), timestamps64.data(), sizeof( uint64_t ),
+        VK_QUERY_RESULT_64_BIT );
+    EXPECT_EQ( VK_NOT_READY, result );
+
+    vkDestroyCommandPool( device, commandPool, nullptr );
+    vkDestroyQueryPool( device, timestampQueryPool, nullptr );
+    vkDestroyQueryPool( device, statisticsQueryPool, nullptr );
+    vkDestroyQueryPool( device, occlusionQueryPool, nullptr );
+}
+
+TEST_F( vk_mock_icd_tests, vkGetCalibratedTimestampsKHR )
+{
+    CreateInstance();
+    CreateDevice();
+
+    auto vkSetMockTimestampClockEXT = (PFN_vkSetMockTimestampClockEXT)vkGetInstanceProcAddr( instance, "vkSetMockTimestampClockEXT" );
+    ASSERT_NE( nullptr, vkSetMockTimestampClockEXT );
+
+    uint32_t timeDomainCount = 0;
+    VkResult result = vkGetPhysicalDeviceCalibrateableTimeDomainsKHR( physicalDevice, &timeDomainCount, nullptr );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    std::vector<VkTimeDomainKHR> timeDomains( timeDomainCount );
+    result = vkGetPhysicalDeviceCalibrateableTimeDomainsKHR( physicalDevice, &timeDomainCount, timeDomains.data() );
+    ASSERT_EQ( VK_SUCCESS, result );
+    ASSERT_EQ( VK_TIME_DOMAIN_DEVICE_KHR, timeDomains[ 0 ] );
+    ASSERT_NE( timeDomains.end(), std::find( timeDomains.begin(), timeDomains.end(), VK_TIME_DOMAIN_CLOCK_MONOTONIC_KHR ) );
+
+    VkCalibratedTimestampInfoKHR timestampInfos[ 2 ] = {};
+    timestampInfos[ 0 ].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_KHR;
+    timestampInfos[ 0 ].timeDomain = VK_TIME_DOMAIN_DEVICE_KHR;
+    timestampInfos[ 1 ].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_KHR;
+    timestampInfos[ 1 ].timeDomain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_KHR;
+
+    // Device timestamps are read from CLOCK_MONOTONIC by default.
+    uint64_t timestamps[ 2 ] = {};
+    uint64_t maxDeviation = 0;
+    result = vkGetCalibratedTimestampsKHR( device, 2, timestampInfos, timestamps, &maxDeviation );
+    ASSERT_EQ( VK_SUCCESS, result );
+    EXPECT_LE( std::max( timestamps[ 0 ], timestamps[ 1 ] ) - std::min( timestamps[ 0 ], timestamps[ 1 ] ), maxDeviation );
+
+    VkMockTimestampClockInfoEXT clockInfo = {};
+    clockInfo.clock = VK_MOCK_TIMESTAMP_CLOCK_TSC_EXT;
+    clockInfo.timestampPeriod = 2.0f;
+    clockInfo.maxDeviation = 1000;
+
+    result = vkSetMockTimestampClockEXT( physicalDevice, &clockInfo );
+    if( result == VK_ERROR_FEATURE_NOT_PRESENT )
+    {
+        GTEST_SKIP() << "The CPU has no invariant time stamp counter";
+    }
+
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties( physicalDevice, &properties );
+    EXPECT_EQ( 2.0f, properties.limits.timestampPeriod );
+
+    VkQueryPoolCreateInfo queryPoolCreateInfo = {};
+    queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolCreateInfo.queryCount = 1;
+
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    result = vkCreateQueryPool( device, &queryPoolCreateInfo, nullptr, &queryPool );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    BeginCommandBuffer( &commandPool, &commandBuffer );
+    vkCmdWriteTimestamp( commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 0 );
+
+    uint64_t beginTimestamps[ 2 ] = {};
+    result = vkGetCalibratedTimestampsKHR( device, 2, timestampInfos, beginTimestamps, &maxDeviation );
+    ASSERT_EQ( VK_SUCCESS, result );
+    EXPECT_LE( 1000, maxDeviation );
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    SubmitCommandBuffer( commandBuffer );
+
+    uint64_t endTimestamps[ 2 ] = {};
+    result = vkGetCalibratedTimestampsKHR( device, 2, timestampInfos, endTimestamps, &maxDeviation );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    uint64_t timestamp = 0;
+    result = vkGetQueryPoolResults( device, queryPool, 0, 1, sizeof( timestamp ), &timestamp, sizeof( timestamp ), VK_QUERY_RESULT_64_BIT );
+    ASSERT_EQ( VK_SUCCESS, result );
+    EXPECT_LE( beginTimestamps[ 0 ], timestamp );
+    EXPECT_GE( endTimestamps[ 0 ], timestamp );
+
+    // Ticks of the device clock are converted to the configured period.
+    const double deviceTime = double( endTimestamps[ 0 ] - beginTimestamps[ 0 ] ) * properties.limits.timestampPeriod;
+    const double hostTime = double( endTimestamps[ 1 ] - beginTimestamps[ 1 ] );
+    EXPECT_NEAR( hostTime, deviceTime, hostTime * 0.05 );
+
+    vkDestroyCommandPool( device, commandPool, nullptr );
+    vkDestroyQueryPool( device, queryPool, nullptr );
+}
+
+TEST_F( vk_mock_icd_tests, vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR )
+{
+    CreateInstance();
+    CreateDevice();
+
+    auto vkSetMockPerformanceCountersEXT = (PFN_vkSetMockPerformanceCountersEXT)vkGetInstanceProcAddr( instance, "vkSetMockPerformanceCountersEXT" );
+    auto vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR = (PFN_vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR)vkGetInstanceProcAddr( instance, "vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR" );
+    auto vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR = (PFN_vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR)vkGetInstanceProcAddr( instance, "vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR" );
+    auto vkAcquireProfilingLockKHR = (PFN_vkAcquireProfilingLockKHR)vkGetDeviceProcAddr( device, "vkAcquireProfilingLockKHR" );
+    auto vkReleaseProfilingLockKHR = (PFN_vkReleaseProfilingLockKHR)vkGetDeviceProcAddr( device, "vkReleaseProfilingLockKHR" );
+    ASSERT_NE( nullptr, vkSetMockPerformanceCountersEXT );
+    ASSERT_NE( nullptr, vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR );
+    ASSERT_NE( nullptr, vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR );
+    ASSERT_NE( nullptr, vkAcquireProfilingLockKHR );
+    ASSERT_NE( nullptr, vkReleaseProfilingLockKHR );
+
+    // Sample the counters in two passes.
+    const VkMockPerformanceCounterEXT mockCounters[] = {
+        VK_MOCK_PERFORMANCE_COUNTER_COMMANDS_EXECUTED_EXT,
+        VK_MOCK_PERFORMANCE_COUNTER_BYTES_COPIED_EXT,
+        VK_MOCK_PERFORMANCE_COUNTER_BUSY_TIME_EXT,
+        VK_MOCK_PERFORMANCE_COUNTER_DRAWS_EXT,
+        VK_MOCK_PERFORMANCE_COUNTER_DISPATCHES_EXT,
+        VK_MOCK_PERFORMANCE_COUNTER_VERTICES_EXT,
+    };
+
+    VkMockPerformanceCountersInfoEXT countersInfo = {};
+    countersInfo.counterCount = 6;
+    countersInfo.pCounters = mockCounters;
+    countersInfo.countersPerPass = 3;
+
+    VkResult result = vkSetMockPerformanceCountersEXT( physicalDevice, &countersInfo );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    uint32_t counterCount = 0;
+    result = vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR( physicalDevice, 0, &counterCount, nullptr, nullptr );
+    ASSERT_EQ( VK_SUCCESS, result );
+    ASSERT_EQ( 6, counterCount );
+
+    std::vector<VkPerformanceCounterKHR> counters( counterCount, { VK_STRUCTURE_TYPE_PERFORMANCE_COUNTER_KHR } );
+    std::vector<VkPerformanceCounterDescriptionKHR> descriptions( counterCount, { VK_STRUCTURE_TYPE_PERFORMANCE_COUNTER_DESCRIPTION_KHR } );
+    result = vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR( physicalDevice, 0, &counterCount, counters.data(), descriptions.data() );
+    ASSERT_EQ( VK_SUCCESS, result );
+    EXPECT_EQ( VK_PERFORMANCE_COUNTER_UNIT_BYTES_KHR, counters[ 1 ].unit );
+    EXPECT_EQ( VK_PERFORMANCE_COUNTER_UNIT_NANOSECONDS_KHR, counters[ 2 ].unit );
+    EXPECT_EQ( VK_PERFORMANCE_COUNTER_STORAGE_UINT64_KHR, counters[ 3 ].storage );
+    EXPECT_STREQ( "Draws", descriptions[ 3 ].name );
+
+    const uint32_t counterIndices[] = { 0, 1, 2, 3, 4, 5 };
+
+    VkQueryPoolPerformanceCreateInfoKHR performanceCreateInfo = {};
+    performanceCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_PERFORMANCE_CREATE_INFO_KHR;
+    performanceCreateInfo.queueFamilyIndex = 0;
+    performanceCreateInfo.counterIndexCount = 6;
+    performanceCreateInfo.pCounterIndices = counterIndices;
+
+    uint32_t passCount = 0;
+    vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR( physicalDevice, &performanceCreateInfo, &passCount );
+    ASSERT_EQ( 2, passCount );
+
+    // The lock is held until released.
+    VkAcquireProfilingLockInfoKHR lockInfo = {};
+    lockInfo.sType = VK_STRUCTURE_TYPE_ACQUIRE_PROFILING_LOCK_INFO_KHR;
+    lockInfo.timeout = 0;
+
+    result = vkAcquireProfilingLockKHR( device, &lockInfo );
+    ASSERT_EQ( VK_SUCCESS, result );
+    result = vkAcquireProfilingLockKHR( device, &lockInfo );
+    EXPECT_EQ( VK_TIMEOUT, result );
+
+    VkQueryPoolCreateInfo queryPoolCreateInfo = {};
+    queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolCreateInfo.pNext = &performanceCreateInfo;
+    queryPoolCreateInfo.queryType = VK_QUERY_TYPE_PERFORMANCE_QUERY_KHR;
+    queryPoolCreateInfo.queryCount = 1;
+
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    result = vkCreateQueryPool( device, &queryPoolCreateInfo, nullptr, &queryPool );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    vkResetQueryPool( device, queryPool, 0, 1 );
+
+    const VkDeviceSize bufferSize = 4096;
+    VkBuffer srcBuffer = VK_NULL_HANDLE, dstBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory srcMemory = VK_NULL_HANDLE, dstMemory = VK_NULL_HANDLE;
+    void* pSrcData = nullptr;
+    void* pDstData = nullptr;
+    CreateHostVisibleBuffer( bufferSize, &srcBuffer, &srcMemory, &pSrcData );
+    CreateHostVisibleBuffer( bufferSize, &dstBuffer, &dstMemory, &pDstData );
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    BeginCommandBuffer( &commandPool, &commandBuffer );
+
+    VkBufferCopy region = {};
+    region.size = bufferSize;
+
+    vkCmdBeginQuery( commandBuffer, queryPool, 0, 0 );
+    vkCmdCopyBuffer( commandBuffer, srcBuffer, dstBuffer, 1, &region );
+    vkCmdDraw( commandBuffer, 6, 2, 0, 0 );
+    vkCmdEndQuery( commandBuffer, queryPool, 0 );
+
+    result = vkEndCommandBuffer( commandBuffer );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkPerformanceQuerySubmitInfoKHR performanceSubmitInfo = {};
+    performanceSubmitInfo.sType = VK_STRUCTURE_TYPE_PERFORMANCE_QUERY_SUBMIT_INFO_KHR;
+
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &performanceSubmitInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+
+    VkPerformanceCounterResultKHR results[ 6 ] = {};
+
+    // The query is available once all passes have been submitted.
+    for( uint32_t pass = 0; pass < passCount; ++pass )
+    {
+        result = vkGetQueryPoolResults( device, queryPool, 0, 1, sizeof( results ), results, sizeof( results ), 0 );
+        EXPECT_EQ( VK_NOT_READY, result );
+
+        performanceSubmitInfo.counterPassIndex = pass;
+        result = vkQueueSubmit( queue, 1, &submitInfo, VK_NULL_HANDLE );
+        ASSERT_EQ( VK_SUCCESS, result );
+    }
+
+    vkReleaseProfilingLockKHR( device );
+
+    result = vkGetQueryPoolResults( device, queryPool, 0, 1, sizeof( results ), results, sizeof( results ), 0 );
+    ASSERT_EQ( VK_SUCCESS, result );
+    EXPECT_EQ( 3, results[ 0 ].uint64 );
+    EXPECT_EQ( bufferSize, results[ 1 ].uint64 );
+    EXPECT_LT( 0, results[ 2 ].uint64 );
+    EXPECT_EQ( 1, results[ 3 ].uint64 );
+    EXPECT_EQ( 0, results[ 4 ].uint64 );
+    EXPECT_EQ( 12, results[ 5 ].uint64 );
+
+    result = vkAcquireProfilingLockKHR( device, &lockInfo );
+    EXPECT_EQ( VK_SUCCESS, result );
+    vkReleaseProfilingLockKHR( device );
+
+    vkDestroyCommandPool( device, commandPool, nullptr );
+    vkDestroyBuffer( device, dstBuffer, nullptr );
+    vkDestroyBuffer( device, srcBuffer, nullptr );
+    vkFreeMemory( device, dstMemory, nullptr );
+    vkFreeMemory( device, srcMemory, nullptr );
+    vkDestroyQueryPool( device, queryPool, nullptr );
+}
+
+TEST_F( vk_mock_icd_tests, vkEnumeratePhysicalDeviceGroups )
+{
+    CreateInstance();
+
+    auto vkSetMockPhysicalDevicesEXT = (PFN_vkSetMockPhysicalDevicesEXT)vkGetInstanceProcAddr( instance, "vkSetMockPhysicalDevicesEXT" );
+    auto vkSetMockPerformanceCountersEXT = (PFN_vkSetMockPerformanceCountersEXT)vkGetInstanceProcAddr( instance, "vkSetMockPerformanceCountersEXT" );
+    ASSERT_NE( nullptr, vkSetMockPhysicalDevicesEXT );
+    ASSERT_NE( nullptr, vkSetMockPerformanceCountersEXT );
+
+    // Two discrete GPUs linked in a device group and an integrated GPU.
+    VkMockPhysicalDeviceInfoEXT mockPhysicalDevices[ 3 ] = {};
+    mockPhysicalDevices[ 0 ].pDeviceName = "Mock GPU 0";
+    mockPhysicalDevices[ 0 ].deviceType = VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU;
+    mockPhysicalDevices[ 0 ].threadCount = 2;
+    mockPhysicalDevices[ 1 ].pDeviceName = "Mock GPU 1";
+    mockPhysicalDevices[ 1 ].deviceType = VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU;
+    mockPhysicalDevices[ 1 ].threadCount = 2;
+    mockPhysicalDevices[ 2 ].pDeviceName = "Mock iGPU";
+    mockPhysicalDevices[ 2 ].deviceType = VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU;
+    mockPhysicalDevices[ 2 ].memoryHeapSize = 64 * 1024 * 1024;
+    mockPhysicalDevices[ 2 ].groupIndex = 1;
+
+    VkMockPhysicalDevicesInfoEXT physicalDevicesInfo = {};
+    physicalDevicesInfo.physicalDeviceCount = 3;
+    physicalDevicesInfo.pPhysicalDevices = mockPhysicalDevices;
+    physicalDevicesInfo.peerMemoryBandwidth = 256 * 1024 * 1024;
+
+    VkResult result = vkSetMockPhysicalDevicesEXT( instance, &physicalDevicesInfo );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    uint32_t physicalDeviceCount = 0;
+    result = vkEnumeratePhysicalDevices( instance, &physicalDeviceCount, nullptr );
+    ASSERT_EQ( VK_SUCCESS, result );
+    ASSERT_EQ( 3, physicalDeviceCount );
+
+    VkPhysicalDevice physicalDevices[ 3 ] = {};
+    physicalDeviceCount = 2;
+    result = vkEnumeratePhysicalDevices( instance, &physicalDeviceCount, physicalDevices );
+    EXPECT_EQ( VK_INCOMPLETE, result );
+    physicalDeviceCount = 3;
+    result = vkEnumeratePhysicalDevices( instance, &physicalDeviceCount, physicalDevices );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties( physicalDevices[ 2 ], &properties );
+    EXPECT_STREQ( "Mock iGPU", properties.deviceName );
+    EXPECT_EQ( VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU, properties.deviceType );
+
+    // Memory of the device group is replicated on all physical devices in the group.
+    VkPhysicalDeviceMemoryProperties memoryProperties = {};
+    vkGetPhysicalDeviceMemoryProperties( physicalDevices[ 0 ], &memoryProperties );
+    EXPECT_NE( 0, memoryProperties.memoryHeaps[ 0 ].flags & VK_MEMORY_HEAP_MULTI_INSTANCE_BIT );
+    vkGetPhysicalDeviceMemoryProperties( physicalDevices[ 2 ], &memoryProperties );
+    EXPECT_EQ( 0, memoryProperties.memoryHeaps[ 0 ].flags & VK_MEMORY_HEAP_MULTI_INSTANCE_BIT );
+    EXPECT_EQ( 64 * 1024 * 1024, memoryProperties.memoryHeaps[ 0 ].size );
+
+    uint32_t groupCount = 0;
+    result = vkEnumeratePhysicalDeviceGroups( instance, &groupCount, nullptr );
+    ASSERT_EQ( VK_SUCCESS, result );
+    ASSERT_EQ( 2, groupCount );
+
+    std::vector<VkPhysicalDeviceGroupProperties> groups( groupCount, { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GROUP_PROPERTIES } );
+    result = vkEnumeratePhysicalDeviceGroups( instance, &groupCount, groups.data() );
+    ASSERT_EQ( VK_SUCCESS, result );
+    ASSERT_EQ( 2, groups[ 0 ].physicalDeviceCount );
+    EXPECT_EQ( physicalDevices[ 0 ], groups[ 0 ].physicalDevices[ 0 ] );
+    EXPECT_EQ( physicalDevices[ 1 ], groups[ 0 ].physicalDevices[ 1 ] );
+    ASSERT_EQ( 1, groups[ 1 ].physicalDeviceCount );
+    EXPECT_EQ( physicalDevices[ 2 ], groups[ 1 ].physicalDevices[ 0 ] );
+
+    // Create a logical device from the first group.
+    physicalDevice = physicalDevices[ 0 ];
+
+    const VkMockPerformanceCounterEXT mockCounter = VK_MOCK_PERFORMANCE_COUNTER_PEER_BYTES_COPIED_EXT;
+
+    VkMockPerformanceCountersInfoEXT countersInfo = {};
+    countersInfo.counterCount = 1;
+    countersInfo.pCounters = &mockCounter;
+    countersInfo.countersPerPass = 1;
+
+    result = vkSetMockPerformanceCountersEXT( physicalDevice, &countersInfo );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkDeviceGroupDeviceCreateInfo deviceGroupCreateInfo = {};
+    deviceGroupCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_GROUP_DEVICE_CREATE_INFO;
+    deviceGroupCreateInfo.physicalDeviceCount = groups[ 0 ].physicalDeviceCount;
+    deviceGroupCreateInfo.pPhysicalDevices = groups[ 0 ].physicalDevices;
+
+    VkDeviceQueueCreateInfo queueCreateInfo = {};
+    queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queueCreateInfo.queueCount = 1;
+    const float queuePriority = 1.0f;
+    queueCreateInfo.pQueuePriorities = &queuePriority;
+
+    VkDeviceCreateInfo deviceCreateInfo = {};
+    deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceCreateInfo.pNext = &deviceGroupCreateInfo;
+    deviceCreateInfo.queueCreateInfoCount = 1;
+    deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
+
+    result = vkCreateDevice( physicalDevice, &deviceCreateInfo, allocator, &device );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    vkGetDeviceQueue( device, 0, 0, &queue );
+
+    VkPeerMemoryFeatureFlags peerMemoryFeatures = 0;
+    vkGetDeviceGroupPeerMemoryFeatures( device, 0, 0, 1, &peerMemoryFeatures );
+    EXPECT_NE( 0, peerMemoryFeatures & VK_PEER_MEMORY_FEATURE_COPY_DST_BIT );
+
+    const VkDeviceSize bufferSize = 1024 * 1024;
+    VkBuffer srcBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory srcMemory = VK_NULL_HANDLE;
+    void* pSrcData = nullptr;
+    CreateHostVisibleBuffer( bufferSize, &srcBuffer, &srcMemory, &pSrcData );
+    memset( pSrcData, 0x5A, bufferSize );
+
+    // Both devices write the memory instance of the first device.
+    VkBufferCreateInfo bufferCreateInfo = {};
+    bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferCreateInfo.size = bufferSize;
+    bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+    VkBuffer dstBuffer = VK_NULL_HANDLE;
+    result = vkCreateBuffer( device, &bufferCreateInfo, nullptr, &dstBuffer );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkMemoryAllocateInfo memoryAllocateInfo = {};
+    memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    memoryAllocateInfo.allocationSize = bufferSize;
+
+    VkDeviceMemory dstMemory = VK_NULL_HANDLE;
+    result = vkAllocateMemory( device, &memoryAllocateInfo, nullptr, &dstMemory );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    const uint32_t deviceIndices[] = { 0, 0 };
+
+    VkBindBufferMemoryDeviceGroupInfo bindDeviceGroupInfo = {};
+    bindDeviceGroupInfo.sType = VK_STRUCTURE_TYPE_BIND_BUFFER_MEMORY_DEVICE_GROUP_INFO;
+    bindDeviceGroupInfo.deviceIndexCount = 2;
+    bindDeviceGroupInfo.pDeviceIndices = deviceIndices;
+
+    VkBindBufferMemoryInfo bindInfo = {};
+    bindInfo.sType = VK_STRUCTURE_TYPE_BIND_BUFFER_MEMORY_INFO;
+    bindInfo.pNext = &bindDeviceGroupInfo;
+    bindInfo.buffer = dstBuffer;
+    bindInfo.memory = dstMemory;
+
+    result = vkBindBufferMemory2( device, 1, &bindInfo );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkQueryPoolPerformanceCreateInfoKHR performanceCreateInfo = {};
+    performanceCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_PERFORMANCE_CREATE_INFO_KHR;
+    performanceCreateInfo.counterIndexCount = 1;
+    const uint32_t counterIndex = 0;
+    performanceCreateInfo.pCounterIndices = &counterIndex;
+
+    VkQueryPoolCreateInfo queryPoolCreateInfo = {};
+    queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolCreateInfo.pNext = &performanceCreateInfo;
+    queryPoolCreateInfo.queryType = VK_QUERY_TYPE_PERFORMANCE_QUERY_KHR;
+    queryPoolCreateInfo.queryCount = 1;
+
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    result = vkCreateQueryPool( device, &queryPoolCreateInfo, nullptr, &queryPool );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    BeginCommandBuffer( &commandPool, &commandBuffer );
+
+    VkBufferCopy region = {};
+    region.size = bufferSize;
+
+    vkCmdBeginQuery( commandBuffer, queryPool, 0, 0 );
+    vkCmdCopyBuffer( commandBuffer, srcBuffer, dstBuffer, 1, &region );
+    vkCmdEndQuery( commandBuffer, queryPool, 0 );
+
+    result = vkEndCommandBuffer( commandBuffer );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    uint32_t commandBufferDeviceMask = 0x1;
+
+    VkDeviceGroupSubmitInfo deviceGroupSubmitInfo = {};
+    deviceGroupSubmitInfo.sType = VK_STRUCTURE_TYPE_DEVICE_GROUP_SUBMIT_INFO;
+    deviceGroupSubmitInfo.commandBufferCount = 1;
+    deviceGroupSubmitInfo.pCommandBufferDeviceMasks = &commandBufferDeviceMask;
+
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &deviceGroupSubmitInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+
+    // The first device writes its local memory instance.
+    vkResetQueryPool( device, queryPool, 0, 1 );
+    result = vkQueueSubmit( queue, 1, &submitInfo, VK_NULL_HANDLE );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkPerformanceCounterResultKHR counterResult = {};
+    result = vkGetQueryPoolResults( device, queryPool, 0, 1, sizeof( counterResult ), &counterResult, sizeof( counterResult ), 0 );
+    ASSERT_EQ( VK_SUCCESS, result );
+    EXPECT_EQ( 0, counterResult.uint64 );
+
+    // The second device writes the memory instance of its peer, which is charged by the modeled bandwidth.
+    commandBufferDeviceMask = 0x2;
+
+    vkResetQueryPool( device, queryPool, 0, 1 );
+    const auto begin = std::chrono::steady_clock::now();
+    result = vkQueueSubmit( queue, 1, &submitInfo, VK_NULL_HANDLE );
+    const auto end = std::chrono::steady_clock::now();
+    ASSERT_EQ( VK_SUCCESS, result );
+    EXPECT_LE( std::chrono::milliseconds( 3 ), end - begin );
+
+    result = vkGetQueryPoolResults( device, queryPool, 0, 1, sizeof( counterResult ), &counterResult, sizeof( counterResult ), 0 );
+    ASSERT_EQ( VK_SUCCESS, result );
+    EXPECT_EQ( bufferSize, counterResult.uint64 );
+
+    vkDestroyCommandPool( device, commandPool, nullptr );
+    vkDestroyQueryPool( device, queryPool, nullptr );
+    vkDestroyBuffer( device, dstBuffer, nullptr );
+    vkDestroyBuffer( device, srcBuffer, nullptr );
+    vkFreeMemory( device, dstMemory, nullptr );
+    vkFreeMemory( device, srcMemory, nullptr );
+}
+
+TEST_F( vk_mock_icd_tests, vkLoadMockPhysicalDeviceProfileEXT )
+{
+    CreateInstance();
+
+    auto vkLoadMockPhysicalDeviceProfileEXT = (PFN_vkLoadMockPhysicalDeviceProfileEXT)vkGetInstanceProcAddr( instance, "vkLoadMockPhysicalDeviceProfileEXT" );
+    ASSERT_NE( nullptr, vkLoadMockPhysicalDeviceProfileEXT );
+
+    uint32_t physicalDeviceCount = 1;
+    vkEnumeratePhysicalDevices( instance, &physicalDeviceCount, &physicalDevice );
+    ASSERT_NE( VK_NULL_HANDLE, physicalDevice );
+
+    const char profileJson[] = R"({
+        "capabilities": {
+            "baseline": {
+                "extensions": { "VK_KHR_swapchain": 70, "VK_KHR_unknown_extension": 1 },
+                "features": { "VkPhysicalDeviceFeatures": { "samplerAnisotropy": true, "unknownFeature": true } },
+                "properties": {
+                    "VkPhysicalDeviceProperties": {
+                        "deviceName": "Profile GPU",
+                        "deviceType": "VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU",
+                        "limits": {
+                            "maxImageDimension2D": 16384,
+                            "maxViewportDimensions": [ 8192, 8192 ],
+                            "framebufferColorSampleCounts": [ "VK_SAMPLE_COUNT_1_BIT", "VK_SAMPLE_COUNT_4_BIT" ]
+                        }
+                    }
+                }
+            },
+            "large_images": {
+                "properties": { "VkPhysicalDeviceProperties": { "limits": { "maxImageDimension2D": 32768 } } }
+            }
+        },
+        "profiles": {
+            "VP_MOCK_baseline": { "version": 1, "api-version": "1.2.198", "capabilities": [ "baseline" ] },
+            "VP_MOCK_large_images": { "version": 1, "api-version": "1.3.0", "capabilities": [ "baseline", [ "large_images", "baseline" ] ] }
+        }
+    })";
+
+    const char* pProfileFileName = "vk_mock_icd_tests_profile.json";
+    const char* pCacheFileName = "vk_mock_icd_tests_profile.bin";
+
+    FILE* pFile = fopen( pProfileFileName, "wb" );
+    ASSERT_NE( nullptr, pFile );
+    fwrite( profileJson, 1, sizeof( profileJson ) - 1, pFile );
+    fclose( pFile );
+    remove( pCacheFileName );
+
+    VkMockPhysicalDeviceProfileInfoEXT profileInfo = {};
+    profileInfo.pFileName = pProfileFileName;
+    profileInfo.pProfileName = "VP_MOCK_large_images";
+    profileInfo.pCacheFileName = pCacheFileName;
+
+    // The first load compiles the profile and writes the cache, the second one maps the cache.
+    for( int i = 0; i < 2; ++i )
+    {
+        VkResult result = vkLoadMockPhysicalDeviceProfileEXT( physicalDevice, &profileInfo );
+        ASSERT_EQ( VK_SUCCESS, result );
+
+        pFile = fopen( pCacheFileName, "rb" );
+        ASSERT_NE( nullptr, pFile );
+        fclose( pFile );
+
+        VkPhysicalDeviceProperties properties = {};
+        vkGetPhysicalDeviceProperties( physicalDevice, &properties );
+        EXPECT_EQ( VK_MAKE_API_VERSION( 0, 1, 3, 0 ), properties.apiVersion );
+        EXPECT_STREQ( "Profile GPU", properties.deviceName );
+        EXPECT_EQ( VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, properties.deviceType );
+        EXPECT_EQ( 4096, properties.limits.maxImageDimension1D );
+        EXPECT_EQ( 32768, properties.limits.maxImageDimension2D );
+        EXPECT_EQ( 8192, properties.limits.maxViewportDimensions[ 0 ] );
+        EXPECT_EQ( 8192, properties.limits.maxViewportDimensions[ 1 ] );
+        EXPECT_EQ( VK_SAMPLE_COUNT_1_BIT | VK_SAMPLE_COUNT_4_BIT, properties.limits.framebufferColorSampleCounts );
+
+        VkPhysicalDeviceFeatures features = {};
+        vkGetPhysicalDeviceFeatures( physicalDevice, &features );
+        EXPECT_EQ( VK_TRUE, features.samplerAnisotropy );
+        EXPECT_EQ( VK_TRUE, features.multiDrawIndirect );
+
+        // Only the extensions listed by the profile and implemented by the mock are enumerated.
+        uint32_t extensionCount = 0;
+        result = vkEnumerateDeviceExtensionProperties( physicalDevice, nullptr, &extensionCount, nullptr );
+        ASSERT_EQ( VK_SUCCESS, result );
+        ASSERT_EQ( 1, extensionCount );
+
+        VkExtensionProperties extension = {};
+        result = vkEnumerateDeviceExtensionProperties( physicalDevice, nullptr, &extensionCount, &extension );
+        ASSERT_EQ( VK_SUCCESS, result );
+        EXPECT_STREQ( VK_KHR_SWAPCHAIN_EXTENSION_NAME, extension.extensionName );
+    }
+
+    // Cache of a different profile is recompiled.
+    profileInfo.pProfileName = "VP_MOCK_baseline";
+    VkResult result = vkLoadMockPhysicalDeviceProfileEXT( physicalDevice, &profileInfo );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties( physicalDevice, &properties );
+    EXPECT_EQ( VK_MAKE_API_VERSION( 0, 1, 2, 198 ), properties.apiVersion );
+    EXPECT_EQ( 16384, properties.limits.maxImageDimension2D );
+
+    // Failed loads keep the previous profile.
+    profileInfo.pProfileName = "VP_MOCK_unknown";
+    result = vkLoadMockPhysicalDeviceProfileEXT( physicalDevice, &profileInfo );
+    EXPECT_EQ( VK_ERROR_INITIALIZATION_FAILED, result );
+
+    vkGetPhysicalDeviceProperties( physicalDevice, &properties );
+    EXPECT_EQ( 16384, properties.limits.maxImageDimension2D );
+
+    // Profiles rewritten with the same size right after the cache was written are recompiled.
+    std::string modifiedProfileJson = profileJson;
+    modifiedProfileJson.replace( modifiedProfileJson.find( "16384" ), 5, "12288" );
+
+    pFile = fopen( pProfileFileName, "wb" );
+    ASSERT_NE( nullptr, pFile );
+    fwrite( modifiedProfileJson.data(), 1, modifiedProfileJson.size(), pFile );
+    fclose( pFile );
+
+    profileInfo.pProfileName = "VP_MOCK_baseline";
+    result = vkLoadMockPhysicalDeviceProfileEXT( physicalDevice, &profileInfo );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    vkGetPhysicalDeviceProperties( physicalDevice, &properties );
+    EXPECT_EQ( 12288, properties.limits.maxImageDimension2D );
+
+    remove( pProfileFileName );
+    remove( pCacheFileName );
+}
+
+TEST_F( vk_mock_icd_tests, vkGetPhysicalDeviceProperties2Profile )
+{
+    CreateInstance();
+
+    auto vkLoadMockPhysicalDeviceProfileEXT = (PFN_vkLoadMockPhysicalDeviceProfileEXT)vkGetInstanceProcAddr( instance, "vkLoadMockPhysicalDeviceProfileEXT" );
+    ASSERT_NE( nullptr, vkLoadMockPhysicalDeviceProfileEXT );
+
+    uint32_t physicalDeviceCount = 1;
+    vkEnumeratePhysicalDevices( instance, &physicalDeviceCount, &physicalDevice );
+    ASSERT_NE( VK_NULL_HANDLE, physicalDevice );
+
+    const char profileJson[] = R"({
+        "capabilities": {
+            "baseline": {
+                "features": {
+                    "VkPhysicalDeviceVulkan12Features": { "samplerMirrorClampToEdge": true, "drawIndirectCount": false }
+                },
+                "properties": {
+                    "VkPhysicalDeviceSubgroupProperties": {
+                        "subgroupSize": 16,
+                        "supportedStages": [ "VK_SHADER_STAGE_COMPUTE_BIT", "VK_SHADER_STAGE_FRAGMENT_BIT" ]
+                    },
+                    "VkPhysicalDeviceIDProperties": { "deviceNodeMask": 1 }
+                }
+            }
+        },
+        "profiles": {
+            "VP_MOCK_extensions": { "version": 1, "api-version": "1.3.0", "capabilities": [ "baseline" ] }
+        }
+    })";
+
+    const char* pProfileFileName = "vk_mock_icd_tests_profile_pnext.json";
+
+    FILE* pFile = fopen( pProfileFileName, "wb" );
+    ASSERT_NE( nullptr, pFile );
+    fwrite( profileJson, 1, sizeof( profileJson ) - 1, pFile );
+    fclose( pFile );
+
+    VkMockPhysicalDeviceProfileInfoEXT profileInfo = {};
+    profileInfo.pFileName = pProfileFileName;
+
+    VkResult result = vkLoadMockPhysicalDeviceProfileEXT( physicalDevice, &profileInfo );
+    remove( pProfileFileName );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    // Structures in the pNext chains are patched with the values of the profile,
+    // and the values not defined by the profile are reported by the mock.
+    VkPhysicalDeviceVulkan12Features vulkan12Features = {};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &vulkan12Features;
+
+    vkGetPhysicalDeviceFeatures2( physicalDevice, &features );
+    EXPECT_EQ( &vulkan12Features, features.pNext );
+    EXPECT_EQ( VK_TRUE, vulkan12Features.samplerMirrorClampToEdge );
+    EXPECT_EQ( VK_FALSE, vulkan12Features.drawIndirectCount );
+    EXPECT_EQ( VK_TRUE, vulkan12Features.bufferDeviceAddress );
+
+    VkPhysicalDeviceIDProperties idProperties = {};
+    idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+    VkPhysicalDeviceSubgroupProperties subgroupProperties = {};
+    subgroupProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+    subgroupProperties.pNext = &idProperties;
+
+    VkPhysicalDeviceProperties2 properties = {};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &subgroupProperties;
+
+    vkGetPhysicalDeviceProperties2( physicalDevice, &properties );
+    EXPECT_EQ( VK_MAKE_API_VERSION( 0, 1, 3, 0 ), properties.properties.apiVersion );
+    EXPECT_EQ( &idProperties, subgroupProperties.pNext );
+    EXPECT_EQ( 16, subgroupProperties.subgroupSize );
+    EXPECT_EQ( VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, subgroupProperties.supportedStages );
+    EXPECT_NE( 0, subgroupProperties.supportedOperations & VK_SUBGROUP_FEATURE_BASIC_BIT );
+    EXPECT_EQ( 1, idProperties.deviceNodeMask );
+    EXPECT_EQ( 0, memcmp( idProperties.deviceUUID, "vk_mock_icd", 11 ) );
+}
+
+TEST_F( vk_mock_icd_tests, vkGetPhysicalDeviceFormatProperties )
+{
+    CreateInstance();
+
+    auto vkLoadMockPhysicalDeviceProfileEXT = (PFN_vkLoadMockPhysicalDeviceProfileEXT)vkGetInstanceProcAddr( instance, "vkLoadMockPhysicalDeviceProfileEXT" );
+    ASSERT_NE( nullptr, vkLoadMockPhysicalDeviceProfileEXT );
+
+    uint32_t physicalDeviceCount = 1;
+    vkEnumeratePhysicalDevices( instance, &physicalDeviceCount, &physicalDevice );
+    ASSERT_NE( VK_NULL_HANDLE, physicalDevice );
+
+    VkFormatProperties formatProperties = {};
+    vkGetPhysicalDeviceFormatProperties( physicalDevice, VK_FORMAT_R8G8B8A8_UNORM, &formatProperties );
+    EXPECT_NE( 0, formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT );
+    EXPECT_NE( 0, formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_TRANSFER_DST_BIT );
+    EXPECT_EQ( formatProperties.optimalTilingFeatures, formatProperties.linearTilingFeatures );
+    EXPECT_NE( 0, formatProperties.bufferFeatures & VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT );
+
+    // Compressed formats are only copied by the mock.
+    vkGetPhysicalDeviceFormatProperties( physicalDevice, VK_FORMAT_BC1_RGB_UNORM_BLOCK, &formatProperties );
+    EXPECT_NE( 0, formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_TRANSFER_SRC_BIT );
+    EXPECT_EQ( 0, formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT );
+    EXPECT_EQ( 0, formatProperties.bufferFeatures );
+
+    VkImageFormatProperties imageFormatProperties = {};
+    EXPECT_EQ( VK_ERROR_FORMAT_NOT_SUPPORTED, vkGetPhysicalDeviceImageFormatProperties( physicalDevice,
+        VK_FORMAT_BC1_RGB_UNORM_BLOCK, VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, 0, &imageFormatProperties ) );
+
+    ASSERT_EQ( VK_SUCCESS, vkGetPhysicalDeviceImageFormatProperties( physicalDevice,
+        VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, 0, &imageFormatProperties ) );
+    EXPECT_EQ( 4096, imageFormatProperties.maxExtent.width );
+    EXPECT_EQ( 13, imageFormatProperties.maxMipLevels );
+    EXPECT_NE( 0, imageFormatProperties.sampleCounts & VK_SAMPLE_COUNT_4_BIT );
+
+    const char profileJson[] = R"({
+        "capabilities": {
+            "baseline": {
+                "formats": {
+                    "VK_FORMAT_R8G8B8A8_UNORM": {
+                        "VkFormatProperties": {
+                            "optimalTilingFeatures": [ "VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT", "VK_FORMAT_FEATURE_TRANSFER_SRC_BIT" ]
+                        }
+                    },
+                    "VK_FORMAT_UNKNOWN": {
+                        "VkFormatProperties": { "bufferFeatures": [ "VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT" ] }
+                    }
+                }
+            }
+        },
+        "profiles": {
+            "VP_MOCK_formats": { "version": 1, "api-version": "1.3.0", "capabilities": [ "baseline" ] }
+        }
+    })";
+
+    const char* pProfileFileName = "vk_mock_icd_tests_profile_formats.json";
+
+    FILE* pFile = fopen( pProfileFileName, "wb" );
+    ASSERT_NE( nullptr, pFile );
+    fwrite( profileJson, 1, sizeof( profileJson ) - 1, pFile );
+    fclose( pFile );
+
+    VkMockPhysicalDeviceProfileInfoEXT profileInfo = {};
+    profileInfo.pFileName = pProfileFileName;
+
+    VkResult result = vkLoadMockPhysicalDeviceProfileEXT( physicalDevice, &profileInfo );
+    remove( pProfileFileName );
+    ASSERT_EQ( VK_SUCCESS, result );
+
+    // Formats defined by the profile replace the features of the mock, other formats are not affected.
+    VkFormatProperties3 formatProperties3 = {};
+    formatProperties3.sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_3;
+
+    VkFormatProperties2 formatProperties2 = {};
+    formatProperties2.sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_2;
+    formatProperties2.pNext = &formatProperties3;
+
+    vkGetPhysicalDeviceFormatProperties2( physicalDevice, VK_FORMAT_R8G8B8A8_UNORM, &formatProperties2 );
+    EXPECT_EQ( VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_SRC_BIT, formatProperties2.formatProperties.optimalTilingFeatures );
+    EXPECT_NE( 0, formatProperties2.formatProperties.linearTilingFeatures & VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT );
+    EXPECT_EQ( VkFormatFeatureFlags2( VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_SRC_BIT ), formatProperties3.optimalTilingFeatures );
+
+    EXPECT_EQ( VK_ERROR_FORMAT_NOT_SUPPORTED, vkGetPhysicalDeviceImageFormatProperties( physicalDevice,
+        VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, 0, &imageFormatProperties ) );
+
+    vkGetPhysicalDeviceFormatProperties( physicalDevice, VK_FORMAT_B8G8R8A8_UNORM, &formatProperties );
+    EXPECT_NE( 0, formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT );
+}
+
 int main( int argc, char** argv )
 {
     testing::InitGoogleTest( &argc, argv );